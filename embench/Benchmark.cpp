@@ -0,0 +1,107 @@
+//  Benchmark.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "embench.h"
+
+
+
+//  statics
+
+volatile UINT64     Benchmark::m_Sink = 0;
+
+
+
+//  private statics
+
+//  getNanoseconds()
+COUNT64
+Benchmark::getNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+
+//  public methods
+
+//  measure()
+//
+//  Warms up the kernel, calibrates an iteration count, and times the requested number of trials.
+Benchmark::Result
+Benchmark::measure
+(
+    const Settings&     settings
+) const
+{
+    //  Warm up caches, branch predictors, and the CPU clock, doubling the iteration count as we go,
+    //  so that by the end we know roughly how long one iteration takes.
+    COUNT64 iterations = 1;
+    COUNT64 warmupNanos = static_cast<COUNT64>( settings.m_WarmupMillis ) * 1000000;
+    COUNT64 warmupStart = getNanoseconds();
+    COUNT64 elapsed = 0;
+    while ( true )
+    {
+        COUNT64 start = getNanoseconds();
+        m_Sink = m_Sink + m_Kernel( iterations );
+        elapsed = getNanoseconds() - start;
+        if ( getNanoseconds() - warmupStart >= warmupNanos )
+            break;
+        if ( elapsed < warmupNanos / 4 )
+            iterations *= 2;
+    }
+
+    Result result;
+    COUNT64 trialNanos = static_cast<COUNT64>( settings.m_TrialMillis ) * 1000000;
+    result.m_Iterations = elapsed ? std::max<COUNT64>( 1, iterations * trialNanos / elapsed ) : iterations;
+    result.m_Trials = std::max<COUNT>( 1, settings.m_Trials );
+
+    std::vector<double> nanosPerWord;
+    double words = static_cast<double>( result.m_Iterations ) * m_WordsPerIteration;
+    for ( INDEX tx = 0; tx < result.m_Trials; ++tx )
+    {
+        COUNT64 start = getNanoseconds();
+        m_Sink = m_Sink + m_Kernel( result.m_Iterations );
+        nanosPerWord.push_back( static_cast<double>( getNanoseconds() - start ) / words );
+    }
+
+    std::sort( nanosPerWord.begin(), nanosPerWord.end() );
+    result.m_MinNanosPerWord = nanosPerWord.front();
+    result.m_MedianNanosPerWord = nanosPerWord[nanosPerWord.size() / 2];
+    result.m_MaxNanosPerWord = nanosPerWord.back();
+    return result;
+}
+
+
+
+//  public statics
+
+//  pinCurrentThread()
+//
+//  Pins the calling thread to the given host CPU, so that trials are not disturbed by migration
+//
+//  Returns:
+//      true if successful
+bool
+Benchmark::pinCurrentThread
+(
+    const COUNT         cpu
+)
+{
+#ifdef WIN32
+    if ( cpu >= sizeof(DWORD_PTR) * 8 )
+        return false;
+    return SetThreadAffinityMask( GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu ) != 0;
+#else
+    if ( cpu >= CPU_SETSIZE )
+        return false;
+
+    cpu_set_t cpuSet;
+    CPU_ZERO( &cpuSet );
+    CPU_SET( cpu, &cpuSet );
+    return pthread_setaffinity_np( pthread_self(), sizeof(cpuSet), &cpuSet ) == 0;
+#endif
+}
+
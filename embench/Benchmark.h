@@ -0,0 +1,92 @@
+//  Benchmark.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  One timed kernel.  The kernel is a function which performs a given number of iterations over some fixed
+//  amount of work (so many words, so many bytes) and returns a checksum of what it produced - the checksum
+//  goes into a sink, so that the compiler cannot discard the work.
+//
+//  measure() runs the kernel (on whatever CPU the caller has pinned itself to) for a warmup period, using
+//  that to choose an iteration count which fills the requested trial time, then runs the given number of
+//  trials at that count and reports the median, with the best and worst trials for an idea of the noise.
+
+
+
+#ifndef     EMBENCH_BENCHMARK_H
+#define     EMBENCH_BENCHMARK_H
+
+
+
+class   Benchmark
+{
+public:
+    typedef std::function<UINT64( const COUNT64 iterations )>     KERNEL;
+
+    class   Settings
+    {
+    public:
+        COUNT32                 m_TrialMillis;
+        COUNT                   m_Trials;
+        COUNT32                 m_WarmupMillis;
+
+        Settings()
+            :m_TrialMillis( 200 ),
+            m_Trials( 11 ),
+            m_WarmupMillis( 300 )
+        {}
+    };
+
+    class   Result
+    {
+    public:
+        COUNT64                 m_Iterations;           //  per trial
+        double                  m_MaxNanosPerWord;
+        double                  m_MedianNanosPerWord;
+        double                  m_MinNanosPerWord;
+        COUNT                   m_Trials;
+
+        Result()
+            :m_Iterations( 0 ),
+            m_MaxNanosPerWord( 0.0 ),
+            m_MedianNanosPerWord( 0.0 ),
+            m_MinNanosPerWord( 0.0 ),
+            m_Trials( 0 )
+        {}
+    };
+
+private:
+    const COUNT                 m_BytesPerIteration;
+    const KERNEL                m_Kernel;
+    const std::string           m_Name;
+    const COUNT                 m_WordsPerIteration;
+
+    static volatile UINT64      m_Sink;
+
+    static COUNT64              getNanoseconds();
+
+public:
+    Benchmark( const std::string&   name,
+               const COUNT          wordsPerIteration,
+               const COUNT          bytesPerIteration,
+               const KERNEL&        kernel )
+        :m_BytesPerIteration( bytesPerIteration ),
+        m_Kernel( kernel ),
+        m_Name( name ),
+        m_WordsPerIteration( wordsPerIteration )
+    {}
+
+    Result                      measure( const Settings& settings ) const;
+
+    inline COUNT                getBytesPerIteration() const        { return m_BytesPerIteration; }
+    inline const std::string&   getName() const                     { return m_Name; }
+    inline COUNT                getWordsPerIteration() const        { return m_WordsPerIteration; }
+
+    static bool                 pinCurrentThread( const COUNT cpu );
+};
+
+typedef     std::vector<Benchmark*>                 BENCHMARKS;
+typedef     BENCHMARKS::iterator                    ITBENCHMARKS;
+typedef     BENCHMARKS::const_iterator              CITBENCHMARKS;
+
+
+
+#endif
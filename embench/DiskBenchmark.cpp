@@ -0,0 +1,307 @@
+//  DiskBenchmark.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "embench.h"
+
+
+
+//  local constants
+#define     PACK_FILE_PREFIX            "EMBENCH"
+#define     PACK_TRACK_COUNT            10000       //  the smallest pack createPack() will make
+
+
+
+//  private methods
+
+//  completeSlot()
+//
+//  Accounts for a channel program which is no longer in progress.
+//  Only the measured phase contributes to the result.
+//
+//  Returns:
+//      false if the IO was unsuccessful
+bool
+DiskBenchmark::completeSlot
+(
+    Slot* const     pSlot,
+    const Phase     phase
+)
+{
+    pSlot->m_InFlight = false;
+    const ChannelModule::ChannelProgram* pChannelProgram = pSlot->m_pChannelProgram;
+    if ( pChannelProgram->m_ChannelStatus != ChannelModule::Status::SUCCESSFUL )
+    {
+        std::stringstream strm;
+        strm << ChannelModule::getCommandString( pChannelProgram->m_Command )
+            << " of block " << pChannelProgram->m_Address
+            << " on DISK" << pChannelProgram->m_DeviceAddress
+            << " failed - " << ChannelModule::getStatusString( pChannelProgram->m_ChannelStatus );
+        if ( pChannelProgram->m_ChannelStatus == ChannelModule::Status::DEVICE_ERROR )
+            strm << " " << Device::getIoStatusString( pChannelProgram->m_DeviceStatus, pChannelProgram->m_SystemErrorCode );
+        m_ErrorMessage = strm.str();
+        return false;
+    }
+
+    if ( phase == Phase::MEASURE )
+    {
+        m_Histogram.record( LatencyHistogram::getMicroseconds() - pSlot->m_StartMicros );
+        m_Result.m_Bytes += miscGetBlockSizeFromPrepFactor( m_Settings.m_PrepFactor );
+        if ( pChannelProgram->m_Command == ChannelModule::Command::READ )
+            ++m_Result.m_Reads;
+        else
+            ++m_Result.m_Writes;
+    }
+
+    return true;
+}
+
+
+//  runPhase()
+//
+//  Keeps every slot busy until the phase is over (for the fill, until every block of every pack has been
+//  written), then waits for the stragglers.
+//
+//  Returns:
+//      false if an IO failed, or we were told to terminate
+bool
+DiskBenchmark::runPhase
+(
+    const Phase         phase
+)
+{
+    COUNT64 startMicros = LatencyHistogram::getMicroseconds();
+    COUNT32 millis = (phase == Phase::WARMUP) ? m_Settings.m_WarmupMillis : m_Settings.m_DurationMillis;
+    COUNT64 endMicros = startMicros + static_cast<COUNT64>( millis ) * 1000;
+    m_NextPack = 0;
+    for ( INDEX px = 0; px < m_NextBlockIds.size(); ++px )
+        m_NextBlockIds[px] = 0;
+
+    bool failed = false;
+    while ( true )
+    {
+        bool stopping = failed
+                        || isWorkerTerminating()
+                        || ((phase != Phase::FILL) && (LatencyHistogram::getMicroseconds() >= endMicros));
+        bool completed = false;
+        bool inFlight = false;
+        for ( ITSLOTS its = m_Slots.begin(); its != m_Slots.end(); ++its )
+        {
+            if ( its->m_InFlight && (its->m_pChannelProgram->m_ChannelStatus != ChannelModule::Status::IN_PROGRESS) )
+            {
+                completed = true;
+                if ( !completeSlot( &*its, phase ) )
+                {
+                    failed = true;
+                    stopping = true;
+                }
+            }
+
+            if ( !its->m_InFlight && !stopping )
+                its->m_InFlight = startSlot( &*its, phase );
+            if ( its->m_InFlight )
+                inFlight = true;
+        }
+
+        if ( !inFlight )
+            break;
+        if ( !completed )
+            workerWait( 100 );
+    }
+
+    if ( phase == Phase::MEASURE )
+        m_Result.m_ElapsedMicros = LatencyHistogram::getMicroseconds() - startMicros;
+
+    return !failed && !isWorkerTerminating();
+}
+
+
+//  startSlot()
+//
+//  Chooses the next IO for the phase and access pattern, and routes the slot's channel program for it.
+//
+//  Returns:
+//      false if there is nothing more to do (which happens only at the end of the fill)
+bool
+DiskBenchmark::startSlot
+(
+    Slot* const         pSlot,
+    const Phase         phase
+)
+{
+    ChannelModule::Command command = ChannelModule::Command::WRITE;
+    INDEX packIndex = 0;
+    BLOCK_ID blockId = 0;
+
+    if ( phase == Phase::FILL )
+    {
+        if ( m_NextPack == m_Settings.m_PackCount )
+            return false;
+        packIndex = m_NextPack;
+        blockId = m_NextBlockIds[packIndex]++;
+        if ( m_NextBlockIds[packIndex] == m_BlockCount )
+            ++m_NextPack;
+    }
+    else
+    {
+        if ( m_Random() % 100 < m_Settings.m_ReadPercent )
+            command = ChannelModule::Command::READ;
+
+        if ( m_Settings.m_AccessPattern == AccessPattern::SEQUENTIAL )
+        {
+            packIndex = m_NextPack;
+            m_NextPack = (m_NextPack + 1) % m_Settings.m_PackCount;
+            blockId = m_NextBlockIds[packIndex];
+            m_NextBlockIds[packIndex] = (blockId + 1) % m_BlockCount;
+        }
+        else
+        {
+            packIndex = m_Random() % m_Settings.m_PackCount;
+            blockId = m_Random() % m_BlockCount;
+        }
+    }
+
+    ChannelModule::ChannelProgram* pChannelProgram = pSlot->m_pChannelProgram;
+    pChannelProgram->m_DeviceAddress = static_cast<Node::NODE_ADDRESS>( packIndex );
+    pChannelProgram->m_Command = command;
+    pChannelProgram->m_Address = blockId;
+    pChannelProgram->m_BytesTransferred = 0;
+    pChannelProgram->m_WordsTransferred = 0;
+    pChannelProgram->m_DeviceStatus = Device::IoStatus::SUCCESSFUL;
+    pChannelProgram->m_SystemErrorCode = 0;
+
+    pSlot->m_StartMicros = LatencyHistogram::getMicroseconds();
+    m_Configuration.routeIo( pChannelProgram );
+    return true;
+}
+
+
+//  worker()
+//
+//  The whole run - set up, inquire, fill, warm up, measure, tear down
+void
+DiskBenchmark::worker()
+{
+    BLOCK_SIZE blockSize = miscGetBlockSizeFromPrepFactor( m_Settings.m_PrepFactor );
+    for ( INDEX px = 0; px < m_Settings.m_PackCount; ++px )
+        m_Configuration.addPack( blockSize, m_BlockCount, 0, 0, static_cast<Node::NODE_ADDRESS>( px ) );
+
+    if ( m_Configuration.build( this, m_Settings.m_IoAffinity, &m_ErrorMessage ) )
+    {
+        bool okay = true;
+        if ( m_Settings.m_ReadPercent > 0 )
+            okay = runPhase( Phase::FILL );
+        if ( okay )
+            okay = runPhase( Phase::WARMUP );
+        if ( okay )
+        {
+            m_Histogram.reset();
+            okay = runPhase( Phase::MEASURE );
+            m_Result.m_Latency = m_Histogram.getSnapshot();
+        }
+
+        if ( !okay && m_ErrorMessage.empty() )
+            m_ErrorMessage = "Terminated";
+    }
+
+    m_Configuration.tearDown();
+}
+
+
+
+//  constructors, destructors
+
+DiskBenchmark::DiskBenchmark
+(
+    const Settings&     settings
+)
+:Worker( "DiskBenchmark" ),
+        m_BlockCount( settings.m_PrepFactor ? static_cast<BLOCK_COUNT>( PACK_TRACK_COUNT ) * 1792 / settings.m_PrepFactor : 0 ),
+        m_Configuration( settings.m_Directory, PACK_FILE_PREFIX ),
+        m_NextBlockIds( settings.m_PackCount, 0 ),
+        m_NextPack( 0 ),
+        m_Random( 2200 ),
+        m_Settings( settings ),
+        m_Slots( settings.m_QueueDepth )
+{
+    for ( ITSLOTS its = m_Slots.begin(); its != m_Slots.end(); ++its )
+    {
+        its->m_pBuffer = new Word36[m_Settings.m_PrepFactor];
+        for ( INDEX wx = 0; wx < m_Settings.m_PrepFactor; ++wx )
+            its->m_pBuffer[wx].setW( m_Random() );
+
+        its->m_pChannelProgram = new ChannelModule::ChannelProgram( this );
+        its->m_pChannelProgram->m_AccessControlList.push_back( IoAccessControlWord( its->m_pBuffer,
+                                                                                    m_Settings.m_PrepFactor,
+                                                                                    EXIOBAM_INCREMENT ) );
+        its->m_pChannelProgram->m_Format = ChannelModule::IoTranslateFormat::C;
+        its->m_pChannelProgram->m_TransferSizeWords = m_Settings.m_PrepFactor;
+    }
+}
+
+
+DiskBenchmark::~DiskBenchmark()
+{
+    workerStop( true );
+    for ( ITSLOTS its = m_Slots.begin(); its != m_Slots.end(); ++its )
+    {
+        delete its->m_pChannelProgram;
+        delete[] its->m_pBuffer;
+    }
+}
+
+
+
+//  public methods
+
+//  run()
+//
+//  Does the whole run on our worker thread, and waits for it.
+//
+//  Returns:
+//      true if successful - otherwise, getErrorMessage() says why
+bool
+DiskBenchmark::run()
+{
+    if ( !miscIsValidPrepFactor( m_Settings.m_PrepFactor ) )
+    {
+        m_ErrorMessage = "Invalid prep factor";
+        return false;
+    }
+
+    if ( (m_Settings.m_PackCount == 0) || (m_Settings.m_QueueDepth == 0) || (m_Settings.m_ReadPercent > 100) )
+    {
+        m_ErrorMessage = "Invalid settings";
+        return false;
+    }
+
+    if ( !workerStart() )
+    {
+        m_ErrorMessage = "Cannot start worker thread";
+        return false;
+    }
+
+    workerJoin();
+    return m_ErrorMessage.empty();
+}
+
+
+
+//  public statics
+
+//  getAccessPatternString()
+const char*
+DiskBenchmark::getAccessPatternString
+(
+    const AccessPattern     pattern
+)
+{
+    switch ( pattern )
+    {
+    case AccessPattern::RANDOM:         return "Random";
+    case AccessPattern::SEQUENTIAL:     return "Sequential";
+    }
+
+    return "???";
+}
@@ -0,0 +1,150 @@
+//  DiskBenchmark.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  End-to-end disk IO benchmark, from channel program to host file and back, without an exec.
+//  We build a ScratchConfiguration with one channel module, one controller, and one device per pack,
+//  then keep a fixed number of channel programs in flight
+//  (the queue depth), each one a single-block format C transfer of the kind MFDManager::directDiskIo() issues,
+//  routed through IOProcessor::routeIo() just as IoManager does.  As each completes we time it and replace it.
+//
+//  If the mix includes reads, the packs are filled first so that reads find data rather than holes.
+//  Then we run the mix for a warmup period with the statistics discarded, and for the measured period.
+//  Any unsuccessful IO ends the run - the harness is meant to measure a working stack, not to exercise errors.
+//  We are the Worker to which completions are signalled, so all of the driving happens on our own thread;
+//  run() starts it and waits for it to finish.
+
+
+
+#ifndef     EMBENCH_DISK_BENCHMARK_H
+#define     EMBENCH_DISK_BENCHMARK_H
+
+
+
+class   DiskBenchmark : public Worker
+{
+public:
+    enum class AccessPattern
+    {
+        RANDOM,
+        SEQUENTIAL,
+    };
+
+    class   Settings
+    {
+    public:
+        AccessPattern           m_AccessPattern;
+        std::string             m_Directory;            //  where the scratch packs are created
+        COUNT32                 m_DurationMillis;
+        CpuSet                  m_IoAffinity;           //  for the channel module, which does the host IO
+        COUNT                   m_PackCount;
+        PREP_FACTOR             m_PrepFactor;           //  words per block, hence the size of every IO
+        COUNT                   m_QueueDepth;           //  channel programs kept in flight
+        COUNT                   m_ReadPercent;
+        COUNT32                 m_WarmupMillis;
+
+        Settings()
+            :m_AccessPattern( AccessPattern::RANDOM ),
+            m_Directory( "/tmp/" ),
+            m_DurationMillis( 5000 ),
+            m_PackCount( 1 ),
+            m_PrepFactor( 1792 ),
+            m_QueueDepth( 4 ),
+            m_ReadPercent( 70 ),
+            m_WarmupMillis( 500 )
+        {}
+    };
+
+    class   Result
+    {
+    public:
+        COUNT64                 m_Bytes;                //  host bytes moved by successful IOs
+        COUNT64                 m_ElapsedMicros;        //  first routeIo() to last completion
+        LatencyHistogram::Snapshot  m_Latency;          //  routeIo() to completion, per successful IO
+        COUNT64                 m_Reads;
+        COUNT64                 m_Writes;
+
+        Result()
+            :m_Bytes( 0 ),
+            m_ElapsedMicros( 0 ),
+            m_Reads( 0 ),
+            m_Writes( 0 )
+        {}
+
+        inline double getIops() const
+        {
+            return m_ElapsedMicros ? (m_Reads + m_Writes) * 1000000.0 / m_ElapsedMicros : 0.0;
+        }
+
+        inline double getMegabytesPerSecond() const
+        {
+            return m_ElapsedMicros ? static_cast<double>( m_Bytes ) / m_ElapsedMicros : 0.0;
+        }
+    };
+
+private:
+    enum class Phase
+    {
+        FILL,
+        WARMUP,
+        MEASURE,
+    };
+
+    //  One in-flight position - a channel program and the buffer its ACW describes
+    class   Slot
+    {
+    public:
+        Word36*                 m_pBuffer;
+        ChannelModule::ChannelProgram*  m_pChannelProgram;
+        bool                    m_InFlight;
+        COUNT64                 m_StartMicros;
+
+        Slot()
+            :m_pBuffer( 0 ),
+            m_pChannelProgram( 0 ),
+            m_InFlight( false ),
+            m_StartMicros( 0 )
+        {}
+    };
+
+    typedef     std::vector<Slot>                       SLOTS;
+    typedef     SLOTS::iterator                         ITSLOTS;
+
+    typedef     std::vector<BLOCK_ID>                   BLOCKIDS;
+
+    BLOCK_COUNT                 m_BlockCount;           //  per pack
+    ScratchConfiguration        m_Configuration;
+    std::string                 m_ErrorMessage;
+    LatencyHistogram            m_Histogram;
+    BLOCKIDS                    m_NextBlockIds;         //  per pack, for sequential access and for the fill
+    INDEX                       m_NextPack;
+    std::mt19937_64             m_Random;
+    Result                      m_Result;
+    const Settings              m_Settings;
+    SLOTS                       m_Slots;
+
+    bool                        completeSlot( Slot* const   pSlot,
+                                              const Phase   phase );
+    bool                        runPhase( const Phase phase );
+    bool                        startSlot( Slot* const  pSlot,
+                                           const Phase  phase );
+
+    //  Worker interface
+    void                        worker();
+    bool                        isWorkerClockParticipant() const    { return false; }
+
+public:
+    DiskBenchmark( const Settings& settings );
+    ~DiskBenchmark();
+
+    bool                        run();
+
+    inline const std::string&   getErrorMessage() const             { return m_ErrorMessage; }
+    inline const Result&        getResult() const                   { return m_Result; }
+    inline const Settings&      getSettings() const                 { return m_Settings; }
+
+    static const char*          getAccessPatternString( const AccessPattern pattern );
+};
+
+
+
+#endif
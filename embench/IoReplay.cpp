@@ -0,0 +1,351 @@
+//  IoReplay.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "embench.h"
+
+
+
+//  local constants
+#define     PACK_FILE_PREFIX            "EMREPLAY"
+#define     MIN_PACK_TRACKS             10000       //  the smallest and largest packs createPack() will make
+#define     MAX_PACK_TRACKS             99999
+#define     MAX_WAIT_MILLIS             100
+
+
+
+//  private methods
+
+//  completeSlot()
+//
+//  Accounts for a channel program which is no longer in progress, and frees its slot
+void
+IoReplay::completeSlot
+(
+    Slot* const     pSlot
+)
+{
+    const ChannelModule::ChannelProgram& channelProgram = pSlot->m_ChannelProgram;
+    if ( channelProgram.m_ChannelStatus != ChannelModule::Status::SUCCESSFUL )
+    {
+        ++m_Result.m_Errors;
+    }
+    else
+    {
+        COUNT64 micros = LatencyHistogram::getMicroseconds() - pSlot->m_StartMicros;
+        m_LatencyHistogram.record( micros );
+        pSlot->m_pHistogram->record( micros );
+        if ( channelProgram.m_Command == ChannelModule::Command::READ )
+            ++m_Result.m_Reads;
+        else
+            ++m_Result.m_Writes;
+    }
+
+    m_FreeSlots.push_back( pSlot );
+}
+
+
+//  plan()
+//
+//  Works out from the capture which packs we need, how big they must be, and when each IO is due
+bool
+IoReplay::plan()
+{
+    //  The disk controller rounds every transfer up, and the device sees the rounded size - so must we
+    DiskController sizer( "SIZER" );
+
+    CHANNEL_MODULE_ADDRESSES channelModuleAddresses;
+    bool first = true;
+    COUNT64 firstTimestamp = 0;
+    for ( IoCapture::CITRECORDS itr = m_Records.begin(); itr != m_Records.end(); ++itr )
+    {
+        ChannelModule::Command command = static_cast<ChannelModule::Command>( itr->m_Command );
+        if ( ((command != ChannelModule::Command::READ) && (command != ChannelModule::Command::WRITE))
+            || !miscIsValidBlockSize( itr->m_BlockSize )
+            || (itr->m_BufferWords == 0) )
+        {
+            ++m_Result.m_Skipped;
+            continue;
+        }
+
+        UINT64 packKey = (static_cast<UINT64>( itr->m_ProcessorUPI ) << 48)
+                        | (static_cast<UINT64>( itr->m_ChannelModuleAddress ) << 32)
+                        | (static_cast<UINT64>( itr->m_ControllerAddress ) << 16)
+                        | itr->m_DeviceAddress;
+        ITPACKS itp = m_Packs.find( packKey );
+        if ( itp == m_Packs.end() )
+        {
+            UINT64 channelModuleKey = (static_cast<UINT64>( itr->m_ProcessorUPI ) << 16) | itr->m_ChannelModuleAddress;
+            if ( channelModuleAddresses.find( channelModuleKey ) == channelModuleAddresses.end() )
+            {
+                Node::NODE_ADDRESS address = static_cast<Node::NODE_ADDRESS>( channelModuleAddresses.size() );
+                channelModuleAddresses[channelModuleKey] = address;
+            }
+
+            ScratchConfiguration::Pack* pPack = m_Configuration.addPack( itr->m_BlockSize,
+                                                                         0,
+                                                                         channelModuleAddresses[channelModuleKey],
+                                                                         itr->m_ControllerAddress,
+                                                                         itr->m_DeviceAddress );
+            itp = m_Packs.insert( std::make_pair( packKey, pPack ) ).first;
+        }
+        else if ( itp->second->m_BlockSize != itr->m_BlockSize )
+        {
+            //  The pack was changed during the capture - we replay only IO to the first one
+            ++m_Result.m_Skipped;
+            continue;
+        }
+
+        ScratchConfiguration::Pack* pPack = itp->second;
+
+        COUNT bytes = sizer.getContainingBufferSize(
+            ChannelModule::getByteCountFromWordCount( itr->m_BufferWords,
+                                                      static_cast<ChannelModule::IoTranslateFormat>( itr->m_Format ) ) );
+        BLOCK_COUNT blocks = (bytes + pPack->m_BlockSize - 1) / pPack->m_BlockSize;
+        if ( itr->m_Address + blocks > pPack->m_BlockCount )
+            pPack->m_BlockCount = itr->m_Address + blocks;
+        if ( itr->m_BufferWords > m_MaxBufferWords )
+            m_MaxBufferWords = itr->m_BufferWords;
+
+        if ( first )
+        {
+            firstTimestamp = itr->m_Timestamp;
+            first = false;
+        }
+
+        COUNT64 capturedMicros = itr->m_Timestamp - firstTimestamp;
+        COUNT64 dueMicros = m_Settings.m_SpeedPercent ? capturedMicros * 100 / m_Settings.m_SpeedPercent : 0;
+        m_Steps.push_back( Step( dueMicros, &*itr, pPack ) );
+        m_Result.m_CapturedMicros = capturedMicros;
+    }
+
+    if ( m_Steps.empty() )
+    {
+        m_ErrorMessage = "Nothing in the capture can be replayed";
+        return false;
+    }
+
+    for ( ITPACKS itp = m_Packs.begin(); itp != m_Packs.end(); ++itp )
+    {
+        ScratchConfiguration::Pack* pPack = itp->second;
+        PREP_FACTOR prepFactor = miscGetPrepFactorFromBlockSize( pPack->m_BlockSize );
+        BLOCK_COUNT minBlocks = static_cast<BLOCK_COUNT>( MIN_PACK_TRACKS ) * 1792 / prepFactor;
+        if ( pPack->m_BlockCount < minBlocks )
+            pPack->m_BlockCount = minBlocks;
+        if ( pPack->m_BlockCount * prepFactor / 1792 > MAX_PACK_TRACKS )
+        {
+            std::stringstream strm;
+            strm << "Capture addresses block " << pPack->m_BlockCount - 1
+                << " - too large for a pack with " << pPack->m_BlockSize << "-byte blocks";
+            m_ErrorMessage = strm.str();
+            return false;
+        }
+    }
+
+    m_Result.m_ChannelModuleCount = channelModuleAddresses.size();
+    m_Result.m_DeviceCount = m_Packs.size();
+    return true;
+}
+
+
+//  replay()
+//
+//  Issues every step when it is due (or, at speed zero, whenever there is room), and waits for the stragglers
+void
+IoReplay::replay()
+{
+    COUNT64 startMicros = LatencyHistogram::getMicroseconds();
+    INDEX nextStep = 0;
+    while ( true )
+    {
+        bool progressed = false;
+        for ( INDEX sx = 0; sx < m_InFlightSlots.size(); )
+        {
+            Slot* pSlot = m_InFlightSlots[sx];
+            if ( pSlot->m_ChannelProgram.m_ChannelStatus == ChannelModule::Status::IN_PROGRESS )
+            {
+                ++sx;
+                continue;
+            }
+
+            completeSlot( pSlot );
+            m_InFlightSlots[sx] = m_InFlightSlots.back();
+            m_InFlightSlots.pop_back();
+            progressed = true;
+        }
+
+        bool stopping = isWorkerTerminating();
+        COUNT64 nowMicros = LatencyHistogram::getMicroseconds();
+        while ( !stopping && (nextStep < m_Steps.size()) )
+        {
+            if ( m_Settings.m_SpeedPercent == 0 )
+            {
+                if ( m_InFlightSlots.size() >= m_Settings.m_QueueDepth )
+                    break;
+            }
+            else if ( startMicros + m_Steps[nextStep].m_DueMicros > nowMicros )
+            {
+                break;
+            }
+
+            startStep( m_Steps[nextStep++], startMicros, nowMicros );
+            progressed = true;
+        }
+
+        if ( m_InFlightSlots.empty() && (stopping || (nextStep == m_Steps.size())) )
+            break;
+
+        if ( !progressed )
+        {
+            //  Completions signal us, so we need only time the wait for the next step which is due
+            COUNT32 waitMillis = MAX_WAIT_MILLIS;
+            if ( m_Settings.m_SpeedPercent && !stopping && (nextStep < m_Steps.size()) )
+            {
+                COUNT64 dueMicros = startMicros + m_Steps[nextStep].m_DueMicros;
+                COUNT64 untilMillis = dueMicros > nowMicros ? (dueMicros - nowMicros) / 1000 : 0;
+                if ( untilMillis < waitMillis )
+                    waitMillis = static_cast<COUNT32>( untilMillis );
+            }
+
+            if ( waitMillis )
+                workerWait( waitMillis );
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    m_Result.m_ElapsedMicros = LatencyHistogram::getMicroseconds() - startMicros;
+}
+
+
+//  startStep()
+//
+//  Routes a channel program for one captured IO, in a free slot (or a new one)
+void
+IoReplay::startStep
+(
+    const Step&         step,
+    const COUNT64       startMicros,
+    const COUNT64       nowMicros
+)
+{
+    Slot* pSlot = 0;
+    if ( m_FreeSlots.empty() )
+    {
+        m_Slots.emplace_back( this );
+        pSlot = &m_Slots.back();
+        pSlot->m_Buffer.resize( m_MaxBufferWords );
+        for ( INDEX wx = 0; wx < m_MaxBufferWords; ++wx )
+            pSlot->m_Buffer[wx].setW( (static_cast<UINT64>( m_Slots.size() ) << 24) ^ wx );
+    }
+    else
+    {
+        pSlot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    }
+
+    const IoCapture::Record* pRecord = step.m_pRecord;
+    const ScratchConfiguration::Pack* pPack = step.m_pPack;
+    ChannelModule::ChannelProgram* pChannelProgram = &pSlot->m_ChannelProgram;
+    pChannelProgram->m_ChannelModuleAddress = pPack->m_ChannelModuleAddress;
+    pChannelProgram->m_ControllerAddress = pPack->m_ControllerAddress;
+    pChannelProgram->m_DeviceAddress = pPack->m_DeviceAddress;
+    pChannelProgram->m_Command = static_cast<ChannelModule::Command>( pRecord->m_Command );
+    pChannelProgram->m_Address = pRecord->m_Address;
+    pChannelProgram->m_TransferSizeWords = pRecord->m_TransferSizeWords;
+    pChannelProgram->m_Format = static_cast<ChannelModule::IoTranslateFormat>( pRecord->m_Format );
+    pChannelProgram->m_AccessControlList.clear();
+    pChannelProgram->m_AccessControlList.push_back( IoAccessControlWord( &pSlot->m_Buffer[0],
+                                                                         pRecord->m_BufferWords,
+                                                                         EXIOBAM_INCREMENT ) );
+    pChannelProgram->m_BytesTransferred = 0;
+    pChannelProgram->m_WordsTransferred = 0;
+    pChannelProgram->m_DeviceStatus = Device::IoStatus::SUCCESSFUL;
+    pChannelProgram->m_SystemErrorCode = 0;
+    pSlot->m_pHistogram = (pChannelProgram->m_Command == ChannelModule::Command::READ) ? &m_ReadHistogram : &m_WriteHistogram;
+
+    if ( m_Settings.m_SpeedPercent )
+        m_LatenessHistogram.record( nowMicros - (startMicros + step.m_DueMicros) );
+
+    m_InFlightSlots.push_back( pSlot );
+    if ( m_InFlightSlots.size() > m_Result.m_MaxInFlight )
+        m_Result.m_MaxInFlight = m_InFlightSlots.size();
+
+    pSlot->m_StartMicros = LatencyHistogram::getMicroseconds();
+    m_Configuration.routeIo( pChannelProgram );
+}
+
+
+//  worker()
+//
+//  The whole run - set up, inquire, replay, tear down
+void
+IoReplay::worker()
+{
+    if ( m_Configuration.build( this, m_Settings.m_IoAffinity, &m_ErrorMessage ) )
+    {
+        replay();
+        m_Result.m_Lateness = m_LatenessHistogram.getSnapshot();
+        m_Result.m_Latency = m_LatencyHistogram.getSnapshot();
+        m_Result.m_ReadLatency = m_ReadHistogram.getSnapshot();
+        m_Result.m_WriteLatency = m_WriteHistogram.getSnapshot();
+        if ( isWorkerTerminating() )
+            m_ErrorMessage = "Terminated";
+    }
+
+    m_Configuration.tearDown();
+}
+
+
+
+//  constructors, destructors
+
+IoReplay::IoReplay
+(
+    const Settings&     settings
+)
+:Worker( "IoReplay" ),
+        m_Configuration( settings.m_Directory, PACK_FILE_PREFIX ),
+        m_MaxBufferWords( 0 ),
+        m_Settings( settings )
+{
+}
+
+
+IoReplay::~IoReplay()
+{
+    workerStop( true );
+}
+
+
+
+//  public methods
+
+//  run()
+//
+//  Loads and plans the capture, then does the replay on our worker thread, and waits for it.
+//
+//  Returns:
+//      true if successful - otherwise, getErrorMessage() says why
+bool
+IoReplay::run()
+{
+    if ( (m_Settings.m_SpeedPercent == 0) && (m_Settings.m_QueueDepth == 0) )
+    {
+        m_ErrorMessage = "Invalid settings";
+        return false;
+    }
+
+    if ( !IoCapture::load( m_Settings.m_FileName, &m_Records, &m_ErrorMessage ) || !plan() )
+        return false;
+
+    if ( !workerStart() )
+    {
+        m_ErrorMessage = "Cannot start worker thread";
+        return false;
+    }
+
+    workerJoin();
+    return m_ErrorMessage.empty();
+}
@@ -0,0 +1,165 @@
+//  IoReplay.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Re-issues an IoCapture against scratch packs, for comparing emulator builds on a real access pattern.
+//  Every disk path in the capture (IOP / channel module / controller / device) gets its own scratch pack,
+//  with the captured block size and at least enough blocks for the highest address used.  The packs are
+//  arranged in a ScratchConfiguration so that each captured channel module gets its own ChannelModule
+//  (so the host IO is spread over as many threads as it was), and each captured controller its own DiskController.  Only disk reads and writes are replayed;
+//  anything else (inquiries, tape IO, IO to devices which were not prepped) is counted and skipped.
+//
+//  At a non-zero speed, IOs are issued on the captured schedule (scaled by the speed percentage) regardless
+//  of how many are still in flight, so a slow build falls behind rather than stretching the pattern -
+//  the lateness distribution shows by how much.  At speed zero, IOs are issued as fast as possible with a
+//  fixed number in flight.  IOs which fail are counted, but do not end the run.
+//
+//  The packs are not filled, so reads of blocks which the replay has not yet written find holes.
+
+
+
+#ifndef     EMBENCH_IO_REPLAY_H
+#define     EMBENCH_IO_REPLAY_H
+
+
+
+class   IoReplay : public Worker
+{
+public:
+    class   Settings
+    {
+    public:
+        std::string             m_Directory;            //  where the scratch packs are created
+        std::string             m_FileName;             //  the capture
+        CpuSet                  m_IoAffinity;           //  for the channel modules, which do the host IO
+        COUNT                   m_QueueDepth;           //  channel programs kept in flight, at speed zero
+        COUNT                   m_SpeedPercent;         //  100 for the captured speed, zero for as fast as possible
+
+        Settings()
+            :m_Directory( "/tmp/" ),
+            m_QueueDepth( 4 ),
+            m_SpeedPercent( 100 )
+        {}
+    };
+
+    class   Result
+    {
+    public:
+        COUNT64                 m_CapturedMicros;       //  first to last replayed IO, as captured
+        COUNT                   m_ChannelModuleCount;
+        COUNT                   m_DeviceCount;
+        COUNT64                 m_ElapsedMicros;        //  first routeIo() to last completion
+        COUNT64                 m_Errors;
+        LatencyHistogram::Snapshot  m_Lateness;         //  routeIo() behind schedule - empty at speed zero
+        LatencyHistogram::Snapshot  m_Latency;          //  routeIo() to completion, per successful IO
+        COUNT                   m_MaxInFlight;
+        LatencyHistogram::Snapshot  m_ReadLatency;
+        COUNT64                 m_Reads;
+        COUNT64                 m_Skipped;              //  captured channel programs we did not replay
+        LatencyHistogram::Snapshot  m_WriteLatency;
+        COUNT64                 m_Writes;
+
+        Result()
+            :m_CapturedMicros( 0 ),
+            m_ChannelModuleCount( 0 ),
+            m_DeviceCount( 0 ),
+            m_ElapsedMicros( 0 ),
+            m_Errors( 0 ),
+            m_MaxInFlight( 0 ),
+            m_Reads( 0 ),
+            m_Skipped( 0 ),
+            m_Writes( 0 )
+        {}
+
+        inline double getIops() const
+        {
+            return m_ElapsedMicros ? (m_Reads + m_Writes) * 1000000.0 / m_ElapsedMicros : 0.0;
+        }
+    };
+
+private:
+    //  One in-flight position - a channel program and the buffer its ACW describes
+    class   Slot
+    {
+    public:
+        std::vector<Word36>     m_Buffer;
+        ChannelModule::ChannelProgram   m_ChannelProgram;
+        LatencyHistogram*       m_pHistogram;           //  read or write latency
+        COUNT64                 m_StartMicros;
+
+        Slot( Worker* const pSource )
+            :m_ChannelProgram( pSource ),
+            m_pHistogram( 0 ),
+            m_StartMicros( 0 )
+        {}
+    };
+
+    //  One replayable capture record, resolved to its replay path
+    class   Step
+    {
+    public:
+        COUNT64                 m_DueMicros;            //  from the start of the replay, at the captured speed
+        const IoCapture::Record*    m_pRecord;
+        const ScratchConfiguration::Pack*   m_pPack;
+
+        Step( const COUNT64                         dueMicros,
+              const IoCapture::Record*              pRecord,
+              const ScratchConfiguration::Pack*     pPack )
+            :m_DueMicros( dueMicros ),
+            m_pRecord( pRecord ),
+            m_pPack( pPack )
+        {}
+    };
+
+    //  Each captured disk path maps to the scratch pack which stands in for it.  The pack's block count starts
+    //  as the highest block used plus one, and becomes the size of the pack once plan() has seen everything.
+    typedef     std::map<UINT64, ScratchConfiguration::Pack*>   PACKS;  //  keyed by captured path
+    typedef     PACKS::iterator                         ITPACKS;
+
+    typedef     std::map<UINT64, Node::NODE_ADDRESS>    CHANNEL_MODULE_ADDRESSES;   //  by captured UPI and address
+
+    typedef     std::list<Slot>                         SLOTS;
+    typedef     SLOTS::iterator                         ITSLOTS;
+
+    typedef     std::vector<Step>                       STEPS;
+
+    ScratchConfiguration        m_Configuration;
+    std::string                 m_ErrorMessage;
+    std::vector<Slot*>          m_FreeSlots;
+    std::vector<Slot*>          m_InFlightSlots;
+    LatencyHistogram            m_LatenessHistogram;
+    LatencyHistogram            m_LatencyHistogram;
+    WORD_COUNT                  m_MaxBufferWords;
+    PACKS                       m_Packs;
+    LatencyHistogram            m_ReadHistogram;
+    IoCapture::RECORDS          m_Records;
+    Result                      m_Result;
+    const Settings              m_Settings;
+    SLOTS                       m_Slots;
+    STEPS                       m_Steps;
+    LatencyHistogram            m_WriteHistogram;
+
+    void                        completeSlot( Slot* const pSlot );
+    bool                        plan();
+    void                        replay();
+    void                        startStep( const Step&      step,
+                                           const COUNT64    startMicros,
+                                           const COUNT64    nowMicros );
+
+    //  Worker interface
+    void                        worker();
+    bool                        isWorkerClockParticipant() const    { return false; }
+
+public:
+    IoReplay( const Settings& settings );
+    ~IoReplay();
+
+    bool                        run();
+
+    inline const std::string&   getErrorMessage() const             { return m_ErrorMessage; }
+    inline const Result&        getResult() const                   { return m_Result; }
+    inline const Settings&      getSettings() const                 { return m_Settings; }
+};
+
+
+
+#endif
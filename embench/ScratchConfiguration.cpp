@@ -0,0 +1,273 @@
+//  ScratchConfiguration.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "embench.h"
+
+
+
+//  local constants
+#define     INQUIRY_WORDS               28
+
+
+
+//  private methods
+
+//  buildNodes()
+//
+//  Builds IOP0, the channel modules, one disk controller per channel module and controller address,
+//  and one device per pack, mounts the packs, and starts the channel modules.
+bool
+ScratchConfiguration::buildNodes
+(
+    const CpuSet&       ioAffinity,
+    std::string* const  pErrorMessage
+)
+{
+    COUNT channelModuleCount = 0;
+    for ( ITPACKS itp = m_Packs.begin(); itp != m_Packs.end(); ++itp )
+    {
+        if ( itp->m_ChannelModuleAddress >= channelModuleCount )
+            channelModuleCount = itp->m_ChannelModuleAddress + 1;
+    }
+
+    m_pIOProcessor = new IOProcessor( "IOP0" );
+    for ( COUNT cmx = 0; cmx < channelModuleCount; ++cmx )
+    {
+        std::stringstream strm;
+        strm << "CM0-" << cmx;
+        ChannelModule* pChannelModule = new ChannelModule( strm.str() );
+        m_ChannelModules.push_back( pChannelModule );
+        Node::connect( m_pIOProcessor, static_cast<Node::NODE_ADDRESS>( cmx ), pChannelModule );
+    }
+
+    INDEX devx = 0;
+    for ( ITPACKS itp = m_Packs.begin(); itp != m_Packs.end(); ++itp, ++devx )
+    {
+        UINT64 controllerKey = (static_cast<UINT64>( itp->m_ChannelModuleAddress ) << 32) | itp->m_ControllerAddress;
+        ITCONTROLLERS itc = m_Controllers.find( controllerKey );
+        if ( itc == m_Controllers.end() )
+        {
+            std::stringstream strm;
+            strm << "DSKCTL" << m_Controllers.size();
+            DiskController* pController = new DiskController( strm.str() );
+            itc = m_Controllers.insert( std::make_pair( controllerKey, pController ) ).first;
+            Node::connect( m_ChannelModules[itp->m_ChannelModuleAddress], itp->m_ControllerAddress, pController );
+        }
+
+        std::stringstream strm;
+        strm << "DISK" << devx;
+        itp->m_pDevice = new FileSystemDiskDevice( strm.str() );
+        Node::connect( itc->second, itp->m_DeviceAddress, itp->m_pDevice );
+
+        if ( !itp->m_pDevice->mount( itp->m_FileName ) )
+        {
+            *pErrorMessage = "Cannot mount " + itp->m_FileName;
+            return false;
+        }
+
+        itp->m_pDevice->setReady( true );
+        itp->m_pDevice->setIsWriteProtected( false );
+    }
+
+    for ( ITCHANNEL_MODULES itcm = m_ChannelModules.begin(); itcm != m_ChannelModules.end(); ++itcm )
+    {
+        if ( !ioAffinity.isEmpty() && !(*itcm)->setAffinity( ioAffinity ) )
+        {
+            *pErrorMessage = "Cannot pin the channel modules to CPUs " + ioAffinity.getSpecification();
+            return false;
+        }
+
+        (*itcm)->initialize();
+    }
+
+    return true;
+}
+
+
+//  createPacks()
+//
+//  Creates the scratch packs, replacing any left behind by an earlier run which did not finish
+bool
+ScratchConfiguration::createPacks
+(
+    std::string* const  pErrorMessage
+)
+{
+    for ( ITPACKS itp = m_Packs.begin(); itp != m_Packs.end(); ++itp )
+    {
+        std::remove( itp->m_FileName.c_str() );
+        if ( !FileSystemDiskDevice::createPack( itp->m_FileName, itp->m_BlockSize, itp->m_BlockCount, pErrorMessage ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+//  deletePacks()
+void
+ScratchConfiguration::deletePacks()
+{
+    for ( ITPACKS itp = m_Packs.begin(); itp != m_Packs.end(); ++itp )
+        std::remove( itp->m_FileName.c_str() );
+}
+
+
+//  inquire()
+//
+//  Does an inquiry on one pack, as the exec does when a disk comes up - this clears the unit attention
+//  which the device raised when it was made ready.  The completion is signalled to the given worker,
+//  on whose thread we must be called.
+bool
+ScratchConfiguration::inquire
+(
+    Worker* const       pWorker,
+    const Pack&         pack,
+    std::string* const  pErrorMessage
+)
+{
+    Word36 buffer[INQUIRY_WORDS];
+    ChannelModule::ChannelProgram channelProgram( pWorker );
+    channelProgram.m_ChannelModuleAddress = pack.m_ChannelModuleAddress;
+    channelProgram.m_ControllerAddress = pack.m_ControllerAddress;
+    channelProgram.m_DeviceAddress = pack.m_DeviceAddress;
+    channelProgram.m_Command = ChannelModule::Command::INQUIRY;
+    channelProgram.m_AccessControlList.push_back( IoAccessControlWord( buffer, INQUIRY_WORDS, EXIOBAM_INCREMENT ) );
+    channelProgram.m_Format = ChannelModule::IoTranslateFormat::C;
+    channelProgram.m_TransferSizeWords = INQUIRY_WORDS;
+
+    m_pIOProcessor->routeIo( &channelProgram );
+    while ( channelProgram.m_ChannelStatus == ChannelModule::Status::IN_PROGRESS )
+        pWorker->workerWait( 10 );
+
+    if ( channelProgram.m_ChannelStatus != ChannelModule::Status::SUCCESSFUL )
+    {
+        *pErrorMessage = "Inquiry failed on " + pack.m_pDevice->getName()
+            + " - " + ChannelModule::getStatusString( channelProgram.m_ChannelStatus );
+        return false;
+    }
+
+    return true;
+}
+
+
+
+//  constructors, destructors
+
+ScratchConfiguration::ScratchConfiguration
+(
+    const std::string&  directory,
+    const std::string&  filePrefix
+)
+:m_Directory( directory ),
+        m_FilePrefix( filePrefix ),
+        m_pIOProcessor( 0 )
+{
+}
+
+
+ScratchConfiguration::~ScratchConfiguration()
+{
+    tearDown();
+}
+
+
+
+//  public methods
+
+//  addPack()
+//
+//  Describes another pack, and names its scratch file - nothing is created until build()
+ScratchConfiguration::Pack*
+ScratchConfiguration::addPack
+(
+    const BLOCK_SIZE            blockSize,
+    const BLOCK_COUNT           blockCount,
+    const Node::NODE_ADDRESS    channelModuleAddress,
+    const Node::NODE_ADDRESS    controllerAddress,
+    const Node::NODE_ADDRESS    deviceAddress
+)
+{
+    std::stringstream strm;
+    strm << m_Directory;
+    if ( !m_Directory.empty() && (m_Directory.back() != '/') )
+        strm << "/";
+    strm << m_FilePrefix << std::setw( 3 ) << std::setfill( '0' ) << m_Packs.size() << ".dsk";
+
+    m_Packs.push_back( Pack() );
+    Pack* pPack = &m_Packs.back();
+    pPack->m_BlockSize = blockSize;
+    pPack->m_BlockCount = blockCount;
+    pPack->m_ChannelModuleAddress = channelModuleAddress;
+    pPack->m_ControllerAddress = controllerAddress;
+    pPack->m_DeviceAddress = deviceAddress;
+    pPack->m_FileName = strm.str();
+    return pPack;
+}
+
+
+//  build()
+//
+//  Creates the packs, builds and starts the configuration, and does an inquiry on every pack.
+//  Must be called on the given worker's thread, which receives the inquiry completions.
+//  If we fail, the caller should still tearDown().
+//
+//  Returns:
+//      true if successful - otherwise, *pErrorMessage says why
+bool
+ScratchConfiguration::build
+(
+    Worker* const       pWorker,
+    const CpuSet&       ioAffinity,
+    std::string* const  pErrorMessage
+)
+{
+    if ( !createPacks( pErrorMessage ) || !buildNodes( ioAffinity, pErrorMessage ) )
+        return false;
+
+    for ( ITPACKS itp = m_Packs.begin(); itp != m_Packs.end(); ++itp )
+    {
+        if ( !inquire( pWorker, *itp, pErrorMessage ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+//  tearDown()
+//
+//  Stops the channel modules, discards the configuration, and deletes the packs.  Nothing may be in flight.
+void
+ScratchConfiguration::tearDown()
+{
+    for ( ITCHANNEL_MODULES itcm = m_ChannelModules.begin(); itcm != m_ChannelModules.end(); ++itcm )
+        (*itcm)->terminate();
+
+    for ( ITPACKS itp = m_Packs.begin(); itp != m_Packs.end(); ++itp )
+    {
+        FileSystemDiskDevice* pDevice = itp->m_pDevice;
+        if ( pDevice )
+        {
+            if ( pDevice->isMounted() )
+                pDevice->unmount();
+            delete pDevice;
+            itp->m_pDevice = 0;
+        }
+    }
+
+    for ( ITCONTROLLERS itc = m_Controllers.begin(); itc != m_Controllers.end(); ++itc )
+        delete itc->second;
+    m_Controllers.clear();
+
+    for ( ITCHANNEL_MODULES itcm = m_ChannelModules.begin(); itcm != m_ChannelModules.end(); ++itcm )
+        delete *itcm;
+    m_ChannelModules.clear();
+
+    delete m_pIOProcessor;
+    m_pIOProcessor = 0;
+
+    deletePacks();
+}
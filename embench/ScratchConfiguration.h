@@ -0,0 +1,94 @@
+//  ScratchConfiguration.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  A private IOProcessor / ChannelModule / DiskController / FileSystemDiskDevice configuration on freshly-created
+//  scratch packs, for the benchmarks which drive the disk IO stack without an exec.  The caller describes
+//  each pack - its size, and the channel module, controller, and device addresses at which it should appear -
+//  then build() creates the packs, builds and starts the configuration, and does an inquiry on every pack.
+//  tearDown() (which the destructor also does) discards the configuration and deletes the packs.
+//
+//  Channel modules are numbered from zero, up to the highest one any pack uses; there is one disk controller
+//  for each channel module and controller address which any pack uses.
+
+
+
+#ifndef     EMBENCH_SCRATCH_CONFIGURATION_H
+#define     EMBENCH_SCRATCH_CONFIGURATION_H
+
+
+
+class   ScratchConfiguration
+{
+public:
+    //  One scratch pack, and where its device appears in the configuration
+    class   Pack
+    {
+    public:
+        BLOCK_SIZE              m_BlockSize;
+        BLOCK_COUNT             m_BlockCount;
+        Node::NODE_ADDRESS      m_ChannelModuleAddress;
+        Node::NODE_ADDRESS      m_ControllerAddress;
+        Node::NODE_ADDRESS      m_DeviceAddress;
+        FileSystemDiskDevice*   m_pDevice;              //  while the configuration is built
+        std::string             m_FileName;
+
+        Pack()
+            :m_BlockSize( 0 ),
+            m_BlockCount( 0 ),
+            m_ChannelModuleAddress( 0 ),
+            m_ControllerAddress( 0 ),
+            m_DeviceAddress( 0 ),
+            m_pDevice( 0 )
+        {}
+    };
+
+private:
+    typedef     std::list<Pack>                         PACKS;          //  a list, so that Pack pointers stay put
+    typedef     PACKS::iterator                         ITPACKS;
+
+    typedef     std::vector<ChannelModule*>             CHANNEL_MODULES;
+    typedef     CHANNEL_MODULES::iterator               ITCHANNEL_MODULES;
+
+    typedef     std::map<UINT64, DiskController*>       CONTROLLERS;    //  by channel module and controller address
+    typedef     CONTROLLERS::iterator                   ITCONTROLLERS;
+
+    CHANNEL_MODULES             m_ChannelModules;
+    CONTROLLERS                 m_Controllers;
+    const std::string           m_Directory;
+    const std::string           m_FilePrefix;
+    IOProcessor*                m_pIOProcessor;
+    PACKS                       m_Packs;
+
+    bool                        buildNodes( const CpuSet&       ioAffinity,
+                                            std::string* const  pErrorMessage );
+    bool                        createPacks( std::string* const pErrorMessage );
+    void                        deletePacks();
+    bool                        inquire( Worker* const          pWorker,
+                                         const Pack&            pack,
+                                         std::string* const     pErrorMessage );
+
+public:
+    ScratchConfiguration( const std::string&    directory,
+                          const std::string&    filePrefix );
+    ~ScratchConfiguration();
+
+    Pack*                       addPack( const BLOCK_SIZE           blockSize,
+                                         const BLOCK_COUNT          blockCount,
+                                         const Node::NODE_ADDRESS   channelModuleAddress,
+                                         const Node::NODE_ADDRESS   controllerAddress,
+                                         const Node::NODE_ADDRESS   deviceAddress );
+    bool                        build( Worker* const        pWorker,
+                                       const CpuSet&        ioAffinity,
+                                       std::string* const   pErrorMessage );
+    void                        tearDown();
+
+    inline COUNT                getPackCount() const                { return m_Packs.size(); }
+    inline void                 routeIo( ChannelModule::ChannelProgram* const pChannelProgram )
+    {
+        m_pIOProcessor->routeIo( pChannelProgram );
+    }
+};
+
+
+
+#endif
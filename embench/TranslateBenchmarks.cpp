@@ -0,0 +1,167 @@
+//  TranslateBenchmarks.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "embench.h"
+
+
+
+//  Fixture
+
+//  Sets up one channel program, with a single incrementing ACW over a block of words which are valid
+//  for the format (A and D stop at a quarter-word with its MSBit set), and the frames for the same block.
+TranslateBenchmarks::Fixture::Fixture
+(
+    const IoTranslateFormat     format,
+    const COUNT                 wordCount
+)
+:m_ChannelProgram( 0 ),
+        m_pChildIo( 0 ),
+        m_ConversionBuffer( getByteCountFromWordCount( wordCount, format ) ),
+        m_Tracker( &m_ChannelProgram ),
+        m_pWordBuffer( new Word36[wordCount] )
+{
+    std::mt19937_64 random( 2200 );
+    for ( INDEX wx = 0; wx < wordCount; ++wx )
+        m_pWordBuffer[wx].setW( format == IoTranslateFormat::A ? random() & 0377377377377ll : random() );
+
+    m_ChannelProgram.m_Format = format;
+    m_ChannelProgram.m_TransferSizeWords = wordCount;
+    m_ChannelProgram.m_AccessControlList.push_back( IoAccessControlWord( m_pWordBuffer, wordCount, EXIOBAM_INCREMENT ) );
+
+    m_pChildIo = new Device::IoInfo( 0,
+                                     Device::IoFunction::READ,
+                                     m_ConversionBuffer.m_pBuffer,
+                                     0,
+                                     m_ConversionBuffer.m_BufferSizeBytes );
+    m_pChildIo->setBytesTransferred( m_ConversionBuffer.m_BufferSizeBytes );
+
+    m_Tracker.m_pConversionBuffer = &m_ConversionBuffer;
+    m_Tracker.m_pChildIo = m_pChildIo;
+    m_Tracker.m_TransferSizeBytes = m_ConversionBuffer.m_BufferSizeBytes;
+}
+
+
+TranslateBenchmarks::Fixture::~Fixture()
+{
+    delete m_pChildIo;
+    delete[] m_pWordBuffer;
+}
+
+
+
+//  private methods
+
+//  createFixture()
+//
+//  Creates a fixture which we keep until we are destroyed, and fills its frames from its words
+TranslateBenchmarks::Fixture*
+TranslateBenchmarks::createFixture
+(
+    const IoTranslateFormat     format,
+    const COUNT                 wordCount
+)
+{
+    Fixture* pFixture = new Fixture( format, wordCount );
+    m_Fixtures.push_back( pFixture );
+
+    switch ( format )
+    {
+    case IoTranslateFormat::A:  translateToA( &pFixture->m_Tracker, false );    break;
+    case IoTranslateFormat::B:  translateToB( &pFixture->m_Tracker );           break;
+    case IoTranslateFormat::C:  translateToC( &pFixture->m_Tracker );           break;
+    default:                                                                    break;
+    }
+
+    return pFixture;
+}
+
+
+
+//  constructors, destructors
+
+TranslateBenchmarks::~TranslateBenchmarks()
+{
+    for ( ITFIXTURES itf = m_Fixtures.begin(); itf != m_Fixtures.end(); ++itf )
+        delete *itf;
+}
+
+
+
+//  public methods
+
+//  create()
+//
+//  Adds a To and a From benchmark for each format, for blocks of the given size, to the given container.
+//  They refer to our fixtures, so we must outlive them.
+void
+TranslateBenchmarks::create
+(
+    BENCHMARKS* const   pBenchmarks,
+    const COUNT         wordCount
+)
+{
+    std::stringstream strm;
+    strm << "/" << wordCount;
+    const std::string suffix = strm.str();
+
+    Fixture* pA = createFixture( IoTranslateFormat::A, wordCount );
+    Fixture* pB = createFixture( IoTranslateFormat::B, wordCount );
+    Fixture* pC = createFixture( IoTranslateFormat::C, wordCount );
+    const COUNT bytesA = pA->m_ConversionBuffer.m_BufferSizeBytes;
+    const COUNT bytesB = pB->m_ConversionBuffer.m_BufferSizeBytes;
+    const COUNT bytesC = pC->m_ConversionBuffer.m_BufferSizeBytes;
+
+    pBenchmarks->push_back( new Benchmark( "ChannelModule.translateToA" + suffix, wordCount, bytesA,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                translateToA( &pA->m_Tracker, false );
+            return pA->m_ChannelProgram.m_BytesTransferred;
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "ChannelModule.translateFromA" + suffix, wordCount, bytesA,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            COUNT residue = 0;
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                translateFromA( &pA->m_Tracker, &residue );
+            return pA->m_ChannelProgram.m_WordsTransferred + residue;
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "ChannelModule.translateToB" + suffix, wordCount, bytesB,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                translateToB( &pB->m_Tracker );
+            return pB->m_ChannelProgram.m_BytesTransferred;
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "ChannelModule.translateFromB" + suffix, wordCount, bytesB,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            COUNT residue = 0;
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                translateFromB( &pB->m_Tracker, &residue );
+            return pB->m_ChannelProgram.m_WordsTransferred + residue;
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "ChannelModule.translateToC" + suffix, wordCount, bytesC,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                translateToC( &pC->m_Tracker );
+            return pC->m_ChannelProgram.m_BytesTransferred;
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "ChannelModule.translateFromC" + suffix, wordCount, bytesC,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            COUNT residue = 0;
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                translateFromC( &pC->m_Tracker, &residue );
+            return pC->m_ChannelProgram.m_WordsTransferred + residue;
+        } ) );
+}
+
@@ -0,0 +1,54 @@
+//  TranslateBenchmarks.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Benchmarks for the ChannelModule A, B, and C format translations, in both directions, for a single
+//  block of some number of words described by one ACW - which is how disk IO arrives from the exec.
+//  We are a ChannelModule (never started) only so that we can get at the translation methods;
+//  Bytes per iteration, for the GB/s figure, are the frames produced or consumed.
+
+
+
+#ifndef     EMBENCH_TRANSLATE_BENCHMARKS_H
+#define     EMBENCH_TRANSLATE_BENCHMARKS_H
+
+
+
+class   TranslateBenchmarks : public ChannelModule
+{
+private:
+    class   Fixture
+    {
+    public:
+        ChannelProgram          m_ChannelProgram;
+        Device::IoInfo*         m_pChildIo;             //  for the From translations
+        ConversionBuffer        m_ConversionBuffer;
+        Tracker                 m_Tracker;
+        Word36*                 m_pWordBuffer;
+
+        Fixture( const IoTranslateFormat    format,
+                 const COUNT                wordCount );
+        ~Fixture();
+    };
+
+    typedef     std::vector<Fixture*>               FIXTURES;
+    typedef     FIXTURES::iterator                  ITFIXTURES;
+
+    FIXTURES                    m_Fixtures;
+
+    Fixture*                    createFixture( const IoTranslateFormat  format,
+                                               const COUNT              wordCount );
+
+public:
+    TranslateBenchmarks()
+        :ChannelModule( "BENCH" )
+    {}
+
+    ~TranslateBenchmarks();
+
+    void                        create( BENCHMARKS* const   pBenchmarks,
+                                        const COUNT         wordCount );
+};
+
+
+
+#endif
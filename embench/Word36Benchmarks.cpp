@@ -0,0 +1,173 @@
+//  Word36Benchmarks.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "embench.h"
+
+
+
+//  constructors, destructors
+
+//  Fills the source buffers with reproducible content - the same seed every run
+Word36Benchmarks::Word36Benchmarks
+(
+    const COUNT         wordCount
+)
+:m_pPackedBuffer( new BYTE[(wordCount * 9 + 1) / 2] ),
+        m_pSourceBuffer( new Word36[wordCount] ),
+        m_pTargetBuffer( new Word36[wordCount] ),
+        m_WordCount( wordCount )
+{
+    std::mt19937_64 random( 2200 );
+    for ( INDEX wx = 0; wx < m_WordCount; ++wx )
+        m_pSourceBuffer[wx].setW( random() );
+
+    const std::string sample = "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789 ";
+    for ( INDEX cx = 0; cx < m_WordCount * 6; ++cx )
+    {
+        m_FieldataText += sample[cx % sample.size()];
+        if ( cx < m_WordCount * 4 )
+            m_AsciiText += sample[cx % sample.size()];
+    }
+
+    miscWord36Pack( m_pPackedBuffer, m_pSourceBuffer, m_WordCount );
+}
+
+
+Word36Benchmarks::~Word36Benchmarks()
+{
+    delete[] m_pPackedBuffer;
+    delete[] m_pSourceBuffer;
+    delete[] m_pTargetBuffer;
+}
+
+
+
+//  public methods
+
+//  create()
+//
+//  Adds our benchmarks to the given container.  They refer to our buffers, so we must outlive them.
+void
+Word36Benchmarks::create
+(
+    BENCHMARKS* const   pBenchmarks
+)
+{
+    std::stringstream strm;
+    strm << "/" << m_WordCount;
+    const std::string suffix = strm.str();
+    const COUNT words = m_WordCount;
+    const Word36* const pSource = m_pSourceBuffer;
+    Word36* const pTarget = m_pTargetBuffer;
+    BYTE* const pPacked = m_pPackedBuffer;
+    const std::string& asciiText = m_AsciiText;
+    const std::string& fieldataText = m_FieldataText;
+
+    pBenchmarks->push_back( new Benchmark( "Word36.getPartial" + suffix, words, words * 8,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            UINT64 sum = 0;
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+            {
+                for ( INDEX wx = 0; wx < words; ++wx )
+                {
+                    const Word36& word = pSource[wx];
+                    sum += word.getH1() + word.getH2()
+                        + word.getQ1() + word.getQ2() + word.getQ3() + word.getQ4()
+                        + word.getS1() + word.getS2() + word.getS3() + word.getS4() + word.getS5() + word.getS6()
+                        + word.getT1() + word.getT2() + word.getT3();
+                }
+            }
+            return sum;
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "Word36.setPartial" + suffix, words, words * 8,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+            {
+                for ( INDEX wx = 0; wx < words; ++wx )
+                {
+                    UINT64 value = pSource[wx].getW() + ix;
+                    Word36& word = pTarget[wx];
+                    word.setH1( value );
+                    word.setQ3( value );
+                    word.setS5( value );
+                    word.setT3( value );
+                }
+            }
+            return pTarget[0].getW() + pTarget[words - 1].getW();
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "miscOnesCompAdd36" + suffix, words, words * 8,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            UINT64 sum = 0;
+            bool carry = false;
+            bool overflow = false;
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+            {
+                for ( INDEX wx = 0; wx < words; ++wx )
+                    sum = miscOnesCompAdd36( sum, pSource[wx].getW(), &carry, &overflow );
+            }
+            return sum + (carry ? 1 : 0) + (overflow ? 2 : 0);
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "miscOnesCompSubtract36" + suffix, words, words * 8,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            UINT64 difference = 0;
+            bool carry = false;
+            bool overflow = false;
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+            {
+                for ( INDEX wx = 0; wx < words; ++wx )
+                    difference = miscOnesCompSubtract36( difference, pSource[wx].getW(), &carry, &overflow );
+            }
+            return difference + (carry ? 1 : 0) + (overflow ? 2 : 0);
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "miscStringToWord36Ascii" + suffix, words, words * 4,
+        [=, &asciiText]( const COUNT64 iterations ) -> UINT64
+        {
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                miscStringToWord36Ascii( asciiText, pTarget );
+            return pTarget[0].getW() + pTarget[words - 1].getW();
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "miscStringToWord36Fieldata" + suffix, words, words * 6,
+        [=, &fieldataText]( const COUNT64 iterations ) -> UINT64
+        {
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                miscStringToWord36Fieldata( fieldataText, pTarget );
+            return pTarget[0].getW() + pTarget[words - 1].getW();
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "miscWord36FieldataToString" + suffix, words, words * 6,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            UINT64 sum = 0;
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                sum += miscWord36FieldataToString( pSource, words ).size();
+            return sum;
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "miscWord36Pack" + suffix, words, words * 9 / 2,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                miscWord36Pack( pPacked, pSource, words );
+            return pPacked[0] + pPacked[words * 9 / 2 - 1];
+        } ) );
+
+    pBenchmarks->push_back( new Benchmark( "miscWord36Unpack" + suffix, words, words * 9 / 2,
+        [=]( const COUNT64 iterations ) -> UINT64
+        {
+            for ( COUNT64 ix = 0; ix < iterations; ++ix )
+                miscWord36Unpack( pTarget, pPacked, words );
+            return pTarget[0].getW() + pTarget[words - 1].getW();
+        } ) );
+}
+
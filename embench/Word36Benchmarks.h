@@ -0,0 +1,35 @@
+//  Word36Benchmarks.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Benchmarks for the Word36 partial-word accessors, and for the misclib ones-complement arithmetic,
+//  character conversion, and pack/unpack primitives, each applied to a buffer of some number of words.
+//  Bytes per iteration, for the GB/s figure, are those of the byte-stream side of a conversion,
+//  or 8 per word (host storage) for operations which stay in Word36 form.
+
+
+
+#ifndef     EMBENCH_WORD36_BENCHMARKS_H
+#define     EMBENCH_WORD36_BENCHMARKS_H
+
+
+
+class   Word36Benchmarks
+{
+private:
+    std::string                 m_AsciiText;
+    BYTE*                       m_pPackedBuffer;
+    std::string                 m_FieldataText;
+    Word36*                     m_pSourceBuffer;        //  random 36-bit values
+    Word36*                     m_pTargetBuffer;
+    const COUNT                 m_WordCount;
+
+public:
+    Word36Benchmarks( const COUNT wordCount );
+    ~Word36Benchmarks();
+
+    void                        create( BENCHMARKS* const pBenchmarks );
+};
+
+
+
+#endif
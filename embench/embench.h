@@ -0,0 +1,26 @@
+//  Common header file for embench
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#ifndef EMBENCH_H
+#define	EMBENCH_H
+
+
+
+#include    "../misclib/misclib.h"
+#include    "../hardwarelib/hardwarelib.h"
+
+#include    <functional>
+#include    <random>
+
+#include    "Benchmark.h"
+#include    "ScratchConfiguration.h"
+#include    "DiskBenchmark.h"
+#include    "IoReplay.h"
+#include    "TranslateBenchmarks.h"
+#include    "Word36Benchmarks.h"
+
+
+
+#endif	/* EMBENCH_H */
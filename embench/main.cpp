@@ -0,0 +1,647 @@
+//  Benchmark utility for emulator primitives
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Usage:
+//      embench [ -cpu n ] [ -trials n ] [ -warmup ms ] [ -time ms ] [ -csv ] [ name_filter ... ]
+//      embench -disk [ -cpu n ] [ -iocpu n ] [ -dir path ] [ -packs n ] [ -depth n ] [ -prep n ]
+//                    [ -read pct ] [ -seq ] [ -warmup ms ] [ -time ms ] [ -csv ]
+//      embench -replay capture_file [ -cpu n ] [ -iocpu n ] [ -dir path ] [ -speed pct ] [ -depth n ] [ -csv ]
+//
+//  The first form runs every benchmark whose name contains any of the filters (or all of them, if there are
+//  none), pinned to one host CPU, and reports the median ns/word and GB/s, with the best and worst trials.
+//  The second runs the disk IO stack against scratch packs (see DiskBenchmark) and reports IOPS, MB/s,
+//  and latency percentiles.  The third re-issues an IoCapture (see emssp /IOCAPTURE) against scratch packs
+//  (see IoReplay) and reports the latency distributions for reads, writes, and all IO, and how far behind
+//  the captured schedule the replay fell.
+//  Build with CONF=Release for numbers worth comparing - the Debug build is unoptimized.
+
+
+
+#include    "embench.h"
+
+
+
+//  local constants
+#define     DEFAULT_CPU                 0
+#define     TRANSLATE_BLOCK_WORDS       { 28, 448, 1792 }   //  one sector, one 2K block, one track
+#define     WORD36_BUFFER_WORDS         1792                //  must be even, for pack and unpack
+
+
+
+//  function prototypes
+
+static int      diskMain( const int argc,
+                          char**    argv );
+static bool     isSelected( const std::string&  name,
+                            const VSTRING&      filters );
+static bool     parseArguments( const int                   argc,
+                                char**                      argv,
+                                COUNT* const                pCpu,
+                                Benchmark::Settings* const  pSettings,
+                                bool* const                 pCsvFlag,
+                                VSTRING* const              pFilters );
+static bool     parseDiskArguments( const int                       argc,
+                                    char**                          argv,
+                                    COUNT* const                    pCpu,
+                                    DiskBenchmark::Settings* const  pSettings,
+                                    bool* const                     pCsvFlag );
+static bool     parseReplayArguments( const int                     argc,
+                                      char**                        argv,
+                                      COUNT* const                  pCpu,
+                                      IoReplay::Settings* const     pSettings,
+                                      bool* const                   pCsvFlag );
+static int      replayMain( const int   argc,
+                            char**      argv );
+static void     showUsage();
+
+
+
+//  ----------------------------------------------------------------------------
+//  Useful static functions
+//  ----------------------------------------------------------------------------
+
+//  diskMain()
+//
+//  main() for the -disk form
+static int
+diskMain
+(
+    const int           argc,
+    char**              argv
+)
+{
+    COUNT cpu = DEFAULT_CPU;
+    DiskBenchmark::Settings settings;
+    bool csvFlag = false;
+    if ( !parseDiskArguments( argc, argv, &cpu, &settings, &csvFlag ) )
+    {
+        showUsage();
+        return 1;
+    }
+
+    DiskBenchmark benchmark( settings );
+    std::stringstream cpuStrm;
+    cpuStrm << cpu;
+    CpuSet cpuSet;
+    if ( !CpuSet::parse( cpuStrm.str(), &cpuSet ) || !benchmark.workerSetAffinity( cpuSet ) )
+    {
+        std::cout << "Cannot pin to CPU " << cpu << std::endl;
+        return 1;
+    }
+
+    BLOCK_SIZE blockSize = miscGetBlockSizeFromPrepFactor( settings.m_PrepFactor );
+    if ( !csvFlag )
+    {
+        std::cout << "embench " << VERSION << std::endl;
+        std::cout << COPYRIGHT << std::endl;
+#ifndef __OPTIMIZE__
+        std::cout << "Warning:This is an unoptimized build - use CONF=Release for real numbers" << std::endl;
+#endif
+        std::cout << "Disk: " << settings.m_PackCount << " pack(s) in " << settings.m_Directory
+            << "  Prep:" << settings.m_PrepFactor << " (" << blockSize << " bytes)"
+            << "  Depth:" << settings.m_QueueDepth
+            << "  Read:" << settings.m_ReadPercent << "%"
+            << "  " << DiskBenchmark::getAccessPatternString( settings.m_AccessPattern )
+            << "  Warmup:" << settings.m_WarmupMillis << "ms"
+            << "  Time:" << settings.m_DurationMillis << "ms" << std::endl << std::endl;
+    }
+
+    if ( !benchmark.run() )
+    {
+        std::cout << "Error:" << benchmark.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    const DiskBenchmark::Result& result = benchmark.getResult();
+    const LatencyHistogram::Snapshot& latency = result.m_Latency;
+    std::stringstream strm;
+    strm << std::fixed << std::setprecision( 1 );
+    if ( csvFlag )
+    {
+        strm << "packs,prep,block_bytes,depth,read_percent,pattern,reads,writes,elapsed_us,iops,mb_per_second,"
+            << "mean_us,p50_us,p90_us,p99_us,p999_us,max_us" << std::endl;
+        strm << settings.m_PackCount
+            << "," << settings.m_PrepFactor
+            << "," << blockSize
+            << "," << settings.m_QueueDepth
+            << "," << settings.m_ReadPercent
+            << "," << DiskBenchmark::getAccessPatternString( settings.m_AccessPattern )
+            << "," << result.m_Reads
+            << "," << result.m_Writes
+            << "," << result.m_ElapsedMicros
+            << "," << result.getIops()
+            << "," << result.getMegabytesPerSecond()
+            << "," << latency.getMeanMicros()
+            << "," << latency.getPercentileMicros( 50.0 )
+            << "," << latency.getPercentileMicros( 90.0 )
+            << "," << latency.getPercentileMicros( 99.0 )
+            << "," << latency.getPercentileMicros( 99.9 )
+            << "," << latency.m_MaxMicros;
+    }
+    else
+    {
+        strm << std::right
+            << std::setw( 10 ) << "Reads"
+            << std::setw( 10 ) << "Writes"
+            << std::setw( 12 ) << "IOPS"
+            << std::setw( 10 ) << "MB/s"
+            << std::setw( 10 ) << "mean(us)"
+            << std::setw( 8 ) << "p50"
+            << std::setw( 8 ) << "p90"
+            << std::setw( 8 ) << "p99"
+            << std::setw( 8 ) << "p99.9"
+            << std::setw( 8 ) << "max" << std::endl;
+        strm << std::setw( 10 ) << result.m_Reads
+            << std::setw( 10 ) << result.m_Writes
+            << std::setw( 12 ) << result.getIops()
+            << std::setw( 10 ) << result.getMegabytesPerSecond()
+            << std::setw( 10 ) << latency.getMeanMicros()
+            << std::setw( 8 ) << latency.getPercentileMicros( 50.0 )
+            << std::setw( 8 ) << latency.getPercentileMicros( 90.0 )
+            << std::setw( 8 ) << latency.getPercentileMicros( 99.0 )
+            << std::setw( 8 ) << latency.getPercentileMicros( 99.9 )
+            << std::setw( 8 ) << latency.m_MaxMicros;
+    }
+
+    std::cout << strm.str() << std::endl;
+    return 0;
+}
+
+
+//  isSelected()
+//
+//  Indicates whether the named benchmark matches any of the filters (all do, if there are no filters)
+static bool
+isSelected
+(
+    const std::string&  name,
+    const VSTRING&      filters
+)
+{
+    if ( filters.empty() )
+        return true;
+
+    for ( VSTRING::const_iterator itf = filters.begin(); itf != filters.end(); ++itf )
+    {
+        if ( name.find( *itf ) != std::string::npos )
+            return true;
+    }
+
+    return false;
+}
+
+
+//  parseArguments()
+//
+//  Returns false for syntax error
+static bool
+parseArguments
+(
+    const int                   argc,
+    char**                      argv,
+    COUNT* const                pCpu,
+    Benchmark::Settings* const  pSettings,
+    bool* const                 pCsvFlag,
+    VSTRING* const              pFilters
+)
+{
+    for ( int ax = 1; ax < argc; ++ax )
+    {
+        SuperString arg( argv[ax] );
+        if ( arg.compareNoCase( "-csv" ) == 0 )
+        {
+            *pCsvFlag = true;
+            continue;
+        }
+
+        if ( arg[0] != '-' )
+        {
+            pFilters->push_back( arg );
+            continue;
+        }
+
+        if ( (ax + 1 == argc) || !SuperString( argv[ax + 1] ).isDecimalNumeric() )
+            return false;
+
+        COUNT32 value = SuperString( argv[++ax] ).toDecimal();
+        if ( arg.compareNoCase( "-cpu" ) == 0 )
+            *pCpu = value;
+        else if ( arg.compareNoCase( "-trials" ) == 0 )
+            pSettings->m_Trials = value;
+        else if ( arg.compareNoCase( "-warmup" ) == 0 )
+            pSettings->m_WarmupMillis = value;
+        else if ( arg.compareNoCase( "-time" ) == 0 )
+            pSettings->m_TrialMillis = value;
+        else
+            return false;
+    }
+
+    return true;
+}
+
+
+//  parseDiskArguments()
+//
+//  For the -disk form (argv[1] is -disk).  Returns false for syntax error
+static bool
+parseDiskArguments
+(
+    const int                       argc,
+    char**                          argv,
+    COUNT* const                    pCpu,
+    DiskBenchmark::Settings* const  pSettings,
+    bool* const                     pCsvFlag
+)
+{
+    for ( int ax = 2; ax < argc; ++ax )
+    {
+        SuperString arg( argv[ax] );
+        if ( arg.compareNoCase( "-csv" ) == 0 )
+        {
+            *pCsvFlag = true;
+            continue;
+        }
+
+        if ( arg.compareNoCase( "-seq" ) == 0 )
+        {
+            pSettings->m_AccessPattern = DiskBenchmark::AccessPattern::SEQUENTIAL;
+            continue;
+        }
+
+        if ( ax + 1 == argc )
+            return false;
+
+        if ( arg.compareNoCase( "-dir" ) == 0 )
+        {
+            pSettings->m_Directory = argv[++ax];
+            continue;
+        }
+
+        if ( arg.compareNoCase( "-iocpu" ) == 0 )
+        {
+            if ( !CpuSet::parse( argv[++ax], &pSettings->m_IoAffinity ) )
+                return false;
+            continue;
+        }
+
+        if ( !SuperString( argv[ax + 1] ).isDecimalNumeric() )
+            return false;
+
+        COUNT32 value = SuperString( argv[++ax] ).toDecimal();
+        if ( arg.compareNoCase( "-cpu" ) == 0 )
+            *pCpu = value;
+        else if ( arg.compareNoCase( "-depth" ) == 0 )
+            pSettings->m_QueueDepth = value;
+        else if ( arg.compareNoCase( "-packs" ) == 0 )
+            pSettings->m_PackCount = value;
+        else if ( arg.compareNoCase( "-prep" ) == 0 )
+            pSettings->m_PrepFactor = value;
+        else if ( arg.compareNoCase( "-read" ) == 0 )
+            pSettings->m_ReadPercent = value;
+        else if ( arg.compareNoCase( "-time" ) == 0 )
+            pSettings->m_DurationMillis = value;
+        else if ( arg.compareNoCase( "-warmup" ) == 0 )
+            pSettings->m_WarmupMillis = value;
+        else
+            return false;
+    }
+
+    return miscIsValidPrepFactor( pSettings->m_PrepFactor )
+        && (pSettings->m_PackCount > 0)
+        && (pSettings->m_QueueDepth > 0)
+        && (pSettings->m_ReadPercent <= 100);
+}
+
+
+//  parseReplayArguments()
+//
+//  For the -replay form (argv[1] is -replay, argv[2] is the capture file).  Returns false for syntax error
+static bool
+parseReplayArguments
+(
+    const int                       argc,
+    char**                          argv,
+    COUNT* const                    pCpu,
+    IoReplay::Settings* const       pSettings,
+    bool* const                     pCsvFlag
+)
+{
+    if ( (argc < 3) || (argv[2][0] == '-') )
+        return false;
+    pSettings->m_FileName = argv[2];
+
+    for ( int ax = 3; ax < argc; ++ax )
+    {
+        SuperString arg( argv[ax] );
+        if ( arg.compareNoCase( "-csv" ) == 0 )
+        {
+            *pCsvFlag = true;
+            continue;
+        }
+
+        if ( ax + 1 == argc )
+            return false;
+
+        if ( arg.compareNoCase( "-dir" ) == 0 )
+        {
+            pSettings->m_Directory = argv[++ax];
+            continue;
+        }
+
+        if ( arg.compareNoCase( "-iocpu" ) == 0 )
+        {
+            if ( !CpuSet::parse( argv[++ax], &pSettings->m_IoAffinity ) )
+                return false;
+            continue;
+        }
+
+        if ( !SuperString( argv[ax + 1] ).isDecimalNumeric() )
+            return false;
+
+        COUNT32 value = SuperString( argv[++ax] ).toDecimal();
+        if ( arg.compareNoCase( "-cpu" ) == 0 )
+            *pCpu = value;
+        else if ( arg.compareNoCase( "-depth" ) == 0 )
+            pSettings->m_QueueDepth = value;
+        else if ( arg.compareNoCase( "-speed" ) == 0 )
+            pSettings->m_SpeedPercent = value;
+        else
+            return false;
+    }
+
+    return (pSettings->m_SpeedPercent > 0) || (pSettings->m_QueueDepth > 0);
+}
+
+
+//  replayMain()
+//
+//  main() for the -replay form
+static int
+replayMain
+(
+    const int           argc,
+    char**              argv
+)
+{
+    COUNT cpu = DEFAULT_CPU;
+    IoReplay::Settings settings;
+    bool csvFlag = false;
+    if ( !parseReplayArguments( argc, argv, &cpu, &settings, &csvFlag ) )
+    {
+        showUsage();
+        return 1;
+    }
+
+    IoReplay replay( settings );
+    std::stringstream cpuStrm;
+    cpuStrm << cpu;
+    CpuSet cpuSet;
+    if ( !CpuSet::parse( cpuStrm.str(), &cpuSet ) || !replay.workerSetAffinity( cpuSet ) )
+    {
+        std::cout << "Cannot pin to CPU " << cpu << std::endl;
+        return 1;
+    }
+
+    if ( !csvFlag )
+    {
+        std::cout << "embench " << VERSION << std::endl;
+        std::cout << COPYRIGHT << std::endl;
+#ifndef __OPTIMIZE__
+        std::cout << "Warning:This is an unoptimized build - use CONF=Release for real numbers" << std::endl;
+#endif
+        std::cout << "Replay: " << settings.m_FileName << "  Packs in " << settings.m_Directory;
+        if ( settings.m_SpeedPercent )
+            std::cout << "  Speed:" << settings.m_SpeedPercent << "%";
+        else
+            std::cout << "  Speed:unpaced  Depth:" << settings.m_QueueDepth;
+        std::cout << std::endl << std::endl;
+    }
+
+    if ( !replay.run() )
+    {
+        std::cout << "Error:" << replay.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    const IoReplay::Result& result = replay.getResult();
+    const LatencyHistogram::Snapshot* snapshots[] =
+    {
+        &result.m_ReadLatency,
+        &result.m_WriteLatency,
+        &result.m_Latency,
+        &result.m_Lateness,
+    };
+    const char* labels[] = { "read", "write", "all", "late" };
+
+    std::stringstream strm;
+    strm << std::fixed << std::setprecision( 1 );
+    if ( csvFlag )
+    {
+        strm << "speed_percent,depth,packs,channel_modules,reads,writes,errors,skipped,max_in_flight,"
+            << "captured_us,elapsed_us,iops,latency,count,mean_us,p50_us,p90_us,p99_us,p999_us,max_us" << std::endl;
+        for ( INDEX sx = 0; sx < sizeof( labels ) / sizeof( labels[0] ); ++sx )
+        {
+            const LatencyHistogram::Snapshot& latency = *snapshots[sx];
+            strm << settings.m_SpeedPercent
+                << "," << settings.m_QueueDepth
+                << "," << result.m_DeviceCount
+                << "," << result.m_ChannelModuleCount
+                << "," << result.m_Reads
+                << "," << result.m_Writes
+                << "," << result.m_Errors
+                << "," << result.m_Skipped
+                << "," << result.m_MaxInFlight
+                << "," << result.m_CapturedMicros
+                << "," << result.m_ElapsedMicros
+                << "," << result.getIops()
+                << "," << labels[sx]
+                << "," << latency.m_Count
+                << "," << latency.getMeanMicros()
+                << "," << latency.getPercentileMicros( 50.0 )
+                << "," << latency.getPercentileMicros( 90.0 )
+                << "," << latency.getPercentileMicros( 99.0 )
+                << "," << latency.getPercentileMicros( 99.9 )
+                << "," << latency.m_MaxMicros;
+            if ( sx + 1 < sizeof( labels ) / sizeof( labels[0] ) )
+                strm << std::endl;
+        }
+    }
+    else
+    {
+        strm << "Packs:" << result.m_DeviceCount
+            << "  Channel modules:" << result.m_ChannelModuleCount
+            << "  Reads:" << result.m_Reads
+            << "  Writes:" << result.m_Writes
+            << "  Errors:" << result.m_Errors
+            << "  Skipped:" << result.m_Skipped
+            << "  Max in flight:" << result.m_MaxInFlight << std::endl;
+        strm << "Captured:" << LatencyHistogram::getDurationString( result.m_CapturedMicros )
+            << "  Replayed:" << LatencyHistogram::getDurationString( result.m_ElapsedMicros )
+            << "  IOPS:" << result.getIops() << std::endl << std::endl;
+        strm << std::right
+            << std::setw( 8 ) << "(us)"
+            << std::setw( 10 ) << "count"
+            << std::setw( 10 ) << "mean"
+            << std::setw( 8 ) << "p50"
+            << std::setw( 8 ) << "p90"
+            << std::setw( 8 ) << "p99"
+            << std::setw( 8 ) << "p99.9"
+            << std::setw( 8 ) << "max";
+        for ( INDEX sx = 0; sx < sizeof( labels ) / sizeof( labels[0] ); ++sx )
+        {
+            const LatencyHistogram::Snapshot& latency = *snapshots[sx];
+            if ( latency.m_Count == 0 )
+                continue;
+            strm << std::endl
+                << std::setw( 8 ) << labels[sx]
+                << std::setw( 10 ) << latency.m_Count
+                << std::setw( 10 ) << latency.getMeanMicros()
+                << std::setw( 8 ) << latency.getPercentileMicros( 50.0 )
+                << std::setw( 8 ) << latency.getPercentileMicros( 90.0 )
+                << std::setw( 8 ) << latency.getPercentileMicros( 99.0 )
+                << std::setw( 8 ) << latency.getPercentileMicros( 99.9 )
+                << std::setw( 8 ) << latency.m_MaxMicros;
+        }
+    }
+
+    std::cout << strm.str() << std::endl;
+    return 0;
+}
+
+
+//  showUsage()
+static void
+showUsage()
+{
+    std::cout << "Usage: embench [ -cpu n ] [ -trials n ] [ -warmup ms ] [ -time ms ] [ -csv ] [ name_filter ... ]" << std::endl;
+    std::cout << "  -cpu     host CPU to pin to (default " << DEFAULT_CPU << ")" << std::endl;
+    std::cout << "  -trials  timed trials per benchmark; the median is reported" << std::endl;
+    std::cout << "  -warmup  milliseconds of untimed running before the trials" << std::endl;
+    std::cout << "  -time    target milliseconds per trial" << std::endl;
+    std::cout << "  -csv     comma-separated output, for comparing runs" << std::endl;
+    std::cout << "Usage: embench -disk [ -cpu n ] [ -iocpu n ] [ -dir path ] [ -packs n ] [ -depth n ] [ -prep n ]" << std::endl;
+    std::cout << "                     [ -read pct ] [ -seq ] [ -warmup ms ] [ -time ms ] [ -csv ]" << std::endl;
+    std::cout << "  -cpu     host CPU for the thread which issues the IO (default " << DEFAULT_CPU << ")" << std::endl;
+    std::cout << "  -iocpu   host CPUs for the channel module, which does the host IO (default any)" << std::endl;
+    std::cout << "  -dir     directory for the scratch packs (default /tmp/)" << std::endl;
+    std::cout << "  -packs   number of packs, each on its own device (default 1)" << std::endl;
+    std::cout << "  -depth   channel programs kept in flight (default 4)" << std::endl;
+    std::cout << "  -prep    prep factor - words per block, and per IO (default 1792)" << std::endl;
+    std::cout << "  -read    percentage of IOs which are reads (default 70)" << std::endl;
+    std::cout << "  -seq     sequential rather than random block addresses" << std::endl;
+    std::cout << "  -warmup  milliseconds of unmeasured IO (default 500)" << std::endl;
+    std::cout << "  -time    milliseconds of measured IO (default 5000)" << std::endl;
+    std::cout << "Usage: embench -replay capture_file [ -cpu n ] [ -iocpu n ] [ -dir path ] [ -speed pct ] [ -depth n ] [ -csv ]" << std::endl;
+    std::cout << "  -cpu     host CPU for the thread which issues the IO (default " << DEFAULT_CPU << ")" << std::endl;
+    std::cout << "  -iocpu   host CPUs for the channel modules, which do the host IO (default any)" << std::endl;
+    std::cout << "  -dir     directory for the scratch packs (default /tmp/)" << std::endl;
+    std::cout << "  -speed   percentage of the captured speed (default 100) - zero for as fast as possible" << std::endl;
+    std::cout << "  -depth   channel programs kept in flight at speed zero (default 4)" << std::endl;
+}
+
+
+
+//  ----------------------------------------------------------------------------
+//  main
+//  ----------------------------------------------------------------------------
+
+int
+main
+(
+    int         argc,
+    char**      argv
+)
+{
+    if ( (argc > 1) && (SuperString( argv[1] ).compareNoCase( "-disk" ) == 0) )
+        return diskMain( argc, argv );
+    if ( (argc > 1) && (SuperString( argv[1] ).compareNoCase( "-replay" ) == 0) )
+        return replayMain( argc, argv );
+
+    COUNT cpu = DEFAULT_CPU;
+    Benchmark::Settings settings;
+    bool csvFlag = false;
+    VSTRING filters;
+    if ( !parseArguments( argc, argv, &cpu, &settings, &csvFlag, &filters ) )
+    {
+        showUsage();
+        return 1;
+    }
+
+    if ( !Benchmark::pinCurrentThread( cpu ) )
+    {
+        std::cout << "Cannot pin to CPU " << cpu << std::endl;
+        return 1;
+    }
+
+    BENCHMARKS benchmarks;
+    Word36Benchmarks word36Benchmarks( WORD36_BUFFER_WORDS );
+    word36Benchmarks.create( &benchmarks );
+
+    TranslateBenchmarks translateBenchmarks;
+    const COUNT blockWords[] = TRANSLATE_BLOCK_WORDS;
+    for ( INDEX bx = 0; bx < sizeof( blockWords ) / sizeof( blockWords[0] ); ++bx )
+        translateBenchmarks.create( &benchmarks, blockWords[bx] );
+
+    if ( csvFlag )
+    {
+        std::cout << "name,words,bytes,iterations,trials,ns_per_word,min_ns_per_word,max_ns_per_word,gb_per_second" << std::endl;
+    }
+    else
+    {
+        std::cout << "embench " << VERSION << std::endl;
+        std::cout << COPYRIGHT << std::endl;
+#ifndef __OPTIMIZE__
+        std::cout << "Warning:This is an unoptimized build - use CONF=Release for real numbers" << std::endl;
+#endif
+        std::cout << "CPU " << cpu << " of " << CpuSet::getHostCpuCount()
+            << "  Trials:" << settings.m_Trials
+            << "  Warmup:" << settings.m_WarmupMillis << "ms"
+            << "  Trial:" << settings.m_TrialMillis << "ms" << std::endl << std::endl;
+        std::cout << std::left << std::setw( 40 ) << "Benchmark" << std::right
+            << std::setw( 12 ) << "ns/word"
+            << std::setw( 12 ) << "min"
+            << std::setw( 12 ) << "max"
+            << std::setw( 10 ) << "GB/s" << std::endl;
+    }
+
+    for ( CITBENCHMARKS itb = benchmarks.begin(); itb != benchmarks.end(); ++itb )
+    {
+        const Benchmark* pBenchmark = *itb;
+        if ( !isSelected( pBenchmark->getName(), filters ) )
+            continue;
+
+        Benchmark::Result result = pBenchmark->measure( settings );
+        double bytesPerWord = static_cast<double>( pBenchmark->getBytesPerIteration() ) / pBenchmark->getWordsPerIteration();
+        double gbPerSecond = result.m_MedianNanosPerWord > 0.0 ? bytesPerWord / result.m_MedianNanosPerWord : 0.0;
+
+        std::stringstream strm;
+        strm << std::fixed << std::setprecision( 3 );
+        if ( csvFlag )
+        {
+            strm << pBenchmark->getName()
+                << "," << pBenchmark->getWordsPerIteration()
+                << "," << pBenchmark->getBytesPerIteration()
+                << "," << result.m_Iterations
+                << "," << result.m_Trials
+                << "," << result.m_MedianNanosPerWord
+                << "," << result.m_MinNanosPerWord
+                << "," << result.m_MaxNanosPerWord
+                << "," << gbPerSecond;
+        }
+        else
+        {
+            strm << std::left << std::setw( 40 ) << pBenchmark->getName() << std::right
+                << std::setw( 12 ) << result.m_MedianNanosPerWord
+                << std::setw( 12 ) << result.m_MinNanosPerWord
+                << std::setw( 12 ) << result.m_MaxNanosPerWord
+                << std::setw( 10 ) << gbPerSecond;
+        }
+        std::cout << strm.str() << std::endl;
+    }
+
+    for ( ITBENCHMARKS itb = benchmarks.begin(); itb != benchmarks.end(); ++itb )
+        delete *itb;
+
+    return 0;
+}
+
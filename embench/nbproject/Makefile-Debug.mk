@@ -0,0 +1,128 @@
+#
+# Generated Makefile - do not edit!
+#
+# Edit the Makefile in the project folder instead (../Makefile). Each target
+# has a -pre and a -post target defined where you can add customized code.
+#
+# This makefile implements configuration specific macros and targets.
+
+
+# Environment
+MKDIR=mkdir
+CP=cp
+GREP=grep
+NM=nm
+CCADMIN=CCadmin
+RANLIB=ranlib
+CC=gcc
+CCC=g++
+CXX=g++
+FC=gfortran
+AS=as
+
+# Macros
+CND_PLATFORM=GNU-Linux-x86
+CND_DLIB_EXT=so
+CND_CONF=Debug
+CND_DISTDIR=dist
+CND_BUILDDIR=build
+
+# Include project Makefile
+include embench-Makefile.mk
+
+# Object Directory
+OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
+
+# Object Files
+OBJECTFILES= \
+	${OBJECTDIR}/Benchmark.o \
+	${OBJECTDIR}/DiskBenchmark.o \
+	${OBJECTDIR}/IoReplay.o \
+	${OBJECTDIR}/ScratchConfiguration.o \
+	${OBJECTDIR}/TranslateBenchmarks.o \
+	${OBJECTDIR}/Word36Benchmarks.o \
+	${OBJECTDIR}/main.o
+
+
+# C Compiler Flags
+CFLAGS=
+
+# CC Compiler Flags
+CCFLAGS=-m64
+CXXFLAGS=-m64
+
+# Fortran Compiler Flags
+FFLAGS=
+
+# Assembler Flags
+ASFLAGS=
+
+# Link Libraries and Options
+LDLIBSOPTIONS=../hardwarelib/dist/Debug/GNU-Linux-x86/libhardwarelib.a ../misclib/dist/Debug/GNU-Linux-x86/libmisclib.a -lpthread
+
+# Build Targets
+.build-conf: ${BUILD_SUBPROJECTS}
+	"${MAKE}"  -f nbproject/Makefile-${CND_CONF}.mk ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/embench
+
+${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/embench: ../hardwarelib/dist/Debug/GNU-Linux-x86/libhardwarelib.a
+
+${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/embench: ../misclib/dist/Debug/GNU-Linux-x86/libmisclib.a
+
+${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/embench: ${OBJECTFILES}
+	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
+	${LINK.cc} -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/embench ${OBJECTFILES} ${LDLIBSOPTIONS}
+
+${OBJECTDIR}/Benchmark.o: nbproject/Makefile-${CND_CONF}.mk Benchmark.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Benchmark.o Benchmark.cpp
+
+${OBJECTDIR}/DiskBenchmark.o: nbproject/Makefile-${CND_CONF}.mk DiskBenchmark.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DiskBenchmark.o DiskBenchmark.cpp
+
+${OBJECTDIR}/IoReplay.o: nbproject/Makefile-${CND_CONF}.mk IoReplay.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/IoReplay.o IoReplay.cpp
+
+${OBJECTDIR}/ScratchConfiguration.o: nbproject/Makefile-${CND_CONF}.mk ScratchConfiguration.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ScratchConfiguration.o ScratchConfiguration.cpp
+
+${OBJECTDIR}/TranslateBenchmarks.o: nbproject/Makefile-${CND_CONF}.mk TranslateBenchmarks.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TranslateBenchmarks.o TranslateBenchmarks.cpp
+
+${OBJECTDIR}/Word36Benchmarks.o: nbproject/Makefile-${CND_CONF}.mk Word36Benchmarks.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Word36Benchmarks.o Word36Benchmarks.cpp
+
+${OBJECTDIR}/main.o: nbproject/Makefile-${CND_CONF}.mk main.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/main.o main.cpp
+
+# Subprojects
+.build-subprojects:
+	cd ../hardwarelib && ${MAKE}  -f Makefile CONF=Debug
+	cd ../misclib && ${MAKE}  -f Makefile CONF=Debug
+
+# Clean Targets
+.clean-conf: ${CLEAN_SUBPROJECTS}
+	${RM} -r ${CND_BUILDDIR}/${CND_CONF}
+	${RM} ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/embench
+
+# Subprojects
+.clean-subprojects:
+	cd ../hardwarelib && ${MAKE}  -f Makefile CONF=Debug clean
+	cd ../misclib && ${MAKE}  -f Makefile CONF=Debug clean
+
+# Enable dependency checking
+.dep.inc: .depcheck-impl
+
+include .dep.inc
@@ -10,7 +10,8 @@
 //  Persisted JSON object:
 //  { "ioProcessors": [ --ioProcessor--, ... ],
 //    "subSystems": [ --subSystem--, ... ],
-//    "mounts": [ --mount--, ... ] }
+//    "mounts": [ --mount--, ... ],
+//    "affinities": [ --affinity--, ... ] }        (optional)
 //
 //  ioProcessor:
 //  { "name": "IOP0",
@@ -31,6 +32,12 @@
 //  mount:
 //  { "deviceName": "DISK0",
 //    "mediaName": "dsk000" }
+//
+//  affinity:
+//  { "nodeName": "IOP0",
+//    "cpus": "NODE0" }
+//      nodeName is an IOP (applies to all its channel modules) or a channel module (overrides its IOP)
+//      cpus is a CpuSet specification
 
 
 
@@ -38,6 +45,7 @@
 
 
 
+#define     KEY_AFFINITY_ARRAY          "affinities"
 #define     KEY_IOPROCESSOR_ARRAY       "ioProcessors"
 #define     KEY_SUBSYSTEM_ARRAY         "subSystems"
 #define     KEY_MOUNT_ARRAY             "mounts"
@@ -46,6 +54,43 @@
 
 //  private methods
 
+//  applyAffinities()
+//
+//  Pins every channel module's worker thread according to m_Affinities.
+//  A channel module's own entry takes precedence over that of its IOP; with neither, the thread is unpinned.
+//
+//  Returns:
+//      Result enum indicating success or the reason for failure
+PersistableNodeTable::Result
+PersistableNodeTable::applyAffinities()
+{
+    Result result = Result::Success;
+    for ( auto itiop = m_IoProcessors.begin(); itiop != m_IoProcessors.end(); ++itiop )
+    {
+        const IOProcessor* piop = itiop->second;
+        auto itiopAff = m_Affinities.find( piop->getName() );
+
+        const Node::DESCENDANTS& chmods = piop->getDescendants();
+        for ( auto itcm = chmods.begin(); itcm != chmods.end(); ++itcm )
+        {
+            ChannelModule* pcm = dynamic_cast<ChannelModule*>( itcm->second );
+            auto itcmAff = m_Affinities.find( pcm->getName() );
+
+            CpuSet cpuSet;
+            if ( itcmAff != m_Affinities.end() )
+                cpuSet = itcmAff->second;
+            else if ( itiopAff != m_Affinities.end() )
+                cpuSet = itiopAff->second;
+
+            if ( !pcm->setAffinity( cpuSet ) )
+                result = Result::AffinityFailed;
+        }
+    }
+
+    return result;
+}
+
+
 //  areNodeNamesUnique()
 //
 //  Tests a list of names to see if they are all unique
@@ -242,10 +287,62 @@ PersistableNodeTable::deserialize
     if ( result != Result::Success )
         return result;
 
+    JSONArrayValue* pAffinities = dynamic_cast<JSONArrayValue*>( pObject->getItem( KEY_AFFINITY_ARRAY ) );
+    if ( pAffinities )
+    {
+        result = deserializeAffinities( pAffinities );
+        if ( result != Result::Success )
+            return result;
+    }
+
     return deserializeMounts( pMounts );
 }
 
 
+//  deserializeAffinities()
+//
+//  Given a JSON array containing affinity entries, we deserialize them all and pin the affected threads.
+//
+//  affinity:
+//  { "nodeName": "IOP0",
+//    "cpus": "NODE0" }
+//
+//  Returns:
+//      Result enum indicating success or the reason for failure
+PersistableNodeTable::Result
+PersistableNodeTable::deserializeAffinities
+(
+    const JSONArrayValue* const     pArray
+)
+{
+    for ( INDEX ax = 0; ax < pArray->getCount(); ++ax )
+    {
+        JSONObjectValue* pObject = dynamic_cast<JSONObjectValue*>( pArray->getItem( ax ) );
+        if ( pObject == 0 )
+            return Result::ParseError;
+
+        JSONStringValue* pNodeName = dynamic_cast<JSONStringValue*>( pObject->getItem( "nodeName" ) );
+        JSONStringValue* pCpus = dynamic_cast<JSONStringValue*>( pObject->getItem( "cpus" ) );
+        if ( (pNodeName == 0) || (pCpus == 0) )
+            return Result::ParseError;
+
+        Node* pNode = getNode( pNodeName->getValueAsString() );
+        if ( pNode == 0 )
+            return Result::NodeDoesNotExist;
+        if ( (dynamic_cast<IOProcessor*>( pNode ) == 0) && (dynamic_cast<ChannelModule*>( pNode ) == 0) )
+            return Result::TypeConflict;
+
+        CpuSet cpuSet;
+        if ( !CpuSet::parse( pCpus->getValueAsString(), &cpuSet ) )
+            return Result::InvalidCpuSet;
+        if ( !cpuSet.isEmpty() )
+            m_Affinities[pNode->getName()] = cpuSet;
+    }
+
+    return applyAffinities();
+}
+
+
 //  deserializeDevices()
 //
 //  Takes a JSONArray describing a list of devices, deserializes them into Device objects,
@@ -606,6 +703,29 @@ PersistableNodeTable::isNodeNameUnique
 }
 
 
+//  serializeAffinities()
+//
+//  Create a JSON array containing JSON-serialization of all the affinity entries we know about
+//
+//  Format of serialized affinity object:
+//  { "nodeName": "IOP0",
+//    "cpus": "NODE0" }
+JSONArrayValue*
+PersistableNodeTable::serializeAffinities() const
+{
+    JSONArrayValue* pArray = new JSONArrayValue();
+    for ( auto itaff = m_Affinities.begin(); itaff != m_Affinities.end(); ++itaff )
+    {
+        JSONObjectValue* pAffinity = new JSONObjectValue();
+        pAffinity->store( "nodeName", new JSONStringValue( itaff->first ) );
+        pAffinity->store( "cpus", new JSONStringValue( itaff->second.getSpecification() ) );
+        pArray->append( pAffinity );
+    }
+
+    return pArray;
+}
+
+
 //  serializeDevice()
 //
 //  Creates a JSON object containing a description of the indicated Device
@@ -1241,10 +1361,12 @@ PersistableNodeTable::deleteIoProcessor
     for ( auto itcm = chmods.begin(); itcm != chmods.end(); ++itcm )
     {
         ChannelModule* pcm = dynamic_cast<ChannelModule*>(itcm->second);
+        m_Affinities.erase( pcm->getName() );
         m_NodeSet.erase( pcm );
         delete pcm;
     }
 
+    m_Affinities.erase( piop->getName() );
     m_IoProcessors.erase( it );
     m_NodeSet.erase( piop );
     delete piop;
@@ -1456,6 +1578,7 @@ PersistableNodeTable::save
     pSaveObject->store( KEY_IOPROCESSOR_ARRAY, serializeIoProcessors() );
     pSaveObject->store( KEY_SUBSYSTEM_ARRAY, serializeSubSystems() );
     pSaveObject->store( KEY_MOUNT_ARRAY, serializeMounts() );
+    pSaveObject->store( KEY_AFFINITY_ARRAY, serializeAffinities() );
 
     //  Serialize the JSON object then discard it
     std::string data = pSaveObject->encode();
@@ -1491,6 +1614,58 @@ PersistableNodeTable::save
 }
 
 
+//  setAffinity()
+//
+//  Pins the worker threads of an IOP's channel modules, or of a single channel module, to a set of host CPUs.
+//  A channel module's own setting takes precedence over that of its IOP.
+//
+//  Parameters:
+//      nodeName:           name of an IOP or a channel module
+//      specification:      CpuSet specification - "ANY" (or empty) removes the setting
+//
+//  Returns:
+//      Result enum indicating success or the reason for failure
+PersistableNodeTable::Result
+PersistableNodeTable::setAffinity
+(
+    const SuperString&  nodeName,
+    const std::string&  specification
+)
+{
+    lock();
+
+    Node* pNode = getNode( nodeName );
+    if ( pNode == 0 )
+    {
+        unlock();
+        return Result::NodeDoesNotExist;
+    }
+
+    if ( (dynamic_cast<IOProcessor*>( pNode ) == 0) && (dynamic_cast<ChannelModule*>( pNode ) == 0) )
+    {
+        unlock();
+        return Result::TypeConflict;
+    }
+
+    CpuSet cpuSet;
+    if ( !CpuSet::parse( specification, &cpuSet ) )
+    {
+        unlock();
+        return Result::InvalidCpuSet;
+    }
+
+    if ( cpuSet.isEmpty() )
+        m_Affinities.erase( pNode->getName() );
+    else
+        m_Affinities[pNode->getName()] = cpuSet;
+
+    m_IsUpdated = true;
+    Result result = applyAffinities();
+    unlock();
+    return result;
+}
+
+
 
 //  public static methods
 
@@ -1505,12 +1680,14 @@ PersistableNodeTable::getResultString
 {
     switch ( result )
     {
+    case Result::AffinityFailed:                return "The host refused to set thread affinity";
     case Result::CannotConnect:                 return "The subsystem cannot be connected";
     case Result::ChannelModuleStillConnected:   return "At least one channel module is still connected to a controller";
     case Result::FileCloseFailed:               return "File close failed";
     case Result::FileIoFailed:                  return "File IO failed";
     case Result::FileOpenFailed:                return "File open failed";
     case Result::GeneratedNameConflict:         return "There is a conflict in automatically generated names";
+    case Result::InvalidCpuSet:                 return "CPU set is invalid or names CPUs the host does not have";
     case Result::MountFailed:                   return "Mount Failed";
     case Result::NameIsInvalid:                 return "A proposed name is invalid";
     case Result::NameIsNotUnique:               return "A proposed name is not unique";
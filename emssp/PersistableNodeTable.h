@@ -22,12 +22,14 @@ public:
     enum class Result
     {
         Success,
+        AffinityFailed,
         CannotConnect,
         ChannelModuleStillConnected,
         FileCloseFailed,
         FileIoFailed,
         FileOpenFailed,
         GeneratedNameConflict,
+        InvalidCpuSet,
         MountFailed,
         NameIsInvalid,
         NameIsNotUnique,
@@ -38,13 +40,16 @@ public:
 
     typedef std::map<std::string, SubSystem*>   SUBSYSTEMS;
     typedef std::map<std::string, IOProcessor*> IOPROCESSORS;
+    typedef std::map<std::string, CpuSet>       AFFINITIES;     //  keyed by IOP or channel module name
 
 
 private:
+    AFFINITIES                  m_Affinities;
     bool                        m_IsUpdated;
     IOPROCESSORS                m_IoProcessors;
     SUBSYSTEMS                  m_SubSystems;
 
+    Result              applyAffinities();
     bool                areNodeNamesUnique( const std::vector<SuperString>& names ) const;
     Result              createDeviceInt( SubSystem* const           pSubSystem,
                                          const SuperString&         nodeName,
@@ -55,6 +60,7 @@ private:
                                             const Controller::ControllerType    controllerType,
                                             const std::vector<SuperString>&     controllerNames );
     Result              deserialize( const JSONObjectValue* const pObject );
+    Result              deserializeAffinities( const JSONArrayValue* const pArray );
     Result              deserializeDevices( const JSONArrayValue* const pArray,
                                             SubSystem* const            pSubSystem );
     Result              deserializeIoProcessor( const JSONObjectValue* const pObject );
@@ -65,6 +71,7 @@ private:
     Result              deserializeSubSystems( const JSONArrayValue* const pArray );
     void                disconnectSubSystemInt( SubSystem* const pSubSystem );
     bool                isNodeNameUnique( const SuperString& name ) const;
+    JSONArrayValue*     serializeAffinities() const;
     JSONObjectValue*    serializeDevice( const Device* const pDevice ) const;
     JSONObjectValue*    serializeIoProcessor( const IOProcessor* const pIoProcessor ) const;
     JSONArrayValue*     serializeIoProcessors() const;
@@ -104,14 +111,18 @@ public:
     Result              disconnectSubSystem( const SuperString& subSystemName );
     Result              load( const SuperString& fileName );
     Result              save( const SuperString& fileName );
+    Result              setAffinity( const SuperString& nodeName,
+                                     const std::string& specification );
 
     inline void         clear()
     {
+        m_Affinities.clear();
         m_NodeSet.clear();
         m_IsUpdated = false;
     }
 
     //  Use these carefully - they may change value unexpectedly in multi-threaded contexts
+    inline const AFFINITIES&    getAffinities() const       { return m_Affinities; }
     inline const IOPROCESSORS&  getIoProcessors() const     { return m_IoProcessors; }
 
     inline SubSystem*           getSubSystem( const SuperString& subSystemName ) const
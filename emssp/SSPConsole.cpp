@@ -67,8 +67,6 @@ SSPConsole::injectConsoleMessage
 
         m_ReadReplyMessages[mx]->m_Reply = reply;
         m_ReadReplyMessages[mx]->m_ReplyReady = true;
-        unlock();
-        return true;
     }
     else
     {
@@ -77,9 +75,13 @@ SSPConsole::injectConsoleMessage
         temp.trimTrailingSpaces();
 
         m_UnsolicitedKeyins.push_back( temp );
-        unlock();
-        return true;
     }
+
+    unlock();
+
+    InputEvent event;
+    notifyListeners( &event );
+    return true;
 }
 
 
@@ -295,3 +295,35 @@ SSPPanel::setStopCodeMessage
     if ( m_RestartEnabled && !getJumpKey( 3 ) )
         m_RestartRequested = true;
 }
+
+
+
+//  ----------------------------------------------------------------------------
+//  HttpServer::Handler overrides
+//  ----------------------------------------------------------------------------
+
+//  handleRequest()
+//
+//  Serves /metrics - we hold our lock throughout, so the exec cannot be unloaded out from under us
+void
+SSPPanel::handleRequest
+(
+    const HttpServer::Request&      request,
+    HttpServer::Response* const     pResponse
+)
+{
+    if ( (request.m_Method.compare( "GET" ) != 0) && (request.m_Method.compare( "HEAD" ) != 0) )
+    {
+        pResponse->m_StatusCode = 405;
+        pResponse->m_Headers["Allow"] = "GET, HEAD";
+        return;
+    }
+
+    MetricsWriter writer;
+    lock();
+    ExecMetrics::write( m_pExec, &writer );
+    unlock();
+
+    pResponse->m_ContentType = MetricsWriter::CONTENT_TYPE;
+    pResponse->m_Body = writer.getText();
+}
@@ -10,7 +10,7 @@
 
 
 
-class   SSPPanel : public PanelInterface, public Worker, public Lockable
+class   SSPPanel : public PanelInterface, public Worker, public Lockable, public HttpServer::Handler
 {
 private:
     ConsoleInterface* const     m_pConsole;
@@ -68,6 +68,10 @@ public:
     void                    setJumpKeys( const Word36& jumpKeys );
     void                    setStatusMessage( const std::string& message );
     void                    setStopCodeMessage( const std::string& message );
+
+    //  HttpServer::Handler overrides
+    void                    handleRequest( const HttpServer::Request&   request,
+                                           HttpServer::Response* const  pResponse );
 };
 
 
@@ -9,6 +9,10 @@
 
 //  local constants
 #define     NODE_CONFIG_FILE_NAME       BASE_PATH "emssp_node.cfg"
+#define     METRICS_PATH                "/metrics"
+#define     METRICS_PORT                8000
+#define     SYSTEM_LOG_FILE_NAME        "emssp.log"
+#define     SYSTEM_LOG_MAX_BYTES        (64 * 1024 * 1024)
 
 
 
@@ -21,6 +25,7 @@ typedef     bool        (*COMMAND_HANDLER)( const std::list<SuperString>& argume
 //  function prototypes
 
 static bool     callHandler( const std::list<SuperString>& parameters );
+static bool     clockHandler( const std::list<SuperString>& parameters );
 static bool     execBootHandler( const std::list<SuperString>& parameters );
 static bool     execConfigHandler( const std::list<SuperString>& parameters );
 static bool     execDumpHandler( const std::list<SuperString>& parameters );
@@ -30,15 +35,19 @@ static bool     execReloadHandler( const std::list<SuperString>& parameters );
 static bool     execStatusHandler( const std::list<SuperString>& parameters );
 static bool     execUnloadHandler( const std::list<SuperString>& parameters );
 static bool     helpHandler( const std::list<SuperString>& parameters );
+static bool     ioCaptureHandler( const std::list<SuperString>& parameters );
 static bool     jumpClearHandler( const std::list<SuperString>& parameters );
 static bool     jumpSetHandler( const std::list<SuperString>& parameters );
 static bool     jumpShowHandler( const std::list<SuperString>& parameters );
+static bool     logHandler( const std::list<SuperString>& parameters );
 static bool     mediaCreateHandler( const std::list<SuperString>& parameters );
+static bool     nodeAffinityHandler( const std::list<SuperString>& parameters );
 static bool     nodeConfigHandler( const std::list<SuperString>& parameters );
 static bool     nodeDeviceHandler( const std::list<SuperString>& parameters );
 static bool     nodeIopHandler( const std::list<SuperString>& parameters );
 static bool     nodeSubSystemHandler( const std::list<SuperString>& parameters );
 static bool     quitHandler( const std::list<SuperString>& parameters );
+static bool     traceHandler( const std::list<SuperString>& parameters );
 
 static bool     getJumpKeys( const std::list<SuperString>&      parameters,
                              std::set<PanelInterface::JUMPKEY>* pJumpKeys );
@@ -112,6 +121,7 @@ static SUBCOMMANDS MediaSubCommands =
 
 static SUBCOMMANDS NodeSubCommands =
 {
+    {"AFFINITY",    nodeAffinityHandler},
     {"CONFIG",      nodeConfigHandler},
     {"DEVICE",      nodeDeviceHandler},
     {"IOP",         nodeIopHandler},
@@ -124,6 +134,17 @@ static Command CallCommand( callHandler,
                             "Executes the emssp commands found in the given script\n",
                             0 );
 
+static Command ClockCommand( clockHandler,
+                             "/CLOCK [ SHOW ]\n"
+                                     "/CLOCK [ REAL | VIRTUAL ]\n"
+                                     "/CLOCK ACCELERATED {factor}\n",
+                             "Displays or changes the way time runs for the exec.\n"
+                                     "REAL is host time (the default).\n"
+                                     "ACCELERATED runs time {factor} (2 to 1000) times faster than host time.\n"
+                                     "VIRTUAL runs time at host speed while anything is busy, and skips ahead to\n"
+                                     "  the next pending timer whenever everything is waiting.\n"
+                                     "The clock cannot be changed while an exec is running.\n" );
+
 static Command ExecCommand( 0,
                             "/EXEC [ BOOT | DUMP | HALT | LOAD | RELOAD | STATUS | UNLOAD ]\n"
                                     "/EXEC CONFIG LIST\n"
@@ -141,6 +162,15 @@ static Command HelpCommand( helpHandler,
                             "Displays a short syntax list of all available commands,\n"
                                 "or more detailed help for the indicated command (if specified).\n" );
 
+static Command IoCaptureCommand( ioCaptureHandler,
+                                 "/IOCAPTURE [ SHOW ]\n"
+                                         "/IOCAPTURE START capture_file_name\n"
+                                         "/IOCAPTURE STOP\n",
+                                 "Records the time, path, command, block address, word count, and format of every\n"
+                                         "  channel program routed by an IOP - but none of the data - to the given file.\n"
+                                         "  Capture is off by default.  embench -replay re-issues a capture against\n"
+                                         "  scratch packs, and reports the latencies.\n" );
+
 static Command JumpCommand( 0,
                             "/JUMP SHOW\n"
                                     "/JUMP SET|CLEAR key_number,...\n",
@@ -153,6 +183,18 @@ static Command JumpCommand( 0,
                                     "  JK13: Initializes Mass Storage\n",
                             &JumpSubCommands );
 
+static Command LogCommand( logHandler,
+                           "/LOG [ SHOW ]\n"
+                                   "/LOG LEVEL [ category | ALL ] level\n"
+                                   "/LOG FORMAT [ TEXT | JSON ]\n",
+                           "Controls the system log.  Entries of each category below its level are ignored.\n"
+                                   "category is chosen from [ GENERAL | CHANNEL | CONSOLE | DEVICE | EXEC\n"
+                                   "  | FACILITIES | IO | MFD | NETWORK | WORKER ]\n"
+                                   "level is chosen from [ TRACE | DEBUG | INFO | WARNING | ERROR | OFF ]\n"
+                                   "  DEBUG on CHANNEL or DEVICE logs every IO, TRACE adds the buffers.\n"
+                                   "  Levels below the build's MISCLIB_LOG_MIN_LEVEL are compiled out.\n"
+                                   "FORMAT JSON writes one JSON object per line, rather than plain text.\n" );
+
 static Command MediaCommand( 0,
                              "/MEDIA CREATE PACK pack_name block_size block_count\n"
                                      "/MEDIA CREATE VOLUME volume_name\n",
@@ -165,7 +207,10 @@ static Command MediaCommand( 0,
                              &MediaSubCommands );
 
 static Command NodeCommand( 0,
-                            "/NODE CONFIG [ LOAD | SAVE ] [ {file_name} ]\n"
+                            "/NODE AFFINITY SET {affinity_node_name} {cpu_set}\n"
+                                    "/NODE AFFINITY CLEAR {affinity_node_name}\n"
+                                    "/NODE AFFINITY LIST\n"
+                                    "/NODE CONFIG [ LOAD | SAVE ] [ {file_name} ]\n"
                                     "/NODE CONFIG LIST\n"
                                     "/NODE DEVICE CREATE {device_name} {device_type} {device_model} {subsystem_name}\n"
                                     "/NODE DEVICE MOUNT {device_name} {media_name}\n"
@@ -189,7 +234,11 @@ static Command NodeCommand( 0,
                                     "subsystem_name is an arbitrarily assigned name for a given subsystem\n"
                                     "media_name is the name of a virtual disk pack or a virtual tape volume\n"
                                     "iop_name is the name of an existing IOProcessor node\n"
-                                    "chmod_name is the name of a channel module to which the subsystem is to be attached\n",
+                                    "chmod_name is the name of a channel module to which the subsystem is to be attached\n"
+                                    "affinity_node_name is the name of an IOP (for all of its channel modules)\n"
+                                    "  or of a channel module (overriding its IOP)\n"
+                                    "cpu_set is a list of host CPU numbers and ranges (e.g., 0-3,8), NODEn for all\n"
+                                    "  the CPUs of host NUMA node n, or ANY\n",
                             &NodeSubCommands );
 
 static Command QuitCommand( quitHandler,
@@ -197,16 +246,32 @@ static Command QuitCommand( quitHandler,
                             "Ends execution of the emssp executable.\n"
                                     "If an exec is running, you may use the FORCE argument stop it.\n" );
 
+static Command TraceCommand( traceHandler,
+                             "/TRACE [ SHOW ]\n"
+                                     "/TRACE [ ON | OFF ]\n"
+                                     "/TRACE DUMP [ dump_file_name ]\n"
+                                     "/TRACE DECODE dump_file_name json_file_name\n",
+                             "Controls the binary event trace of channel programs, device IOs, worker wakeups,\n"
+                                     "  MFD commits, and keyins.  Tracing is off by default.\n"
+                                     "DUMP writes the trace to the given file (or a time-stamped ExecTrace file).\n"
+                                     "  The trace is also dumped automatically when the exec stops with tracing on.\n"
+                                     "DECODE converts a dump file to Chrome trace JSON, for chrome://tracing\n"
+                                     "  or ui.perfetto.dev.\n" );
+
 
 static COMMANDS Commands
 {
     { "CALL",   &CallCommand },
+    { "CLOCK",  &ClockCommand },
     { "EXEC",   &ExecCommand },
     { "HELP",   &HelpCommand },
+    { "IOCAPTURE", &IoCaptureCommand },
     { "JUMP",   &JumpCommand },
+    { "LOG",    &LogCommand },
     { "MEDIA",  &MediaCommand },
     { "NODE",   &NodeCommand },
     { "QUIT",   &QuitCommand },
+    { "TRACE",  &TraceCommand },
 };
 
 
@@ -317,6 +382,61 @@ callHandler
 }
 
 
+//  clockHandler()
+//
+//  Handles the CLOCK command
+static bool
+clockHandler
+(
+    const std::list<SuperString>& parameters
+)
+{
+    VirtualClock* pClock = VirtualClock::getInstance();
+    auto itparm = parameters.begin();
+    if ( (itparm == parameters.end()) || ((itparm->compareNoCase( "SHOW" ) == 0) && (parameters.size() == 1)) )
+    {
+        //  /CLOCK [ SHOW ]
+        std::stringstream strm;
+        pClock->dump( strm, "" );
+        std::string text = strm.str();
+        sendOutput( text.substr( 0, text.find( '\n' ) ) );
+        return true;
+    }
+
+    VirtualClock::Mode mode;
+    COUNT factor = 1;
+    if ( (itparm->compareNoCase( "REAL" ) == 0) && (parameters.size() == 1) )
+        mode = VirtualClock::MODE_REAL;
+    else if ( (itparm->compareNoCase( "VIRTUAL" ) == 0) && (parameters.size() == 1) )
+        mode = VirtualClock::MODE_VIRTUAL;
+    else if ( (itparm->compareNoCase( "ACCELERATED" ) == 0) && (parameters.size() == 2) )
+    {
+        mode = VirtualClock::MODE_ACCELERATED;
+        const SuperString& factorStr = parameters.back();
+        if ( !factorStr.isDecimalNumeric() || ((factor = factorStr.toDecimal()) < 2) || (factor > 1000) )
+        {
+            sendOutput( "Error:Factor must be from 2 to 1000" );
+            return false;
+        }
+    }
+    else
+    {
+        sendOutput( SyntaxErrorMsg );
+        return false;
+    }
+
+    if ( Panel.isExecLoaded() && Panel.isExecRunning() )
+    {
+        sendOutput( "Error:Cannot change the clock with exec running." );
+        return false;
+    }
+
+    pClock->setMode( mode, factor );
+    sendOutput( std::string( "Clock is now " ) + VirtualClock::getModeString( mode ) );
+    return true;
+}
+
+
 //  execBootHandler()
 //
 //  Handles EXEC BOOT
@@ -519,6 +639,66 @@ helpHandler
 }
 
 
+//  ioCaptureHandler()
+//
+//  Handles the IOCAPTURE command
+static bool
+ioCaptureHandler
+(
+    const std::list<SuperString>& parameters
+)
+{
+    std::vector<SuperString> parms( parameters.begin(), parameters.end() );
+    if ( parms.empty() || ((parms[0].compareNoCase( "SHOW" ) == 0) && (parms.size() == 1)) )
+    {
+        //  /IOCAPTURE [ SHOW ]
+        IoCapture::Statistics stats = IoCapture::getStatistics();
+        std::stringstream strm;
+        strm << "IO capture is " << (stats.m_Capturing ? "ON" : "OFF");
+        if ( !stats.m_FileName.empty() )
+        {
+            strm << " File=" << stats.m_FileName
+                << " Records=" << stats.m_RecordCount
+                << " Elapsed=" << stats.m_ElapsedMicros / 1000 << "ms";
+        }
+        sendOutput( strm.str() );
+        return true;
+    }
+
+    if ( (parms[0].compareNoCase( "START" ) == 0) && (parms.size() == 2) )
+    {
+        std::string errorMessage;
+        if ( !IoCapture::start( parms[1], &errorMessage ) )
+        {
+            sendOutput( "Error:" + errorMessage );
+            return false;
+        }
+
+        sendOutput( "IO capture started to " + parms[1] );
+        return true;
+    }
+
+    if ( (parms[0].compareNoCase( "STOP" ) == 0) && (parms.size() == 1) )
+    {
+        if ( !IoCapture::isCapturing() )
+        {
+            sendOutput( "Error:IO capture is not on" );
+            return false;
+        }
+
+        IoCapture::stop();
+        IoCapture::Statistics stats = IoCapture::getStatistics();
+        std::stringstream strm;
+        strm << "IO capture stopped - " << stats.m_RecordCount << " records written to " << stats.m_FileName;
+        sendOutput( strm.str() );
+        return true;
+    }
+
+    sendOutput( SyntaxErrorMsg );
+    return false;
+}
+
+
 //  jumpClearHandler()
 //
 //  Handles JUMP Clear
@@ -593,6 +773,87 @@ jumpShowHandler
 }
 
 
+//  logHandler()
+//
+//  Handles the LOG command
+static bool
+logHandler
+(
+    const std::list<SuperString>& parameters
+)
+{
+    SystemLog* pLog = SystemLog::getInstance();
+    std::vector<SuperString> parms( parameters.begin(), parameters.end() );
+    if ( parms.empty() || ((parms[0].compareNoCase( "SHOW" ) == 0) && (parms.size() == 1)) )
+    {
+        //  /LOG [ SHOW ]
+        SystemLog::Statistics stats = pLog->getStatistics();
+        std::stringstream strm;
+        strm << "Format=" << (pLog->getFormat() == SystemLog::FORMAT_JSON ? "JSON" : "TEXT")
+            << " Written=" << stats.m_WrittenCount
+            << " Dropped=" << stats.m_DroppedCount
+            << " Queued=" << stats.m_QueuedCount;
+        sendOutput( strm.str() );
+
+        for ( INDEX cx = 0; cx < SystemLog::CATEGORY_COUNT; ++cx )
+        {
+            SystemLog::Category category = static_cast<SystemLog::Category>( cx );
+            strm.str( "" );
+            strm << "  " << std::left << std::setw( 12 ) << SystemLog::getCategoryString( category )
+                << SystemLog::getLevelString( pLog->getMinimumLevel( category ) );
+            sendOutput( strm.str() );
+        }
+        return true;
+    }
+
+    if ( (parms[0].compareNoCase( "LEVEL" ) == 0) && (parms.size() == 3) )
+    {
+        //  /LOG LEVEL [ category | ALL ] level
+        SystemLog::Level level;
+        if ( !SystemLog::getLevel( parms[2], &level ) )
+        {
+            sendOutput( "Error:Invalid level" );
+            return false;
+        }
+
+        if ( parms[1].compareNoCase( "ALL" ) == 0 )
+        {
+            for ( INDEX cx = 0; cx < SystemLog::CATEGORY_COUNT; ++cx )
+                pLog->setMinimumLevel( static_cast<SystemLog::Category>( cx ), level );
+            return true;
+        }
+
+        SystemLog::Category category;
+        if ( !SystemLog::getCategory( parms[1], &category ) )
+        {
+            sendOutput( "Error:Invalid category" );
+            return false;
+        }
+
+        pLog->setMinimumLevel( category, level );
+        return true;
+    }
+
+    if ( (parms[0].compareNoCase( "FORMAT" ) == 0) && (parms.size() == 2) )
+    {
+        //  /LOG FORMAT [ TEXT | JSON ]
+        if ( parms[1].compareNoCase( "TEXT" ) == 0 )
+            pLog->setFormat( SystemLog::FORMAT_TEXT );
+        else if ( parms[1].compareNoCase( "JSON" ) == 0 )
+            pLog->setFormat( SystemLog::FORMAT_JSON );
+        else
+        {
+            sendOutput( SyntaxErrorMsg );
+            return false;
+        }
+        return true;
+    }
+
+    sendOutput( SyntaxErrorMsg );
+    return false;
+}
+
+
 //  mediaCreateHandler()
 //
 //  Handles MEDIA CREATE...
@@ -674,6 +935,95 @@ mediaCreateHandler
 }
 
 
+//  nodeAffinityHandler()
+//
+//  Handles NODE AFFINITY...
+static bool
+nodeAffinityHandler
+(
+    const std::list<SuperString>& parameters
+)
+{
+    auto itparm = parameters.begin();
+    if ( itparm != parameters.end() )
+    {
+        if ( itparm->compareNoCase( "CLEAR" ) == 0 )
+        {
+            //  /NODE AFFINITY CLEAR {affinity_node_name}
+            if ( parameters.size() == 2 )
+            {
+                PersistableNodeTable::Result result = pNodeTable->setAffinity( parameters.back(), "ANY" );
+                if ( result != PersistableNodeTable::Result::Success )
+                {
+                    std::stringstream strm;
+                    strm << "Error:" << PersistableNodeTable::getResultString( result );
+                    sendOutput( strm.str() );
+                    return false;
+                }
+
+                sendOutput( "Affinity cleared" );
+                return true;
+            }
+        }
+        else if ( itparm->compareNoCase( "LIST" ) == 0 )
+        {
+            //  /NODE AFFINITY LIST
+            if ( parameters.size() == 1 )
+            {
+                COUNT nodeCount = CpuSet::getNumaNodeCount();
+                std::stringstream hostStrm;
+                hostStrm << "Host has " << CpuSet::getHostCpuCount() << " CPU(s) in " << nodeCount << " NUMA node(s):";
+                for ( COUNT nx = 0; nx < nodeCount; ++nx )
+                {
+                    CpuSet nodeSet;
+                    std::stringstream nodeStrm;
+                    nodeStrm << "NODE" << nx;
+                    if ( CpuSet::parse( nodeStrm.str(), &nodeSet ) )
+                        hostStrm << "  " << nodeStrm.str() << "=" << nodeSet.getCpuListString();
+                }
+                sendOutput( hostStrm.str() );
+
+                const PersistableNodeTable::AFFINITIES& affinities = pNodeTable->getAffinities();
+                if ( affinities.empty() )
+                    sendOutput( "  <no affinities set>" );
+                for ( auto itaff = affinities.begin(); itaff != affinities.end(); ++itaff )
+                {
+                    std::stringstream strm;
+                    strm << "  " << itaff->first << " " << itaff->second.getSpecification()
+                        << " (CPUs " << itaff->second.getCpuListString() << ")";
+                    sendOutput( strm.str() );
+                }
+
+                return true;
+            }
+        }
+        else if ( itparm->compareNoCase( "SET" ) == 0 )
+        {
+            //  /NODE AFFINITY SET {affinity_node_name} {cpu_set}
+            if ( parameters.size() == 3 )
+            {
+                ++itparm;
+                const SuperString& nodeName = *itparm;
+                PersistableNodeTable::Result result = pNodeTable->setAffinity( nodeName, parameters.back() );
+                if ( result != PersistableNodeTable::Result::Success )
+                {
+                    std::stringstream strm;
+                    strm << "Error:" << PersistableNodeTable::getResultString( result );
+                    sendOutput( strm.str() );
+                    return false;
+                }
+
+                sendOutput( "Affinity set" );
+                return true;
+            }
+        }
+    }
+
+    sendOutput( SyntaxErrorMsg );
+    return false;
+}
+
+
 //  nodeConfigHandler()
 //
 //  Handles NODE CONFIG...
@@ -1322,6 +1672,79 @@ quitHandler
 }
 
 
+//  traceHandler()
+//
+//  Handles the TRACE command
+static bool
+traceHandler
+(
+    const std::list<SuperString>& parameters
+)
+{
+    std::vector<SuperString> parms( parameters.begin(), parameters.end() );
+    if ( parms.empty() || ((parms[0].compareNoCase( "SHOW" ) == 0) && (parms.size() == 1)) )
+    {
+        //  /TRACE [ SHOW ]
+        TraceLog::Statistics stats = TraceLog::getStatistics();
+        std::stringstream strm;
+        strm << "Trace is " << (stats.m_Enabled ? "ON" : "OFF")
+            << " Records=" << stats.m_RecordCount
+            << " Threads=" << stats.m_ThreadCount
+            << " Rings=" << stats.m_RingCount << "x" << TraceLog::RING_SIZE
+            << " Names=" << stats.m_NameCount;
+        sendOutput( strm.str() );
+        return true;
+    }
+
+    if ( (parms[0].compareNoCase( "ON" ) == 0) && (parms.size() == 1) )
+    {
+        TraceLog::setEnabled( true );
+        sendOutput( "Trace is now ON" );
+        return true;
+    }
+
+    if ( (parms[0].compareNoCase( "OFF" ) == 0) && (parms.size() == 1) )
+    {
+        TraceLog::setEnabled( false );
+        sendOutput( "Trace is now OFF" );
+        return true;
+    }
+
+    if ( (parms[0].compareNoCase( "DUMP" ) == 0) && (parms.size() <= 2) )
+    {
+        std::string fileName;
+        if ( parms.size() == 1 )
+            fileName = Exec::dumpTrace();
+        else if ( TraceLog::dump( parms[1] ) )
+            fileName = parms[1];
+
+        if ( fileName.empty() )
+        {
+            sendOutput( "Error:Cannot write trace dump - see system log" );
+            return false;
+        }
+
+        sendOutput( "Trace written to " + fileName );
+        return true;
+    }
+
+    if ( (parms[0].compareNoCase( "DECODE" ) == 0) && (parms.size() == 3) )
+    {
+        if ( !TraceDecoder::decode( parms[1], parms[2] ) )
+        {
+            sendOutput( "Error:Cannot decode trace dump - see system log" );
+            return false;
+        }
+
+        sendOutput( "Trace decoded to " + parms[2] );
+        return true;
+    }
+
+    sendOutput( SyntaxErrorMsg );
+    return false;
+}
+
+
 //  ----------------------------------------------------------------------------
 //  Useful static functions
 //  ----------------------------------------------------------------------------
@@ -1526,9 +1949,9 @@ main
     std::cout << "emssp " << VERSION << std::endl;
     std::cout << COPYRIGHT << std::endl;
 
-    //???? need a SystemLog better than this
     SystemLog* pLog = new SystemLog();
-    pLog->open( "emssp.log" );
+    pLog->setRotation( SYSTEM_LOG_MAX_BYTES, false );
+    pLog->open( SYSTEM_LOG_FILE_NAME );
 
     //  Initialization
     pNodeTable = new PersistableNodeTable();
@@ -1589,11 +2012,10 @@ main
 
     pConfiguration = new Configuration();//???? need to load this from config file
 
-    //  Set up RPC listener
-    std::string s = "NetServer";
-    short p = 8000;
-    NetServer* ns = new NetServer(s, p);
-    ns->workerStart();
+    //  Set up the metrics endpoint
+    HttpServer* pMetricsServer = new HttpServer( "MetricsServer", METRICS_PORT );
+    pMetricsServer->registerHandler( METRICS_PATH, &Panel );
+    pMetricsServer->workerStart();
 
     //  Command loop
     char inputBuffer[132];
@@ -1629,7 +2051,13 @@ main
 
     //  Termination
 
-    delete ns;//????
+    if ( IoCapture::isCapturing() )
+        IoCapture::stop();
+
+    pMetricsServer->workerStop( true );
+    pMetricsServer->unregisterHandler( METRICS_PATH );
+    delete pMetricsServer;
+    pMetricsServer = 0;
 
     //???? lose all Node entries...
 
@@ -28,7 +28,9 @@ private:
 public:
     AccountManager( Exec* const pExec )
         :ExecManager( pExec )
-    {}
+    {
+        MISCLIB_SET_LOCK_NAME( "AccountManager" );
+    }
 
     bool                    initialize( Activity* const pBootActivity );
     bool                    recover( Activity* const pBootActivity );
@@ -38,6 +38,25 @@ public:
 static Tracker      TrackingTable;
 #endif
 
+std::atomic<COUNT64>    Activity::m_NextSerialNumber( 1 );
+
+
+
+//  private methods
+
+//  workerExiting()
+//
+//  Our thread (or pool step) is finishing - ask the Exec to reap us right away.
+//  This includes exec activities which finish on their own (keyins, mostly), but not those stopped for shutdown;
+//  they are torn down with the Exec, and the managers may refer to them until then.
+//  The serial number lets the Exec verify, later, that the object it finds is still us.
+void
+Activity::workerExiting()
+{
+    if ( m_pRunInfo && (!m_pRunInfo->isExec() || (m_StopReason != STOP_SHUTDOWN)) )
+        m_pExec->postActivityExit( m_pRunInfo, this, m_SerialNumber );
+}
+
 
 
 //  constructor, destructors
@@ -49,9 +68,11 @@ Activity::Activity
     RunInfo* const      pRunInfo
 )
 :Worker( threadName ),
+m_SerialNumber( m_NextSerialNumber++ ),
 m_pExec( pExec ),
 m_pRunInfo( pRunInfo )
 {
+    MISCLIB_SET_LOCK_NAME( "Activity " + threadName );
 #ifdef  _DEBUG
     TrackingTable.appendActivity( this );
 #endif
@@ -88,6 +109,14 @@ void
         << ( isActive() ? " ACTIVE" : "" )
         << ( isTerminated() ? " TERMINATED" : "" )
         << std::endl;
+
+    Worker::WakeupStatistics stats = getWorkerWakeupStatistics();
+    stream << prefix << "  Signals=" << std::dec << stats.m_SignalCount
+        << " Wakeups=" << stats.m_WakeupCount
+        << " Timeouts=" << stats.m_TimeoutCount
+        << " AvgLatency=" << (stats.m_WakeupCount ? stats.m_TotalLatencyUSecs / stats.m_WakeupCount : 0) << "us"
+        << " MaxLatency=" << stats.m_MaxLatencyUSecs << "us"
+        << std::endl;
 }
 
 
@@ -25,6 +25,14 @@ public:
         STOP_DEMAND_X,      //  @@X keyin from DEMAND
     };
 
+private:
+    const COUNT64                   m_SerialNumber;             //  Unique over the life of the process
+
+    static std::atomic<COUNT64>     m_NextSerialNumber;
+
+    //  Worker interface
+    void                            workerExiting();
+
 protected:
     Exec* const                     m_pExec;
     RunInfo* const                  m_pRunInfo;
@@ -41,6 +49,7 @@ public:
                                           const bool        wait );
 
     inline RunInfo*                 getRunInfo() const          { return m_pRunInfo; }
+    inline COUNT64                  getSerialNumber() const     { return m_SerialNumber; }
     inline const std::string&       getThreadName() const       { return Worker::getWorkerName(); }
     inline bool                     isActive() const            { return Worker::isWorkerActive(); }
     inline bool                     isTerminated() const        { return Worker::isWorkerTerminated(); }
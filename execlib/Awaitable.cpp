@@ -0,0 +1,105 @@
+//  Awaitable implementations
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "execlib.h"
+
+
+
+//  Awaitable
+
+//  wait()
+//
+//  Starts the awaitable, then blocks the given worker (which must be the caller) until it is ready.
+//  If the worker is told to terminate first, we cancel the awaitable.
+//
+//  Returns:
+//      true if the awaitable is ready, false if it was cancelled
+bool
+Awaitable::wait
+(
+    Worker* const       pWorker
+)
+{
+    start( pWorker );
+    while ( !isReady() )
+    {
+        if ( pWorker->isWorkerTerminating() )
+        {
+            cancel();
+            return false;
+        }
+
+        pWorker->workerWait( RECHECK_MSEC );
+    }
+
+    return true;
+}
+
+
+
+//  ChannelProgramAwaitable
+
+//  cancel()
+void
+ChannelProgramAwaitable::cancel()
+{
+    if ( m_pChannelProgram->m_ChannelStatus == ChannelModule::Status::IN_PROGRESS )
+        m_pIOProcessor->cancelIo( m_pChannelProgram );
+}
+
+
+//  isReady()
+bool
+ChannelProgramAwaitable::isReady() const
+{
+    return m_pChannelProgram->m_ChannelStatus != ChannelModule::Status::IN_PROGRESS;
+}
+
+
+//  start()
+//
+//  The channel module signals the channel program's source worker upon completion, so we make that the waiter.
+void
+ChannelProgramAwaitable::start
+(
+    Worker* const       pWorker
+)
+{
+    m_pChannelProgram->m_pSource = pWorker;
+    m_pIOProcessor->routeIo( m_pChannelProgram );
+}
+
+
+
+//  ReadReplyAwaitable
+
+//  cancel()
+//
+//  Withdraws the request - once this returns, the console manager no longer refers to the request or the waiter.
+void
+ReadReplyAwaitable::cancel()
+{
+    m_pConsoleManager->cancelReadReplyMessage( m_pRequest );
+}
+
+
+//  isReady()
+bool
+ReadReplyAwaitable::isReady() const
+{
+    return m_pRequest->isCompleted() || m_pRequest->isCancelled();
+}
+
+
+//  start()
+void
+ReadReplyAwaitable::start
+(
+    Worker* const       pWorker
+)
+{
+    m_pRequest->setNotifyWorker( pWorker );
+    m_pConsoleManager->postReadReplyMessage( m_pRequest, false );
+}
@@ -0,0 +1,83 @@
+//  Awaitable.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Things a Worker may wait upon without polling.
+//  Awaitables signal the worker via workerSignal() upon completion, so wait() sleeps until then;
+//  isReady() is also re-checked periodically, in case some completion path does not signal.
+//  A worker which cannot block (such as IoActivity, juggling many requests) calls start() itself, and checks
+//  isReady() when signaled.  Whoever started an awaitable must cancel() it if they go away before it is ready.
+
+
+
+#ifndef     EXECLIB_AWAITABLE_H
+#define     EXECLIB_AWAITABLE_H
+
+
+
+#include    "ConsoleManager.h"
+
+
+
+class   Awaitable
+{
+private:
+    static const COUNT32        RECHECK_MSEC = 1000;        //  how often wait() looks at us without being signaled
+
+public:
+    virtual ~Awaitable(){}
+
+    bool                        wait( Worker* const pWorker );
+
+    //  Abandons the wait - invoked if the activity terminates while waiting
+    virtual void                cancel(){}
+    //  Indicates whether the awaited thing has happened
+    virtual bool                isReady() const = 0;
+    //  Starts whatever is to be awaited - the given worker is to be signaled upon completion
+    virtual void                start( Worker* const pWorker ) = 0;
+};
+
+
+//  Waits for a channel program to complete.
+//  The channel program belongs to the caller, and must outlive the wait.
+class   ChannelProgramAwaitable : public Awaitable
+{
+private:
+    ChannelModule::ChannelProgram* const    m_pChannelProgram;
+    IOProcessor* const                      m_pIOProcessor;
+
+public:
+    ChannelProgramAwaitable( IOProcessor* const                     pIOProcessor,
+                             ChannelModule::ChannelProgram* const   pChannelProgram )
+        :m_pChannelProgram( pChannelProgram ),
+        m_pIOProcessor( pIOProcessor )
+    {}
+
+    void                        cancel();
+    bool                        isReady() const;
+    void                        start( Worker* const pWorker );
+};
+
+
+//  Waits for the operator to answer (or the Exec to cancel) a console read-reply message.
+//  The request belongs to the caller, and must outlive the wait.
+class   ReadReplyAwaitable : public Awaitable
+{
+private:
+    ConsoleManager* const                       m_pConsoleManager;
+    ConsoleManager::ReadReplyRequest* const     m_pRequest;
+
+public:
+    ReadReplyAwaitable( ConsoleManager* const                   pConsoleManager,
+                        ConsoleManager::ReadReplyRequest* const pRequest )
+        :m_pConsoleManager( pConsoleManager ),
+        m_pRequest( pRequest )
+    {}
+
+    void                        cancel();
+    bool                        isReady() const;
+    void                        start( Worker* const pWorker );
+};
+
+
+
+#endif
@@ -284,6 +284,40 @@ BootActivity::assignSystemFile
 }
 
 
+//  awaitReply()
+//
+//  Posts a read-reply message with a limited set of acceptable responses, and arranges for the state machine
+//  to resume in the given state (which should call takeReply()) when the operator answers.  No thread is held
+//  meanwhile.  The named span times the wait.
+void
+BootActivity::awaitReply
+(
+    const std::string&      prompt,
+    const VSTRING&          responses,
+    const std::string&      spanName,
+    const STATE             resumeState
+)
+{
+    BYTE max = 0;
+    for ( INDEX rx = 0; rx < responses.size(); ++rx )
+    {
+        if ( max < responses[rx].size() )
+            max = static_cast<BYTE>(responses[rx].size());
+    }
+
+    delete m_pReplyRequest;
+    m_pReplyRequest = new ConsoleManager::ReadReplyRequest( m_pExec->getRunInfo(),
+                                                            0,
+                                                            ConsoleManager::Group::SYSTEM,
+                                                            prompt,
+                                                            max );
+    m_ReplyResponses = responses;
+
+    m_pWaitSpan = new BootProfile::Span( m_pExec->getBootProfile(), spanName );
+    awaitEvent( new ReadReplyAwaitable( m_pConsoleManager, m_pReplyRequest ), resumeState );
+}
+
+
 //  catalogSystemFile()
 //
 //  Catalogs one system file, based on the current state and the settings for the
@@ -359,85 +393,6 @@ BootActivity::checkFacStatus
 }
 
 
-//  confirmFixedDeviceCount()
-bool
-BootActivity::confirmFixedDeviceCount()
-{
-    //  Prompt operator to ensure the proper number of fixed drives.
-    //  Part of this process entails directing MFD to read the disk labels of the accessible packs.
-    //      n-FIXED MS DEVICES= 1 - CONTINUE? YN
-    COUNT fixedCount = 0;
-    MFDManager* pMfdMgr = dynamic_cast<MFDManager*>( m_pExec->getManager( Exec::MID_MFD_MANAGER ) );
-    pMfdMgr->readDiskLabels( this, &fixedCount );
-    if ( fixedCount == 0 )
-    {
-        //  Oops - there aren't any fixed packs.  We cannot proceed.
-        std::string consMsg = "INVALID CONFIGURATION-NO FIXED DEVICES FOUND";
-        m_pConsoleManager->postReadOnlyMessage( consMsg, Routing, m_pExec->getRunInfo() );
-        m_pExec->stopExec( Exec::SC_INITIALIZATION );
-        return false;
-    }
-
-    std::stringstream strm;
-    strm << "FIXED MS DEVICES=" << std::setw( 2 ) << std::dec << fixedCount << " - CONTINUE? YN";
-    VSTRING responses;
-    responses.push_back( "Y" );
-    responses.push_back( "N" );
-    INDEX respIndex = 0;
-    if ( !m_pConsoleManager->postReadReplyMessage( strm.str(),
-                                                   responses,
-                                                   &respIndex,
-                                                   m_pExec->getRunInfo() ) )
-    {
-        return false;
-    }
-
-    if ( !isWorkerTerminating() && respIndex == 1 )
-    {
-        m_pExec->stopExec( Exec::SC_OPERATOR_KEYIN );
-        return false;
-    }
-
-    return true;
-}
-
-
-//  confirmJK13()
-//
-//  Remind operator that JK13 is set, and prompt whether he really wants this.
-//      JK 13 is set and will cause mass storage to be reinitialized,
-//      0-are you sure you want JK 13 set? Answer Y or N
-bool
-BootActivity::confirmJK13()
-{
-    m_pConsoleManager->postReadOnlyMessage( "JK 13 is set and will cause mass storage to be reinitialized.",
-                                            Routing,
-                                            m_pExec->getRunInfo() );
-    if ( isWorkerTerminating() )
-        return false;
-
-    VSTRING responses;
-    responses.push_back( "Y" );
-    responses.push_back( "N" );
-    INDEX respIndex = 0;
-    if ( !m_pConsoleManager->postReadReplyMessage( "Are you sure you want JK 13 set?  Answer Y or N",
-                                                   responses,
-                                                   &respIndex,
-                                                   m_pExec->getRunInfo() ) )
-    {
-        return false;
-    }
-
-    if ( !isWorkerTerminating() && respIndex == 1 )
-    {
-        m_pExec->stopExec( Exec::SC_OPERATOR_KEYIN );
-        return false;
-    }
-
-    return true;
-}
-
-
 //  displayJumpKeysSet()
 //
 //  Possibly multi-step process to show the operator which jump keys are set during boot
@@ -528,74 +483,14 @@ BootActivity::displayStartupMessages()
 }
 
 
-//  initialBoot()
+//  endWaitSpan()
 //
-//  JK13 boot path
+//  Ends the span timing an operator's answer, if there is one
 void
-BootActivity::initialBoot()
+BootActivity::endWaitSpan()
 {
-    if ( !confirmJK13() || isWorkerTerminating() )
-        return;
-
-    m_pExec->displayTime( m_pExec->getExecTime(), true, Routing );
-    if ( isWorkerTerminating() )
-        return;
-
-    if ( !confirmFixedDeviceCount() || isWorkerTerminating() )
-        return;
-
-    waitForDownPackKeyins();
-    if ( isWorkerTerminating() )
-        return;
-
-    if ( !initializeMassStorage() || isWorkerTerminating() )
-        return;
-
-    if ( !initializeGenf() || isWorkerTerminating() )
-        return;
-
-    if ( !initializeDloc() || isWorkerTerminating() )
-        return;
-
-    AccountManager* pAccMgr = dynamic_cast<AccountManager*>( m_pExec->getManager( Exec::MID_ACCOUNT_MANAGER ) );
-    if ( !pAccMgr->initialize( this ) || isWorkerTerminating() )
-        return;
-
-    SecurityManager* pSecMgr = dynamic_cast<SecurityManager*>( m_pExec->getManager( Exec::MID_SECURITY_MANAGER ) );
-    if ( !pSecMgr->initialize( this ) || isWorkerTerminating() )
-        return;
-
-    //  Start up some other activities
-    CoarseSchedulerActivity* pCoarseSchedulerActivity = new CoarseSchedulerActivity( m_pExec );
-    m_pExec->getRunInfo()->appendTaskActivity( pCoarseSchedulerActivity );
-    pCoarseSchedulerActivity->start();
-
-    PollActivity* pPollActivity = new PollActivity( m_pExec );
-    m_pExec->getRunInfo()->appendTaskActivity( pPollActivity );
-    pPollActivity->start();
-
-    //  Create and start SYS, and wait until it is done (need intrinsic @LIBCOPY routine of some sort)
-    m_pExec->setStatus( Exec::ST_SYS );
-/*
-SYS START
-SYS SYS*MSG: CREATING - SYSTEM FILES
-SYS SYS*MSG: CREATED - SYSTEM FILES
-SYS SYS FIN
-*/
-
-/*
-Main storage size = 264830976 words
-*/
-
-    m_pExec->setStatus( Exec::ST_RUNNING );
-
-    //  Ready for RSI to get going...
-    RSIManager* pRsiMgr = dynamic_cast<RSIManager*>( m_pExec->getManager( Exec::MID_RSI_MANAGER ) );
-    RSIActivity* pRSIActivity = new RSIActivity( m_pExec, pRsiMgr );
-    m_pExec->getRunInfo()->appendTaskActivity( pRSIActivity );
-    pRSIActivity->start();
-
-    //  And we're out of here...
+    delete m_pWaitSpan;
+    m_pWaitSpan = 0;
 }
 
 
@@ -664,102 +559,412 @@ BootActivity::initializeMassStorage()
 void
 BootActivity::recoveryBoot()
 {
+    BootProfile::Span bootSpan( m_pExec->getBootProfile(), "RECOVERY BOOT" );
     //TODO:RECOV
 }
 
 
-//  waitForDownPackKeyins()
+//  reportBootProfile()
+//
+//  Ends the boot timeline, and reports it - the top three levels on the console, everything in the log,
+//  and the whole thing as a JSON file for tools (chrome://tracing, or ui.perfetto.dev) to chew on.
+//      BOOT TIMELINE 2042 MS
+//        MASS STORAGE 704 MS
+void
+BootActivity::reportBootProfile()
+{
+    BootProfile* pProfile = m_pExec->getBootProfile();
+    pProfile->finish();
+
+    std::stringstream strm;
+    strm << "BOOT TIMELINE " << pProfile->getTotalMicros() / 1000 << " MS";
+    m_pConsoleManager->postReadOnlyMessage( strm.str(), 0 );
+    SYSTEM_LOG( EXEC, INFO, "BootActivity session " << m_pExec->getCurrentSession() << " " << strm.str() );
+
+    BootProfile::ENTRIES entries = pProfile->getEntries();
+    for ( BootProfile::CITENTRIES ite = entries.begin(); ite != entries.end(); ++ite )
+    {
+        std::string indent( 2 * (ite->m_Depth + 1), ASCII_SPACE );
+        const char* pSuffix = ite->m_Ended ? "" : " (INCOMPLETE)";
+        if ( ite->m_Depth <= 2 )
+        {
+            strm.str( "" );
+            strm << indent << ite->m_Name << " " << ite->m_DurationMicros / 1000 << " MS" << pSuffix;
+            m_pConsoleManager->postReadOnlyMessage( strm.str(), 0 );
+        }
+
+        SYSTEM_LOG( EXEC, INFO, "BootActivity " << indent << ite->m_Name
+                    << " start=" << ite->m_StartMicros << "us duration=" << ite->m_DurationMicros << "us" << pSuffix );
+    }
+
+    SystemTime* pLocalTime = SystemTime::createLocalSystemTime();
+    std::string fileName = "ExecBoot." + pLocalTime->getTimeStamp() + ".json";
+    delete pLocalTime;
+    pLocalTime = 0;
+
+    if ( pProfile->writeJson( fileName ) )
+        SystemLog::write( "Boot timeline written to " + fileName );
+}
+
+
+//  takeReply()
+//
+//  For the state in which awaitReply() resumes us.  If the operator gave one of the acceptable responses,
+//  we store its index.  If not, we ask again, resuming in this same state - or if the message was cancelled
+//  (the exec is stopping), we go to DONE.
+//
+//  Returns:
+//      true if *pIndex is the operator's answer, false if the caller should simply return
+bool
+BootActivity::takeReply
+(
+    INDEX* const            pIndex
+)
+{
+    if ( !m_pReplyRequest->isCompleted() )
+    {
+        endWaitSpan();
+        setNextState( DONE );
+        return false;
+    }
+
+    for ( INDEX rx = 0; rx < m_ReplyResponses.size(); ++rx )
+    {
+        if ( m_pReplyRequest->getResponse().compareNoCase( m_ReplyResponses[rx] ) == 0 )
+        {
+            *pIndex = rx;
+            endWaitSpan();
+            return true;
+        }
+    }
+
+    m_pReplyRequest->setCompleted( false );
+    awaitEvent( new ReadReplyAwaitable( m_pConsoleManager, m_pReplyRequest ), getCurrentState() );
+    return false;
+}
+
+
+
+//  private, protected static methods
+
+//  handleDone()
+//
+//  However the boot ends, close what is still open, and report the timeline
+void
+BootActivity::handleDone
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    BootActivity* pActivity = dynamic_cast<BootActivity*>( pObject );
+    pActivity->endWaitSpan();
+    delete pActivity->m_pBootSpan;
+    pActivity->m_pBootSpan = 0;
+
+    if ( pActivity->m_pExec->getBootProfile()->isProfiling() )
+        pActivity->reportBootProfile();
+}
+
+
+//  handleFixedDevices()
+//
+//  Prompt operator to ensure the proper number of fixed drives.
+//  Part of this process entails directing MFD to read the disk labels of the accessible packs -
+//  MFD waits for that IO synchronously, so we hold our pool carrier meanwhile.
+//      n-FIXED MS DEVICES= 1 - CONTINUE? YN
+void
+BootActivity::handleFixedDevices
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    BootActivity* pActivity = dynamic_cast<BootActivity*>( pObject );
+    Exec* pExec = pActivity->m_pExec;
+
+    COUNT fixedCount = 0;
+    {
+        BootProfile::Span span( pExec->getBootProfile(), "FIXED DEVICES" );
+        MFDManager* pMfdMgr = dynamic_cast<MFDManager*>( pExec->getManager( Exec::MID_MFD_MANAGER ) );
+        pMfdMgr->readDiskLabels( pActivity, &fixedCount );
+    }
+
+    if ( pActivity->isWorkerTerminating() )
+        return;
+
+    if ( fixedCount == 0 )
+    {
+        //  Oops - there aren't any fixed packs.  We cannot proceed.
+        std::string consMsg = "INVALID CONFIGURATION-NO FIXED DEVICES FOUND";
+        pActivity->m_pConsoleManager->postReadOnlyMessage( consMsg, Routing, pExec->getRunInfo() );
+        pExec->stopExec( Exec::SC_INITIALIZATION );
+        return;
+    }
+
+    std::stringstream strm;
+    strm << "FIXED MS DEVICES=" << std::setw( 2 ) << std::dec << fixedCount << " - CONTINUE? YN";
+    VSTRING responses;
+    responses.push_back( "Y" );
+    responses.push_back( "N" );
+    pActivity->awaitReply( strm.str(), responses, "FIXED DEVICES CONFIRM WAIT", FIXED_DEVICES_REPLY );
+}
+
+
+//  handleFixedDevicesReply()
 //
-//  Allow the user to mark packs down.  (We don't do this right now, but one day we might).
+//  The operator has confirmed the fixed device count (or not).  If so, allow the operator to mark packs down.
+//  (We don't do this right now, but one day we might).
 //      n-ENTER LOCAL DOWN PACK KEYINS - ANS GO
 void
-BootActivity::waitForDownPackKeyins()
+BootActivity::handleFixedDevicesReply
+(
+    IntrinsicActivity* const    pObject
+)
 {
+    BootActivity* pActivity = dynamic_cast<BootActivity*>( pObject );
+    INDEX respIndex = 0;
+    if ( !pActivity->takeReply( &respIndex ) )
+        return;
+
+    if ( respIndex == 1 )
+    {
+        pActivity->m_pExec->stopExec( Exec::SC_OPERATOR_KEYIN );
+        return;
+    }
+
     VSTRING responses;
     responses.push_back( "GO" );
+    pActivity->awaitReply( "ENTER LOCAL DOWN PACK KEYINS - ANS GO", responses, "DOWN PACK WAIT", INITIALIZE );
+}
+
+
+//  handleInitialize()
+//
+//  The rest of the JK13 boot path, once the operator is done with down pack keyins - initialize mass storage,
+//  create the system files, and start up the other activities.  MFD and the facilities do their disk IO
+//  synchronously, so we hold our pool carrier for the duration.
+void
+BootActivity::handleInitialize
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    BootActivity* pActivity = dynamic_cast<BootActivity*>( pObject );
+    Exec* pExec = pActivity->m_pExec;
+    BootProfile* pProfile = pExec->getBootProfile();
+
+    INDEX respIndex = 0;
+    if ( !pActivity->takeReply( &respIndex ) )
+        return;
+
+    {
+        BootProfile::Span span( pProfile, "MASS STORAGE" );
+        if ( !pActivity->initializeMassStorage() || pActivity->isWorkerTerminating() )
+            return;
+    }
+
+    {
+        BootProfile::Span span( pProfile, "GENF$" );
+        if ( !pActivity->initializeGenf() || pActivity->isWorkerTerminating() )
+            return;
+    }
+
+    {
+        BootProfile::Span span( pProfile, "DLOC$" );
+        if ( !pActivity->initializeDloc() || pActivity->isWorkerTerminating() )
+            return;
+    }
+
+    {
+        BootProfile::Span span( pProfile, "ACCOUNTS" );
+        AccountManager* pAccMgr = dynamic_cast<AccountManager*>( pExec->getManager( Exec::MID_ACCOUNT_MANAGER ) );
+        if ( !pAccMgr->initialize( pActivity ) || pActivity->isWorkerTerminating() )
+            return;
+    }
+
+    {
+        BootProfile::Span span( pProfile, "SECURITY" );
+        SecurityManager* pSecMgr = dynamic_cast<SecurityManager*>( pExec->getManager( Exec::MID_SECURITY_MANAGER ) );
+        if ( !pSecMgr->initialize( pActivity ) || pActivity->isWorkerTerminating() )
+            return;
+    }
+
+    //  Start up some other activities
+    BootProfile::Span startSpan( pProfile, "START ACTIVITIES" );
+    CoarseSchedulerActivity* pCoarseSchedulerActivity = new CoarseSchedulerActivity( pExec );
+    pExec->getRunInfo()->appendTaskActivity( pCoarseSchedulerActivity );
+    pCoarseSchedulerActivity->start();
+
+    RunEventActivity* pRunEventActivity = new RunEventActivity( pExec );
+    pExec->getRunInfo()->appendTaskActivity( pRunEventActivity );
+    pRunEventActivity->start();
+
+    PollActivity* pPollActivity = new PollActivity( pExec );
+    pExec->getRunInfo()->appendTaskActivity( pPollActivity );
+    pPollActivity->start();
+
+    MFDScanActivity* pMFDScanActivity = new MFDScanActivity( pExec );
+    pExec->getRunInfo()->appendTaskActivity( pMFDScanActivity );
+    pMFDScanActivity->start();
+
+    //  Create and start SYS, and wait until it is done (need intrinsic @LIBCOPY routine of some sort)
+    pExec->setStatus( Exec::ST_SYS );
+/*
+SYS START
+SYS SYS*MSG: CREATING - SYSTEM FILES
+SYS SYS*MSG: CREATED - SYSTEM FILES
+SYS SYS FIN
+*/
+
+/*
+Main storage size = 264830976 words
+*/
+
+    pExec->setStatus( Exec::ST_RUNNING );
+
+    //  Ready for RSI to get going...
+    RSIManager* pRsiMgr = dynamic_cast<RSIManager*>( pExec->getManager( Exec::MID_RSI_MANAGER ) );
+    RSIActivity* pRSIActivity = new RSIActivity( pExec, pRsiMgr );
+    pExec->getRunInfo()->appendTaskActivity( pRSIActivity );
+    pRSIActivity->start();
+
+    //  And we're out of here...
+}
+
+
+//  handleJK13Reply()
+//
+//  The operator has answered whether JK13 is really wanted.  If so, display the time and carry on.
+void
+BootActivity::handleJK13Reply
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    BootActivity* pActivity = dynamic_cast<BootActivity*>( pObject );
+    Exec* pExec = pActivity->m_pExec;
+
     INDEX respIndex = 0;
-    m_pConsoleManager->postReadReplyMessage( "ENTER LOCAL DOWN PACK KEYINS - ANS GO",
-                                             responses,
-                                             &respIndex,
-                                             m_pExec->getRunInfo() );
-    return;
+    if ( !pActivity->takeReply( &respIndex ) )
+        return;
+
+    if ( respIndex == 1 )
+    {
+        pExec->stopExec( Exec::SC_OPERATOR_KEYIN );
+        pActivity->setNextState( DONE );
+        return;
+    }
+
+    BootProfile::Span span( pExec->getBootProfile(), "DISPLAY TIME" );
+    pExec->displayTime( pExec->getExecTime(), true, Routing );
 }
 
 
-//  waitForModifyConfig()
+//  handleModifyConfigReply()
 //
-//  Allow the user to mark packs down.  (We don't do this right now, but one day we might).
-//      n-Modify config, then answer: DONE
+//  The operator has finished modifying the config
 void
-BootActivity::waitForModifyConfig()
+BootActivity::handleModifyConfigReply
+(
+    IntrinsicActivity* const    pObject
+)
 {
-    VSTRING responses;
-    responses.push_back( "DONE" );
+    BootActivity* pActivity = dynamic_cast<BootActivity*>( pObject );
     INDEX respIndex = 0;
-    m_pConsoleManager->postReadReplyMessage( "Modify config, then answer: DONE",
-                                             responses,
-                                             &respIndex,
-                                             m_pExec->getRunInfo() );
+    pActivity->takeReply( &respIndex );
 }
 
 
-//  worker()
+//  handleSession()
 //
-//  Main code for this activity
+//  No more config changes - display the session number, then branch on JK13.
+//  For the JK13 path, remind the operator that JK13 is set, and prompt whether they really want this.
+//      JK 13 is set and will cause mass storage to be reinitialized,
+//      0-are you sure you want JK 13 set? Answer Y or N
 void
-BootActivity::worker()
+BootActivity::handleSession
+(
+    IntrinsicActivity* const    pObject
+)
 {
-    std::stringstream strm;
+    BootActivity* pActivity = dynamic_cast<BootActivity*>( pObject );
+    Exec* pExec = pActivity->m_pExec;
 
-    //  Set boot status 1 - allow FS keyins, SJ/CJ/DJ, and D keyin to set time/date.
-    m_pExec->setStatus( Exec::ST_BOOTING_1 );
+    //  Set boot status 2 - no more config changes for the time being...
+    pExec->setStatus( Exec::ST_BOOTING_2 );
 
-    //  Set holds on batch and demand
-    m_pExec->setHoldBatchRuns( true );
-    m_pExec->setHoldDemandTerminals( true );
+    pActivity->displaySessionNumber();
+    if ( pActivity->isWorkerTerminating() )
+        return;
 
-    displayStartupMessages();
-    if ( isWorkerTerminating() )
+    if ( !pExec->getJumpKey( 13 ) )
+    {
+        pActivity->recoveryBoot();
         return;
+    }
 
-    displayJumpKeysSet();
-    if ( isWorkerTerminating() )
+    pActivity->m_pBootSpan = new BootProfile::Span( pExec->getBootProfile(), "INITIAL BOOT" );
+    pActivity->m_pConsoleManager->postReadOnlyMessage( "JK 13 is set and will cause mass storage to be reinitialized.",
+                                                       Routing,
+                                                       pExec->getRunInfo() );
+    if ( pActivity->isWorkerTerminating() )
         return;
 
-    //  If this an automatic boot (non-operator), display the system error message.
-    //      System error ooo terminated session ooo.
-    if ( !m_pExec->isOperatorBoot() )
+    VSTRING responses;
+    responses.push_back( "Y" );
+    responses.push_back( "N" );
+    pActivity->awaitReply( "Are you sure you want JK 13 set?  Answer Y or N", responses, "JK13 CONFIRM WAIT", JK13_REPLY );
+}
+
+
+//  handleStartup()
+//
+//  Starts the boot timeline, displays the startup messages, and for operator boots,
+//  asks the operator to modify the config.
+void
+BootActivity::handleStartup
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    BootActivity* pActivity = dynamic_cast<BootActivity*>( pObject );
+    Exec* pExec = pActivity->m_pExec;
+    BootProfile* pProfile = pExec->getBootProfile();
+    pProfile->start( pExec->getCurrentSession() );
+
+    //  Set boot status 1 - allow FS keyins, SJ/CJ/DJ, and D keyin to set time/date.
+    pExec->setStatus( Exec::ST_BOOTING_1 );
+
+    //  Set holds on batch and demand
+    pExec->setHoldBatchRuns( true );
+    pExec->setHoldDemandTerminals( true );
 
     {
-        m_pExec->displaySystemErrorMsg( m_pExec->getLastStopCode(),
-                                        m_pExec->getCurrentSession() - 1 );
-        if ( isWorkerTerminating() )
+        BootProfile::Span span( pProfile, "STARTUP MESSAGES" );
+        pActivity->displayStartupMessages();
+        if ( pActivity->isWorkerTerminating() )
             return;
-    }
 
-    //  Canonically, modify config is allowed for tape boots.
-    //  We don't have tape boots, but we do have the concept of reloading the OS...
-    //  This is done by emexec, and results in discarding and reinstantiating the Exec object (and its dependencies).
-    //  For our purposes, we'll just assume that all operator (manual) boots should ask the question.
-    if ( m_pExec->isOperatorBoot() )
-    {
-        waitForModifyConfig();
-        if ( isWorkerTerminating() )
+        pActivity->displayJumpKeysSet();
+        if ( pActivity->isWorkerTerminating() )
             return;
     }
 
-    //  Set boot status 1 - no more config changes for the time being...
-    m_pExec->setStatus( Exec::ST_BOOTING_2 );
-
-    displaySessionNumber();
-    if ( isWorkerTerminating() )
+    //  If this an automatic boot (non-operator), display the system error message.
+    //      System error ooo terminated session ooo.
+    if ( !pExec->isOperatorBoot() )
+    {
+        pExec->displaySystemErrorMsg( pExec->getLastStopCode(), pExec->getCurrentSession() - 1 );
         return;
+    }
 
-    //  Branch here for jump 13.
-    if ( m_pExec->getJumpKey( 13 ) )
-        initialBoot();
-    else
-        recoveryBoot();
+    //  Canonically, modify config is allowed for tape boots.
+    //  We don't have tape boots, but we do have the concept of reloading the OS...
+    //  This is done by emexec, and results in discarding and reinstantiating the Exec object (and its dependencies).
+    //  For our purposes, we'll just assume that all operator (manual) boots should ask the question.
+    //      n-Modify config, then answer: DONE
+    VSTRING responses;
+    responses.push_back( "DONE" );
+    pActivity->awaitReply( "Modify config, then answer: DONE", responses, "MODIFY CONFIG WAIT", MODIFY_CONFIG_REPLY );
 }
 
 
@@ -792,7 +997,10 @@ BootActivity::BootActivity
 (
     Exec* const         pExec
 )
-:IntrinsicActivity( pExec, "BootActivity", pExec->getRunInfo() )
+:IntrinsicActivity( pExec, "BootActivity", pExec->getRunInfo() ),
+m_pBootSpan( 0 ),
+m_pReplyRequest( 0 ),
+m_pWaitSpan( 0 )
 {
     m_pConsoleManager = dynamic_cast<ConsoleManager*>( pExec->getManager( Exec::MID_CONSOLE_MANAGER ) );
 
@@ -807,6 +1015,24 @@ BootActivity::BootActivity
     m_RunAssignMnemonic = m_pExec->getConfiguration().getStringValue( "RUNASGMNE" );
     m_RunInitialReserve = m_pExec->getConfiguration().getIntegerValue( "RUNINTRES" );
     m_RunMaxSize = m_pExec->getConfiguration().getIntegerValue( "RUNMAXSIZ" );
+
+    //  The operator's answers are awaited between states, so the boot holds no thread while waiting for them
+    establishStateEntry( STARTUP, handleStartup, SESSION );
+    establishStateEntry( MODIFY_CONFIG_REPLY, handleModifyConfigReply, SESSION );
+    establishStateEntry( SESSION, handleSession, DONE );
+    establishStateEntry( JK13_REPLY, handleJK13Reply, FIXED_DEVICES );
+    establishStateEntry( FIXED_DEVICES, handleFixedDevices, DONE );
+    establishStateEntry( FIXED_DEVICES_REPLY, handleFixedDevicesReply, DONE );
+    establishStateEntry( INITIALIZE, handleInitialize, DONE );
+    establishStateEntry( DONE, handleDone, DONE );
+}
+
+
+BootActivity::~BootActivity()
+{
+    delete m_pBootSpan;
+    delete m_pReplyRequest;
+    delete m_pWaitSpan;
 }
 
 
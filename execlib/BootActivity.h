@@ -10,6 +10,7 @@
 
 
 
+#include    "BootProfile.h"
 #include    "FacilitiesManager.h"
 #include    "IntrinsicActivity.h"
 
@@ -18,6 +19,18 @@
 class	BootActivity : public IntrinsicActivity
 {
 private:
+    enum LocalState
+    {
+        STARTUP             = m_InitialState,   //  Startup messages, and the modify config question for operator boots
+        MODIFY_CONFIG_REPLY,                    //  Operator has answered DONE
+        SESSION,                                //  Session number, then branch on JK13
+        JK13_REPLY,                             //  Operator has confirmed (or not) that JK13 is wanted
+        FIXED_DEVICES,                          //  Read the disk labels, and ask for the fixed device count to be confirmed
+        FIXED_DEVICES_REPLY,                    //  Operator has confirmed (or not) the fixed device count
+        INITIALIZE,                             //  Operator has answered GO to down pack keyins - initialize and start things
+        DONE                = m_TerminalState,  //  Report the boot timeline
+    };
+
     class SystemFileInfo
     {
     public:
@@ -52,6 +65,7 @@ private:
         {}
     };
 
+    BootProfile::Span*  m_pBootSpan;                //  INITIAL BOOT, which lasts over several states
     ConsoleManager*     m_pConsoleManager;
     SuperString         m_DefaultDiskType;          //  Asg mnemonic for disk files not specifically covered otherwise
     SuperString         m_DlocAssignMnemonic;       //  DLOCASGMNE  - asg mnemonic for SYS$*DLOC$
@@ -60,32 +74,47 @@ private:
     SuperString         m_LibAssignMnemonic;        //  LIBASGMNE   - asg mnemonic for SYS$*LIB$
     COUNT               m_LibInitialReserve;        //  LIBINTRES   - initial reserve for SYS$*LIB$
     COUNT               m_LibMaxSize;               //  LIBMAXSIZ   - max size for SYS$*LIB$
+    ConsoleManager::ReadReplyRequest*
+                        m_pReplyRequest;            //  Most recent operator question
+    VSTRING             m_ReplyResponses;           //  ...and the answers we accept to it
 //  REWDRV      - deals with rewinding drives on recovery boots
     SuperString         m_RunAssignMnemonic;        //  RUNASGMNE   - asg mnemonic for SYS$*RUN$
     COUNT               m_RunInitialReserve;        //  RUNINTRES   - initial reserve for SYS$*RUN$
     COUNT               m_RunMaxSize;               //  RUNMAXSIZE  - max size for SYS$*RUN$
 //  SSEQPT      - asg mnemonic for EXEC and system processor @ASG of tape files
+    BootProfile::Span*  m_pWaitSpan;                //  Times the operator's answer to m_pReplyRequest
 
     bool                        assignSystemFile( SystemFileInfo* const pSystemFileInfo );
+    void                        awaitReply( const std::string&  prompt,
+                                            const VSTRING&      responses,
+                                            const std::string&  spanName,
+                                            const STATE         resumeState );
     bool                        catalogSystemFile( SystemFileInfo* const pSystemFileInfo );
     bool                        checkFacStatus( const FacilitiesManager::Result&    result,
                                                 const std::string&                  message );
-    bool                        confirmFixedDeviceCount();
-    bool                        confirmJK13();
     void                        displayJumpKeysSet();
     void                        displaySessionNumber();
     void                        displayStartupMessages();
-    void                        initialBoot();
+    void                        endWaitSpan();
     bool                        initializeDloc();
     bool                        initializeGenf();
     bool                        initializeMassStorage();
     void                        recoveryBoot();
-    void                        waitForDownPackKeyins();
-    void                        waitForModifyConfig();
-    void                        worker();
+    void                        reportBootProfile();
+    bool                        takeReply( INDEX* const pIndex );
+
+    static void                 handleDone( IntrinsicActivity* const pObject );
+    static void                 handleFixedDevices( IntrinsicActivity* const pObject );
+    static void                 handleFixedDevicesReply( IntrinsicActivity* const pObject );
+    static void                 handleInitialize( IntrinsicActivity* const pObject );
+    static void                 handleJK13Reply( IntrinsicActivity* const pObject );
+    static void                 handleModifyConfigReply( IntrinsicActivity* const pObject );
+    static void                 handleSession( IntrinsicActivity* const pObject );
+    static void                 handleStartup( IntrinsicActivity* const pObject );
 
 public:
     BootActivity( Exec* const pExec );
+    ~BootActivity();
 
     //  InstrinsicActivity interface
     void                        dump( std::ostream&         stream,
@@ -0,0 +1,249 @@
+//  BootProfile.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "execlib.h"
+
+
+
+//  private methods
+
+//  begin()
+//
+//  Opens an entry at the current depth.
+//
+//  Returns:
+//      index of the new entry, or NO_ENTRY if we are not profiling (or this is not the booting Worker)
+INDEX
+BootProfile::begin
+(
+    const std::string&      name
+)
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    if ( !m_Profiling || (Worker::getCurrentWorker() != m_pWorker) )
+        return NO_ENTRY;
+
+    m_Entries.push_back( Entry( m_Depth++, name, LatencyHistogram::getMicroseconds() - m_StartMicros ) );
+    return m_Entries.size() - 1;
+}
+
+
+//  end()
+//
+//  Closes an entry opened by begin().  The depth goes back to that of the entry, so that an entry left open
+//  by mistake cannot skew the depth of everything after it.
+void
+BootProfile::end
+(
+    const INDEX             index
+)
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    if ( !m_Profiling || (index == NO_ENTRY) || (index >= m_Entries.size()) )
+        return;
+
+    Entry& entry = m_Entries[index];
+    entry.m_DurationMicros = LatencyHistogram::getMicroseconds() - m_StartMicros - entry.m_StartMicros;
+    entry.m_Ended = true;
+    m_Depth = entry.m_Depth;
+}
+
+
+//  getJsonString()
+//
+//  Quotes and escapes a string for JSON
+std::string
+BootProfile::getJsonString
+(
+    const std::string&      value
+)
+{
+    std::stringstream strm;
+    strm << "\"";
+    for ( INDEX cx = 0; cx < value.size(); ++cx )
+    {
+        char ch = value[cx];
+        if ( (ch == '"') || (ch == '\\') )
+            strm << '\\' << ch;
+        else if ( static_cast<BYTE>(ch) < ASCII_SPACE )
+            strm << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << static_cast<int>(ch) << std::dec;
+        else
+            strm << ch;
+    }
+    strm << "\"";
+    return strm.str();
+}
+
+
+
+//  constructors, destructors
+
+BootProfile::BootProfile()
+    :m_Depth( 0 ),
+    m_EndMicros( 0 ),
+    m_Profiling( false ),
+    m_Session( 0 ),
+    m_StartMicros( 0 ),
+    m_pWorker( 0 )
+{
+}
+
+
+
+//  public methods
+
+//  finish()
+//
+//  Stops profiling.  Entries still open (because the boot failed or was stopped) are closed as of now,
+//  but remain marked as not ended.
+void
+BootProfile::finish()
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    if ( !m_Profiling )
+        return;
+
+    m_EndMicros = LatencyHistogram::getMicroseconds();
+    for ( ENTRIES::iterator ite = m_Entries.begin(); ite != m_Entries.end(); ++ite )
+    {
+        if ( !ite->m_Ended )
+            ite->m_DurationMicros = m_EndMicros - m_StartMicros - ite->m_StartMicros;
+    }
+
+    m_Profiling = false;
+}
+
+
+//  getEntries()
+BootProfile::ENTRIES
+BootProfile::getEntries() const
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    return m_Entries;
+}
+
+
+//  getJson()
+//
+//  Produces the timeline as a JSON object.  The traceEvents member is in Chrome trace format,
+//  so that the same file can be loaded into chrome://tracing or ui.perfetto.dev.
+std::string
+BootProfile::getJson() const
+{
+    ENTRIES entries = getEntries();
+    COUNT64 totalMicros = getTotalMicros();
+
+    m_Mutex.lock();
+    COUNT session = m_Session;
+    std::string startTimeStamp = m_StartTimeStamp;
+    m_Mutex.unlock();
+
+    std::stringstream strm;
+    strm << "{" << std::endl;
+    strm << "  \"version\": " << getJsonString( VERSION ) << "," << std::endl;
+    strm << "  \"session\": " << session << "," << std::endl;
+    strm << "  \"startTime\": " << getJsonString( startTimeStamp ) << "," << std::endl;
+    strm << "  \"totalMicros\": " << totalMicros << "," << std::endl;
+
+    strm << "  \"phases\": [";
+    for ( CITENTRIES ite = entries.begin(); ite != entries.end(); ++ite )
+    {
+        strm << (ite == entries.begin() ? "" : ",") << std::endl;
+        strm << "    { \"name\": " << getJsonString( ite->m_Name )
+            << ", \"depth\": " << ite->m_Depth
+            << ", \"startMicros\": " << ite->m_StartMicros
+            << ", \"durationMicros\": " << ite->m_DurationMicros
+            << ", \"ended\": " << (ite->m_Ended ? "true" : "false") << " }";
+    }
+    strm << std::endl << "  ]," << std::endl;
+
+    strm << "  \"traceEvents\": [";
+    for ( CITENTRIES ite = entries.begin(); ite != entries.end(); ++ite )
+    {
+        strm << (ite == entries.begin() ? "" : ",") << std::endl;
+        strm << "    { \"name\": " << getJsonString( ite->m_Name )
+            << ", \"cat\": \"boot\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1"
+            << ", \"ts\": " << ite->m_StartMicros
+            << ", \"dur\": " << ite->m_DurationMicros << " }";
+    }
+    strm << std::endl << "  ]" << std::endl;
+    strm << "}" << std::endl;
+    return strm.str();
+}
+
+
+//  getTotalMicros()
+//
+//  Time from start() to finish() - or to now, if we have not finished
+COUNT64
+BootProfile::getTotalMicros() const
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    if ( m_StartMicros == 0 )
+        return 0;
+    return (m_Profiling ? LatencyHistogram::getMicroseconds() : m_EndMicros) - m_StartMicros;
+}
+
+
+//  isProfiling()
+//
+//  For callers which must do some work to name a span - true if a span begun now, by this Worker,
+//  would be recorded.
+bool
+BootProfile::isProfiling() const
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    return m_Profiling && (Worker::getCurrentWorker() == m_pWorker);
+}
+
+
+//  start()
+//
+//  Discards the previous boot's timeline, and starts recording a new one - for spans begun by the calling Worker
+void
+BootProfile::start
+(
+    const COUNT             session
+)
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    m_Depth = 0;
+    m_EndMicros = 0;
+    m_Entries.clear();
+    m_Profiling = true;
+    m_Session = session;
+    m_StartMicros = LatencyHistogram::getMicroseconds();
+    m_pWorker = Worker::getCurrentWorker();
+
+    SystemTime* pLocalTime = SystemTime::createLocalSystemTime();
+    m_StartTimeStamp = pLocalTime->getTimeStamp();
+    delete pLocalTime;
+}
+
+
+//  writeJson()
+//
+//  Writes getJson() to the given file
+bool
+BootProfile::writeJson
+(
+    const std::string&      fileName
+) const
+{
+    std::ofstream stream( fileName, std::ios::out | std::ios::trunc );
+    if ( !stream.good() )
+    {
+        SystemLog::write( "BootProfile cannot open " + fileName );
+        return false;
+    }
+
+    stream << getJson();
+    bool result = stream.good();
+    stream.close();
+    if ( !result )
+        SystemLog::write( "BootProfile failed writing " + fileName );
+    return result;
+}
+
@@ -0,0 +1,101 @@
+//  BootProfile.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Boot-phase timeline, for tracking boot time from one release to the next.
+//  BootActivity opens a Span for each boot phase, and MFDManager opens nested Spans for its significant steps
+//  (label reads, fixed pack initialization with its directory cache loads, allocation table loads, and so on).
+//  Spans are recorded only between start() and finish(), and only by the Worker which called start() - the
+//  boot runs as a sequence of pool steps, so that is not necessarily the same thread from one span to the next.
+//  So the same MFDManager code run after boot (for an UP keyin, say), or by another activity while the boot
+//  is in progress (an FS keyin, or MFDScanActivity), records nothing.
+//
+//  Times are host time from a steady clock, not exec time - we are measuring the emulator, not the exec.
+//  Phases which wait for the operator are named with a trailing WAIT, so that they can be discounted.
+
+
+
+#ifndef     EXECLIB_BOOT_PROFILE_H
+#define     EXECLIB_BOOT_PROFILE_H
+
+
+
+class   BootProfile
+{
+public:
+    class   Entry
+    {
+    public:
+        COUNT                   m_Depth;                //  zero for boot phases, one for their steps, and so on
+        COUNT64                 m_DurationMicros;
+        bool                    m_Ended;                //  false if the boot ended while this was still open
+        std::string             m_Name;
+        COUNT64                 m_StartMicros;          //  from the start of the boot
+
+        Entry( const COUNT          depth,
+               const std::string&   name,
+               const COUNT64        startMicros )
+            :m_Depth( depth ),
+            m_DurationMicros( 0 ),
+            m_Ended( false ),
+            m_Name( name ),
+            m_StartMicros( startMicros )
+        {}
+    };
+
+    typedef     std::vector<Entry>                  ENTRIES;
+    typedef     ENTRIES::const_iterator             CITENTRIES;
+
+    //  Begins an entry on construction and ends it on destruction.  Does nothing if we are not profiling.
+    class   Span
+    {
+    private:
+        BootProfile* const      m_pProfile;
+        const INDEX             m_Index;
+
+    public:
+        Span( BootProfile* const    pProfile,
+              const std::string&    name )
+            :m_pProfile( pProfile ),
+            m_Index( pProfile->begin( name ) )
+        {}
+
+        ~Span()
+        {
+            m_pProfile->end( m_Index );
+        }
+    };
+
+private:
+    COUNT                       m_Depth;                //  of the next entry to begin
+    COUNT64                     m_EndMicros;            //  steady clock - zero until finish()
+    ENTRIES                     m_Entries;
+    mutable std::mutex          m_Mutex;
+    bool                        m_Profiling;
+    COUNT                       m_Session;
+    COUNT64                     m_StartMicros;          //  steady clock
+    std::string                 m_StartTimeStamp;       //  local time, for the report
+    const Worker*               m_pWorker;              //  the booting Worker - the only one we record
+
+    INDEX                       begin( const std::string& name );
+    void                        end( const INDEX index );
+
+    static std::string          getJsonString( const std::string& value );
+
+public:
+    BootProfile();
+
+    void                        finish();
+    ENTRIES                     getEntries() const;
+    std::string                 getJson() const;
+    COUNT64                     getTotalMicros() const;
+    bool                        isProfiling() const;
+    void                        start( const COUNT session );
+    bool                        writeJson( const std::string& fileName ) const;
+
+    static const INDEX          NO_ENTRY = static_cast<INDEX>( -1 );
+};
+
+
+
+#endif
+
@@ -128,11 +128,11 @@ CSInterpreter::executeDirCatalog
 {
     std::stringstream strm;
     pUserRunInfo->postToPrint( "Cataloged Files:" );
-    MFDManager::FileSetInfoList list;
-    m_pMfdMgr->getFileSetInfoList( &list );
-    for ( MFDManager::FileSetInfoList::const_iterator it = list.begin(); it != list.end(); ++it )
+    MFDManager::CatalogQueryList list;
+    m_pMfdMgr->getCatalogInfo( SuperString(), false, &list );
+    for ( MFDManager::CatalogQueryList::const_iterator it = list.begin(); it != list.end(); ++it )
     {
-        MFDManager::FileSetInfo* pfsInfo = *it;
+        const MFDManager::FileSetInfo* pfsInfo = &(*it)->m_FileSetInfo;
         strm.str( "" );
         strm << "  " << pfsInfo->m_Qualifier << "*" << pfsInfo->m_Filename << " [";
 
@@ -1,7 +1,9 @@
 //  CoarseSchedulerActivity
 //  Copyright (c) 2015 by Kurt Duncan
 //
-//  Regularly polls all batch and Demand RunInfo objects, to see if any Control Mode processing needs done.
+//  Polls all batch and Demand RunInfo objects, to see if any Control Mode processing needs done.
+//  The Exec signals us when a run changes state or loses an activity, and input producers do so when they
+//  fill a READ$ buffer; in between, we look only occasionally.
 //  This activity runs under the Exec RunInfo context.
 //  It must be started in the boot process before any user runs are opened (i.e., SYS)
 //  It can be started probably as early as BootActivity, although it doesn't need to be...
@@ -201,6 +203,70 @@ CoarseSchedulerActivity::echoStatementStack
 }
 
 
+//  handlePoll()
+//
+//  We go through this over and over, until the world ends - immediately again if we did something useful,
+//  otherwise whenever we are signaled (or after m_IdleRecheckMSec).  Either way, we hold no thread in between.
+void
+CoarseSchedulerActivity::handlePoll
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    CoarseSchedulerActivity* pActivity = dynamic_cast<CoarseSchedulerActivity*>( pObject );
+    bool busy = false;
+
+    //  Odd loop, due to the fact that we need to iterate over a container which may
+    //  change its content during our noodling around.  The idea is that we're going
+    //  to process all of the RunInfo objects which the Exec knows about... as best we can.
+    LSTRING runids;
+    pActivity->m_pExec->getRunids( &runids );
+    for ( LITSTRING its = runids.begin(); its != runids.end(); ++its )
+    {
+        //  Retrieve the indicated RunInfo, if we can.
+        //  If we cannot, then something has updated the Exec's list of RunInfos,
+        //  and we should just move on to the next thing.
+        RunInfo* pRunInfo = pActivity->m_pExec->getRunInfo( *its, false );
+        if ( pRunInfo )
+        {
+            ControlModeRunInfo* pCMRunInfo = dynamic_cast<ControlModeRunInfo*>( pRunInfo );
+            if ( pCMRunInfo )
+            {
+                //  Only do batch and demand RunInfo objects which are active AND in control mode
+                RunInfo::State runState = pRunInfo->getState();
+                if ( ((pRunInfo->isBatch()) || (pRunInfo->isDemand()))
+                    && ( runState == RunInfo::STATE_ACTIVE )
+                    && pRunInfo->inControlMode() )
+                {
+                    //  Process the RunInfo object.  If we get true for a result, something useful
+                    //  was done, and we should forego our normal wait at the end of our poll cycle,
+                    //  since there might be something *else* we can immediately do.
+                    pCMRunInfo->attach();
+                    bool result = pActivity->processRunInfo( pCMRunInfo );
+                    pCMRunInfo->detach();
+                    if ( result )
+                        busy = true;
+                }
+            }
+        }
+    }
+
+    pActivity->awaitTimer( busy ? 0 : m_IdleRecheckMSec, POLL );
+}
+
+
+//  handleStartup()
+//
+//  Anything necessary prior to first user interaction (currently, nothing)
+void
+CoarseSchedulerActivity::handleStartup
+(
+    IntrinsicActivity* const    pObject
+)
+{
+}
+
+
 //  processCheckErrorAbort()
 //
 //  Batch runs for which the most recent task ended in ERROR or ABORT status will
@@ -366,57 +432,6 @@ CoarseSchedulerActivity::processSkip
 }
 
 
-//  worker()
-//
-//  We go through this over and over, until the world ends.
-void
-CoarseSchedulerActivity::worker()
-{
-    while ( !isWorkerTerminating() )
-    {
-        bool delayFlag = true;
-
-        //  Odd loop, due to the fact that we need to iterate over a container which may
-        //  change its content during our noodling around.  The idea is that we're going
-        //  to process all of the RunInfo objects which the Exec knows about... as best we can.
-        LSTRING runids;
-        m_pExec->getRunids( &runids );
-        for ( LITSTRING its = runids.begin(); its != runids.end(); ++its )
-        {
-            //  Retrieve the indicated RunInfo, if we can.
-            //  If we cannot, then something has updated the Exec's list of RunInfos,
-            //  and we should just move on to the next thing.
-            RunInfo* pRunInfo = m_pExec->getRunInfo( *its, false );
-            if ( pRunInfo )
-            {
-                ControlModeRunInfo* pCMRunInfo = dynamic_cast<ControlModeRunInfo*>( pRunInfo );
-                if ( pCMRunInfo )
-                {
-                    //  Only do batch and demand RunInfo objects which are active AND in control mode
-                    RunInfo::State runState = pRunInfo->getState();
-                    if ( ((pRunInfo->isBatch()) || (pRunInfo->isDemand()))
-                        && ( runState == RunInfo::STATE_ACTIVE )
-                        && pRunInfo->inControlMode() )
-                    {
-                        //  Process the RunInfo object.  If we get true for a result, something useful
-                        //  was done, and we should forego our normal wait at the end of our poll cycle,
-                        //  since there might be something *else* we can immediately do.
-                        pCMRunInfo->attach();
-                        bool result = processRunInfo( pCMRunInfo );
-                        pCMRunInfo->detach();
-                        if ( result )
-                            delayFlag = false;
-                    }
-                }
-            }
-        }
-
-        if ( delayFlag )
-            miscSleep( 100 );
-    }
-}
-
-
 
 //  constructors, destructors
 
@@ -426,6 +441,16 @@ CoarseSchedulerActivity::CoarseSchedulerActivity
 )
 :IntrinsicActivity( pExec, "CoarseSchedulerActivity", pExec->getRunInfo() )
 {
+    //  The Exec signals us whenever a run might have something for us to do
+    pExec->setCoarseSchedulerActivity( this );
+    establishStateEntry( STARTUP, handleStartup, POLL, 0 );
+    establishStateEntry( POLL, handlePoll, POLL );
+}
+
+
+CoarseSchedulerActivity::~CoarseSchedulerActivity()
+{
+    m_pExec->setCoarseSchedulerActivity( 0 );
 }
 
 
@@ -26,13 +26,15 @@ private:
         DONE                = m_TerminalState,
     };
 
+    static const COUNT32        m_IdleRecheckMSec = 1000;   //  otherwise we wait to be signaled
+
     bool                        processControlStatement( ControlModeRunInfo* const pRunInfo );
     bool                        processRunInfo( ControlModeRunInfo* const pRunInfo );
-    void                        worker();
 
     static void                 echoStatementStack( ControlModeRunInfo* const   pRunInfo,
                                                     const bool                  processorCallFlag );
     static void                 handlePoll( IntrinsicActivity* const pObject );
+    static void                 handleStartup( IntrinsicActivity* const pObject );
     static bool                 processCheckErrorAbort( ControlModeRunInfo* const pRunInfo );
     static bool                 processReadInput( ControlModeRunInfo* const pRunInfo );
     static bool                 processSkip( ControlModeRunInfo* const  pRunInfo,
@@ -41,6 +43,7 @@ private:
 
 public:
     CoarseSchedulerActivity( Exec* const pExec );
+    ~CoarseSchedulerActivity();
 
     //  IntrinsicActivity interface
     void                        dump( std::ostream&         stream,
@@ -103,6 +103,8 @@ Configuration::Configuration()
     establishValue( "MAXATMP", new IntegerValue( 3 ) );
     establishValue( "MAXGRN", new IntegerValue( 256 ) );
     establishValue( "MDFALT", new StringValue( "F" ) );
+    establishValue( "MFDSCANINTVL", new IntegerValue( 60 ) );    //  minutes between MFD consistency scan passes
+    establishValue( "MFDSCANRATE", new IntegerValue( 500 ) );    //  directory sectors per second, 0 disables scanning
     establishValue( "MSTRACC", new StringValue("") );
     establishValue( "OVRACC", new StringValue("INSTALLATION") );
     establishValue( "OVRUSR", new StringValue("INSTALLATION") );
@@ -1,7 +1,7 @@
 //	ConsoleActivity.cpp
 //  Copyright (c) 2015 by Kurt Duncan
 //
-//	Polls ConsoleManager and handles unsolicited input therefrom
+//	Polls ConsoleManager and handles unsolicited input therefrom, whenever ConsoleManager signals us
 
 
 
@@ -9,16 +9,47 @@
 
 
 
-//	private / protected methods
+//	private / protected statics
 
+//  handleDone()
+//
+//  Invoked once as we terminate
+void
+ConsoleActivity::handleDone
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    ConsoleActivity* pActivity = dynamic_cast<ConsoleActivity*>( pObject );
+    pActivity->m_pConsoleManager->setActivity( 0 );
+}
+
+
+//  handlePoll()
+//
+//  Polls the ConsoleManager - if it did anything, we come right back; otherwise we wait until ConsoleManager
+//  signals us (a request was posted, or a console has input), looking again now and then for undeliverable messages.
+void
+ConsoleActivity::handlePoll
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    ConsoleActivity* pActivity = dynamic_cast<ConsoleActivity*>( pObject );
+    if ( pActivity->m_pConsoleManager->poll() )
+        pActivity->setDelay( 0 );
+}
+
+
+//  handleStartup()
 void
-ConsoleActivity::worker()
+ConsoleActivity::handleStartup
+(
+    IntrinsicActivity* const    pObject
+)
 {
-    while ( !isWorkerTerminating() )
-    {
-        if ( !m_pConsoleManager->poll() )
-            miscSleep( 250 );
-    }
+    ConsoleActivity* pActivity = dynamic_cast<ConsoleActivity*>( pObject );
+    pActivity->m_pConsoleManager->setActivity( pActivity );
 }
 
 
@@ -32,7 +63,11 @@ ConsoleManager * const  pConsoleManager
 )
 :IntrinsicActivity( pExec, "ConsoleActivity", pExec->getRunInfo( ) ),
 m_pConsoleManager( pConsoleManager )
-{}
+{
+    establishStateEntry( STARTUP, handleStartup, POLL, 0 );
+    establishStateEntry( POLL, handlePoll, POLL, m_IdleRecheckMSec );
+    establishStateEntry( DONE, handleDone, DONE, 0 );
+}
 
 
 
@@ -18,8 +18,20 @@
 class	ConsoleActivity : public IntrinsicActivity
 {
 private:
+    enum LocalState
+    {
+        STARTUP                 = m_InitialState,   //  Register with ConsoleManager
+        POLL,
+        DONE                    = m_TerminalState,  //  Deregister from ConsoleManager
+    };
+
 	ConsoleManager* const       m_pConsoleManager;
-    void                        worker();
+
+    static const COUNT32        m_IdleRecheckMSec = 1000;   //  otherwise we wait to be signaled
+
+    static void                 handleDone( IntrinsicActivity* const pObject );
+    static void                 handlePoll( IntrinsicActivity* const pObject );
+    static void                 handleStartup( IntrinsicActivity* const pObject );
 
 public:
 	ConsoleActivity( Exec* const            pExec,
@@ -4,6 +4,8 @@
 //  Represents some entity that implements a console.
 //  ConsoleManager deals with these things...
 //  It is up to the implementation to provide instantiations of this... at least one anyway.
+//  Whenever a reply or an unsolicited message arrives, the implementation emits an InputEvent to its listeners
+//  (ConsoleManager registers itself as one), so that the input is picked up without anyone having to poll for it.
 
 
 
@@ -11,7 +13,7 @@
 #define     EXECLIB_CONSOLE_INTERFACE_H
 
 
-class ConsoleInterface
+class ConsoleInterface : public Emitter
 {
 protected:
     ConsoleInterface(){}
@@ -19,6 +21,9 @@ protected:
 public:
     typedef     INDEX           MESSAGE_ID;
 
+    class InputEvent : public Event
+    {};
+
     virtual ~ConsoleInterface(){};
 
     virtual bool                cancelReadReplyMessage( const MESSAGE_ID identifier ) = 0;
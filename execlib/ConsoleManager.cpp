@@ -221,6 +221,18 @@ ConsoleManager::postToConsoleLog
 }
 
 
+//  signalActivity()
+//
+//  Wakes ConsoleActivity (if it is running) so that it calls poll() promptly
+void
+ConsoleManager::signalActivity()
+{
+    std::lock_guard<std::mutex> guard( m_ActivityMutex );
+    if ( m_pActivity )
+        m_pActivity->signal();
+}
+
+
 
 //  constructors, destructors
 
@@ -230,6 +242,9 @@ ConsoleManager::ConsoleManager
 )
 :ExecManager( pExec )
 {
+    MISCLIB_SET_LOCK_NAME( "ConsoleManager" );
+    m_pActivity = 0;
+
     //  No main console yet
     m_pMainConsole = 0;
 
@@ -256,8 +271,10 @@ ConsoleManager::~ConsoleManager()
         m_ReadOnlyRequests.pop_back();
     }
 
-    //  We don't delete these, since we didn't create them.
+    //  We don't delete these, since we didn't create them - but the consoles outlive us, so stop listening to them.
     m_ReadReplyRequests.clear();
+    for ( ITCONSOLES itc = m_Consoles.begin(); itc != m_Consoles.end(); ++itc )
+        itc->second->unregisterListener( this );
     m_Consoles.clear();
 }
 
@@ -332,6 +349,52 @@ ConsoleManager::dump
 }
 
 
+//  cancelReadReplyMessage()
+//
+//  Withdraws a read-reply request which the owner no longer wants answered.
+//  The request is marked cancelled (if not already completed), and we forget it and its notify worker,
+//  so the owner may delete either as soon as we return.
+void
+ConsoleManager::cancelReadReplyMessage
+(
+    ReadReplyRequest* const pRequest
+)
+{
+    lock();
+
+    pRequest->setNotifyWorker( 0 );
+    for ( ITREADREPLYREQUESTS itr = m_ReadReplyRequests.begin(); itr != m_ReadReplyRequests.end(); ++itr )
+    {
+        if ( *itr == pRequest )
+        {
+            ConsoleInterface* pConsole = pRequest->getCurrentConsole();
+            if ( pConsole != 0 )
+                pConsole->cancelReadReplyMessage( pRequest->getMessageId() );
+            m_ReadReplyRequests.erase( itr );
+            break;
+        }
+    }
+
+    if ( !pRequest->isCompleted() )
+        pRequest->setCancelled();
+
+    unlock();
+}
+
+
+//  getReadOnlyCount()
+//
+//  Retrieves number of read-only messages not yet sent to all their consoles
+COUNT
+ConsoleManager::getReadOnlyCount()
+{
+    lock();
+    COUNT messages = m_ReadOnlyRequests.size();
+    unlock();
+    return messages;
+}
+
+
 //  getReadReplyCount()
 //
 //  Retrieves number of outstanding read-reply messages
@@ -345,9 +408,23 @@ ConsoleManager::getReadReplyCount()
 }
 
 
+//  listenerEventTriggered()
+//
+//  Listener interface
+//  A registered console has input for us (on the console's thread) - wake up ConsoleActivity to collect it.
+void
+ConsoleManager::listenerEventTriggered
+(
+    Event* const        pEvent
+)
+{
+    signalActivity();
+}
+
+
 //  poll()
 //
-//  Called periodically (at fairly frequent intervals, if you please) by ConsoleActivity
+//  Called by ConsoleActivity whenever we signal it (new requests, or console input), and at a leisurely pace otherwise
 //  Checks the pending request queues to see if there's anything that needs to be sent to any consoles.
 //  If there's anything to do, it does one thing, then returns true.  If there's nothing to do, it returns false.
 bool
@@ -383,6 +460,7 @@ ConsoleManager::postReadOnlyMessage
     lock();
     m_ReadOnlyRequests.push_back( new ReadOnlyRequest( pRunInfo, routing, group, message ));
     unlock();
+    signalActivity();
 
     //  Post to the Run's console log
     if ( pRunInfo )
@@ -410,11 +488,22 @@ ConsoleManager::postReadReplyMessage
     strm << "Cons RR (" << pRequest << "):" << pRequest->m_Message;
     SystemLog::write( strm.str() );
 
+    //  Waiting on a worker?  Sleep until the reply (or cancellation) signals us.
+    //  The awaitable posts the request for us, and withdraws it if the worker is told to terminate.
+    Worker* pWorker = waitForResponse ? Worker::getCurrentWorker() : 0;
+    if ( pWorker )
+    {
+        ReadReplyAwaitable awaitable( this, pRequest );
+        awaitable.wait( pWorker );
+        return;
+    }
+
     //  Post it to the pending list, and let the next poll() pick it up.
     lock();
     pRequest->setCurrentConsole( 0 );
     m_ReadReplyRequests.push_back( pRequest );
     unlock();
+    signalActivity();
 
     if ( waitForResponse )
     {
@@ -568,6 +657,7 @@ ConsoleManager::registerConsole
     m_Consoles[routing] = pConsole;
     if ( mainConsole )
         m_pMainConsole = pConsole;
+    pConsole->registerListener( this );
 
     logStrm.str( "" );
     logStrm << "ConsoleManager::Registered with routing "
@@ -600,6 +690,20 @@ ConsoleManager::registerConsole
 }
 
 
+//  setActivity()
+//
+//  ConsoleActivity registers itself here (and deregisters with 0) so that we can signal it
+void
+ConsoleManager::setActivity
+(
+    Activity* const     pActivity
+)
+{
+    std::lock_guard<std::mutex> guard( m_ActivityMutex );
+    m_pActivity = pActivity;
+}
+
+
 //  shutdown()
 //
 //  Exec is preparing to shut down
@@ -776,11 +880,13 @@ ConsoleManager::unregisterConsole
     }
 
     //  Remove the console from our list
+    pConsole->unregisterListener( this );
     m_Consoles.erase( itc );
     if ( pConsole == m_pMainConsole )
         m_pMainConsole = 0;
 
     unlock();
+    signalActivity();
     return true;
 }
 
@@ -21,7 +21,7 @@
 
 
 
-class ConsoleManager : public ExecManager
+class ConsoleManager : public ExecManager, public Listener
 {
 public:
     enum class Group
@@ -41,8 +41,11 @@ public:
         bool                            m_Completed;            //  We are done with this; owner can delete it at any time
         ConsoleInterface*               m_pCurrentConsole;      //  If a console is working on this, else null
         ConsoleInterface::MESSAGE_ID    m_MessageId;            //  Set by the ConsoleInterface when we post this
+        Worker*                         m_pNotifyWorker;        //  Signaled upon completion or cancellation, if set
         SuperString                     m_Response;
 
+        void                notify() const                                              { if ( m_pNotifyWorker ) m_pNotifyWorker->workerSignal(); }
+
     public:
         const Group                     m_Group;
         const UINT8                     m_MaxResponseLength;
@@ -65,6 +68,7 @@ public:
             m_Completed = false;
             m_pCurrentConsole = 0;
             m_MessageId = 0;
+            m_pNotifyWorker = 0;
         }
 
         ConsoleInterface*   getCurrentConsole() const                                   { return m_pCurrentConsole; }
@@ -73,10 +77,11 @@ public:
         const SuperString&  getResponse() const                                         { return m_Response; }
         bool                isCancelled() const                                         { return m_Cancelled; }
         bool                isCompleted() const                                         { return m_Completed; }
-        void                setCancelled()                                              { m_Cancelled = true; }
-        void                setCompleted( const bool flag = true )                      { m_Completed = flag; }
+        void                setCancelled()                                              { m_Cancelled = true; notify(); }
+        void                setCompleted( const bool flag = true )                      { m_Completed = flag; if ( flag ) notify(); }
         void                setCurrentConsole( ConsoleInterface* const pConsole )       { m_pCurrentConsole = pConsole; }
         void                setMessageId( const ConsoleInterface::MESSAGE_ID messageId ){ m_MessageId = messageId; }
+        void                setNotifyWorker( Worker* const pWorker )                    { m_pNotifyWorker = pWorker; }
         void                setResponse( const std::string& response )                  { m_Response = response; }
     };
 
@@ -149,6 +154,8 @@ private:
     typedef READREPLYREQUESTS::iterator                     ITREADREPLYREQUESTS;
     typedef READREPLYREQUESTS::const_iterator               CITREADREPLYREQUESTS;
 
+    Activity*               m_pActivity;            //  ConsoleActivity - signaled whenever poll() has something to do
+    std::mutex              m_ActivityMutex;        //  protects m_pActivity
     CONSOLES                m_Consoles;
     ConsoleInterface*       m_pMainConsole;
     READONLYGROUPASG        m_ReadOnlyGroupAssignments;
@@ -166,6 +173,7 @@ private:
     bool                            pollReadReply();
     void                            postToConsoleLog( RunInfo* const        pRunInfo,
                                                       const std::string&    message ) const;
+    void                            signalActivity();
 
     static inline Group             fixGroup( const Group group )
     {
@@ -184,6 +192,8 @@ public:
     ConsoleManager( Exec* const pExec );
     ~ConsoleManager();
 
+    void                            cancelReadReplyMessage( ReadReplyRequest* const pRequest );
+    COUNT                           getReadOnlyCount();
     COUNT                           getReadReplyCount();
     bool                            notifyReadReplyMessageDisplayed( const COUNT64  serialNumber,
                                                                      const BYTE     messageId ) const;
@@ -206,6 +216,7 @@ public:
 
     bool                            registerConsole( ConsoleInterface* const    pConsole,
                                                      const bool                 mainConsole );
+    void                            setActivity( Activity* const pActivity );
     bool                            unregisterConsole( ConsoleInterface* const pConsole );
 
     //  ExecManager interface
@@ -215,6 +226,9 @@ public:
     bool							startup();
     void                            terminate();
 
+    //  Listener interface
+    void                            listenerEventTriggered( Event* const pEvent );
+
     //  Convenient wrappers
     inline void                     postReadOnlyMessage( const std::string& message,
                                                          RunInfo* const     pRunInfo )
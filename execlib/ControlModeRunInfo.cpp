@@ -53,28 +53,6 @@ ControlModeRunInfo::~ControlModeRunInfo()
 
 //  public methods
 
-//  cleanActivites()
-//
-//  Called occasionally by the Exec, so we can get rid of zombies.
-//  Exec MUST attach before calling here.
-//
-//  Returns:
-//      true generally, false if there is no current task
-void
-ControlModeRunInfo::cleanActivities()
-{
-    RunInfo::cleanActivities();
-    if ( m_pControlModeActivity )
-    {
-        if ( m_pControlModeActivity->isTerminated() )
-        {
-            delete m_pControlModeActivity;
-            m_pControlModeActivity = 0;
-        }
-    }
-}
-
-
 //  dump()
 //
 //  For debugging
@@ -117,19 +95,15 @@ void
 bool
     ControlModeRunInfo::hasLiveActivity() const
 {
-    bool result = false;
-    lock();
-
+    //  The base class takes the shared lock itself, and shared locks must not be taken recursively
     if ( RunInfo::hasLiveActivity() )
-        result = true;
-    else
-    {
-        if ( m_pControlModeActivity && ( !m_pControlModeActivity->isTerminated() ) )
-            result = true;
-
-    }
+        return true;
 
-    unlock();
+    bool result = false;
+    lockShared();
+    if ( m_pControlModeActivity && ( !m_pControlModeActivity->isTerminated() ) )
+        result = true;
+    unlockShared();
     return result;
 }
 
@@ -146,3 +120,30 @@ void
         m_pControlModeActivity->stop( Activity::STOP_SHUTDOWN, false );
     unlock();
 }
+
+
+//  removeActivity()
+//
+//  Called by the Exec when an activity of ours has exited - it might be the control mode activity.
+//  Exec MUST attach before calling here.
+//
+//  Returns:
+//      the activity if we owned it, else 0
+Activity*
+ControlModeRunInfo::removeActivity
+(
+    Activity* const     pActivity,
+    const COUNT64       serialNumber
+)
+{
+    Activity* pResult = RunInfo::removeActivity( pActivity, serialNumber );
+    if ( (pResult == 0)
+        && (m_pControlModeActivity == pActivity)
+        && (pActivity->getSerialNumber() == serialNumber) )
+    {
+        pResult = m_pControlModeActivity;
+        m_pControlModeActivity = 0;
+    }
+
+    return pResult;
+}
@@ -45,9 +45,10 @@ public:
     virtual ~ControlModeRunInfo();
 
     //  UserRunInfo interface
-    virtual void                cleanActivities();
     virtual bool                hasLiveActivity() const;
     virtual void                killActivities() const;
+    virtual Activity*           removeActivity( Activity* const pActivity,
+                                                const COUNT64   serialNumber );
 
     //  getters
     inline Activity*            getControlModeActivity() const      { return m_pControlModeActivity; }
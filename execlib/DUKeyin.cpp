@@ -2,6 +2,9 @@
 //  Copyright (c) 2015 by Kurt Duncan
 //
 //	Handles the DU keyin
+//      DU MP[,{dumpBits | ALL}]    Creates an exec dump file
+//      DU MFD                      Creates a binary MFD snapshot file, for offline analysis
+//      DU LK[,count]               Displays the most contended locks (requires MISCLIB_LOCK_PROFILING)
 
 //TODO:BATCH Need to change the format to "DU MP[, {runid | dumpBits}]"
 
@@ -13,6 +16,89 @@
 
 //	private / protected methods
 
+//  handleLK()
+//
+//  Displays the top contended locks, by total time spent waiting.
+//  Full histograms and call sites are written to the Exec dump.
+void
+DUKeyin::handleLK()
+{
+#if MISCLIB_LOCK_PROFILING
+    COUNT topCount = 5;
+    if ( m_Parameters.size() > 1 )
+    {
+        displayInvalidParameter();
+        return;
+    }
+
+    if ( m_Parameters.size() == 1 )
+    {
+        if ( !m_Parameters[0].isDecimalNumeric() )
+        {
+            displayInvalidParameter();
+            return;
+        }
+        topCount = m_Parameters[0].toDecimal();
+    }
+
+    std::vector<LockProfile::Summary> summaries;
+    LockProfiler::getInstance()->getTopContended( topCount, &summaries );
+    if ( summaries.empty() )
+    {
+        m_pConsoleManager->postReadOnlyMessage( "No Contended Locks", m_Routing, m_pExec->getRunInfo() );
+        return;
+    }
+
+    for ( INDEX sx = 0; sx < summaries.size(); ++sx )
+    {
+        std::stringstream consStrm;
+        consStrm << summaries[sx].m_Name
+            << " Cont=" << summaries[sx].m_Contentions << "/" << summaries[sx].m_Acquisitions
+            << " Wait=" << summaries[sx].m_TotalWaitNSecs / 1000 << "us"
+            << " Max=" << summaries[sx].m_MaxWaitNSecs / 1000 << "us";
+        m_pConsoleManager->postReadOnlyMessage( consStrm.str(), m_Routing, m_pExec->getRunInfo() );
+    }
+#else
+    m_pConsoleManager->postReadOnlyMessage( "Lock Profiling Not Enabled", m_Routing, m_pExec->getRunInfo() );
+#endif
+}
+
+
+//  handleMFD()
+//
+//  Writes a binary snapshot of the MFD directory to a file.
+//  The MFD manager lock is held only while the directory is copied, not while the file is written.
+void
+DUKeyin::handleMFD()
+{
+    if ( m_Parameters.size() > 0 )
+    {
+        displayInvalidParameter();
+        return;
+    }
+
+    MFDManager* pmfdmgr = dynamic_cast<MFDManager*>( m_pExec->getManager( Exec::MID_MFD_MANAGER ) );
+    MFDSnapshot snapshot;
+    pmfdmgr->takeDirectorySnapshot( &snapshot );
+
+    SystemTime* pLocalTime = SystemTime::createLocalSystemTime();
+    std::string fileName = "MFDSnapshot." + pLocalTime->getTimeStamp() + ".bin";
+    delete pLocalTime;
+    pLocalTime = 0;
+
+    std::ofstream stream( fileName.c_str(), std::ios::out | std::ios::binary );
+    bool written = stream.is_open() && snapshot.write( stream );
+    stream.close();
+
+    std::stringstream consStrm;
+    if ( written )
+        consStrm << "MFD Snapshot Created - " << snapshot.getSectorCount() << " Sectors - File Name:" << fileName;
+    else
+        consStrm << "MFD Snapshot Failed - File Name:" << fileName;
+    m_pConsoleManager->postReadOnlyMessage( consStrm.str(), m_Routing, m_pExec->getRunInfo() );
+}
+
+
 //	isAllowed()
 //
 //	Returns true if this keyin is allowed (always allowed)
@@ -29,9 +115,21 @@ DUKeyin::isAllowed() const
 void
 DUKeyin::handler()
 {
+    if ( m_Option.compareNoCase( "LK" ) == 0 )
+    {
+        handleLK();
+        return;
+    }
+
+    if ( m_Option.compareNoCase( "MFD" ) == 0 )
+    {
+        handleMFD();
+        return;
+    }
+
 	if ( m_Option.compareNoCase( "MP" ) != 0 )
     {
-        m_pConsoleManager->postReadOnlyMessage( "MP Option required for DU Keyin", m_Routing, m_pExec->getRunInfo() );
+        m_pConsoleManager->postReadOnlyMessage( "MP, MFD, or LK Option required for DU Keyin", m_Routing, m_pExec->getRunInfo() );
         return;
     }
 
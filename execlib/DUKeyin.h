@@ -17,6 +17,9 @@
 class   DUKeyin : public KeyinActivity
 {
 private:
+    void                        handleLK();
+    void                        handleMFD();
+
     // KeyinThread interface
     void                        handler();
     bool                        isAllowed() const;
@@ -36,6 +36,7 @@ DemandRunInfo::DemandRunInfo
                      options,
                      schedulingPriority,
                      processorDispatchingPriority ),
+m_InputAllowed( false ),
 m_RSISessionNumber( rsiSessionNumber )
 {
     //  Create RSI symbiont buffers for READ$ and PRINT$
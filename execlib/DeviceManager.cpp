@@ -43,7 +43,7 @@ DeviceManager::setNodeDown
             NodeEntry* pEntry = m_NodeEntries[*itNode];
             if ( (pEntry->m_Status == NDST_DN) || !pEntry->m_Accessible )
             {
-                SystemLog::write("DeviceManager::setNodeDown():Assigned disk becoming inaccessible");
+                SYSTEM_LOG( IO, ERROR, "DeviceManager::setNodeDown():Assigned disk becoming inaccessible" );
                 m_pExec->stopExec( Exec::SC_RESPONSE_REQUIRES_REBOOT );
                 break;
             }
@@ -86,7 +86,7 @@ DeviceManager::setNodeSuspended
         MFDManager* const pMFDManager = dynamic_cast<MFDManager*>(m_pExec->getManager( Exec::MID_MFD_MANAGER ));
         if ( pMFDManager == 0 )
         {
-            SystemLog::write( "DeviceManager::setNodeSuspended() Cannot find MFDManager" );
+            SYSTEM_LOG( IO, ERROR, "DeviceManager::setNodeSuspended() Cannot find MFDManager" );
             m_pExec->stopExec( Exec::SC_INTERNAL_ERROR );
             return;
         }
@@ -121,6 +121,7 @@ DeviceManager::DeviceManager
 )
 :ExecManager( pExec )
 {
+    MISCLIB_SET_LOCK_NAME( "DeviceManager" );
     m_NextNodeId = 1;
 }
 
@@ -245,9 +246,9 @@ DeviceManager::dump
 COUNT
 DeviceManager::getChannelModuleCount() const
 {
-    lock();
+    lockShared();
     COUNT count = getCount( Node::Category::CHANNEL_MODULE );
-    unlock();
+    unlockShared();
     return count;
 }
 
@@ -259,9 +260,9 @@ DeviceManager::getChannelModuleEntry
     const CHANNEL_MODULE_ID     channelModuleIdentifier
 ) const
 {
-    lock();
+    lockShared();
     const ChannelModuleEntry* pEntry = dynamic_cast<const ChannelModuleEntry*>( getEntry( channelModuleIdentifier ) );
-    unlock();
+    unlockShared();
     return pEntry;
 }
 
@@ -274,7 +275,7 @@ DeviceManager::getChannelModuleIdentifiers
 ) const
 {
     pContainer->clear();
-    lock();
+    lockShared();
 
     for ( CITNODEENTRIES itne = m_NodeEntries.begin(); itne != m_NodeEntries.end(); ++itne )
     {
@@ -282,7 +283,7 @@ DeviceManager::getChannelModuleIdentifiers
             pContainer->push_back( itne->first );
     }
 
-    unlock();
+    unlockShared();
 }
 
 
@@ -290,9 +291,9 @@ DeviceManager::getChannelModuleIdentifiers
 COUNT
 DeviceManager::getControllerCount() const
 {
-    lock();
+    lockShared();
     COUNT count = getCount( Node::Category::CONTROLLER );
-    unlock();
+    unlockShared();
     return count;
 }
 
@@ -304,9 +305,9 @@ DeviceManager::getControllerEntry
     const CONTROLLER_ID         controllerIdentifier
 ) const
 {
-    lock();
+    lockShared();
     const ControllerEntry* pEntry = dynamic_cast<const ControllerEntry*>( getEntry( controllerIdentifier ) );
-    unlock();
+    unlockShared();
     return pEntry;
 }
 
@@ -319,7 +320,7 @@ DeviceManager::getControllerIdentifiers
 ) const
 {
     pContainer->clear();
-    lock();
+    lockShared();
 
     for ( CITNODEENTRIES itne = m_NodeEntries.begin(); itne != m_NodeEntries.end(); ++itne )
     {
@@ -327,7 +328,7 @@ DeviceManager::getControllerIdentifiers
             pContainer->push_back( itne->first );
     }
 
-    unlock();
+    unlockShared();
 }
 
 
@@ -335,9 +336,9 @@ DeviceManager::getControllerIdentifiers
 COUNT
 DeviceManager::getDeviceCount() const
 {
-    lock();
+    lockShared();
     COUNT count = getCount( Node::Category::DEVICE );
-    unlock();
+    unlockShared();
     return count;
 }
 
@@ -349,9 +350,9 @@ DeviceManager::getDeviceEntry
     const DEVICE_ID         deviceIdentifier
 ) const
 {
-    lock();
+    lockShared();
     const DeviceEntry* pEntry = dynamic_cast<const DeviceEntry*>( getEntry( deviceIdentifier ) );
-    unlock();
+    unlockShared();
     return pEntry;
 }
 
@@ -363,9 +364,9 @@ DeviceManager::getDeviceEntry
     const std::string&      nodeName
 ) const
 {
-    lock();
+    lockShared();
     const DeviceEntry* pEntry = dynamic_cast<const DeviceEntry*>( getEntry( nodeName ) );
-    unlock();
+    unlockShared();
     return pEntry;
 }
 
@@ -378,7 +379,7 @@ DeviceManager::getDeviceIdentifiers
 ) const
 {
     pContainer->clear();
-    lock();
+    lockShared();
 
     for ( CITNODEENTRIES itne = m_NodeEntries.begin(); itne != m_NodeEntries.end(); ++itne )
     {
@@ -386,7 +387,7 @@ DeviceManager::getDeviceIdentifiers
             pContainer->push_back( itne->first );
     }
 
-    unlock();
+    unlockShared();
 }
 
 
@@ -398,7 +399,7 @@ DeviceManager::getDeviceIdentifiers
 ) const
 {
     pContainer->clear();
-    lock();
+    lockShared();
 
     for ( CITNODEENTRIES itne = m_NodeEntries.begin(); itne != m_NodeEntries.end(); ++itne )
     {
@@ -412,7 +413,7 @@ DeviceManager::getDeviceIdentifiers
         }
     }
 
-    unlock();
+    unlockShared();
 }
 
 
@@ -420,9 +421,9 @@ DeviceManager::getDeviceIdentifiers
 COUNT
 DeviceManager::getProcessorCount() const
 {
-    lock();
+    lockShared();
     COUNT count = getCount( Node::Category::PROCESSOR );
-    unlock();
+    unlockShared();
     return count;
 }
 
@@ -434,9 +435,9 @@ DeviceManager::getProcessorEntry
     const PROCESSOR_ID          ioProcessorIdentifier
 ) const
 {
-    lock();
+    lockShared();
     const ProcessorEntry* pEntry = dynamic_cast<const ProcessorEntry*>( getEntry( ioProcessorIdentifier ) );
-    unlock();
+    unlockShared();
     return pEntry;
 }
 
@@ -449,7 +450,7 @@ DeviceManager::getProcessorIdentifiers
 ) const
 {
     pContainer->clear();
-    lock();
+    lockShared();
 
     for ( CITNODEENTRIES itne = m_NodeEntries.begin(); itne != m_NodeEntries.end(); ++itne )
     {
@@ -457,7 +458,7 @@ DeviceManager::getProcessorIdentifiers
             pContainer->push_back( itne->first );
     }
 
-    unlock();
+    unlockShared();
 }
 
 
@@ -488,9 +489,9 @@ DeviceManager::getNodeEntry
     const NODE_ID       nodeId
 ) const
 {
-    lock();
+    lockShared();
     const NodeEntry* pne = getEntry( nodeId );
-    unlock();
+    unlockShared();
     return pne;
 }
 
@@ -504,9 +505,9 @@ DeviceManager::getNodeEntry
     const std::string&      nodeName
 ) const
 {
-    lock();
+    lockShared();
     const NodeEntry* pne = getEntry( nodeName );
-    unlock();
+    unlockShared();
     return pne;
 }
 
@@ -522,7 +523,7 @@ DeviceManager::getNodeIdentifier
 {
     NODE_ID nodeId = 0;
 
-    lock();
+    lockShared();
     for ( CITNODEENTRIES itne = m_NodeEntries.begin(); itne != m_NodeEntries.end(); ++itne )
     {
         if ( itne->second->m_pNode == pNode )
@@ -532,7 +533,7 @@ DeviceManager::getNodeIdentifier
         }
     }
 
-    unlock();
+    unlockShared();
     return nodeId;
 }
 
@@ -547,9 +548,9 @@ DeviceManager::getNodeName
     const NODE_ID nodeId
 ) const
 {
-    lock();
+    lockShared();
     const std::string& ref = getEntry( nodeId )->m_pNode->getName();
-    unlock();
+    unlockShared();
 
     return ref;
 }
@@ -564,12 +565,12 @@ DeviceManager::getNodeStatusAndAvailabilityString
     const NODE_ID   nodeId
 ) const
 {
-    lock();
+    lockShared();
     const NodeEntry* pne = getEntry( nodeId );
     std::string result = getNodeStatusString( pne->m_Status );
     if ( !pne->m_Accessible )
         result += " NA";
-    unlock();
+    unlockShared();
     return result;
 }
 
@@ -585,17 +586,13 @@ DeviceManager::setNodeDownInternally
     const NODE_ID       nodeId
 )
 {
-    std::stringstream logStrm;
-    logStrm << "DeviceManager setNodeDownInternally node=" << nodeId;
-    SystemLog::write( logStrm.str() );
+    SYSTEM_LOG( IO, WARNING, "DeviceManager setNodeDownInternally node=" << nodeId );
 
     NodeEntry* pEntry = getEntry( nodeId );
     if ( pEntry == 0 )
     {
         //  This is bad - stop the EXEC
-        std::stringstream logStrm;
-        logStrm << "Fatal:setNodeDownInternally() called with bad nodeId = " << nodeId;
-        SystemLog::getInstance()->write( logStrm.str() );
+        SYSTEM_LOG( IO, ERROR, "Fatal:setNodeDownInternally() called with bad nodeId = " << nodeId );
         m_pExec->stopExec( Exec::SC_INTERNAL_ERROR );
         return;
     }
@@ -644,7 +641,7 @@ DeviceManager::setNodeStatus
     NodeEntry* pNodeEntry = getEntry( nodeId );
     if ( pNodeEntry == 0 )
     {
-        SystemLog::write( "DeviceManager::setNodeStatus() called with bad nodeId" );
+        SYSTEM_LOG( IO, ERROR, "DeviceManager::setNodeStatus() called with bad nodeId" );
         m_pExec->stopExec( Exec::SC_FACILITIES_INVENTORY );
         unlock();
         return;
@@ -683,7 +680,7 @@ DeviceManager::setNodeStatus
 void
 DeviceManager::shutdown()
 {
-    SystemLog::write( "DeviceManager::shutdown()" );
+    SYSTEM_LOG( IO, INFO, "DeviceManager::shutdown()" );
 }
 
 
@@ -693,7 +690,7 @@ DeviceManager::shutdown()
 bool
 DeviceManager::startup()
 {
-    SystemLog::write( "DeviceManager::startup()" );
+    SYSTEM_LOG( IO, INFO, "DeviceManager::startup()" );
 
     //  Load nodes (only on the first boot)
     const std::set<Node*>& nodeSet = m_pExec->getNodeTable().getNodeSet();
@@ -784,7 +781,7 @@ DeviceManager::startup()
 void
 DeviceManager::terminate()
 {
-    SystemLog::write( "DeviceManager::terminate()" );
+    SYSTEM_LOG( IO, INFO, "DeviceManager::terminate()" );
 }
 
 
@@ -174,6 +174,42 @@ DiskAllocationTable::getAllocatedTrackCount() const
 }
 
 
+//  getAllocatedTrackCount()
+//
+//  Returns number of tracks within the given area which are allocated.
+//  Tracks beyond the end of the table are not counted.
+TRACK_COUNT
+DiskAllocationTable::getAllocatedTrackCount
+(
+    const TRACK_ID      trackId,
+    const TRACK_COUNT   trackCount
+) const
+{
+    TRACK_COUNT count = 0;
+    TRACK_ID limitTrackId = trackId + trackCount;
+
+    CITREGION itr = m_Regions.upper_bound( trackId );
+    if ( itr != m_Regions.begin() )
+        --itr;
+
+    while ( (itr != m_Regions.end()) && (itr->first < limitTrackId) )
+    {
+        if ( itr->second->m_Allocated )
+        {
+            TRACK_ID first = (itr->first > trackId) ? itr->first : trackId;
+            TRACK_ID limit = itr->first + itr->second->m_TrackCount;
+            if ( limit > limitTrackId )
+                limit = limitTrackId;
+            if ( limit > first )
+                count += limit - first;
+        }
+        ++itr;
+    }
+
+    return count;
+}
+
+
 //  initialize()
 //
 //  Reinitializes the object to a specific number of unallocated tracks.
@@ -51,6 +51,8 @@ public:
     bool                    findLargestUnallocatedRegion( TRACK_ID* const       pTrackId,
                                                           TRACK_COUNT* const    pTrackCount ) const;
     TRACK_COUNT             getAllocatedTrackCount() const;
+    TRACK_COUNT             getAllocatedTrackCount( const TRACK_ID      trackId,
+                                                    const TRACK_COUNT   trackCount ) const;
     void                    initialize( const TRACK_COUNT diskTrackCount );
     bool                    modifyArea( const TRACK_ID      trackId,
                                         const TRACK_COUNT   trackCount,
@@ -65,6 +65,31 @@ Exec::abortRun
 }
 
 
+//  applyRunStateEvents()
+//
+//  Moves RunInfo objects between the registry's state lists according to the state change events posted so far.
+//  Events for objects which are not (or are no longer) registered are ignored.
+//  Caller must hold our lock.
+//
+//  Returns:
+//      true if any events were consumed
+bool
+Exec::applyRunStateEvents()
+{
+    RUNSTATEEVENTS events;
+    m_RunStateEventMutex.lock();
+    events.swap( m_RunStateEvents );
+    m_RunStateEventMutex.unlock();
+
+    for ( ITRUNSTATEEVENTS itev = events.begin(); itev != events.end(); ++itev )
+    {
+        m_RunRegistry.move( itev->m_pRunInfo, itev->m_PreviousState, itev->m_NewState );
+    }
+
+    return !events.empty();
+}
+
+
 //  assignDIAGToRun()
 //
 //  Assigns a temporary DIAG$ file to the given run; handles failures appropriately
@@ -159,6 +184,59 @@ Exec::assignTPF$ToRun
 }
 
 
+//  clearRunInfoTable()
+//
+//  Deletes all RunInfo objects, along with any unprocessed state change events and activity exits
+void
+Exec::clearRunInfoTable()
+{
+    lock();
+    m_pLoadGeneratorActivity = 0;
+    m_pRunInfo = 0;
+    m_RunRegistry.clear();
+
+    m_RunStateEventMutex.lock();
+    m_RunStateEvents.clear();
+    m_ActivityExits.clear();
+    m_RunStateEventMutex.unlock();
+    unlock();
+}
+
+
+//  eraseRunInfo()
+//
+//  Removes a RunInfo object from the registry, discards any state change events and activity exits
+//  still queued for it, and deletes it.  Caller must hold our lock, and must have applied pending events.
+void
+Exec::eraseRunInfo
+(
+    RunInfo* const      pRunInfo
+)
+{
+    m_RunStateEventMutex.lock();
+    ITRUNSTATEEVENTS itev = m_RunStateEvents.begin();
+    while ( itev != m_RunStateEvents.end() )
+    {
+        if ( itev->m_pRunInfo == pRunInfo )
+            itev = m_RunStateEvents.erase( itev );
+        else
+            ++itev;
+    }
+
+    ITACTIVITYEXITS itax = m_ActivityExits.begin();
+    while ( itax != m_ActivityExits.end() )
+    {
+        if ( itax->m_pRunInfo == pRunInfo )
+            itax = m_ActivityExits.erase( itax );
+        else
+            ++itax;
+    }
+    m_RunStateEventMutex.unlock();
+
+    m_RunRegistry.erase( pRunInfo );
+}
+
+
 //  generateUniqueRunId()
 //
 //  Establishes the actual runid based on the given original runid.
@@ -183,9 +261,9 @@ Exec::generateUniqueRunId
 
     //  There is an outside chance that the algorithm below could run without stopping...
     //  if all possible runid's already exist.
-    if ( ( m_RunInfoTable.find( uniqueRunId ) != m_RunInfoTable.end() ) && ( uniqueRunId.size() < 6 ) )
+    if ( m_RunRegistry.find( uniqueRunId ) && ( uniqueRunId.size() < 6 ) )
         uniqueRunId += 'A';
-    while ( m_RunInfoTable.find( uniqueRunId ) != m_RunInfoTable.end() )
+    while ( m_RunRegistry.find( uniqueRunId ) )
     {
         // Can we increment the last character of the run id?
         INDEX lastx = uniqueRunId.size() - 1;
@@ -243,6 +321,166 @@ Exec::generateUniqueRunId
 }
 
 
+//  insertRunInfo()
+//
+//  Adds a newly-created RunInfo object to the registry
+void
+Exec::insertRunInfo
+(
+    RunInfo* const      pRunInfo
+)
+{
+    lock();
+    m_RunRegistry.insert( pRunInfo );
+    unlock();
+}
+
+
+//  openDemandRun()
+//
+//  Creates and registers a DemandRunInfo, once the caller has settled who the user is.
+//  See createDemandRun() for the parameters.
+//
+//  Returns:
+//      pointer to newly-created DemandRunInfo object if successful, else zero (the run-id could not be made unique)
+DemandRunInfo*
+Exec::openDemandRun
+(
+    Activity* const                     pActivity,
+    const SecurityManager::UserProfile& userProfile,
+    const COUNT                         rsiSessionNumber,
+    const std::string&                  rsiSessionName,
+    const std::string&                  runId,
+    const std::string&                  accountId,
+    const std::string&                  userId,
+    const std::string&                  projectId,
+    const UINT32                        options,
+    const char                          schedulingPriority,
+    const char                          processorDispatchingPriority
+)
+{
+    ConsoleManager* pconsmgr = dynamic_cast<ConsoleManager*>( m_Managers[MID_CONSOLE_MANAGER] );
+
+    //  Deal with project-id
+    std::string effectiveProjectId = projectId;
+    if ( effectiveProjectId.size() == 0 )
+        effectiveProjectId = "Q$Q$Q$";
+
+    //  Deal with run-id
+    std::string originalRunId = runId;
+    if ( originalRunId.size() == 0 )
+        originalRunId = "RUN000";
+
+    std::string actualRunId;
+    if ( !generateUniqueRunId( runId, &actualRunId ) )
+    {
+        std::string consMsg = "UNABLE TO GENERATE UNIQUE RUNID FOR " + originalRunId;
+        pconsmgr->postReadOnlyMessage( consMsg, m_pRunInfo );
+        return 0;
+    }
+
+    //  Priority values
+    char schedPri = schedulingPriority;
+    if ( schedPri == ' ' )
+        schedPri = 'A';
+
+    char procPri = processorDispatchingPriority;
+    if ( procPri == ' ' )
+        procPri = 'A';
+
+    //  Ready to create and register the DemandRunInfo object
+    DemandRunInfo* pDRInfo = new DemandRunInfo( this,
+                                                originalRunId,
+                                                actualRunId,
+                                                accountId,
+                                                projectId,
+                                                userId,
+                                                options,
+                                                schedPri,
+                                                procPri,
+                                                rsiSessionNumber );
+    pDRInfo->setSecurityContext( new SecurityContext( userProfile ) );
+    insertRunInfo( pDRInfo );
+
+    //  Notify console
+    std::string consMsg = actualRunId + "/" + rsiSessionName + " START";
+    if ( m_pConfiguration->getBoolValue( "SFTIMESTAMP" ) )
+        consMsg += " " + getTimeStamp();
+    pconsmgr->postReadOnlyMessage( consMsg, pDRInfo );
+
+    //  Assign TPF$ and DIAG$ - If either of these fails, the run is error'd and terminated.
+    if ( !assignTPF$ToRun( pActivity, pDRInfo ) )
+        return pDRInfo;
+    if ( !assignDIAG$ToRun( pActivity, pDRInfo ) )
+        return pDRInfo;
+
+    return pDRInfo;
+}
+
+
+//  reapActivities()
+//
+//  Deletes the activities which have posted their exit since we last looked, if their RunInfo still owns them.
+//  Deleting an activity joins its thread, so its resources are released here rather than at some later poll.
+//  Once a run's activity is gone, whoever schedules that run's next piece of work is signaled.
+//  Caller must hold our lock - this keeps the RunInfo objects from going away underneath us.
+//
+//  Returns:
+//      true if any exits were consumed
+bool
+Exec::reapActivities()
+{
+    ACTIVITYEXITS exits;
+    m_RunStateEventMutex.lock();
+    exits.swap( m_ActivityExits );
+    m_RunStateEventMutex.unlock();
+
+    for ( ITACTIVITYEXITS itax = exits.begin(); itax != exits.end(); ++itax )
+    {
+        //  The most recent load generator is kept for LG STATUS - setLoadGeneratorActivity() reposts it when replaced
+        if ( itax->m_pActivity == m_pLoadGeneratorActivity )
+            continue;
+
+        itax->m_pRunInfo->attach();
+        Activity* pActivity = itax->m_pRunInfo->removeActivity( itax->m_pActivity, itax->m_SerialNumber );
+        itax->m_pRunInfo->detach();
+
+        if ( pActivity )
+        {
+            pActivity->workerJoin();
+            delete pActivity;
+
+            std::lock_guard<std::mutex> guard( m_RunStateEventMutex );
+            signalSchedulers( itax->m_pRunInfo );
+        }
+    }
+
+    return !exits.empty();
+}
+
+
+//  signalSchedulers()
+//
+//  Wakes the activities which schedule work for a user run, after it changes state or loses an activity:
+//  CoarseSchedulerActivity for batch and demand runs (it may now read the next control statement),
+//  and RSIActivity for demand runs (the session may be waiting on the run).
+//  Caller must hold m_RunStateEventMutex.
+void
+Exec::signalSchedulers
+(
+    const RunInfo* const    pRunInfo
+)
+{
+    if ( !pRunInfo->isBatch() && !pRunInfo->isDemand() )
+        return;
+
+    if ( m_pCoarseSchedulerActivity )
+        m_pCoarseSchedulerActivity->signal();
+    if ( pRunInfo->isDemand() )
+        dynamic_cast<RSIManager*>( m_Managers[MID_RSI_MANAGER] )->signalActivity();
+}
+
+
 //  terminateExecActivities()
 //
 //  Terminates all exec activities
@@ -251,15 +489,11 @@ Exec::terminateExecActivities() const
 {
     m_pRunInfo->attach();
     m_pRunInfo->killActivities();
+    m_pRunInfo->detach();
 
+    //  hasLiveActivity() needs only a shared lock, so this does not hold off the activities' own updates
     while ( m_pRunInfo->hasLiveActivity() )
-    {
-        m_pRunInfo->detach();
         miscSleep( 100 );
-        m_pRunInfo->attach();
-    }
-
-    m_pRunInfo->detach();
 }
 
 
@@ -292,11 +526,7 @@ Exec::worker()
     m_pPanelInterface->setStatusMessage( getStatusString( m_Status ));
 
     //  Kill any RunInfo objects still hanging around from a previous session
-    while ( m_RunInfoTable.size() > 0 )
-    {
-        delete m_RunInfoTable.begin()->second;
-        m_RunInfoTable.erase( m_RunInfoTable.begin()->first );
-    }
+    clearRunInfoTable();
 
     if ( m_Status == ST_NOT_BOOTED )
     {
@@ -316,7 +546,7 @@ Exec::worker()
     std::string overheadUserId = m_pConfiguration->getStringValue( "OVRUSR" );
     m_pRunInfo = new ExecRunInfo( this, overheadAccountId, overheadUserId );
     m_pRunInfo->setSecurityContext( new ExecSecurityContext() );
-    m_RunInfoTable.insert( std::make_pair( m_pRunInfo->getActualRunId(), m_pRunInfo ) );
+    insertRunInfo( m_pRunInfo );
 
     //  Wake up the managers
     bool startError = false;
@@ -366,10 +596,12 @@ Exec::worker()
         //  Kill any remaining user activities.
         //  Don't delete anything - the user might want to dump the Exec.
         lock();
-        for ( ITRUNINFOS itri = m_RunInfoTable.begin(); itri != m_RunInfoTable.end(); ++itri )
+        std::vector<RunInfo*> runInfos;
+        m_RunRegistry.getRunInfos( &runInfos );
+        for ( INDEX rx = 0; rx < runInfos.size(); ++rx )
         {
-            if ( !itri->second->isExec() )
-                itri->second->killActivities();
+            if ( !runInfos[rx]->isExec() )
+                runInfos[rx]->killActivities();
         }
         unlock();
     }
@@ -390,6 +622,14 @@ Exec::worker()
     for ( ITEXECMANAGERS item = m_Managers.begin(); item != m_Managers.end(); ++item )
         (*item)->terminate();
 
+    //  If anyone was tracing, they will want to see how we got here
+    if ( TraceLog::isEnabled() )
+    {
+        std::string fileName = dumpTrace();
+        if ( !fileName.empty() )
+            SystemLog::write( "Exec trace written to " + fileName );
+    }
+
     //  All done.
     setStatus( ST_STOPPED );
 }
@@ -434,6 +674,7 @@ Exec::Exec
     m_pNodeTable( pNodeTable ),
     m_pPanelInterface( pPanelInterface )
 {
+    MISCLIB_SET_LOCK_NAME( "Exec" );
     m_CurrentSession = 0;
     m_ExecTimeOffsetMicros = 0;
     m_HoldBatchRuns = false;
@@ -441,7 +682,10 @@ Exec::Exec
     m_HoldDemandTerminals = false;
     m_InitialBoot = true;
     m_LastStopCode = SC_NONE;
+    m_pCoarseSchedulerActivity = 0;
+    m_pLoadGeneratorActivity = 0;
     m_OperatorBoot = false;
+    m_pRunEventActivity = 0;
     m_pRunInfo = 0;
     m_Status = ST_NOT_BOOTED;
 
@@ -469,12 +713,7 @@ Exec::~Exec()
 	}
 
     // Remove any existing RunInfo objects
-    m_pRunInfo = 0;
-    while ( m_RunInfoTable.size() != 0 )
-    {
-        delete m_RunInfoTable.begin()->second;
-        m_RunInfoTable.erase( m_RunInfoTable.begin()->first );
-    }
+    clearRunInfoTable();
 }
 
 
@@ -571,12 +810,7 @@ Exec::bootExec
         return false;
 
     // Remove any existing RunInfo objects (from a previous session, presumably)
-    m_pRunInfo = 0;
-    while ( m_RunInfoTable.size() != 0 )
-    {
-        delete m_RunInfoTable.begin()->second;
-        m_RunInfoTable.erase( m_RunInfoTable.begin()->first );
-    }
+    clearRunInfoTable();
 
     m_OperatorBoot = operatorBoot;
     return Worker::workerStart();
@@ -712,7 +946,6 @@ Exec::createDemandRun
 {
     //  Validate account - we have to do this in case RSI screws things up
     RSIManager* prsimgr = dynamic_cast<RSIManager*>( m_Managers[MID_RSI_MANAGER] );
-    ConsoleManager* pconsmgr = dynamic_cast<ConsoleManager*>( m_Managers[MID_CONSOLE_MANAGER] );
 
     if ( accountId.size() == 0 )
     {
@@ -742,59 +975,19 @@ Exec::createDemandRun
     //  "YOUR USER-ID DOES NOT HAVE ACCESS TO THE REQUESTED PROJECT-ID."
     //  TODO:SEC (? is this not handled in demand?  think about this...)
 
-    //  Deal with project-id
-    std::string effectiveProjectId = projectId;
-    if ( effectiveProjectId.size() == 0 )
-        effectiveProjectId = "Q$Q$Q$";
-
-    //  Deal with run-id
-    std::string originalRunId = runId;
-    if ( originalRunId.size() == 0 )
-        originalRunId = "RUN000";
-
-    std::string actualRunId;
-    if ( !generateUniqueRunId( runId, &actualRunId ) )
-    {
-        std::string consMsg = "UNABLE TO GENERATE UNIQUE RUNID FOR " + originalRunId;
-        pconsmgr->postReadOnlyMessage( consMsg, m_pRunInfo );
+    DemandRunInfo* pDRInfo = openDemandRun( pActivity,
+                                            userProfile,
+                                            rsiSessionNumber,
+                                            rsiSessionName,
+                                            runId,
+                                            accountId,
+                                            sessionUserId,
+                                            projectId,
+                                            options,
+                                            schedulingPriority,
+                                            processorDispatchingPriority );
+    if ( pDRInfo == 0 )
         prsimgr->sendOutput( rsiSessionNumber, "RUN-ID CONFLICT" );
-        return 0;
-    }
-
-    //  Priority values
-    char schedPri = schedulingPriority;
-    if ( schedPri == ' ' )
-        schedPri = 'A';
-
-    char procPri = processorDispatchingPriority;
-    if ( procPri == ' ' )
-        procPri = 'A';
-
-    //  Ready to create and register the DemandRunInfo object
-    DemandRunInfo* pDRInfo = new DemandRunInfo( this,
-                                                originalRunId,
-                                                actualRunId,
-                                                accountId,
-                                                projectId,
-                                                sessionUserId,
-                                                options,
-                                                schedPri,
-                                                procPri,
-                                                rsiSessionNumber );
-    pDRInfo->setSecurityContext( new SecurityContext( userProfile ) );
-    m_RunInfoTable[actualRunId] = pDRInfo;
-
-    //  Notify console
-    std::string consMsg = actualRunId + "/" + rsiSessionName + " START";
-    if ( m_pConfiguration->getBoolValue( "SFTIMESTAMP" ) )
-        consMsg += " " + getTimeStamp();
-    pconsmgr->postReadOnlyMessage( consMsg, pDRInfo );
-
-    //  Assign TPF$ and DIAG$ - If either of these fails, the run is error'd and terminated.
-    if ( !assignTPF$ToRun( pActivity, pDRInfo ) )
-        return pDRInfo;
-    if ( !assignDIAG$ToRun( pActivity, pDRInfo ) )
-        return pDRInfo;
 
     return pDRInfo;
 }
@@ -830,6 +1023,51 @@ Exec::createKeyin
 }
 
 
+//  createScriptedDemandRun()
+//
+//  Opens a demand run which is driven by a script rather than by an RSI session (see LoadGeneratorActivity).
+//  There is no session to validate against or to complain to, so the user-id comes from the profile,
+//  the RSI session number is zero, and the caller does what RSIManager would otherwise do -
+//  it feeds READ$ whenever the run allows input, drains PRINT$, and lets go of the run at RSI_TERM.
+//
+//  Parameters:
+//      pActivity:          pointer to requesting Activity
+//      userProfile:        profile under which the run executes
+//      sessionName:        pseudo-session name, for the START message
+//      runId:              run-id - it is made unique as usual
+//      accountId:          account-id - must not be empty
+//      projectId:          project-id - defaults to 'Q$Q$Q$'
+//
+//  Returns:
+//      pointer to newly-created DemandRunInfo object if successful, else zero
+DemandRunInfo*
+Exec::createScriptedDemandRun
+(
+    Activity* const                     pActivity,
+    const SecurityManager::UserProfile& userProfile,
+    const std::string&                  sessionName,
+    const std::string&                  runId,
+    const std::string&                  accountId,
+    const std::string&                  projectId
+)
+{
+    if ( accountId.size() == 0 )
+        return 0;
+
+    return openDemandRun( pActivity,
+                          userProfile,
+                          0,
+                          sessionName,
+                          runId,
+                          accountId,
+                          userProfile.m_UserId,
+                          projectId,
+                          0,
+                          ' ',
+                          ' ' );
+}
+
+
 //  displaySystemErrorMsg()
 //
 //  Displays the
@@ -876,7 +1114,7 @@ Exec::displayTime
 )
 {
     std::stringstream strm;
-    SystemTime* pSystemTime = SystemTime::createFromMicroseconds( SystemTime::getMicrosecondsSinceEpoch() );
+    SystemTime* pSystemTime = SystemTime::createFromMicroseconds( VirtualClock::getInstance()->getMicrosecondsSinceEpoch() );
 
     if ( longFormat )
     {
@@ -940,16 +1178,26 @@ Exec::dump
     stream << "  Operator Boot:     " << ( m_OperatorBoot ? "true" : "false" ) << std::endl;
     stream << "  Status:            " << std::oct << static_cast<unsigned int>(m_Status)
             << ":" << getStatusString( m_Status ) << std::endl;
+    VirtualClock::getInstance()->dump( stream, "  " );
 
     //  Dump the Run Info Table (this will include the Exec's table)
     stream << "  Run Info Objects:" << std::endl;
-    for (CITRUNINFOS itri = m_RunInfoTable.begin(); itri != m_RunInfoTable.end(); ++itri )
-        itri->second->dump( stream, "    ", dumpBits );
+    lockShared();
+    LSTRING runids;
+    m_RunRegistry.getRunids( &runids );
+    for ( LCITSTRING itr = runids.begin(); itr != runids.end(); ++itr )
+        m_RunRegistry.find( *itr )->dump( stream, "    ", dumpBits );
+    unlockShared();
 
     //  Dump the managers
     for (CITEXECMANAGERS itm = m_Managers.begin(); itm != m_Managers.end(); ++itm )
         (*itm)->dump( stream, dumpBits );
 
+#if MISCLIB_LOCK_PROFILING
+    //  Dump the most contended locks
+    LockProfiler::getInstance()->dump( stream, "  ", 20 );
+#endif
+
     stream.close();
     return fileName;
 }
@@ -957,12 +1205,12 @@ Exec::dump
 
 //  getExecTime()
 //
-//  Gets the exec time in microseconds since EXEC epoch,
+//  Gets the exec time in microseconds since EXEC epoch, according to the VirtualClock,
 //  based on the offset provided by the D keyin.
 EXECTIME
 Exec::getExecTime() const
 {
-    return SystemTime::getMicrosecondsSinceEpoch() + m_ExecTimeOffsetMicros;
+    return VirtualClock::getInstance()->getMicrosecondsSinceEpoch() + m_ExecTimeOffsetMicros;
 }
 
 
@@ -1019,36 +1267,27 @@ Exec::getRunCounters
     COUNT* const        pBacklogRunCount
 ) const
 {
-    *pBatchRunCount = 0;
-    *pDemandRunCount = 0;
-    *pBacklogRunCount = 0;
-
-    lock();
-    for ( CITRUNINFOS itri = m_RunInfoTable.begin(); itri != m_RunInfoTable.end(); ++itri )
-    {
-        const RunInfo* pRunInfo = itri->second;
-        switch ( pRunInfo->getState() )
-        {
-        case RunInfo::STATE_IN_BACKLOG:
-            ++(*pBacklogRunCount);
-            break;
+    //  No lock needed - the counters are maintained atomically by the registry
+    RunRegistry::Counters counters = m_RunRegistry.getCounters();
+    *pBatchRunCount = counters.m_BatchRuns;
+    *pDemandRunCount = counters.m_DemandRuns;
+    *pBacklogRunCount = counters.m_BacklogRuns;
+}
 
-        case RunInfo::STATE_ACTIVE:
-        case RunInfo::STATE_FIN:
-        case RunInfo::STATE_RSI_DETACHED:
-        case RunInfo::STATE_RSI_TERM:
-            if ( pRunInfo->isBatch() )
-                ++(*pBatchRunCount);
-            else if ( pRunInfo->isDemand() )
-                ++(*pDemandRunCount);
-            break;
 
-        case RunInfo::STATE_SMOQUE:
-            //???? anything to do here?
-            break;
-        }
-    }
-    unlock();
+//  getRunCount()
+//
+//  Retrieves the number of runs in the given state
+COUNT
+Exec::getRunCount
+(
+    const RunInfo::State    state
+) const
+{
+    lockShared();
+    COUNT count = m_RunRegistry.getCount( state );
+    unlockShared();
+    return count;
 }
 
 
@@ -1065,16 +1304,32 @@ RunInfo*
 {
     RunInfo* pResult = 0;
 
-    lock();
-    CITRUNINFOS itri = m_RunInfoTable.find( runId );
-    if ( itri != m_RunInfoTable.end() )
-    {
-        pResult = itri->second;
-        if ( attachFlag )
-            pResult->attach();
-    }
+    lockShared();
+    pResult = m_RunRegistry.find( runId );
+    if ( pResult && attachFlag )
+        pResult->attach();
 
-    unlock();
+    unlockShared();
+    return pResult;
+}
+
+
+//  getRunInfoShared()
+//
+//  Retrieves the RunInfo object for the given actual run id, attached for reading only.
+//  Caller must release it with detachShared(), and must not attach it (nor lock anything it might) meanwhile.
+RunInfo*
+    Exec::getRunInfoShared
+    (
+    const std::string&  runId
+    ) const
+{
+    lockShared();
+    RunInfo* pResult = m_RunRegistry.find( runId );
+    if ( pResult )
+        pResult->attachShared();
+
+    unlockShared();
     return pResult;
 }
 
@@ -1088,11 +1343,9 @@ void
     LSTRING* const      pContainer
     ) const
 {
-    pContainer->clear();
-    lock();
-    for ( CITRUNINFOS itri = m_RunInfoTable.begin(); itri != m_RunInfoTable.end(); ++itri )
-        pContainer->push_back( itri->first );
-    unlock();
+    lockShared();
+    m_RunRegistry.getRunids( pContainer );
+    unlockShared();
 }
 
 
@@ -1110,123 +1363,35 @@ Exec::getStatusCounters
     COUNT* const pInitialLoadRuns
 ) const
 {
+    //TODO:BATCH any deadline?  any waiting on start time?  any ops hold?
+    //TODO:TASK any in initial load?
+    //  No lock needed - the counters are maintained atomically by the registry
     *pRunsWaitingOnStartTime = 0;
     *pUnopenedDeadlineRuns = 0;
     *pOperationsHold = 0;
     *pSOptionHold = 0;
-    *pActiveRuns = 0;
+    *pActiveRuns = m_RunRegistry.getCounters().m_ActiveRuns;
     *pInitialLoadRuns = 0;
-
-    lock();
-    for ( CITRUNINFOS itri = m_RunInfoTable.begin(); itri != m_RunInfoTable.end(); ++itri )
-    {
-        const RunInfo* pRunInfo = itri->second;
-        if ( !pRunInfo->isExec() && !pRunInfo->isTIP() )
-        {
-            switch ( pRunInfo->getState() )
-            {
-            case RunInfo::STATE_IN_BACKLOG:
-                //TODO:BATCH any deadline?  any waiting on start time?  any ops hold?
-                break;
-
-            case RunInfo::STATE_ACTIVE:
-                ++(*pActiveRuns);
-                //TODO:TASK any in initial load?
-                break;
-
-            case RunInfo::STATE_FIN:
-            case RunInfo::STATE_RSI_DETACHED:
-            case RunInfo::STATE_RSI_TERM:
-                //  We don't count these
-                break;
-
-            case RunInfo::STATE_SMOQUE:
-                //???? anything to do here?
-                break;
-            }
-        }
-    }
-    unlock();
 }
 
 
-//  pollUserRunInfoObjects()
+//  postActivityExit()
 //
-//  Iterates over the user-mode RunInfo objects, and cleans their terminated activities.
+//  Invoked by an activity of a user run, on its own thread, as that thread is about to finish.
+//  We queue the exit and wake up RunEventActivity, which reaps the activity.
+//  The caller may hold its RunInfo attached, so we must not take our own lock here.
 void
-Exec::pollUserRunInfoObjects
+Exec::postActivityExit
 (
-    Activity* const     pActivity
+    RunInfo* const          pRunInfo,
+    Activity* const         pActivity,
+    const COUNT64           serialNumber
 )
 {
-    lock();
-
-    ITRUNINFOS itri = m_RunInfoTable.begin();
-    while ( itri != m_RunInfoTable.end() )
-    {
-        RunInfo* pri = itri->second;
-        UserRunInfo* prui = dynamic_cast<UserRunInfo*>( pri );
-        pri->attach();
-        switch ( pri->getState() )
-        {
-        case RunInfo::STATE_IN_BACKLOG:
-            //  Waiting on QueueManager to start us
-            pri->detach();
-            ++itri;
-            break;
-
-        case RunInfo::STATE_ACTIVE:
-            //  Clean up any stale activity threads
-            pri->cleanActivities();
-            pri->detach();
-            ++itri;
-            break;
-
-        case RunInfo::STATE_FIN:
-            //  Clear the run info.
-            closeUserRun( pActivity, prui );
-
-            //  If we're DEMAND, wait for RSIManager to let go of us
-            //  otherwise, go to ST_SMOQUE
-            if ( pri->isDemand() && (pri->getState() != RunInfo::STATE_RSI_DETACHED) )
-                pri->setState( RunInfo::STATE_RSI_TERM );
-            else
-                pri->setState( RunInfo::STATE_SMOQUE );
-            pri->detach();
-            break;
-
-        case RunInfo::STATE_RSI_DETACHED:
-            //  RSIManager no longer tracking us - move on to ST_SMOQUE
-            pri->setState( RunInfo::STATE_SMOQUE );
-            pri->detach();
-            break;
-
-        case RunInfo::STATE_RSI_TERM:
-            //  Waiting on RSIManager to release us
-            pri->detach();
-            ++itri;
-            break;
-
-        case RunInfo::STATE_SMOQUE:
-            //  There (may) be files in SMOQUE - if not, we can delete the RunInfo object
-            //TODO:SMOQUE
-            if ( false ) // in smoque
-            {
-                pri->detach();
-                ++itri;
-            }
-
-            //  Not in smoque...
-            pri->detach();
-            pri = 0;
-            delete itri->second;
-            itri->second = 0;
-            m_RunInfoTable.erase( itri++ );
-            break;
-        }
-    }
-
-    unlock();
+    std::lock_guard<std::mutex> guard( m_RunStateEventMutex );
+    m_ActivityExits.push_back( ActivityExit( pRunInfo, pActivity, serialNumber ) );
+    if ( m_pRunEventActivity )
+        m_pRunEventActivity->signal();
 }
 
 
@@ -1281,9 +1446,102 @@ void
     ExecNodeChangeEvent ev( pNode, mediaName, nodeStatusString );
     notifyListeners( &ev );
 }
+
 */
 
 
+//  postRunStateEvent()
+//
+//  Invoked by RunInfo::setState() whenever a run changes state.
+//  We adjust the registry's (atomic) run counters, then queue the event and wake up RunEventActivity and the run's schedulers -
+//  the RunInfo is attached (locked) by the caller, so we must not take our own lock here.
+void
+Exec::postRunStateEvent
+(
+    RunInfo* const          pRunInfo,
+    const RunInfo::State    previousState,
+    const RunInfo::State    newState
+)
+{
+    m_RunRegistry.noteStateChange( pRunInfo, previousState, newState );
+
+    std::lock_guard<std::mutex> guard( m_RunStateEventMutex );
+    m_RunStateEvents.push_back( RunStateEvent( pRunInfo, previousState, newState ) );
+    if ( m_pRunEventActivity )
+        m_pRunEventActivity->signal();
+    signalSchedulers( pRunInfo );
+}
+
+
+//  processRunStateEvents()
+//
+//  Invoked by RunEventActivity whenever it is signaled.
+//  Reaps exited activities and applies posted state changes to the state index,
+//  then advances those runs which are waiting on the Exec:
+//      FIN runs are closed, then go to RSI_TERM (demand runs which RSIManager still holds) or SMOQUE
+//      RSI_DETACHED runs go to SMOQUE
+//      SMOQUE runs are deleted
+//  Advancing a run posts further events (and may let activities exit), so we keep going until nothing new has been posted.
+//  Only the FIN, RSI_DETACHED, and SMOQUE lists are visited - backlogged and active runs are never scanned.
+//
+//  Returns:
+//      true if some FIN run could not be closed yet, because it still has a live activity
+bool
+Exec::processRunStateEvents
+(
+    Activity* const     pActivity
+)
+{
+    lock();
+    reapActivities();
+    applyRunStateEvents();
+
+    do
+    {
+        //  Close finished runs.  If the activity which set FIN is still winding down, leave the run for later.
+        std::vector<RunInfo*> runInfos;
+        m_RunRegistry.getRunInfos( RunInfo::STATE_FIN, &runInfos );
+        for ( INDEX rx = 0; rx < runInfos.size(); ++rx )
+        {
+            RunInfo* pri = runInfos[rx];
+            if ( pri->hasLiveActivity() )
+                continue;
+
+            pri->attach();
+            closeUserRun( pActivity, dynamic_cast<UserRunInfo*>( pri ) );
+
+            //  If we're DEMAND, wait for RSIManager to let go of us
+            //  otherwise, go to ST_SMOQUE
+            if ( pri->isDemand() && (pri->getState() != RunInfo::STATE_RSI_DETACHED) )
+                pri->setState( RunInfo::STATE_RSI_TERM );
+            else
+                pri->setState( RunInfo::STATE_SMOQUE );
+            pri->detach();
+        }
+
+        //  RSIManager no longer tracking these - move on to ST_SMOQUE
+        m_RunRegistry.getRunInfos( RunInfo::STATE_RSI_DETACHED, &runInfos );
+        for ( INDEX rx = 0; rx < runInfos.size(); ++rx )
+        {
+            runInfos[rx]->attach();
+            runInfos[rx]->setState( RunInfo::STATE_SMOQUE );
+            runInfos[rx]->detach();
+        }
+
+        //  There (may) be files in SMOQUE - if not, we can delete the RunInfo object
+        //TODO:SMOQUE
+        m_RunRegistry.getRunInfos( RunInfo::STATE_SMOQUE, &runInfos );
+        for ( INDEX rx = 0; rx < runInfos.size(); ++rx )
+            eraseRunInfo( runInfos[rx] );
+    }
+    while ( reapActivities() | applyRunStateEvents() );
+
+    bool deferred = m_RunRegistry.getCount( RunInfo::STATE_FIN ) > 0;
+    unlock();
+    return deferred;
+}
+
+
 //  printTailSheet()
 //
 //  Prints summary information to a run's tail sheet.
@@ -1487,6 +1745,24 @@ Exec::registerAndStartKeyin
 }
 
 
+//  setLoadGeneratorActivity()
+//
+//  Registers a new load generator for the LG keyin.  The one it replaces must be terminated,
+//  and was skipped by reapActivities() - so we post its exit again, now that nobody will look for it.
+//  Caller must hold our lock.
+void
+Exec::setLoadGeneratorActivity
+(
+    LoadGeneratorActivity* const    pActivity
+)
+{
+    LoadGeneratorActivity* pPrevious = m_pLoadGeneratorActivity;
+    m_pLoadGeneratorActivity = pActivity;
+    if ( pPrevious )
+        postActivityExit( m_pRunInfo, pPrevious, pPrevious->getSerialNumber() );
+}
+
+
 //  setStatus()
 //
 //  All updates to the Exec status MUST go through here.
@@ -1507,6 +1783,18 @@ Exec::setStatus
 }
 
 
+//  signalCoarseScheduler()
+//
+//  Invoked by whoever places input in a run's READ$ buffer, so that CoarseSchedulerActivity picks it up right away
+void
+Exec::signalCoarseScheduler()
+{
+    std::lock_guard<std::mutex> guard( m_RunStateEventMutex );
+    if ( m_pCoarseSchedulerActivity )
+        m_pCoarseSchedulerActivity->signal();
+}
+
+
 //  stopExec()
 //
 //  Stops the EXEC
@@ -1522,6 +1810,11 @@ Exec::stopExec
     m_LastStopCode = stopCode;
     m_pPanelInterface->setStopCodeMessage( getStopCodeString( m_LastStopCode ) );
 
+    //  Whatever led up to the stop should be in the log file before anything else happens
+    SystemLog* pLog = SystemLog::getInstance();
+    if ( pLog )
+        pLog->flush();
+
     Worker::workerStop( false );
     return true;
 }
@@ -1587,6 +1880,27 @@ Exec::terminateDemandRun
 
 //  public statics
 
+//  dumpTrace()
+//
+//  Writes the content of the TraceLog rings to a time-stamped file (see TraceDecoder)
+//
+//  Returns:
+//      file name of trace file, or an empty string if it could not be written
+std::string
+Exec::dumpTrace()
+{
+    SystemTime* pLocalTime = SystemTime::createLocalSystemTime();
+    std::string fileName = "ExecTrace." + pLocalTime->getTimeStamp();
+#ifdef  WIN32
+    fileName += ".bin";
+#endif
+    delete pLocalTime;
+    pLocalTime = 0;
+
+    return TraceLog::dump( fileName ) ? fileName : "";
+}
+
+
 //  getSatusString()
 const char*
 Exec::getStatusString
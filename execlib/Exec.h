@@ -8,6 +8,7 @@
 
 
 
+#include    "BootProfile.h"
 #include    "Configuration.h"
 #include    "ConsoleInterface.h"
 #include    "ControlModeRunInfo.h"
@@ -17,11 +18,17 @@
 #include    "KeyinActivity.h"
 #include    "NodeTable.h"
 #include    "RunInfo.h"
+#include    "RunRegistry.h"
 #include    "UserRunInfo.h"
 #include    "PanelInterface.h"
 
 
 
+//  annoying forward-references
+class   LoadGeneratorActivity;
+
+
+
 //  For debugging
 #if 0 //TODO:DEBUG keep this around if we need it for some other similar purpose
 #define     STRINGIZE(x)                    STRINGIZE_SIMPLE(x)
@@ -54,7 +61,7 @@
 
 
 
-class	Exec : public Worker, public Lockable
+class	Exec : public Worker, public SharedLockable
 {
 public:
     enum ManagerId
@@ -132,11 +139,50 @@ private:
     typedef EXECMANAGERS::iterator                              ITEXECMANAGERS;
     typedef EXECMANAGERS::const_iterator                        CITEXECMANAGERS;
 
-    typedef std::map<std::string, RunInfo*>                     RUNINFOS;
-    typedef RUNINFOS::iterator                                  ITRUNINFOS;
-    typedef RUNINFOS::const_iterator                            CITRUNINFOS;
+    //  Posted by Activity::workerExiting(), consumed by processRunStateEvents()
+    class   ActivityExit
+    {
+    public:
+        RunInfo*                    m_pRunInfo;
+        Activity*                   m_pActivity;                //  compared, never dereferenced, until found
+        COUNT64                     m_SerialNumber;
+
+        ActivityExit( RunInfo* const    pRunInfo,
+                      Activity* const   pActivity,
+                      const COUNT64     serialNumber )
+            :m_pRunInfo( pRunInfo ),
+            m_pActivity( pActivity ),
+            m_SerialNumber( serialNumber )
+        {}
+    };
+
+    typedef std::deque<ActivityExit>                            ACTIVITYEXITS;
+    typedef ACTIVITYEXITS::iterator                             ITACTIVITYEXITS;
+
+    //  Posted by RunInfo::setState(), consumed by processRunStateEvents()
+    class   RunStateEvent
+    {
+    public:
+        RunInfo*                    m_pRunInfo;
+        RunInfo::State              m_PreviousState;
+        RunInfo::State              m_NewState;
+
+        RunStateEvent( RunInfo* const       pRunInfo,
+                       const RunInfo::State previousState,
+                       const RunInfo::State newState )
+            :m_pRunInfo( pRunInfo ),
+            m_PreviousState( previousState ),
+            m_NewState( newState )
+        {}
+    };
+
+    typedef std::deque<RunStateEvent>                           RUNSTATEEVENTS;
+    typedef RUNSTATEEVENTS::iterator                            ITRUNSTATEEVENTS;
 
     //  private data
+    ACTIVITYEXITS                   m_ActivityExits;            //  exited activities not yet reaped
+    BootProfile                     m_BootProfile;              //  timeline of the most recent boot
+    Activity*                       m_pCoarseSchedulerActivity; //  signaled when a run may have control mode work
     Configuration* const            m_pConfiguration;           //  From application wrapper (e.g., emexec)
     COUNT                           m_CurrentSession;
     INT64                           m_ExecTimeOffsetMicros;     //  usec offset from system time, for Exec time
@@ -145,6 +191,8 @@ private:
     bool                            m_HoldDemandTerminals;      //  Do not allow any more demand terminals to go active
     bool                            m_InitialBoot;
     StopCode                        m_LastStopCode;
+    LoadGeneratorActivity*          m_pLoadGeneratorActivity;   //  most recent LG keyin generator, if any - it is not
+                                                                //      reaped until it is replaced, so LG STATUS can report
     EXECMANAGERS                    m_Managers;
     NodeTable* const                m_pNodeTable;               //  From application wrapper (e.g., emexec)
                                                                 //      This is persisted here so that DeviceManager can
@@ -156,12 +204,17 @@ private:
                                                                 //      alter the object itself (just good practice).
     bool                            m_OperatorBoot;             //  if false it is an automatic boot
     PanelInterface* const           m_pPanelInterface;          //  Whoever is controlling us
+    Activity*                       m_pRunEventActivity;        //  signaled when a RunInfo changes state
     ExecRunInfo*                    m_pRunInfo;                 //  pointer to EXEC-8 RunInfo object
-    RUNINFOS                        m_RunInfoTable;             //  map of all RunInfo objects
+    RunRegistry                     m_RunRegistry;              //  all RunInfo objects - under our lock, except counters
+    RUNSTATEEVENTS                  m_RunStateEvents;           //  state changes not yet applied to the index
+    std::mutex                      m_RunStateEventMutex;       //  protects m_RunStateEvents, m_ActivityExits,
+                                                                //      m_pRunEventActivity, and m_pCoarseSchedulerActivity
     Status                          m_Status;
 
     //  private methods
     void                            abortRun( RunInfo* const pRunInfo );
+    bool                            applyRunStateEvents();
     bool                            assignDIAG$ToRun( Activity* const       pActivity,
                                                       UserRunInfo* const    pRunInfo );
     bool                            assignFileToRun( Activity* const    pActivity,
@@ -170,8 +223,24 @@ private:
                                                      const std::string& fileName );
     bool                            assignTPF$ToRun( Activity* const    pActivity,
                                                      UserRunInfo* const pRunInfo );
+    void                            clearRunInfoTable();
+    void                            eraseRunInfo( RunInfo* const pRunInfo );
     bool                            generateUniqueRunId( const std::string&     originalRunId,
                                                             std::string* const  pUniqueRunId ) const;
+    void                            insertRunInfo( RunInfo* const pRunInfo );
+    DemandRunInfo*                  openDemandRun( Activity* const                      pActivity,
+                                                   const SecurityManager::UserProfile&  userProfile,
+                                                   const COUNT                          rsiSessionNumber,
+                                                   const std::string&                   rsiSessionName,
+                                                   const std::string&                   runId,
+                                                   const std::string&                   accountId,
+                                                   const std::string&                   userId,
+                                                   const std::string&                   projectId,
+                                                   const UINT32                         options,
+                                                   const char                           schedulingPriority,
+                                                   const char                           processorDispatchingPriority );
+    bool                            reapActivities();
+    void                            signalSchedulers( const RunInfo* const pRunInfo );
     void                            terminateExecActivities() const;
 
     //  private static methods
@@ -213,6 +282,12 @@ public:
                                                      const char                             processorDispatchingPriority );
     bool                            createKeyin( const Word36       routing,
                                                  const std::string& input );
+    DemandRunInfo*                  createScriptedDemandRun( Activity* const                        pActivity,
+                                                             const SecurityManager::UserProfile&    userProfile,
+                                                             const std::string&                     sessionName,
+                                                             const std::string&                     runId,
+                                                             const std::string&                     accountId,
+                                                             const std::string&                     projectId );
     void                            displaySystemErrorMsg( const StopCode   stopCode,
                                                             const COUNT     session ) const;
     void                            displayTime( const EXECTIME     execTime,
@@ -225,20 +300,30 @@ public:
     void                            getRunCounters( COUNT* const    pBatchRunCount,
                                                     COUNT* const    pDemandRunCount,
                                                     COUNT* const    pBacklogRunCount ) const;
+    COUNT                           getRunCount( const RunInfo::State state ) const;
     void                            getRunids( LSTRING* const pContainer ) const;
     RunInfo*                        getRunInfo( const std::string&  runId,
                                                 const bool          attach ) const;
+    RunInfo*                        getRunInfoShared( const std::string& runId ) const;
     void                            getStatusCounters( COUNT* const pRunsWaitingOnStartTime,
                                                        COUNT* const pUnopenedDeadlineRuns,
                                                        COUNT* const pOperationsHold,
                                                        COUNT* const pSOptionHold,
                                                        COUNT* const pActiveRuns,
                                                        COUNT* const pInitialLoadRuns ) const;
-    void                            pollUserRunInfoObjects( Activity* const pActivity );
+    void                            postActivityExit( RunInfo* const    pRunInfo,
+                                                      Activity* const   pActivity,
+                                                      const COUNT64     serialNumber );
     void                            postNodeChangeEvent( const Node* const pNode );
+    void                            postRunStateEvent( RunInfo* const       pRunInfo,
+                                                       const RunInfo::State previousState,
+                                                       const RunInfo::State newState );
+    bool                            processRunStateEvents( Activity* const pActivity );
     void                            printTailSheet( ControlModeRunInfo* const pRunInfo ) const;
     void                            registerAndStartKeyin( KeyinActivity* const pActivity );
+    void                            setLoadGeneratorActivity( LoadGeneratorActivity* const pActivity );
     void                            setStatus( const Status status );
+    void                            signalCoarseScheduler();
     bool                            stopExec( const StopCode stopCode );
     void                            terminateDemandRun( DemandRunInfo* const pRunInfo );
 
@@ -246,17 +331,19 @@ public:
     inline bool                     areBatchRunsHeld() const                { return m_HoldBatchRuns; }
     inline bool                     areDemandRunsHeld() const               { return m_HoldDemandRuns; }
     inline bool                     areDemandTerminalsHeld() const          { return m_HoldDemandTerminals; }
+    inline BootProfile*             getBootProfile()                        { return &m_BootProfile; }
     inline const Configuration&     getConfiguration() const                { return *m_pConfiguration; }
     inline COUNT                    getCurrentSession() const               { return m_CurrentSession; }
     inline COUNT64                  getExecTimeMicroseconds() const
     {
-        return SystemTime::getMicrosecondsSinceEpoch() + m_ExecTimeOffsetMicros;
+        return VirtualClock::getInstance()->getMicrosecondsSinceEpoch() + m_ExecTimeOffsetMicros;
     }
     inline bool                     getJumpKey( const PanelInterface::JUMPKEY jumpKey ) const
     {
         return m_pPanelInterface->getJumpKey( jumpKey );
     }
     inline StopCode                 getLastStopCode() const                 { return m_LastStopCode; }
+    inline LoadGeneratorActivity*   getLoadGeneratorActivity() const        { return m_pLoadGeneratorActivity; }
     inline ExecManager*             getManager( const ManagerId id ) const  { return m_Managers[id]; }
     inline const NodeTable&         getNodeTable() const                    { return *m_pNodeTable; }
     inline ExecRunInfo*             getRunInfo() const                      { return m_pRunInfo; }
@@ -275,6 +362,16 @@ public:
         return dynamic_cast<ConsoleManager*>(m_Managers[MID_CONSOLE_MANAGER])->
                 registerConsole( pConsoleInterface, mainConsole );
     }
+    inline void                     setCoarseSchedulerActivity( Activity* const pActivity )
+    {
+        std::lock_guard<std::mutex> guard( m_RunStateEventMutex );
+        m_pCoarseSchedulerActivity = pActivity;
+    }
+    inline void                     setRunEventActivity( Activity* const pActivity )
+    {
+        std::lock_guard<std::mutex> guard( m_RunStateEventMutex );
+        m_pRunEventActivity = pActivity;
+    }
     inline void                     setHoldBatchRuns( const bool hold )
     {
         m_HoldBatchRuns = hold;
@@ -298,6 +395,7 @@ public:
     }
 
     // public static methods
+    static std::string              dumpTrace();
     static const char*              getStatusString( const Status status );
     static const char*              getStopCodeString( const StopCode stopCode );
     static bool                     isValidAccountId( const std::string& );
@@ -26,7 +26,7 @@ class   SecurityManager;
 
 
 
-class ExecManager : public Lockable
+class ExecManager : public SharedLockable
 {
 protected:
     Exec* const                 m_pExec;
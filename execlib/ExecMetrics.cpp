@@ -0,0 +1,397 @@
+//  ExecMetrics.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Publishes exec-wide metrics.  All metric names begin with em2200_; latencies are in seconds.
+
+
+
+#include    "execlib.h"
+
+
+
+//  private statics
+
+//  getHostThreadCount()
+//
+//  Retrieves the number of threads in this process, as the host sees it (zero if we cannot tell)
+COUNT
+ExecMetrics::getHostThreadCount()
+{
+#ifdef WIN32
+    return 0;
+#else
+    std::ifstream file( "/proc/self/status" );
+    std::string line;
+    while ( std::getline( file, line ) )
+    {
+        if ( line.compare( 0, 8, "Threads:" ) == 0 )
+        {
+            std::stringstream strm( line.substr( 8 ) );
+            COUNT count = 0;
+            strm >> count;
+            return count;
+        }
+    }
+
+    return 0;
+#endif
+}
+
+
+//  writeConsoleMetrics()
+//
+//  Console message backlog
+void
+ExecMetrics::writeConsoleMetrics
+(
+    Exec* const             pExec,
+    MetricsWriter* const    pWriter
+)
+{
+    ConsoleManager* pConsoleManager = dynamic_cast<ConsoleManager*>( pExec->getManager( Exec::MID_CONSOLE_MANAGER ) );
+
+    pWriter->describe( "em2200_console_read_only_backlog",
+                       MetricsWriter::TYPE_GAUGE,
+                       "Read-only console messages not yet sent to all their consoles" );
+    pWriter->writeSample( "em2200_console_read_only_backlog", COUNT64( pConsoleManager->getReadOnlyCount() ) );
+
+    pWriter->describe( "em2200_console_read_reply_outstanding",
+                       MetricsWriter::TYPE_GAUGE,
+                       "Read-reply console messages awaiting an operator response" );
+    pWriter->writeSample( "em2200_console_read_reply_outstanding", COUNT64( pConsoleManager->getReadReplyCount() ) );
+}
+
+
+//  writeIoMetrics()
+//
+//  IO counts and latencies, per device and per path, as collected by IoManager and the devices themselves.
+//  Rates are left to the consumer, which can derive them from the _count series.
+void
+ExecMetrics::writeIoMetrics
+(
+    Exec* const             pExec,
+    MetricsWriter* const    pWriter
+)
+{
+    DeviceManager* pDeviceManager = dynamic_cast<DeviceManager*>( pExec->getManager( Exec::MID_DEVICE_MANAGER ) );
+    IoManager* pIoManager = dynamic_cast<IoManager*>( pExec->getManager( Exec::MID_IO_MANAGER ) );
+
+    pWriter->describe( "em2200_io_request_latency_seconds",
+                       MetricsWriter::TYPE_SUMMARY,
+                       "IoManager request latency, from submission to completion, by request type" );
+    MetricsWriter::LABELS labels;
+    labels.push_back( std::make_pair( "type", "mass_storage" ) );
+    pWriter->writeSummary( "em2200_io_request_latency_seconds",
+                           labels,
+                           pIoManager->getMassStorageRequestHistogram().getSnapshot() );
+    labels[0].second = "tape";
+    pWriter->writeSummary( "em2200_io_request_latency_seconds",
+                           labels,
+                           pIoManager->getTapeRequestHistogram().getSnapshot() );
+
+    IoManager::DEVICELATENCIES deviceLatencies;
+    pIoManager->getDeviceLatencies( &deviceLatencies );
+
+    pWriter->describe( "em2200_io_device_latency_seconds",
+                       MetricsWriter::TYPE_SUMMARY,
+                       "Child IO latency, from routing to an IOP to completion, by device" );
+    for ( IoManager::CITDEVICELATENCIES itdl = deviceLatencies.begin(); itdl != deviceLatencies.end(); ++itdl )
+    {
+        labels.clear();
+        labels.push_back( std::make_pair( "device", pDeviceManager->getNodeName( itdl->first ) ) );
+        pWriter->writeSummary( "em2200_io_device_latency_seconds", labels, itdl->second->m_Histogram.getSnapshot() );
+    }
+
+    pWriter->describe( "em2200_io_device_outstanding",
+                       MetricsWriter::TYPE_GAUGE,
+                       "Child IOs in progress, by device" );
+    for ( IoManager::CITDEVICELATENCIES itdl = deviceLatencies.begin(); itdl != deviceLatencies.end(); ++itdl )
+    {
+        labels.clear();
+        labels.push_back( std::make_pair( "device", pDeviceManager->getNodeName( itdl->first ) ) );
+        pWriter->writeSample( "em2200_io_device_outstanding", labels, COUNT64( itdl->second->m_Outstanding ) );
+    }
+
+    IoManager::PATHLATENCIES pathLatencies;
+    pIoManager->getPathLatencies( &pathLatencies );
+
+    pWriter->describe( "em2200_io_path_latency_seconds",
+                       MetricsWriter::TYPE_SUMMARY,
+                       "Child IO latency, from routing to an IOP to completion, by path" );
+    for ( IoManager::CITPATHLATENCIES itpl = pathLatencies.begin(); itpl != pathLatencies.end(); ++itpl )
+    {
+        const DeviceManager::Path* pPath = itpl->first;
+        labels.clear();
+        labels.push_back( std::make_pair( "device", pDeviceManager->getNodeName( pPath->m_DeviceIdentifier ) ) );
+        labels.push_back( std::make_pair( "iop", pDeviceManager->getNodeName( pPath->m_IOPIdentifier ) ) );
+        labels.push_back( std::make_pair( "channel_module",
+                                          pDeviceManager->getNodeName( pPath->m_ChannelModuleIdentifier ) ) );
+        labels.push_back( std::make_pair( "controller", pDeviceManager->getNodeName( pPath->m_ControllerIdentifier ) ) );
+        pWriter->writeSummary( "em2200_io_path_latency_seconds", labels, itpl->second->m_Histogram.getSnapshot() );
+    }
+
+    pWriter->describe( "em2200_device_service_seconds",
+                       MetricsWriter::TYPE_SUMMARY,
+                       "Time taken by the device itself to service an IO, by device" );
+    DeviceManager::NODE_IDS deviceIds;
+    pDeviceManager->getDeviceIdentifiers( &deviceIds );
+    for ( DeviceManager::CITNODE_IDS itid = deviceIds.begin(); itid != deviceIds.end(); ++itid )
+    {
+        const DeviceManager::DeviceEntry* pEntry = pDeviceManager->getDeviceEntry( *itid );
+        const Device* pDevice = pEntry ? dynamic_cast<const Device*>( pEntry->m_pNode ) : 0;
+        if ( pDevice == 0 )
+            continue;
+
+        labels.clear();
+        labels.push_back( std::make_pair( "device", pDeviceManager->getNodeName( *itid ) ) );
+        pWriter->writeSummary( "em2200_device_service_seconds", labels, pDevice->getServiceHistogram().getSnapshot() );
+    }
+}
+
+
+//  writeLockMetrics()
+//
+//  Lock contention for the Exec and each of its managers
+void
+ExecMetrics::writeLockMetrics
+(
+    Exec* const             pExec,
+    MetricsWriter* const    pWriter
+)
+{
+    static const char* const managerNames[] =
+    {
+        "DeviceManager",
+        "IoManager",
+        "ConsoleManager",
+        "MFDManager",
+        "FacilitiesManager",
+        "QueueManager",
+        "AccountManager",
+        "SecurityManager",
+        "RSIManager",
+    };
+
+    typedef std::pair<std::string, LockStatistics::Snapshot>    LOCKENTRY;
+    std::vector<LOCKENTRY> locks;
+    locks.push_back( LOCKENTRY( "Exec", pExec->getLockStatistics() ) );
+    for ( INDEX mx = 0; mx < sizeof( managerNames ) / sizeof( managerNames[0] ); ++mx )
+    {
+        ExecManager* pManager = pExec->getManager( static_cast<Exec::ManagerId>( mx ) );
+        if ( pManager )
+            locks.push_back( LOCKENTRY( managerNames[mx], pManager->getLockStatistics() ) );
+    }
+
+    MetricsWriter::LABELS labels( 1 );
+    labels[0].first = "lock";
+
+#if MISCLIB_LOCK_PROFILING
+    //  Acquisitions are only counted in profiling builds - see LockStatistics.h
+    pWriter->describe( "em2200_lock_acquisitions_total",
+                       MetricsWriter::TYPE_COUNTER,
+                       "Lock acquisitions, exclusive and shared" );
+    for ( INDEX lx = 0; lx < locks.size(); ++lx )
+    {
+        labels[0].second = locks[lx].first;
+        pWriter->writeSample( "em2200_lock_acquisitions_total",
+                              labels,
+                              locks[lx].second.m_Acquisitions + locks[lx].second.m_SharedAcquisitions );
+    }
+#endif
+
+    pWriter->describe( "em2200_lock_contentions_total",
+                       MetricsWriter::TYPE_COUNTER,
+                       "Lock acquisitions which had to wait" );
+    for ( INDEX lx = 0; lx < locks.size(); ++lx )
+    {
+        labels[0].second = locks[lx].first;
+        pWriter->writeSample( "em2200_lock_contentions_total", labels, locks[lx].second.m_Contentions );
+    }
+
+    pWriter->describe( "em2200_lock_wait_seconds_total",
+                       MetricsWriter::TYPE_COUNTER,
+                       "Total time spent waiting for locks" );
+    for ( INDEX lx = 0; lx < locks.size(); ++lx )
+    {
+        labels[0].second = locks[lx].first;
+        pWriter->writeSample( "em2200_lock_wait_seconds_total",
+                              labels,
+                              locks[lx].second.m_TotalWaitNSecs / 1000000000.0 );
+    }
+}
+
+
+//  writeLogMetrics()
+//
+//  SystemLog throughput and losses
+void
+ExecMetrics::writeLogMetrics
+(
+    MetricsWriter* const    pWriter
+)
+{
+    SystemLog* pLog = SystemLog::getInstance();
+    if ( pLog == 0 )
+        return;
+
+    SystemLog::Statistics stats = pLog->getStatistics();
+    pWriter->describe( "em2200_system_log_entries_total",
+                       MetricsWriter::TYPE_COUNTER,
+                       "Entries written to the system log file" );
+    pWriter->writeSample( "em2200_system_log_entries_total", stats.m_WrittenCount );
+    pWriter->describe( "em2200_system_log_dropped_total",
+                       MetricsWriter::TYPE_COUNTER,
+                       "Entries discarded because the system log ring was full" );
+    pWriter->writeSample( "em2200_system_log_dropped_total", stats.m_DroppedCount );
+    pWriter->describe( "em2200_system_log_queued",
+                       MetricsWriter::TYPE_GAUGE,
+                       "Entries waiting to be written to the system log file" );
+    pWriter->writeSample( "em2200_system_log_queued", COUNT64( stats.m_QueuedCount ) );
+    pWriter->describe( "em2200_system_log_flushes_total",
+                       MetricsWriter::TYPE_COUNTER,
+                       "Batches written and flushed to the system log file" );
+    pWriter->writeSample( "em2200_system_log_flushes_total", stats.m_FlushCount );
+}
+
+
+//  writePoolMetrics()
+//
+//  Block pool (i.e., directory sector and DAD cache) usage.  Allocations which do not need a refill are
+//  satisfied from the allocating thread's cache - so the thread cache hit rate is 1 - (refills / allocations).
+void
+ExecMetrics::writePoolMetrics
+(
+    MetricsWriter* const    pWriter
+)
+{
+    std::vector<FixedBlockPool*> pools;
+    FixedBlockPool::getPools( &pools );
+
+    std::vector<FixedBlockPool::Statistics> stats;
+    for ( INDEX px = 0; px < pools.size(); ++px )
+        stats.push_back( pools[px]->getStatistics() );
+
+    MetricsWriter::LABELS labels( 1 );
+    labels[0].first = "pool";
+
+    pWriter->describe( "em2200_block_pool_allocations_total",
+                       MetricsWriter::TYPE_COUNTER,
+                       "Blocks allocated from the pool (thread cache counts are folded in periodically)" );
+    for ( INDEX px = 0; px < pools.size(); ++px )
+    {
+        labels[0].second = pools[px]->getName();
+        pWriter->writeSample( "em2200_block_pool_allocations_total", labels, stats[px].m_AllocationCount );
+    }
+
+    pWriter->describe( "em2200_block_pool_thread_cache_refills_total",
+                       MetricsWriter::TYPE_COUNTER,
+                       "Thread cache misses, each of which refilled the cache from the pool" );
+    for ( INDEX px = 0; px < pools.size(); ++px )
+    {
+        labels[0].second = pools[px]->getName();
+        pWriter->writeSample( "em2200_block_pool_thread_cache_refills_total", labels, stats[px].m_RefillCount );
+    }
+
+    pWriter->describe( "em2200_block_pool_blocks",
+                       MetricsWriter::TYPE_GAUGE,
+                       "Blocks obtained from the heap by the pool" );
+    for ( INDEX px = 0; px < pools.size(); ++px )
+    {
+        labels[0].second = pools[px]->getName();
+        pWriter->writeSample( "em2200_block_pool_blocks", labels, stats[px].m_BlockCount );
+    }
+}
+
+
+//  writeRunMetrics()
+//
+//  Runs in each state
+void
+ExecMetrics::writeRunMetrics
+(
+    Exec* const             pExec,
+    MetricsWriter* const    pWriter
+)
+{
+    pWriter->describe( "em2200_runs", MetricsWriter::TYPE_GAUGE, "Runs known to the exec, by run state" );
+
+    MetricsWriter::LABELS labels( 1 );
+    labels[0].first = "state";
+    for ( INDEX sx = 0; sx < RunRegistry::STATE_COUNT; ++sx )
+    {
+        RunInfo::State state = static_cast<RunInfo::State>( sx );
+        labels[0].second = RunInfo::getStateString( state );
+        pWriter->writeSample( "em2200_runs", labels, COUNT64( pExec->getRunCount( state ) ) );
+    }
+}
+
+
+//  writeThreadMetrics()
+//
+//  Thread counts, for the process and for the worker pool
+void
+ExecMetrics::writeThreadMetrics
+(
+    MetricsWriter* const    pWriter
+)
+{
+    pWriter->describe( "em2200_host_threads", MetricsWriter::TYPE_GAUGE, "Threads in the emulator process" );
+    pWriter->writeSample( "em2200_host_threads", COUNT64( getHostThreadCount() ) );
+
+    WorkerPool::Statistics poolStats = WorkerPool::getInstance()->getStatistics();
+    pWriter->describe( "em2200_worker_pool_carriers",
+                       MetricsWriter::TYPE_GAUGE,
+                       "Carrier threads in the shared worker pool" );
+    pWriter->writeSample( "em2200_worker_pool_carriers", COUNT64( poolStats.m_CarrierCount ) );
+    pWriter->describe( "em2200_worker_pool_workers",
+                       MetricsWriter::TYPE_GAUGE,
+                       "Workers currently scheduled on the shared worker pool" );
+    pWriter->writeSample( "em2200_worker_pool_workers", COUNT64( poolStats.m_WorkerCount ) );
+    pWriter->describe( "em2200_worker_pool_steps_total",
+                       MetricsWriter::TYPE_COUNTER,
+                       "Worker steps executed by the shared worker pool" );
+    pWriter->writeSample( "em2200_worker_pool_steps_total", poolStats.m_StepCount );
+
+    VirtualClock::Statistics clockStats = VirtualClock::getInstance()->getStatistics();
+    pWriter->describe( "em2200_clock_participant_threads",
+                       MetricsWriter::TYPE_GAUGE,
+                       "Threads taking part in VirtualClock idle detection" );
+    pWriter->writeSample( "em2200_clock_participant_threads", COUNT64( clockStats.m_ThreadCount ) );
+}
+
+
+
+//  public statics
+
+//  write()
+//
+//  Writes all the metrics we know about.  pExec may be null, if no exec is loaded - in which case we can only
+//  say so, along with the block pool and system log metrics (which outlive any one exec).
+//  The caller is responsible for ensuring that the Exec is not deleted while we are at work.
+void
+ExecMetrics::write
+(
+    Exec* const             pExec,
+    MetricsWriter* const    pWriter
+)
+{
+    pWriter->describe( "em2200_exec_status",
+                       MetricsWriter::TYPE_GAUGE,
+                       "1 for the current exec status" );
+    MetricsWriter::LABELS labels( 1 );
+    labels[0].first = "status";
+    labels[0].second = pExec ? Exec::getStatusString( pExec->getStatus() ) : "Not loaded";
+    pWriter->writeSample( "em2200_exec_status", labels, COUNT64( 1 ) );
+
+    writePoolMetrics( pWriter );
+    writeLogMetrics( pWriter );
+    if ( pExec == 0 )
+        return;
+
+    writeThreadMetrics( pWriter );
+    writeRunMetrics( pExec, pWriter );
+    writeConsoleMetrics( pExec, pWriter );
+    writeIoMetrics( pExec, pWriter );
+    writeLockMetrics( pExec, pWriter );
+}
+
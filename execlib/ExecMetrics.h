@@ -0,0 +1,43 @@
+//  ExecMetrics.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Gathers exec-wide metrics for publication via a MetricsWriter (e.g., by an HTTP /metrics endpoint).
+//  Everything here is read from counters and histograms which are maintained anyway - publishing takes a few
+//  short-lived locks, but does nothing to slow down the code being measured.
+
+
+
+#ifndef     EXECLIB_EXEC_METRICS_H
+#define     EXECLIB_EXEC_METRICS_H
+
+
+
+#include    "Exec.h"
+
+
+
+class   ExecMetrics
+{
+private:
+    static COUNT                getHostThreadCount();
+    static void                 writeConsoleMetrics( Exec* const            pExec,
+                                                     MetricsWriter* const   pWriter );
+    static void                 writeIoMetrics( Exec* const             pExec,
+                                                MetricsWriter* const    pWriter );
+    static void                 writeLockMetrics( Exec* const           pExec,
+                                                  MetricsWriter* const  pWriter );
+    static void                 writeLogMetrics( MetricsWriter* const pWriter );
+    static void                 writePoolMetrics( MetricsWriter* const pWriter );
+    static void                 writeRunMetrics( Exec* const            pExec,
+                                                 MetricsWriter* const   pWriter );
+    static void                 writeThreadMetrics( MetricsWriter* const pWriter );
+
+public:
+    static void                 write( Exec* const          pExec,
+                                       MetricsWriter* const pWriter );
+};
+
+
+
+#endif
+
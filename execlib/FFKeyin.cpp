@@ -117,7 +117,9 @@ FFKeyin::handler()
     }
 
     //  TODO:CNS Display any such files assigned to common-name sections
-    bool foundEntry = false;
+    //  We only read the RunInfo objects, so we attach them shared - and we collect the results to be displayed
+    //  once we let go, since the console manager may attach the exec RunInfo (possibly one of these) exclusively.
+    LSTRING results;
 
     //  Get list of RunIds from EXEC, then check the RunInfo objects for file assignments
     LSTRING runIdList;
@@ -126,7 +128,7 @@ FFKeyin::handler()
     {
         //  Due to synchronicity, the Run might no longer be accessible...
         //  Try to get the pointer, and attach, then check whether we actually got it.
-        RunInfo* pRunInfo = m_pExec->getRunInfo( *its, true );
+        RunInfo* pRunInfo = m_pExec->getRunInfoShared( *its );
         if ( pRunInfo )
         {
             //  Get container of FacilityItems, then iterate over each
@@ -144,22 +146,24 @@ FFKeyin::handler()
                     if ( (m_AbsoluteCycle > 0) && (m_AbsoluteCycle != pFacItem->getAbsoluteFileCycle()) )
                         continue;
 
-                    //  We have a match - display the result
-                    foundEntry = true;
+                    //  We have a match - save the result
                     std::stringstream consStrm;
                     consStrm << "RUN:  " << pRunInfo->getActualRunId() << " HAS "
                             << m_Qualifier << "*" << m_Filename
                             << "(" << pFacItem->getAbsoluteFileCycle() << ")";
-                    m_pConsoleManager->postReadOnlyMessage( consStrm.str(), m_Routing, m_pExec->getRunInfo() );
+                    results.push_back( consStrm.str() );
                 }
             }
 
-            pRunInfo->detach();
+            pRunInfo->detachShared();
         }
     }
 
+    for ( LCITSTRING itr = results.begin(); itr != results.end(); ++itr )
+        m_pConsoleManager->postReadOnlyMessage( *itr, m_Routing, m_pExec->getRunInfo() );
+
     //  Make sure user isn't left with no results whatsoever...
-    if ( !foundEntry )
+    if ( results.empty() )
         m_pConsoleManager->postReadOnlyMessage( "NO ENTRIES FOUND FOR FF KEYIN", m_Routing, m_pExec->getRunInfo() );
 }
 
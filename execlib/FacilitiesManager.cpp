@@ -1967,6 +1967,7 @@ FacilitiesManager::FacilitiesManager
 :ExecManager( pExec ),
 m_pMFDManager( dynamic_cast<MFDManager*>( pExec->getManager( Exec::MID_MFD_MANAGER ) ) )
 {
+    MISCLIB_SET_LOCK_NAME( "FacilitiesManager" );
     //  Load configuration tags
     m_DefaultMaxGranules = 0;
     m_ReleaseUnusedReserve = true;
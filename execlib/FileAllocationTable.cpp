@@ -7,6 +7,48 @@
 
 
 
+//  statics
+
+FixedBlockPool  FileAllocationTable::DeviceAreaDescriptor::m_Pool( "DeviceAreaDescriptors",
+                                                                   sizeof(FileAllocationTable::DeviceAreaDescriptor) );
+
+
+
+//  DeviceAreaDescriptor
+
+//  operator new()
+//
+//  DADs are allocated from a fixed-size pool rather than the general heap.
+void*
+FileAllocationTable::DeviceAreaDescriptor::operator new
+(
+    size_t          size
+)
+{
+    if ( size != sizeof(DeviceAreaDescriptor) )
+        return ::operator new( size );
+    return m_Pool.allocate();
+}
+
+
+//  operator delete()
+//
+//  Sized, so that anything operator new() took from the general heap goes back there rather than to the pool.
+void
+FileAllocationTable::DeviceAreaDescriptor::operator delete
+(
+    void*           pObject,
+    size_t          size
+)
+{
+    if ( size != sizeof(DeviceAreaDescriptor) )
+        ::operator delete( pObject );
+    else
+        m_Pool.release( pObject );
+}
+
+
+
 //  private methods
 
 
@@ -231,7 +273,7 @@ FileAllocationTable::convertTrackId
     TRACK_ID* const     pDeviceRelativeTrackId
 ) const
 {
-    lock();
+    lockShared();
 
     for ( CITFAENTRIES itfae = m_Entries.begin(); itfae != m_Entries.end(); ++itfae )
     {
@@ -243,12 +285,12 @@ FileAllocationTable::convertTrackId
         {
             *pLDATIndex = itfae->second.m_LDATIndex;
             *pDeviceRelativeTrackId = itfae->second.m_DeviceTrackId + offset;
-            unlock();
+            unlockShared();
             return true;
         }
     }
 
-    unlock();
+    unlockShared();
     return false;
 }
 
@@ -264,7 +306,7 @@ FileAllocationTable::dump
     const std::string&  fileIdentifier
 ) const
 {
-    lock();
+    lockShared();
 
     stream << prefix << "FileAllocationTable for " << fileIdentifier
             << "  MainItem0=0" << std::oct << std::setw(12) << std::setfill('0') << m_MainItem0Addr
@@ -312,7 +354,7 @@ FileAllocationTable::dump
         }
     }
 
-    unlock();
+    unlockShared();
 }
 
 
@@ -323,12 +365,12 @@ TRACK_COUNT
 FileAllocationTable::getAllocatedTrackCount() const
 {
     TRACK_COUNT count = 0;
-    lock();
+    lockShared();
 
     for ( CITFAENTRIES itfae = m_Entries.begin(); itfae != m_Entries.end(); ++itfae )
         count += itfae->second.m_TrackCount;
 
-    unlock();
+    unlockShared();
     return count;
 }
 
@@ -365,7 +407,7 @@ FileAllocationTable::getFileAllocationEntries
     if ( trackCount == 0 )
         return;
 
-    lock();
+    lockShared();
 
     //  Set up working values which we can loop over and modify.
     TRACK_ID workingTrackId = firstTrackId;
@@ -438,7 +480,7 @@ FileAllocationTable::getFileAllocationEntries
         }
     }
 
-    unlock();
+    unlockShared();
 }
 
 
@@ -447,7 +489,7 @@ TRACK_ID
 FileAllocationTable::getHighestTrackAssigned() const
 {
     TRACK_ID trackId = 0;
-    lock();
+    lockShared();
 
     if ( !m_Entries.empty() )
     {
@@ -456,7 +498,7 @@ FileAllocationTable::getHighestTrackAssigned() const
         trackId = itfae->first + itfae->second.m_TrackCount - 1;
     }
 
-    unlock();
+    unlockShared();
     return trackId;
 }
 
@@ -11,7 +11,7 @@
 
 
 
-class   FileAllocationTable : public Lockable
+class   FileAllocationTable : public SharedLockable
 {
 public:
     class   DeviceAreaDescriptor
@@ -42,6 +42,8 @@ public:
         bool                    m_IsDeleted;        //  This DAD is no longer needed, and should be deallocated
         bool                    m_IsUpdated;        //  This DAD has been updated and needs to be written to MFD
 
+        static FixedBlockPool   m_Pool;             //  DADs come and go in large numbers - keep them off the general heap
+
         inline Word36*          entryAddress( const INDEX ex )              { return &(m_Data[(3 * ex) + 4]); }
 
     public:
@@ -51,6 +53,10 @@ public:
             m_IsUpdated( false )
         {}
 
+        static void*            operator new( size_t size );
+        static void             operator delete( void*  pObject,
+                                                 size_t size );
+
         inline const Word36*    getData() const                             { return m_Data; }
         inline DSADDR           getDSAddress() const                        { return m_DSAddress; }
         inline const Word36*    getEntry( const INDEX ex ) const            { return &(m_Data[(3 * ex) + 4]); }
@@ -0,0 +1,262 @@
+//  IOKeyin.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Handles the IO keyin
+//
+//  Format:
+//      IO[,DEV] [ device_name[,...] ]
+//      IO,PATH [ device_name[,...] ]
+//      IO,CM [ channel_module_name[,...] ]
+//      IO,RESET
+//
+//  Child IO latency is measured by IoManager from the time a channel program is routed to an IOP,
+//  until it is seen to be complete.  Queue depth is the number of child IOs currently outstanding.
+
+
+
+#include    "execlib.h"
+
+
+
+//  private / protected methods
+
+//  getLatencyString()
+//
+//  Formats the common part of a line of output for one histogram
+std::string
+IOKeyin::getLatencyString
+(
+    const LatencyHistogram::Snapshot&   snapshot
+) const
+{
+    std::stringstream strm;
+    strm << " IOS=" << std::dec << snapshot.m_Count
+        << " P50=" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 50.0 ) )
+        << " P99=" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 99.0 ) )
+        << " MAX=" << LatencyHistogram::getDurationString( snapshot.m_MaxMicros );
+    return strm.str();
+}
+
+
+//  handleCM()
+//
+//  Displays channel module latencies - total time from the channel program being queued until it completes,
+//  and the time spent waiting for the device to accept it.
+//      {cm} IOS=n P50=t P99=t MAX=t WAIT P99=t QD=n
+void
+IOKeyin::handleCM() const
+{
+    DeviceManager::NODE_IDS nodeIds;
+    m_pDeviceManager->getChannelModuleIdentifiers( &nodeIds );
+    for ( DeviceManager::CITNODE_IDS itid = nodeIds.begin(); itid != nodeIds.end(); ++itid )
+    {
+        if ( !isSelected( *itid ) )
+            continue;
+
+        const DeviceManager::ChannelModuleEntry* pEntry = m_pDeviceManager->getChannelModuleEntry( *itid );
+        ChannelModule* pChannelModule = dynamic_cast<ChannelModule*>( pEntry->m_pNode );
+        LatencyHistogram::Snapshot waitSnapshot = pChannelModule->getWaitHistogram().getSnapshot();
+
+        std::stringstream strm;
+        strm << m_pDeviceManager->getNodeName( *itid )
+            << getLatencyString( pChannelModule->getTotalHistogram().getSnapshot() )
+            << " WAIT P99=" << LatencyHistogram::getDurationString( waitSnapshot.getPercentileMicros( 99.0 ) )
+            << " QD=" << std::dec << pChannelModule->getQueueDepth();
+        m_pConsoleManager->postReadOnlyMessage( strm.str(), m_Routing, m_pExec->getRunInfo() );
+    }
+}
+
+
+//  handleDevice()
+//
+//  Displays child IO latencies by device, along with the device's own service time.
+//  Devices which have not done any IO are not shown.
+//      {device} IOS=n P50=t P99=t MAX=t QD=n SVC P99=t
+//      MASS REQ IOS=n P50=t P99=t MAX=t
+//      TAPE REQ IOS=n P50=t P99=t MAX=t
+void
+IOKeyin::handleDevice() const
+{
+    IoManager::DEVICELATENCIES latencies;
+    m_pIoManager->getDeviceLatencies( &latencies );
+    for ( IoManager::CITDEVICELATENCIES itdl = latencies.begin(); itdl != latencies.end(); ++itdl )
+    {
+        if ( !isSelected( itdl->first ) )
+            continue;
+
+        std::stringstream strm;
+        strm << m_pDeviceManager->getNodeName( itdl->first )
+            << getLatencyString( itdl->second->m_Histogram.getSnapshot() )
+            << " QD=" << std::dec << itdl->second->m_Outstanding;
+
+        const DeviceManager::DeviceEntry* pEntry = m_pDeviceManager->getDeviceEntry( itdl->first );
+        const Device* pDevice = dynamic_cast<const Device*>( pEntry->m_pNode );
+        if ( pDevice )
+        {
+            LatencyHistogram::Snapshot snapshot = pDevice->getServiceHistogram().getSnapshot();
+            strm << " SVC P99=" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 99.0 ) );
+        }
+
+        m_pConsoleManager->postReadOnlyMessage( strm.str(), m_Routing, m_pExec->getRunInfo() );
+    }
+
+    if ( m_Parameters.empty() )
+    {
+        std::string msg = "MASS REQ" + getLatencyString( m_pIoManager->getMassStorageRequestHistogram().getSnapshot() );
+        m_pConsoleManager->postReadOnlyMessage( msg, m_Routing, m_pExec->getRunInfo() );
+        msg = "TAPE REQ" + getLatencyString( m_pIoManager->getTapeRequestHistogram().getSnapshot() );
+        m_pConsoleManager->postReadOnlyMessage( msg, m_Routing, m_pExec->getRunInfo() );
+    }
+}
+
+
+//  handlePath()
+//
+//  Displays child IO latencies by path
+//      {device}/{iop}/{cm}/{controller} IOS=n P50=t P99=t MAX=t QD=n
+void
+IOKeyin::handlePath() const
+{
+    IoManager::PATHLATENCIES latencies;
+    m_pIoManager->getPathLatencies( &latencies );
+    for ( IoManager::CITPATHLATENCIES itpl = latencies.begin(); itpl != latencies.end(); ++itpl )
+    {
+        const DeviceManager::Path* pPath = itpl->first;
+        if ( !isSelected( pPath->m_DeviceIdentifier ) )
+            continue;
+
+        std::stringstream strm;
+        strm << m_pDeviceManager->getNodeName( pPath->m_DeviceIdentifier )
+            << "/" << m_pDeviceManager->getNodeName( pPath->m_IOPIdentifier )
+            << "/" << m_pDeviceManager->getNodeName( pPath->m_ChannelModuleIdentifier )
+            << "/" << m_pDeviceManager->getNodeName( pPath->m_ControllerIdentifier )
+            << getLatencyString( itpl->second->m_Histogram.getSnapshot() )
+            << " QD=" << std::dec << itpl->second->m_Outstanding;
+        m_pConsoleManager->postReadOnlyMessage( strm.str(), m_Routing, m_pExec->getRunInfo() );
+    }
+}
+
+
+//  handleReset()
+//
+//  Discards all latency information kept by IoManager, the channel modules, and the devices
+void
+IOKeyin::handleReset() const
+{
+    m_pIoManager->resetLatencies();
+
+    DeviceManager::NODE_IDS nodeIds;
+    m_pDeviceManager->getChannelModuleIdentifiers( &nodeIds );
+    for ( DeviceManager::CITNODE_IDS itid = nodeIds.begin(); itid != nodeIds.end(); ++itid )
+    {
+        ChannelModule* pChannelModule =
+            dynamic_cast<ChannelModule*>( m_pDeviceManager->getChannelModuleEntry( *itid )->m_pNode );
+        pChannelModule->getTotalHistogram().reset();
+        pChannelModule->getWaitHistogram().reset();
+    }
+
+    nodeIds.clear();
+    m_pDeviceManager->getDeviceIdentifiers( &nodeIds );
+    for ( DeviceManager::CITNODE_IDS itid = nodeIds.begin(); itid != nodeIds.end(); ++itid )
+    {
+        Device* pDevice = dynamic_cast<Device*>( m_pDeviceManager->getDeviceEntry( *itid )->m_pNode );
+        if ( pDevice )
+            pDevice->getServiceHistogram().reset();
+    }
+
+    m_pConsoleManager->postReadOnlyMessage( "IO LATENCIES RESET", m_Routing, m_pExec->getRunInfo() );
+}
+
+
+//  isAllowed()
+//
+//  Returns true if this keyin is allowed
+bool
+IOKeyin::isAllowed() const
+{
+    switch ( m_pExec->getStatus() )
+    {
+    case Exec::ST_SYS:
+    case Exec::ST_RUNNING:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+//  isSelected()
+//
+//  Returns true if the operator named no components, or named the given one
+bool
+IOKeyin::isSelected
+(
+    const DeviceManager::NODE_ID    nodeIdentifier
+) const
+{
+    if ( m_Parameters.empty() )
+        return true;
+
+    const std::string& nodeName = m_pDeviceManager->getNodeName( nodeIdentifier );
+    for ( INDEX px = 0; px < m_Parameters.size(); ++px )
+    {
+        if ( m_Parameters[px].compareNoCase( nodeName ) == 0 )
+            return true;
+    }
+
+    return false;
+}
+
+
+//  handler()
+//
+//  Called from Keyin base class worker() function
+void
+IOKeyin::handler()
+{
+    //  Make sure the named components exist, so that a typo does not just produce no output
+    for ( INDEX px = 0; px < m_Parameters.size(); ++px )
+    {
+        if ( m_pDeviceManager->getNodeEntry( m_Parameters[px] ) == 0 )
+        {
+            std::string msg = "IO KEYIN - " + m_Parameters[px] + " DOES NOT EXIST, INPUT IGNORED";
+            m_pConsoleManager->postReadOnlyMessage( msg, m_Routing, m_pExec->getRunInfo() );
+            return;
+        }
+    }
+
+    if ( m_Option.empty() || (m_Option.compareNoCase( "DEV" ) == 0) )
+        handleDevice();
+    else if ( m_Option.compareNoCase( "PATH" ) == 0 )
+        handlePath();
+    else if ( m_Option.compareNoCase( "CM" ) == 0 )
+        handleCM();
+    else if ( m_Option.compareNoCase( "RESET" ) == 0 )
+    {
+        if ( m_Parameters.size() > 0 )
+            displayParametersNotAllowed();
+        else
+            handleReset();
+    }
+    else
+        displayOptionNotAllowed();
+}
+
+
+
+// constructors / destructors
+
+IOKeyin::IOKeyin
+(
+    Exec* const                     pExec,
+    const SuperString&              KeyinId,
+    const SuperString&              Option,
+    const std::vector<SuperString>& Parameters,
+    const Word36&                   Routing
+)
+:KeyinActivity( pExec, KeyinId, Option, Parameters, Routing )
+{
+    m_pDeviceManager = dynamic_cast<DeviceManager*>( m_pExec->getManager( Exec::MID_DEVICE_MANAGER ) );
+    m_pIoManager = dynamic_cast<IoManager*>( m_pExec->getManager( Exec::MID_IO_MANAGER ) );
+}
+
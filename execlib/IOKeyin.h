@@ -0,0 +1,48 @@
+//  IOKeyin.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  IO keyin handler - displays IO latency and queue depth for devices, paths, and channel modules
+
+
+
+#ifndef     EXECLIB_IO_KEYIN_H
+#define     EXECLIB_IO_KEYIN_H
+
+
+
+#include    "DeviceManager.h"
+#include    "Exec.h"
+#include    "IoManager.h"
+#include    "KeyinActivity.h"
+
+
+
+class   IOKeyin : public KeyinActivity
+{
+private:
+    DeviceManager*              m_pDeviceManager;
+    IoManager*                  m_pIoManager;
+
+    std::string                 getLatencyString( const LatencyHistogram::Snapshot& snapshot ) const;
+    void                        handleCM() const;
+    void                        handleDevice() const;
+    void                        handlePath() const;
+    void                        handleReset() const;
+    bool                        isSelected( const DeviceManager::NODE_ID nodeIdentifier ) const;
+
+    // KeyinThread interface
+    void                        handler();
+    bool                        isAllowed() const;
+
+public:
+    IOKeyin( Exec* const                        pExec,
+             const SuperString&                 KeyinId,
+             const SuperString&                 Option,
+             const std::vector<SuperString>&    Params,
+             const Word36&                      Routing );
+};
+
+
+
+#endif
+
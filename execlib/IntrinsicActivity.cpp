@@ -11,58 +11,101 @@
 
 //  local statics
 
+const IntrinsicActivity::STATE      IntrinsicActivity::m_InitialState;
+const IntrinsicActivity::STATE      IntrinsicActivity::m_TerminalState;
+
 
 
 //	private / protected methods
 
 //	worker()
 //
-//	Main working code
+//	Main working code, for when we run on a thread of our own.
+//  Steps through the state machine, delaying in small increments between states - a signal ends the delay.
 void
     IntrinsicActivity::worker()
 {
     m_CurrentState = m_InitialState;
-    while ( !isWorkerTerminating() )
+    m_TerminalHandled = false;
+    while ( true )
     {
-        //  Ending state?
-        if ( m_CurrentState == m_TerminalState )
+        COUNT32 delayRemaining = workerStep();
+        if ( delayRemaining == STEP_DONE )
+            break;
+
+        while ( (delayRemaining > 0) && (!isWorkerTerminating()) )
         {
-            Worker::workerSetTermFlag();
-            continue;
+            COUNT32 delayTime = (delayRemaining > m_DelayIncrement) ? m_DelayIncrement : delayRemaining;
+            if ( workerWait( delayTime ) )
+                break;
+            delayRemaining -= delayTime;
         }
+    }
+}
+
 
-        //  Find the StateEntry corresponding to the current state
-        CITSTATEENTRIES itse = m_StateEntries.find( m_CurrentState );
-        if ( itse == m_StateEntries.end() )
+//  workerStep()
+//
+//  Runs the handler for the current state, and advances to the next state.
+//  Returns the delay requested for the state, or STEP_DONE once we are terminating.
+COUNT32
+    IntrinsicActivity::workerStep()
+{
+    //  Ending state, or told to terminate?  Give the terminal state handler (if any) its one chance.
+    if ( isWorkerTerminating() || (m_CurrentState == m_TerminalState) )
+    {
+        Worker::workerSetTermFlag();
+        if ( m_pAwaitable )
         {
-            std::stringstream strm;
-            strm << getWorkerName() << " intrinsic activity state machine failure - no entry for state " << m_CurrentState;
-            SystemLog::write( strm.str() );
-            m_pExec->stopExec( Exec::SC_INTERNAL_ERROR );
-            Worker::workerSetTermFlag();
-            break;
+            m_pAwaitable->cancel();
+            delete m_pAwaitable;
+            m_pAwaitable = 0;
         }
 
-        //  Set next state and next delay values - the handler might override them.
-        //  Then call the handler under lock...
-        m_NextState = itse->second.m_NextState;
-        m_DelayMSec = itse->second.m_DelayMSec;
-        lock();
-        itse->second.m_Handler( this );
-        unlock();
-
-        //  Delay in small increments, if requested.
-        COUNT32 delayRemaining = m_DelayMSec;
-        while ( (delayRemaining > 0) && (!isWorkerTerminating()) )
+        CITSTATEENTRIES itse = m_StateEntries.find( m_TerminalState );
+        if ( !m_TerminalHandled && (itse != m_StateEntries.end()) && itse->second.m_Handler )
         {
-            COUNT32 delayTime = (delayRemaining > m_DelayIncrement) ? m_DelayIncrement : delayRemaining;
-            workerWait( delayTime );
-            delayRemaining -= delayTime;
+            lock();
+            itse->second.m_Handler( this );
+            unlock();
         }
+        m_TerminalHandled = true;
+        return STEP_DONE;
+    }
 
-        //  Update current state and we're done with this loop.
-        m_CurrentState = m_NextState;
+    //  Waiting on something?  If it isn't done, go back to sleep - we'll be signaled when it is.
+    //  Otherwise, carry on with the resume state (which is already our current state).
+    if ( m_pAwaitable )
+    {
+        if ( !m_pAwaitable->isReady() )
+            return m_AwaitRecheckMSec;
+        delete m_pAwaitable;
+        m_pAwaitable = 0;
     }
+
+    //  Find the StateEntry corresponding to the current state
+    CITSTATEENTRIES itse = m_StateEntries.find( m_CurrentState );
+    if ( itse == m_StateEntries.end() )
+    {
+        std::stringstream strm;
+        strm << getWorkerName() << " intrinsic activity state machine failure - no entry for state " << m_CurrentState;
+        SystemLog::write( strm.str() );
+        m_pExec->stopExec( Exec::SC_INTERNAL_ERROR );
+        Worker::workerSetTermFlag();
+        return STEP_DONE;
+    }
+
+    //  Set next state and next delay values - the handler might override them.
+    //  Then call the handler under lock...
+    m_NextState = itse->second.m_NextState;
+    m_DelayMSec = itse->second.m_DelayMSec;
+    lock();
+    itse->second.m_Handler( this );
+    unlock();
+
+    //  Update current state and we're done with this step.
+    m_CurrentState = m_NextState;
+    return m_DelayMSec;
 }
 
 
@@ -76,15 +119,55 @@ IntrinsicActivity::IntrinsicActivity
     RunInfo* const          pRunInfo
 )
 :Activity( pExec, activityName, pRunInfo ),
+m_pAwaitable( 0 ),
 m_CurrentState( m_InitialState ),
 m_DelayMSec( m_DelayIncrement ),
-m_NextState( m_TerminalState )
+m_NextState( m_TerminalState ),
+m_TerminalHandled( false )
 {
 }
 
 
 IntrinsicActivity::~IntrinsicActivity()
 {
+    delete m_pAwaitable;
+}
+
+
+
+//  protected methods
+
+//  awaitEvent()
+//
+//  For state handlers - starts the given awaitable, and arranges for the state machine to resume
+//  in the given state once it is ready.  We take ownership of the awaitable.
+void
+    IntrinsicActivity::awaitEvent
+    (
+    Awaitable* const    pAwaitable,
+    const STATE         resumeState
+    )
+{
+    assert( m_pAwaitable == 0 );
+    m_pAwaitable = pAwaitable;
+    m_NextState = resumeState;
+    m_DelayMSec = 0;
+    pAwaitable->start( this );
+}
+
+
+//  awaitTimer()
+//
+//  For state handlers - resumes in the given state after the given delay (or sooner, if signaled)
+void
+    IntrinsicActivity::awaitTimer
+    (
+    const COUNT32       delayMSec,
+    const STATE         resumeState
+    )
+{
+    m_NextState = resumeState;
+    m_DelayMSec = delayMSec;
 }
 
 
@@ -104,7 +187,8 @@ void
     )
 {
     stream << prefix << "IntrinsicActivity - CurrentState=" << m_CurrentState
-        << " NextState=" << m_NextState << " Delay=" << m_DelayMSec << "ms" << std::endl;
+        << " NextState=" << m_NextState << " Delay=" << m_DelayMSec << "ms"
+        << (m_pAwaitable ? " Awaiting" : "") << std::endl;
     stream << prefix << "  State Entries:" << std::endl;
     for ( CITSTATEENTRIES itse = m_StateEntries.begin(); itse != m_StateEntries.end(); ++itse )
     {
@@ -5,6 +5,15 @@
 //  must constantly check for exception conditions so they can shut down or divert as quickly as possible.
 //
 //  Derived classes may dispense with state machine handling by simply implementing their own worker.
+//
+//  Activities which establish state entries are steppable - they run one state per step on the shared
+//  WorkerPool rather than on a thread of their own, with each state's delay serving as the wait between steps.
+//  A handler established for m_TerminalState is invoked once, as the activity terminates.
+//
+//  A handler which needs to wait for a console reply (or a channel program) starts it with awaitEvent(),
+//  naming the state in which to resume; no thread is held while the activity waits.  Simple timed waits
+//  are awaitTimer().  A handler may still call code which waits synchronously (MFD disk IO, for instance) -
+//  that holds the pool carrier for the duration, and the pool covers for it with another.
 
 
 
@@ -17,6 +26,10 @@
 
 
 
+class   Awaitable;
+
+
+
 class IntrinsicActivity : public Activity 
 {
 public:
@@ -55,15 +68,20 @@ private:
     typedef STATEENTRIES::iterator              ITSTATEENTRIES;
     typedef STATEENTRIES::const_iterator        CITSTATEENTRIES;
 
+    Awaitable*                  m_pAwaitable;               //  What we are waiting upon, if anything
     STATE                       m_CurrentState;
     COUNT32                     m_DelayMSec;
     STATE                       m_NextState;
     STATEENTRIES                m_StateEntries;
+    bool                        m_TerminalHandled;
 
     const static COUNT32        m_DelayIncrement = 50;      // msec's
+    const static COUNT32        m_AwaitRecheckMSec = 1000;  // how often we look at an awaitable without being signaled
 
     //  Worker interface
+    virtual bool                isWorkerSteppable() const   { return !m_StateEntries.empty(); }
     virtual void                worker();
+    virtual COUNT32             workerStep();
 
 protected:
     IntrinsicActivity( Exec* const          pExec,
@@ -84,8 +102,14 @@ protected:
         m_StateEntries[triggerState] = StateEntry( handler, nextState, delayMSec );
     }
 
+    void                        awaitEvent( Awaitable* const    pAwaitable,
+                                            const STATE         resumeState );
+    void                        awaitTimer( const COUNT32       delayMSec,
+                                            const STATE         resumeState );
+
 public:
     inline STATE    getCurrentState() const                 { return m_CurrentState; }
+    inline bool     isAwaiting() const                      { return m_pAwaitable != 0; }
     inline void     setDelay( const COUNT32 delayMSec )     { m_DelayMSec = delayMSec; }
     inline void     setNextState( const STATE nextState )   { m_NextState = nextState; }
 };
@@ -9,16 +9,35 @@
 
 
 
-//	private / protected methods
+//	private / protected statics
 
+//  handlePoll()
+//
+//  Polls the IoManager - if it did anything, we come right back; otherwise we wait until signaled.
+//  New requests, child IO completions, and operator replies all signal us, so the delay is only a backstop.
 void
-IoActivity::worker()
+IoActivity::handlePoll
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    IoActivity* pActivity = dynamic_cast<IoActivity*>( pObject );
+    if ( pActivity->m_pIoManager->pollPendingRequests() )
+        pActivity->setDelay( 0 );
+}
+
+
+//  handleTerminate()
+//
+//  We are going away - operator replies to outstanding IO messages must no longer signal us.
+void
+IoActivity::handleTerminate
+(
+    IntrinsicActivity* const    pObject
+)
 {
-    while ( !isWorkerTerminating() )
-    {
-        if ( !m_pIoManager->pollPendingRequests() )
-            miscSleep( 50 );
-    }
+    IoActivity* pActivity = dynamic_cast<IoActivity*>( pObject );
+    pActivity->m_pIoManager->cancelConsoleMessages();
 }
 
 
@@ -33,6 +52,10 @@ IoActivity::IoActivity
 :IntrinsicActivity( pExec, "IoActivity", pExec->getRunInfo() ),
 m_pIoManager( pIoManager )
 {
+    //  IoManager signals us when it has something for us to do
+    m_pIoManager->setIoActivity( this );
+    establishStateEntry( POLL, handlePoll, POLL, 1000 );
+    establishStateEntry( m_TerminalState, handleTerminate, m_TerminalState );
 }
 
 
@@ -18,8 +18,15 @@
 class	IoActivity : public IntrinsicActivity
 {
 private:
+    enum LocalState
+    {
+        POLL                    = m_InitialState,
+    };
+
 	IoManager* const	        m_pIoManager;
-    void                        worker();
+
+    static void                 handlePoll( IntrinsicActivity* const pObject );
+    static void                 handleTerminate( IntrinsicActivity* const pObject );
 
 public:
 	IoActivity( Exec* const         pExec,
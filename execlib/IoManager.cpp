@@ -254,6 +254,59 @@ IoManager::detachChildBuffer
 }
 
 
+//  noteChildIoDone()
+//
+//  Records the latency of a child IO which has just completed, against its device and its path.
+//  Call under lock.
+void
+IoManager::noteChildIoDone
+(
+    RequestTracker* const   pTracker
+)
+{
+    COUNT64 micros = pTracker->m_StateMicros[RequestTracker::RTST_CHILD_IO_DONE]
+                     - pTracker->m_StateMicros[RequestTracker::RTST_CHILD_IO_IN_PROGRESS];
+
+    ITDEVICELATENCIES itdl = m_DeviceLatencies.find( pTracker->m_pChildIoPath->m_DeviceIdentifier );
+    if ( itdl != m_DeviceLatencies.end() )
+    {
+        itdl->second->m_Histogram.record( micros );
+        --itdl->second->m_Outstanding;
+    }
+
+    ITPATHLATENCIES itpl = m_PathLatencies.find( pTracker->m_pChildIoPath );
+    if ( itpl != m_PathLatencies.end() )
+    {
+        itpl->second->m_Histogram.record( micros );
+        --itpl->second->m_Outstanding;
+    }
+}
+
+
+//  noteChildIoStarted()
+//
+//  Counts a child IO which has just been routed, as outstanding against its device and its path.
+//  Call under lock.
+void
+IoManager::noteChildIoStarted
+(
+    RequestTracker* const   pTracker
+)
+{
+    const DeviceManager::Path* pPath = pTracker->m_pChildIoPath;
+
+    IoLatency*& pDeviceLatency = m_DeviceLatencies[pPath->m_DeviceIdentifier];
+    if ( pDeviceLatency == 0 )
+        pDeviceLatency = new IoLatency();
+    ++pDeviceLatency->m_Outstanding;
+
+    IoLatency*& pPathLatency = m_PathLatencies[pPath];
+    if ( pPathLatency == 0 )
+        pPathLatency = new IoLatency();
+    ++pPathLatency->m_Outstanding;
+}
+
+
 //  pollChildIoDone()
 //
 //  Redirector
@@ -322,7 +375,7 @@ IoManager::pollChildIoDoneMassStorage
 
         //  Go back to setup in case there is more to be done for this IO.
         //  Only MS IOs do this (see below, TAPE goes straight to completeTracker())
-        pTracker->m_State = RequestTracker::RTST_CHILD_IO_SETUP;
+        pTracker->setState( RequestTracker::RTST_CHILD_IO_SETUP );
         return true;
     }
 
@@ -433,7 +486,7 @@ IoManager::pollChildIoDoneMassStorage
     case ChannelModule::Status::INSUFFICIENT_BUFFERS:
         //  Silent retry
         pTracker->m_RetryFlag = true;
-        pTracker->m_State = RequestTracker::RTST_CHILD_IO_READY;
+        pTracker->setState( RequestTracker::RTST_CHILD_IO_READY );
         return false;
 
     case ChannelModule::Status::INVALID_CHANNEL_MODULE_ADDRESS:
@@ -607,7 +660,7 @@ IoManager::pollChildIoDoneTape
     case ChannelModule::Status::INSUFFICIENT_BUFFERS:
         //  Silent retry
         pTracker->m_RetryFlag = true;
-        pTracker->m_State = RequestTracker::RTST_CHILD_IO_READY;
+        pTracker->setState( RequestTracker::RTST_CHILD_IO_READY );
         return false;
 
     case ChannelModule::Status::INVALID_CHANNEL_MODULE_ADDRESS:
@@ -644,7 +697,8 @@ IoManager::pollChildIoInProgress
 {
     if ( pTracker->m_pChannelProgram->m_ChannelStatus != ChannelModule::Status::IN_PROGRESS )
     {
-        pTracker->m_State = RequestTracker::RTST_CHILD_IO_DONE;
+        pTracker->setState( RequestTracker::RTST_CHILD_IO_DONE );
+        noteChildIoDone( pTracker );
         return true;
     }
 
@@ -746,7 +800,8 @@ IoManager::pollChildIoReadyMassStorage
         m_pDeviceManager->getProcessorEntry( pTracker->m_pChildIoPath->m_IOPIdentifier );
     IOProcessor* pIOP = dynamic_cast<IOProcessor*>( pIOPEntry->m_pNode );
     pIOP->routeIo( pTracker->m_pChannelProgram );
-    pTracker->m_State = RequestTracker::RTST_CHILD_IO_IN_PROGRESS;
+    pTracker->setState( RequestTracker::RTST_CHILD_IO_IN_PROGRESS );
+    noteChildIoStarted( pTracker );
 
     return true;
 }
@@ -784,7 +839,8 @@ IoManager::pollChildIoReadyTape
         m_pDeviceManager->getProcessorEntry( pTracker->m_pChildIoPath->m_IOPIdentifier );
     IOProcessor* pIOP = dynamic_cast<IOProcessor*>( pIOPEntry->m_pNode );
     pIOP->routeIo( pTracker->m_pChannelProgram );
-    pTracker->m_State = RequestTracker::RTST_CHILD_IO_IN_PROGRESS;
+    pTracker->setState( RequestTracker::RTST_CHILD_IO_IN_PROGRESS );
+    noteChildIoStarted( pTracker );
 
     return true;
 }
@@ -909,7 +965,7 @@ IoManager::pollChildIoSetupMassStorage
         pTracker->m_pChannelProgram->m_Command = ChannelModule::Command::READ;
 
     //  Ready for the IO (well, as ready as we can get without a potentially necessary temp buffer
-    pTracker->m_State = RequestTracker::RTST_CHILD_IO_READY;
+    pTracker->setState( RequestTracker::RTST_CHILD_IO_READY );
     return true;
 }
 
@@ -960,7 +1016,7 @@ IoManager::pollChildIoSetupTape
     //  Update channel program for the IO (we won't do the path bit yet - we'll leave that for later).
     pTracker->m_pChannelProgram->m_Format = execGetIoTranslateFormat( pTracker->m_pTapeItem->getTapeFormat() );
     pTracker->m_pChannelProgram->m_AccessControlList = pTracker->m_pIoPacket->m_AccessControlList;
-    pTracker->m_State = RequestTracker::RTST_CHILD_IO_READY;
+    pTracker->setState( RequestTracker::RTST_CHILD_IO_READY );
     return true;
 }
 
@@ -1019,7 +1075,7 @@ IoManager::pollConsoleMessage
             delete pTracker->m_pConsoleMessageInfo;
             pTracker->m_pConsoleMessageInfo = 0;
             pTracker->m_RetryFlag = true;
-            pTracker->m_State = RequestTracker::RTST_CHILD_IO_READY;
+            pTracker->setState( RequestTracker::RTST_CHILD_IO_READY );
             return true;
         }
 
@@ -1143,7 +1199,7 @@ IoManager::pollNewMassStorage
     pTracker->m_NextWordAddress = pTracker->m_StartingWordAddress;
     pTracker->m_RemainingWordCount = pTracker->m_TotalWordCount;
 
-    pTracker->m_State = RequestTracker::RTST_CHILD_IO_SETUP;
+    pTracker->setState( RequestTracker::RTST_CHILD_IO_SETUP );
     return true;
 }
 
@@ -1234,7 +1290,7 @@ IoManager::pollNewTape
         }
     }
 
-    pTracker->m_State = RequestTracker::RTST_CHILD_IO_SETUP;
+    pTracker->setState( RequestTracker::RTST_CHILD_IO_SETUP );
     return true;
 }
 
@@ -1270,9 +1326,10 @@ IoManager::postConsoleMessage
                                                                         ConsoleManager::Group::IO_ACTIVITY,
                                                                         pConsInfo->m_Message,
                                                                         1 );
-    m_pConsoleManager->postReadReplyMessage( pConsInfo->m_pConsolePacket, false );
+    pConsInfo->m_pAwaitable = new ReadReplyAwaitable( m_pConsoleManager, pConsInfo->m_pConsolePacket );
+    pConsInfo->m_pAwaitable->start( m_pIoActivity );
     pTracker->m_pConsoleMessageInfo = pConsInfo;
-    pTracker->m_State = RequestTracker::RTST_CONSOLE_MESSAGE_PENDING;
+    pTracker->setState( RequestTracker::RTST_CONSOLE_MESSAGE_PENDING );
 }
 
 
@@ -1426,7 +1483,7 @@ IoManager::repostConsoleMessage
     const bool              prependQuery
 ) const
 {
-    delete pTracker->m_pConsoleMessageInfo->m_pConsolePacket;
+    pTracker->m_pConsoleMessageInfo->release();
 
     std::string message;
     if ( prependQuery )
@@ -1439,8 +1496,10 @@ IoManager::repostConsoleMessage
                                                   ConsoleManager::Group::IO_ACTIVITY,
                                                   message,
                                                   1 );
-    m_pConsoleManager->postReadReplyMessage( pTracker->m_pConsoleMessageInfo->m_pConsolePacket, false );
-    pTracker->m_State = RequestTracker::RTST_CONSOLE_MESSAGE_PENDING;
+    pTracker->m_pConsoleMessageInfo->m_pAwaitable =
+            new ReadReplyAwaitable( m_pConsoleManager, pTracker->m_pConsoleMessageInfo->m_pConsolePacket );
+    pTracker->m_pConsoleMessageInfo->m_pAwaitable->start( m_pIoActivity );
+    pTracker->setState( RequestTracker::RTST_CONSOLE_MESSAGE_PENDING );
 }
 
 
@@ -1614,13 +1673,41 @@ m_pConsoleManager( dynamic_cast<ConsoleManager*>( m_pExec->getManager( Exec::MID
 m_pDeviceManager( dynamic_cast<DeviceManager*>( m_pExec->getManager( Exec::MID_DEVICE_MANAGER ) ) ),
 m_pMFDManager( dynamic_cast<MFDManager*>( m_pExec->getManager( Exec::MID_MFD_MANAGER ) ) )
 {
+    MISCLIB_SET_LOCK_NAME( "IoManager" );
     m_pIoActivity = 0;
 }
 
 
+IoManager::~IoManager()
+{
+    for ( ITDEVICELATENCIES itdl = m_DeviceLatencies.begin(); itdl != m_DeviceLatencies.end(); ++itdl )
+        delete itdl->second;
+    for ( ITPATHLATENCIES itpl = m_PathLatencies.begin(); itpl != m_PathLatencies.end(); ++itpl )
+        delete itpl->second;
+}
+
+
 
 //  Public methods
 
+//  cancelConsoleMessages()
+//
+//  IoActivity is terminating - withdraw any outstanding operator messages, so that nothing signals it hereafter.
+//  The affected requests see the cancellation, and are aborted by pollConsoleMessage() if we are polled again.
+void
+IoManager::cancelConsoleMessages()
+{
+    lock();
+    for ( ITREQUESTS itr = m_PendingRequests.begin(); itr != m_PendingRequests.end(); ++itr )
+    {
+        ConsoleMessageInfo* pcmInfo = (*itr)->m_pConsoleMessageInfo;
+        if ( pcmInfo && pcmInfo->m_pAwaitable )
+            pcmInfo->m_pAwaitable->cancel();
+    }
+    unlock();
+}
+
+
 //  cleanup()
 void
 IoManager::cleanup()
@@ -1656,12 +1743,27 @@ IoManager::dump
     for ( ITCHILDBUFFERS itcb = m_ChildBuffersInUse.begin(); itcb != m_ChildBuffersInUse.end(); ++itcb )
         stream << "    0x" << std::hex << reinterpret_cast<void *>( *itcb ) << std::endl;
 
+    stream << "  Child IO latency by device:" << std::endl;
+    for ( CITDEVICELATENCIES itdl = m_DeviceLatencies.begin(); itdl != m_DeviceLatencies.end(); ++itdl )
+    {
+        LatencyHistogram::Snapshot snapshot = itdl->second->m_Histogram.getSnapshot();
+        stream << "    " << m_pDeviceManager->getNodeName( itdl->first )
+                << " IOs:" << std::dec << snapshot.m_Count
+                << " P50:" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 50.0 ) )
+                << " P99:" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 99.0 ) )
+                << " Max:" << LatencyHistogram::getDurationString( snapshot.m_MaxMicros )
+                << " Outstanding:" << itdl->second->m_Outstanding
+                << std::endl;
+    }
+
+    COUNT64 now = LatencyHistogram::getMicroseconds();
     stream << "  Pending Requests:" << std::endl;
     for ( CITREQUESTS itr = m_PendingRequests.begin(); itr != m_PendingRequests.end(); ++itr )
     {
         stream << "    Type:" << getRequestTrackerTypeString( (*itr)->m_Type )
                 << " State:" << getRequestTrackerStateString( (*itr)->m_State )
                 << " Retry:" << ((*itr)->m_RetryFlag ? "YES" : "NO")
+                << " Age:" << LatencyHistogram::getDurationString( now - (*itr)->m_StateMicros[RequestTracker::RTST_NEW] )
                 << std::endl;
 
         const IoPacket* pPkt = (*itr)->m_pIoPacket;
@@ -1733,6 +1835,37 @@ IoManager::dump
 }
 
 
+//  getDeviceLatencies()
+//
+//  Retrieves the child IO latency information for every device we have done IO to.
+//  The IoLatency objects belong to us, and last as long as we do.
+void
+IoManager::getDeviceLatencies
+(
+    DEVICELATENCIES* const  pContainer
+)
+{
+    lock();
+    *pContainer = m_DeviceLatencies;
+    unlock();
+}
+
+
+//  getPathLatencies()
+//
+//  Retrieves the child IO latency information for every path we have done IO over
+void
+IoManager::getPathLatencies
+(
+    PATHLATENCIES* const    pContainer
+)
+{
+    lock();
+    *pContainer = m_PathLatencies;
+    unlock();
+}
+
+
 //  pollPendingRequests()
 //
 //  Checks the list of pending requests to see if any of the need attention.
@@ -1799,13 +1932,31 @@ IoManager::pollPendingRequests()
 }
 
 
+//  resetLatencies()
+//
+//  Discards all latency information collected so far (but not the outstanding IO counts)
+void
+IoManager::resetLatencies()
+{
+    lock();
+    for ( ITDEVICELATENCIES itdl = m_DeviceLatencies.begin(); itdl != m_DeviceLatencies.end(); ++itdl )
+        itdl->second->m_Histogram.reset();
+    for ( ITPATHLATENCIES itpl = m_PathLatencies.begin(); itpl != m_PathLatencies.end(); ++itpl )
+        itpl->second->m_Histogram.reset();
+    unlock();
+
+    m_MassStorageRequestHistogram.reset();
+    m_TapeRequestHistogram.reset();
+}
+
+
 //  shutdown()
 //
 //  Exec would like to shut down
 void
 IoManager::shutdown()
 {
-    SystemLog::write("IoManager::shutdown()");
+    SYSTEM_LOG( IO, INFO, "IoManager::shutdown()" );
 }
 
 
@@ -1831,6 +1982,7 @@ IoManager::startIo
         else if ( pIoPacket->m_pFacItem->isSectorMassStorage() || pIoPacket->m_pFacItem->isWordMassStorage() )
             m_PendingRequests.push_back( new MassStorageRequestTracker( pIoPacket, m_pIoActivity ) );
         unlock();
+        m_pIoActivity->signal();
     }
 }
 
@@ -1841,7 +1993,7 @@ IoManager::startIo
 bool
 IoManager::startup()
 {
-    SystemLog::write("IoManager::startup()");
+    SYSTEM_LOG( IO, INFO, "IoManager::startup()" );
 
     //  Allocate buffers
     while ( m_ChildBuffersAvailable.size() < m_ConcurrentDiskIos )
@@ -1856,7 +2008,7 @@ IoManager::startup()
 void
 IoManager::terminate()
 {
-    SystemLog::write("IoManager::terminate()");
+    SYSTEM_LOG( IO, INFO, "IoManager::terminate()" );
 }
 
 
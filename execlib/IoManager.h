@@ -9,6 +9,7 @@
 
 
 #include    "Activity.h"
+#include    "Awaitable.h"
 #include    "ExecManager.h"
 #include    "DiskFacilityItem.h"
 #include    "FacilityItem.h"
@@ -24,6 +25,27 @@
 class   IoManager : public ExecManager
 {
 public:
+    //  Latency of child IOs for one device or one path - from the time a channel program is routed to the IOP
+    //  until we see it complete - along with the number of child IOs currently outstanding.
+    class   IoLatency
+    {
+    public:
+        LatencyHistogram        m_Histogram;
+        std::atomic<COUNT>      m_Outstanding;
+
+        IoLatency()
+            :m_Outstanding( 0 )
+        {}
+    };
+
+    typedef     std::map<DeviceManager::DEVICE_ID, IoLatency*>      DEVICELATENCIES;
+    typedef     DEVICELATENCIES::iterator                           ITDEVICELATENCIES;
+    typedef     DEVICELATENCIES::const_iterator                     CITDEVICELATENCIES;
+
+    typedef     std::map<const DeviceManager::Path*, IoLatency*>    PATHLATENCIES;
+    typedef     PATHLATENCIES::iterator                             ITPATHLATENCIES;
+    typedef     PATHLATENCIES::const_iterator                       CITPATHLATENCIES;
+
     class   IoPacket
     {
     public:
@@ -55,17 +77,30 @@ private:
     class   ConsoleMessageInfo
     {
     public:
+        ReadReplyAwaitable*                 m_pAwaitable;           //  Signals IoActivity upon the reply
         ConsoleManager::ReadReplyRequest*   m_pConsolePacket;
         std::string                         m_AcceptedResponses;    //  Accepted responses - e.g., "ABGM"
         std::string                         m_Message;
 
         ConsoleMessageInfo()
-            :m_pConsolePacket( 0 )
+            :m_pAwaitable( 0 ),
+            m_pConsolePacket( 0 )
         {}
 
         ~ConsoleMessageInfo()
         {
+            release();
+        }
+
+        //  Withdraws the message (if still outstanding) so that ConsoleManager forgets it, then deletes it
+        void release()
+        {
+            if ( m_pAwaitable )
+                m_pAwaitable->cancel();
+            delete m_pAwaitable;
             delete m_pConsolePacket;
+            m_pAwaitable = 0;
+            m_pConsolePacket = 0;
         }
     };
 
@@ -89,6 +124,8 @@ private:
             RTST_NEW,
         };
 
+        static const COUNT              STATE_COUNT = RTST_NEW + 1;
+
         enum Type
         {
             RTTYPE_MASS_STORAGE,
@@ -103,6 +140,7 @@ private:
                                                                 //      in the IO packet for B or G responses.
         bool                            m_RetryFlag;            //  true if we've failed at least one attempt at a child IO
         State                           m_State;
+        COUNT64                         m_StateMicros[STATE_COUNT];     //  host time at which we last entered each state
         const Type                      m_Type;
 
         RequestTracker( const RequestTracker::Type  type,
@@ -116,12 +154,22 @@ private:
             m_RetryFlag( false ),
             m_State( RTST_NEW ),
             m_Type( type )
-        {}
+        {
+            for ( INDEX sx = 0; sx < STATE_COUNT; ++sx )
+                m_StateMicros[sx] = 0;
+            m_StateMicros[RTST_NEW] = LatencyHistogram::getMicroseconds();
+        }
 
         virtual ~RequestTracker()
         {
             delete m_pChannelProgram;
         }
+
+        inline void setState( const State state )
+        {
+            m_State = state;
+            m_StateMicros[state] = LatencyHistogram::getMicroseconds();
+        }
     };
 
     class   MassStorageRequestTracker : public RequestTracker
@@ -189,10 +237,14 @@ private:
     CHILDBUFFERS                m_ChildBuffersAvailable;
     CHILDBUFFERS                m_ChildBuffersInUse;
     ConsoleManager* const       m_pConsoleManager;
+    DEVICELATENCIES             m_DeviceLatencies;
     DeviceManager* const        m_pDeviceManager;
     Activity*                   m_pIoActivity;
+    LatencyHistogram            m_MassStorageRequestHistogram;  //  RTST_NEW to RTST_COMPLETED
     MFDManager* const           m_pMFDManager;
+    PATHLATENCIES               m_PathLatencies;
     REQUESTS                    m_PendingRequests;
+    LatencyHistogram            m_TapeRequestHistogram;
 
     //  private static data
     static const COUNT          m_ConcurrentDiskIos = 16;       //  Some day this might be tunable...
@@ -202,6 +254,8 @@ private:
     void                        allocateSpace( MassStorageRequestTracker* const pTracker );
     bool                        attachChildBuffer( MassStorageRequestTracker* const pTracker );
     void                        detachChildBuffer( MassStorageRequestTracker* const pTracker );
+    void                        noteChildIoDone( RequestTracker* const pTracker );
+    void                        noteChildIoStarted( RequestTracker* const pTracker );
     bool                        pollChildIoDone( RequestTracker* const pTracker );
     bool                        pollChildIoDoneMassStorage( MassStorageRequestTracker* const pTracker );
     bool                        pollChildIoDoneTape( TapeRequestTracker* const pTracker );
@@ -223,11 +277,16 @@ private:
     void                        repostConsoleMessage( RequestTracker* const pRequestTracker,
                                                       const bool            prependQuery ) const;
 
-    inline void completeTracker( RequestTracker* const pTracker ) const
+    inline void completeTracker( RequestTracker* const pTracker )
     {
         pTracker->m_pIoPacket->m_pActivity->signal();
         pTracker->m_pIoPacket = 0;
-        pTracker->m_State = RequestTracker::RTST_COMPLETED;
+        pTracker->setState( RequestTracker::RTST_COMPLETED );
+
+        LatencyHistogram& histogram = (pTracker->m_Type == RequestTracker::RTTYPE_TAPE)
+                                        ? m_TapeRequestHistogram : m_MassStorageRequestHistogram;
+        histogram.record( pTracker->m_StateMicros[RequestTracker::RTST_COMPLETED]
+                          - pTracker->m_StateMicros[RequestTracker::RTST_NEW] );
     }
 
     //  private statics
@@ -238,11 +297,18 @@ private:
 
 public:
     IoManager( Exec* const pExec );
-    ~IoManager(){};
+    ~IoManager();
 
+    void                        cancelConsoleMessages();
+    void                        getDeviceLatencies( DEVICELATENCIES* const pContainer );
+    void                        getPathLatencies( PATHLATENCIES* const pContainer );
     bool                        pollPendingRequests();
+    void                        resetLatencies();
     void                        startIo( IoPacket* const pIoPacket );
 
+    inline LatencyHistogram&    getMassStorageRequestHistogram()    { return m_MassStorageRequestHistogram; }
+    inline LatencyHistogram&    getTapeRequestHistogram()           { return m_TapeRequestHistogram; }
+
     inline void setIoActivity( Activity* const pActivity )
     {
         m_pIoActivity = pActivity;
@@ -94,6 +94,8 @@ KeyinActivity::displayParametersNotAllowed() const
 void
     KeyinActivity::worker()
 {
+    TraceLog::Span span( TraceLog::EVENT_KEYIN, TraceLog::isEnabled() ? TraceLog::intern( m_KeyinId ) : 0 );
+
     if ( isAllowed() )
     {
         handler();
@@ -224,6 +226,8 @@ KeyinActivity::createKeyin
         return new FFKeyin( pExec, cmdString, optionString, paramStrings, routing );
     else if ( cmdString.compare( "FS" ) == 0 )
         return new FSKeyin( pExec, cmdString, optionString, paramStrings, routing );
+    else if ( cmdString.compare( "IO" ) == 0 )
+        return new IOKeyin( pExec, cmdString, optionString, paramStrings, routing );
     else if ( cmdString.compare( "MS" ) == 0 )
         return new MSKeyin( pExec, cmdString, optionString, paramStrings, routing );
     else if ( cmdString.compare( "PREP" ) == 0 )
@@ -242,7 +246,9 @@ KeyinActivity::createKeyin
         return new DollarBangKeyin( pExec, cmdString, optionString, paramStrings, routing );
     else if ( pExec->getConfiguration().getBoolValue( "EXKEYINS" ) )
     {
-        if ( cmdString.compare( "PREP" ) == 0 )
+        if ( cmdString.compare( "LG" ) == 0 )
+            return new LGKeyin( pExec, cmdString, optionString, paramStrings, routing );
+        else if ( cmdString.compare( "PREP" ) == 0 )
             return new PREPKeyin( pExec, cmdString, optionString, paramStrings, routing );
     }
 
@@ -0,0 +1,161 @@
+//	LGKeyin.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//	Handles the LG keyin
+//
+//  LG [STATUS]                         reports on the current (or most recent) load generator
+//  LG START {sessions} [{runs}]        opens {sessions} scripted demand runs at a time, until {runs} have been done
+//                                          (or until LG STOP, if {runs} is not given)
+//  LG STOP                             opens no more runs - the generator finishes once those in progress are done
+
+
+
+#include	"execlib.h"
+
+
+
+//	private / protected methods
+
+//  handleSTART()
+void
+LGKeyin::handleSTART()
+{
+    if ( (m_Parameters.size() < 2) || (m_Parameters.size() > 3) )
+    {
+        displayGeneralError();
+        return;
+    }
+
+    if ( !m_Parameters[1].isDecimalNumeric() || (m_Parameters[1].toDecimal() == 0)
+        || (m_Parameters[1].toDecimal() > LoadGeneratorActivity::MAX_SESSIONS) )
+    {
+        displayInvalidParameter();
+        return;
+    }
+
+    COUNT sessions = static_cast<COUNT>( m_Parameters[1].toDecimal() );
+    COUNT64 runs = 0;
+    if ( m_Parameters.size() == 3 )
+    {
+        if ( !m_Parameters[2].isDecimalNumeric() )
+        {
+            displayInvalidParameter();
+            return;
+        }
+        runs = m_Parameters[2].toDecimal();
+    }
+
+    //  Only one at a time.  The previous generator stays registered (for LG STATUS) until this one replaces it.
+    m_pExec->lock();
+    LoadGeneratorActivity* pActivity = m_pExec->getLoadGeneratorActivity();
+    if ( pActivity && !pActivity->isTerminated() )
+    {
+        m_pExec->unlock();
+        m_pConsoleManager->postReadOnlyMessage( "LG ALREADY ACTIVE", m_Routing, m_pExec->getRunInfo() );
+        return;
+    }
+
+    pActivity = new LoadGeneratorActivity( m_pExec, sessions, runs, m_Routing );
+    m_pExec->getRunInfo()->appendTaskActivity( pActivity );
+    m_pExec->setLoadGeneratorActivity( pActivity );
+    pActivity->start();
+    m_pExec->unlock();
+
+    std::stringstream strm;
+    strm << "LG STARTED " << sessions << " SESSIONS";
+    if ( runs )
+        strm << " " << runs << " RUNS";
+    m_pConsoleManager->postReadOnlyMessage( strm.str(), m_Routing, m_pExec->getRunInfo() );
+}
+
+
+//  handleSTATUS()
+void
+LGKeyin::handleSTATUS() const
+{
+    //  The generator is not reaped while it is registered, and cannot be replaced while we hold the exec lock
+    m_pExec->lock();
+    LoadGeneratorActivity* pActivity = m_pExec->getLoadGeneratorActivity();
+    if ( pActivity )
+        pActivity->postReport();
+    m_pExec->unlock();
+
+    if ( pActivity == 0 )
+        m_pConsoleManager->postReadOnlyMessage( "LG NOT ACTIVE", m_Routing, m_pExec->getRunInfo() );
+}
+
+
+//  handleSTOP()
+void
+LGKeyin::handleSTOP() const
+{
+    m_pExec->lock();
+    LoadGeneratorActivity* pActivity = m_pExec->getLoadGeneratorActivity();
+    bool stopping = pActivity && !pActivity->isTerminated();
+    if ( stopping )
+        pActivity->requestStop();
+    m_pExec->unlock();
+
+    if ( stopping )
+    {
+        m_pConsoleManager->postReadOnlyMessage( "LG STOPPING", m_Routing, m_pExec->getRunInfo() );
+    }
+    else
+        m_pConsoleManager->postReadOnlyMessage( "LG NOT ACTIVE", m_Routing, m_pExec->getRunInfo() );
+}
+
+
+//	isAllowed()
+//
+//	Returns true if this keyin is allowed
+bool
+LGKeyin::isAllowed() const
+{
+    return m_pExec->getStatus() == Exec::ST_RUNNING;
+}
+
+
+//	handler()
+//
+//	Called from Keyin base class worker() function
+void
+LGKeyin::handler()
+{
+    if ( m_Option.size() > 0 )
+    {
+        displayOptionNotAllowed();
+        return;
+    }
+
+    SuperString command = m_Parameters.empty() ? SuperString( "STATUS" ) : m_Parameters[0];
+    command.foldToUpperCase();
+    if ( command.compare( "START" ) == 0 )
+        handleSTART();
+    else if ( (command.compare( "STATUS" ) == 0) && (m_Parameters.size() <= 1) )
+        handleSTATUS();
+    else if ( (command.compare( "STOP" ) == 0) && (m_Parameters.size() == 1) )
+        handleSTOP();
+    else
+        displayGeneralError();
+}
+
+
+
+// constructors / destructors
+
+LGKeyin::LGKeyin
+(
+    Exec* const                     pExec,
+    const SuperString&              KeyinId,
+    const SuperString&              Option,
+    const std::vector<SuperString>& Parameters,
+    const Word36&                   Routing
+)
+:KeyinActivity( pExec, KeyinId, Option, Parameters, Routing )
+{
+}
+
+
+
+//	public methods
+
@@ -0,0 +1,40 @@
+//  LGKeyin.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  LG keyin handler - starts, stops, and reports on the synthetic demand load generator
+
+
+
+#ifndef     EXECLIB_LG_KEYIN_H
+#define     EXECLIB_LG_KEYIN_H
+
+
+
+#include    "Exec.h"
+#include    "KeyinActivity.h"
+
+
+
+class   LGKeyin : public KeyinActivity
+{
+private:
+    void                        handleSTART();
+    void                        handleSTATUS() const;
+    void                        handleSTOP() const;
+
+    // KeyinThread interface
+    void						handler();
+    bool						isAllowed() const;
+
+public:
+    LGKeyin( Exec* const                        pExec,
+             const SuperString&                 KeyinId,
+             const SuperString&                 Option,
+             const std::vector<SuperString>&    Params,
+             const Word36&                      Routing );
+};
+
+
+
+#endif
+
@@ -0,0 +1,486 @@
+//  LoadGeneratorActivity.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Drives scripted demand runs through control mode, and keeps the books on them.
+
+
+
+#include    "execlib.h"
+
+
+
+//  private methods
+
+//  drainPrint()
+//
+//  Discards whatever the run has put in PRINT$, as RSIManager::checkPrintBuffer() would after sending it to the terminal.
+//  Without this, the buffer fills and postToPrint() starts failing.
+//  Caller must have the RunInfo attached.
+void
+LoadGeneratorActivity::drainPrint
+(
+    DemandRunInfo* const    pRunInfo
+) const
+{
+    SymbiontBuffer* psbuff = pRunInfo->getSymbiontBufferPrint();
+    if ( psbuff )
+    {
+        while ( !psbuff->isExhausted() )
+        {
+            const Word36* pCWord = psbuff->readWord();
+            if ( pCWord->isNegative() )
+                psbuff->advanceReadIndex( pCWord->getS2() );
+            else
+                psbuff->advanceReadIndex( pCWord->getT1() );
+        }
+
+        psbuff->clear();
+    }
+}
+
+
+//  getImage()
+//
+//  Builds the control image for a deck step.  Catalogued files are unique to the run, so runs never contend.
+std::string
+LoadGeneratorActivity::getImage
+(
+    const Step          step,
+    const COUNT64       runSerial
+) const
+{
+    std::stringstream fileStrm;
+    fileStrm << "LOADGEN*F" << std::setw( 6 ) << std::setfill( '0' ) << (runSerial % 1000000) << ".";
+
+    switch ( step )
+    {
+    case STEP_ASG_T:    return "@ASG,T LGTEMP.";
+    case STEP_USE:      return "@USE LGUSE.,LGTEMP.";
+    case STEP_FREE_T:   return "@FREE LGTEMP.";
+    case STEP_CAT:      return "@CAT " + fileStrm.str();
+    case STEP_ASG_A:    return "@ASG,A " + fileStrm.str();
+    case STEP_FREE_D:   return "@FREE,D " + fileStrm.str();
+    case STEP_LOG:      return "@LOG LOAD GENERATOR";
+    case STEP_FIN:      return "@FIN";
+    default:            return "";
+    }
+}
+
+
+//  openRun()
+//
+//  Opens a new scripted demand run for the given session.
+//  The run executes under the exec's overhead user-id and account, with a profile like the one SecurityManager
+//  gives an ordinary demand user.
+//
+//  Returns:
+//      true if we opened a run
+bool
+LoadGeneratorActivity::openRun
+(
+    Session* const      pSession
+)
+{
+    SecurityManager::UserProfile profile;
+    profile.m_AllAccountsAllowed = true;
+    profile.m_CanAccessBatch = true;
+    profile.m_CanAccessDemand = true;
+    profile.m_CanAccessTIP = false;
+    profile.m_CanBypassRunCard = true;
+    profile.m_DefaultAccount = m_pExec->getRunInfo()->getAccountId();
+    profile.m_DemandTimeoutSeconds = 0;
+    profile.m_Privileged = false;
+    profile.m_UserId = m_pExec->getRunInfo()->getUserId();
+
+    std::stringstream strm;
+    strm << "LG" << std::setw( 3 ) << std::setfill( '0' ) << (pSession - &m_Sessions[0]);
+
+    COUNT64 startMicros = LatencyHistogram::getMicroseconds();
+    DemandRunInfo* pRunInfo = m_pExec->createScriptedDemandRun( this,
+                                                                profile,
+                                                                strm.str(),
+                                                                "LOAD",
+                                                                profile.m_DefaultAccount,
+                                                                "LOADGEN" );
+    if ( pRunInfo == 0 )
+    {
+        ++m_OpenFailures;
+        return false;
+    }
+
+    pSession->m_NextStep = 0;
+    pSession->m_pRunInfo = pRunInfo;
+    pSession->m_RunSerial = m_NextRunSerial++;
+    pSession->m_RunStartMicros = startMicros;
+    pSession->m_StatementPending = false;
+    ++m_RunsStarted;
+    return true;
+}
+
+
+//  pollSessions()
+//
+//  One pass over the sessions - opens runs for idle sessions, feeds READ$ for runs which want input,
+//  and lets go of runs which have finished.
+//
+//  Returns:
+//      true if we did anything, so that the caller can come right back
+bool
+LoadGeneratorActivity::pollSessions()
+{
+    bool result = false;
+    bool opening = !m_StopRequested && ((m_RunLimit == 0) || (m_RunsStarted < m_RunLimit));
+
+    for ( ITSESSIONS its = m_Sessions.begin(); its != m_Sessions.end(); ++its )
+    {
+        Session* pSession = &(*its);
+        if ( pSession->m_pRunInfo == 0 )
+        {
+            if ( opening && openRun( pSession ) )
+                result = true;
+            opening = !m_StopRequested && ((m_RunLimit == 0) || (m_RunsStarted < m_RunLimit));
+            continue;
+        }
+
+        DemandRunInfo* pRunInfo = pSession->m_pRunInfo;
+        COUNT64 now = LatencyHistogram::getMicroseconds();
+        pRunInfo->attach();
+        drainPrint( pRunInfo );
+
+        //  Finished?  Let go of it as RSIManager would - once we set RSI_DETACHED, the exec may delete it.
+        if ( pRunInfo->getState() == RunInfo::STATE_RSI_TERM )
+        {
+            if ( pSession->m_StatementPending )
+            {
+                m_StatementHistogram.record( now - pSession->m_StatementStartMicros );
+                m_StepHistograms[pSession->m_PendingStep].record( now - pSession->m_StatementStartMicros );
+            }
+
+            if ( pRunInfo->getRunConditionWord().anyPreviousTaskInError() )
+                ++m_ErrorRuns;
+            pRunInfo->setState( RunInfo::STATE_RSI_DETACHED );
+            pRunInfo->detach();
+
+            m_RunHistogram.record( now - pSession->m_RunStartMicros );
+            ++m_RunsCompleted;
+            pSession->m_pRunInfo = 0;
+            pSession->m_StatementPending = false;
+            result = true;
+            continue;
+        }
+
+        //  Still working on the last statement, or not in control mode?  Leave it be.
+        if ( (pRunInfo->getState() != RunInfo::STATE_ACTIVE)
+            || !pRunInfo->isInputAllowed()
+            || (pSession->m_NextStep >= STEP_COUNT) )
+        {
+            pRunInfo->detach();
+            continue;
+        }
+
+        if ( pSession->m_StatementPending )
+        {
+            m_StatementHistogram.record( now - pSession->m_StatementStartMicros );
+            m_StepHistograms[pSession->m_PendingStep].record( now - pSession->m_StatementStartMicros );
+            pSession->m_StatementPending = false;
+        }
+
+        //  The keyin is issued on the run's behalf, and costs it no statement.
+        Step step = static_cast<Step>( pSession->m_NextStep++ );
+        if ( step == STEP_KEYIN )
+        {
+            static const char* keyins[] = { "SS", "DJ", "FS MS" };
+            pRunInfo->detach();
+            m_pExec->createKeyin( m_Routing, keyins[pSession->m_RunSerial % 3] );
+            ++m_Keyins;
+            pRunInfo->attach();
+            step = static_cast<Step>( pSession->m_NextStep++ );
+        }
+
+        //  Put the image into READ$ exactly as RSIManager does for terminal input -
+        //  the buffer is empty whenever input is allowed, and the character set is ASCII.
+        std::string image = getImage( step, pSession->m_RunSerial );
+        SymbiontBuffer* psbuff = pRunInfo->getSymbiontBufferRead();
+        COUNT dataWords = image.size() / 4;
+        if ( image.size() % 4 )
+            ++dataWords;
+
+        Word36 cword;
+        cword.setT1( dataWords );
+        cword.setS6( SymbiontBuffer::CSET_ASCII );
+        psbuff->writeWord( cword );
+
+        Word36* pData = psbuff->getBuffer() + psbuff->getNextWrite();
+        miscStringToWord36Ascii( image, pData, dataWords );
+        psbuff->advanceWriteIndex( dataWords );
+
+        pRunInfo->setInputAllowed( false );
+        pRunInfo->detach();
+        m_pExec->signalCoarseScheduler();
+
+        pSession->m_PendingStep = step;
+        pSession->m_StatementPending = true;
+        pSession->m_StatementStartMicros = LatencyHistogram::getMicroseconds();
+        result = true;
+    }
+
+    return result;
+}
+
+
+//  postReportLocked()
+//
+//  Posts our figures to the console which started us.  Caller must hold our lock.
+//
+//  LG ACTIVE SESS nnn RUNS nnnn/nnnn ERR nnnn RUNS/MIN nnnn.n
+//  LG RUN N=nnnn P50=... P99=... MAX=...
+//  LG STMT N=nnnn P50=... P99=... MAX=...
+//  LG {step} N=nnnn MEAN=... P99=...           (one per statement type - facilities, MFD, and control)
+//  LG KEYINS nnnn OPENFAIL nnnn MS IO N=nnnn MEAN=...
+void
+LoadGeneratorActivity::postReportLocked() const
+{
+    ConsoleManager* pConsMgr = dynamic_cast<ConsoleManager*>( m_pExec->getManager( Exec::MID_CONSOLE_MANAGER ) );
+    RunInfo* pExecRunInfo = m_pExec->getRunInfo();
+
+    COUNT activeRuns = 0;
+    for ( SESSIONS::const_iterator its = m_Sessions.begin(); its != m_Sessions.end(); ++its )
+    {
+        if ( its->m_pRunInfo )
+            ++activeRuns;
+    }
+
+    COUNT64 endMicros = m_StopMicros ? m_StopMicros : LatencyHistogram::getMicroseconds();
+    COUNT64 elapsedMicros = (m_StartMicros && (endMicros > m_StartMicros)) ? endMicros - m_StartMicros : 0;
+    double runsPerMinute = elapsedMicros ? m_RunsCompleted * 60000000.0 / elapsedMicros : 0.0;
+
+    std::stringstream strm;
+    strm << "LG " << (isTerminated() || m_StopMicros ? "DONE" : (m_StopRequested ? "STOPPING" : "ACTIVE"))
+        << " SESS " << activeRuns << "/" << m_Sessions.size()
+        << " RUNS " << m_RunsCompleted << "/" << m_RunsStarted
+        << " ERR " << m_ErrorRuns
+        << " RUNS/MIN " << std::fixed << std::setprecision( 1 ) << runsPerMinute;
+    pConsMgr->postReadOnlyMessage( strm.str(), m_Routing, pExecRunInfo );
+
+    LatencyHistogram::Snapshot snapshot = m_RunHistogram.getSnapshot();
+    strm.str( "" );
+    strm << "LG RUN N=" << snapshot.m_Count
+        << " P50=" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 50.0 ) )
+        << " P99=" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 99.0 ) )
+        << " MAX=" << LatencyHistogram::getDurationString( snapshot.m_MaxMicros );
+    pConsMgr->postReadOnlyMessage( strm.str(), m_Routing, pExecRunInfo );
+
+    snapshot = m_StatementHistogram.getSnapshot();
+    strm.str( "" );
+    strm << "LG STMT N=" << snapshot.m_Count
+        << " P50=" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 50.0 ) )
+        << " P99=" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 99.0 ) )
+        << " MAX=" << LatencyHistogram::getDurationString( snapshot.m_MaxMicros );
+    pConsMgr->postReadOnlyMessage( strm.str(), m_Routing, pExecRunInfo );
+
+    for ( INDEX sx = 0; sx < STEP_COUNT; ++sx )
+    {
+        if ( sx == STEP_KEYIN )
+            continue;
+
+        snapshot = m_StepHistograms[sx].getSnapshot();
+        strm.str( "" );
+        strm << "LG " << getStepString( static_cast<Step>( sx ) )
+            << " N=" << snapshot.m_Count
+            << " MEAN=" << LatencyHistogram::getDurationString( snapshot.getMeanMicros() )
+            << " P99=" << LatencyHistogram::getDurationString( snapshot.getPercentileMicros( 99.0 ) );
+        pConsMgr->postReadOnlyMessage( strm.str(), m_Routing, pExecRunInfo );
+    }
+
+    //  Mass storage requests are exec-wide, so this includes whatever else was going on at the time.
+    IoManager* pIoMgr = dynamic_cast<IoManager*>( m_pExec->getManager( Exec::MID_IO_MANAGER ) );
+    snapshot = pIoMgr->getMassStorageRequestHistogram().getSnapshot();
+    COUNT64 ioCount = snapshot.m_Count - m_IoCountBase;
+    COUNT64 ioMicros = snapshot.m_TotalMicros - m_IoTotalMicrosBase;
+    strm.str( "" );
+    strm << "LG KEYINS " << m_Keyins
+        << " OPENFAIL " << m_OpenFailures
+        << " MS IO N=" << ioCount
+        << " MEAN=" << LatencyHistogram::getDurationString( ioCount ? ioMicros / ioCount : 0 );
+    pConsMgr->postReadOnlyMessage( strm.str(), m_Routing, pExecRunInfo );
+}
+
+
+
+//  private statics
+
+//  getStepString()
+//
+//  For reports
+const char*
+LoadGeneratorActivity::getStepString
+(
+    const Step          step
+)
+{
+    switch ( step )
+    {
+    case STEP_ASG_T:    return "ASG,T";
+    case STEP_USE:      return "USE";
+    case STEP_FREE_T:   return "FREE";
+    case STEP_CAT:      return "CAT";
+    case STEP_ASG_A:    return "ASG,A";
+    case STEP_FREE_D:   return "FREE,D";
+    case STEP_LOG:      return "LOG";
+    case STEP_KEYIN:    return "KEYIN";
+    case STEP_FIN:      return "FIN";
+    default:            return "?";
+    }
+}
+
+
+//  handleDone()
+//
+//  Invoked once as we terminate - either everything is finished, or the exec is going down.
+void
+LoadGeneratorActivity::handleDone
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    LoadGeneratorActivity* pActivity = dynamic_cast<LoadGeneratorActivity*>( pObject );
+    if ( pActivity->m_StopMicros == 0 )
+        pActivity->m_StopMicros = LatencyHistogram::getMicroseconds();
+    pActivity->postReportLocked();
+}
+
+
+//  handlePoll()
+//
+//  Drives the sessions.  If we did anything, we come right back; otherwise we wait a bit.
+//  Once no more runs are to be opened and the last one has finished, we are done.
+void
+LoadGeneratorActivity::handlePoll
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    LoadGeneratorActivity* pActivity = dynamic_cast<LoadGeneratorActivity*>( pObject );
+    if ( pActivity->pollSessions() )
+        pActivity->setDelay( 0 );
+
+    bool opening = !pActivity->m_StopRequested
+                    && ((pActivity->m_RunLimit == 0) || (pActivity->m_RunsStarted < pActivity->m_RunLimit));
+    if ( !opening && (pActivity->m_RunsStarted == pActivity->m_RunsCompleted) )
+    {
+        pActivity->m_StopMicros = LatencyHistogram::getMicroseconds();
+        pActivity->setNextState( DONE );
+    }
+}
+
+
+//  handleStartup()
+//
+//  Notes the mass storage request counters, so that we can report on our share of them
+void
+LoadGeneratorActivity::handleStartup
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    LoadGeneratorActivity* pActivity = dynamic_cast<LoadGeneratorActivity*>( pObject );
+    IoManager* pIoMgr = dynamic_cast<IoManager*>( pActivity->m_pExec->getManager( Exec::MID_IO_MANAGER ) );
+    LatencyHistogram::Snapshot snapshot = pIoMgr->getMassStorageRequestHistogram().getSnapshot();
+    pActivity->m_IoCountBase = snapshot.m_Count;
+    pActivity->m_IoTotalMicrosBase = snapshot.m_TotalMicros;
+    pActivity->m_StartMicros = LatencyHistogram::getMicroseconds();
+}
+
+
+
+//  constructors, destructors
+
+LoadGeneratorActivity::LoadGeneratorActivity
+(
+    Exec* const         pExec,
+    const COUNT         sessionCount,
+    const COUNT64       runLimit,
+    const Word36&       routing
+)
+:IntrinsicActivity( pExec, "LoadGeneratorActivity", pExec->getRunInfo() ),
+m_ErrorRuns( 0 ),
+m_IoCountBase( 0 ),
+m_IoTotalMicrosBase( 0 ),
+m_Keyins( 0 ),
+m_NextRunSerial( 1 ),
+m_OpenFailures( 0 ),
+m_Routing( routing ),
+m_RunLimit( runLimit ),
+m_RunsCompleted( 0 ),
+m_RunsStarted( 0 ),
+m_Sessions( sessionCount ),
+m_StartMicros( 0 ),
+m_StopMicros( 0 ),
+m_StopRequested( false )
+{
+    establishStateEntry( STARTUP, handleStartup, POLL, 0 );
+    establishStateEntry( POLL, handlePoll, POLL, 10 );
+    establishStateEntry( DONE, handleDone, DONE, 0 );
+}
+
+
+
+//  public methods
+
+//  dump()
+//
+//  IntrinsicActivity interface
+//  For debugging
+void
+LoadGeneratorActivity::dump
+(
+    std::ostream&       stream,
+    const std::string&  prefix,
+    const DUMPBITS      dumpBits
+)
+{
+    stream << prefix << "LoadGeneratorActivity Sessions=" << m_Sessions.size()
+        << " RunLimit=" << m_RunLimit
+        << " Started=" << m_RunsStarted
+        << " Completed=" << m_RunsCompleted
+        << (m_StopRequested ? " StopRequested" : "") << std::endl;
+    for ( INDEX sx = 0; sx < m_Sessions.size(); ++sx )
+    {
+        const Session& session = m_Sessions[sx];
+        if ( session.m_pRunInfo )
+        {
+            stream << prefix << "  Session " << sx << ": " << session.m_pRunInfo->getActualRunId()
+                << " Serial=" << session.m_RunSerial
+                << " NextStep=" << session.m_NextStep
+                << (session.m_StatementPending ? " Pending" : "") << std::endl;
+        }
+    }
+
+    IntrinsicActivity::dump( stream, prefix + "  ", dumpBits );
+}
+
+
+//  postReport()
+//
+//  For the LG keyin
+void
+LoadGeneratorActivity::postReport()
+{
+    lock();
+    postReportLocked();
+    unlock();
+}
+
+
+//  requestStop()
+//
+//  No more runs are opened; we finish once those in progress have finished.
+void
+LoadGeneratorActivity::requestStop()
+{
+    lock();
+    m_StopRequested = true;
+    unlock();
+    signal();
+}
+
@@ -0,0 +1,129 @@
+//  LoadGeneratorActivity.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Synthetic demand workload, for capacity planning - started and reported on by the LG keyin.
+//  We keep some number of scripted demand runs open at once.  Each run gets the same small deck of
+//  facilities and catalogue statements, plus a keyin, and ends with @FIN; as each run finishes, another is opened
+//  in its place, until the requested number of runs has been done (or forever, if none was requested).
+//
+//  There is no RSI session behind these runs.  We do for each of them what RSIManager would do for a terminal -
+//  put the next image into READ$ whenever the run allows input, throw away whatever lands in PRINT$,
+//  and let go of the run when the exec moves it to RSI_TERM.  Everything between - CoarseSchedulerActivity,
+//  CSInterpreter, ControlStatementActivity, the managers - is the real path.
+//
+//  A statement's latency is from the moment its image goes into READ$ to the moment the run next allows input
+//  (or for @FIN, reaches RSI_TERM), so it includes the wait for the coarse scheduler to notice it.
+
+
+
+#ifndef     EXECLIB_LOAD_GENERATOR_ACTIVITY_H
+#define     EXECLIB_LOAD_GENERATOR_ACTIVITY_H
+
+
+
+#include    "DemandRunInfo.h"
+#include    "IntrinsicActivity.h"
+
+
+
+class   LoadGeneratorActivity : public IntrinsicActivity
+{
+private:
+    enum LocalState
+    {
+        STARTUP                 = m_InitialState,
+        POLL,
+        DONE                    = m_TerminalState,  //  Post the final report
+    };
+
+    //  Deck steps, in the order they are issued.  The keyin is not an image - we issue it ourselves.
+    enum Step
+    {
+        STEP_ASG_T,                     //  @ASG,T      temporary file
+        STEP_USE,                       //  @USE        attach an internal name to it
+        STEP_FREE_T,                    //  @FREE       release it
+        STEP_CAT,                       //  @CAT        catalogue a file unique to the run
+        STEP_ASG_A,                     //  @ASG,A      assign it
+        STEP_FREE_D,                    //  @FREE,D     release and delete it
+        STEP_LOG,                       //  @LOG
+        STEP_KEYIN,                     //  a status keyin
+        STEP_FIN,                       //  @FIN
+        STEP_COUNT,
+    };
+
+    //  One scripted terminal
+    class   Session
+    {
+    public:
+        INDEX                   m_NextStep;
+        Step                    m_PendingStep;          //  statement in progress, if m_StatementPending
+        DemandRunInfo*          m_pRunInfo;             //  zero if we have no run open
+        COUNT64                 m_RunSerial;
+        COUNT64                 m_RunStartMicros;
+        bool                    m_StatementPending;
+        COUNT64                 m_StatementStartMicros;
+
+        Session()
+            :m_NextStep( 0 ),
+            m_PendingStep( STEP_ASG_T ),
+            m_pRunInfo( 0 ),
+            m_RunSerial( 0 ),
+            m_RunStartMicros( 0 ),
+            m_StatementPending( false ),
+            m_StatementStartMicros( 0 )
+        {}
+    };
+
+    typedef     std::vector<Session>                SESSIONS;
+    typedef     SESSIONS::iterator                  ITSESSIONS;
+
+    COUNT64                     m_ErrorRuns;            //  runs which were in error when they finished
+    COUNT64                     m_IoCountBase;          //  mass storage request count when we started
+    COUNT64                     m_IoTotalMicrosBase;    //  mass storage request time when we started
+    COUNT64                     m_Keyins;
+    COUNT64                     m_NextRunSerial;
+    COUNT64                     m_OpenFailures;         //  runs we could not open
+    const Word36                m_Routing;              //  console which started us, for reports
+    LatencyHistogram            m_RunHistogram;         //  open to RSI_TERM
+    COUNT64                     m_RunLimit;             //  zero for no limit
+    COUNT64                     m_RunsCompleted;
+    COUNT64                     m_RunsStarted;
+    SESSIONS                    m_Sessions;
+    COUNT64                     m_StartMicros;
+    LatencyHistogram            m_StatementHistogram;   //  all statements
+    LatencyHistogram            m_StepHistograms[STEP_COUNT];
+    COUNT64                     m_StopMicros;           //  when the last run finished, if we are done
+    bool                        m_StopRequested;
+
+    void                        drainPrint( DemandRunInfo* const pRunInfo ) const;
+    std::string                 getImage( const Step    step,
+                                          const COUNT64 runSerial ) const;
+    bool                        openRun( Session* const pSession );
+    bool                        pollSessions();
+    void                        postReportLocked() const;
+
+    static void                 handleDone( IntrinsicActivity* const pObject );
+    static void                 handlePoll( IntrinsicActivity* const pObject );
+    static void                 handleStartup( IntrinsicActivity* const pObject );
+    static const char*          getStepString( const Step step );
+
+public:
+    LoadGeneratorActivity( Exec* const      pExec,
+                           const COUNT      sessionCount,
+                           const COUNT64    runLimit,
+                           const Word36&    routing );
+
+    void                        postReport();
+    void                        requestStop();
+
+    //  IntrinsicActivity interface
+    void                        dump( std::ostream&         stream,
+                                      const std::string&    prefix,
+                                      const DUMPBITS        dumpBits );
+
+    static const COUNT          MAX_SESSIONS = 999;
+};
+
+
+
+#endif
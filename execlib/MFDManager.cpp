@@ -590,6 +590,8 @@
 #define     OVERWRITTEN_REEL_TABLE      (0555555555555ll)
 #endif
 
+#define     DUMP_CHUNK_SIZE             (64 * 1024)     //  Dump output is accumulated to this size before writing
+
 
 
 //  statics
@@ -597,6 +599,8 @@
 const std::string   MFDFQualifier               = "SYS$";
 const std::string   MFDFFileName                = "MFDF$$";
 
+FixedBlockPool      MFDManager::m_DirectorySectorPool( "DirectorySectors", WORDS_PER_SECTOR * sizeof(Word36), 256 );
+
 
 
 //  TODO:DEBUG - this needs removed at some point, once we're happy that things are going nicely
@@ -625,11 +629,7 @@ MFDManager::allocateDirectorySector
 {
     Result result;
 
-    //TODO:DEBUG
-    std::stringstream strm;
-    strm << "MFDManager::allocateDirectorySector() preferredLDAT=0" << std::oct << preferredLDATIndex;
-    SystemLog::write(strm.str());
-    //END DEBUG
+    SYSTEM_LOG( MFD, DEBUG, "MFDManager::allocateDirectorySector() preferredLDAT=0" << std::oct << preferredLDATIndex );
 
     //  Check DAS's on the various packs to find one which has a free directory sector.
     //  Start with the preferred pack, then move on as necessary.  At this point, we
@@ -704,11 +704,7 @@ MFDManager::allocateDirectorySectorOnDAS
     static UINT64 entryMask = 0777777777760;
     Result result;
 
-    //TODO:DEBUG
-    std::stringstream strm;
-    strm << "MFDManager::allocateDirectorySectorOnDAS() dasAddr=0" << std::oct << dasAddr;
-    SystemLog::write( strm.str() );
-    //ENDDEBUG
+    SYSTEM_LOG( MFD, DEBUG, "MFDManager::allocateDirectorySectorOnDAS() dasAddr=0" << std::oct << dasAddr );
 
     //  stage the DAS
     Word36* pDAS = 0;
@@ -746,11 +742,7 @@ MFDManager::allocateDirectorySectorOnDAS
                     //  This will not move the sector, so pDAS and pEntry will still be valid.
                     pEntry[wx + 1].logicalOr( bitMask );
                     DEBUG_INSERT( dasAddr );
-                    //TODO:DEBUG
-                    strm.str("");
-                    strm << "    Returning with pDSAddress->0" << std::oct << *pDSAddress;
-                    SystemLog::write(strm.str());
-                    //ENDDEBUG
+                    SYSTEM_LOG( MFD, DEBUG, "    Returning with pDSAddress->0" << std::oct << *pDSAddress );
                     return result;
                 }
             }
@@ -779,11 +771,7 @@ MFDManager::allocateDirectorySectorOnPack
 )
 {
     Result result;
-    //TODO:DEBUG
-    std::stringstream strm;
-    strm << "MFDManager::allocateDirectorySectorOnPack() ldat=0" << std::oct << ldatIndex;
-    SystemLog::write( strm.str() );
-    //ENDDEBUG
+    SYSTEM_LOG( MFD, DEBUG, "MFDManager::allocateDirectorySectorOnPack() ldat=0" << std::oct << ldatIndex );
 
     //  Grab sectors 0 and 1
     DSADDR sector0Addr = (ldatIndex << 18);
@@ -849,11 +837,7 @@ MFDManager::allocateDirectoryTrack
 {
     Result result;
 
-    //TODO:DEBUG
-    std::stringstream strm;
-    strm << "MFDManager::allocateDirectoryTrack() called, with preferred LDAT = 0" << std::oct << preferredLDATIndex;
-    SystemLog::write( strm.str() );
-    //ENDDEBUG
+    SYSTEM_LOG( MFD, DEBUG, "MFDManager::allocateDirectoryTrack() called, with preferred LDAT = 0" << std::oct << preferredLDATIndex );
 
     //  Select a fixed pack for allocation.  We can use only packs which are UP,
     //  which have at least one track unallocated, and which have < 07777 directory tracks.
@@ -1134,13 +1118,9 @@ MFDManager::allocateFixedTracks
         return result;
     pSector1[3].setW( pSector1[3].getW() - *pTracksAllocated );
 
-    //TODO:DEBUG
-    std::stringstream strm;
-    strm << "MFDManager::allocateFixedTracks() alloc'd 0" << std::oct << *pTracksAllocated
-        << " track(s) on LDAT 0" << std::oct << *pAllocatedLDATIndex
-        << " at Device TrackID 0" << std::oct << *pDeviceTrackId;
-    SystemLog::write( strm.str() );
-    //ENDDEBUG
+    SYSTEM_LOG( MFD, DEBUG, "MFDManager::allocateFixedTracks() alloc'd 0" << std::oct << *pTracksAllocated
+                << " track(s) on LDAT 0" << std::oct << *pAllocatedLDATIndex
+                << " at Device TrackID 0" << std::oct << *pDeviceTrackId );
 
     return result;
 }
@@ -1262,11 +1242,7 @@ MFDManager::chooseFixedLDATIndex()
 
         if ( itpi->second->m_InFixedPool )
         {
-            //TODO:DEBUG
-            std::stringstream strm;
-            strm << "MFDManager::chooseFixedLDATIndex() chose LDAT 0" << std::oct << itpi->first;
-            SystemLog::write(strm.str());
-            //ENDDEBUG
+            SYSTEM_LOG( MFD, DEBUG, "MFDManager::chooseFixedLDATIndex() chose LDAT 0" << std::oct << itpi->first );
             return itpi->first;
         }
     }
@@ -1283,6 +1259,10 @@ MFDManager::commitMFDUpdates
 )
 {
     Result result;
+    TraceLog::Span span( TraceLog::EVENT_MFD_COMMIT, m_UpdatedSectors.size() );
+
+    if ( !m_UpdatedSectors.empty() )
+        ++m_UpdateGeneration;
 
     while ( m_UpdatedSectors.size() > 0 )
     {
@@ -1548,18 +1528,12 @@ MFDManager::directDiskIo
     channelProgram.m_Format = ChannelModule::IoTranslateFormat::C;
     channelProgram.m_TransferSizeWords = wordCount;
 
-    //  Start the IO, then wait for completion
-    pIOProcessor->routeIo( &channelProgram );
-    while ( channelProgram.m_ChannelStatus == ChannelModule::Status::IN_PROGRESS )
+    //  Start the IO, then sleep until the channel module signals completion.
+    ChannelProgramAwaitable awaitable( pIOProcessor, &channelProgram );
+    if ( !awaitable.wait( pActivity ) )
     {
-        if ( pActivity->isTerminating() )
-        {
-            pIOProcessor->cancelIo( &channelProgram );
-            result.m_Status = MFDST_TERMINATING;
-            return result;
-        }
-
-        pActivity->wait( 10 );
+        result.m_Status = MFDST_TERMINATING;
+        return result;
     }
 
     result.m_ChannelStatus = channelProgram.m_ChannelStatus;
@@ -1914,1771 +1888,1480 @@ MFDManager::dropReelTables
 }
 
 
-//  dumpMFDDirectory()
+//  establishLookupEntry()
 //
-//  Dumps the MFD data in a nice directory format.
-//  Presumes that the directory is not corrupted.
-//  For debugging.
-void
-MFDManager::dumpMFDDirectory
-(
-    std::ostream&       stream
-)
+//  Establishes a lookup entry for the given qual/file combination.
+//
+//  Parameters:
+//      pActivity:          pointer to the invoking Activity
+//      pQualifier:         pointer to 2-entry Word36 buffer containing LJSF qualfier in fieldata
+//      pFileName:          pointer to 2-entry Word36 buffer containing LJSF filename in fieldata
+//      leadItemAddr:       DSADDR of lead item sector 0 for the fileset
+MFDManager::Result
+    MFDManager::establishLookupEntry
+    (
+    Activity* const             pActivity,
+    const Word36* const         pQualifier,
+    const Word36* const         pFileName,
+    const DSADDR                leadItemAddr
+    )
 {
-    stream << "  MFD Directory:" << std::endl;
+    Result result;
+    INDEX hashIndex = getLookupTableHashIndex( pQualifier, pFileName );
+    LDATINDEX preferredLDATIndex = leadItemAddr >> 18;
 
-    //  Iterate over the lookup items
-    for ( INDEX lx = 0; lx < m_SearchItemLookupTable.size(); ++lx )
+    //  See if we can find an existing search item with an empty entry.
+    //  Iterate over the existing search item chain (if there is one).
+    DSADDR firstSearchItemAddr = m_SearchItemLookupTable[hashIndex];
+    DSADDR lastSearchItemAddr = firstSearchItemAddr;
+    Word36* pExisting = 0;
+    if ( firstSearchItemAddr )
     {
-        DSADDR searchItemAddr = m_SearchItemLookupTable[lx];
+        preferredLDATIndex = firstSearchItemAddr >> 18;
+
+        //  We found a current lookup entry at the given hash index - walk the chain
+        DSADDR searchItemAddr = firstSearchItemAddr;
         while ( searchItemAddr != 0 )
         {
-            //  Read the lookup item.
-            CITDIRECTORYCACHE itSearchItem = m_DirectoryCache.find( searchItemAddr );
-            if ( itSearchItem == m_DirectoryCache.end() )
-            {
-                stream << "    Error locating search item at DSADDR 0" << std::oct << searchItemAddr << std::endl;
-                continue;
-            }
+            //  Get the search item
+            lastSearchItemAddr = searchItemAddr;
+            if ( !stageDirectorySector( searchItemAddr, false, &pExisting, &result ) )
+                return result;
 
-            const Word36* pSearchItem = itSearchItem->second;
-            const Word36* pEntry = &pSearchItem[01];
-            for ( INDEX ex = 0; ex < 5; ++ex )
+            Word36* pEntry = pExisting + 1;
+            for ( INDEX32 ex = 0; ex < 5; ++ex )
             {
-                DSADDR leadItem0Addr = getLinkAddress( pEntry[4] );
-                if ( leadItem0Addr != 0 )
-                    dumpMFDDirectoryLeadItem( stream, leadItem0Addr );
+                DSADDR linkedAddr = getLinkAddress( pEntry[4] );
+                if ( linkedAddr == 0 )
+                {
+                    //  We can use this item.  Update it appropriately.
+                    pEntry[0] = pQualifier[0];
+                    pEntry[1] = pQualifier[1];
+                    pEntry[2] = pFileName[0];
+                    pEntry[3] = pFileName[1];
+                    pEntry[4] = leadItemAddr;
+
+                    DEBUG_INSERT( searchItemAddr );
+                    return result;
+                }
                 pEntry += 5;
             }
 
-            searchItemAddr = getLinkAddress( pSearchItem[0] );
+            //  This entry is full, look for another
+            searchItemAddr = getLinkAddress( pExisting[0] );
         }
     }
-}
-
 
-//  dumpMFDDirectoryLeadItem()
-//
-//  Handles lead items for dumpMFDDirectory
-void
-MFDManager::dumpMFDDirectoryLeadItem
-(
-    std::ostream&       stream,
-    const DSADDR        leadItem0Addr
-)
-{
-    //  Read lead item 0 (and 1, if it exists)
-    DSADDR leadItem1Addr = 0;
-    Word36* pLeadItem0 = 0;
-    Word36* pLeadItem1 = 0;
-    Result result;
-    if ( !stageLeadItems( leadItem0Addr, false, &leadItem1Addr, &pLeadItem0, &pLeadItem1, &result ) )
-    {
-        stream << "    Error reading lead item:" << getResultString( result ) << std::endl;
-        return;
-    }
+    //  No empty search items (possibly no search items at all).
+    //  Allocate a new directory sector, and build a new search item there-in.
+    DSADDR newSearchItemAddr = 0;
+    result = allocateDirectorySector( pActivity, preferredLDATIndex, &newSearchItemAddr );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
 
-    SuperString qualifier = miscWord36FieldataToString( &pLeadItem0[1], 2 );
-    qualifier.trimTrailingSpaces();
-    SuperString filename = miscWord36FieldataToString( &pLeadItem0[3], 2 );
-    filename.trimTrailingSpaces();
-    SuperString projectId = miscWord36FieldataToString( &pLeadItem0[5], 2 );
-    projectId.trimTrailingSpaces();
+    Word36* pNewItem = 0;
+    if ( !stageDirectorySector( newSearchItemAddr, true, &pNewItem, &result ) )
+        return result;
+    for ( INDEX wx = 0; wx < 28; ++wx )
+        pNewItem[wx].setW( 0 );
 
-    SuperString readKey("<none>");
-    if ( !pLeadItem0[7].isZero() )
+    //  Set up new search item.
+    pNewItem[0].setW( 0440000000000ll );
+    if ( pExisting )
     {
-        readKey = miscWord36FieldataToString( &pLeadItem0[7], 1 );
-        readKey.trimTrailingSpaces();
+        //  A chain already exists, and we have a pointer to the last search item in the chain.
+        //  Link this new entry to the previous last existing item.
+        pExisting[0].setW( newSearchItemAddr | 0040000000000ll );
+        DEBUG_INSERT( lastSearchItemAddr );
     }
-
-    SuperString writeKey("<none>");
-    if ( !pLeadItem0[010].isZero() )
+    else
     {
-        writeKey = miscWord36FieldataToString( &pLeadItem0[010], 1 );
-        writeKey.trimTrailingSpaces();
+        //  No chain exists, so nothing to link to this new item.
+        //  The lookup table needs to link here, though...
+        m_SearchItemLookupTable[hashIndex] = newSearchItemAddr;
     }
 
-    const FileType fileType = ( pLeadItem0[011].getS1() == 0 ) ? FILETYPE_MASS_STORAGE : FILETYPE_TAPE; //TODO:REMO removable issue?
-    const COUNT currentCycles = pLeadItem0[011].getS2();
-    const COUNT maxRange = pLeadItem0[011].getS3();
-    const COUNT currentRange = pLeadItem0[011].getQ3();
-    const UINT16 highestAbsolute = pLeadItem0[011].getQ4();
-
-    UINT32 statusBits = pLeadItem0[012].getT1();
-    bool guardedSet = ( statusBits & 04000 ) ? true : false;
-    bool plusOneExists = ( statusBits & 02000 ) ? true : false;
-    bool nameChangeInProgress = ( statusBits & 01000 ) ? true : false;
-
-    stream << "    FileSet " << qualifier << "*" << filename << "  ProjectId:" << projectId << std::endl;
-    stream << "      ReadKey:" << readKey << "  WriteKey:" << writeKey
-        << "  FileType:" << getFileTypeString( fileType ) << std::endl;
-    stream << "      Cycles existing:" << currentCycles
-        << "  maxRange:" << maxRange
-        << "  currentRange:" << currentRange
-        << "  highestAbsolute:" << highestAbsolute << std::endl;
-    stream << "      Guarded:" << ( guardedSet ? "Yes" : "No" )
-        << "  +1Exists:" << ( plusOneExists ? "Yes" : "No" )
-        << "  nameChgInProg:" << ( nameChangeInProgress ? "Yes" : "No" ) << std::endl;
+    Word36* pEntry = &pNewItem[1];
+    pEntry[0] = pQualifier[0];
+    pEntry[1] = pQualifier[1];
+    pEntry[2] = pFileName[0];
+    pEntry[3] = pFileName[1];
+    pEntry[4] = leadItemAddr;
 
-    Word36* pLink = &pLeadItem0[013];
-    int relativeCycle = plusOneExists ? 1 : 0;
-    for ( INDEX ex = 0; ex < currentRange; ++ex )
-    {
-        if ( ex == 17 )
-            pLink = &pLeadItem1[01];
-        DSADDR mainItem0Addr = getLinkAddress( pLink[0] );
-        if ( mainItem0Addr != 0 )
-            dumpMFDDirectoryMainItem( stream, fileType, relativeCycle, mainItem0Addr );
-        ++pLink;
-        --relativeCycle;
-    }
+    return result;
 }
 
 
-//  dumpMFDDirectoryMainItem()
+/*TODO:RECOV this *might* be used during recovery?  maybe?
+//  getAllocatedDirectorySectors()
 //
-//  Handles main items for dumpMFDDirectory
-void
-MFDManager::dumpMFDDirectoryMainItem
-(
-    std::ostream&               stream,
-    const FileType              fileType,
-    const int                   relativeCycle,
-    const DSADDR                mainItem0Addr
-)
+//  Populates a container with the DSADDR's of all the allocated directory sectors
+//
+//  Parameters:
+//      pContainer:         pointer to container to be populated
+//      includeDASs:        true to include DSADDR's of all the DAS sectors
+MFDManager::Result
+    MFDManager::getAllocatedDirectorySectors
+    (
+    std::set<DSADDR>* const     pContainer,
+    const bool                  includeDASs
+    )
 {
     Result result;
+    pContainer->clear();
 
-    DSADDR mainItem1Addr = 0;
-    Word36* pMainItem0 = 0;
-    Word36* pMainItem1 = 0;
-    if ( !stageMainItems( mainItem0Addr, false, &mainItem1Addr, &pMainItem0, &pMainItem1, &result ) )
+    DSADDR dasAddr = 0;
+    bool done = false;
+    while ( !done )
     {
-        stream << "    Error reading main items:" << getResultString( result ) << std::endl;
-        return;
-    }
+        //  Read the first/next DAS
+        Word36* pDas = m_DataStoreCache.readDirectorySector( dasAddr, &result.m_DataStoreResult );
+        if ( !pDas )
+        {
+            SystemLog::write( "MFDManager::getAllocatedDirectorySectors() cannot read DAS" );
+            result.m_Status = MFDST_DATASTORE_ERROR;
+            return result;
+        }
 
-    SuperString qualifier = miscWord36FieldataToString( &pMainItem0[01], 2 );
-    SuperString fileName = miscWord36FieldataToString( &pMainItem0[03], 2 );
-    SuperString projectId = miscWord36FieldataToString( &pMainItem0[05], 2 );
-    SuperString account = miscWord36FieldataToString( &pMainItem0[07], 2 );
-    qualifier.trimTrailingSpaces();
-    fileName.trimTrailingSpaces();
-    projectId.trimTrailingSpaces();
-    account.trimTrailingSpaces();
+        //  Iterate over the directory tracks described by this DAS
+        for ( INDEX ex = 0; ex < 9; ++ex )
+        {
+            Word36* pEntry = &pDas[ex * 3];
 
-    UINT8 disableFlags = pMainItem0[013].getS1();
-    bool directoryDisabled = ( disableFlags & 020 ) ? true : false;
-    bool writeDisabled = ( disableFlags & 010 ) ? true : false;
-    bool backupDisabled = ( disableFlags & 004 ) ? true : false;
-    bool cacheDisabled = ( disableFlags & 002 ) ? true : false;
+            //  Is the track allocated?
+            if ( (ex == 0) || (isLinkAddress( pEntry[0] )) )
+            {
+                //  Yeah, iterate over the bits in the 2-word bitmask, corresponding to sector addresses.
+                DSADDR dsAddr = dasAddr + (ex * 64);
+                UINT64 bitMask = (pEntry[1].getW() & 0777777777760) << 28;
+                bitMask |= pEntry[2].getW() >> 4;
 
-    UINT16 descriptorFlags = pMainItem0[014].getT1();
-    bool unloaded = ( descriptorFlags & 04000 ) ? true : false;
-    bool backedUp = ( descriptorFlags & 02000 ) ? true : false;
-    bool saveOnCheckpoint = ( descriptorFlags & 01000 ) ? true : false;
-    bool toBeCataloged = ( descriptorFlags & 00100 ) ? true : false;
-    bool tapeFile = ( descriptorFlags & 00040 ) ? true : false;
-    bool toBeWriteOnly = ( descriptorFlags & 00004 ) ? true : false;
-    bool toBeReadOnly = ( descriptorFlags & 00002 ) ? true : false;
-    bool toBeDropped = ( descriptorFlags & 00001 ) ? true : false;
+                //  Is the sector allocated, and do we want to know about it?
+                for ( INDEX bx = 0; bx < 64; ++bx, bitMask <<= 1 )
+                {
+                    if ( (bitMask & 0x8000000000000000) && ( (dsAddr != dasAddr) || includeDASs ) )
+                        pContainer->insert( dsAddr );
+                }
+            }
+        }
 
-    UINT8 fileFlags = pMainItem0[014].getS3();
-    bool largeFile = ( fileFlags & 040 ) ? true : false;
-    bool writtenTo = ( fileFlags & 002 ) ? true : false;
-    bool storeThrough = ( fileFlags & 001 ) ? true : false;
-
-    UINT8 pCharFlags = pMainItem0[015].getS1();
-    bool positionGranularity = ( pCharFlags & 040 ) ? true : false;
-    bool wordAddressable = ( pCharFlags & 010 ) ? true : false;
-    bool asgToCommonName = ( pCharFlags & 004 ) ? true : false;
-
-    SuperString asgMnemonic = miscWord36FieldataToString( &pMainItem0[016], 1 );
-    asgMnemonic.trimTrailingSpaces();
-
-    COUNT cumulativeAssignCount = pMainItem0[017].getH2();
+        //  Move on to the next DAS (if there is one)
+        if ( !isLinkAddress( pDas[27] ) )
+            done = true;
+        else
+            dasAddr += 9 * 64;
+    }
 
-    UINT8 inhibitFlags = pMainItem0[021].getS2();
-    bool guarded = ( inhibitFlags & 040 ) ? true : false;
-    bool unloadInhibit = ( inhibitFlags & 020 ) ? true : false;
-    bool privateFile = ( inhibitFlags & 010 ) ? true : false;
-    bool exclusiveUse = ( inhibitFlags & 004 ) ? true : false;
-    bool writeOnly = ( inhibitFlags & 002 ) ? true : false;
-    bool readOnly = ( inhibitFlags & 001 ) ? true : false;
+    return result;
+}
+*/
 
-    COUNT currentAssignCount = pMainItem0[021].getT2();
-    UINT16 absoluteCycle = pMainItem0[021].getT3();
 
-    stream << "      " << qualifier << "*" << fileName
-        << "(" << std::dec << absoluteCycle << ")"
-        << "/(" << ( relativeCycle > 0 ? "+" : "-" ) << relativeCycle << ")"
-        << "  Project:" << projectId
-        << "  Account:" << account
-        << "  AsgTDate:" << TDate( pMainItem0[022] )
-        << "  CatTDate:" << TDate( pMainItem0[023] )
-        << std::endl;
+//  getConfigData()
+//
+//  (re)load data items which derive from configurator entries
+void
+    MFDManager::getConfigData()
+{
+    m_LookupTableSize = static_cast<COUNT32>(m_pExec->getConfiguration().getIntegerValue( "DCLUTS" ));
+    m_OverheadAccountId = m_pExec->getConfiguration().getStringValue( "OVRACC" );
+    m_OverheadUserId = m_pExec->getConfiguration().getStringValue( "OVRUSR" );
+}
 
-    stream << "        AsgMnem:" << asgMnemonic
-        << "  CumulAsg:" << cumulativeAssignCount
-        << "  CurrentAsg:" << currentAssignCount
-        << " - Inhibits:"
-        << ( guarded ? "GUARD " : "" )
-        << ( unloadInhibit ? "UNLD " : "" )
-        << ( privateFile ? "PRIV " : "" )
-        << ( exclusiveUse ? "XUSE " : "" )
-        << ( writeOnly ? "WRONLY " : "" )
-        << ( readOnly ? "RDONLY " : "" )
-        << std::endl;
 
-    stream << "        Desc:"
-        << ( unloaded ? "UNLD " : "" )
-        << ( backedUp ? "BKUP " : "" )
-        << ( saveOnCheckpoint ? "SCHKPT " : "" )
-        << ( toBeCataloged ? "ToBeCAT " : "" )
-        << ( tapeFile ? "TAPE " : "" )
-        << ( toBeReadOnly ? "ToBeRDONLY " : "" )
-        << ( toBeWriteOnly ? "ToBeWRONLY " : "" )
-        << ( toBeDropped ? "ToBeDRP " : "" );
+//  getFileSetInfo()
+//
+//  Populates a FileSetInfo object for the indicated lead item.
+MFDManager::Result
+MFDManager::getFileSetInfo
+(
+    const DSADDR            leadItemAddr0,
+    FileSetInfo* const      pInfo
+) const
+{
+    Result result;
 
-    stream << " - FileFlg:"
-        << ( largeFile ? "LARGE " : "" )
-        << ( writtenTo ? "WRITTEN " : "" )
-        << ( storeThrough ? "STHRU " : "" );
+    //  Read the lead item(s).
+    DSADDR leadItemAddr1 = 0;
+    Word36* pLeadItem0 = 0;
+    Word36* pLeadItem1 = 0;
+    if ( !stageLeadItems( leadItemAddr0, &leadItemAddr1, &pLeadItem0, &pLeadItem1, &result ) )
+        return result;
 
-    stream << " - PCHAR:"
-        << ( positionGranularity ? "POSGRN " : "" )
-        << ( wordAddressable ? "WADDR " : "" )
-        << ( asgToCommonName ? "ASGCNS " : "" );
+    //  Start filling in the caller's FileSetInfo object
+    pInfo->m_DSAddresses.resize( 2 );
+    pInfo->m_DSAddresses[0] = leadItemAddr0;
+    pInfo->m_DSAddresses[1] = leadItemAddr1;
 
-    if ( disableFlags )
+    pInfo->m_MFDIdentifier = leadItemAddr0;
+    pInfo->m_Qualifier = miscWord36FieldataToString( &pLeadItem0[01], 2 );
+    pInfo->m_Qualifier.trimTrailingSpaces();
+    pInfo->m_Filename = miscWord36FieldataToString( &pLeadItem0[03], 2 );
+    pInfo->m_Filename.trimTrailingSpaces();
+    pInfo->m_ProjectId = miscWord36FieldataToString( &pLeadItem0[05], 2 );
+    pInfo->m_ProjectId.trimTrailingSpaces();
+    if ( !pLeadItem0[07].isZero() )
     {
-        stream << " - Disbl: "
-            << ( directoryDisabled ? "MFD " : "" )
-            << ( writeDisabled ? "Write " : "" )
-            << ( backupDisabled ? "Backup " : "" )
-            << ( cacheDisabled ? "Cache " : "" );
+        pInfo->m_ReadKey = miscWord36FieldataToString( &pLeadItem0[07], 1 );
+        pInfo->m_ReadKey.trimTrailingSpaces();
+    }
+    if ( !pLeadItem0[010].isZero() )
+    {
+        pInfo->m_WriteKey = miscWord36FieldataToString( &pLeadItem0[010], 1 );
+        pInfo->m_WriteKey.trimTrailingSpaces();
     }
 
-    stream << std::endl;
+    pInfo->m_FileType = getFileType( pLeadItem0[011].getS1() );
+    pInfo->m_MaxRange = pLeadItem0[011].getS3();
+    pInfo->m_Guarded = (pLeadItem0[012].getT1() & 04000) != 0;
+    pInfo->m_PlusOneCycleExists = (pLeadItem0[012].getT1() & 02000) != 0;
 
-    //TODO:REM is there a fileType for removable?
-    if ( fileType == FILETYPE_MASS_STORAGE )
+    //  Load FileCycleInfo objects
+    UINT16 currentRange = pLeadItem0[011].getQ3();
+    UINT16 highestAbsolute = pLeadItem0[011].getQ4();
+
+    pInfo->m_CycleEntries.resize( currentRange );
+    Word36* pEntry = &pLeadItem0[013];
+    UINT16 thisAbsolute = highestAbsolute;
+    INT16 thisRelative = pInfo->m_PlusOneCycleExists ? 1 : 0;
+    for ( INDEX ex = 0; ex < currentRange; ++ex )
     {
-        COUNT initialReserve = pMainItem0[024].getH1();
-        COUNT maxGranules = pMainItem0[025].getH1();
-        COUNT highestGranuleAssigned = pMainItem0[026].getH1();
-        COUNT highestTrackWritten = pMainItem0[027].getH1();
-        stream << "        InitGran:" << initialReserve
-            << "  MaxGran:" << maxGranules
-            << "  HighestGran:" << highestGranuleAssigned
-            << "  HighestTrk:" << highestTrackWritten
-            << std::endl;
+        //  Entries 1-17 (ex 0:16) are in the first lead item; the remaining entries are in the second.
+        //  We don't check to see whether sector 1 exists at this point; we assume that, if it does,
+        //  we already followed the link from sector 0 to populate the buffer.
+        if ( ex == 17 )
+            pEntry = &pLeadItem1[01];
 
-        //  Chase DAD tables
-        DSADDR dadAddr = getLinkAddress( pMainItem0[0] );
-        if ( dadAddr == 0 )
-            stream << "        No DAD Sectors" << std::endl;
-        else
+        //  If the entry is non-zero, there is an actual file cycle at this position
+        if ( pEntry->getW() != 0 )
         {
-            stream << "        DAD Sector  FileRelative  Limit         DeviceRelatv  Region        Entry   Device" << std::endl;
-            stream << "        DSADDR      Word Address  Word Address  Word Address  Word Length   Flags   Index " << std::endl;
-            stream << "        ----------  ------------  ------------  ------------  ------------  ------  ------" << std::endl;
-
-            while ( dadAddr != 0 )
-            {
-                Word36* pDAD;
-                if ( !stageDirectorySector( dadAddr, false, &pDAD, &result ) )
-                {
-                    stream << "        MFD ERROR reading DAD at DSADDR=0" << std::oct << dadAddr << std::endl;
-                    stream << "        Result:" << getResultString( result ) << std::endl;
-                    break;
-                }
+            pInfo->m_CycleEntries[ex].m_Exists = true;
+            if ( (pEntry->getW() & 0200000000000ll) != 0 )
+                pInfo->m_CycleEntries[ex].m_ToBeCataloged = true;
+            if ( (pEntry->getW() & 0100000000000ll) != 0 )
+                pInfo->m_CycleEntries[ex].m_ToBeDropped = true;
+            pInfo->m_CycleEntries[ex].m_RelativeCycle = thisRelative;
+            pInfo->m_CycleEntries[ex].m_AbsoluteCycle = thisAbsolute;
+            pInfo->m_CycleEntries[ex].m_MainItem0Addr = getLinkAddress( pEntry[0] );
+            --thisRelative;
+        }
 
-                UINT64 regionAddr = pDAD[2].getW();
-                UINT64 limitAddr = pDAD[3].getW();
-                stream << "        "
-                    << std::oct << std::setw( 10 ) << std::setfill( '0' ) << dadAddr
-                    << "  "
-                    << std::oct << std::setw( 12 ) << std::setfill( '0' ) << regionAddr
-                    << "  "
-                    << std::oct << std::setw( 12 ) << std::setfill( '0' ) << limitAddr
-                    << std::endl;
+        --thisAbsolute;
+        if ( thisAbsolute == 0 )
+            thisAbsolute = 999;
+        ++pEntry;
+    }
 
-                Word36* pEntry = pDAD + 04;
-                for ( INDEX ex = 0; ex < 8; ++ex )
-                {
-                    //  Safety check in case last DAD entry flag isn't there...
-                    if ( regionAddr >= limitAddr )
-                    {
-                        stream << "        WARNING:No last DAD flag found!" << std::endl;
-                        break;
-                    }
+    return result;
+}
 
-                    UINT64 deviceWordAddr = pEntry[0].getW();
-                    UINT64 wordLength = pEntry[1].getW();
-                    UINT32 dadFlags = pEntry[2].getH1();
-                    UINT32 deviceIndex = pEntry[2].getH2();
 
-                    stream << "                                                "
-                        << std::oct << std::setw( 12 ) << std::setfill( '0' ) << deviceWordAddr
-                        << "  "
-                        << std::oct << std::setw( 12 ) << std::setfill( '0' ) << wordLength
-                        << "  "
-                        << std::oct << std::setw( 6 ) << std::setfill( '0' ) << dadFlags
-                        << "  "
-                        << std::oct << std::setw( 6 ) << std::setfill( '0' ) << deviceIndex
-                        << std::endl;
+//  getLeadItemAddress()
+//
+//  Retrieves the lead item address for a given qualifier/filename, if it exists.
+DSADDR
+MFDManager::getLeadItemAddress
+(
+    const Word36* const pQualifier,
+    const Word36* const pFileName
+) const
+{
+    //  Find the search item for the given qual/file combination, if it exists
+    INDEX hx = getLookupTableHashIndex( pQualifier, pFileName );
+    DSADDR lookupAddr = m_SearchItemLookupTable[hx];
 
-                    //  Is this the last DAD entry?
-                    if ( dadFlags & 04 )
-                        break;
-                    pEntry += 3;
-                }
+    Word36* pLookupItem = 0;
+    Word36* pEntry = 0;
+    while ( lookupAddr != 0 )
+    {
+        //  Don't go overboard on this - if we don't find it, we don't find it.  Don't crash things.
+        Result result;
+        if ( !stageDirectorySector( lookupAddr, &pLookupItem, &result ) )
+            return 0;
 
-                dadAddr = getLinkAddress( pDAD[0] );
+        pEntry = &pLookupItem[1];
+        for ( INDEX ex = 0; ex < 5; ++ex )
+        {
+            if ( (pEntry[0].getW() == pQualifier[0].getW()) && (pEntry[1].getW() == pQualifier[1].getW())
+                && (pEntry[2].getW() == pFileName[0].getW()) && (pEntry[3].getW() == pFileName[1].getW()) )
+            {
+                return getLinkAddress( pEntry[4] );
             }
+
+            pEntry += 5;
         }
+
+        lookupAddr = getLinkAddress( pLookupItem[0] );
     }
 
-    if ( fileType == FILETYPE_TAPE )
-    {
-        UINT8 density = pMainItem0[024].getS1();
-        UINT8 format = pMainItem0[024].getS2();
-        COUNT reels = pMainItem0[024].getH2();
-        UINT8 mtapop = pMainItem0[025].getS3();
-        UINT8 noise = pMainItem0[025].getS6();
-        stream << "        Density:";
-        switch ( density )
-        {
-        case 01:
-            stream << "800/38000BPI";
-            break;
-        case 02:
-            stream << "1600BPI";
-            break;
-        case 03:
-            stream << "6250BPI";
-            break;
-        case 04:
-            stream << "5090BPMM";
-            break;
-        case 05:
-            stream << "38000BPI";
-            break;
-        case 06:
-            stream << "76000BPI";
-            break;
-        case 07:
-            stream << "85937BPI";
-            break;
-        default:
-            stream << std::oct << density;
-        }
-
-        stream << " Format:"
-            << (format & 01 ? "DataCnv " : "")
-            << (format & 02 ? "QwPack " : "")
-            << (format & 04 ? "6btPack " : "")
-            << (format & 010 ? "8btPack " : "")
-            << (format & 020 ? "Even " : "Odd ")
-            << (format & 040 ? "9Trk " : "");
-
-        stream << " Reels:" << reels;
+    return 0;
+}
 
-        stream << " MTAPOP:"
-            << (mtapop & 040 ? "CATJ " : "")
-            << (mtapop & 020 ? "QIC " : "")
-            << (mtapop & 010 ? "HIC " : "")
-            << (mtapop & 004 ? "BufOff " : "")
-            << (mtapop & 002 ? "DLT " : "")
-            << (mtapop & 001 ? "HIS " : "");
 
-        stream << " Noise:" << noise << std::endl;
+//  getSearchItemAddress()
+//
+//  Retrieves the search item address for a given qualifier/filename, if it exists.
+//  For qualifiers and filenames in Fieldata LJSF format
+inline DSADDR
+MFDManager::getSearchItemAddress
+(
+    const Word36* const pQualifier,
+    const Word36* const pFileName
+) const
+{
+    //  Find the search item for the given qual/file combination, if it exists
+    INDEX hx = getLookupTableHashIndex( pQualifier, pFileName );
+    return m_SearchItemLookupTable[hx];
+}
 
-        // TODO:TAPE display reels, possibly chasing reel tables
-    }
 
-    if ( !pMainItem1[010].isZero() )
-    {
-        UINT8 fasBits = pMainItem1[011].getS2();
-        bool unloadedAtBackup = (fasBits & 040) ? true : false;
-        bool numberBlocksPositions = (fasBits & 020) ? true : false;
+//  getSearchItemAddress()
+//
+//  Retrieves the search item address for a given qualifier/filename, if it exists.
+//  For qualifiers and filenames held in SuperString objects
+inline DSADDR
+MFDManager::getSearchItemAddress
+(
+    const SuperString&  qualifier,
+    const SuperString&  fileName
+) const
+{
+    //  Convert superstrings to FD LJSF
+    std::string tempQual = qualifier;
+    tempQual.resize( 12, ' ' );
+    std::string tempFile = fileName;
+    tempFile.resize( 12, ' ' );
 
-        stream << "        BkupTDATE:" << TDate( pMainItem1[010] )
-            << " Wrds:" << pMainItem1[07].getT1()
-            << " MaxLvls:" << pMainItem1[011].getS1()
-            << " CurLvls:" << pMainItem1[011].getS3()
-            << " UnldBkup:" << (unloadedAtBackup ? "YES" : "NO")
-            << " Blks:" << pMainItem1[011].getH2()
-            << (numberBlocksPositions ? "POS" : "TRK")
-            << " FilePos:" << pMainItem1[012].getW()
-            << std::endl;
-    }
+    Word36 fdQual[2];
+    miscStringToWord36Fieldata( tempQual, fdQual, 2 );
+    Word36 fdFile[2];
+    miscStringToWord36Fieldata( tempFile, fdFile, 2 );
 
-    switch ( pMainItem1[017].getS2() )
-    {
-    case 1:
-        stream << "        Leg 1 of TIP duplex file" << std::endl;
-        break;
-    case 2:
-        stream << "        Leg 2 of TIP dupliex file" << std::endl;
-        break;
-    case 3:
-        stream << "        TIP simplex file" << std::endl;
-        break;
-    }
+    //  Find the search item for the given qual/file combination, if it exists
+    INDEX hx = getLookupTableHashIndex( fdQual, fdFile );
+    return m_SearchItemLookupTable[hx];
 }
 
 
-//  establishLookupEntry()
-//
-//  Establishes a lookup entry for the given qual/file combination.
+//  initializeAssignMFD()
 //
-//  Parameters:
-//      pActivity:          pointer to the invoking Activity
-//      pQualifier:         pointer to 2-entry Word36 buffer containing LJSF qualfier in fieldata
-//      pFileName:          pointer to 2-entry Word36 buffer containing LJSF filename in fieldata
-//      leadItemAddr:       DSADDR of lead item sector 0 for the fileset
+//  Assigns SYS$*MFDF$$ to the Exec.  For initial boots.
 MFDManager::Result
-    MFDManager::establishLookupEntry
-    (
+MFDManager::initializeAssignMFD
+(
     Activity* const             pActivity,
-    const Word36* const         pQualifier,
-    const Word36* const         pFileName,
-    const DSADDR                leadItemAddr
-    )
+    const DSADDR                mfdMainItem0Addr,
+    FileAllocationTable* const  pMFDFat             //  Pre-created FAT for MFD
+)
 {
     Result result;
-    INDEX hashIndex = getLookupTableHashIndex( pQualifier, pFileName );
-    LDATINDEX preferredLDATIndex = leadItemAddr >> 18;
 
-    //  See if we can find an existing search item with an empty entry.
-    //  Iterate over the existing search item chain (if there is one).
-    DSADDR firstSearchItemAddr = m_SearchItemLookupTable[hashIndex];
-    DSADDR lastSearchItemAddr = firstSearchItemAddr;
-    Word36* pExisting = 0;
-    if ( firstSearchItemAddr )
+    //  Find highest track for MFD - not hard to do.  Of course, we don't ever use it...
+    CITDIRECTORYCACHE itLast = m_DirectoryCache.end();
+    if ( itLast == m_DirectoryCache.begin() )
     {
-        preferredLDATIndex = firstSearchItemAddr >> 18;
-
-        //  We found a current lookup entry at the given hash index - walk the chain
-        DSADDR searchItemAddr = firstSearchItemAddr;
-        while ( searchItemAddr != 0 )
-        {
-            //  Get the search item
-            lastSearchItemAddr = searchItemAddr;
-            if ( !stageDirectorySector( searchItemAddr, false, &pExisting, &result ) )
-                return result;
+        SystemLog::write("MFDManager::initializeAssignMFD() cache is empty");
+        result.m_Status = MFDST_INTERNAL_ERROR; //  cache should never be empty at this point
+        return result;
+    }
 
-            Word36* pEntry = pExisting + 1;
-            for ( INDEX32 ex = 0; ex < 5; ++ex )
-            {
-                DSADDR linkedAddr = getLinkAddress( pEntry[4] );
-                if ( linkedAddr == 0 )
-                {
-                    //  We can use this item.  Update it appropriately.
-                    pEntry[0] = pQualifier[0];
-                    pEntry[1] = pQualifier[1];
-                    pEntry[2] = pFileName[0];
-                    pEntry[3] = pFileName[1];
-                    pEntry[4] = leadItemAddr;
+    --itLast;
+    DSADDR lastDSAddress = itLast->first;
+    UINT32 highestTrack = static_cast<UINT32>( (lastDSAddress >> 6) & 077777777 );
+    UINT32 highestGranule = highestTrack;
 
-                    DEBUG_INSERT( searchItemAddr );
-                    return result;
-                }
-                pEntry += 5;
-            }
+    DiskFacilityItem* pFacItem = new DiskFacilityItem( MFDFFileName,
+                                                       MFDFQualifier,
+                                                       ECODE_WORD_DISK,
+                                                       OPTB_A | OPTB_X,
+                                                       false,               //  release flag
+                                                       0,                   //  absolute file cycle
+                                                       false,               //  absolute file cycle (not) given
+                                                       true,                //  exclusive assign
+                                                       true,                //  existing file flag
+                                                       mfdMainItem0Addr,
+                                                       false,               //  read (not) inhibited
+                                                       false,               //  read key (not) needed
+                                                       0,                   //  relative file cycle
+                                                       false,               //  relative file cycle (not) given
+                                                       false,               //  temporary file flag
+                                                       false,               //  write (not) inhibited
+                                                       false,               //  write key (not) needed
+                                                       pMFDFat,
+                                                       MSGRAN_TRACK,
+                                                       highestGranule,
+                                                       highestTrack,
+                                                       0,                   //  initial granules
+                                                       0777777 );           //  max granules
 
-            //  This entry is full, look for another
-            searchItemAddr = getLinkAddress( pExisting[0] );
-        }
-    }
+    //  Now attach the FACitem to the RunInfo
+    RunInfo* pRunInfo = pActivity->getRunInfo();
+    pRunInfo->attach();
+    pRunInfo->insertFacilityItem( pFacItem );
+    pRunInfo->detach();
 
-    //  No empty search items (possibly no search items at all).
-    //  Allocate a new directory sector, and build a new search item there-in.
-    DSADDR newSearchItemAddr = 0;
-    result = allocateDirectorySector( pActivity, preferredLDATIndex, &newSearchItemAddr );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
+    //  Go back to the main item and set the assignment fields
+    //  Main item 0[017].H2 is cumulative assign count
+    //  Main item 0[021].T2 is current assign count
+    //  Main item 0[021].bit9 is exclusive use flag
+    //  Main item 0[022].W is TDATE$ current assignment started
+    Word36* pMainItem0 = 0;
+    if ( !stageDirectorySector( mfdMainItem0Addr, true, &pMainItem0, &result ) )
         return result;
 
-    Word36* pNewItem = 0;
-    if ( !stageDirectorySector( newSearchItemAddr, true, &pNewItem, &result ) )
-        return result;
-    for ( INDEX wx = 0; wx < 28; ++wx )
-        pNewItem[wx].setW( 0 );
+    pMainItem0[017].setH2( 1 );
+    pMainItem0[021].setT2( 1 );
+    pMainItem0[021].logicalOr( 0000400000000L );
 
-    //  Set up new search item.
-    pNewItem[0].setW( 0440000000000ll );
-    if ( pExisting )
-    {
-        //  A chain already exists, and we have a pointer to the last search item in the chain.
-        //  Link this new entry to the previous last existing item.
-        pExisting[0].setW( newSearchItemAddr | 0040000000000ll );
-        DEBUG_INSERT( lastSearchItemAddr );
-    }
-    else
-    {
-        //  No chain exists, so nothing to link to this new item.
-        //  The lookup table needs to link here, though...
-        m_SearchItemLookupTable[hashIndex] = newSearchItemAddr;
-    }
+    TDate* pTDate = reinterpret_cast<TDate*>( &pMainItem0[022] );
+    m_pExec->getExecTimeTDate( pTDate );
 
-    Word36* pEntry = &pNewItem[1];
-    pEntry[0] = pQualifier[0];
-    pEntry[1] = pQualifier[1];
-    pEntry[2] = pFileName[0];
-    pEntry[3] = pFileName[1];
-    pEntry[4] = leadItemAddr;
+    DEBUG_INSERT( mfdMainItem0Addr );
 
     return result;
 }
 
 
-/*TODO:RECOV this *might* be used during recovery?  maybe?
-//  getAllocatedDirectorySectors()
-//
-//  Populates a container with the DSADDR's of all the allocated directory sectors
+//  initializeCatalogMFD()
 //
-//  Parameters:
-//      pContainer:         pointer to container to be populated
-//      includeDASs:        true to include DSADDR's of all the DAS sectors
+//  Creates an entry in the MFD, to describe the MFD.  Creates DAD entries as well.
+//  Returns DSADDR of main item sector 0 to the caller through the parameter list.
 MFDManager::Result
-    MFDManager::getAllocatedDirectorySectors
-    (
-    std::set<DSADDR>* const     pContainer,
-    const bool                  includeDASs
-    )
+MFDManager::initializeCatalogMFD
+(
+    Activity* const             pActivity,
+    DSADDR* const               pMainItem0Addr,
+    FileAllocationTable** const ppMFDFat
+)
 {
     Result result;
-    pContainer->clear();
 
-    DSADDR dasAddr = 0;
-    bool done = false;
-    while ( !done )
-    {
-        //  Read the first/next DAS
-        Word36* pDas = m_DataStoreCache.readDirectorySector( dasAddr, &result.m_DataStoreResult );
-        if ( !pDas )
-        {
-            SystemLog::write( "MFDManager::getAllocatedDirectorySectors() cannot read DAS" );
-            result.m_Status = MFDST_DATASTORE_ERROR;
-            return result;
-        }
+    //  Catalog SYS$*MFDF$$ and create the DAD table in the MFD update cache.
+    //  All updates go to MFD staged update area.
+    //  Put the directory sectors on the first fixed device.
+    LDATINDEX ldatIndex = 1;
 
-        //  Iterate over the directory tracks described by this DAS
-        for ( INDEX ex = 0; ex < 9; ++ex )
-        {
-            Word36* pEntry = &pDas[ex * 3];
+    DSADDR searchItemAddr = 0;
+    result = allocateDirectorySector( pActivity, ldatIndex, &searchItemAddr );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
 
-            //  Is the track allocated?
-            if ( (ex == 0) || (isLinkAddress( pEntry[0] )) )
-            {
-                //  Yeah, iterate over the bits in the 2-word bitmask, corresponding to sector addresses.
-                DSADDR dsAddr = dasAddr + (ex * 64);
-                UINT64 bitMask = (pEntry[1].getW() & 0777777777760) << 28;
-                bitMask |= pEntry[2].getW() >> 4;
+    DSADDR leadItemAddr = 0;
+    result = allocateDirectorySector( pActivity, ldatIndex, &leadItemAddr );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
 
-                //  Is the sector allocated, and do we want to know about it?
-                for ( INDEX bx = 0; bx < 64; ++bx, bitMask <<= 1 )
-                {
-                    if ( (bitMask & 0x8000000000000000) && ( (dsAddr != dasAddr) || includeDASs ) )
-                        pContainer->insert( dsAddr );
-                }
-            }
-        }
+    DSADDR mainItem0Addr = 0;
+    result = allocateDirectorySector( pActivity, ldatIndex, &mainItem0Addr );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
 
-        //  Move on to the next DAS (if there is one)
-        if ( !isLinkAddress( pDas[27] ) )
-            done = true;
-        else
-            dasAddr += 9 * 64;
-    }
+    DSADDR mainItem1Addr = 0;
+    result = allocateDirectorySector( pActivity, ldatIndex, &mainItem1Addr );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
 
-    return result;
-}
-*/
+    result = initializeCatalogMFDSearchItem( searchItemAddr, leadItemAddr );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
 
+    result = initializeCatalogMFDLeadItem( leadItemAddr, mainItem0Addr );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
 
-//  getConfigData()
-//
-//  (re)load data items which derive from configurator entries
-void
-    MFDManager::getConfigData()
-{
-    m_LookupTableSize = static_cast<COUNT32>(m_pExec->getConfiguration().getIntegerValue( "DCLUTS" ));
-    m_OverheadAccountId = m_pExec->getConfiguration().getStringValue( "OVRACC" );
-    m_OverheadUserId = m_pExec->getConfiguration().getStringValue( "OVRUSR" );
+    result = initializeCatalogMFDMainItem0( mainItem0Addr, leadItemAddr, mainItem1Addr );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
+
+    result = initializeCatalogMFDMainItem1( mainItem1Addr, mainItem0Addr );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
+
+    result = initializeCreateMFDDADTable( pActivity, mainItem0Addr, ppMFDFat );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
+
+    *pMainItem0Addr = mainItem0Addr;
+    return result;
 }
 
 
-//  getFileSetInfo()
+//  initializeCatalogMFDLeadItem()
 //
-//  Populates a FileSetInfo object for the indicated lead item.
-MFDManager::Result
-MFDManager::getFileSetInfo
+//  subfunction of initializeCatalogMFD() - we assume the sector buffer has been cleared.
+inline MFDManager::Result
+MFDManager::initializeCatalogMFDLeadItem
 (
-    const DSADDR            leadItemAddr0,
-    FileSetInfo* const      pInfo
-) const
+    const DSADDR        leadItem0Addr,
+    const DSADDR        mainItem0Addr
+)
 {
     Result result;
 
-    //  Read the lead item(s).
-    DSADDR leadItemAddr1 = 0;
-    Word36* pLeadItem0 = 0;
-    Word36* pLeadItem1 = 0;
-    if ( !stageLeadItems( leadItemAddr0, &leadItemAddr1, &pLeadItem0, &pLeadItem1, &result ) )
+    //  Find the sector
+    Word36* pLeadItem = 0;
+    if ( !stageDirectorySector( leadItem0Addr, true, &pLeadItem, &result ) )
         return result;
 
-    //  Start filling in the caller's FileSetInfo object
-    pInfo->m_DSAddresses.resize( 2 );
-    pInfo->m_DSAddresses[0] = leadItemAddr0;
-    pInfo->m_DSAddresses[1] = leadItemAddr1;
+    pLeadItem[0].setW(0500000000000ll);         //  Descriptor and empty link address
+    miscStringToWord36Fieldata( MFDFQualifier, &pLeadItem[1], 2 );
+    miscStringToWord36Fieldata( MFDFFileName, &pLeadItem[3], 2 );
+    miscStringToWord36Fieldata( m_OverheadUserId, &pLeadItem[5], 2 );   //  Project-ID field
+    pLeadItem[011].setS2( 1 );                  //  number of f-cycles existing
+    pLeadItem[011].setS3( 1 );                  //  maximum range of f-cycles
+    pLeadItem[011].setQ3( 1 );                  //  current range
+    pLeadItem[011].setQ4( 1 );                  //  highest absolute f-cycle
+    pLeadItem[012].setT1( 04000 );              //  status bits - Guarded File
+    pLeadItem[013].setW( mainItem0Addr );       //  link to main item 0 for the only cycle of the file
 
-    pInfo->m_MFDIdentifier = leadItemAddr0;
-    pInfo->m_Qualifier = miscWord36FieldataToString( &pLeadItem0[01], 2 );
-    pInfo->m_Qualifier.trimTrailingSpaces();
-    pInfo->m_Filename = miscWord36FieldataToString( &pLeadItem0[03], 2 );
-    pInfo->m_Filename.trimTrailingSpaces();
-    pInfo->m_ProjectId = miscWord36FieldataToString( &pLeadItem0[05], 2 );
-    pInfo->m_ProjectId.trimTrailingSpaces();
-    if ( !pLeadItem0[07].isZero() )
-    {
-        pInfo->m_ReadKey = miscWord36FieldataToString( &pLeadItem0[07], 1 );
-        pInfo->m_ReadKey.trimTrailingSpaces();
-    }
-    if ( !pLeadItem0[010].isZero() )
-    {
-        pInfo->m_WriteKey = miscWord36FieldataToString( &pLeadItem0[010], 1 );
-        pInfo->m_WriteKey.trimTrailingSpaces();
-    }
+    return result;
+}
 
-    pInfo->m_FileType = getFileType( pLeadItem0[011].getS1() );
-    pInfo->m_MaxRange = pLeadItem0[011].getS3();
-    pInfo->m_Guarded = (pLeadItem0[012].getT1() & 04000) != 0;
-    pInfo->m_PlusOneCycleExists = (pLeadItem0[012].getT1() & 02000) != 0;
 
-    //  Load FileCycleInfo objects
-    UINT16 currentRange = pLeadItem0[011].getQ3();
-    UINT16 highestAbsolute = pLeadItem0[011].getQ4();
+//  initializeCatalogMFDMainItem0()
+//
+//  subfunction of initializeCatalogMFD() - we assume the sector buffer has been cleared.
+inline MFDManager::Result
+MFDManager::initializeCatalogMFDMainItem0
+(
+    const DSADDR        mainItem0Addr,
+    const DSADDR        leadItemAddr,
+    const DSADDR        mainItem1Addr
+)
+{
+    Result result;
 
-    pInfo->m_CycleEntries.resize( currentRange );
-    Word36* pEntry = &pLeadItem0[013];
-    UINT16 thisAbsolute = highestAbsolute;
-    INT16 thisRelative = pInfo->m_PlusOneCycleExists ? 1 : 0;
-    for ( INDEX ex = 0; ex < currentRange; ++ex )
-    {
-        //  Entries 1-17 (ex 0:16) are in the first lead item; the remaining entries are in the second.
-        //  We don't check to see whether sector 1 exists at this point; we assume that, if it does,
-        //  we already followed the link from sector 0 to populate the buffer.
-        if ( ex == 17 )
-            pEntry = &pLeadItem1[01];
+    //  Find the sector
+    Word36* pMainItem0 = 0;
+    if ( !stageDirectorySector( mainItem0Addr, true, &pMainItem0, &result ) )
+        return result;
 
-        //  If the entry is non-zero, there is an actual file cycle at this position
-        if ( pEntry->getW() != 0 )
-        {
-            pInfo->m_CycleEntries[ex].m_Exists = true;
-            if ( (pEntry->getW() & 0200000000000ll) != 0 )
-                pInfo->m_CycleEntries[ex].m_ToBeCataloged = true;
-            if ( (pEntry->getW() & 0100000000000ll) != 0 )
-                pInfo->m_CycleEntries[ex].m_ToBeDropped = true;
-            pInfo->m_CycleEntries[ex].m_RelativeCycle = thisRelative;
-            pInfo->m_CycleEntries[ex].m_AbsoluteCycle = thisAbsolute;
-            pInfo->m_CycleEntries[ex].m_MainItem0Addr = getLinkAddress( pEntry[0] );
-            --thisRelative;
-        }
+    TDate currentTDate;
+    m_pExec->getExecTimeTDate( &currentTDate );
 
-        --thisAbsolute;
-        if ( thisAbsolute == 0 )
-            thisAbsolute = 999;
-        ++pEntry;
-    }
+    pMainItem0[0].setW( 0600000000000ll );                                  //  DAD link - no link for now
+    miscStringToWord36Fieldata( MFDFQualifier, &pMainItem0[1], 2 );         //  Qualifier
+    miscStringToWord36Fieldata( MFDFFileName, &pMainItem0[3], 2 );          //  FileName
+    miscStringToWord36Fieldata( m_OverheadUserId, &pMainItem0[5], 2 );      //  User-id for Project-id
+    miscStringToWord36Fieldata( m_OverheadAccountId, &pMainItem0[7], 2 );   //  Account-id
+    pMainItem0[015].setW( mainItem1Addr );                                  //  Link to main item sector 1
+    miscStringToWord36Fieldata("F     ", &pMainItem0[016]);                 // asg mnemonic
+    pMainItem0[013].setW( leadItemAddr );                                   //  Link back to lead item sector 0
+    pMainItem0[017].setH2( 0 );                                             // cumulative assign count
+    pMainItem0[021].setS2( 070 );                                           // inhibit flags guarded, inhibit rolout, private
+    pMainItem0[021].setT2( 0 );                                             // current assigned count
+    pMainItem0[021].setT3( 1 );                                             // absolute fcycle
+    pMainItem0[022] = currentTDate;                                         // TDATE$ of current assign
+    pMainItem0[023] = currentTDate;                                         // TDATE$ of catalog
+    pMainItem0[024].setH1( 1 );                                             // init grans
+    pMainItem0[025].setH1( 0777777 );                                       // max grans - max possible
+    //  highest granule assigned, and highest track written are zero (H1 of 026 and 027).
+    //  They're already zero, so...
 
     return result;
 }
 
 
-//  getLeadItemAddress()
+//  initializeCatalogMFDMainItem1()
 //
-//  Retrieves the lead item address for a given qualifier/filename, if it exists.
-DSADDR
-MFDManager::getLeadItemAddress
+//  subfunction of initializeCatalogMFD() - we assume the sector buffer has been cleared.
+inline MFDManager::Result
+MFDManager::initializeCatalogMFDMainItem1
 (
-    const Word36* const pQualifier,
-    const Word36* const pFileName
-) const
+    const DSADDR        mainItem1Addr,
+    const DSADDR        mainItem0Addr
+)
 {
-    //  Find the search item for the given qual/file combination, if it exists
-    INDEX hx = getLookupTableHashIndex( pQualifier, pFileName );
-    DSADDR lookupAddr = m_SearchItemLookupTable[hx];
-
-    Word36* pLookupItem = 0;
-    Word36* pEntry = 0;
-    while ( lookupAddr != 0 )
-    {
-        //  Don't go overboard on this - if we don't find it, we don't find it.  Don't crash things.
-        Result result;
-        if ( !stageDirectorySector( lookupAddr, &pLookupItem, &result ) )
-            return 0;
-
-        pEntry = &pLookupItem[1];
-        for ( INDEX ex = 0; ex < 5; ++ex )
-        {
-            if ( (pEntry[0].getW() == pQualifier[0].getW()) && (pEntry[1].getW() == pQualifier[1].getW())
-                && (pEntry[2].getW() == pFileName[0].getW()) && (pEntry[3].getW() == pFileName[1].getW()) )
-            {
-                return getLinkAddress( pEntry[4] );
-            }
+    Result result;
 
-            pEntry += 5;
-        }
+    //  Find the sector
+    Word36* pMainItem1 = 0;
+    if ( !stageDirectorySector( mainItem1Addr, true, &pMainItem1, &result ) )
+        return result;
 
-        lookupAddr = getLinkAddress( pLookupItem[0] );
-    }
+    pMainItem1[0].setW( 0400000000000 );
+    miscStringToWord36Fieldata( MFDFQualifier, &pMainItem1[1], 2 );     //  Qualifier (again)
+    miscStringToWord36Fieldata( MFDFFileName, &pMainItem1[3], 2 );      //  Filename (again)
+    miscStringToWord36Fieldata( "*NO.1*", &pMainItem1[5], 1 );          //  Identifies the ordinal of this sector
+    pMainItem1[6].setW( mainItem0Addr );                                //  Link back to main item sector 0
+    pMainItem1[7].setT3( 1 );                                           // abs file cycle
+    pMainItem1[011].setS1( 1 );                                         // one backup level allowed (does this matter?)
 
-    return 0;
+    return result;
 }
 
 
-//  getSearchItemAddress()
+//  initializeCatalogMFDSearchItem()
 //
-//  Retrieves the search item address for a given qualifier/filename, if it exists.
-//  For qualifiers and filenames in Fieldata LJSF format
-inline DSADDR
-MFDManager::getSearchItemAddress
+//  subfunction of initializeCatalogMFD()
+inline MFDManager::Result
+MFDManager::initializeCatalogMFDSearchItem
 (
-    const Word36* const pQualifier,
-    const Word36* const pFileName
-) const
+    const DSADDR        searchItemAddr,
+    const DSADDR        leadItem0Addr
+)
 {
-    //  Find the search item for the given qual/file combination, if it exists
-    INDEX hx = getLookupTableHashIndex( pQualifier, pFileName );
-    return m_SearchItemLookupTable[hx];
-}
+    Result result;
 
+    //  Find the sector
+    Word36* pSearchItem = 0;
+    if ( !stageDirectorySector( searchItemAddr, true, &pSearchItem, &result ) )
+        return result;
 
-//  getSearchItemAddress()
-//
-//  Retrieves the search item address for a given qualifier/filename, if it exists.
-//  For qualifiers and filenames held in SuperString objects
-inline DSADDR
-MFDManager::getSearchItemAddress
-(
-    const SuperString&  qualifier,
-    const SuperString&  fileName
-) const
-{
-    //  Convert superstrings to FD LJSF
-    std::string tempQual = qualifier;
-    tempQual.resize( 12, ' ' );
-    std::string tempFile = fileName;
-    tempFile.resize( 12, ' ' );
+    //  Populate the sector with a single entry for SYS$*MFDF$$
+    pSearchItem[0].setW( 0440000000000ll );
+    miscStringToWord36Fieldata( MFDFQualifier, &pSearchItem[1], 2 );
+    miscStringToWord36Fieldata( MFDFFileName, &pSearchItem[3], 2 );
+    pSearchItem[5].setW( leadItem0Addr );
 
-    Word36 fdQual[2];
-    miscStringToWord36Fieldata( tempQual, fdQual, 2 );
-    Word36 fdFile[2];
-    miscStringToWord36Fieldata( tempFile, fdFile, 2 );
+    //  Update lookup table to point to this sector
+    INDEX hashIndex = getLookupTableHashIndex( &pSearchItem[1], &pSearchItem[3] );
+    m_SearchItemLookupTable[hashIndex] = searchItemAddr;
 
-    //  Find the search item for the given qual/file combination, if it exists
-    INDEX hx = getLookupTableHashIndex( fdQual, fdFile );
-    return m_SearchItemLookupTable[hx];
+    return result;
 }
 
 
-//  initializeAssignMFD()
+//  initializeCreateMFDDADTable
 //
-//  Assigns SYS$*MFDF$$ to the Exec.  For initial boots.
+//  Creates a DAD table for the MFD.
+//  We update the main item, so the caller must make sure it is marked updated.
+//
+//  If successful, we pass back a pointer to a newly-allocated FAT.
 MFDManager::Result
-MFDManager::initializeAssignMFD
+MFDManager::initializeCreateMFDDADTable
 (
     Activity* const             pActivity,
-    const DSADDR                mfdMainItem0Addr,
-    FileAllocationTable* const  pMFDFat             //  Pre-created FAT for MFD
+    const DSADDR                mainItem0Addr,
+    FileAllocationTable** const ppMFDFat
 )
 {
     Result result;
 
-    //  Find highest track for MFD - not hard to do.  Of course, we don't ever use it...
-    CITDIRECTORYCACHE itLast = m_DirectoryCache.end();
-    if ( itLast == m_DirectoryCache.begin() )
+    //  Create FileAllocationTable
+    FileAllocationTable* pMFDFat = new FileAllocationTable( mainItem0Addr, false );
+
+    //  Now iterate over all of the packs in the fixed pool
+    for ( ITPACKINFOMAP itpi = m_PackInfo.begin(); itpi != m_PackInfo.end(); ++itpi )
     {
-        SystemLog::write("MFDManager::initializeAssignMFD() cache is empty");
-        result.m_Status = MFDST_INTERNAL_ERROR; //  cache should never be empty at this point
-        return result;
-    }
+        PackInfo* pPackInfo = itpi->second;
+        //  Don't worry UP or SU... If it's in the fixed pool, it is UP or SU,
+        //  and if the user tries to trip us up with a well-timed DN or RV keyin, screw him.
+        //  In fact, maybe we should restrict those keyins during the initialization process...
+        if ( pPackInfo->m_InFixedPool )
+        {
+            //  Stage sector 1 for the pack
+            DSADDR sector0Addr = (pPackInfo->m_LDATIndex << 18);
+            Word36* pSector0 = 0;
+            if ( !stageDirectorySector( sector0Addr, false, &pSector0, &result ) )
+                return result;
 
-    --itLast;
-    DSADDR lastDSAddress = itLast->first;
-    UINT32 highestTrack = static_cast<UINT32>( (lastDSAddress >> 6) & 077777777 );
-    UINT32 highestGranule = highestTrack;
+            DSADDR sector1Addr = sector0Addr + 1;
+            Word36* pSector1 = 0;
+            if ( !stageDirectorySector( sector1Addr, false, &pSector1, &result ) )
+                return result;
 
-    DiskFacilityItem* pFacItem = new DiskFacilityItem( MFDFFileName,
-                                                       MFDFQualifier,
-                                                       ECODE_WORD_DISK,
-                                                       OPTB_A | OPTB_X,
-                                                       false,               //  release flag
-                                                       0,                   //  absolute file cycle
-                                                       false,               //  absolute file cycle (not) given
-                                                       true,                //  exclusive assign
-                                                       true,                //  existing file flag
-                                                       mfdMainItem0Addr,
-                                                       false,               //  read (not) inhibited
-                                                       false,               //  read key (not) needed
-                                                       0,                   //  relative file cycle
-                                                       false,               //  relative file cycle (not) given
-                                                       false,               //  temporary file flag
-                                                       false,               //  write (not) inhibited
-                                                       false,               //  write key (not) needed
-                                                       pMFDFat,
-                                                       MSGRAN_TRACK,
-                                                       highestGranule,
-                                                       highestTrack,
-                                                       0,                   //  initial granules
-                                                       0777777 );           //  max granules
+            SECTOR_COUNT dasOffset = pSector1[020].getH2();
+            if ( dasOffset != 0 )
+            {
+                //  Initial tracks are all contiguous, except (possibly) the first DAS track
+                //  There is some ambiguity as to whether initial tracks count includes the first DAS track,
+                //  so we avoid using that value.  Instead, we figure out how many directory tracks preceed the
+                //  DAS track, based on the dasOffset value.
+                TRACK_COUNT initTracks = dasOffset / SECTORS_PER_TRACK;
+                TRACK_ID firstDiskDirectoryTrack = pPackInfo->m_DirectoryTrackAddress / SECTORS_PER_TRACK;
+                TRACK_ID firstFileRelativeTrack = pPackInfo->m_LDATIndex << 12;
+                pMFDFat->allocated( firstFileRelativeTrack, initTracks, pPackInfo->m_LDATIndex, firstDiskDirectoryTrack );
 
-    //  Now attach the FACitem to the RunInfo
-    RunInfo* pRunInfo = pActivity->getRunInfo();
-    pRunInfo->attach();
-    pRunInfo->insertFacilityItem( pFacItem );
-    pRunInfo->detach();
+                //  Account for first DAS track
+                DRWA firstDASDiskWord = pSector0[033].getW();
+                TRACK_ID firstDiskDASTrack = firstDASDiskWord / WORDS_PER_TRACK;
+                TRACK_ID firstFileDASTrack = firstFileRelativeTrack + initTracks;
+                pMFDFat->allocated( firstFileDASTrack, 1, pPackInfo->m_LDATIndex, firstDiskDASTrack );
+            }
+            else
+            {
+                //  In this case, we have at most 9 directory tracks, which means they all fit in the sector 0 DAS.
+                //  Account for the first (DAS) track.
+                TRACK_ID deviceRelativeTrackId = pPackInfo->m_DirectoryTrackAddress / SECTORS_PER_TRACK;
+                TRACK_ID fileRelativeTrackId = pPackInfo->m_LDATIndex << 12;
+                pMFDFat->allocated( fileRelativeTrackId, 1, pPackInfo->m_LDATIndex, deviceRelativeTrackId );
 
-    //  Go back to the main item and set the assignment fields
-    //  Main item 0[017].H2 is cumulative assign count
-    //  Main item 0[021].T2 is current assign count
-    //  Main item 0[021].bit9 is exclusive use flag
-    //  Main item 0[022].W is TDATE$ current assignment started
-    Word36* pMainItem0 = 0;
-    if ( !stageDirectorySector( mfdMainItem0Addr, true, &pMainItem0, &result ) )
-        return result;
+                //  Account for subsequent (if any) tracks according to the DAS
+                Word36* pEntry = &pSector0[3];
+                for ( INDEX ex = 1; ex < 9; ++ex )
+                {
+                    ++fileRelativeTrackId;
+                    if ( !pEntry->isNegative() )
+                    {
+                        DRWA directoryTrackWordId = pEntry->getW();
+                        deviceRelativeTrackId = directoryTrackWordId / WORDS_PER_TRACK;
+                        pMFDFat->allocated( fileRelativeTrackId, 1, pPackInfo->m_LDATIndex, deviceRelativeTrackId );
+                    }
 
-    pMainItem0[017].setH2( 1 );
-    pMainItem0[021].setT2( 1 );
-    pMainItem0[021].logicalOr( 0000400000000L );
+                    pEntry += 3;
+                }
+            }
+        }
+    }
 
-    TDate* pTDate = reinterpret_cast<TDate*>( &pMainItem0[022] );
-    m_pExec->getExecTimeTDate( pTDate );
+    //  Update the DAD in the FAT, then write it to the MFD
+    pMFDFat->synchronizeDADTables();
 
-    DEBUG_INSERT( mfdMainItem0Addr );
+    Word36* pMainItem0 = 0;
+    if ( !stageDirectorySector( mainItem0Addr, true, &pMainItem0, &result ) )
+        return result;
+
+    result = writeDADUpdates( pActivity, pMFDFat );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+    {
+        delete pMFDFat;
+        pMFDFat = 0;
+    }
 
+    *ppMFDFat = pMFDFat;
     return result;
 }
 
 
-//  initializeCatalogMFD()
+//  initializeFixedPack()
 //
-//  Creates an entry in the MFD, to describe the MFD.  Creates DAD entries as well.
-//  Returns DSADDR of main item sector 0 to the caller through the parameter list.
+//  Initializes the fixed pack on the indicated device.
+//  Clears out the MFD (if there is such) on the pack, copies HMBT to SMBT,
+//  and allocates an empty directory track beyond the initial tracks.
+//  All this is done in the cache, which must be committed at some point.
+//  Most of this would not be necessary for a freshly-prepped pack, but we do it anyway.
+//
+//  Caller must comit MFD updates.
+//  We do not stop the Exec on IO errors - caller must decide whether that is appropriate.
 MFDManager::Result
-MFDManager::initializeCatalogMFD
+MFDManager::initializeFixedPack
 (
-    Activity* const             pActivity,
-    DSADDR* const               pMainItem0Addr,
-    FileAllocationTable** const ppMFDFat
+    Activity* const         pActivity,
+    ITPACKINFOMAP           itPackInfo
 )
 {
     Result result;
 
-    //  Catalog SYS$*MFDF$$ and create the DAD table in the MFD update cache.
-    //  All updates go to MFD staged update area.
-    //  Put the directory sectors on the first fixed device.
-    LDATINDEX ldatIndex = 1;
+    LDATINDEX ldatIndex = itPackInfo->first;
+    PackInfo* pPackInfo = itPackInfo->second;
 
-    DSADDR searchItemAddr = 0;
-    result = allocateDirectorySector( pActivity, ldatIndex, &searchItemAddr );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
-        return result;
+    //  Load initial directory tracks from the pack into directory cache.
+    //  Start with the first directory track.
+    BLOCK_ID firstBlockId = pPackInfo->m_DirectoryTrackAddress / SECTORS_PER_BLOCK( pPackInfo->m_PrepFactor );
+    DSADDR sector0Addr = pPackInfo->m_LDATIndex << 18;
+    DSADDR sector1Addr = sector0Addr + 1;
 
-    DSADDR leadItemAddr = 0;
-    result = allocateDirectorySector( pActivity, ldatIndex, &leadItemAddr );
+    result = loadDirectoryTrackIntoCache( pActivity, pPackInfo, sector0Addr, firstBlockId );
     if ( result.m_Status != MFDST_SUCCESSFUL )
         return result;
 
-    DSADDR mainItem0Addr = 0;
-    result = allocateDirectorySector( pActivity, ldatIndex, &mainItem0Addr );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
+    //  Go find the next directory track (if any) - this depends on whether we are chasing DAS sectors.
+    //  We determine this by checking sector1[020].H2:
+    //      If zero, then sector0 is a DAS.
+    //      Else it is the number of sectors up to, but not including, the first DAS
+    //          (and thus can be used as the sector offset from sector 0, for the first DAS).
+    Word36* pSector0 = 0;
+    if ( !stageDirectorySector( sector0Addr, false, &pSector0, &result ) )
         return result;
 
-    DSADDR mainItem1Addr = 0;
-    result = allocateDirectorySector( pActivity, ldatIndex, &mainItem1Addr );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
+    Word36* pSector1 = 0;
+    if ( !stageDirectorySector( sector1Addr, true, &pSector1, &result ) )
         return result;
 
-    result = initializeCatalogMFDSearchItem( searchItemAddr, leadItemAddr );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
-        return result;
+    UINT32 dasOffset = pSector1[020].getH2();
+    if ( dasOffset == 0 )
+    {
+        //  First DAS is in sector 0 - we will need to chase track information in the DAS.
+        //  However, we know that there are 9 or fewer tracks, so we don't have to chase DAS sectors.
+        //  So we just have to iterate over 8 DAS track 3-word entries (since we already loaded the first one).
+        for ( INDEX32 ex = 1; ex < 9; ++ex )
+        {
+            Word36* pEntry = pSector0 + (3 * ex);
+            if ( !pEntry->isNegative() )
+            {
+                DSADDR dirSectorAddr = sector0Addr + (ex * SECTORS_PER_TRACK);
+                DRWA dirTrackAddr = pEntry->getW();
+                BLOCK_ID dirBlockId = dirTrackAddr * BLOCKS_PER_TRACK(pPackInfo->m_PrepFactor);
+                result = loadDirectoryTrackIntoCache( pActivity, pPackInfo, dirSectorAddr, dirBlockId );
+                if ( result.m_Status != MFDST_SUCCESSFUL )
+                    return result;
+            }
+        }
 
-    result = initializeCatalogMFDLeadItem( leadItemAddr, mainItem0Addr );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
-        return result;
+        //  Now build sector 0 according to rules for small disks
+        buildSector0ForSmallDisks( pSector0,
+                                   pPackInfo->m_DirectoryTrackAddress,
+                                   pPackInfo->m_S0S1HMBTPadWords,
+                                   pPackInfo->m_SMBTWords );
+        DEBUG_INSERT( sector0Addr );
+    }
+    else
+    {
+        //  First DAS follows contiguous MBT directory tracks.
+        //  Load the directory tracks.  Make sure we're talking about a multiple of 9 of them.
+        TRACK_COUNT directoryTracks = pSector0[0].getS1();
+        if ( directoryTracks % 9 )
+            directoryTracks -= (directoryTracks % 9);
+        BLOCK_ID blockId = firstBlockId + BLOCKS_PER_TRACK(pPackInfo->m_PrepFactor);
+        DSADDR sectorAddr = sector0Addr + SECTORS_PER_TRACK;
+        for ( TRACK_COUNT track = 1; track < directoryTracks; ++track )
+        {
+            result = loadDirectoryTrackIntoCache( pActivity, pPackInfo, sectorAddr, blockId );
+            if ( result.m_Status != MFDST_SUCCESSFUL )
+                return result;
+            sectorAddr += SECTORS_PER_TRACK;
+            blockId += BLOCKS_PER_TRACK(pPackInfo->m_PrepFactor);
+        }
 
-    result = initializeCatalogMFDMainItem0( mainItem0Addr, leadItemAddr, mainItem1Addr );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
-        return result;
+        //  Sector0 is formatted according to rules for large disks - this is not a DAS sector.
+        //  It should be all zeroes except for +0,S1 which contains the
+        //  number of initial directory tracks used to host S0/S1/HMBT/padding/SMBT, and +27,W
+        //  which is the link to the first DAS track.  We don't need to change this.
+        //  However, we DO need to initialize the DAS in the DAS track which it references.
+        Word36* pDAS = allocateCacheSector();
+        buildEmptyDASSector( pDAS, pPackInfo->m_LDATIndex );
 
-    result = initializeCatalogMFDMainItem1( mainItem1Addr, mainItem0Addr );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
-        return result;
+        //  Now stage the DAS track - we don't actually load it, since we don't care what's in it.
+        //  Additionally, some storage media might give us errors it that track hasn't yet been written.
+        DSADDR dasSectorAddr = sector0Addr + dasOffset;
+        TRACK_ID dasTrackId = dasSectorAddr >> 6;
+        DRWA dasDeviceTrackWord = pSector0[033].getW();
+        TRACK_ID dasDeviceTrackId = dasDeviceTrackWord / WORDS_PER_TRACK;
+        BLOCK_ID dasBlockId = dasDeviceTrackId * BLOCKS_PER_TRACK(pPackInfo->m_PrepFactor);
+        m_DirectoryTrackIdMap[dasTrackId] = dasBlockId;
 
-    result = initializeCreateMFDDADTable( pActivity, mainItem0Addr, ppMFDFat );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
-        return result;
+        releaseCacheSector( m_DirectoryCache[dasSectorAddr] );
+        m_DirectoryCache[dasSectorAddr] = pDAS;
+        for ( INDEX32 sx = 1; sx < SECTORS_PER_TRACK; ++sx )
+        {
+            Word36*& pCacheSector = m_DirectoryCache[dasSectorAddr + sx];
+            if ( pCacheSector == 0 )
+                pCacheSector = allocateCacheSector();
+        }
+    }
+
+    //  Fix up sector 1.  update word 3 (current available tracks) from word 2 (max avail),
+    //  and put LDAT Index in word 5,H1
+    pSector1[3].setW( pSector1[2].getW() );
+    pSector1[5].setH1( ldatIndex );
+
+    //  Copy HMBT to SMBT, effectively releasing all allocated non-directory tracks (if any).
+    DSADDR hmbtAddr = (ldatIndex << 18) | 2;
+    DSADDR smbtAddr = (ldatIndex << 18) | static_cast<COUNT32>(pPackInfo->m_S0S1HMBTPadWords / 28);
+    SECTOR_COUNT smbtSectors = pPackInfo->m_SMBTWords / 28;
+    if ( pPackInfo->m_SMBTWords % 28 )
+        ++smbtSectors;
+
+    Word36* pHMBTSector = 0;
+    Word36* pSMBTSector = 0;
+    for ( SECTOR_COUNT sc = 0; sc < smbtSectors; ++sc )
+    {
+        if ( !stageDirectorySector( hmbtAddr, false, &pHMBTSector, &result ) )
+            return result;
+        if ( !stageDirectorySector( smbtAddr, true, &pSMBTSector, &result ) )
+            return result;
+        for ( INDEX wx = 0; wx < 28; ++wx )
+            pSMBTSector[wx] = pHMBTSector[wx];
+        ++smbtAddr;
+        ++hmbtAddr;
+    }
 
-    *pMainItem0Addr = mainItem0Addr;
     return result;
 }
 
 
-//  initializeCatalogMFDLeadItem()
+//  initializeFixedPacks()
 //
-//  subfunction of initializeCatalogMFD() - we assume the sector buffer has been cleared.
-inline MFDManager::Result
-MFDManager::initializeCatalogMFDLeadItem
+//  Called early in jk13 boot - after pack labels are read, LDATs are assigned,
+//  m_PackInfo is populated, and initial directory sectors are loaded.
+//  We cannot commit the consequent MFD updates yet, since the FAT isn't loaded for the MFD.
+//  This means the caller must do this commit as soon as it is practical.
+MFDManager::Result
+MFDManager::initializeFixedPacks
 (
-    const DSADDR        leadItem0Addr,
-    const DSADDR        mainItem0Addr
+    Activity* const         pActivity
 )
 {
+    //  No lock required - this occurs early in boot
     Result result;
-
-    //  Find the sector
-    Word36* pLeadItem = 0;
-    if ( !stageDirectorySector( leadItem0Addr, true, &pLeadItem, &result ) )
-        return result;
-
-    pLeadItem[0].setW(0500000000000ll);         //  Descriptor and empty link address
-    miscStringToWord36Fieldata( MFDFQualifier, &pLeadItem[1], 2 );
-    miscStringToWord36Fieldata( MFDFFileName, &pLeadItem[3], 2 );
-    miscStringToWord36Fieldata( m_OverheadUserId, &pLeadItem[5], 2 );   //  Project-ID field
-    pLeadItem[011].setS2( 1 );                  //  number of f-cycles existing
-    pLeadItem[011].setS3( 1 );                  //  maximum range of f-cycles
-    pLeadItem[011].setQ3( 1 );                  //  current range
-    pLeadItem[011].setQ4( 1 );                  //  highest absolute f-cycle
-    pLeadItem[012].setT1( 04000 );              //  status bits - Guarded File
-    pLeadItem[013].setW( mainItem0Addr );       //  link to main item 0 for the only cycle of the file
+    for ( ITPACKINFOMAP itpi = m_PackInfo.begin(); itpi != m_PackInfo.end(); ++itpi )
+    {
+        if ( itpi->second->m_IsFixed )
+        {
+            BootProfile::Span span( m_pExec->getBootProfile(), "INIT PACK " + itpi->second->m_PackName );
+            result = initializeFixedPack( pActivity, itpi );
+            if ( result.m_Status != MFDST_SUCCESSFUL )
+                break;
+        }
+    }
 
     return result;
 }
 
 
-//  initializeCatalogMFDMainItem0()
+//  initializeLoadPackInfo()
 //
-//  subfunction of initializeCatalogMFD() - we assume the sector buffer has been cleared.
-inline MFDManager::Result
-MFDManager::initializeCatalogMFDMainItem0
+//  Iterates over the given list of PackInfo objects (which do not yet have LDAT's, so are not in m_PackInfo)
+//  assigning LDATs to all the packs and building up m_PackInfo.
+void
+MFDManager::initializeLoadPackInfo
 (
-    const DSADDR        mainItem0Addr,
-    const DSADDR        leadItemAddr,
-    const DSADDR        mainItem1Addr
+    Activity* const         pActivity,
+    const PACKINFOLIST&     packInfoList
 )
 {
-    Result result;
-
-    //  Find the sector
-    Word36* pMainItem0 = 0;
-    if ( !stageDirectorySector( mainItem0Addr, true, &pMainItem0, &result ) )
-        return result;
-
-    TDate currentTDate;
-    m_pExec->getExecTimeTDate( &currentTDate );
+//????    DeviceManager* pdevmgr = dynamic_cast<DeviceManager*>( m_pExec->getManager( Exec::MID_DEVICE_MANAGER ) );
+    LDATINDEX nextLDAT = 1;
+    for ( CITPACKINFOLIST itpi = packInfoList.begin(); itpi != packInfoList.end(); ++itpi )
+    {
+        PackInfo* pPackInfo = *itpi;
+        if ( pPackInfo->m_IsFixed )
+        {
+            //  This pack is fixed - is it in conflict with any other already-'registered' fixed pack?
+            //  If so, mark it DN.
+            bool conflict = false;
+            for ( CITPACKINFOMAP itpiRegistered = m_PackInfo.begin(); itpiRegistered != m_PackInfo.end(); ++itpiRegistered )
+            {
+                PackInfo* pRegisteredPackInfo = itpiRegistered->second;
+                if ( pPackInfo->m_PackName.compareNoCase( pRegisteredPackInfo->m_PackName ) == 0 )
+                {
+                    std::string consMsg = "DEVICE ";
+                    consMsg += m_pDeviceManager->getNodeName( pPackInfo->m_DeviceId ) + " PACK-ID CONFLICT";
+                    m_pConsoleManager->postReadOnlyMessage( consMsg, 0 );
+                    m_pDeviceManager->setNodeDownInternally( pActivity, pPackInfo->m_DeviceId );
+                    conflict = true;
+                    break;
+                }
+            }
 
-    pMainItem0[0].setW( 0600000000000ll );                                  //  DAD link - no link for now
-    miscStringToWord36Fieldata( MFDFQualifier, &pMainItem0[1], 2 );         //  Qualifier
-    miscStringToWord36Fieldata( MFDFFileName, &pMainItem0[3], 2 );          //  FileName
-    miscStringToWord36Fieldata( m_OverheadUserId, &pMainItem0[5], 2 );      //  User-id for Project-id
-    miscStringToWord36Fieldata( m_OverheadAccountId, &pMainItem0[7], 2 );   //  Account-id
-    pMainItem0[015].setW( mainItem1Addr );                                  //  Link to main item sector 1
-    miscStringToWord36Fieldata("F     ", &pMainItem0[016]);                 // asg mnemonic
-    pMainItem0[013].setW( leadItemAddr );                                   //  Link back to lead item sector 0
-    pMainItem0[017].setH2( 0 );                                             // cumulative assign count
-    pMainItem0[021].setS2( 070 );                                           // inhibit flags guarded, inhibit rolout, private
-    pMainItem0[021].setT2( 0 );                                             // current assigned count
-    pMainItem0[021].setT3( 1 );                                             // absolute fcycle
-    pMainItem0[022] = currentTDate;                                         // TDATE$ of current assign
-    pMainItem0[023] = currentTDate;                                         // TDATE$ of catalog
-    pMainItem0[024].setH1( 1 );                                             // init grans
-    pMainItem0[025].setH1( 0777777 );                                       // max grans - max possible
-    //  highest granule assigned, and highest track written are zero (H1 of 026 and 027).
-    //  They're already zero, so...
+            if ( !conflict )
+            {
+                //  No conflict - assign an LDAT and integrate the pack into the fixed pool
+                pPackInfo->m_LDATIndex = nextLDAT++;
+                m_PackInfo[pPackInfo->m_LDATIndex] = pPackInfo;
+                pPackInfo->m_InFixedPool = true;
+                pPackInfo->m_AssignCount = 1;
 
-    return result;
+                //  Notify listeners
+                /*???? obsolete, but keep it around in case
+                const DeviceManager::NodeEntry* pNodeEntry = pdevmgr->getNodeEntry( pPackInfo->m_DeviceId );
+                m_pExec->postNodeChangeEvent( pNodeEntry->m_pNode );
+                */
+            }
+        }
+    }
 }
 
 
-//  initializeCatalogMFDMainItem1()
+//  insertMainItem()
 //
-//  subfunction of initializeCatalogMFD() - we assume the sector buffer has been cleared.
-inline MFDManager::Result
-MFDManager::initializeCatalogMFDMainItem1
-(
-    const DSADDR        mainItem1Addr,
-    const DSADDR        mainItem0Addr
-)
-{
-    Result result;
-
-    //  Find the sector
-    Word36* pMainItem1 = 0;
-    if ( !stageDirectorySector( mainItem1Addr, true, &pMainItem1, &result ) )
-        return result;
-
-    pMainItem1[0].setW( 0400000000000 );
-    miscStringToWord36Fieldata( MFDFQualifier, &pMainItem1[1], 2 );     //  Qualifier (again)
-    miscStringToWord36Fieldata( MFDFFileName, &pMainItem1[3], 2 );      //  Filename (again)
-    miscStringToWord36Fieldata( "*NO.1*", &pMainItem1[5], 1 );          //  Identifies the ordinal of this sector
-    pMainItem1[6].setW( mainItem0Addr );                                //  Link back to main item sector 0
-    pMainItem1[7].setT3( 1 );                                           // abs file cycle
-    pMainItem1[011].setS1( 1 );                                         // one backup level allowed (does this matter?)
-
-    return result;
-}
-
-
-//  initializeCatalogMFDSearchItem()
+//  Inserts a main item link into the appropriate lead item sector,
+//  according to the indicated absolute file cycle.
 //
-//  subfunction of initializeCatalogMFD()
-inline MFDManager::Result
-MFDManager::initializeCatalogMFDSearchItem
+//  Parameters:
+//      pActivity:          pointer to the controlling Activity
+//      leadItem0Addr:      DSADDR of lead item into which the link is to be inserted
+//      mainItem0Addr:      DSADDR link to main item to be inserted into the lead item
+//      absoluteCycle:      absolute file cycle associated with the relevant main item
+//      guardedFile:        true if main item represents a guarded file cycle (which forces the whole set to be guarded)
+MFDManager::Result
+MFDManager::insertMainItem
 (
-    const DSADDR        searchItemAddr,
-    const DSADDR        leadItem0Addr
+    Activity* const         pActivity,
+    const DSADDR            leadItem0Addr,
+    const DSADDR            mainItem0Addr,
+    const UINT16            absoluteCycle,
+    const bool              guardedFile
 )
 {
     Result result;
 
-    //  Find the sector
-    Word36* pSearchItem = 0;
-    if ( !stageDirectorySector( searchItemAddr, true, &pSearchItem, &result ) )
+    //  Read lead items 0 and optionally 1
+    Word36* pLeadItem0 = 0;
+    Word36* pLeadItem1 = 0;
+    DSADDR leadItem1Addr = 0;
+    if ( !stageLeadItems( leadItem0Addr, true, &leadItem1Addr, &pLeadItem0, &pLeadItem1, &result ) )
         return result;
 
-    //  Populate the sector with a single entry for SYS$*MFDF$$
-    pSearchItem[0].setW( 0440000000000ll );
-    miscStringToWord36Fieldata( MFDFQualifier, &pSearchItem[1], 2 );
-    miscStringToWord36Fieldata( MFDFFileName, &pSearchItem[3], 2 );
-    pSearchItem[5].setW( leadItem0Addr );
-
-    //  Update lookup table to point to this sector
-    INDEX hashIndex = getLookupTableHashIndex( &pSearchItem[1], &pSearchItem[3] );
-    m_SearchItemLookupTable[hashIndex] = searchItemAddr;
-
-    return result;
-}
-
-
-//  initializeCreateMFDDADTable
-//
-//  Creates a DAD table for the MFD.
-//  We update the main item, so the caller must make sure it is marked updated.
-//
-//  If successful, we pass back a pointer to a newly-allocated FAT.
-MFDManager::Result
-MFDManager::initializeCreateMFDDADTable
-(
-    Activity* const             pActivity,
-    const DSADDR                mainItem0Addr,
-    FileAllocationTable** const ppMFDFat
-)
-{
-    Result result;
+    //  Update lead items 0 and possibly 1.  If the fileset is empty, this is pretty simple.
+    COUNT currentCycleRange = pLeadItem0[011].getQ3();
 
-    //  Create FileAllocationTable
-    FileAllocationTable* pMFDFat = new FileAllocationTable( mainItem0Addr, false );
+    //  If this cycle is guarded, the whole set becomes guarded.
+    if ( guardedFile )
+        pLeadItem0[012].logicalOr( 0400000000000ll );
 
-    //  Now iterate over all of the packs in the fixed pool
-    for ( ITPACKINFOMAP itpi = m_PackInfo.begin(); itpi != m_PackInfo.end(); ++itpi )
+    if ( currentCycleRange == 0 )
     {
-        PackInfo* pPackInfo = itpi->second;
-        //  Don't worry UP or SU... If it's in the fixed pool, it is UP or SU,
-        //  and if the user tries to trip us up with a well-timed DN or RV keyin, screw him.
-        //  In fact, maybe we should restrict those keyins during the initialization process...
-        if ( pPackInfo->m_InFixedPool )
+        //  Empty file set - this is the only cycle that will exist in the file set.
+        pLeadItem0[011].setS2( 1 );
+        pLeadItem0[011].setQ3( 1 );
+        pLeadItem0[011].setQ4( absoluteCycle );
+        pLeadItem0[013].setW( mainItem0Addr );
+    }
+    else
+    {
+        //  Non-empty file set - we have to maneuver around other existing file cycles.
+        //  Calculate the new cycle range - it might be different from the current, and the exact calculation
+        //  depends on whether the new cycle is higher or lower than the current absolute max cycle.
+        UINT16 currentHighestAbsoluteCycle = pLeadItem0[011].getQ4();
+        COUNT newCycleRange = 0;
+        UINT16 compRange = execGetAbsoluteCycleRange( absoluteCycle, currentHighestAbsoluteCycle );   //  range from current highest to new abs cycle
+        int comparison = execCompareAbsoluteCycles( absoluteCycle, currentHighestAbsoluteCycle );   //  comparison from new cycle to current highest
+        if ( comparison > 0 )
         {
-            //  Stage sector 1 for the pack
-            DSADDR sector0Addr = (pPackInfo->m_LDATIndex << 18);
-            Word36* pSector0 = 0;
-            if ( !stageDirectorySector( sector0Addr, false, &pSector0, &result ) )
-                return result;
-
-            DSADDR sector1Addr = sector0Addr + 1;
-            Word36* pSector1 = 0;
-            if ( !stageDirectorySector( sector1Addr, false, &pSector1, &result ) )
-                return result;
+            //  new cycle sorts higher than any existing cycles, so the range *will* be extended.
+            newCycleRange = currentCycleRange + compRange - 1;
+        }
+        else
+        {
+            //  new cycle sorts lower than the highest existing cycle, so the range *might* be extended.
+            newCycleRange = compRange > currentCycleRange ? compRange : currentCycleRange;
+        }
 
-            SECTOR_COUNT dasOffset = pSector1[020].getH2();
-            if ( dasOffset != 0 )
-            {
-                //  Initial tracks are all contiguous, except (possibly) the first DAS track
-                //  There is some ambiguity as to whether initial tracks count includes the first DAS track,
-                //  so we avoid using that value.  Instead, we figure out how many directory tracks preceed the
-                //  DAS track, based on the dasOffset value.
-                TRACK_COUNT initTracks = dasOffset / SECTORS_PER_TRACK;
-                TRACK_ID firstDiskDirectoryTrack = pPackInfo->m_DirectoryTrackAddress / SECTORS_PER_TRACK;
-                TRACK_ID firstFileRelativeTrack = pPackInfo->m_LDATIndex << 12;
-                pMFDFat->allocated( firstFileRelativeTrack, initTracks, pPackInfo->m_LDATIndex, firstDiskDirectoryTrack );
+        //  If the new cycle range is different than the existing cycle range, update lead item 0.
+        //  Then, if the original range didn't require a sector 1, and the new one does,
+        //  create and link in a new lead item sector 1.
+        if ( newCycleRange != currentCycleRange )
+        {
+            pLeadItem0[011].setQ3( newCycleRange );
 
-                //  Account for first DAS track
-                DRWA firstDASDiskWord = pSector0[033].getW();
-                TRACK_ID firstDiskDASTrack = firstDASDiskWord / WORDS_PER_TRACK;
-                TRACK_ID firstFileDASTrack = firstFileRelativeTrack + initTracks;
-                pMFDFat->allocated( firstFileDASTrack, 1, pPackInfo->m_LDATIndex, firstDiskDASTrack );
-            }
-            else
+            if ( (newCycleRange > 17) && (leadItem1Addr == 0) )
             {
-                //  In this case, we have at most 9 directory tracks, which means they all fit in the sector 0 DAS.
-                //  Account for the first (DAS) track.
-                TRACK_ID deviceRelativeTrackId = pPackInfo->m_DirectoryTrackAddress / SECTORS_PER_TRACK;
-                TRACK_ID fileRelativeTrackId = pPackInfo->m_LDATIndex << 12;
-                pMFDFat->allocated( fileRelativeTrackId, 1, pPackInfo->m_LDATIndex, deviceRelativeTrackId );
+                LDATINDEX preferredLDATIndex = leadItem0Addr >> 18;
+                result = allocateDirectorySector( pActivity, preferredLDATIndex, &leadItem1Addr );
+                if ( result.m_Status != MFDST_SUCCESSFUL )
+                    return result;
 
-                //  Account for subsequent (if any) tracks according to the DAS
-                Word36* pEntry = &pSector0[3];
-                for ( INDEX ex = 1; ex < 9; ++ex )
-                {
-                    ++fileRelativeTrackId;
-                    if ( !pEntry->isNegative() )
-                    {
-                        DRWA directoryTrackWordId = pEntry->getW();
-                        deviceRelativeTrackId = directoryTrackWordId / WORDS_PER_TRACK;
-                        pMFDFat->allocated( fileRelativeTrackId, 1, pPackInfo->m_LDATIndex, deviceRelativeTrackId );
-                    }
+                pLeadItem1 = 0;
+                if ( !stageDirectorySector( leadItem1Addr, false, &pLeadItem1, &result ) )
+                    return result;
 
-                    pEntry += 3;
-                }
+                //  Link item 1 to item 0 and clear item 1's forward link
+                pLeadItem0[0].setW( leadItem1Addr );
+                pLeadItem1[0].setW( 0400000000000 );
             }
         }
-    }
 
-    //  Update the DAD in the FAT, then write it to the MFD
-    pMFDFat->synchronizeDADTables();
+        if ( comparison > 0 )
+        {
+            //  The requested new cycle is higher than the current highest cycle.
+            //  All the existing links will need to be moved downward in the lead items.
+            //  We TRUST that calling code has already dropped cycles needing to be dropped,
+            //  and that this procedure will not produce results inconsistent with max range.
+            INDEX sx = currentCycleRange;
+            INDEX dx = sx + compRange - 1;
+            while ( sx > 0 )
+            {
+                --sx;
+                --dx;
+                {//TODO:DEBUG
+                    std::cout << "Moving " << sx << " to " << dx << std::endl;
+                }
+                Word36* pSource = getMainItemLinkPointer( sx, pLeadItem0, pLeadItem1 );
+                Word36* pDest = getMainItemLinkPointer( dx, pLeadItem0, pLeadItem1 );
+                *pDest = *pSource;
+                pSource->clear();
+            }
 
-    Word36* pMainItem0 = 0;
-    if ( !stageDirectorySector( mainItem0Addr, true, &pMainItem0, &result ) )
-        return result;
+            //  Now create the new link and update the highest absolute cycle
+            pLeadItem0[013].setW( mainItem0Addr );
+            pLeadItem0[011].setQ4( absoluteCycle );
+        }
+        else
+        {
+            //  The requested new cycle sorts lower than the current highest cycle.
+            //  Find the exact location for the main item link.
+            Word36* pEntry = getMainItemLinkPointer( compRange - 1, pLeadItem0, pLeadItem1 );
+            pEntry->setW( mainItem0Addr );
+        }
 
-    result = writeDADUpdates( pActivity, pMFDFat );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
-    {
-        delete pMFDFat;
-        pMFDFat = 0;
+        //  Update number of actual files - we don't have to worry about the actual number,
+        //  we just know we're increasing it by 1.
+        pLeadItem0[011].setS2( pLeadItem0[011].getS2() + 1 );
     }
 
-    *ppMFDFat = pMFDFat;
     return result;
 }
 
 
-//  initializeFixedPack()
-//
-//  Initializes the fixed pack on the indicated device.
-//  Clears out the MFD (if there is such) on the pack, copies HMBT to SMBT,
-//  and allocates an empty directory track beyond the initial tracks.
-//  All this is done in the cache, which must be committed at some point.
-//  Most of this would not be necessary for a freshly-prepped pack, but we do it anyway.
+//  internalPrep()
 //
-//  Caller must comit MFD updates.
-//  We do not stop the Exec on IO errors - caller must decide whether that is appropriate.
+//  Preps a pack as fixed or removable.
+//  Use device's blocksize to determine prepfactor, and blockcount to determine tracks.
+//  Put first directory track about 1/3 of the way through the pack (by convention).
 MFDManager::Result
-MFDManager::initializeFixedPack
+MFDManager::internalPrep
 (
-    Activity* const         pActivity,
-    ITPACKINFOMAP           itPackInfo
+    Activity* const                 pActivity,
+    const DeviceManager::DEVICE_ID  deviceId,
+    const bool                      fixedFlag,
+    const std::string&              packLabel
 )
 {
     Result result;
 
-    LDATINDEX ldatIndex = itPackInfo->first;
-    PackInfo* pPackInfo = itPackInfo->second;
-
-    //  Load initial directory tracks from the pack into directory cache.
-    //  Start with the first directory track.
-    BLOCK_ID firstBlockId = pPackInfo->m_DirectoryTrackAddress / SECTORS_PER_BLOCK( pPackInfo->m_PrepFactor );
-    DSADDR sector0Addr = pPackInfo->m_LDATIndex << 18;
-    DSADDR sector1Addr = sector0Addr + 1;
-
-    result = loadDirectoryTrackIntoCache( pActivity, pPackInfo, sector0Addr, firstBlockId );
+    //  Obtain device info - if we can't get it, we cannot prep the thing.
+    BLOCK_COUNT packBlockCount;
+    BLOCK_SIZE packBlockSize;
+    result = getDiskDeviceValues( pActivity, deviceId, &packBlockCount, &packBlockSize );
     if ( result.m_Status != MFDST_SUCCESSFUL )
         return result;
 
-    //  Go find the next directory track (if any) - this depends on whether we are chasing DAS sectors.
-    //  We determine this by checking sector1[020].H2:
-    //      If zero, then sector0 is a DAS.
-    //      Else it is the number of sectors up to, but not including, the first DAS
-    //          (and thus can be used as the sector offset from sector 0, for the first DAS).
-    Word36* pSector0 = 0;
-    if ( !stageDirectorySector( sector0Addr, false, &pSector0, &result ) )
+    PREP_FACTOR prepFactor = miscGetPrepFactorFromBlockSize( packBlockSize );
+    if ( (prepFactor == 0) || (packBlockCount == 0) )
+    {
+        result.m_Status = MFDST_PACK_NOT_FORMATTED;
         return result;
+    }
 
-    Word36* pSector1 = 0;
-    if ( !stageDirectorySector( sector1Addr, true, &pSector1, &result ) )
+    const DeviceManager::DeviceEntry* pDevEntry = m_pDeviceManager->getDeviceEntry( deviceId );
+    if ( pDevEntry == 0 )
+    {
+        std::stringstream strm;
+        strm << "MFDManager::internalPrep() Cannot get device entry for device ID " << deviceId;
+        SystemLog::write( strm.str() );
+        result.m_Status = MFDST_INTERNAL_ERROR;
         return result;
+    }
 
-    UINT32 dasOffset = pSector1[020].getH2();
-    if ( dasOffset == 0 )
-    {
-        //  First DAS is in sector 0 - we will need to chase track information in the DAS.
-        //  However, we know that there are 9 or fewer tracks, so we don't have to chase DAS sectors.
-        //  So we just have to iterate over 8 DAS track 3-word entries (since we already loaded the first one).
-        for ( INDEX32 ex = 1; ex < 9; ++ex )
-        {
-            Word36* pEntry = pSector0 + (3 * ex);
-            if ( !pEntry->isNegative() )
-            {
-                DSADDR dirSectorAddr = sector0Addr + (ex * SECTORS_PER_TRACK);
-                DRWA dirTrackAddr = pEntry->getW();
-                BLOCK_ID dirBlockId = dirTrackAddr * BLOCKS_PER_TRACK(pPackInfo->m_PrepFactor);
-                result = loadDirectoryTrackIntoCache( pActivity, pPackInfo, dirSectorAddr, dirBlockId );
-                if ( result.m_Status != MFDST_SUCCESSFUL )
-                    return result;
-            }
-        }
+    SuperString adjustedPackLabel = packLabel;
+    adjustedPackLabel.resize( 6, ' ' );
+    adjustedPackLabel.foldToUpperCase();
 
-        //  Now build sector 0 according to rules for small disks
-        buildSector0ForSmallDisks( pSector0,
-                                   pPackInfo->m_DirectoryTrackAddress,
-                                   pPackInfo->m_S0S1HMBTPadWords,
-                                   pPackInfo->m_SMBTWords );
-        DEBUG_INSERT( sector0Addr );
-    }
-    else
-    {
-        //  First DAS follows contiguous MBT directory tracks.
-        //  Load the directory tracks.  Make sure we're talking about a multiple of 9 of them.
-        TRACK_COUNT directoryTracks = pSector0[0].getS1();
-        if ( directoryTracks % 9 )
-            directoryTracks -= (directoryTracks % 9);
-        BLOCK_ID blockId = firstBlockId + BLOCKS_PER_TRACK(pPackInfo->m_PrepFactor);
-        DSADDR sectorAddr = sector0Addr + SECTORS_PER_TRACK;
-        for ( TRACK_COUNT track = 1; track < directoryTracks; ++track )
-        {
-            result = loadDirectoryTrackIntoCache( pActivity, pPackInfo, sectorAddr, blockId );
-            if ( result.m_Status != MFDST_SUCCESSFUL )
-                return result;
-            sectorAddr += SECTORS_PER_TRACK;
-            blockId += BLOCKS_PER_TRACK(pPackInfo->m_PrepFactor);
-        }
+    std::stringstream consStrm;
+    consStrm << "PREP " << pDevEntry->m_pNode->getName()
+        << (fixedFlag ? " FIX" : " REM")
+        << " BSZ=" << packBlockSize
+        << " BLKS=" << packBlockCount
+        << " PREP=" << prepFactor
+        << " LBL=" << packLabel;
+    m_pConsoleManager->postReadOnlyMessage( consStrm.str(), 0 );
 
-        //  Sector0 is formatted according to rules for large disks - this is not a DAS sector.
-        //  It should be all zeroes except for +0,S1 which contains the
-        //  number of initial directory tracks used to host S0/S1/HMBT/padding/SMBT, and +27,W
-        //  which is the link to the first DAS track.  We don't need to change this.
-        //  However, we DO need to initialize the DAS in the DAS track which it references.
-        Word36* pDAS = new Word36[WORDS_PER_SECTOR];
-        buildEmptyDASSector( pDAS, pPackInfo->m_LDATIndex );
+    //  Traditionally, we have used the first 2 physical blocks for booting and such,
+    //  with the third reserved for the pack label.  This does not vary based on the prepfactor.
+    //  (In fact, it is said that the first two physical blocks /can/ vary in size).
+    //  To observe tradition, we'll make sure to reserve at least those 3 physical blocks
+    //  in the hardware master bit table... but we need to know how many tracks we're talking about.
+    TRACK_COUNT reservedTracks = (prepFactor == 1792) ? 3 : (prepFactor == 896) ? 2 : 1;
+    COUNT recordsPerTrack = BLOCKS_PER_TRACK(prepFactor);
+    COUNT sectorsPerBlock = SECTORS_PER_BLOCK(prepFactor);
+    TRACK_COUNT totalTracks = ( packBlockCount * prepFactor ) / 1792;
+    SECTOR_ID firstDirectoryTrackAddr = ( totalTracks / 3 ) * SECTORS_PER_TRACK;
 
-        //  Now stage the DAS track - we don't actually load it, since we don't care what's in it.
-        //  Additionally, some storage media might give us errors it that track hasn't yet been written.
-        DSADDR dasSectorAddr = sector0Addr + dasOffset;
-        TRACK_ID dasTrackId = dasSectorAddr >> 6;
-        DRWA dasDeviceTrackWord = pSector0[033].getW();
-        TRACK_ID dasDeviceTrackId = dasDeviceTrackWord / WORDS_PER_TRACK;
-        BLOCK_ID dasBlockId = dasDeviceTrackId * BLOCKS_PER_TRACK(pPackInfo->m_PrepFactor);
-        m_DirectoryTrackIdMap[dasTrackId] = dasBlockId;
+    //  Calculate mbtLength - this is the length of an MBT, including the 2 delimiting words.
+    WORD_COUNT mbtLength = totalTracks / 32;
+    if ( totalTracks % 32 )
+        ++mbtLength;
+    mbtLength += 2;
+    SECTOR_COUNT smbtSectors = mbtLength / WORDS_PER_SECTOR;
+    if ( mbtLength % WORDS_PER_SECTOR )
+        ++mbtLength;
 
-        m_DirectoryCache[dasSectorAddr] = pDAS;
-        for ( INDEX32 sx = 1; sx < SECTORS_PER_TRACK; ++sx )
-            m_DirectoryCache[dasSectorAddr + sx] = new Word36[WORDS_PER_SECTOR];
-    }
+    //  Calculate hbmtLength - this is the length of S0+S1+HMBT+Padding_to_block_boundary in words.
+    WORD_COUNT hmbtLength = (2 * WORDS_PER_SECTOR) + mbtLength;
+    if ( hmbtLength % prepFactor )
+        hmbtLength = ( ( hmbtLength / prepFactor ) + 1 ) * prepFactor;
+    SECTOR_COUNT hmbtSectors = hmbtLength / WORDS_PER_SECTOR;
+    if ( hmbtLength % WORDS_PER_SECTOR )
+        ++hmbtSectors;
 
-    //  Fix up sector 1.  update word 3 (current available tracks) from word 2 (max avail),
-    //  and put LDAT Index in word 5,H1
-    pSector1[3].setW( pSector1[2].getW() );
-    pSector1[5].setH1( ldatIndex );
+    //  Calculate initial track allocation.
+    //  First, determine number of directory tracks.  If >= 9, then it must be a multiple of 9.
+    //  Then determine the number of initial tracks (directory tracks + track containing VOL1).
+    //  Finally, the number of tracks remaining after initial allocation.
+    TRACK_COUNT directoryTracks = (hmbtLength + mbtLength) / WORDS_PER_TRACK;
+    if ( (hmbtLength + mbtLength) % WORDS_PER_TRACK )
+        ++directoryTracks;
+    //TODO:DEBUG BELOW IS A BUG - LEAVE FOR NOW, TO TEST LARGE DISK ALGORITHMS
+    if ( directoryTracks % 9 )
+        directoryTracks = ( ( directoryTracks / 9 ) + 1 ) * 9;
 
-    //  Copy HMBT to SMBT, effectively releasing all allocated non-directory tracks (if any).
-    DSADDR hmbtAddr = (ldatIndex << 18) | 2;
-    DSADDR smbtAddr = (ldatIndex << 18) | static_cast<COUNT32>(pPackInfo->m_S0S1HMBTPadWords / 28);
-    SECTOR_COUNT smbtSectors = pPackInfo->m_SMBTWords / 28;
-    if ( pPackInfo->m_SMBTWords % 28 )
-        ++smbtSectors;
+    TRACK_COUNT initialTracks = directoryTracks + reservedTracks + (directoryTracks >= 9) ? 1 : 0;
+    TRACK_COUNT remainingTracks = totalTracks - initialTracks;
 
-    Word36* pHMBTSector = 0;
-    Word36* pSMBTSector = 0;
-    for ( SECTOR_COUNT sc = 0; sc < smbtSectors; ++sc )
+    //  If this is a large disk (i.e., 9 or more directory tracks) create a DAS track
+    //  beyond what will become the initial directory tracks.
+    if ( directoryTracks >= 9 )
     {
-        if ( !stageDirectorySector( hmbtAddr, false, &pHMBTSector, &result ) )
+        DRWA dasTrackWordAddress = (firstDirectoryTrackAddr * 28) + (directoryTracks * 1792);
+        result = internalPrepCreateDASSector( pActivity, deviceId, prepFactor, dasTrackWordAddress );
+        if ( result.m_Status != MFDST_SUCCESSFUL )
             return result;
-        if ( !stageDirectorySector( smbtAddr, true, &pSMBTSector, &result ) )
+    }
+
+    //  Build initial directory tracks in-memory.  This takes a nice chunk of memory.
+    //  Note that the initial directory tracks (and the first DAS track for large disks)
+    //  are placed in consecutive physical blocks.
+    Word36* pDirectorySectors = new Word36[WORDS_PER_TRACK * static_cast<COUNT>(directoryTracks)];
+
+    //  Build Sector 0
+    Word36* pSector0 = pDirectorySectors;
+    internalPrepBuildSector0( pSector0, firstDirectoryTrackAddr, directoryTracks, hmbtLength, mbtLength );
+
+    //  Build Sector 1 (always version 1)
+    COUNT dasOffset = pSector0[0].getS1() * SECTORS_PER_TRACK;
+    Word36* pSector1 = pDirectorySectors + WORDS_PER_SECTOR;
+    internalPrepBuildSector1( pSector1, hmbtSectors, smbtSectors, remainingTracks, adjustedPackLabel, mbtLength, dasOffset );
+
+    //  Fill-in HMBT
+    Word36* pHMBT = pDirectorySectors + (2 * WORDS_PER_SECTOR);
+    internalPrepBuildMBT( pHMBT, totalTracks, reservedTracks, directoryTracks, firstDirectoryTrackAddr, mbtLength );
+
+    //  Fill-in SMBT (just copy from HMBT)
+    Word36* pSMBT = pDirectorySectors + (hmbtSectors * WORDS_PER_SECTOR);
+    for ( INDEX wx = 0; wx < (smbtSectors * WORDS_PER_SECTOR); ++wx )
+        pSMBT[wx] = pHMBT[wx];
+
+    //  Write initial directory tracks
+    BLOCK_ID directoryBlockId = firstDirectoryTrackAddr / sectorsPerBlock;
+    BLOCK_COUNT blocksPerTrack = BLOCKS_PER_TRACK(prepFactor);
+    BLOCK_COUNT directoryBlocks = directoryTracks * blocksPerTrack;
+
+    Word36* pWriteBlock = pDirectorySectors;
+    BLOCK_ID writeBlockId = directoryBlockId;
+    for ( COUNT blockCount = 0; blockCount < directoryBlocks; ++blockCount )
+    {
+        result = directDiskIo( pActivity, deviceId, ChannelModule::Command::WRITE, writeBlockId, prepFactor, pWriteBlock );
+        if ( result.m_Status != MFDST_SUCCESSFUL )
             return result;
-        for ( INDEX wx = 0; wx < 28; ++wx )
-            pSMBTSector[wx] = pHMBTSector[wx];
-        ++smbtAddr;
-        ++hmbtAddr;
+
+        pWriteBlock += prepFactor;
+        ++writeBlockId;
     }
 
+    delete[] pDirectorySectors;
+    pDirectorySectors = 0;
+    pWriteBlock = 0;
+
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+        return result;
+
+    //  Create VOL1 label
+    Word36* pLabel = new Word36[prepFactor];
+    miscStringToWord36Ascii( "VOL1", &pLabel[0] );
+    miscStringToWord36Ascii( adjustedPackLabel, &pLabel[1] );
+    pLabel[3].setW( firstDirectoryTrackAddr );
+    pLabel[4].setH1( recordsPerTrack );
+    pLabel[4].setH2( prepFactor );
+    pLabel[011].setH1( static_cast<COUNT>(hmbtLength) );
+    pLabel[011].setH2( static_cast<COUNT>(mbtLength) );
+    pLabel[016].setW( totalTracks );
+
+    //  Write VOL1 label
+    result = directDiskIo( pActivity, deviceId, ChannelModule::Command::WRITE, 2, prepFactor, pLabel );
+
+    delete[] pLabel;
     return result;
 }
 
 
-//  initializeFixedPacks()
+//  internalPrepCreateDASSector()
 //
-//  Called early in jk13 boot - after pack labels are read, LDATs are assigned,
-//  m_PackInfo is populated, and initial directory sectors are loaded.
-//  We cannot commit the consequent MFD updates yet, since the FAT isn't loaded for the MFD.
-//  This means the caller must do this commit as soon as it is practical.
+//  For internal prep of large disk drives (which require 9 or more initial directory tracks)
+//  we go ahead and create an empty DAS directory track following the initial directory tracks.
 MFDManager::Result
-MFDManager::initializeFixedPacks
+MFDManager::internalPrepCreateDASSector
 (
-    Activity* const         pActivity
-)
+    Activity* const                 pActivity,
+    const DeviceManager::DEVICE_ID  deviceId,
+    const PREP_FACTOR               prepFactor,
+    const DRWA                      dasTrackWordAddress
+) const
 {
-    //  No lock required - this occurs early in boot
     Result result;
-    for ( ITPACKINFOMAP itpi = m_PackInfo.begin(); itpi != m_PackInfo.end(); ++itpi )
-    {
-        if ( itpi->second->m_IsFixed )
-        {
-            result = initializeFixedPack( pActivity, itpi );
-            if ( result.m_Status != MFDST_SUCCESSFUL )
-                break;
-        }
-    }
-
-    return result;
-}
+    Word36* pBuffer = new Word36[prepFactor];
+    Word36* pDAS = pBuffer;
 
+    //  Word 0 S1 is 02 for removable, 03 for fixed (we're doing fixed)
+    //  The remainder of the word is the sector address of the DAS
+    pDAS[0].setW( dasTrackWordAddress / 28 );
+    pDAS[0].setS1( 03 );
 
-//  initializeLoadPackInfo()
-//
-//  Iterates over the given list of PackInfo objects (which do not yet have LDAT's, so are not in m_PackInfo)
-//  assigning LDATs to all the packs and building up m_PackInfo.
-void
-MFDManager::initializeLoadPackInfo
-(
-    Activity* const         pActivity,
-    const PACKINFOLIST&     packInfoList
-)
-{
-//????    DeviceManager* pdevmgr = dynamic_cast<DeviceManager*>( m_pExec->getManager( Exec::MID_DEVICE_MANAGER ) );
-    LDATINDEX nextLDAT = 1;
-    for ( CITPACKINFOLIST itpi = packInfoList.begin(); itpi != packInfoList.end(); ++itpi )
+    //  Only the first sector (the DAS sector) is used - set the flag for it.
+    pDAS[1].setW( 0400000000000 );
+    for ( INDEX ex = 1; ex < 9; ++ex )
     {
-        PackInfo* pPackInfo = *itpi;
-        if ( pPackInfo->m_IsFixed )
-        {
-            //  This pack is fixed - is it in conflict with any other already-'registered' fixed pack?
-            //  If so, mark it DN.
-            bool conflict = false;
-            for ( CITPACKINFOMAP itpiRegistered = m_PackInfo.begin(); itpiRegistered != m_PackInfo.end(); ++itpiRegistered )
-            {
-                PackInfo* pRegisteredPackInfo = itpiRegistered->second;
-                if ( pPackInfo->m_PackName.compareNoCase( pRegisteredPackInfo->m_PackName ) == 0 )
-                {
-                    std::string consMsg = "DEVICE ";
-                    consMsg += m_pDeviceManager->getNodeName( pPackInfo->m_DeviceId ) + " PACK-ID CONFLICT";
-                    m_pConsoleManager->postReadOnlyMessage( consMsg, 0 );
-                    m_pDeviceManager->setNodeDownInternally( pActivity, pPackInfo->m_DeviceId );
-                    conflict = true;
-                    break;
-                }
-            }
+        Word36* pEntry = &pDAS[3 * ex];
+        pEntry[0].setW( 0400000000000 );
+    }
+    pDAS[033].setW( 0400000000000 );
 
-            if ( !conflict )
-            {
-                //  No conflict - assign an LDAT and integrate the pack into the fixed pool
-                pPackInfo->m_LDATIndex = nextLDAT++;
-                m_PackInfo[pPackInfo->m_LDATIndex] = pPackInfo;
-                pPackInfo->m_InFixedPool = true;
-                pPackInfo->m_AssignCount = 1;
+    BLOCK_ID blockId = dasTrackWordAddress / prepFactor;
 
-                //  Notify listeners
-                /*???? obsolete, but keep it around in case
-                const DeviceManager::NodeEntry* pNodeEntry = pdevmgr->getNodeEntry( pPackInfo->m_DeviceId );
-                m_pExec->postNodeChangeEvent( pNodeEntry->m_pNode );
-                */
-            }
-        }
-    }
+    //  Write the block containing the DAS (don't need to write the rest of the directory track).
+    result = directDiskIo( pActivity, deviceId, ChannelModule::Command::WRITE, blockId, prepFactor, pBuffer );
+    return result;
 }
 
 
-//  insertMainItem()
-//
-//  Inserts a main item link into the appropriate lead item sector,
-//  according to the indicated absolute file cycle.
+//  loadCatalogQueryEntries()
 //
-//  Parameters:
-//      pActivity:          pointer to the controlling Activity
-//      leadItem0Addr:      DSADDR of lead item into which the link is to be inserted
-//      mainItem0Addr:      DSADDR link to main item to be inserted into the lead item
-//      absoluteCycle:      absolute file cycle associated with the relevant main item
-//      guardedFile:        true if main item represents a guarded file cycle (which forces the whole set to be guarded)
+//  Populates the entries of a batch catalog query.
+//  Any entry which does not yet have a lead item address is looked up by qualifier and filename.
+//  Lead items (and then main items, if cycle info is requested) are staged in ascending DSADDR order
+//  across the entire batch, and entries which refer to the same file set share one staging of the lead items.
+//  Entries for uncataloged file sets are marked MFDST_NOT_FOUND; this does not fail the batch.
+//  Call under lock().
 MFDManager::Result
-MFDManager::insertMainItem
+MFDManager::loadCatalogQueryEntries
 (
-    Activity* const         pActivity,
-    const DSADDR            leadItem0Addr,
-    const DSADDR            mainItem0Addr,
-    const UINT16            absoluteCycle,
-    const bool              guardedFile
+    CatalogQueryList* const pList,
+    const bool              includeCycleInfo
 )
 {
     Result result;
 
-    //  Read lead items 0 and optionally 1
-    Word36* pLeadItem0 = 0;
-    Word36* pLeadItem1 = 0;
-    DSADDR leadItem1Addr = 0;
-    if ( !stageLeadItems( leadItem0Addr, true, &leadItem1Addr, &pLeadItem0, &pLeadItem1, &result ) )
-        return result;
-
-    //  Update lead items 0 and possibly 1.  If the fileset is empty, this is pretty simple.
-    COUNT currentCycleRange = pLeadItem0[011].getQ3();
-
-    //  If this cycle is guarded, the whole set becomes guarded.
-    if ( guardedFile )
-        pLeadItem0[012].logicalOr( 0400000000000ll );
-
-    if ( currentCycleRange == 0 )
+    //  Resolve lead item addresses, and order the entries by those addresses
+    CATALOGQUERYMAP leadItemMap;
+    for ( CatalogQueryList::iterator itq = pList->begin(); itq != pList->end(); ++itq )
     {
-        //  Empty file set - this is the only cycle that will exist in the file set.
-        pLeadItem0[011].setS2( 1 );
-        pLeadItem0[011].setQ3( 1 );
-        pLeadItem0[011].setQ4( absoluteCycle );
-        pLeadItem0[013].setW( mainItem0Addr );
+        CatalogQueryEntry* pEntry = *itq;
+        if ( pEntry->m_LeadItem0Addr == 0 )
+        {
+            Word36 qualifier36[2];
+            Word36 filename36[2];
+            miscStringToWord36Fieldata( pEntry->m_Qualifier, &qualifier36[0], 2 );
+            miscStringToWord36Fieldata( pEntry->m_Filename, &filename36[0], 2 );
+            pEntry->m_LeadItem0Addr = getLeadItemAddress( &qualifier36[0], &filename36[0] );
+        }
+
+        if ( pEntry->m_LeadItem0Addr == 0 )
+            pEntry->m_Result.m_Status = MFDST_NOT_FOUND;
+        else
+            leadItemMap.insert( std::make_pair( pEntry->m_LeadItem0Addr, pEntry ) );
     }
-    else
+
+    //  Load file set info in lead item order, noting main items of interest as we go
+    CATALOGCYCLEMAP mainItemMap;
+    const CatalogQueryEntry* pPrevious = 0;
+    for ( CITCATALOGQUERYMAP itlm = leadItemMap.begin(); itlm != leadItemMap.end(); ++itlm )
     {
-        //  Non-empty file set - we have to maneuver around other existing file cycles.
-        //  Calculate the new cycle range - it might be different from the current, and the exact calculation
-        //  depends on whether the new cycle is higher or lower than the current absolute max cycle.
-        UINT16 currentHighestAbsoluteCycle = pLeadItem0[011].getQ4();
-        COUNT newCycleRange = 0;
-        UINT16 compRange = execGetAbsoluteCycleRange( absoluteCycle, currentHighestAbsoluteCycle );   //  range from current highest to new abs cycle
-        int comparison = execCompareAbsoluteCycles( absoluteCycle, currentHighestAbsoluteCycle );   //  comparison from new cycle to current highest
-        if ( comparison > 0 )
+        CatalogQueryEntry* pEntry = itlm->second;
+        if ( pPrevious && (pPrevious->m_LeadItem0Addr == itlm->first) )
         {
-            //  new cycle sorts higher than any existing cycles, so the range *will* be extended.
-            newCycleRange = currentCycleRange + compRange - 1;
+            pEntry->m_Result = pPrevious->m_Result;
+            pEntry->m_FileSetInfo = pPrevious->m_FileSetInfo;
         }
         else
+            pEntry->m_Result = getFileSetInfo( itlm->first, &pEntry->m_FileSetInfo );
+        pPrevious = pEntry;
+
+        if ( pEntry->m_Result.m_Status != MFDST_SUCCESSFUL )
         {
-            //  new cycle sorts lower than the highest existing cycle, so the range *might* be extended.
-            newCycleRange = compRange > currentCycleRange ? compRange : currentCycleRange;
+            if ( result.m_Status == MFDST_SUCCESSFUL )
+                result = pEntry->m_Result;
+            continue;
         }
 
-        //  If the new cycle range is different than the existing cycle range, update lead item 0.
-        //  Then, if the original range didn't require a sector 1, and the new one does,
-        //  create and link in a new lead item sector 1.
-        if ( newCycleRange != currentCycleRange )
+        if ( includeCycleInfo )
         {
-            pLeadItem0[011].setQ3( newCycleRange );
-
-            if ( (newCycleRange > 17) && (leadItem1Addr == 0) )
+            const std::vector<FileSetInfo::CycleEntry>& cycleEntries = pEntry->m_FileSetInfo.m_CycleEntries;
+            pEntry->m_CycleInfos.resize( cycleEntries.size(), 0 );
+            for ( INDEX cx = 0; cx < cycleEntries.size(); ++cx )
             {
-                LDATINDEX preferredLDATIndex = leadItem0Addr >> 18;
-                result = allocateDirectorySector( pActivity, preferredLDATIndex, &leadItem1Addr );
-                if ( result.m_Status != MFDST_SUCCESSFUL )
-                    return result;
-
-                pLeadItem1 = 0;
-                if ( !stageDirectorySector( leadItem1Addr, false, &pLeadItem1, &result ) )
-                    return result;
-
-                //  Link item 1 to item 0 and clear item 1's forward link
-                pLeadItem0[0].setW( leadItem1Addr );
-                pLeadItem1[0].setW( 0400000000000 );
+                if ( cycleEntries[cx].m_Exists )
+                    mainItemMap.insert( std::make_pair( cycleEntries[cx].m_MainItem0Addr, std::make_pair( pEntry, cx ) ) );
             }
         }
+    }
 
-        if ( comparison > 0 )
-        {
-            //  The requested new cycle is higher than the current highest cycle.
-            //  All the existing links will need to be moved downward in the lead items.
-            //  We TRUST that calling code has already dropped cycles needing to be dropped,
-            //  and that this procedure will not produce results inconsistent with max range.
-            INDEX sx = currentCycleRange;
-            INDEX dx = sx + compRange - 1;
-            while ( sx > 0 )
-            {
-                --sx;
-                --dx;
-                {//TODO:DEBUG
-                    std::cout << "Moving " << sx << " to " << dx << std::endl;
-                }
-                Word36* pSource = getMainItemLinkPointer( sx, pLeadItem0, pLeadItem1 );
-                Word36* pDest = getMainItemLinkPointer( dx, pLeadItem0, pLeadItem1 );
-                *pDest = *pSource;
-                pSource->clear();
-            }
+    //  Load file cycle info in main item order
+    for ( CITCATALOGCYCLEMAP itmm = mainItemMap.begin(); itmm != mainItemMap.end(); ++itmm )
+    {
+        CatalogQueryEntry* pEntry = itmm->second.first;
+        INDEX cx = itmm->second.second;
 
-            //  Now create the new link and update the highest absolute cycle
-            pLeadItem0[013].setW( mainItem0Addr );
-            pLeadItem0[011].setQ4( absoluteCycle );
+        Result cycleResult;
+        if ( pEntry->m_FileSetInfo.m_FileType == FILETYPE_TAPE )
+        {
+            TapeFileCycleInfo* pInfo = new TapeFileCycleInfo();
+            pEntry->m_CycleInfos[cx] = pInfo;
+            cycleResult = loadTapeFileCycleInfo( itmm->first, pInfo );
         }
         else
         {
-            //  The requested new cycle sorts lower than the current highest cycle.
-            //  Find the exact location for the main item link.
-            Word36* pEntry = getMainItemLinkPointer( compRange - 1, pLeadItem0, pLeadItem1 );
-            pEntry->setW( mainItem0Addr );
+            MassStorageFileCycleInfo* pInfo = new MassStorageFileCycleInfo();
+            pEntry->m_CycleInfos[cx] = pInfo;
+            cycleResult = loadMassStorageFileCycleInfo( itmm->first, pInfo );
         }
 
-        //  Update number of actual files - we don't have to worry about the actual number,
-        //  we just know we're increasing it by 1.
-        pLeadItem0[011].setS2( pLeadItem0[011].getS2() + 1 );
+        if ( cycleResult.m_Status != MFDST_SUCCESSFUL )
+        {
+            pEntry->m_Result = cycleResult;
+            if ( result.m_Status == MFDST_SUCCESSFUL )
+                result = cycleResult;
+        }
     }
 
     return result;
 }
 
 
-//  internalPrep()
+//  loadDirectoryTrackInfoCache()
 //
-//  Preps a pack as fixed or removable.
-//  Use device's blocksize to determine prepfactor, and blockcount to determine tracks.
-//  Put first directory track about 1/3 of the way through the pack (by convention).
+//  Loads one track of the pack's MFD into cache.
+//  Part of integrating a fixed pack into the fixed pool.
+//  Does not stop the exec on IO error - there are cases where this is not appropriate.
 MFDManager::Result
-MFDManager::internalPrep
+MFDManager::loadDirectoryTrackIntoCache
 (
-    Activity* const                 pActivity,
-    const DeviceManager::DEVICE_ID  deviceId,
-    const bool                      fixedFlag,
-    const std::string&              packLabel
+    Activity* const     pActivity,
+    PackInfo* const     pPackInfo,
+    const DSADDR        firstDSAddr,
+    const BLOCK_ID      firstBlockId
 )
 {
     Result result;
 
-    //  Obtain device info - if we can't get it, we cannot prep the thing.
-    BLOCK_COUNT packBlockCount;
-    BLOCK_SIZE packBlockSize;
-    result = getDiskDeviceValues( pActivity, deviceId, &packBlockCount, &packBlockSize );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
-        return result;
-
-    PREP_FACTOR prepFactor = miscGetPrepFactorFromBlockSize( packBlockSize );
-    if ( (prepFactor == 0) || (packBlockCount == 0) )
+    //  This is called for every directory track, at boot and later - only bother with a name if it will be used
+    BootProfile* pProfile = m_pExec->getBootProfile();
+    std::string spanName;
+    if ( pProfile->isProfiling() )
     {
-        result.m_Status = MFDST_PACK_NOT_FORMATTED;
-        return result;
+        std::stringstream strm;
+        strm << "DIRECTORY TRACK " << pPackInfo->m_PackName << " BLOCK " << firstBlockId;
+        spanName = strm.str();
     }
+    BootProfile::Span span( pProfile, spanName );
 
-    const DeviceManager::DeviceEntry* pDevEntry = m_pDeviceManager->getDeviceEntry( deviceId );
-    if ( pDevEntry == 0 )
+    Word36* pBuffer = new Word36[pPackInfo->m_PrepFactor];
+    BLOCK_ID blockIdLimit = firstBlockId + BLOCKS_PER_TRACK( pPackInfo->m_PrepFactor );
+    DSADDR dsAddr = firstDSAddr;
+
+    for ( BLOCK_ID ioBlockId = firstBlockId; ioBlockId != blockIdLimit; ++ioBlockId )
     {
-        std::stringstream strm;
-        strm << "MFDManager::internalPrep() Cannot get device entry for device ID " << deviceId;
-        SystemLog::write( strm.str() );
-        result.m_Status = MFDST_INTERNAL_ERROR;
-        return result;
+        //  Read a block of directory sectors
+        result = directDiskIo( pActivity,
+                               pPackInfo->m_DeviceId,
+                               ChannelModule::Command::READ,
+                               ioBlockId,
+                               pPackInfo->m_PrepFactor, pBuffer );
+        if ( result.m_Status != MFDST_SUCCESSFUL )
+        {
+            delete[] pBuffer;
+            return result;
+        }
+
+        //  Stage the sectors into cache, reusing any cache sector which is already there
+        Word36* pSector = pBuffer;
+        for ( INDEX sx = 0; sx < SECTORS_PER_BLOCK( pPackInfo->m_PrepFactor ); ++sx )
+        {
+            Word36*& pDest = m_DirectoryCache[dsAddr];
+            if ( pDest == 0 )
+                pDest = allocateCacheSector();
+            for ( INDEX wx = 0; wx < WORDS_PER_SECTOR; ++wx )
+                pDest[wx] = pSector[wx];
+            pSector += WORDS_PER_SECTOR;
+            ++dsAddr;
+        }
     }
 
-    SuperString adjustedPackLabel = packLabel;
-    adjustedPackLabel.resize( 6, ' ' );
-    adjustedPackLabel.foldToUpperCase();
+    delete[] pBuffer;
 
-    std::stringstream consStrm;
-    consStrm << "PREP " << pDevEntry->m_pNode->getName()
-        << (fixedFlag ? " FIX" : " REM")
-        << " BSZ=" << packBlockSize
-        << " BLKS=" << packBlockCount
-        << " PREP=" << prepFactor
-        << " LBL=" << packLabel;
-    m_pConsoleManager->postReadOnlyMessage( consStrm.str(), 0 );
-
-    //  Traditionally, we have used the first 2 physical blocks for booting and such,
-    //  with the third reserved for the pack label.  This does not vary based on the prepfactor.
-    //  (In fact, it is said that the first two physical blocks /can/ vary in size).
-    //  To observe tradition, we'll make sure to reserve at least those 3 physical blocks
-    //  in the hardware master bit table... but we need to know how many tracks we're talking about.
-    TRACK_COUNT reservedTracks = (prepFactor == 1792) ? 3 : (prepFactor == 896) ? 2 : 1;
-    COUNT recordsPerTrack = BLOCKS_PER_TRACK(prepFactor);
-    COUNT sectorsPerBlock = SECTORS_PER_BLOCK(prepFactor);
-    TRACK_COUNT totalTracks = ( packBlockCount * prepFactor ) / 1792;
-    SECTOR_ID firstDirectoryTrackAddr = ( totalTracks / 3 ) * SECTORS_PER_TRACK;
-
-    //  Calculate mbtLength - this is the length of an MBT, including the 2 delimiting words.
-    WORD_COUNT mbtLength = totalTracks / 32;
-    if ( totalTracks % 32 )
-        ++mbtLength;
-    mbtLength += 2;
-    SECTOR_COUNT smbtSectors = mbtLength / WORDS_PER_SECTOR;
-    if ( mbtLength % WORDS_PER_SECTOR )
-        ++mbtLength;
-
-    //  Calculate hbmtLength - this is the length of S0+S1+HMBT+Padding_to_block_boundary in words.
-    WORD_COUNT hmbtLength = (2 * WORDS_PER_SECTOR) + mbtLength;
-    if ( hmbtLength % prepFactor )
-        hmbtLength = ( ( hmbtLength / prepFactor ) + 1 ) * prepFactor;
-    SECTOR_COUNT hmbtSectors = hmbtLength / WORDS_PER_SECTOR;
-    if ( hmbtLength % WORDS_PER_SECTOR )
-        ++hmbtSectors;
-
-    //  Calculate initial track allocation.
-    //  First, determine number of directory tracks.  If >= 9, then it must be a multiple of 9.
-    //  Then determine the number of initial tracks (directory tracks + track containing VOL1).
-    //  Finally, the number of tracks remaining after initial allocation.
-    TRACK_COUNT directoryTracks = (hmbtLength + mbtLength) / WORDS_PER_TRACK;
-    if ( (hmbtLength + mbtLength) % WORDS_PER_TRACK )
-        ++directoryTracks;
-    //TODO:DEBUG BELOW IS A BUG - LEAVE FOR NOW, TO TEST LARGE DISK ALGORITHMS
-    if ( directoryTracks % 9 )
-        directoryTracks = ( ( directoryTracks / 9 ) + 1 ) * 9;
-
-    TRACK_COUNT initialTracks = directoryTracks + reservedTracks + (directoryTracks >= 9) ? 1 : 0;
-    TRACK_COUNT remainingTracks = totalTracks - initialTracks;
-
-    //  If this is a large disk (i.e., 9 or more directory tracks) create a DAS track
-    //  beyond what will become the initial directory tracks.
-    if ( directoryTracks >= 9 )
-    {
-        DRWA dasTrackWordAddress = (firstDirectoryTrackAddr * 28) + (directoryTracks * 1792);
-        result = internalPrepCreateDASSector( pActivity, deviceId, prepFactor, dasTrackWordAddress );
-        if ( result.m_Status != MFDST_SUCCESSFUL )
-            return result;
-    }
-
-    //  Build initial directory tracks in-memory.  This takes a nice chunk of memory.
-    //  Note that the initial directory tracks (and the first DAS track for large disks)
-    //  are placed in consecutive physical blocks.
-    Word36* pDirectorySectors = new Word36[WORDS_PER_TRACK * static_cast<COUNT>(directoryTracks)];
-
-    //  Build Sector 0
-    Word36* pSector0 = pDirectorySectors;
-    internalPrepBuildSector0( pSector0, firstDirectoryTrackAddr, directoryTracks, hmbtLength, mbtLength );
-
-    //  Build Sector 1 (always version 1)
-    COUNT dasOffset = pSector0[0].getS1() * SECTORS_PER_TRACK;
-    Word36* pSector1 = pDirectorySectors + WORDS_PER_SECTOR;
-    internalPrepBuildSector1( pSector1, hmbtSectors, smbtSectors, remainingTracks, adjustedPackLabel, mbtLength, dasOffset );
-
-    //  Fill-in HMBT
-    Word36* pHMBT = pDirectorySectors + (2 * WORDS_PER_SECTOR);
-    internalPrepBuildMBT( pHMBT, totalTracks, reservedTracks, directoryTracks, firstDirectoryTrackAddr, mbtLength );
-
-    //  Fill-in SMBT (just copy from HMBT)
-    Word36* pSMBT = pDirectorySectors + (hmbtSectors * WORDS_PER_SECTOR);
-    for ( INDEX wx = 0; wx < (smbtSectors * WORDS_PER_SECTOR); ++wx )
-        pSMBT[wx] = pHMBT[wx];
-
-    //  Write initial directory tracks
-    BLOCK_ID directoryBlockId = firstDirectoryTrackAddr / sectorsPerBlock;
-    BLOCK_COUNT blocksPerTrack = BLOCKS_PER_TRACK(prepFactor);
-    BLOCK_COUNT directoryBlocks = directoryTracks * blocksPerTrack;
-
-    Word36* pWriteBlock = pDirectorySectors;
-    BLOCK_ID writeBlockId = directoryBlockId;
-    for ( COUNT blockCount = 0; blockCount < directoryBlocks; ++blockCount )
-    {
-        result = directDiskIo( pActivity, deviceId, ChannelModule::Command::WRITE, writeBlockId, prepFactor, pWriteBlock );
-        if ( result.m_Status != MFDST_SUCCESSFUL )
-            return result;
-
-        pWriteBlock += prepFactor;
-        ++writeBlockId;
-    }
-
-    delete[] pDirectorySectors;
-    pDirectorySectors = 0;
-    pWriteBlock = 0;
-
-    if ( result.m_Status != MFDST_SUCCESSFUL )
-        return result;
-
-    //  Create VOL1 label
-    Word36* pLabel = new Word36[prepFactor];
-    miscStringToWord36Ascii( "VOL1", &pLabel[0] );
-    miscStringToWord36Ascii( adjustedPackLabel, &pLabel[1] );
-    pLabel[3].setW( firstDirectoryTrackAddr );
-    pLabel[4].setH1( recordsPerTrack );
-    pLabel[4].setH2( prepFactor );
-    pLabel[011].setH1( static_cast<COUNT>(hmbtLength) );
-    pLabel[011].setH2( static_cast<COUNT>(mbtLength) );
-    pLabel[016].setW( totalTracks );
-
-    //  Write VOL1 label
-    result = directDiskIo( pActivity, deviceId, ChannelModule::Command::WRITE, 2, prepFactor, pLabel );
-
-    delete[] pLabel;
-    return result;
-}
-
-
-//  internalPrepCreateDASSector()
-//
-//  For internal prep of large disk drives (which require 9 or more initial directory tracks)
-//  we go ahead and create an empty DAS directory track following the initial directory tracks.
-MFDManager::Result
-MFDManager::internalPrepCreateDASSector
-(
-    Activity* const                 pActivity,
-    const DeviceManager::DEVICE_ID  deviceId,
-    const PREP_FACTOR               prepFactor,
-    const DRWA                      dasTrackWordAddress
-) const
-{
-    Result result;
-    Word36* pBuffer = new Word36[prepFactor];
-    Word36* pDAS = pBuffer;
-
-    //  Word 0 S1 is 02 for removable, 03 for fixed (we're doing fixed)
-    //  The remainder of the word is the sector address of the DAS
-    pDAS[0].setW( dasTrackWordAddress / 28 );
-    pDAS[0].setS1( 03 );
-
-    //  Only the first sector (the DAS sector) is used - set the flag for it.
-    pDAS[1].setW( 0400000000000 );
-    for ( INDEX ex = 1; ex < 9; ++ex )
-    {
-        Word36* pEntry = &pDAS[3 * ex];
-        pEntry[0].setW( 0400000000000 );
-    }
-    pDAS[033].setW( 0400000000000 );
-
-    BLOCK_ID blockId = dasTrackWordAddress / prepFactor;
-
-    //  Write the block containing the DAS (don't need to write the rest of the directory track).
-    result = directDiskIo( pActivity, deviceId, ChannelModule::Command::WRITE, blockId, prepFactor, pBuffer );
-    return result;
-}
-
-
-//  loadDirectoryTrackInfoCache()
-//
-//  Loads one track of the pack's MFD into cache.
-//  Part of integrating a fixed pack into the fixed pool.
-//  Does not stop the exec on IO error - there are cases where this is not appropriate.
-MFDManager::Result
-MFDManager::loadDirectoryTrackIntoCache
-(
-    Activity* const     pActivity,
-    PackInfo* const     pPackInfo,
-    const DSADDR        firstDSAddr,
-    const BLOCK_ID      firstBlockId
-)
-{
-    Result result;
-
-    Word36* pBuffer = new Word36[pPackInfo->m_PrepFactor];
-    BLOCK_ID blockIdLimit = firstBlockId + BLOCKS_PER_TRACK( pPackInfo->m_PrepFactor );
-    DSADDR dsAddr = firstDSAddr;
-
-    for ( BLOCK_ID ioBlockId = firstBlockId; ioBlockId != blockIdLimit; ++ioBlockId )
-    {
-        //  Read a block of directory sectors
-        result = directDiskIo( pActivity,
-                               pPackInfo->m_DeviceId,
-                               ChannelModule::Command::READ,
-                               ioBlockId,
-                               pPackInfo->m_PrepFactor, pBuffer );
-        if ( result.m_Status != MFDST_SUCCESSFUL )
-            return result;
-
-        //  Stage the sectors into cache
-        Word36* pSector = pBuffer;
-        for ( INDEX sx = 0; sx < SECTORS_PER_BLOCK( pPackInfo->m_PrepFactor ); ++sx )
-        {
-            m_DirectoryCache.insert( std::make_pair( dsAddr, new Word36[WORDS_PER_SECTOR] ) );
-            Word36* pDest = m_DirectoryCache[dsAddr];
-            for ( INDEX wx = 0; wx < WORDS_PER_SECTOR; ++wx )
-                pDest[wx] = pSector[wx];
-            pSector += WORDS_PER_SECTOR;
-            ++dsAddr;
-        }
-    }
-
-    //  Add an entry to the track map (prepend LDAT)
-    TRACK_ID trackId = (firstDSAddr >> 6) & 077777777;
-    m_DirectoryTrackIdMap[trackId] = firstBlockId;
+    //  Add an entry to the track map (prepend LDAT)
+    TRACK_ID trackId = (firstDSAddr >> 6) & 077777777;
+    m_DirectoryTrackIdMap[trackId] = firstBlockId;
 
     return result;
 }
@@ -3853,6 +3536,7 @@ MFDManager::loadFixedPackAllocationTables
     {
         if ( itpi->second->m_InFixedPool )
         {
+            BootProfile::Span span( m_pExec->getBootProfile(), "ALLOCATION TABLE " + itpi->second->m_PackName );
             result = loadFixedPackAllocationTable( pActivity, itpi );
             if ( result.m_Status != MFDST_SUCCESSFUL )
                 break;
@@ -3863,55 +3547,236 @@ MFDManager::loadFixedPackAllocationTables
 }
 
 
-//  readDiskLabel()
-//
-//  Reads the disk label AND sector 1 for the indicated device, populating a newly-acquired PackInfo object.
-//  Called when a pack goes online, and during boot.
-//  Any IO error in reading VOL1 or Sector1 causes the device to go DN.
+//  loadMassStorageFileCycleInfo()
 //
-//  Upon success, returns a pointer to a newly-allocated PackInfo object to ppPackInfo.
+//  Populates a MassStorageFileCycleInfo object for the indicated main item address,
+//  which is expected to reflect a cataloged mass storage file.
+//  Call under lock().
 MFDManager::Result
-MFDManager::readDiskLabel
+MFDManager::loadMassStorageFileCycleInfo
 (
-    Activity* const                 pActivity,
-    const DeviceManager::DEVICE_ID  deviceId,
-    PackInfo** const                ppPackInfo
+    const DSADDR                    mainItem0Addr,
+    MassStorageFileCycleInfo* const pInfo
 )
 {
     Result result;
-    *ppPackInfo = 0;
 
-    //  Get disk geometry.  This tells us how large a buffer we need for reading the label,
-    //  and it avoids an issue on first boot where the unit is in UNIT_ATTENTION state.
-    BLOCK_COUNT blockCount;
-    BLOCK_SIZE blockSize;
-    bool isMounted;
-    bool isReady;
-    bool isWriteProtected;
-    result = getDiskDeviceValues( pActivity, deviceId, &blockCount, &blockSize, &isMounted, &isReady, &isWriteProtected );
-    if ( result.m_Status != MFDST_SUCCESSFUL )
+    Word36* pMainItem0 = 0;
+    Word36* pMainItem1 = 0;
+    DSADDR mainItem1Addr;
+    if ( stageMainItems( mainItem0Addr, false, &mainItem1Addr, &pMainItem0, &pMainItem1, &result ) )
     {
-        if ( !pActivity->isTerminating() )
-            m_pDeviceManager->setNodeDownInternally( pActivity, deviceId );
-        return result;
-    }
+        FileCycleInfo* pCommonInfo = dynamic_cast<FileCycleInfo*>( pInfo );
+        getCommonFileCycleInfo( pCommonInfo, mainItem0Addr, pMainItem0, mainItem1Addr, pMainItem1 );
 
-    if ( blockSize == 0 )
-    {
-        std::string consMsg = "DEVICE " + m_pDeviceManager->getNodeName( deviceId ) + " VOL1 Label Missing";
-        m_pConsoleManager->postReadOnlyMessage(consMsg, 0);
-        m_pDeviceManager->setNodeDownInternally( pActivity, deviceId  );
-        result.m_Status = MFDST_PACK_NOT_FORMATTED;
-        return result;
-    }
+        //  Mass-storage-specific
+        UINT16 descriptors = pMainItem0[014].getT1();
+        UINT8 inhibits = pMainItem0[021].getS2();
+        UINT8 fileFlags = pMainItem0[014].getS3();
+        UINT8 pchar = pMainItem0[015].getS1();
 
-    //  Allocate a buffer large enough for the largest possible prep factor and a PackInfo object.
-    //  For unprepped packs, block size will be zero; we allow for that, in order to get a non-prepped
-    //  result instead of a block size error result.
-    PREP_FACTOR prepFactor = miscGetPrepFactorFromBlockSize( blockSize );
-    Word36* pBuffer = new Word36[prepFactor];
-    PackInfo* pPackInfo = new PackInfo();
-    pPackInfo->m_IsMounted = true;
+        pInfo->m_TDateFirstWriteAfterBackup = pMainItem0[012];
+        pInfo->m_Unloaded = (descriptors & 04000) ? true : false;
+        pInfo->m_SaveOnCheckpoint = (descriptors & 01000) ? true : false;
+        pInfo->m_LargeFile = (fileFlags & 040) ? true : false;
+        pInfo->m_WrittenTo = (fileFlags & 002) ? true : false;
+        pInfo->m_StoreThrough = (fileFlags & 001) ? true : false;
+        pInfo->m_PositionGranularity = (pchar & 040) ? true : false;
+        pInfo->m_WordAddressable = (pchar & 010) ? true : false;
+        pInfo->m_AssignedToCommonNameSection = (pchar & 004) ? true : false;
+        pInfo->m_UnloadInhibited = (inhibits & 020) ? true : false;
+        pInfo->m_InitialReserve = pMainItem0[024].getH1();
+        pInfo->m_MaxGranules = pMainItem0[025].getH1();
+        pInfo->m_HighestGranuleAssigned = pMainItem0[026].getH1();
+        pInfo->m_HighestTrackWritten = pMainItem0[027].getH1();
+    }
+
+    return result;
+}
+
+
+//  loadTapeFileCycleInfo()
+//
+//  Populates a TapeFileCycleInfo object for the indicated main item address,
+//  which is expected to reflect a cataloged tape file.
+//  Call under lock().
+MFDManager::Result
+MFDManager::loadTapeFileCycleInfo
+(
+    const DSADDR                mainItem0Addr,
+    TapeFileCycleInfo* const    pInfo
+)
+{
+    Result result;
+
+    Word36* pMainItem0 = 0;
+    Word36* pMainItem1 = 0;
+    DSADDR mainItem1Addr;
+    if ( stageMainItems( mainItem0Addr, false, &mainItem1Addr, &pMainItem0, &pMainItem1, &result ) )
+    {
+        FileCycleInfo* pCommonInfo = dynamic_cast<FileCycleInfo*>( pInfo );
+        getCommonFileCycleInfo( pCommonInfo, mainItem0Addr, pMainItem0, mainItem1Addr, pMainItem1 );
+
+        //  Tape-specific
+        UINT8 density = pMainItem0[024].getS1();
+        UINT8 format = pMainItem0[024].getS2();
+        UINT8 features = pMainItem0[024].getS3();
+        UINT8 mtapop = pMainItem0[025].getS3();
+
+        if ( features & 040 )
+            pInfo->m_BlockNumbering = TBN_ON;
+        else if ( features & 010 )
+            pInfo->m_BlockNumbering = TBN_OPTIONAL;
+        else
+            pInfo->m_BlockNumbering = TBN_OFF;
+
+        if ( features & 004 )
+            pInfo->m_DataCompression = TDC_ON;
+        else if ( features & 001 )
+            pInfo->m_DataCompression = TDC_OPTIONAL;
+        else
+            pInfo->m_DataCompression = TDC_OFF;
+
+        switch ( density )
+        {
+        case 001:
+            if ( mtapop & 010 ) // HIC
+                pInfo->m_Density = TDENS_38000;
+            else
+                pInfo->m_Density = TDENS_800;
+            break;
+        case 002:
+            pInfo->m_Density = TDENS_1600;
+            break;
+        case 003:
+            pInfo->m_Density = TDENS_6250;
+            break;
+        case 004:
+            pInfo->m_Density = TDENS_5090;
+            break;
+        case 005:
+            pInfo->m_Density = TDENS_38000;
+            break;
+        case 006:
+            pInfo->m_Density = TDENS_76000;
+            break;
+        case 007:
+            pInfo->m_Density = TDENS_85937;
+            break;
+        }
+
+        if ( format & 002 )
+            pInfo->m_Format = TFMT_QUARTER_WORD;
+        else if ( format & 004 )
+            pInfo->m_Format = TFMT_SIX_BIT_PACKED;
+        else
+            pInfo->m_Format = TFMT_EIGHT_BIT_PACKED;
+
+        if ( mtapop & 020 )
+            pInfo->m_Type = TTYPE_QIC;
+        else if ( mtapop & 010 )
+            pInfo->m_Type = TTYPE_HIC;
+        else if ( mtapop & 002 )
+            pInfo->m_Type = TTYPE_DLT;
+        else if ( mtapop & 001 )
+            pInfo->m_Type = TTYPE_HIS;
+        else
+        {
+            if ( format & 040 )
+                pInfo->m_Type = TTYPE_NINE_TRACK;
+            else
+                pInfo->m_Type = TTYPE_SEVEN_TRACK;
+        }
+
+        if ( (pInfo->m_Type == TTYPE_SEVEN_TRACK) || (pInfo->m_Type == TTYPE_NINE_TRACK) )
+        {
+            if ( format & 020 )
+                pInfo->m_Parity = TPAR_EVEN;
+            else
+                pInfo->m_Parity = TPAR_ODD;
+        }
+        else
+            pInfo->m_Parity = TPAR_NONE;
+
+        pInfo->m_NoiseConstant = pMainItem0[025].getS6();
+        pInfo->m_JOption = ( mtapop & 040 ) ? true : false;
+
+        if ( pMainItem0[032].getW() != 0 )
+            pInfo->m_Reels.push_back( miscWord36FieldataToString( &pMainItem0[032], 1 ));
+        if ( pMainItem0[033].getW() != 0 )
+            pInfo->m_Reels.push_back( miscWord36FieldataToString( &pMainItem0[033], 1 ));
+        DSADDR reelTableAddr = getLinkAddress( pMainItem0[0] );
+        while ( reelTableAddr )
+        {
+            Word36* pReelTable = 0;
+            if ( !stageDirectorySector( reelTableAddr, false, &pReelTable, &result ) )
+                break;
+
+            pInfo->m_DirectorySectorAddresses.push_back( reelTableAddr );
+
+            for ( INDEX wx = 2; wx < 033; ++wx )
+            {
+                if ( pReelTable[wx].getW() != 0 )
+                    pInfo->m_Reels.push_back( miscWord36FieldataToString( &pReelTable[wx], 1 ));
+            }
+
+            reelTableAddr = getLinkAddress( pReelTable[0] );
+        }
+    }
+
+    return result;
+}
+
+
+//  readDiskLabel()
+//
+//  Reads the disk label AND sector 1 for the indicated device, populating a newly-acquired PackInfo object.
+//  Called when a pack goes online, and during boot.
+//  Any IO error in reading VOL1 or Sector1 causes the device to go DN.
+//
+//  Upon success, returns a pointer to a newly-allocated PackInfo object to ppPackInfo.
+MFDManager::Result
+MFDManager::readDiskLabel
+(
+    Activity* const                 pActivity,
+    const DeviceManager::DEVICE_ID  deviceId,
+    PackInfo** const                ppPackInfo
+)
+{
+    Result result;
+    *ppPackInfo = 0;
+
+    //  Get disk geometry.  This tells us how large a buffer we need for reading the label,
+    //  and it avoids an issue on first boot where the unit is in UNIT_ATTENTION state.
+    BLOCK_COUNT blockCount;
+    BLOCK_SIZE blockSize;
+    bool isMounted;
+    bool isReady;
+    bool isWriteProtected;
+    result = getDiskDeviceValues( pActivity, deviceId, &blockCount, &blockSize, &isMounted, &isReady, &isWriteProtected );
+    if ( result.m_Status != MFDST_SUCCESSFUL )
+    {
+        if ( !pActivity->isTerminating() )
+            m_pDeviceManager->setNodeDownInternally( pActivity, deviceId );
+        return result;
+    }
+
+    if ( blockSize == 0 )
+    {
+        std::string consMsg = "DEVICE " + m_pDeviceManager->getNodeName( deviceId ) + " VOL1 Label Missing";
+        m_pConsoleManager->postReadOnlyMessage(consMsg, 0);
+        m_pDeviceManager->setNodeDownInternally( pActivity, deviceId  );
+        result.m_Status = MFDST_PACK_NOT_FORMATTED;
+        return result;
+    }
+
+    //  Allocate a buffer large enough for the largest possible prep factor and a PackInfo object.
+    //  For unprepped packs, block size will be zero; we allow for that, in order to get a non-prepped
+    //  result instead of a block size error result.
+    PREP_FACTOR prepFactor = miscGetPrepFactorFromBlockSize( blockSize );
+    Word36* pBuffer = new Word36[prepFactor];
+    PackInfo* pPackInfo = new PackInfo();
+    pPackInfo->m_IsMounted = true;
     pPackInfo->m_DeviceId = deviceId;
 
     //  Read disk label (always block 2)
@@ -4087,6 +3952,7 @@ MFDManager::readDiskLabels
         const DeviceManager::DeviceEntry* pDevEntry = m_pDeviceManager->getDeviceEntry( nodeIds[nx] );
         if ( (pDevEntry->m_Status == DeviceManager::NDST_SU) || (pDevEntry->m_Status == DeviceManager::NDST_UP) )
         {
+            BootProfile::Span span( m_pExec->getBootProfile(), "LABEL " + m_pDeviceManager->getNodeName( nodeIds[nx] ) );
             PackInfo* pPackInfo = 0;
             MFDManager::Result result = readDiskLabel( pActivity, nodeIds[nx], &pPackInfo );
             if ( result.m_Status == MFDST_TERMINATING )
@@ -4328,6 +4194,7 @@ MFDManager::setSMBTAllocated
 )
 {
     Result result;
+    ++m_UpdateGeneration;
 
     ITPACKINFOMAP itpi = m_PackInfo.find( ldatIndex );
     if ( itpi == m_PackInfo.end() )
@@ -4863,6 +4730,20 @@ MFDManager::writeDADUpdates
 //  ------------------------------------------------------------------------------------------------
 //  ------------------------------------------------------------------------------------------------
 
+//  allocateCacheSector()
+//
+//  Obtains a zeroed directory cache sector from the sector pool.
+//  Cache sectors must be returned via releaseCacheSector(), never via delete.
+Word36*
+MFDManager::allocateCacheSector()
+{
+    Word36* pSector = static_cast<Word36*>( m_DirectorySectorPool.allocate() );
+    for ( INDEX wx = 0; wx < WORDS_PER_SECTOR; ++wx )
+        new( pSector + wx ) Word36();
+    return pSector;
+}
+
+
 //  buildEmptyDASSector()
 //
 //  Builds up an empty DAS sector in the given buffer.
@@ -4957,64 +4838,498 @@ MFDManager::buildSector0ForSmallDisks
             }
         }
     }
-}
+}
+
+
+//  calculateCycleInfo()
+//  Inspects the main item links in lead item 0 and the optional lead item 1, and updates:
+//      current cycle range in lead item 0 (word 011, Q3)
+//      current number of cycles (not counting those in to-be state) (word 011, S2)
+//  Caller must ensure that sector 0 has been staged for update.
+//
+//  Parameters:
+//      pLeadItem0:     pointer to lead item 0
+//      pLeadItem1:     pointer to lead item 1 if it exists, else 0
+void
+MFDManager::calculateCycleInfo
+(
+    Word36* const       pLeadItem0,
+    const Word36* const pLeadItem1
+)
+{
+    //  Find the index of the first (highest) entry.
+    //  Normally (but not necessarily always) this will be entry 0.
+    //  If there are no valid links (which could happen in the middle of some operation),
+    //  we will set the current range and count to zero.
+    INDEX firstEntry = 0;
+    COUNT maxLinks = (pLeadItem1 == 0) ? 17 : 32;
+    while ( firstEntry < maxLinks )
+    {
+        const Word36* const pEntry = getMainItemLinkPointer( firstEntry, pLeadItem0, pLeadItem1 );
+        if ( !pEntry->isZero() )
+            break;
+        ++firstEntry;
+    }
+
+    if ( firstEntry == maxLinks )
+    {
+        pLeadItem0[011].setS2( 0 );
+        pLeadItem0[011].setQ3( 0 );
+        return;
+    }
+
+    //  Keep iterating over the links, to find the last valid one.
+    COUNT cycles = 1;
+    INDEX lastEntry = firstEntry;
+    INDEX thisEntry = firstEntry;
+    while ( thisEntry < maxLinks )
+    {
+        const Word36* const pEntry = getMainItemLinkPointer( firstEntry, pLeadItem0, pLeadItem1 );
+        if ( !pEntry->isZero() )
+        {
+            lastEntry = thisEntry;
+            if ( !pEntry->isNegative() )
+                ++cycles;
+        }
+        ++thisEntry;
+    }
+
+    pLeadItem0[011].setS2( cycles );
+    pLeadItem0[011].setQ3( lastEntry - thisEntry + 1 );
+}
+
+
+//  dumpMFDDirectory()
+//
+//  Dumps the MFD data in a nice directory format, from a snapshot of the directory.
+//  Output is accumulated and written to the stream in chunks.
+//  Presumes that the directory is not corrupted.
+//  For debugging.
+void
+MFDManager::dumpMFDDirectory
+(
+    std::ostream&       stream,
+    const MFDSnapshot&  snapshot
+)
+{
+    std::stringstream chunk;
+    chunk << "  MFD Directory:" << std::endl;
+
+    //  Iterate over the lookup items
+    for ( INDEX lx = 0; lx < snapshot.m_SearchItemLookupTable.size(); ++lx )
+    {
+        DSADDR searchItemAddr = snapshot.m_SearchItemLookupTable[lx];
+        while ( searchItemAddr != 0 )
+        {
+            //  Find the lookup item.
+            const Word36* pSearchItem = snapshot.getSector( searchItemAddr );
+            if ( pSearchItem == 0 )
+            {
+                chunk << "    Error locating search item at DSADDR 0" << std::oct << searchItemAddr << std::endl;
+                break;
+            }
+
+            const Word36* pEntry = &pSearchItem[01];
+            for ( INDEX ex = 0; ex < 5; ++ex )
+            {
+                DSADDR leadItem0Addr = getLinkAddress( pEntry[4] );
+                if ( leadItem0Addr != 0 )
+                {
+                    dumpMFDDirectoryLeadItem( chunk, snapshot, leadItem0Addr );
+                    if ( chunk.tellp() >= DUMP_CHUNK_SIZE )
+                        flushDumpChunk( stream, &chunk );
+                }
+                pEntry += 5;
+            }
+
+            searchItemAddr = getLinkAddress( pSearchItem[0] );
+        }
+    }
+
+    flushDumpChunk( stream, &chunk );
+}
+
+
+//  dumpMFDDirectoryLeadItem()
+//
+//  Handles lead items for dumpMFDDirectory
+void
+MFDManager::dumpMFDDirectoryLeadItem
+(
+    std::ostream&       stream,
+    const MFDSnapshot&  snapshot,
+    const DSADDR        leadItem0Addr
+)
+{
+    //  Find lead item 0 (and 1, if it exists)
+    const Word36* pLeadItem0 = snapshot.getSector( leadItem0Addr );
+    const Word36* pLeadItem1 = 0;
+    DSADDR leadItem1Addr = pLeadItem0 ? getLinkAddress( pLeadItem0[0] ) : 0;
+    if ( leadItem1Addr != 0 )
+        pLeadItem1 = snapshot.getSector( leadItem1Addr );
+    if ( (pLeadItem0 == 0) || ((leadItem1Addr != 0) && (pLeadItem1 == 0)) )
+    {
+        stream << "    Error locating lead item at DSADDR 0" << std::oct << leadItem0Addr << std::endl;
+        return;
+    }
+
+    SuperString qualifier = miscWord36FieldataToString( &pLeadItem0[1], 2 );
+    qualifier.trimTrailingSpaces();
+    SuperString filename = miscWord36FieldataToString( &pLeadItem0[3], 2 );
+    filename.trimTrailingSpaces();
+    SuperString projectId = miscWord36FieldataToString( &pLeadItem0[5], 2 );
+    projectId.trimTrailingSpaces();
+
+    SuperString readKey("<none>");
+    if ( !pLeadItem0[7].isZero() )
+    {
+        readKey = miscWord36FieldataToString( &pLeadItem0[7], 1 );
+        readKey.trimTrailingSpaces();
+    }
+
+    SuperString writeKey("<none>");
+    if ( !pLeadItem0[010].isZero() )
+    {
+        writeKey = miscWord36FieldataToString( &pLeadItem0[010], 1 );
+        writeKey.trimTrailingSpaces();
+    }
+
+    const FileType fileType = ( pLeadItem0[011].getS1() == 0 ) ? FILETYPE_MASS_STORAGE : FILETYPE_TAPE; //TODO:REMO removable issue?
+    const COUNT currentCycles = pLeadItem0[011].getS2();
+    const COUNT maxRange = pLeadItem0[011].getS3();
+    const COUNT currentRange = pLeadItem0[011].getQ3();
+    const UINT16 highestAbsolute = pLeadItem0[011].getQ4();
+
+    UINT32 statusBits = pLeadItem0[012].getT1();
+    bool guardedSet = ( statusBits & 04000 ) ? true : false;
+    bool plusOneExists = ( statusBits & 02000 ) ? true : false;
+    bool nameChangeInProgress = ( statusBits & 01000 ) ? true : false;
+
+    stream << "    FileSet " << qualifier << "*" << filename << "  ProjectId:" << projectId << std::endl;
+    stream << "      ReadKey:" << readKey << "  WriteKey:" << writeKey
+        << "  FileType:" << getFileTypeString( fileType ) << std::endl;
+    stream << "      Cycles existing:" << currentCycles
+        << "  maxRange:" << maxRange
+        << "  currentRange:" << currentRange
+        << "  highestAbsolute:" << highestAbsolute << std::endl;
+    stream << "      Guarded:" << ( guardedSet ? "Yes" : "No" )
+        << "  +1Exists:" << ( plusOneExists ? "Yes" : "No" )
+        << "  nameChgInProg:" << ( nameChangeInProgress ? "Yes" : "No" ) << std::endl;
+
+    const Word36* pLink = &pLeadItem0[013];
+    int relativeCycle = plusOneExists ? 1 : 0;
+    for ( INDEX ex = 0; ex < currentRange; ++ex )
+    {
+        if ( ex == 17 )
+        {
+            if ( pLeadItem1 == 0 )
+                break;
+            pLink = &pLeadItem1[01];
+        }
+        DSADDR mainItem0Addr = getLinkAddress( pLink[0] );
+        if ( mainItem0Addr != 0 )
+            dumpMFDDirectoryMainItem( stream, snapshot, fileType, relativeCycle, mainItem0Addr );
+        ++pLink;
+        --relativeCycle;
+    }
+}
+
+
+//  dumpMFDDirectoryMainItem()
+//
+//  Handles main items for dumpMFDDirectory
+void
+MFDManager::dumpMFDDirectoryMainItem
+(
+    std::ostream&               stream,
+    const MFDSnapshot&          snapshot,
+    const FileType              fileType,
+    const int                   relativeCycle,
+    const DSADDR                mainItem0Addr
+)
+{
+    const Word36* pMainItem0 = snapshot.getSector( mainItem0Addr );
+    const Word36* pMainItem1 = 0;
+    DSADDR mainItem1Addr = pMainItem0 ? getLinkAddress( pMainItem0[015] ) : 0;
+    if ( mainItem1Addr != 0 )
+        pMainItem1 = snapshot.getSector( mainItem1Addr );
+    if ( (pMainItem0 == 0) || ((mainItem1Addr != 0) && (pMainItem1 == 0)) )
+    {
+        stream << "    Error locating main items at DSADDR 0" << std::oct << mainItem0Addr << std::endl;
+        return;
+    }
+
+    SuperString qualifier = miscWord36FieldataToString( &pMainItem0[01], 2 );
+    SuperString fileName = miscWord36FieldataToString( &pMainItem0[03], 2 );
+    SuperString projectId = miscWord36FieldataToString( &pMainItem0[05], 2 );
+    SuperString account = miscWord36FieldataToString( &pMainItem0[07], 2 );
+    qualifier.trimTrailingSpaces();
+    fileName.trimTrailingSpaces();
+    projectId.trimTrailingSpaces();
+    account.trimTrailingSpaces();
+
+    UINT8 disableFlags = pMainItem0[013].getS1();
+    bool directoryDisabled = ( disableFlags & 020 ) ? true : false;
+    bool writeDisabled = ( disableFlags & 010 ) ? true : false;
+    bool backupDisabled = ( disableFlags & 004 ) ? true : false;
+    bool cacheDisabled = ( disableFlags & 002 ) ? true : false;
+
+    UINT16 descriptorFlags = pMainItem0[014].getT1();
+    bool unloaded = ( descriptorFlags & 04000 ) ? true : false;
+    bool backedUp = ( descriptorFlags & 02000 ) ? true : false;
+    bool saveOnCheckpoint = ( descriptorFlags & 01000 ) ? true : false;
+    bool toBeCataloged = ( descriptorFlags & 00100 ) ? true : false;
+    bool tapeFile = ( descriptorFlags & 00040 ) ? true : false;
+    bool toBeWriteOnly = ( descriptorFlags & 00004 ) ? true : false;
+    bool toBeReadOnly = ( descriptorFlags & 00002 ) ? true : false;
+    bool toBeDropped = ( descriptorFlags & 00001 ) ? true : false;
+
+    UINT8 fileFlags = pMainItem0[014].getS3();
+    bool largeFile = ( fileFlags & 040 ) ? true : false;
+    bool writtenTo = ( fileFlags & 002 ) ? true : false;
+    bool storeThrough = ( fileFlags & 001 ) ? true : false;
+
+    UINT8 pCharFlags = pMainItem0[015].getS1();
+    bool positionGranularity = ( pCharFlags & 040 ) ? true : false;
+    bool wordAddressable = ( pCharFlags & 010 ) ? true : false;
+    bool asgToCommonName = ( pCharFlags & 004 ) ? true : false;
+
+    SuperString asgMnemonic = miscWord36FieldataToString( &pMainItem0[016], 1 );
+    asgMnemonic.trimTrailingSpaces();
+
+    COUNT cumulativeAssignCount = pMainItem0[017].getH2();
+
+    UINT8 inhibitFlags = pMainItem0[021].getS2();
+    bool guarded = ( inhibitFlags & 040 ) ? true : false;
+    bool unloadInhibit = ( inhibitFlags & 020 ) ? true : false;
+    bool privateFile = ( inhibitFlags & 010 ) ? true : false;
+    bool exclusiveUse = ( inhibitFlags & 004 ) ? true : false;
+    bool writeOnly = ( inhibitFlags & 002 ) ? true : false;
+    bool readOnly = ( inhibitFlags & 001 ) ? true : false;
+
+    COUNT currentAssignCount = pMainItem0[021].getT2();
+    UINT16 absoluteCycle = pMainItem0[021].getT3();
+
+    stream << "      " << qualifier << "*" << fileName
+        << "(" << std::dec << absoluteCycle << ")"
+        << "/(" << ( relativeCycle > 0 ? "+" : "-" ) << relativeCycle << ")"
+        << "  Project:" << projectId
+        << "  Account:" << account
+        << "  AsgTDate:" << TDate( pMainItem0[022] )
+        << "  CatTDate:" << TDate( pMainItem0[023] )
+        << std::endl;
+
+    stream << "        AsgMnem:" << asgMnemonic
+        << "  CumulAsg:" << cumulativeAssignCount
+        << "  CurrentAsg:" << currentAssignCount
+        << " - Inhibits:"
+        << ( guarded ? "GUARD " : "" )
+        << ( unloadInhibit ? "UNLD " : "" )
+        << ( privateFile ? "PRIV " : "" )
+        << ( exclusiveUse ? "XUSE " : "" )
+        << ( writeOnly ? "WRONLY " : "" )
+        << ( readOnly ? "RDONLY " : "" )
+        << std::endl;
+
+    stream << "        Desc:"
+        << ( unloaded ? "UNLD " : "" )
+        << ( backedUp ? "BKUP " : "" )
+        << ( saveOnCheckpoint ? "SCHKPT " : "" )
+        << ( toBeCataloged ? "ToBeCAT " : "" )
+        << ( tapeFile ? "TAPE " : "" )
+        << ( toBeReadOnly ? "ToBeRDONLY " : "" )
+        << ( toBeWriteOnly ? "ToBeWRONLY " : "" )
+        << ( toBeDropped ? "ToBeDRP " : "" );
+
+    stream << " - FileFlg:"
+        << ( largeFile ? "LARGE " : "" )
+        << ( writtenTo ? "WRITTEN " : "" )
+        << ( storeThrough ? "STHRU " : "" );
+
+    stream << " - PCHAR:"
+        << ( positionGranularity ? "POSGRN " : "" )
+        << ( wordAddressable ? "WADDR " : "" )
+        << ( asgToCommonName ? "ASGCNS " : "" );
+
+    if ( disableFlags )
+    {
+        stream << " - Disbl: "
+            << ( directoryDisabled ? "MFD " : "" )
+            << ( writeDisabled ? "Write " : "" )
+            << ( backupDisabled ? "Backup " : "" )
+            << ( cacheDisabled ? "Cache " : "" );
+    }
+
+    stream << std::endl;
+
+    //TODO:REM is there a fileType for removable?
+    if ( fileType == FILETYPE_MASS_STORAGE )
+    {
+        COUNT initialReserve = pMainItem0[024].getH1();
+        COUNT maxGranules = pMainItem0[025].getH1();
+        COUNT highestGranuleAssigned = pMainItem0[026].getH1();
+        COUNT highestTrackWritten = pMainItem0[027].getH1();
+        stream << "        InitGran:" << initialReserve
+            << "  MaxGran:" << maxGranules
+            << "  HighestGran:" << highestGranuleAssigned
+            << "  HighestTrk:" << highestTrackWritten
+            << std::endl;
+
+        //  Chase DAD tables
+        DSADDR dadAddr = getLinkAddress( pMainItem0[0] );
+        if ( dadAddr == 0 )
+            stream << "        No DAD Sectors" << std::endl;
+        else
+        {
+            stream << "        DAD Sector  FileRelative  Limit         DeviceRelatv  Region        Entry   Device" << std::endl;
+            stream << "        DSADDR      Word Address  Word Address  Word Address  Word Length   Flags   Index " << std::endl;
+            stream << "        ----------  ------------  ------------  ------------  ------------  ------  ------" << std::endl;
+
+            while ( dadAddr != 0 )
+            {
+                const Word36* pDAD = snapshot.getSector( dadAddr );
+                if ( pDAD == 0 )
+                {
+                    stream << "        MFD ERROR locating DAD at DSADDR=0" << std::oct << dadAddr << std::endl;
+                    break;
+                }
+
+                UINT64 regionAddr = pDAD[2].getW();
+                UINT64 limitAddr = pDAD[3].getW();
+                stream << "        "
+                    << std::oct << std::setw( 10 ) << std::setfill( '0' ) << dadAddr
+                    << "  "
+                    << std::oct << std::setw( 12 ) << std::setfill( '0' ) << regionAddr
+                    << "  "
+                    << std::oct << std::setw( 12 ) << std::setfill( '0' ) << limitAddr
+                    << std::endl;
+
+                const Word36* pEntry = pDAD + 04;
+                for ( INDEX ex = 0; ex < 8; ++ex )
+                {
+                    //  Safety check in case last DAD entry flag isn't there...
+                    if ( regionAddr >= limitAddr )
+                    {
+                        stream << "        WARNING:No last DAD flag found!" << std::endl;
+                        break;
+                    }
+
+                    UINT64 deviceWordAddr = pEntry[0].getW();
+                    UINT64 wordLength = pEntry[1].getW();
+                    UINT32 dadFlags = pEntry[2].getH1();
+                    UINT32 deviceIndex = pEntry[2].getH2();
+
+                    stream << "                                                "
+                        << std::oct << std::setw( 12 ) << std::setfill( '0' ) << deviceWordAddr
+                        << "  "
+                        << std::oct << std::setw( 12 ) << std::setfill( '0' ) << wordLength
+                        << "  "
+                        << std::oct << std::setw( 6 ) << std::setfill( '0' ) << dadFlags
+                        << "  "
+                        << std::oct << std::setw( 6 ) << std::setfill( '0' ) << deviceIndex
+                        << std::endl;
+
+                    //  Is this the last DAD entry?
+                    if ( dadFlags & 04 )
+                        break;
+                    pEntry += 3;
+                }
+
+                dadAddr = getLinkAddress( pDAD[0] );
+            }
+        }
+    }
 
-
-//  calculateCycleInfo()
-//  Inspects the main item links in lead item 0 and the optional lead item 1, and updates:
-//      current cycle range in lead item 0 (word 011, Q3)
-//      current number of cycles (not counting those in to-be state) (word 011, S2)
-//  Caller must ensure that sector 0 has been staged for update.
-//
-//  Parameters:
-//      pLeadItem0:     pointer to lead item 0
-//      pLeadItem1:     pointer to lead item 1 if it exists, else 0
-void
-MFDManager::calculateCycleInfo
-(
-    Word36* const       pLeadItem0,
-    const Word36* const pLeadItem1
-)
-{
-    //  Find the index of the first (highest) entry.
-    //  Normally (but not necessarily always) this will be entry 0.
-    //  If there are no valid links (which could happen in the middle of some operation),
-    //  we will set the current range and count to zero.
-    INDEX firstEntry = 0;
-    COUNT maxLinks = (pLeadItem1 == 0) ? 17 : 32;
-    while ( firstEntry < maxLinks )
+    if ( fileType == FILETYPE_TAPE )
     {
-        const Word36* const pEntry = getMainItemLinkPointer( firstEntry, pLeadItem0, pLeadItem1 );
-        if ( !pEntry->isZero() )
+        UINT8 density = pMainItem0[024].getS1();
+        UINT8 format = pMainItem0[024].getS2();
+        COUNT reels = pMainItem0[024].getH2();
+        UINT8 mtapop = pMainItem0[025].getS3();
+        UINT8 noise = pMainItem0[025].getS6();
+        stream << "        Density:";
+        switch ( density )
+        {
+        case 01:
+            stream << "800/38000BPI";
             break;
-        ++firstEntry;
+        case 02:
+            stream << "1600BPI";
+            break;
+        case 03:
+            stream << "6250BPI";
+            break;
+        case 04:
+            stream << "5090BPMM";
+            break;
+        case 05:
+            stream << "38000BPI";
+            break;
+        case 06:
+            stream << "76000BPI";
+            break;
+        case 07:
+            stream << "85937BPI";
+            break;
+        default:
+            stream << std::oct << density;
+        }
+
+        stream << " Format:"
+            << (format & 01 ? "DataCnv " : "")
+            << (format & 02 ? "QwPack " : "")
+            << (format & 04 ? "6btPack " : "")
+            << (format & 010 ? "8btPack " : "")
+            << (format & 020 ? "Even " : "Odd ")
+            << (format & 040 ? "9Trk " : "");
+
+        stream << " Reels:" << reels;
+
+        stream << " MTAPOP:"
+            << (mtapop & 040 ? "CATJ " : "")
+            << (mtapop & 020 ? "QIC " : "")
+            << (mtapop & 010 ? "HIC " : "")
+            << (mtapop & 004 ? "BufOff " : "")
+            << (mtapop & 002 ? "DLT " : "")
+            << (mtapop & 001 ? "HIS " : "");
+
+        stream << " Noise:" << noise << std::endl;
+
+        // TODO:TAPE display reels, possibly chasing reel tables
     }
 
-    if ( firstEntry == maxLinks )
-    {
-        pLeadItem0[011].setS2( 0 );
-        pLeadItem0[011].setQ3( 0 );
+    if ( pMainItem1 == 0 )
         return;
-    }
 
-    //  Keep iterating over the links, to find the last valid one.
-    COUNT cycles = 1;
-    INDEX lastEntry = firstEntry;
-    INDEX thisEntry = firstEntry;
-    while ( thisEntry < maxLinks )
+    if ( !pMainItem1[010].isZero() )
     {
-        const Word36* const pEntry = getMainItemLinkPointer( firstEntry, pLeadItem0, pLeadItem1 );
-        if ( !pEntry->isZero() )
-        {
-            lastEntry = thisEntry;
-            if ( !pEntry->isNegative() )
-                ++cycles;
-        }
-        ++thisEntry;
+        UINT8 fasBits = pMainItem1[011].getS2();
+        bool unloadedAtBackup = (fasBits & 040) ? true : false;
+        bool numberBlocksPositions = (fasBits & 020) ? true : false;
+
+        stream << "        BkupTDATE:" << TDate( pMainItem1[010] )
+            << " Wrds:" << pMainItem1[07].getT1()
+            << " MaxLvls:" << pMainItem1[011].getS1()
+            << " CurLvls:" << pMainItem1[011].getS3()
+            << " UnldBkup:" << (unloadedAtBackup ? "YES" : "NO")
+            << " Blks:" << pMainItem1[011].getH2()
+            << (numberBlocksPositions ? "POS" : "TRK")
+            << " FilePos:" << pMainItem1[012].getW()
+            << std::endl;
     }
 
-    pLeadItem0[011].setS2( cycles );
-    pLeadItem0[011].setQ3( lastEntry - thisEntry + 1 );
+    switch ( pMainItem1[017].getS2() )
+    {
+    case 1:
+        stream << "        Leg 1 of TIP duplex file" << std::endl;
+        break;
+    case 2:
+        stream << "        Leg 2 of TIP dupliex file" << std::endl;
+        break;
+    case 3:
+        stream << "        TIP simplex file" << std::endl;
+        break;
+    }
 }
 
 
@@ -5071,6 +5386,73 @@ MFDManager::dumpMFDTrack
 }
 
 
+//  dumpSnapshotSectors()
+//
+//  Dumps the content of all the sectors in a directory snapshot, in chunks.
+//  For debugging.
+void
+MFDManager::dumpSnapshotSectors
+(
+    std::ostream&       stream,
+    const MFDSnapshot&  snapshot
+)
+{
+    std::stringstream chunk;
+    chunk << "  Cached Directory Sectors:" << std::endl;
+    for ( INDEX sx = 0; sx < snapshot.getSectorCount(); ++sx )
+    {
+        const Word36* pSector = snapshot.getSectorData( sx );
+        std::stringstream leadStrm;
+        leadStrm << "    " << std::oct << std::setw(10) << std::setfill('0') << snapshot.getSectorAddress( sx ) << ":";
+        COUNT leadSize = leadStrm.str().size();
+        std::string leadStr = leadStrm.str();
+        for ( INDEX wx = 0; wx < 28; wx += 4 )
+        {
+            chunk << leadStr;
+            if ( wx == 0 )
+            {
+                leadStr.clear();
+                leadStr.resize( leadSize );
+            }
+
+            for ( INDEX wy = 0; wy < 4; ++wy )
+                chunk << " " << pSector[wx + wy].toOctal();
+            chunk << " ";
+            for ( INDEX wy = 0; wy < 4; ++wy )
+                chunk << " " << pSector[wx + wy].toFieldata();
+            chunk << " ";
+            for ( INDEX wy = 0; wy < 4; ++wy )
+                chunk << " " << pSector[wx + wy].toAscii();
+            chunk << std::endl;
+        }
+
+        if ( chunk.tellp() >= DUMP_CHUNK_SIZE )
+            flushDumpChunk( stream, &chunk );
+    }
+
+    chunk << "  Updated Directory Sectors:" << std::endl;
+    for ( MFDSnapshot::CITDSADDRSET itus = snapshot.m_UpdatedSectors.begin(); itus != snapshot.m_UpdatedSectors.end(); ++itus )
+        chunk << "    0" << std::oct << *itus << std::endl;
+
+    flushDumpChunk( stream, &chunk );
+}
+
+
+//  flushDumpChunk()
+//
+//  Writes accumulated dump output to the real output stream, and empties the accumulator.
+void
+MFDManager::flushDumpChunk
+(
+    std::ostream&               stream,
+    std::stringstream* const    pChunk
+)
+{
+    stream << pChunk->str();
+    pChunk->str( "" );
+}
+
+
 //  getCommonFileCycleInfo()
 //
 //  Common code for getMassStorageFileCycleInfo() and getTapeFileCycleInfo()
@@ -5342,6 +5724,20 @@ MFDManager::internalPrepBuildSector1
 
 
 
+//  releaseCacheSector()
+//
+//  Returns a directory cache sector (obtained from allocateCacheSector()) to the sector pool.
+void
+MFDManager::releaseCacheSector
+(
+    Word36* const       pSector
+)
+{
+    m_DirectorySectorPool.release( pSector );
+}
+
+
+
 //  ------------------------------------------------------------------------------------------------
 //  ------------------------------------------------------------------------------------------------
 //  constructors, destructors
@@ -5356,7 +5752,9 @@ MFDManager::MFDManager
 m_pConsoleManager( dynamic_cast<ConsoleManager*>( pExec->getManager( Exec::MID_CONSOLE_MANAGER ) ) ),
 m_pDeviceManager( dynamic_cast<DeviceManager*>( pExec->getManager( Exec::MID_DEVICE_MANAGER ) ) )
 {
+    MISCLIB_SET_LOCK_NAME( "MFDManager" );
     m_LookupTableSize = 0;
+    m_UpdateGeneration = 0;
 }
 
 
@@ -5386,7 +5784,8 @@ MFDManager::allocateFileTracks
     const TRACK_COUNT           trackCount
 )
 {
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::allocateFileTracks()"
             << " RUNID=" << pActivity->getRunInfo()->getActualRunId()
@@ -5395,7 +5794,7 @@ MFDManager::allocateFileTracks
             << "(" << pDiskItem->getAbsoluteFileCycle() << ")"
             << " TrkId=0" << std::oct << fileTrackId
             << " TrkCount=0" << std::oct << trackCount;
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     Result result;
@@ -5584,7 +5983,8 @@ MFDManager::assignFileCycle
     FileAllocationTable** const ppFileAllocationTable
 )
 {
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::assignFileCycle() "
             << "RUNID=" << pActivity->getRunInfo()->getActualRunId()
@@ -5592,7 +5992,7 @@ MFDManager::assignFileCycle
             << " EXCL=" << (exclusiveFlag ? "YES" : "NO")
             << " INIT=" << newInitialReserve
             << " MAX=" << newMaxGranules;
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     Result result;
@@ -5790,12 +6190,16 @@ void
     //  Clean cache and such
     while ( !m_DirectoryCache.empty() )
     {
-        delete m_DirectoryCache.begin()->second;
+        releaseCacheSector( m_DirectoryCache.begin()->second );
         m_DirectoryCache.erase( m_DirectoryCache.begin() );
     }
 
     m_DirectoryTrackIdMap.clear();
     m_UpdatedSectors.clear();
+
+    //  Abandon any consistency scan in progress
+    scanClearClaims();
+    m_ScanState.m_Phase = SCANPHASE_IDLE;
 }
 
 
@@ -5827,7 +6231,8 @@ MFDManager::createFileCycle
     const bool              toBeCataloged
 )
 {
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::createFileCycle() "
             << "RUNID=" << pActivity->getRunInfo()->getActualRunId()
@@ -5842,7 +6247,7 @@ MFDManager::createFileCycle
             << " INIT=" << initialReserve
             << " MAX=" << maxGranules
             << " TOBOCAT=" << (toBeCataloged ? "YES" : "NO");
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     Result result;
@@ -5859,7 +6264,8 @@ MFDManager::createFileCycle
 
     bool guardedFile = (pLeadItem0[012].getS1() & 040) == 040 ? true : false;
 
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::string qualifier = miscWord36FieldataToString( &pLeadItem0[1], 2 );
         std::string filename = miscWord36FieldataToString( &pLeadItem0[3], 2 );
         std::string projectId = miscWord36FieldataToString( &pLeadItem0[5], 2 );
@@ -5867,7 +6273,7 @@ MFDManager::createFileCycle
         strm << "     FILE=" << qualifier << "*" << filename
             << " PROJ=" << projectId
             << " GUARD=" << (guardedFile ? "YES" : "NO");
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     //  Allocate DSADDR's for main item sectors 0 and 1.
@@ -5988,7 +6394,8 @@ MFDManager::Result
     DSADDR* const               pDSAddr
     )
 {
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::createFileSet() "
             << "RUNID=" << pActivity->getRunInfo()->getActualRunId()
@@ -5996,7 +6403,7 @@ MFDManager::Result
             << " PROJ=" << projectId
             << " TYPE=" << MFDManager::getFileTypeString( fileType )
             << " GOPT=" << (guardedFile ? "YES" : "NO");
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     Result result;
@@ -6042,14 +6449,15 @@ MFDManager::Result
 
     unlock();
     stopExecOnResultStatus( result, false );
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::createFileSet() returning ";
         if ( result.m_Status == MFDST_SUCCESSFUL )
             strm << "DSADDR=0" << std::oct << (*pDSAddr);
         else
             strm << "MFDResult:" << MFDManager::getResultString( result );
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     return result;
@@ -6073,13 +6481,14 @@ MFDManager::dropFileCycle
     const bool              commitFlag
 )
 {
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::dropFileCycle() "
             << "RUNID=" << pActivity->getRunInfo()->getActualRunId()
             << " mainItem0Addr=0" << std::oct << mainItem0Addr
             << " commit=" << (commitFlag ? "TRUE" : "FALSE");
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     Result result;
@@ -6241,12 +6650,13 @@ MFDManager::dropFileSet
     const DSADDR            leadItem0Addr
 )
 {
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::dropFileSet() "
             << "RUNID=" << pActivity->getRunInfo()->getActualRunId()
             << " leadItem0Addr=0" << std::oct << leadItem0Addr;
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     Result result;
@@ -6296,7 +6706,10 @@ MFDManager::dropFileSet
 
 //  dump()
 //
-//  For debugging
+//  For debugging.
+//  Everything we need is copied or formatted while we hold the lock, but the bulk of the work
+//  (formatting the directory sectors and the directory itself) is done from a snapshot after the lock
+//  is released, so that a large catalog does not hold up facilities requests for the duration of the dump.
 void
 MFDManager::dump
 (
@@ -6304,77 +6717,45 @@ MFDManager::dump
     const DUMPBITS      dumpBitMask
 )
 {
-    lock();
-
-    stream << "MFDManager ----------" << std::endl;
-    stream << "  Lookup Table Size:     " << std::dec << m_LookupTableSize << std::endl;
-    stream << "  Overhead Account Id:   " << m_OverheadAccountId << std::endl;
-    stream << "  Overhead User Id:      " << m_OverheadUserId << std::endl;
-
-    if ( dumpBitMask & DUMP_TRACK_ID_MAP )
-    {
-        stream << "  MFD-relative Track ID to Block ID map" << std::endl;
-        for ( CITDIRECTORYTRACKIDMAP it = m_DirectoryTrackIdMap.begin(); it != m_DirectoryTrackIdMap.end(); ++it )
-        {
-            stream << "    " << std::setw( 10 ) << std::oct << std::setfill( '0' ) << it->first
-                << " -> " << std::setw( 10 ) << std::oct << std::setfill( '0' ) << it->second << std::endl;
-        }
-    }
+    MFDSnapshot snapshot;
+    std::stringstream headerStrm;
+    std::stringstream tablesStrm;
 
-    if ( dumpBitMask & DUMP_CACHED_DIRECTORY_SECTOR_DATA )
-    {
-        stream << "  Cached Directory Sectors:" << std::endl;
-        for ( CITDIRECTORYCACHE itdc = m_DirectoryCache.begin(); itdc != m_DirectoryCache.end(); ++itdc )
-        {
-            std::stringstream leadStrm;
-            leadStrm << "    " << std::oct << std::setw(10) << std::setfill('0') << itdc->first << ":";
-            COUNT leadSize = leadStrm.str().size();
-            std::string leadStr = leadStrm.str();
-            for ( INDEX wx = 0; wx < 28; wx += 4 )
-            {
-                stream << leadStr;
-                if ( wx == 0 )
-                {
-                    leadStr.clear();
-                    leadStr.resize( leadSize );
-                }
+    lock();
 
-                for ( INDEX wy = 0; wy < 4; ++wy )
-                    stream << " " << itdc->second[wx + wy].toOctal();
-                stream << " ";
-                for ( INDEX wy = 0; wy < 4; ++wy )
-                    stream << " " << itdc->second[wx + wy].toFieldata();
-                stream << " ";
-                for ( INDEX wy = 0; wy < 4; ++wy )
-                    stream << " " << itdc->second[wx + wy].toAscii();
-                stream << std::endl;
-            }
-        }
+    if ( dumpBitMask & (DUMP_TRACK_ID_MAP | DUMP_CACHED_DIRECTORY_SECTOR_DATA | DUMP_SEARCH_ITEM_LOOKUP_TABLE | DUMP_MFD_DIRECTORY) )
+        takeDirectorySnapshot( &snapshot );
 
-        stream << "  Updated Directory Sectors:" << std::endl;
-        for ( CITDSADDRSET itus = m_UpdatedSectors.begin(); itus != m_UpdatedSectors.end(); ++itus )
-            stream << "    0" << std::oct << *itus << std::endl;
-    }
+    headerStrm << "MFDManager ----------" << std::endl;
+    headerStrm << "  Lookup Table Size:     " << std::dec << m_LookupTableSize << std::endl;
+    headerStrm << "  Overhead Account Id:   " << m_OverheadAccountId << std::endl;
+    headerStrm << "  Overhead User Id:      " << m_OverheadUserId << std::endl;
+    FixedBlockPool::dumpAll( headerStrm, "  " );
+    headerStrm << "  Consistency Scan:      Passes=" << std::dec << m_ScanCheckpoint.m_PassesCompleted
+        << "  LastPass=" << m_ScanCheckpoint.m_LastPassCompleted
+        << "  LastClean=" << m_ScanCheckpoint.m_LastCleanPass
+        << "  LastDiscrepancies=" << m_ScanCheckpoint.m_LastPassDiscrepancies
+        << "  Sectors=" << m_ScanCheckpoint.m_SectorsExamined << std::endl;
 
     if ( dumpBitMask & DUMP_FILE_ALLOCATION_TABLE )
     {
-        stream << "  File Allocation Directory:" << std::endl;
+        tablesStrm << "  File Allocation Directory:" << std::endl;
         for ( CITFILEALLOCATIONDICTIONARY itfad = m_FileAllocationDictionary.begin(); itfad != m_FileAllocationDictionary.end(); ++itfad )
         {
             std::stringstream fileIdStrm;
             fileIdStrm << "DSADDR=" << std::oct << std::setw(10) << std::setfill('0') << itfad->first;
-            itfad->second->dump( stream, "      ", fileIdStrm.str() );
+            itfad->second->dump( tablesStrm, "      ", fileIdStrm.str() );
         }
     }
 
-    stream << "  Pack Info:" << std::endl;
-    stream << "    LDAT  PackId  Prep      DirTrkSector  HMBTWds  SMBTWds  Tracks        Mntd  DvId  FxPl  Asg#" << std::endl;
+    tablesStrm << "  Pack Info:" << std::endl;
+    tablesStrm << "    LDAT  PackId  Prep      DirTrkSector  HMBTWds  SMBTWds  Tracks        Mntd  DvId  FxPl  Asg#" << std::endl;
     for ( CITPACKINFOMAP itpi = m_PackInfo.begin(); itpi != m_PackInfo.end(); ++itpi )
     {
         std::string padPackId = itpi->second->m_PackName;
         padPackId.resize( 6, ' ' );
 
-        stream << "    " << std::oct << std::setw(4) << std::setfill('0') << itpi->second->m_LDATIndex
+        tablesStrm << "    " << std::oct << std::setw(4) << std::setfill('0') << itpi->second->m_LDATIndex
                 << "  " << padPackId
                 << "  " << std::dec << std::setw(4) << itpi->second->m_PrepFactor
                 << "  " << ( itpi->second->m_IsFixed ? " F" : " R" )
@@ -6389,28 +6770,46 @@ MFDManager::dump
                 << std::endl;
 
         if ( dumpBitMask & DUMP_DISK_ALLOCATIONS )
-            itpi->second->m_DiskAllocationTable.dump( stream, "      ", itpi->second->m_PackName );
+            itpi->second->m_DiskAllocationTable.dump( tablesStrm, "      ", itpi->second->m_PackName );
     }
 
+    unlock();
+
+    //  Everything from here on is done without the lock
+    flushDumpChunk( stream, &headerStrm );
+
+    if ( dumpBitMask & DUMP_TRACK_ID_MAP )
+    {
+        stream << "  MFD-relative Track ID to Block ID map" << std::endl;
+        for ( MFDSnapshot::CITTRACKIDMAP it = snapshot.m_DirectoryTrackIdMap.begin(); it != snapshot.m_DirectoryTrackIdMap.end(); ++it )
+        {
+            stream << "    " << std::setw( 10 ) << std::oct << std::setfill( '0' ) << it->first
+                << " -> " << std::setw( 10 ) << std::oct << std::setfill( '0' ) << it->second << std::endl;
+        }
+    }
+
+    if ( dumpBitMask & DUMP_CACHED_DIRECTORY_SECTOR_DATA )
+        dumpSnapshotSectors( stream, snapshot );
+
+    flushDumpChunk( stream, &tablesStrm );
+
     if ( dumpBitMask & DUMP_SEARCH_ITEM_LOOKUP_TABLE )
     {
         stream << "  Search Item Lookup Table:  HASH          DSADDR" << std::endl;
-        for ( INDEX sx = 0; sx < m_SearchItemLookupTable.size(); ++sx )
+        for ( INDEX sx = 0; sx < snapshot.m_SearchItemLookupTable.size(); ++sx )
         {
-            if ( m_SearchItemLookupTable[sx] != 0 )
+            if ( snapshot.m_SearchItemLookupTable[sx] != 0 )
             {
                 stream << "                             "
                         << std::oct << std::setw(12) << std::setfill('0') << sx
-                        << "  " << std::oct << std::setw(10) << std::setfill('0') << m_SearchItemLookupTable[sx]
+                        << "  " << std::oct << std::setw(10) << std::setfill('0') << snapshot.m_SearchItemLookupTable[sx]
                         << std::endl;
             }
         }
     }
 
     if ( dumpBitMask & DUMP_MFD_DIRECTORY )
-        dumpMFDDirectory( stream );
-
-    unlock();
+        dumpMFDDirectory( stream, snapshot );
 }
 
 
@@ -6446,17 +6845,107 @@ MFDManager::getDeviceId
     DeviceManager::DEVICE_ID* const pDeviceId
 ) const
 {
-    bool result = false;
+    bool result = false;
+    lock();
+
+    CITPACKINFOMAP itpi = m_PackInfo.find( ldatIndex );
+    if ( (itpi != m_PackInfo.end()) && itpi->second->m_IsMounted )
+    {
+        *pDeviceId = itpi->second->m_DeviceId;
+        result = true;
+    }
+
+    unlock();
+    return result;
+}
+
+
+//  getCatalogInfo()
+//
+//  Batch catalog query - populates all the entries in the given list, under a single acquisition of the lock.
+//  Caller allocates the entries, filling in qualifier and filename.
+//  If includeCycleInfo is set, file cycle info is loaded for every existing cycle of every file set found.
+//  Per-entry results are in the entries; the returned result reflects only failures other than MFDST_NOT_FOUND.
+MFDManager::Result
+MFDManager::getCatalogInfo
+(
+    CatalogQueryList* const pList,
+    const bool              includeCycleInfo
+)
+{
+    lock();
+    Result result = loadCatalogQueryEntries( pList, includeCycleInfo );
+    unlock();
+
+    stopExecOnResultStatus( result, false );
+    return result;
+}
+
+
+//  getCatalogInfo()
+//
+//  Batch catalog query for all file sets whose qualifier begins with the given prefix
+//  (an empty prefix selects all cataloged file sets).  Entries are appended to the caller's list.
+//  Since the lookup table is hashed on qualifier and filename, this requires one walk of the search items.
+MFDManager::Result
+MFDManager::getCatalogInfo
+(
+    const SuperString&      qualifierPrefix,
+    const bool              includeCycleInfo,
+    CatalogQueryList* const pList
+)
+{
+    Result result;
     lock();
 
-    CITPACKINFOMAP itpi = m_PackInfo.find( ldatIndex );
-    if ( (itpi != m_PackInfo.end()) && itpi->second->m_IsMounted )
+    SuperString prefix = qualifierPrefix;
+    prefix.foldToUpperCase();
+
+    //  Collect matching file sets from the search items - we don't touch the lead items yet.
+    CatalogQueryList newEntries;
+    Word36* pSearchItem = 0;
+    for ( INDEX sx = 0; (sx < m_SearchItemLookupTable.size()) && (result.m_Status == MFDST_SUCCESSFUL); ++sx )
     {
-        *pDeviceId = itpi->second->m_DeviceId;
-        result = true;
+        DSADDR searchItemAddr = m_SearchItemLookupTable[sx];
+        while ( searchItemAddr != 0 )
+        {
+            if ( !stageDirectorySector( searchItemAddr, &pSearchItem, &result ) )
+                break;
+
+            Word36* pSearchEntry = pSearchItem + 1;
+            for ( INDEX ex = 0; ex < 5; ++ex )
+            {
+                DSADDR leadItemAddr0 = getLinkAddress( pSearchEntry[4] );
+                if ( leadItemAddr0 != 0 )
+                {
+                    SuperString qualifier = miscWord36FieldataToString( &pSearchEntry[0], 2 );
+                    qualifier.trimTrailingSpaces();
+                    if ( qualifier.compare( 0, prefix.size(), prefix ) == 0 )
+                    {
+                        SuperString filename = miscWord36FieldataToString( &pSearchEntry[2], 2 );
+                        filename.trimTrailingSpaces();
+                        CatalogQueryEntry* pEntry = new CatalogQueryEntry( qualifier, filename );
+                        pEntry->m_LeadItem0Addr = leadItemAddr0;
+                        newEntries.push_back( pEntry );
+                    }
+                }
+
+                pSearchEntry += 5;
+            }
+
+            searchItemAddr = getLinkAddress( pSearchItem[0] );
+        }
     }
 
+    if ( result.m_Status == MFDST_SUCCESSFUL )
+        result = loadCatalogQueryEntries( &newEntries, includeCycleInfo );
+
     unlock();
+
+    //  Hand the entries over to the caller
+    pList->splice( pList->end(), newEntries );
+
+    stopExecOnResultStatus( result, false );
     return result;
 }
 
@@ -6546,68 +7035,6 @@ MFDManager::getFileSetInfo
 }
 
 
-//  getFileSetInfoList()
-//
-//  Populates a FileSetInfoList object for all cataloged file sets
-MFDManager::Result
-MFDManager::getFileSetInfoList
-(
-    FileSetInfoList* const  pList
-)
-{
-    Result result;
-    lock();
-
-    //  Iterate over the search item lookup table
-    Word36* pSearchEntry = 0;
-    Word36* pSearchItem = 0;
-    for ( INDEX sx = 0; sx < m_SearchItemLookupTable.size(); ++sx )
-    {
-        //  Found an item (which might be at the head of a chain).  Iterate over the chain.
-        DSADDR searchItemAddr = m_SearchItemLookupTable[sx];
-        while ( searchItemAddr != 0 )
-        {
-            //  Stage the search item.
-            if ( !stageDirectorySector( searchItemAddr, &pSearchItem, &result ) )
-            {
-                unlock();
-                return result;
-            }
-
-            //  Iterate over the potential entries in this search item
-            pSearchEntry = pSearchItem + 1;
-            for ( INDEX ex = 0; ex < 5; ++ex )
-            {
-                DSADDR leadItemAddr0 = getLinkAddress( pSearchEntry[4] );
-                if ( leadItemAddr0 != 0 )
-                {
-                    //  We have a lead item address - load a file set info object for it.
-                    FileSetInfo* pfsInfo = new FileSetInfo();
-                    result = getFileSetInfo( leadItemAddr0, pfsInfo );
-                    if ( result.m_Status != MFDST_SUCCESSFUL )
-                    {
-                        delete pfsInfo;
-                        unlock();
-                        return result;
-                    }
-
-                    pList->push_back( pfsInfo );
-                }
-
-                pSearchEntry += 5;
-            }
-
-            //  Get next linked search item
-            searchItemAddr = (result.m_Status == MFDST_SUCCESSFUL) ? getLinkAddress( pSearchItem[0] ) : 0;
-        }
-    }
-
-    unlock();
-    stopExecOnResultStatus( result, false );
-    return result;
-}
-
-
 //  getFixedPoolTrackCounts()
 //
 //  Retrieves the number of tracks accessible on all UP and SU fixed packs,
@@ -6669,40 +7096,10 @@ MFDManager::getMassStorageFileCycleInfo
     MassStorageFileCycleInfo* const pInfo
 )
 {
-    Result result;
     lock();
-
-    Word36* pMainItem0 = 0;
-    Word36* pMainItem1 = 0;
-    DSADDR mainItem1Addr;
-    if ( stageMainItems( mainItem0Addr, false, &mainItem1Addr, &pMainItem0, &pMainItem1, &result ) )
-    {
-        FileCycleInfo* pCommonInfo = dynamic_cast<FileCycleInfo*>( pInfo );
-        getCommonFileCycleInfo( pCommonInfo, mainItem0Addr, pMainItem0, mainItem1Addr, pMainItem1 );
-
-        //  Mass-storage-specific
-        UINT16 descriptors = pMainItem0[014].getT1();
-        UINT8 inhibits = pMainItem0[021].getS2();
-        UINT8 fileFlags = pMainItem0[014].getS3();
-        UINT8 pchar = pMainItem0[015].getS1();
-
-        pInfo->m_TDateFirstWriteAfterBackup = pMainItem0[012];
-        pInfo->m_Unloaded = (descriptors & 04000) ? true : false;
-        pInfo->m_SaveOnCheckpoint = (descriptors & 01000) ? true : false;
-        pInfo->m_LargeFile = (fileFlags & 040) ? true : false;
-        pInfo->m_WrittenTo = (fileFlags & 002) ? true : false;
-        pInfo->m_StoreThrough = (fileFlags & 001) ? true : false;
-        pInfo->m_PositionGranularity = (pchar & 040) ? true : false;
-        pInfo->m_WordAddressable = (pchar & 010) ? true : false;
-        pInfo->m_AssignedToCommonNameSection = (pchar & 004) ? true : false;
-        pInfo->m_UnloadInhibited = (inhibits & 020) ? true : false;
-        pInfo->m_InitialReserve = pMainItem0[024].getH1();
-        pInfo->m_MaxGranules = pMainItem0[025].getH1();
-        pInfo->m_HighestGranuleAssigned = pMainItem0[026].getH1();
-        pInfo->m_HighestTrackWritten = pMainItem0[027].getH1();
-    }
-
+    Result result = loadMassStorageFileCycleInfo( mainItem0Addr, pInfo );
     unlock();
+
     stopExecOnResultStatus( result, false );
     return result;
 }
@@ -6789,6 +7186,19 @@ MFDManager::getPrepFactor
 }
 
 
+//  getScanCheckpoint()
+//
+//  Retrieves a summary of background consistency scanning results
+MFDManager::ScanCheckpoint
+MFDManager::getScanCheckpoint() const
+{
+    lock();
+    ScanCheckpoint checkpoint = m_ScanCheckpoint;
+    unlock();
+    return checkpoint;
+}
+
+
 //  getSearchItemAddresses()
 //
 //  Mainly for @DIR - retrieves a set containing all of the DSADDR's on a particular search item chain
@@ -6834,125 +7244,10 @@ MFDManager::getTapeFileCycleInfo
     TapeFileCycleInfo* const    pInfo
 )
 {
-    Result result;
     lock();
-
-    Word36* pMainItem0 = 0;
-    Word36* pMainItem1 = 0;
-    DSADDR mainItem1Addr;
-    if ( stageMainItems( mainItem0Addr, false, &mainItem1Addr, &pMainItem0, &pMainItem1, &result ) )
-    {
-        FileCycleInfo* pCommonInfo = dynamic_cast<FileCycleInfo*>( pInfo );
-        getCommonFileCycleInfo( pCommonInfo, mainItem0Addr, pMainItem0, mainItem1Addr, pMainItem1 );
-
-        //  Tape-specific
-        UINT8 density = pMainItem0[024].getS1();
-        UINT8 format = pMainItem0[024].getS2();
-        UINT8 features = pMainItem0[024].getS3();
-        UINT8 mtapop = pMainItem0[025].getS3();
-
-        if ( features & 040 )
-            pInfo->m_BlockNumbering = TBN_ON;
-        else if ( features & 010 )
-            pInfo->m_BlockNumbering = TBN_OPTIONAL;
-        else
-            pInfo->m_BlockNumbering = TBN_OFF;
-
-        if ( features & 004 )
-            pInfo->m_DataCompression = TDC_ON;
-        else if ( features & 001 )
-            pInfo->m_DataCompression = TDC_OPTIONAL;
-        else
-            pInfo->m_DataCompression = TDC_OFF;
-
-        switch ( density )
-        {
-        case 001:
-            if ( mtapop & 010 ) // HIC
-                pInfo->m_Density = TDENS_38000;
-            else
-                pInfo->m_Density = TDENS_800;
-            break;
-        case 002:
-            pInfo->m_Density = TDENS_1600;
-            break;
-        case 003:
-            pInfo->m_Density = TDENS_6250;
-            break;
-        case 004:
-            pInfo->m_Density = TDENS_5090;
-            break;
-        case 005:
-            pInfo->m_Density = TDENS_38000;
-            break;
-        case 006:
-            pInfo->m_Density = TDENS_76000;
-            break;
-        case 007:
-            pInfo->m_Density = TDENS_85937;
-            break;
-        }
-
-        if ( format & 002 )
-            pInfo->m_Format = TFMT_QUARTER_WORD;
-        else if ( format & 004 )
-            pInfo->m_Format = TFMT_SIX_BIT_PACKED;
-        else
-            pInfo->m_Format = TFMT_EIGHT_BIT_PACKED;
-
-        if ( mtapop & 020 )
-            pInfo->m_Type = TTYPE_QIC;
-        else if ( mtapop & 010 )
-            pInfo->m_Type = TTYPE_HIC;
-        else if ( mtapop & 002 )
-            pInfo->m_Type = TTYPE_DLT;
-        else if ( mtapop & 001 )
-            pInfo->m_Type = TTYPE_HIS;
-        else
-        {
-            if ( format & 040 )
-                pInfo->m_Type = TTYPE_NINE_TRACK;
-            else
-                pInfo->m_Type = TTYPE_SEVEN_TRACK;
-        }
-
-        if ( (pInfo->m_Type == TTYPE_SEVEN_TRACK) || (pInfo->m_Type == TTYPE_NINE_TRACK) )
-        {
-            if ( format & 020 )
-                pInfo->m_Parity = TPAR_EVEN;
-            else
-                pInfo->m_Parity = TPAR_ODD;
-        }
-        else
-            pInfo->m_Parity = TPAR_NONE;
-
-        pInfo->m_NoiseConstant = pMainItem0[025].getS6();
-        pInfo->m_JOption = ( mtapop & 040 ) ? true : false;
-
-        if ( pMainItem0[032].getW() != 0 )
-            pInfo->m_Reels.push_back( miscWord36FieldataToString( &pMainItem0[032], 1 ));
-        if ( pMainItem0[033].getW() != 0 )
-            pInfo->m_Reels.push_back( miscWord36FieldataToString( &pMainItem0[033], 1 ));
-        DSADDR reelTableAddr = getLinkAddress( pMainItem0[0] );
-        while ( reelTableAddr )
-        {
-            Word36* pReelTable = 0;
-            if ( !stageDirectorySector( reelTableAddr, false, &pReelTable, &result ) )
-                break;
-
-            pInfo->m_DirectorySectorAddresses.push_back( reelTableAddr );
-
-            for ( INDEX wx = 2; wx < 033; ++wx )
-            {
-                if ( pReelTable[wx].getW() != 0 )
-                    pInfo->m_Reels.push_back( miscWord36FieldataToString( &pReelTable[wx], 1 ));
-            }
-
-            reelTableAddr = getLinkAddress( pReelTable[0] );
-        }
-    }
-
+    Result result = loadTapeFileCycleInfo( mainItem0Addr, pInfo );
     unlock();
+
     stopExecOnResultStatus( result, false );
     return result;
 }
@@ -6981,14 +7276,19 @@ MFDManager::initialize
     //  Iterate over the boot disk info we've collected, for all fixed packs.
     //  Assign LDAT indexes, and build m_PackInfo for all packs.
     //  DNs any packs with pack name conflicts (this means we'll still always have at least one).
+    BootProfile* pProfile = m_pExec->getBootProfile();
     if ( !pActivity->isTerminating() )
+    {
+        BootProfile::Span span( pProfile, "LOAD PACK INFO" );
         initializeLoadPackInfo( pActivity, m_BootPackInfo );
+    }
 
     //  Initialize fixed packs..
     //  This clears out all allocations for the fixed packs using direct IO.
     //  Also, it loads directory sectors into cache.
     if ( !pActivity->isTerminating() )
     {
+        BootProfile::Span span( pProfile, "INIT FIXED PACKS" );
         result = initializeFixedPacks( pActivity );
         if ( result.m_Status != MFDST_SUCCESSFUL )
         {
@@ -7000,6 +7300,7 @@ MFDManager::initialize
     //  Load Disk Allocation Tables for the fixed packs based on the SMBTs
     if ( !pActivity->isTerminating() )
     {
+        BootProfile::Span span( pProfile, "LOAD ALLOCATION TABLES" );
         result = loadFixedPackAllocationTables( pActivity );
         if ( result.m_Status != MFDST_SUCCESSFUL )
         {
@@ -7015,6 +7316,7 @@ MFDManager::initialize
     FileAllocationTable* pMFDFat = 0;
     if ( !pActivity->isTerminating() )
     {
+        BootProfile::Span span( pProfile, "CATALOG MFD" );
         result = initializeCatalogMFD( pActivity, &mfdMainItem0Addr, &pMFDFat );
         if ( result.m_Status != MFDST_SUCCESSFUL )
         {
@@ -7026,6 +7328,7 @@ MFDManager::initialize
     //  Manually assign SYS$*MFDF$$ (create a FacItem and stick in in Exec's RunInfo)
     if ( !pActivity->isTerminating() )
     {
+        BootProfile::Span span( pProfile, "ASSIGN MFD" );
         result = initializeAssignMFD( pActivity, mfdMainItem0Addr, pMFDFat );
         if ( result.m_Status != MFDST_SUCCESSFUL )
         {
@@ -7037,6 +7340,7 @@ MFDManager::initialize
     //  Commit MFD changes (now that we have the MFD assigned and its DAD tables loaded)
     if ( !pActivity->isTerminating() )
     {
+        BootProfile::Span span( pProfile, "COMMIT MFD" );
         result = commitMFDUpdates( pActivity );
         if ( result.m_Status != MFDST_SUCCESSFUL )
         {
@@ -7080,6 +7384,7 @@ MFDManager::readDiskLabels
 )
 {
     Result result;
+    BootProfile::Span span( m_pExec->getBootProfile(), "READ DISK LABELS" );
     lock();
 
     result = readDiskLabels( pActivity, &m_BootPackInfo );
@@ -7122,12 +7427,13 @@ MFDManager::releaseExclusiveUse
     const DSADDR        mainItem0Addr
 )
 {
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::releaseExclusiveUse() "
             << "RUNID=" << pActivity->getRunInfo()->getActualRunId()
             << " mainItem0Addr=0" << std::oct << mainItem0Addr;
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     Result result;
@@ -7166,12 +7472,13 @@ MFDManager::releaseFileCycle
     const DSADDR        mainItem0Addr
 )
 {
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::releaseFileCycle() "
             << "RUNID=" << pActivity->getRunInfo()->getActualRunId()
             << " mainItem0Addr=0" << std::oct << mainItem0Addr;
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     Result result;
@@ -7316,7 +7623,8 @@ MFDManager::releaseFileTracks
     const TRACK_COUNT       trackCount
 )
 {
-    {//TODO:DEBUG
+    if ( SYSTEM_LOG_ENABLED( MFD, DEBUG ) )
+    {
         std::stringstream strm;
         strm << "MFDManager::releaseFileTracks() "
             << "RUNID=" << pActivity->getRunInfo()->getActualRunId()
@@ -7324,7 +7632,7 @@ MFDManager::releaseFileTracks
             << "(" << pDiskItem->getAbsoluteFileCycle() << ")"
             << " TrkId=" << fileTrackId
             << " TrkCount=" << trackCount;
-        SystemLog::write( strm.str() );
+        SystemLog::write( SystemLog::CATEGORY_MFD, SystemLog::LEVEL_DEBUG, strm.str() );
     }
 
     Result result;
@@ -7439,7 +7747,7 @@ MFDManager::setBadTrack
 void
 MFDManager::shutdown()
 {
-    SystemLog::write( "MFDManager::shutdown()" );
+    SYSTEM_LOG( MFD, INFO, "MFDManager::shutdown()" );
 }
 
 
@@ -7450,12 +7758,14 @@ MFDManager::shutdown()
 bool
 MFDManager::startup()
 {
-    SystemLog::write( "MFDManager::startup()" );
+    SYSTEM_LOG( MFD, INFO, "MFDManager::startup()" );
 
     //  (re)load config data
     getConfigData();
 
     //  Clear out the cache
+    for ( ITDIRECTORYCACHE itdc = m_DirectoryCache.begin(); itdc != m_DirectoryCache.end(); ++itdc )
+        releaseCacheSector( itdc->second );
     m_DirectoryCache.clear();
     m_DirectoryTrackIdMap.clear();
     m_UpdatedSectors.clear();
@@ -7472,10 +7782,39 @@ MFDManager::startup()
     m_SearchItemLookupTable.clear();
     m_SearchItemLookupTable.resize( m_LookupTableSize, 0 );
 
+    //  Any consistency scan in progress is no longer meaningful.  The checkpoint persists.
+    scanClearClaims();
+    m_ScanState.m_Phase = SCANPHASE_IDLE;
+
     return true;
 }
 
 
+//  takeDirectorySnapshot()
+//
+//  Copies the directory cache, the search item lookup table, and the directory track map into the given snapshot.
+//  This is the only part of a snapshot-based dump or export which needs the lock, and it is a straight copy.
+void
+MFDManager::takeDirectorySnapshot
+(
+    MFDSnapshot* const  pSnapshot
+) const
+{
+    pSnapshot->clear();
+
+    lock();
+
+    pSnapshot->m_SearchItemLookupTable = m_SearchItemLookupTable;
+    pSnapshot->m_DirectoryTrackIdMap = m_DirectoryTrackIdMap;
+    pSnapshot->m_UpdatedSectors = m_UpdatedSectors;
+    pSnapshot->reserve( m_DirectoryCache.size() );
+    for ( CITDIRECTORYCACHE itdc = m_DirectoryCache.begin(); itdc != m_DirectoryCache.end(); ++itdc )
+        pSnapshot->addSector( itdc->first, itdc->second );
+
+    unlock();
+}
+
+
 //  terminate()
 //
 //  Exec::ExecManager interface
@@ -7483,7 +7822,7 @@ MFDManager::startup()
 void
 MFDManager::terminate()
 {
-    SystemLog::write( "MFDManager::terminate()" );
+    SYSTEM_LOG( MFD, INFO, "MFDManager::terminate()" );
 }
 
 
@@ -61,6 +61,7 @@
 #include    "DiskFacilityItem.h"
 #include    "ExecManager.h"
 #include    "FileAllocationTable.h"
+#include    "MFDSnapshot.h"
 
 
 
@@ -257,18 +258,6 @@ public:
         {}
     };
 
-    class   FileSetInfoList : public std::list<FileSetInfo*>
-    {
-    public:
-        ~FileSetInfoList()                  { clear(); }
-
-        void clear()
-        {
-            for ( iterator it = begin(); it != end(); ++it )
-                delete *it;
-        }
-    };
-
     //  Represents the status of a request
     class   Result
     {
@@ -287,6 +276,70 @@ public:
         }
     };
 
+    //  One element of a batch catalog query - see getCatalogInfo().
+    //  The caller fills in qualifier and filename; everything else is filled in by the query.
+    class   CatalogQueryEntry
+    {
+    public:
+        SuperString                 m_Qualifier;
+        SuperString                 m_Filename;
+        DSADDR                      m_LeadItem0Addr;    //  zero if the file set is not cataloged
+        Result                      m_Result;           //  MFDST_NOT_FOUND if the file set is not cataloged
+        FileSetInfo                 m_FileSetInfo;
+        std::vector<FileCycleInfo*> m_CycleInfos;       //  Parallel to m_FileSetInfo.m_CycleEntries, if cycle info was
+                                                        //      requested.  Elements are MassStorageFileCycleInfo or
+                                                        //      TapeFileCycleInfo objects, or zero for non-existent cycles.
+
+        CatalogQueryEntry( const SuperString&   qualifier,
+                           const SuperString&   filename )
+            :m_Qualifier( qualifier ),
+            m_Filename( filename ),
+            m_LeadItem0Addr( 0 )
+        {}
+
+        ~CatalogQueryEntry()
+        {
+            for ( INDEX cx = 0; cx < m_CycleInfos.size(); ++cx )
+                delete m_CycleInfos[cx];
+        }
+
+    private:
+        CatalogQueryEntry( const CatalogQueryEntry& );
+        CatalogQueryEntry& operator=( const CatalogQueryEntry& );
+    };
+
+    class   CatalogQueryList : public std::list<CatalogQueryEntry*>
+    {
+    public:
+        ~CatalogQueryList()                 { clear(); }
+
+        void clear()
+        {
+            for ( iterator it = begin(); it != end(); ++it )
+                delete *it;
+            std::list<CatalogQueryEntry*>::clear();
+        }
+    };
+
+    //  Summary of the results of background consistency scanning - see scanStep()
+    class   ScanCheckpoint
+    {
+    public:
+        COUNT64                     m_PassesCompleted;
+        EXECTIME                    m_LastPassCompleted;        //  Zero if no pass has completed
+        EXECTIME                    m_LastCleanPass;            //  Zero if no pass has completed without discrepancies
+        COUNT64                     m_LastPassDiscrepancies;
+        COUNT64                     m_SectorsExamined;          //  Total for all passes
+
+        ScanCheckpoint()
+            :m_PassesCompleted( 0 ),
+            m_LastPassCompleted( 0 ),
+            m_LastCleanPass( 0 ),
+            m_LastPassDiscrepancies( 0 ),
+            m_SectorsExamined( 0 )
+        {}
+    };
+
     class   PackInfo
     {
         //  To be used in a map, keyed by LDATINDEX (as soon as it is available)
@@ -331,6 +384,12 @@ private:
     typedef     PACKINFOMAP::iterator                           ITPACKINFOMAP;
     typedef     PACKINFOMAP::const_iterator                     CITPACKINFOMAP;
 
+    //  Batch catalog query entries, and cycles of those entries, keyed by directory sector address
+    typedef     std::multimap<DSADDR, CatalogQueryEntry*>                   CATALOGQUERYMAP;
+    typedef     CATALOGQUERYMAP::const_iterator                             CITCATALOGQUERYMAP;
+    typedef     std::multimap<DSADDR, std::pair<CatalogQueryEntry*, INDEX>> CATALOGCYCLEMAP;
+    typedef     CATALOGCYCLEMAP::const_iterator                             CITCATALOGCYCLEMAP;
+
 
     //  Dictionary of FILEALLOCATIONTABLE's, keyed by the DSADDR of the file's main item 0 sector
     typedef     std::map<DSADDR, FileAllocationTable*>          FILEALLOCATIONDICTIONARY;
@@ -346,6 +405,41 @@ private:
     typedef     DIRECTORYTRACKIDMAP::iterator                   ITDIRECTORYTRACKIDMAP;
     typedef     DIRECTORYTRACKIDMAP::const_iterator             CITDIRECTORYTRACKIDMAP;
 
+    //  Tracks claimed by the file cycles examined so far in a consistency scan, by pack
+    typedef     std::map<LDATINDEX, DiskAllocationTable*>       SCANCLAIMS;
+    typedef     SCANCLAIMS::iterator                            ITSCANCLAIMS;
+
+    enum    ScanPhase
+    {
+        SCANPHASE_IDLE,
+        SCANPHASE_FILE_SETS,        //  Walking search items, lead items, main items, and DADs
+        SCANPHASE_PACKS,            //  Comparing each fixed pack's SMBT to its DiskAllocationTable
+    };
+
+    //  Where we are in the current consistency scan pass
+    class   ScanState
+    {
+    public:
+        ScanPhase                   m_Phase;
+        INDEX                       m_LookupIndex;          //  Next search item lookup table entry to be scanned
+        LDATINDEX                   m_LDATIndex;            //  Pack currently (or next) being scanned
+        WORD_COUNT                  m_SMBTWordOffset;       //  Progress through that pack's SMBT
+        UINT64                      m_UpdateGeneration;     //  m_UpdateGeneration when the pass started
+        bool                        m_ClaimsValid;          //  false if the MFD was updated during the pass
+        COUNT64                     m_Discrepancies;
+        SCANCLAIMS                  m_Claims;
+
+        ScanState()
+            :m_Phase( SCANPHASE_IDLE ),
+            m_LookupIndex( 0 ),
+            m_LDATIndex( 0 ),
+            m_SMBTWordOffset( 0 ),
+            m_UpdateGeneration( 0 ),
+            m_ClaimsValid( false ),
+            m_Discrepancies( 0 )
+        {}
+    };
+
 
     //  private data
     PACKINFOLIST                        m_BootPackInfo;                 //  Created by readDiskLabels(), consumed by initialize() or recover()
@@ -360,6 +454,11 @@ private:
     PACKINFOMAP                         m_PackInfo;                     //  Maps LDATINDEX to information known about the pack
     DSADDRVECTOR                        m_SearchItemLookupTable;        //  Value of zero indicates no search item
     DSADDRSET                           m_UpdatedSectors;               //  DSADDRs of updated directory sectors
+    UINT64                              m_UpdateGeneration;             //  Bumped whenever allocations or the MFD change
+    ScanCheckpoint                      m_ScanCheckpoint;               //  Results of background consistency scanning
+    ScanState                           m_ScanState;                    //  Progress of the current consistency scan
+
+    static FixedBlockPool               m_DirectorySectorPool;          //  Backing store for m_DirectoryCache sectors
 
     //  private methods
     Result                      allocateDirectorySector( Activity* const    pActivity,
@@ -415,13 +514,6 @@ private:
                                                      const DSADDR       leadItem0Addr );
     Result                      dropReelTables( Activity* const     pActivity,
                                                 const Word36* const pMainItem1 );
-    void                        dumpMFDDirectory( std::ostream&     stream );
-    void                        dumpMFDDirectoryLeadItem( std::ostream& stream,
-                                                          const DSADDR  leadItem0Addr );
-    void                        dumpMFDDirectoryMainItem( std::ostream&     stream,
-                                                          const FileType    fileType,
-                                                          const int         relativeCycle,
-                                                          const DSADDR      mainItem0Addr );
     Result                      establishLookupEntry( Activity* const       pActivity,
                                                       const Word36* const   pQualifier,
                                                       const Word36* const   pFileName,
@@ -481,6 +573,8 @@ private:
                                                              const DeviceManager::DEVICE_ID  deviceId,
                                                              const PREP_FACTOR               prepFactor,
                                                              const DRWA                      dasTrackWordAddress ) const;
+    Result                      loadCatalogQueryEntries( CatalogQueryList* const    pList,
+                                                         const bool                 includeCycleInfo );
     Result                      loadDirectoryTrackIntoCache( Activity* const    pActivity,
                                                              PackInfo* const    pPackInfo,
                                                              DSADDR             firstDSAddress,
@@ -491,6 +585,10 @@ private:
     Result                      loadFixedPackAllocationTable( Activity* const   pActivity,
                                                               CITPACKINFOMAP    itPackInfo );
     Result                      loadFixedPackAllocationTables( Activity* const  pActivity );
+    Result                      loadMassStorageFileCycleInfo( const DSADDR                      mainItem0Addr,
+                                                              MassStorageFileCycleInfo* const   pInfo );
+    Result                      loadTapeFileCycleInfo( const DSADDR             mainItem0Addr,
+                                                       TapeFileCycleInfo* const pInfo );
     Result                      readDiskLabel( Activity* const                  pActivity,
                                                const DeviceManager::DEVICE_ID   deviceId,
                                                PackInfo** const                 ppPackInfo );
@@ -503,6 +601,22 @@ private:
     Result                      removeLookupEntry( Activity* const      pActivity,
                                                     const Word36* const pQualifier,
                                                     const Word36* const pFileName );
+    void                        scanClaimTracks( const DSADDR       mainItem0Addr,
+                                                 const LDATINDEX    ldatIndex,
+                                                 const TRACK_ID     trackId,
+                                                 const TRACK_COUNT  trackCount );
+    void                        scanClearClaims();
+    COUNT                       scanFileCycle( const DSADDR         leadItem0Addr,
+                                               const DSADDR         mainItem0Addr,
+                                               const FileType       fileType,
+                                               const UINT16         absoluteCycle,
+                                               const Word36* const  pLeadItem0 );
+    COUNT                       scanFileSet( const DSADDR           leadItem0Addr,
+                                             const Word36* const    pSearchEntry );
+    COUNT                       scanLookupEntry( const INDEX lookupIndex );
+    COUNT                       scanPack( const PackInfo* const pPackInfo,
+                                          const COUNT           sectorBudget );
+    void                        scanReport( const std::string& message );
     Result                      setSMBTAllocated( Activity* const       pActivity,
                                                   const LDATINDEX       ldatIndex,
                                                   const TRACK_ID        trackId,
@@ -583,6 +697,7 @@ private:
     }
 
     //  private statics
+    static Word36*              allocateCacheSector();
     static void                 buildSector0ForLargeDisks( Word36* const        pSector0,
                                                            const SECTOR_ID      firstDirectoryTrackAddress,
                                                            const TRACK_COUNT    directoryTracks );
@@ -594,12 +709,26 @@ private:
                                                      const LDATINDEX    ldatIndex );
     static void                 calculateCycleInfo( Word36* const       pLeadItem0,
                                                     const Word36* const pLeadItem1 );
+    static void                 dumpMFDDirectory( std::ostream&         stream,
+                                                  const MFDSnapshot&    snapshot );
+    static void                 dumpMFDDirectoryLeadItem( std::ostream&         stream,
+                                                          const MFDSnapshot&    snapshot,
+                                                          const DSADDR          leadItem0Addr );
+    static void                 dumpMFDDirectoryMainItem( std::ostream&         stream,
+                                                          const MFDSnapshot&    snapshot,
+                                                          const FileType        fileType,
+                                                          const int             relativeCycle,
+                                                          const DSADDR          mainItem0Addr );
     static void                 dumpMFDTrack( std::ostream&         stream,
                                                 const TRACK_ID      directoryTrackId,
                                                 const LDATINDEX     ldatIndex,
                                                 const TRACK_ID      deviceTrackId,
                                                 const Word36* const pData,
                                                 const UINT64        allocMask );
+    static void                 dumpSnapshotSectors( std::ostream&          stream,
+                                                     const MFDSnapshot&     snapshot );
+    static void                 flushDumpChunk( std::ostream&               stream,
+                                                std::stringstream* const    pChunk );
     static void                 getCommonFileCycleInfo( FileCycleInfo* const    pInfo,
                                                         const DSADDR            mainItem0Addr,
                                                         const Word36* const     pMainItem0,
@@ -626,6 +755,7 @@ private:
                                                           const std::string&    packName,
                                                           const WORD_COUNT      mbtLengthInWords,
                                                           const SECTOR_COUNT    dasOffset );
+    static void                 releaseCacheSector( Word36* const pSector );
 
     //  private inline static
     inline static DSADDR        getLinkAddress( const Word36& word36 )        { return word36.getW() & 07777777777ll; }
@@ -683,6 +813,11 @@ public:
     void                        getAssignedNodeIds( DeviceManager::NODE_IDS* const pContainer ) const;
     bool                        getDeviceId( const LDATINDEX                    ldatIndex,
                                              DeviceManager::DEVICE_ID* const    pDeviceId ) const;
+    Result                      getCatalogInfo( CatalogQueryList* const pList,
+                                                const bool              includeCycleInfo );
+    Result                      getCatalogInfo( const SuperString&      qualifierPrefix,
+                                                const bool              includeCycleInfo,
+                                                CatalogQueryList* const pList );
     Result                      getDirectorySector( const DSADDR        directorySectorAddress,
                                                     Word36* const       pBuffer ) const;
     Result                      getFileCycleInfo( const DSADDR          mainItem0Addr,
@@ -690,7 +825,6 @@ public:
     Result                      getFileSetInfo( const std::string&  qualifier,
                                                 const std::string&  filename,
                                                 FileSetInfo* const  pFileSetInfo );
-    Result                      getFileSetInfoList( FileSetInfoList* const  pList );
     Result                      getPackTrackCounts( const PackInfo* const   pPackInfo,
                                                     TRACK_COUNT* const      pAccessible,
                                                     TRACK_COUNT* const      pAvailable ) const;
@@ -701,6 +835,7 @@ public:
     const PackInfo*             getPackInfo( const DeviceManager::DEVICE_ID deviceId ) const;
     bool                        getPrepFactor( const LDATINDEX      ldatIndex,
                                                PREP_FACTOR* const   pPrepFactor ) const;
+    ScanCheckpoint              getScanCheckpoint() const;
     Result                      getSearchItemAddresses( const SuperString&  qualifier,
                                                         const SuperString&  filename,
                                                         DSADDRLIST*         pAddresses ) const;
@@ -727,6 +862,9 @@ public:
     Result                      setBadTrack( Activity* const   pActivity,
                                              const LDATINDEX   ldatIndex,
                                              const TRACK_ID    trackId );
+    bool                        scanStep( const COUNT   sectorBudget,
+                                          COUNT* const  pSectorsExamined );
+    void                        takeDirectorySnapshot( MFDSnapshot* const pSnapshot ) const;
     Result                      updateFileCycle( Activity* const    pActivity,
                                                  const DSADDR       mainItem0Addr,
                                                  const bool         exclusiveUseFlag,
@@ -0,0 +1,549 @@
+//  MFDManager class implementation
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Background consistency scanning of the MFD
+//
+//  A scan pass walks every search item, lead item, main item, and DAD table in the directory,
+//  checking the links between them, and checking the allocations they describe against the
+//  DiskAllocationTable for each pack.  It then compares each fixed pack's SMBT against that pack's
+//  DiskAllocationTable.  Discrepancies are reported to the system log; they are not repaired.
+//
+//  The scan is driven incrementally by MFDScanActivity through scanStep(), which does a limited amount of work
+//  under one acquisition of the lock.  Since the MFD can change between steps, the cross-file check for tracks
+//  claimed by more than one file cycle is abandoned for the remainder of a pass if any update is made during the pass.
+
+
+
+#include    "execlib.h"
+
+
+
+//  private methods
+
+//  scanClaimTracks()
+//
+//  Records the given area as belonging to the given file cycle for the current scan pass,
+//  reporting a discrepancy if any part of the area has already been claimed by some other file cycle.
+void
+MFDManager::scanClaimTracks
+(
+    const DSADDR        mainItem0Addr,
+    const LDATINDEX     ldatIndex,
+    const TRACK_ID      trackId,
+    const TRACK_COUNT   trackCount
+)
+{
+    if ( !m_ScanState.m_ClaimsValid )
+        return;
+
+    CITPACKINFOMAP itpi = m_PackInfo.find( ldatIndex );
+    if ( itpi == m_PackInfo.end() )
+        return;
+
+    DiskAllocationTable*& pClaims = m_ScanState.m_Claims[ldatIndex];
+    if ( pClaims == 0 )
+        pClaims = new DiskAllocationTable( itpi->second->m_TotalTracks );
+
+    if ( pClaims->getAllocatedTrackCount( trackId, trackCount ) != 0 )
+    {
+        std::stringstream strm;
+        strm << "Main item 0" << std::oct << mainItem0Addr
+            << " claims LDAT 0" << std::oct << ldatIndex
+            << " tracks 0" << std::oct << trackId
+            << " for 0" << std::oct << trackCount
+            << " which are already claimed by another file cycle";
+        scanReport( strm.str() );
+        return;
+    }
+
+    pClaims->allocate( trackId, trackCount );
+}
+
+
+//  scanClearClaims()
+//
+//  Discards the track claims for the current scan pass
+void
+MFDManager::scanClearClaims()
+{
+    for ( ITSCANCLAIMS itsc = m_ScanState.m_Claims.begin(); itsc != m_ScanState.m_Claims.end(); ++itsc )
+        delete itsc->second;
+    m_ScanState.m_Claims.clear();
+}
+
+
+//  scanFileCycle()
+//
+//  Checks the main items (and DAD tables or reel tables) for one file cycle.
+//  Call under lock().
+//
+//  Returns:
+//      number of directory sectors examined
+COUNT
+MFDManager::scanFileCycle
+(
+    const DSADDR            leadItem0Addr,
+    const DSADDR            mainItem0Addr,
+    const FileType          fileType,
+    const UINT16            absoluteCycle,
+    const Word36* const     pLeadItem0
+)
+{
+    COUNT sectors = 0;
+    std::stringstream idStrm;
+    idStrm << "Main item 0" << std::oct << mainItem0Addr << " ";
+    const std::string id = idStrm.str();
+
+    Result result;
+    Word36* pMainItem0 = 0;
+    if ( !stageDirectorySector( mainItem0Addr, false, &pMainItem0, &result ) )
+    {
+        scanReport( id + "is not in the directory" );
+        return sectors;
+    }
+    ++sectors;
+
+    if ( getLinkAddress( pMainItem0[013] ) != leadItem0Addr )
+        scanReport( id + "does not link back to its lead item" );
+
+    if ( (pMainItem0[1].getW() != pLeadItem0[1].getW()) || (pMainItem0[2].getW() != pLeadItem0[2].getW())
+        || (pMainItem0[3].getW() != pLeadItem0[3].getW()) || (pMainItem0[4].getW() != pLeadItem0[4].getW()) )
+        scanReport( id + "qualifier or filename does not match its lead item" );
+
+    if ( pMainItem0[021].getT3() != absoluteCycle )
+    {
+        std::stringstream strm;
+        strm << id << "absolute cycle " << std::dec << pMainItem0[021].getT3()
+            << " does not match lead item cycle " << absoluteCycle;
+        scanReport( strm.str() );
+    }
+
+    DSADDR mainItem1Addr = getLinkAddress( pMainItem0[015] );
+    if ( mainItem1Addr != 0 )
+    {
+        Word36* pMainItem1 = 0;
+        if ( !stageDirectorySector( mainItem1Addr, false, &pMainItem1, &result ) )
+            scanReport( id + "links to a main item 1 which is not in the directory" );
+        ++sectors;
+    }
+
+    if ( fileType == FILETYPE_TAPE )
+    {
+        DSADDR reelTableAddr = getLinkAddress( pMainItem0[0] );
+        while ( reelTableAddr != 0 )
+        {
+            Word36* pReelTable = 0;
+            if ( !stageDirectorySector( reelTableAddr, false, &pReelTable, &result ) )
+            {
+                scanReport( id + "links to a reel table which is not in the directory" );
+                break;
+            }
+
+            ++sectors;
+            reelTableAddr = getLinkAddress( pReelTable[0] );
+        }
+
+        return sectors;
+    }
+
+    //  Mass storage - walk the DAD tables, checking the links and the continuity of file-relative addresses.
+    //  Removable packs are not tracked by DiskAllocationTables, so we don't check allocations for them.
+    const bool checkAllocations = (fileType == FILETYPE_MASS_STORAGE);
+    CITFILEALLOCATIONDICTIONARY itfad = m_FileAllocationDictionary.find( mainItem0Addr );
+    const bool assigned = (itfad != m_FileAllocationDictionary.end());
+
+    DSADDR previousAddr = mainItem0Addr;
+    WORD_ID expectedFirstWord = 0;
+    DSADDR dadAddr = getLinkAddress( pMainItem0[0] );
+    while ( dadAddr != 0 )
+    {
+        Word36* pDAD = 0;
+        if ( !stageDirectorySector( dadAddr, false, &pDAD, &result ) )
+        {
+            scanReport( id + "links to a DAD table which is not in the directory" );
+            break;
+        }
+        ++sectors;
+
+        std::stringstream dadStrm;
+        dadStrm << id << "DAD 0" << std::oct << dadAddr << " ";
+        if ( getLinkAddress( pDAD[1] ) != previousAddr )
+            scanReport( dadStrm.str() + "does not link back to its predecessor" );
+
+        WORD_ID fileWord = pDAD[2].getW();
+        WORD_ID limitWord = pDAD[3].getW();
+        if ( fileWord != expectedFirstWord )
+            scanReport( dadStrm.str() + "does not begin where the previous DAD ended" );
+
+        //  For assigned files, the FAT is authoritative and the DADs may lag behind it.
+        //  Otherwise, the DAD entries must describe allocated tracks.
+        const Word36* pEntry = pDAD + 4;
+        for ( INDEX ex = 0; (ex < 8) && (fileWord < limitWord); ++ex )
+        {
+            LDATINDEX ldatIndex = pEntry[2].getH2();
+            if ( checkAllocations && !assigned && (ldatIndex != 0400000) )
+            {
+                TRACK_ID deviceTrackId = pEntry[0].getW() / 1792;
+                TRACK_COUNT trackCount = pEntry[1].getW() / 1792;
+
+                CITPACKINFOMAP itpi = m_PackInfo.find( ldatIndex );
+                if ( itpi == m_PackInfo.end() )
+                    scanReport( dadStrm.str() + "refers to an unknown LDAT index" );
+                else if ( itpi->second->m_DiskAllocationTable.getAllocatedTrackCount( deviceTrackId, trackCount ) != trackCount )
+                {
+                    std::stringstream strm;
+                    strm << dadStrm.str() << "refers to unallocated tracks on LDAT 0" << std::oct << ldatIndex
+                        << " tracks 0" << std::oct << deviceTrackId << " for 0" << std::oct << trackCount;
+                    scanReport( strm.str() );
+                }
+                else
+                    scanClaimTracks( mainItem0Addr, ldatIndex, deviceTrackId, trackCount );
+            }
+
+            fileWord += pEntry[1].getW();
+            if ( pEntry[2].getH1() & 04 )
+                break;
+            pEntry += 3;
+        }
+
+        expectedFirstWord = limitWord;
+        previousAddr = dadAddr;
+        dadAddr = getLinkAddress( pDAD[0] );
+    }
+
+    if ( checkAllocations && assigned && !itfad->second->isEmpty() )
+    {
+        FileAllocationTable::FAENTRIES entries;
+        itfad->second->getFileAllocationEntries( 0, itfad->second->getHighestTrackAssigned() + 1, &entries );
+        for ( FileAllocationTable::CITFAENTRIES itfae = entries.begin(); itfae != entries.end(); ++itfae )
+        {
+            const FileAllocationTable::FileAllocationEntry& fae = itfae->second;
+            if ( fae.m_LDATIndex == 0 )
+                continue;
+
+            CITPACKINFOMAP itpi = m_PackInfo.find( fae.m_LDATIndex );
+            if ( itpi == m_PackInfo.end() )
+                scanReport( id + "file allocation table refers to an unknown LDAT index" );
+            else if ( itpi->second->m_DiskAllocationTable.getAllocatedTrackCount( fae.m_DeviceTrackId, fae.m_TrackCount ) != fae.m_TrackCount )
+            {
+                std::stringstream strm;
+                strm << id << "file allocation table refers to unallocated tracks on LDAT 0" << std::oct << fae.m_LDATIndex
+                    << " tracks 0" << std::oct << fae.m_DeviceTrackId << " for 0" << std::oct << fae.m_TrackCount;
+                scanReport( strm.str() );
+            }
+            else
+                scanClaimTracks( mainItem0Addr, fae.m_LDATIndex, fae.m_DeviceTrackId, fae.m_TrackCount );
+        }
+    }
+
+    return sectors;
+}
+
+
+//  scanFileSet()
+//
+//  Checks the lead items for a file set, and all of the file cycles in the set.
+//  Call under lock().
+//
+//  Returns:
+//      number of directory sectors examined
+COUNT
+MFDManager::scanFileSet
+(
+    const DSADDR            leadItem0Addr,
+    const Word36* const     pSearchEntry
+)
+{
+    COUNT sectors = 0;
+    std::stringstream idStrm;
+    idStrm << "Lead item 0" << std::oct << leadItem0Addr << " ";
+    const std::string id = idStrm.str();
+
+    Result result;
+    DSADDR leadItem1Addr = 0;
+    Word36* pLeadItem0 = 0;
+    Word36* pLeadItem1 = 0;
+    if ( !stageLeadItems( leadItem0Addr, &leadItem1Addr, &pLeadItem0, &pLeadItem1, &result ) )
+    {
+        scanReport( id + "(or its sector 1) is not in the directory" );
+        return sectors;
+    }
+    sectors += pLeadItem1 ? 2 : 1;
+
+    if ( (pLeadItem0[1].getW() != pSearchEntry[0].getW()) || (pLeadItem0[2].getW() != pSearchEntry[1].getW())
+        || (pLeadItem0[3].getW() != pSearchEntry[2].getW()) || (pLeadItem0[4].getW() != pSearchEntry[3].getW()) )
+        scanReport( id + "qualifier or filename does not match its search item" );
+
+    const FileType fileType = getFileType( pLeadItem0[011].getS1() );
+    const UINT16 currentRange = pLeadItem0[011].getQ3();
+    UINT16 thisAbsolute = pLeadItem0[011].getQ4();
+
+    const Word36* pEntry = &pLeadItem0[013];
+    for ( INDEX ex = 0; ex < currentRange; ++ex )
+    {
+        if ( ex == 17 )
+        {
+            if ( pLeadItem1 == 0 )
+            {
+                scanReport( id + "current range requires a sector 1, which does not exist" );
+                break;
+            }
+            pEntry = &pLeadItem1[01];
+        }
+
+        DSADDR mainItem0Addr = getLinkAddress( pEntry[0] );
+        if ( mainItem0Addr != 0 )
+            sectors += scanFileCycle( leadItem0Addr, mainItem0Addr, fileType, thisAbsolute, pLeadItem0 );
+
+        --thisAbsolute;
+        if ( thisAbsolute == 0 )
+            thisAbsolute = 999;
+        ++pEntry;
+    }
+
+    return sectors;
+}
+
+
+//  scanLookupEntry()
+//
+//  Checks the chain of search items hanging from one entry in the search item lookup table,
+//  and every file set referenced therefrom.
+//  Call under lock().
+//
+//  Returns:
+//      number of directory sectors examined
+COUNT
+MFDManager::scanLookupEntry
+(
+    const INDEX         lookupIndex
+)
+{
+    COUNT sectors = 0;
+    Result result;
+    DSADDR searchItemAddr = m_SearchItemLookupTable[lookupIndex];
+    while ( searchItemAddr != 0 )
+    {
+        Word36* pSearchItem = 0;
+        if ( !stageDirectorySector( searchItemAddr, &pSearchItem, &result ) )
+        {
+            std::stringstream strm;
+            strm << "Search item 0" << std::oct << searchItemAddr << " is not in the directory";
+            scanReport( strm.str() );
+            break;
+        }
+        ++sectors;
+
+        const Word36* pSearchEntry = pSearchItem + 1;
+        for ( INDEX ex = 0; ex < 5; ++ex )
+        {
+            DSADDR leadItem0Addr = getLinkAddress( pSearchEntry[4] );
+            if ( leadItem0Addr != 0 )
+            {
+                if ( getLookupTableHashIndex( &pSearchEntry[0], &pSearchEntry[2] ) != lookupIndex )
+                {
+                    std::stringstream strm;
+                    strm << "Search item 0" << std::oct << searchItemAddr << " entry " << std::dec << ex
+                        << " is chained from the wrong lookup table entry";
+                    scanReport( strm.str() );
+                }
+
+                sectors += scanFileSet( leadItem0Addr, pSearchEntry );
+            }
+
+            pSearchEntry += 5;
+        }
+
+        searchItemAddr = getLinkAddress( pSearchItem[0] );
+    }
+
+    return sectors;
+}
+
+
+//  scanPack()
+//
+//  Compares (part of) the SMBT for the given fixed pack against the pack's DiskAllocationTable,
+//  picking up where the previous call left off.  m_ScanState.m_SMBTWordOffset is updated, and when the pack
+//  is finished, m_ScanState.m_LDATIndex is advanced past it.
+//  Call under lock().
+//
+//  Returns:
+//      number of directory sectors examined
+COUNT
+MFDManager::scanPack
+(
+    const PackInfo* const   pPackInfo,
+    const COUNT             sectorBudget
+)
+{
+    COUNT sectors = 0;
+    Result result;
+
+    //  The first SMBT word is a control word; each subsequent word covers 32 tracks (in its high-order 32 bits).
+    //  We check the same words as loadFixedPackAllocationTable() loads.
+    const WORD_COUNT smbtWords = (pPackInfo->m_SMBTWords > 2) ? pPackInfo->m_SMBTWords - 2 : 0;
+    DSADDR firstSMBTAddr = (pPackInfo->m_LDATIndex << 18) | static_cast<COUNT32>(pPackInfo->m_S0S1HMBTPadWords / WORDS_PER_SECTOR);
+    while ( (m_ScanState.m_SMBTWordOffset < smbtWords) && (sectors < sectorBudget) )
+    {
+        WORD_COUNT smbtWordIndex = m_ScanState.m_SMBTWordOffset + 1;
+        DSADDR smbtAddr = firstSMBTAddr + static_cast<DSADDR>(smbtWordIndex / WORDS_PER_SECTOR);
+        Word36* pSMBT = 0;
+        if ( !stageDirectorySector( smbtAddr, &pSMBT, &result ) )
+        {
+            std::stringstream strm;
+            strm << "SMBT sector 0" << std::oct << smbtAddr << " for LDAT 0" << std::oct << pPackInfo->m_LDATIndex
+                << " is not in the directory";
+            scanReport( strm.str() );
+            m_ScanState.m_SMBTWordOffset = smbtWords;
+            break;
+        }
+        ++sectors;
+
+        for ( INDEX wx = smbtWordIndex % WORDS_PER_SECTOR;
+             (wx < WORDS_PER_SECTOR) && (m_ScanState.m_SMBTWordOffset < smbtWords);
+             ++wx, ++m_ScanState.m_SMBTWordOffset )
+        {
+            TRACK_ID firstTrackId = m_ScanState.m_SMBTWordOffset * 32;
+            UINT32 allocBits = static_cast<UINT32>(pSMBT[wx].getW() >> 4);
+            UINT32 mask = 0x80000000;
+            for ( TRACK_ID trackId = firstTrackId; (trackId < firstTrackId + 32) && (trackId < pPackInfo->m_TotalTracks); ++trackId )
+            {
+                bool smbtAllocated = (allocBits & mask) != 0;
+                bool tableAllocated = pPackInfo->m_DiskAllocationTable.getAllocatedTrackCount( trackId, 1 ) != 0;
+                if ( smbtAllocated != tableAllocated )
+                {
+                    std::stringstream strm;
+                    strm << "LDAT 0" << std::oct << pPackInfo->m_LDATIndex
+                        << " track 0" << std::oct << trackId
+                        << " is " << (smbtAllocated ? "allocated" : "unallocated") << " in the SMBT but "
+                        << (tableAllocated ? "allocated" : "unallocated") << " in the allocation table";
+                    scanReport( strm.str() );
+                }
+                mask >>= 1;
+            }
+        }
+    }
+
+    if ( m_ScanState.m_SMBTWordOffset >= smbtWords )
+    {
+        m_ScanState.m_LDATIndex = pPackInfo->m_LDATIndex + 1;
+        m_ScanState.m_SMBTWordOffset = 0;
+    }
+
+    return sectors;
+}
+
+
+//  scanReport()
+//
+//  Reports a consistency scan discrepancy
+void
+MFDManager::scanReport
+(
+    const std::string&      message
+)
+{
+    ++m_ScanState.m_Discrepancies;
+    SystemLog::write( "MFDManager scan: " + message );
+}
+
+
+
+//  public methods
+
+//  scanStep()
+//
+//  Performs one increment of the background consistency scan, under a single acquisition of the lock.
+//  Work continues until (approximately) sectorBudget directory sectors have been examined, or the pass completes,
+//  whichever comes first.  A new pass is started if none is in progress.
+//
+//  Parameters:
+//      sectorBudget:       approximate number of directory sectors to be examined
+//      pSectorsExamined:   where we store the number actually examined
+//
+//  Returns:
+//      true if a pass was completed by this step
+bool
+MFDManager::scanStep
+(
+    const COUNT         sectorBudget,
+    COUNT* const        pSectorsExamined
+)
+{
+    COUNT sectors = 0;
+    bool passComplete = false;
+    lock();
+
+    if ( m_ScanState.m_Phase == SCANPHASE_IDLE )
+    {
+        scanClearClaims();
+        m_ScanState.m_Phase = SCANPHASE_FILE_SETS;
+        m_ScanState.m_LookupIndex = 0;
+        m_ScanState.m_LDATIndex = 0;
+        m_ScanState.m_SMBTWordOffset = 0;
+        m_ScanState.m_UpdateGeneration = m_UpdateGeneration;
+        m_ScanState.m_ClaimsValid = true;
+        m_ScanState.m_Discrepancies = 0;
+    }
+
+    //  If anything changed since the pass started, claims made so far may be stale.
+    if ( m_ScanState.m_ClaimsValid && (m_ScanState.m_UpdateGeneration != m_UpdateGeneration) )
+    {
+        scanClearClaims();
+        m_ScanState.m_ClaimsValid = false;
+    }
+
+    while ( !passComplete && (sectors < sectorBudget) )
+    {
+        if ( m_ScanState.m_Phase == SCANPHASE_FILE_SETS )
+        {
+            if ( m_ScanState.m_LookupIndex < m_SearchItemLookupTable.size() )
+                sectors += scanLookupEntry( m_ScanState.m_LookupIndex++ ) + 1;
+            else
+                m_ScanState.m_Phase = SCANPHASE_PACKS;
+            continue;
+        }
+
+        //  Find the next fixed pack, at or beyond the one we're working on
+        CITPACKINFOMAP itpi = m_PackInfo.lower_bound( m_ScanState.m_LDATIndex );
+        while ( (itpi != m_PackInfo.end()) && !itpi->second->m_InFixedPool )
+            ++itpi;
+
+        if ( itpi == m_PackInfo.end() )
+        {
+            EXECTIME now = m_pExec->getExecTime();
+            ++m_ScanCheckpoint.m_PassesCompleted;
+            m_ScanCheckpoint.m_LastPassCompleted = now;
+            m_ScanCheckpoint.m_LastPassDiscrepancies = m_ScanState.m_Discrepancies;
+            if ( (m_ScanState.m_Discrepancies == 0) && m_ScanState.m_ClaimsValid )
+                m_ScanCheckpoint.m_LastCleanPass = now;
+
+            if ( m_ScanState.m_Discrepancies > 0 )
+            {
+                std::stringstream strm;
+                strm << "MFD SCAN FOUND " << std::dec << m_ScanState.m_Discrepancies << " DISCREPANCIES - SEE LOG";
+                m_pConsoleManager->postReadOnlyMessage( strm.str(), 0 );
+            }
+
+            scanClearClaims();
+            m_ScanState.m_Phase = SCANPHASE_IDLE;
+            passComplete = true;
+            continue;
+        }
+
+        if ( itpi->first != m_ScanState.m_LDATIndex )
+        {
+            m_ScanState.m_LDATIndex = itpi->first;
+            m_ScanState.m_SMBTWordOffset = 0;
+        }
+
+        sectors += scanPack( itpi->second, sectorBudget - sectors ) + 1;
+    }
+
+    m_ScanCheckpoint.m_SectorsExamined += sectors;
+    unlock();
+
+    *pSectorsExamined = sectors;
+    return passComplete;
+}
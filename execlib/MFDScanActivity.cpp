@@ -0,0 +1,90 @@
+//  MFDScanActivity.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Background MFD consistency scanning
+
+
+
+#include    "execlib.h"
+
+
+
+//  Each step runs for this many milliseconds worth of the configured rate, then sleeps for the same period
+#define     STEP_MSECS      100
+
+
+
+//  private / protected statics
+
+//  handleScan()
+//
+//  Scans one step's worth of sectors, then waits for STEP_MSECS - or, if that finished a pass,
+//  for the configured interval between passes.
+//  Configuration is re-read for each step, so that the rate may be changed while we are running.
+void
+MFDScanActivity::handleScan
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    MFDScanActivity* pActivity = dynamic_cast<MFDScanActivity*>( pObject );
+    const Configuration& config = pActivity->m_pExec->getConfiguration();
+    COUNT64 rate = config.getIntegerValue( "MFDSCANRATE" );
+    if ( rate == 0 )
+    {
+        pActivity->setDelay( 1000 );
+        return;
+    }
+
+    COUNT budget = static_cast<COUNT>(rate * STEP_MSECS / 1000);
+    if ( budget == 0 )
+        budget = 1;
+
+    COUNT sectors = 0;
+    bool passComplete = pActivity->m_pMFDManager->scanStep( budget, &sectors );
+    pActivity->m_SectorsExamined += sectors;
+    if ( passComplete )
+    {
+        ++pActivity->m_PassesCompleted;
+        COUNT64 intervalMSecs = config.getIntegerValue( "MFDSCANINTVL" ) * 60 * 1000;
+        if ( intervalMSecs > 0x7FFFFFFF )
+            intervalMSecs = 0x7FFFFFFF;
+        pActivity->setDelay( static_cast<COUNT32>(intervalMSecs) );
+    }
+}
+
+
+
+// constructors / destructors
+
+MFDScanActivity::MFDScanActivity
+(
+    Exec* const         pExec
+)
+:IntrinsicActivity( pExec, "MFDScanActivity", pExec->getRunInfo() ),
+m_pMFDManager( dynamic_cast<MFDManager*>( pExec->getManager( Exec::MID_MFD_MANAGER ) ) ),
+m_PassesCompleted( 0 ),
+m_SectorsExamined( 0 )
+{
+    establishStateEntry( SCAN, handleScan, SCAN, STEP_MSECS );
+}
+
+
+
+//  public methods
+
+void
+MFDScanActivity::dump
+(
+    std::ostream&       stream,
+    const std::string&  prefix,
+    const DUMPBITS      dumpBits
+)
+{
+    stream << prefix << "MFDScanActivity"
+        << "  Passes=" << std::dec << m_PassesCompleted
+        << "  Sectors=" << m_SectorsExamined
+        << std::endl;
+    IntrinsicActivity::dump( stream, prefix + "  ", dumpBits );
+}
+
@@ -0,0 +1,46 @@
+//  MFDScanActivity.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Background MFD consistency scanning.
+//  Drives MFDManager::scanStep() at a configured rate (MFDSCANRATE directory sectors per second),
+//  starting a new pass every MFDSCANINTVL minutes.
+
+
+
+#ifndef     EXECLIB_MFD_SCAN_ACTIVITY_H
+#define     EXECLIB_MFD_SCAN_ACTIVITY_H
+
+
+
+#include    "IntrinsicActivity.h"
+#include    "MFDManager.h"
+
+
+
+class   MFDScanActivity : public IntrinsicActivity
+{
+private:
+    enum LocalState
+    {
+        SCAN                    = m_InitialState,
+    };
+
+    MFDManager* const           m_pMFDManager;
+    COUNT64                     m_PassesCompleted;      //  Passes completed by this activity
+    COUNT64                     m_SectorsExamined;      //  Sectors examined by this activity
+
+    //  IntrinsicActivity interface
+    void                        dump( std::ostream&         stream,
+                                      const std::string&    prefix,
+                                      const DUMPBITS        dumpBits );
+
+    static void                 handleScan( IntrinsicActivity* const pObject );
+
+public:
+    MFDScanActivity( Exec* const pExec );
+};
+
+
+
+#endif
+
@@ -0,0 +1,159 @@
+//  MFDSnapshot implementation
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "execlib.h"
+
+
+
+#define     PACKED_SECTOR_BYTES     (WORDS_PER_SECTOR * 9 / 2)
+
+
+
+//  private statics
+
+//  writeUINT32()
+void
+MFDSnapshot::writeUINT32
+(
+    std::ostream&       stream,
+    const UINT32        value
+)
+{
+    BYTE buffer[4];
+    miscPutBigEndian32( buffer, value );
+    stream.write( reinterpret_cast<const char*>( buffer ), sizeof( buffer ) );
+}
+
+
+//  writeUINT64()
+void
+MFDSnapshot::writeUINT64
+(
+    std::ostream&       stream,
+    const UINT64        value
+)
+{
+    BYTE buffer[8];
+    miscPutBigEndian64( buffer, value );
+    stream.write( reinterpret_cast<const char*>( buffer ), sizeof( buffer ) );
+}
+
+
+
+//  public methods
+
+//  addSector()
+//
+//  Adds a copy of the given sector to the snapshot.
+//  Sectors must be added in ascending DSADDR order (as they come out of the directory cache);
+//  returns false (and ignores the sector) otherwise.
+bool
+MFDSnapshot::addSector
+(
+    const DSADDR            address,
+    const Word36* const     pSector
+)
+{
+    if ( !m_SectorAddresses.empty() && (address <= m_SectorAddresses.back()) )
+        return false;
+
+    m_SectorAddresses.push_back( address );
+    m_SectorData.insert( m_SectorData.end(), pSector, pSector + WORDS_PER_SECTOR );
+    return true;
+}
+
+
+//  clear()
+void
+MFDSnapshot::clear()
+{
+    m_SearchItemLookupTable.clear();
+    m_DirectoryTrackIdMap.clear();
+    m_UpdatedSectors.clear();
+    m_SectorAddresses.clear();
+    m_SectorData.clear();
+}
+
+
+//  getSector()
+//
+//  Retrieves a pointer to the snapshot copy of the indicated sector, or 0 if it is not in the snapshot.
+const Word36*
+MFDSnapshot::getSector
+(
+    const DSADDR        address
+) const
+{
+    INDEX lower = 0;
+    INDEX upper = m_SectorAddresses.size();
+    while ( lower < upper )
+    {
+        INDEX middle = lower + (upper - lower) / 2;
+        if ( m_SectorAddresses[middle] < address )
+            lower = middle + 1;
+        else
+            upper = middle;
+    }
+
+    if ( (lower < m_SectorAddresses.size()) && (m_SectorAddresses[lower] == address) )
+        return getSectorData( lower );
+    return 0;
+}
+
+
+//  reserve()
+//
+//  Preallocates space for the indicated number of sectors
+void
+MFDSnapshot::reserve
+(
+    const COUNT         sectorCount
+)
+{
+    m_SectorAddresses.reserve( sectorCount );
+    m_SectorData.reserve( sectorCount * WORDS_PER_SECTOR );
+}
+
+
+//  write()
+//
+//  Writes the snapshot to the given stream in the binary form described in the header file.
+//  Returns false if the stream reports an error.
+bool
+MFDSnapshot::write
+(
+    std::ostream&       stream
+) const
+{
+    writeUINT32( stream, FILE_IDENTIFIER );
+    writeUINT32( stream, FILE_VERSION );
+
+    writeUINT32( stream, static_cast<UINT32>( m_SearchItemLookupTable.size() ) );
+    for ( INDEX ex = 0; ex < m_SearchItemLookupTable.size(); ++ex )
+        writeUINT32( stream, m_SearchItemLookupTable[ex] );
+
+    writeUINT32( stream, static_cast<UINT32>( m_DirectoryTrackIdMap.size() ) );
+    for ( CITTRACKIDMAP itt = m_DirectoryTrackIdMap.begin(); itt != m_DirectoryTrackIdMap.end(); ++itt )
+    {
+        writeUINT64( stream, itt->first );
+        writeUINT64( stream, itt->second );
+    }
+
+    writeUINT32( stream, static_cast<UINT32>( m_UpdatedSectors.size() ) );
+    for ( CITDSADDRSET itus = m_UpdatedSectors.begin(); itus != m_UpdatedSectors.end(); ++itus )
+        writeUINT32( stream, *itus );
+
+    writeUINT32( stream, static_cast<UINT32>( m_SectorAddresses.size() ) );
+    BYTE packed[PACKED_SECTOR_BYTES];
+    for ( INDEX sx = 0; (sx < m_SectorAddresses.size()) && stream.good(); ++sx )
+    {
+        writeUINT32( stream, m_SectorAddresses[sx] );
+        miscWord36Pack( packed, getSectorData( sx ), WORDS_PER_SECTOR );
+        stream.write( reinterpret_cast<const char*>( packed ), sizeof( packed ) );
+    }
+
+    writeUINT32( stream, FILE_IDENTIFIER );
+    return stream.good();
+}
@@ -0,0 +1,65 @@
+//  MFDSnapshot.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Point-in-time copy of the MFD directory cache and its indices.
+//  MFDManager fills one of these under a short lock, after which it can be formatted, exported,
+//  or examined at leisure without holding up facilities requests.
+//
+//  The binary form written by write() is intended for offline analysis tools:
+//      UINT32      identifier ('MFDS')
+//      UINT32      version
+//      UINT32      n, followed by n UINT32 search item lookup table entries (DSADDRs)
+//      UINT32      n, followed by n pairs of UINT64 directory-relative track ID, UINT64 device-relative block ID
+//      UINT32      n, followed by n UINT32 DSADDRs of sectors updated but not yet written
+//      UINT32      n, followed by n sectors, each as a UINT32 DSADDR and 126 bytes of packed Word36 data
+//      UINT32      identifier again, as a trailer
+//  All integers are big-endian.
+
+
+
+#ifndef     EXECLIB_MFD_SNAPSHOT_H
+#define     EXECLIB_MFD_SNAPSHOT_H
+
+
+
+class   MFDSnapshot
+{
+public:
+    typedef     std::map<TRACK_ID, BLOCK_ID>        TRACKIDMAP;
+    typedef     TRACKIDMAP::const_iterator          CITTRACKIDMAP;
+
+    typedef     std::set<DSADDR>                    DSADDRSET;
+    typedef     DSADDRSET::const_iterator           CITDSADDRSET;
+
+    static const UINT32             FILE_IDENTIFIER = 0x4D464453;   //  'MFDS'
+    static const UINT32             FILE_VERSION = 1;
+
+    std::vector<DSADDR>             m_SearchItemLookupTable;
+    TRACKIDMAP                      m_DirectoryTrackIdMap;
+    DSADDRSET                       m_UpdatedSectors;
+
+private:
+    std::vector<DSADDR>             m_SectorAddresses;      //  In ascending order
+    std::vector<Word36>             m_SectorData;           //  WORDS_PER_SECTOR words for each entry in m_SectorAddresses
+
+    static void                     writeUINT32( std::ostream&  stream,
+                                                 const UINT32   value );
+    static void                     writeUINT64( std::ostream&  stream,
+                                                 const UINT64   value );
+
+public:
+    bool                            addSector( const DSADDR         address,
+                                               const Word36* const  pSector );
+    void                            clear();
+    const Word36*                   getSector( const DSADDR address ) const;
+    void                            reserve( const COUNT sectorCount );
+    bool                            write( std::ostream& stream ) const;
+
+    inline COUNT                    getSectorCount() const                  { return m_SectorAddresses.size(); }
+    inline DSADDR                   getSectorAddress( const INDEX sx ) const{ return m_SectorAddresses[sx]; }
+    inline const Word36*            getSectorData( const INDEX sx ) const   { return &m_SectorData[sx * WORDS_PER_SECTOR]; }
+};
+
+
+
+#endif
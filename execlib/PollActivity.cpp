@@ -27,17 +27,6 @@ PollActivity::newDayActions() const
 }
 
 
-//  oneSecondActions()
-//
-//  Runs every second - calls Exec routine which processes the RunInfo list.
-//  Among other things, this will do FIN processing, bring runs out of backlog, etc
-void
-PollActivity::oneSecondActions()
-{
-    m_pExec->pollUserRunInfoObjects( this );
-}
-
-
 //  sixMinuteActions()
 //
 //  Runs every 6 minutes.
@@ -86,55 +75,89 @@ PollActivity::sixSecondActions() const
 }
 
 
-//  worker()
+
+//	private / protected statics
+
+//  handleCheckTime()
+//
+//  Time to see whether anything needs to happen - if so, we go straight to the state which does it.
+//  Otherwise we remain here, and check again after the default delay.
 void
-PollActivity::worker()
+PollActivity::handleCheckTime
+(
+    IntrinsicActivity* const    pObject
+)
 {
-    while ( !isWorkerTerminating() )
-    {
-        //  Time to see whether anything needs to happen.
-        //  If the current time indicates a day-of-week different than what's in m_PreviousMidnightDayOfWeek,
-        //  it's time to do midnight processing.
-        EXECTIME currentExecTime = m_pExec->getExecTime();
-        SystemTime* pCurrentExecTimeComp = SystemTime::createFromMicroseconds( currentExecTime );
-        if ( pCurrentExecTimeComp->getDayOfWeek() != m_PreviousMidnightDayOfWeek )
-        {
-            newDayActions();
-            m_PreviousMidnightDayOfWeek = pCurrentExecTimeComp->getDayOfWeek();
-            delete pCurrentExecTimeComp;
-            pCurrentExecTimeComp = 0;
-            continue;
-        }
-        delete pCurrentExecTimeComp;
-        pCurrentExecTimeComp = 0;
-
-        //  If the current time is 6 minutes past the previous 6-minute time-stamp,
-        //  set state to do 6-minute stuff (which will subsequently trigger 6-second stuff).
-        if ( (currentExecTime - m_Previous6Minute) >= (360 * SystemTime::MICROSECONDS_PER_SECOND) )
-        {
-            sixMinuteActions();
-            m_Previous6Minute = currentExecTime;
-            continue;
-        }
-
-        //  Similarly for 6-second stuff...
-        if ( (currentExecTime - m_Previous6Second) >= (6 * SystemTime::MICROSECONDS_PER_SECOND) )
-        {
-            sixSecondActions();
-            m_Previous6Second = currentExecTime;
-            continue;
-        }
-
-        //  Finally for 1-second stuff...
-        if ( (currentExecTime - m_Previous1Second ) >= (1 * SystemTime::MICROSECONDS_PER_SECOND) )
-        {
-            oneSecondActions();
-            m_Previous1Second = currentExecTime;
-            continue;
-        }
-
-        miscSleep( 200 );
-    }
+    PollActivity* pActivity = dynamic_cast<PollActivity*>( pObject );
+
+    //  If the current time indicates a day-of-week different than what's in m_PreviousMidnightDayOfWeek,
+    //  it's time to do midnight processing.
+    EXECTIME currentExecTime = pActivity->m_pExec->getExecTime();
+    SystemTime* pCurrentExecTimeComp = SystemTime::createFromMicroseconds( currentExecTime );
+    UINT32 dayOfWeek = pCurrentExecTimeComp->getDayOfWeek();
+    delete pCurrentExecTimeComp;
+    pCurrentExecTimeComp = 0;
+
+    if ( dayOfWeek != pActivity->m_PreviousMidnightDayOfWeek )
+        pActivity->setNextState( NEW_DAY_ACTIONS );
+
+    //  If the current time is 6 minutes past the previous 6-minute time-stamp, do 6-minute stuff.
+    else if ( (currentExecTime - pActivity->m_Previous6Minute) >= (360 * SystemTime::MICROSECONDS_PER_SECOND) )
+        pActivity->setNextState( SIX_MINUTE_ACTIONS );
+
+    //  Similarly for 6-second stuff...
+    else if ( (currentExecTime - pActivity->m_Previous6Second) >= (6 * SystemTime::MICROSECONDS_PER_SECOND) )
+        pActivity->setNextState( SIX_SECOND_ACTIONS );
+
+    else
+        return;
+
+    pActivity->setDelay( 0 );
+}
+
+
+//  handleNewDay()
+void
+PollActivity::handleNewDay
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    PollActivity* pActivity = dynamic_cast<PollActivity*>( pObject );
+    pActivity->newDayActions();
+
+    SystemTime* pSystemTime = SystemTime::createFromMicroseconds( pActivity->m_pExec->getExecTime() );
+    pActivity->m_PreviousMidnightDayOfWeek = pSystemTime->getDayOfWeek();
+    delete pSystemTime;
+    pSystemTime = 0;
+}
+
+
+//  handleSixMinute()
+void
+PollActivity::handleSixMinute
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    PollActivity* pActivity = dynamic_cast<PollActivity*>( pObject );
+    EXECTIME currentExecTime = pActivity->m_pExec->getExecTime();
+    pActivity->sixMinuteActions();
+    pActivity->m_Previous6Minute = currentExecTime;
+}
+
+
+//  handleSixSecond()
+void
+PollActivity::handleSixSecond
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    PollActivity* pActivity = dynamic_cast<PollActivity*>( pObject );
+    EXECTIME currentExecTime = pActivity->m_pExec->getExecTime();
+    pActivity->sixSecondActions();
+    pActivity->m_Previous6Second = currentExecTime;
 }
 
 
@@ -159,7 +182,11 @@ PollActivity::PollActivity
     //  Similarly for previous 6 second action, and 6 minute action.
     m_Previous6Minute = execTime;
     m_Previous6Second = execTime;
-    m_Previous1Second = execTime;
+
+    establishStateEntry( CHECK_TIME, handleCheckTime, CHECK_TIME, 200 );
+    establishStateEntry( NEW_DAY_ACTIONS, handleNewDay, CHECK_TIME, 0 );
+    establishStateEntry( SIX_MINUTE_ACTIONS, handleSixMinute, CHECK_TIME, 0 );
+    establishStateEntry( SIX_SECOND_ACTIONS, handleSixSecond, CHECK_TIME, 0 );
 }
 
 
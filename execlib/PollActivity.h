@@ -23,11 +23,9 @@ private:
         NEW_DAY_ACTIONS,
         SIX_MINUTE_ACTIONS,
         SIX_SECOND_ACTIONS,
-        ONE_SECOND_ACTIONS,
     };
 
     UINT32                  m_PreviousMidnightDayOfWeek;
-    EXECTIME                m_Previous1Second;
     EXECTIME                m_Previous6Minute;
     EXECTIME                m_Previous6Second;
 
@@ -37,10 +35,13 @@ private:
                                         const DUMPBITS      dumpBits );
 
     void                    newDayActions() const;
-    void                    oneSecondActions();
     void                    sixMinuteActions() const;
     void                    sixSecondActions() const;
-    void                    worker();
+
+    static void             handleCheckTime( IntrinsicActivity* const pObject );
+    static void             handleNewDay( IntrinsicActivity* const pObject );
+    static void             handleSixMinute( IntrinsicActivity* const pObject );
+    static void             handleSixSecond( IntrinsicActivity* const pObject );
 
 public:
     PollActivity( Exec* const pExec );
@@ -22,6 +22,7 @@ QueueManager::QueueManager
 )
 :ExecManager( pExec )
 {
+    MISCLIB_SET_LOCK_NAME( "QueueManager" );
 }
 
 
@@ -7,21 +7,47 @@
 
 
 
-//  private, protected methods
+//  private, protected statics
 
-//  worker()
+//  handleDone()
+//
+//  Invoked once as we terminate
+void
+RSIActivity::handleDone
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    RSIActivity* pActivity = dynamic_cast<RSIActivity*>( pObject );
+    pActivity->m_pRSIManager->setActivity( 0 );
+}
+
+
+//  handlePoll()
+//
+//  Polls the RSIManager - if it did anything, we come right back; otherwise we wait until RSIManager signals us,
+//  or until it is time to look at the session timeouts again.
 void
-RSIActivity::worker()
+RSIActivity::handlePoll
+(
+    IntrinsicActivity* const    pObject
+)
 {
-    m_pRSIManager->setActivity( this );
+    RSIActivity* pActivity = dynamic_cast<RSIActivity*>( pObject );
+    if ( pActivity->m_pRSIManager->poll() )
+        pActivity->setDelay( 0 );
+}
 
-    while ( !isWorkerTerminating() )
-    {
-        if ( !m_pRSIManager->poll() )
-            miscSleep( 250 );
-    }
 
-    m_pRSIManager->setActivity( 0 );
+//  handleStartup()
+void
+RSIActivity::handleStartup
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    RSIActivity* pActivity = dynamic_cast<RSIActivity*>( pObject );
+    pActivity->m_pRSIManager->setActivity( pActivity );
 }
 
 
@@ -36,6 +62,9 @@ RSIActivity::RSIActivity
 :IntrinsicActivity( pExec, "RSIActivity", pExec->getRunInfo() ),
 m_pRSIManager( pRSIManager )
 {
+    establishStateEntry( STARTUP, handleStartup, POLL, 0 );
+    establishStateEntry( POLL, handlePoll, POLL, m_IdleRecheckMSec );
+    establishStateEntry( DONE, handleDone, DONE, 0 );
 }
 
 
@@ -17,9 +17,20 @@
 class	RSIActivity : public IntrinsicActivity
 {
 private:
+    enum LocalState
+    {
+        STARTUP                 = m_InitialState,   //  Register with RSIManager
+        POLL,
+        DONE                    = m_TerminalState,  //  Deregister from RSIManager
+    };
+
     RSIManager* const           m_pRSIManager;
 
-    void                        worker();
+    static const COUNT32        m_IdleRecheckMSec = 1000;   //  session timeouts are in seconds; otherwise we are signaled
+
+    static void                 handleDone( IntrinsicActivity* const pObject );
+    static void                 handlePoll( IntrinsicActivity* const pObject );
+    static void                 handleStartup( IntrinsicActivity* const pObject );
 
 public:
 	RSIActivity( Exec* const        pExec,
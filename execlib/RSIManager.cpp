@@ -694,20 +694,24 @@ RSIManager::handleSessionTerminateWaitRunInfo
     RSISession* const   pSession
 )
 {
+    //  We are polled until the run lets go, so look under a shared lock, and attach only to make the change.
+    //  Nothing but us moves the run out of RSI_TERM, so the state cannot change in between.
     DemandRunInfo* pdri = pSession->getRunInfo();
     if ( pdri )
     {
-        pdri->attach();
-        if ( pdri->getState() == RunInfo::STATE_RSI_TERM )
+        pdri->attachShared();
+        bool runTerminating = pdri->getState() == RunInfo::STATE_RSI_TERM;
+        pdri->detachShared();
+
+        if ( runTerminating )
         {
+            pdri->attach();
             pSession->clearRunInfo();
             pSession->setState( RSISession::STATE_TERMINATE );
             pdri->setState( RunInfo::STATE_RSI_DETACHED );
             pdri->detach();
             pdri = 0;
         }
-        else
-            pdri->detach();
     }
 
     if ( pdri == 0 )
@@ -1015,7 +1019,7 @@ RSIManager::timeoutCheck
     //  Only test if the configured timeout is non-zero - zero means infinite time allowed.
     if ( pSession->getTimeoutSecs() > 0 )
     {
-        COUNT64 systemTime = SystemTime::getMicrosecondsSinceEpoch();
+        COUNT64 systemTime = VirtualClock::getInstance()->getMicrosecondsSinceEpoch();
         COUNT64 elapsedSeconds = (systemTime - pSession->getLastInputSystemTime()) / SystemTime::MICROSECONDS_PER_SECOND;
 
         if ( elapsedSeconds >= pSession->getTimeoutSecs() )
@@ -1061,6 +1065,8 @@ RSIManager::RSIManager
 )
 :ExecManager( pExec )
 {
+    MISCLIB_SET_LOCK_NAME( "RSIManager" );
+    m_pActivity = 0;
 }
 
 
@@ -1176,7 +1182,7 @@ RSIManager::openSession
 
 //  poll()
 //
-//  Invoked by RSIActivity on a frequent basis to keep RSI communication flowing
+//  Invoked by RSIActivity whenever it is signaled (a session or its run changed), and every so often for timeouts
 //
 //  Returns:
 //      true if we did something that would argue in favor of another immediate poll,
@@ -1289,6 +1295,20 @@ RSIManager::sendOutput
 }
 
 
+//  setActivity()
+//
+//  RSIActivity registers itself here (and deregisters with 0) so that signalActivity() can wake it
+void
+RSIManager::setActivity
+(
+    RSIActivity* const  pActivity
+)
+{
+    std::lock_guard<std::mutex> guard( m_ActivityMutex );
+    m_pActivity = pActivity;
+}
+
+
 //  shutdown()
 //
 //  ExecManager interface
@@ -1301,6 +1321,20 @@ RSIManager::shutdown()
 }
 
 
+//  signalActivity()
+//
+//  Wakes RSIActivity so that it polls the sessions promptly.
+//  Called for session state changes, and by the Exec when a demand run changes state or one of its activities exits.
+//  Takes no lock other than our own m_ActivityMutex, so it is safe with RunInfos attached.
+void
+RSIManager::signalActivity()
+{
+    std::lock_guard<std::mutex> guard( m_ActivityMutex );
+    if ( m_pActivity )
+        m_pActivity->signal();
+}
+
+
 //  startup()
 //
 //  ExecManager interface
@@ -1359,6 +1393,8 @@ RSIManager::terminateSession
         itsess->second->setState( RSISession::STATE_TERMINATE );
 
     unlock();
+    if ( stat == ST_SUCCESSFUL )
+        signalActivity();
     return stat;
 }
 
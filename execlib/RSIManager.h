@@ -33,6 +33,7 @@ private:
     typedef SESSIONS::const_iterator                CITSESSIONS;
 
     Activity*                       m_pActivity;                //  pointer to RSIActivity
+    std::mutex                      m_ActivityMutex;            //  protects m_pActivity for signalActivity()
     COUNT                           m_ConfigMaxSignOnAttempts;
     COUNT                           m_ConfigMaxSessions;
     SESSIONS                        m_Sessions;
@@ -84,9 +85,8 @@ public:
                                                 const bool          force = false );    //TODO force overrides @@HOLD... when we get that far
     Status                          terminateSession( const COUNT sessionNumber );
     bool                            poll();
-
-    //  inlines
-    void                            setActivity( RSIActivity* const pActivity )     { m_pActivity = pActivity; }
+    void                            setActivity( RSIActivity* const pActivity );
+    void                            signalActivity();
 
 	//  ExecManager interface
     void                            cleanup();
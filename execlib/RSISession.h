@@ -116,7 +116,7 @@ public:
     inline void                     setUserId( const SuperString& userId )          { m_UserId = userId; }
     inline void                     updateLastInputTime()
     {
-        m_LastInputSystemTime = SystemTime::getMicrosecondsSinceEpoch();
+        m_LastInputSystemTime = VirtualClock::getInstance()->getMicrosecondsSinceEpoch();
     }
 
     //  statics
@@ -0,0 +1,65 @@
+//	RunEventActivity.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//	Processes RunInfo state changes as they are posted
+
+
+
+#include	"execlib.h"
+
+
+
+//	private / protected statics
+
+//  handleDrain()
+//
+//  Lets the Exec process everything which has been posted.
+//  If some FIN run could not yet be closed (its control mode activity is still winding down)
+//  we look again shortly; otherwise we sleep until the next state change signals us.
+void
+RunEventActivity::handleDrain
+(
+    IntrinsicActivity* const    pObject
+)
+{
+    RunEventActivity* pActivity = dynamic_cast<RunEventActivity*>( pObject );
+    bool deferred = pActivity->m_pExec->processRunStateEvents( pActivity );
+    pActivity->setDelay( deferred ? m_DeferredRecheckMSec : m_IdleRecheckMSec );
+}
+
+
+
+// constructors / destructors
+
+RunEventActivity::RunEventActivity
+(
+    Exec* const         pExec
+)
+:IntrinsicActivity( pExec, "RunEventActivity", pExec->getRunInfo() )
+{
+    //  The Exec signals us whenever a RunInfo changes state
+    pExec->setRunEventActivity( this );
+    establishStateEntry( DRAIN, handleDrain, DRAIN, m_IdleRecheckMSec );
+}
+
+
+RunEventActivity::~RunEventActivity()
+{
+    m_pExec->setRunEventActivity( 0 );
+}
+
+
+
+//	public methods
+
+void
+RunEventActivity::dump
+(
+    std::ostream&       stream,
+    const std::string&  prefix,
+    const DUMPBITS      dumpBits
+)
+{
+    stream << prefix << "RunEventActivity" << std::endl;
+    IntrinsicActivity::dump( stream, prefix + "  ", dumpBits );
+}
@@ -0,0 +1,43 @@
+//	RunEventActivity.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//	Drains the Exec's queue of RunInfo state changes, advancing runs through FIN, RSI detach, and SMOQUE.
+//  RunInfo::setState() signals us, so runs move on as soon as they change state rather than at the next poll.
+
+
+
+#ifndef		EXECLIB_RUN_EVENT_ACTIVITY_H
+#define		EXECLIB_RUN_EVENT_ACTIVITY_H
+
+
+
+#include	"IntrinsicActivity.h"
+
+
+
+class	RunEventActivity : public IntrinsicActivity
+{
+private:
+    enum LocalState
+    {
+        DRAIN                   = m_InitialState,
+    };
+
+    static const COUNT32        m_DeferredRecheckMSec = 50;     //  while a FIN run still has a live activity
+    static const COUNT32        m_IdleRecheckMSec = 5000;       //  otherwise we wait to be signaled
+
+    //  IntrinsicActivity interface
+    void                        dump( std::ostream&         stream,
+                                        const std::string&  prefix,
+                                        const DUMPBITS      dumpBits );
+
+    static void                 handleDrain( IntrinsicActivity* const pObject );
+
+public:
+    RunEventActivity( Exec* const pExec );
+    ~RunEventActivity();
+};
+
+
+
+#endif
@@ -26,7 +26,11 @@ const UINT32            options,
 const char              schedulingPriority,
 const char              processorDispatchingPriority
 )
-:m_AccountId( accountId ),
+:m_pRegistryNext( 0 ),
+m_pRegistryPrev( 0 ),
+m_Registered( false ),
+m_RegistryState( initialState ),
+m_AccountId( accountId ),
 m_ActualRunId( actualRunId ),
 m_pExec( pExec ),
 m_Options( options ),
@@ -39,6 +43,7 @@ m_StartTime( pExec->getExecTime() ),
 m_UserId( userId ),
 m_State( initialState )
 {
+    MISCLIB_SET_LOCK_NAME( "RunInfo " + actualRunId );
     m_AttachedCount = 0;
 
     //  Set default and implied qualifiers to project ID
@@ -88,19 +93,6 @@ RunInfo::appendTaskActivity
 }
 
 
-//  cleanActivites()
-//
-//  Called occasionally by the Exec, so we can get rid of zombies.
-void
-RunInfo::cleanActivities()
-{
-    lock();
-    if ( m_pTask )
-        m_pTask->cleanActivities();
-    unlock();
-}
-
-
 //  dump()
 //
 //  For debugging
@@ -260,10 +252,10 @@ bool
 RunInfo::hasLiveActivity() const
 {
     bool result = false;
-    lock();
+    lockShared();
     if ( m_pTask )
         result = m_pTask->hasLiveActivity();
-    unlock();
+    unlockShared();
     return result;
 }
 
@@ -307,6 +299,45 @@ RunInfo::killActivities() const
 }
 
 
+//  removeActivity()
+//
+//  Called by the Exec when an activity of ours has exited.
+//  If we (still) own the activity, we give up ownership so the Exec can delete it.
+//  Exec MUST attach before calling here.
+//
+//  Returns:
+//      the activity if we owned it, else 0
+Activity*
+RunInfo::removeActivity
+(
+    Activity* const     pActivity,
+    const COUNT64       serialNumber
+)
+{
+    assert( m_AttachedCount > 0 );
+    return m_pTask ? m_pTask->removeActivity( pActivity, serialNumber ) : 0;
+}
+
+
+//  setState()
+//
+//  Changes the run state, and lets the Exec know so that it can act on the change right away
+void
+RunInfo::setState
+(
+    const State         state
+)
+{
+    assert( m_AttachedCount > 0 );
+    if ( state != m_State )
+    {
+        State previousState = m_State;
+        m_State = state;
+        m_pExec->postRunStateEvent( this, previousState, state );
+    }
+}
+
+
 
 //  statics
 
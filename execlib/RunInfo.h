@@ -96,7 +96,7 @@ Auxiliary Information - Description
 
 
 
-class   RunInfo : public Lockable
+class   RunInfo : public SharedLockable
 {
 public:
     enum    State
@@ -171,6 +171,14 @@ public:
     typedef     NAMEITEMS::const_iterator           CITNAMEITEMS;
 
 
+private:
+    //  Maintained by RunRegistry - links for its per-state lists, and the state of the list we are on
+    friend class RunRegistry;
+    RunInfo*                    m_pRegistryNext;
+    RunInfo*                    m_pRegistryPrev;
+    std::atomic<bool>           m_Registered;
+    State                       m_RegistryState;
+
 protected:
     //  mostly-static stuff, which is set just once for the run
     const std::string           m_AccountId;
@@ -228,15 +236,21 @@ public:
         unlock();
     }
 
+    //  For callers which only read - does not count as being attached
+    inline void attachShared() const    { lockShared(); }
+    inline void detachShared() const    { unlockShared(); }
+
     //  functional
     bool                        appendTaskActivity( Activity* const pActivity );
-    virtual void                cleanActivities();
     void                        establishNameItem( const SuperString&   internalName,
                                                    NameItem* const      pNameItem );
     FacilityItem*               getFacilityItem( const FacilityItem::IDENTIFIER ) const;
     NameItem*                   getNameItem( const SuperString& internalName ) const;
     virtual bool                hasLiveActivity() const;
     virtual void                killActivities() const;
+    virtual Activity*           removeActivity( Activity* const pActivity,
+                                                const COUNT64   serialNumber );
+    void                        setState( const State state );
 
     //  getters
     inline const std::string&       getActualRunId() const              { return m_ActualRunId; }
@@ -338,12 +352,6 @@ public:
         m_RunConditionWord.setW( value );
     }
 
-    inline void                 setState( const State state )
-    {
-        assert( m_AttachedCount > 0 );
-        m_State = state;
-    }
-
     inline void                 setStatus( const Status status )
     {
         assert( m_AttachedCount > 0 );
@@ -0,0 +1,296 @@
+//	RunRegistry.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//	RunRegistry implementation
+
+
+
+#include	"execlib.h"
+
+
+
+//	private methods
+
+//  adjustCounters()
+//
+//  Adds delta to whichever counters a run of this type counts toward, while in the given state
+void
+RunRegistry::adjustCounters
+(
+    const RunInfo* const    pRunInfo,
+    const RunInfo::State    state,
+    const int               delta
+)
+{
+    switch ( state )
+    {
+    case RunInfo::STATE_IN_BACKLOG:
+        m_BacklogRuns += delta;
+        break;
+
+    case RunInfo::STATE_ACTIVE:
+        if ( !pRunInfo->isExec() && !pRunInfo->isTIP() )
+            m_ActiveRuns += delta;
+        //  fall through
+
+    case RunInfo::STATE_FIN:
+    case RunInfo::STATE_RSI_DETACHED:
+    case RunInfo::STATE_RSI_TERM:
+        if ( pRunInfo->isBatch() )
+            m_BatchRuns += delta;
+        else if ( pRunInfo->isDemand() )
+            m_DemandRuns += delta;
+        break;
+
+    case RunInfo::STATE_SMOQUE:
+        //???? anything to do here?
+        break;
+    }
+}
+
+
+//  link()
+//
+//  Appends the RunInfo to the tail of the list for the given state
+void
+RunRegistry::link
+(
+    RunInfo* const          pRunInfo,
+    const RunInfo::State    state
+)
+{
+    StateList& list = m_StateLists[state];
+    pRunInfo->m_RegistryState = state;
+    pRunInfo->m_pRegistryNext = 0;
+    pRunInfo->m_pRegistryPrev = list.m_pTail;
+    if ( list.m_pTail )
+        list.m_pTail->m_pRegistryNext = pRunInfo;
+    else
+        list.m_pHead = pRunInfo;
+    list.m_pTail = pRunInfo;
+    ++list.m_Count;
+}
+
+
+//  unlink()
+//
+//  Removes the RunInfo from whichever state list it is on
+void
+RunRegistry::unlink
+(
+    RunInfo* const          pRunInfo
+)
+{
+    StateList& list = m_StateLists[pRunInfo->m_RegistryState];
+    if ( pRunInfo->m_pRegistryPrev )
+        pRunInfo->m_pRegistryPrev->m_pRegistryNext = pRunInfo->m_pRegistryNext;
+    else
+        list.m_pHead = pRunInfo->m_pRegistryNext;
+    if ( pRunInfo->m_pRegistryNext )
+        pRunInfo->m_pRegistryNext->m_pRegistryPrev = pRunInfo->m_pRegistryPrev;
+    else
+        list.m_pTail = pRunInfo->m_pRegistryPrev;
+    pRunInfo->m_pRegistryNext = 0;
+    pRunInfo->m_pRegistryPrev = 0;
+    --list.m_Count;
+}
+
+
+
+//  constructors, destructors
+
+RunRegistry::RunRegistry()
+    :m_ActiveRuns( 0 ),
+    m_BacklogRuns( 0 ),
+    m_BatchRuns( 0 ),
+    m_DemandRuns( 0 )
+{
+}
+
+
+RunRegistry::~RunRegistry()
+{
+    clear();
+}
+
+
+
+//  public methods
+
+//  clear()
+//
+//  Deletes all registered RunInfo objects
+void
+RunRegistry::clear()
+{
+    for ( ITRUNINFOS itri = m_RunInfos.begin(); itri != m_RunInfos.end(); ++itri )
+    {
+        itri->second->m_Registered = false;
+        delete itri->second;
+    }
+
+    m_RunInfos.clear();
+    for ( INDEX sx = 0; sx < STATE_COUNT; ++sx )
+        m_StateLists[sx] = StateList();
+
+    m_ActiveRuns = 0;
+    m_BacklogRuns = 0;
+    m_BatchRuns = 0;
+    m_DemandRuns = 0;
+}
+
+
+//  erase()
+//
+//  Removes a RunInfo object from the registry and deletes it
+void
+RunRegistry::erase
+(
+    RunInfo* const      pRunInfo
+)
+{
+    assert( pRunInfo->m_Registered );
+    unlink( pRunInfo );
+    m_RunInfos.erase( pRunInfo->getActualRunId() );
+    pRunInfo->m_Registered = false;
+    adjustCounters( pRunInfo, pRunInfo->getState(), -1 );
+    delete pRunInfo;
+}
+
+
+//  find()
+//
+//  Retrieves the RunInfo with the given actual run-id, or 0 if there is none
+RunInfo*
+RunRegistry::find
+(
+    const std::string&  actualRunId
+) const
+{
+    CITRUNINFOS itri = m_RunInfos.find( actualRunId );
+    return ( itri == m_RunInfos.end() ) ? 0 : itri->second;
+}
+
+
+//  getCounters()
+//
+//  Lock-free snapshot of the run counters
+RunRegistry::Counters
+RunRegistry::getCounters() const
+{
+    Counters counters;
+    counters.m_ActiveRuns = m_ActiveRuns.load();
+    counters.m_BacklogRuns = m_BacklogRuns.load();
+    counters.m_BatchRuns = m_BatchRuns.load();
+    counters.m_DemandRuns = m_DemandRuns.load();
+    return counters;
+}
+
+
+//  getRunids()
+//
+//  Populates a container with the actual run-ids of all registered runs, in collating order
+void
+RunRegistry::getRunids
+(
+    LSTRING* const      pContainer
+) const
+{
+    pContainer->clear();
+    for ( CITRUNINFOS itri = m_RunInfos.begin(); itri != m_RunInfos.end(); ++itri )
+        pContainer->push_back( itri->first );
+    pContainer->sort();
+}
+
+
+//  getRunInfos()
+//
+//  Populates a container with all registered runs
+void
+RunRegistry::getRunInfos
+(
+    std::vector<RunInfo*>* const    pContainer
+) const
+{
+    pContainer->clear();
+    pContainer->reserve( m_RunInfos.size() );
+    for ( CITRUNINFOS itri = m_RunInfos.begin(); itri != m_RunInfos.end(); ++itri )
+        pContainer->push_back( itri->second );
+}
+
+
+//  getRunInfos()
+//
+//  Populates a container with the runs on the list for the given state, oldest arrival first
+void
+RunRegistry::getRunInfos
+(
+    const RunInfo::State            state,
+    std::vector<RunInfo*>* const    pContainer
+) const
+{
+    pContainer->clear();
+    pContainer->reserve( m_StateLists[state].m_Count );
+    for ( RunInfo* pri = m_StateLists[state].m_pHead; pri; pri = pri->m_pRegistryNext )
+        pContainer->push_back( pri );
+}
+
+
+//  insert()
+//
+//  Registers a newly-created RunInfo object
+void
+RunRegistry::insert
+(
+    RunInfo* const      pRunInfo
+)
+{
+    assert( !pRunInfo->m_Registered );
+    m_RunInfos[pRunInfo->getActualRunId()] = pRunInfo;
+    link( pRunInfo, pRunInfo->getState() );
+    adjustCounters( pRunInfo, pRunInfo->getState(), 1 );
+    pRunInfo->m_Registered = true;
+}
+
+
+//  move()
+//
+//  Moves a run from the list for previousState to the list for newState, as state change events are applied.
+//
+//  Returns:
+//      false if the run is not registered, or is not on the list for previousState (event does not apply)
+bool
+RunRegistry::move
+(
+    RunInfo* const          pRunInfo,
+    const RunInfo::State    previousState,
+    const RunInfo::State    newState
+)
+{
+    if ( !pRunInfo->m_Registered || (pRunInfo->m_RegistryState != previousState) )
+        return false;
+
+    unlink( pRunInfo );
+    link( pRunInfo, newState );
+    return true;
+}
+
+
+//  noteStateChange()
+//
+//  Invoked from RunInfo::setState() (via the Exec), with the RunInfo attached but without the Exec lock.
+//  Only the atomic counters are touched - the state lists catch up when the event is applied.
+void
+RunRegistry::noteStateChange
+(
+    const RunInfo* const    pRunInfo,
+    const RunInfo::State    previousState,
+    const RunInfo::State    newState
+)
+{
+    if ( pRunInfo->m_Registered )
+    {
+        adjustCounters( pRunInfo, previousState, -1 );
+        adjustCounters( pRunInfo, newState, 1 );
+    }
+}
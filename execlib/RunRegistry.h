@@ -0,0 +1,97 @@
+//	RunRegistry.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//	The Exec's table of RunInfo objects.
+//  Runs are found by actual run-id through a hash table, and are linked into one list per run state
+//  (the links live in the RunInfo objects themselves) so that lifecycle processing visits only the runs
+//  in the states it cares about.
+//
+//  The table and lists are protected by the Exec lock.  The run counters, however, are atomics which are
+//  adjusted directly from RunInfo::setState(), so status queries need neither a scan nor the Exec lock.
+
+
+
+#ifndef     EXECLIB_RUN_REGISTRY_H
+#define     EXECLIB_RUN_REGISTRY_H
+
+
+
+#include    "RunInfo.h"
+
+
+
+class   RunRegistry
+{
+public:
+    static const COUNT          STATE_COUNT = RunInfo::STATE_SMOQUE + 1;
+
+    //  Snapshot of the run counters
+    class   Counters
+    {
+    public:
+        COUNT                   m_ActiveRuns;       //  ACTIVE runs which are neither Exec nor TIP
+        COUNT                   m_BacklogRuns;      //  IN_BACKLOG runs
+        COUNT                   m_BatchRuns;        //  batch runs from ACTIVE through RSI_DETACHED
+        COUNT                   m_DemandRuns;       //  demand runs from ACTIVE through RSI_DETACHED
+    };
+
+private:
+    class   StateList
+    {
+    public:
+        RunInfo*                m_pHead;
+        RunInfo*                m_pTail;
+        COUNT                   m_Count;
+
+        StateList()
+            :m_pHead( 0 ),
+            m_pTail( 0 ),
+            m_Count( 0 )
+        {}
+    };
+
+    typedef     std::unordered_map<std::string, RunInfo*>   RUNINFOS;
+    typedef     RUNINFOS::iterator                          ITRUNINFOS;
+    typedef     RUNINFOS::const_iterator                    CITRUNINFOS;
+
+    std::atomic<COUNT>          m_ActiveRuns;
+    std::atomic<COUNT>          m_BacklogRuns;
+    std::atomic<COUNT>          m_BatchRuns;
+    std::atomic<COUNT>          m_DemandRuns;
+    RUNINFOS                    m_RunInfos;
+    StateList                   m_StateLists[STATE_COUNT];
+
+    void                        adjustCounters( const RunInfo* const    pRunInfo,
+                                                const RunInfo::State    state,
+                                                const int               delta );
+    void                        link( RunInfo* const            pRunInfo,
+                                      const RunInfo::State      state );
+    void                        unlink( RunInfo* const pRunInfo );
+
+public:
+    RunRegistry();
+    ~RunRegistry();
+
+    void                        clear();
+    void                        erase( RunInfo* const pRunInfo );
+    RunInfo*                    find( const std::string& actualRunId ) const;
+    Counters                    getCounters() const;
+    void                        getRunids( LSTRING* const pContainer ) const;
+    void                        getRunInfos( std::vector<RunInfo*>* const pContainer ) const;
+    void                        getRunInfos( const RunInfo::State           state,
+                                             std::vector<RunInfo*>* const   pContainer ) const;
+    void                        insert( RunInfo* const pRunInfo );
+    bool                        move( RunInfo* const            pRunInfo,
+                                      const RunInfo::State      previousState,
+                                      const RunInfo::State      newState );
+    void                        noteStateChange( const RunInfo* const   pRunInfo,
+                                                 const RunInfo::State   previousState,
+                                                 const RunInfo::State   newState );
+
+    inline COUNT                getCount( const RunInfo::State state ) const    { return m_StateLists[state].m_Count; }
+    inline COUNT                size() const                                    { return m_RunInfos.size(); }
+};
+
+
+
+#endif
@@ -143,6 +143,7 @@ SecurityManager::SecurityManager
 )
 :ExecManager( pExec )
 {
+    MISCLIB_SET_LOCK_NAME( "SecurityManager" );
 }
 
 
@@ -19,6 +19,7 @@ Task::Task
     :m_RunId( runId ),
     m_TaskName( taskName )
 {
+    MISCLIB_SET_LOCK_NAME( "Task " + runId + " " + taskName );
 }
 
 
@@ -117,3 +118,36 @@ Task::killActivities() const
     unlock();
 }
 
+
+//  removeActivity()
+//
+//  Removes an exited activity from our container, without deleting it.
+//  The pointer is only compared until it is found, since the object may already have been deleted;
+//  the serial number then guards against a new activity which happens to occupy the same address.
+//
+//  Returns:
+//      the activity if we had it, else 0
+Activity*
+Task::removeActivity
+(
+    Activity* const     pActivity,
+    const COUNT64       serialNumber
+)
+{
+    Activity* pResult = 0;
+    lock();
+
+    for ( ITACTIVITIES ita = m_Activities.begin(); ita != m_Activities.end(); ++ita )
+    {
+        if ( (*ita == pActivity) && (pActivity->getSerialNumber() == serialNumber) )
+        {
+            m_Activities.erase( ita );
+            pResult = pActivity;
+            break;
+        }
+    }
+
+    unlock();
+    return pResult;
+}
+
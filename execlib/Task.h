@@ -36,6 +36,8 @@ public:
                                         const DUMPBITS      dumpBits ) const;
     bool                        hasLiveActivity() const;
     void                        killActivities() const;
+    Activity*                   removeActivity( Activity* const pActivity,
+                                                const COUNT64   serialNumber );
 
     inline void                 appendActivity( Activity* const pActivity )     { m_Activities.push_back( pActivity ); }
 };
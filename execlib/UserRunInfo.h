@@ -82,9 +82,10 @@ public:
     void                        setErrorMode();
 
     //  RunInfo interface (passed through to ControlModeRunInfo)
-    virtual void                cleanActivities() = 0;
     virtual bool                hasLiveActivity() const = 0;
     virtual void                killActivities() const = 0;
+    virtual Activity*           removeActivity( Activity* const pActivity,
+                                                const COUNT64   serialNumber ) = 0;
 
     //  getters
     inline const LSTRING&       getConsoleLog() const               { return m_ConsoleLog; }
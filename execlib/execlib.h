@@ -18,16 +18,6 @@
 
 
 
-//  Following tags should be commented out to disable them
-#define     EXECLIB_LOG_CHANNEL_IOS             0
-#define     EXECLIB_LOG_CHANNEL_IO_ERRORS       1
-#define     EXECLIB_LOG_CHANNEL_IO_BUFFERS      0   //  this won't always work if EXECLIB_LOG_CHANNEL_IOS isn't also def'd
-#define     EXECLIB_LOG_DEVICE_IOS              0
-#define     EXECLIB_LOG_DEVICE_IO_ERRORS        1
-#define     EXECLIB_LOG_DEVICE_IO_BUFFERS       0   //  this won't always work if EXECLIB_LOG_DEVICE_IOS isn't also def'd
-
-
-
 //  dump type bit masks
 typedef     UINT64                              DUMPBITS;
 
@@ -169,16 +159,23 @@ public:
 #include                    "SUKeyin.h"
 #include                    "UPKeyin.h"
 #include                "FFKeyin.h"
+#include                "IOKeyin.h"
 #include                "JumpKeyKeyin.h"
 #include                    "CJKeyin.h"
 #include                    "DJKeyin.h"
 #include                    "SJKeyin.h"
+#include                "LGKeyin.h"
 #include                "MSKeyin.h"
 #include                "PREPKeyin.h"
 #include                "SSKeyin.h"
+#include            "LoadGeneratorActivity.h"
+#include            "MFDScanActivity.h"
 #include            "PollActivity.h"
 #include            "RSIActivity.h"
+#include            "RunEventActivity.h"
 #include            "TransparentActivity.h"
+#include    "Awaitable.h"
+#include    "BootProfile.h"
 #include    "Configuration.h"
 #include    "ConsoleInterface.h"
 #include    "CSInterpreter.h"
@@ -194,6 +191,7 @@ public:
 #include        "QueueManager.h"
 #include        "RSIManager.h"
 #include        "SecurityManager.h"
+#include    "ExecMetrics.h"
 #include    "FacilityItem.h"
 #include        "NonStandardFacilityItem.h"
 #include        "StandardFacilityItem.h"
@@ -201,6 +199,7 @@ public:
 #include            "TapeFacilityItem.h"
 #include    "FileAllocationTable.h"
 #include    "FileSpecification.h"
+#include    "MFDSnapshot.h"
 #include    "MasterConfigurationTable.h"
 #include    "NodeTable.h"
 #include    "PanelInterface.h"
@@ -212,6 +211,7 @@ public:
 #include                "BatchRunInfo.h"
 #include                "DemandRunInfo.h"
 #include            "TIPRunInfo.h"
+#include    "RunRegistry.h"
 #include    "SecurityContext.h"
 #include    "SymbiontBuffer.h"
 #include    "Task.h"
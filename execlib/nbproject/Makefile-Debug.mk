@@ -37,8 +37,10 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 OBJECTFILES= \
 	${OBJECTDIR}/AccountManager.o \
 	${OBJECTDIR}/Activity.o \
+	${OBJECTDIR}/Awaitable.o \
 	${OBJECTDIR}/BatchRunInfo.o \
 	${OBJECTDIR}/BootActivity.o \
+	${OBJECTDIR}/BootProfile.o \
 	${OBJECTDIR}/CJKeyin.o \
 	${OBJECTDIR}/CSInterpreter.o \
 	${OBJECTDIR}/CSKeyin.o \
@@ -59,6 +61,7 @@ OBJECTFILES= \
 	${OBJECTDIR}/DollarBangKeyin.o \
 	${OBJECTDIR}/Exec.o \
 	${OBJECTDIR}/ExecManager.o \
+	${OBJECTDIR}/ExecMetrics.o \
 	${OBJECTDIR}/ExecRunInfo.o \
 	${OBJECTDIR}/FFKeyin.o \
 	${OBJECTDIR}/FSKeyin.o \
@@ -70,12 +73,18 @@ OBJECTFILES= \
 	${OBJECTDIR}/FacilityItem.o \
 	${OBJECTDIR}/FileAllocationTable.o \
 	${OBJECTDIR}/FileSpecification.o \
+	${OBJECTDIR}/IOKeyin.o \
 	${OBJECTDIR}/IntrinsicActivity.o \
 	${OBJECTDIR}/IoActivity.o \
 	${OBJECTDIR}/IoManager.o \
 	${OBJECTDIR}/JumpKeyKeyin.o \
 	${OBJECTDIR}/KeyinActivity.o \
+	${OBJECTDIR}/LGKeyin.o \
+	${OBJECTDIR}/LoadGeneratorActivity.o \
 	${OBJECTDIR}/MFDManager.o \
+	${OBJECTDIR}/MFDManager_Scan.o \
+	${OBJECTDIR}/MFDScanActivity.o \
+	${OBJECTDIR}/MFDSnapshot.o \
 	${OBJECTDIR}/MSKeyin.o \
 	${OBJECTDIR}/MasterConfigurationTable.o \
 	${OBJECTDIR}/NonStandardFacilityItem.o \
@@ -86,7 +95,9 @@ OBJECTFILES= \
 	${OBJECTDIR}/RSIManager.o \
 	${OBJECTDIR}/RSISession.o \
 	${OBJECTDIR}/RVKeyin.o \
+	${OBJECTDIR}/RunEventActivity.o \
 	${OBJECTDIR}/RunInfo.o \
+	${OBJECTDIR}/RunRegistry.o \
 	${OBJECTDIR}/SJKeyin.o \
 	${OBJECTDIR}/SSKeyin.o \
 	${OBJECTDIR}/SUKeyin.o \
@@ -139,6 +150,11 @@ ${OBJECTDIR}/Activity.o: Activity.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Activity.o Activity.cpp
 
+${OBJECTDIR}/Awaitable.o: Awaitable.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Awaitable.o Awaitable.cpp
+
 ${OBJECTDIR}/BatchRunInfo.o: BatchRunInfo.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -149,6 +165,11 @@ ${OBJECTDIR}/BootActivity.o: BootActivity.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/BootActivity.o BootActivity.cpp
 
+${OBJECTDIR}/BootProfile.o: BootProfile.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/BootProfile.o BootProfile.cpp
+
 ${OBJECTDIR}/CJKeyin.o: CJKeyin.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -249,6 +270,11 @@ ${OBJECTDIR}/ExecManager.o: ExecManager.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ExecManager.o ExecManager.cpp
 
+${OBJECTDIR}/ExecMetrics.o: ExecMetrics.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ExecMetrics.o ExecMetrics.cpp
+
 ${OBJECTDIR}/ExecRunInfo.o: ExecRunInfo.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -304,6 +330,11 @@ ${OBJECTDIR}/FileSpecification.o: FileSpecification.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/FileSpecification.o FileSpecification.cpp
 
+${OBJECTDIR}/IOKeyin.o: IOKeyin.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/IOKeyin.o IOKeyin.cpp
+
 ${OBJECTDIR}/IntrinsicActivity.o: IntrinsicActivity.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -329,11 +360,36 @@ ${OBJECTDIR}/KeyinActivity.o: KeyinActivity.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/KeyinActivity.o KeyinActivity.cpp
 
+${OBJECTDIR}/LGKeyin.o: LGKeyin.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/LGKeyin.o LGKeyin.cpp
+
+${OBJECTDIR}/LoadGeneratorActivity.o: LoadGeneratorActivity.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/LoadGeneratorActivity.o LoadGeneratorActivity.cpp
+
 ${OBJECTDIR}/MFDManager.o: MFDManager.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MFDManager.o MFDManager.cpp
 
+${OBJECTDIR}/MFDManager_Scan.o: MFDManager_Scan.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MFDManager_Scan.o MFDManager_Scan.cpp
+
+${OBJECTDIR}/MFDScanActivity.o: MFDScanActivity.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MFDScanActivity.o MFDScanActivity.cpp
+
+${OBJECTDIR}/MFDSnapshot.o: MFDSnapshot.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MFDSnapshot.o MFDSnapshot.cpp
+
 ${OBJECTDIR}/MSKeyin.o: MSKeyin.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -384,11 +440,21 @@ ${OBJECTDIR}/RVKeyin.o: RVKeyin.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/RVKeyin.o RVKeyin.cpp
 
+${OBJECTDIR}/RunEventActivity.o: RunEventActivity.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/RunEventActivity.o RunEventActivity.cpp
+
 ${OBJECTDIR}/RunInfo.o: RunInfo.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/RunInfo.o RunInfo.cpp
 
+${OBJECTDIR}/RunRegistry.o: RunRegistry.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/RunRegistry.o RunRegistry.cpp
+
 ${OBJECTDIR}/SJKeyin.o: SJKeyin.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
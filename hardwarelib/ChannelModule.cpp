@@ -165,7 +165,8 @@ ChannelModule::checkChildIOs()
             {
                 foundSomething = true;
                 //  No child IO, or child IO is done - lose the tracker silently.
-                itt->m_pConversionBuffer->m_InUse = false;
+                if ( itt->m_pConversionBuffer )
+                    itt->m_pConversionBuffer->m_InUse = false;
                 itt->m_pConversionBuffer = 0;
                 delete itt->m_pChildIo;
                 itt->m_pChildIo = 0;
@@ -210,21 +211,22 @@ ChannelModule::checkChildIOs()
             //  If the successful IO is a read (i.e., *In*) transfer the given data to the caller's buffer.
             if ( isTransferInCommand( itt->m_pChannelProgram->m_Command ) )
             {
-#if EXECLIB_LOG_CHANNEL_IO_BUFFERS
-                //  Need to dump IO Buffers on read completion
-                std::stringstream strm;
-                const IoAccessControlList::IOACWS& acList = itt->m_pChannelProgram->m_AccessControlList.getAccessControlWords();
-                for ( IoAccessControlList::CITIOACWS itacw = acList.begin(); itacw != acList.end(); ++itacw )
+                if ( SYSTEM_LOG_ENABLED( CHANNEL, TRACE ) )
                 {
-                    strm.str( "" );
-                    strm << "    ACW: pBuf=0" << itacw->m_pBuffer
-                        << " words=0" << std::oct << itacw->m_BufferSize
-                        << " " << miscGetExecIoBufferAddressModifierString( itacw->m_AddressModifier );
-                    SystemLog::write( strm.str() );
-
-                    miscDumpWord36BufferToLog( SystemLog::getInstance(), itacw->m_pBuffer, itacw->m_BufferSize );
+                    //  Need to dump IO Buffers on read completion
+                    const IoAccessControlList::IOACWS& acList = itt->m_pChannelProgram->m_AccessControlList.getAccessControlWords();
+                    for ( IoAccessControlList::CITIOACWS itacw = acList.begin(); itacw != acList.end(); ++itacw )
+                    {
+                        SYSTEM_LOG( CHANNEL, TRACE, "    ACW: pBuf=0" << itacw->m_pBuffer
+                                    << " words=0" << std::oct << itacw->m_BufferSize
+                                    << " " << miscGetExecIoBufferAddressModifierString( itacw->m_AddressModifier ) );
+                        miscDumpWord36BufferToLog( SystemLog::getInstance(),
+                                                   SystemLog::CATEGORY_CHANNEL,
+                                                   SystemLog::LEVEL_TRACE,
+                                                   itacw->m_pBuffer,
+                                                   itacw->m_BufferSize );
+                    }
                 }
-#endif
 
                 COUNT residue = 0;
                 switch ( itt->m_pChannelProgram->m_Format )
@@ -250,12 +252,20 @@ ChannelModule::checkChildIOs()
             itt->m_pChannelProgram->m_ChannelStatus = Status::SUCCESSFUL;
         }
 
+        m_TotalHistogram.record( LatencyHistogram::getMicroseconds() - itt->m_QueuedMicros );
+        if ( TraceLog::isEnabled() )
+            TraceLog::record( TraceLog::EVENT_CHANNEL_PROGRAM,
+                              TraceLog::PHASE_END,
+                              reinterpret_cast<UINT64>( itt->m_pChannelProgram ),
+                              static_cast<UINT64>( itt->m_pChildIo->getStatus() ) );
+
         //  Notify calling activity in case it hasn't picked up the channel status yet.
         if ( pSource )
             pSource->workerSignal();
 
         //  Release the conversion buffer
-        itt->m_pConversionBuffer->m_InUse = false;
+        if ( itt->m_pConversionBuffer )
+            itt->m_pConversionBuffer->m_InUse = false;
         itt->m_pConversionBuffer = 0;
 
         //  Lose the Device::IoInfo object
@@ -284,11 +294,28 @@ ChannelModule::startChildIOs()
     ITTRACKERS itt = m_Trackers.begin();
     while ( itt != m_Trackers.end() )
     {
-        foundSomething = true;
+        //  If the caller cancelled before we started a child IO, just get rid of this one.
+        //  If there is a child IO, checkChildIOs() disposes of the tracker when the child IO is done.
+        if ( itt->m_Cancelled )
+        {
+            if ( itt->m_pChildIo == 0 )
+            {
+                foundSomething = true;
+                if ( itt->m_pConversionBuffer )
+                    itt->m_pConversionBuffer->m_InUse = false;
+                itt = m_Trackers.erase( itt );
+            }
+            else
+                ++itt;
+            continue;
+        }
 
-        //  If this tracker isn't cancelled, and we don't yet have a child IO, create one.
-        if ( !itt->m_Cancelled && ( itt->m_pChildIo == 0 ) )
+        //  If this tracker doesn't yet have a child IO, create one - unless it is a transfer which is still
+        //  waiting for a conversion buffer (there are only MAX_BUFFERS of those; assignBuffers() will get to it).
+        if ( ( itt->m_pChildIo == 0 )
+             && ( ( itt->m_pConversionBuffer != 0 ) || !isTransferCommand( itt->m_pChannelProgram->m_Command ) ) )
         {
+            foundSomething = true;
             Device::IoFunction ioFunction = Device::IoFunction::NONE;
             switch ( itt->m_pChannelProgram->m_Command )
             {
@@ -311,20 +338,16 @@ ChannelModule::startChildIOs()
 
             itt->m_pChildIo = new Device::IoInfo( this,
                                                   ioFunction,
-                                                  itt->m_pConversionBuffer->m_pBuffer,
+                                                  itt->m_pConversionBuffer ? itt->m_pConversionBuffer->m_pBuffer : 0,
                                                   static_cast<BLOCK_ID>(itt->m_pChannelProgram->m_Address),
                                                   itt->m_TransferSizeBytes );
+            itt->m_StartedMicros = LatencyHistogram::getMicroseconds();
+            m_WaitHistogram.record( itt->m_StartedMicros - itt->m_QueuedMicros );
             Controller* pController = dynamic_cast<Controller*>( m_Descendants[itt->m_pChannelProgram->m_ControllerAddress] );
             pController->routeIo(itt->m_pChannelProgram->m_DeviceAddress, itt->m_pChildIo);
-            ++itt;
-        }
-        else
-        {
-            //  Caller cancelled, so just get rid of this one.
-            if ( itt->m_pConversionBuffer )
-                itt->m_pConversionBuffer->m_InUse = false;
-            itt = m_Trackers.erase( itt );
         }
+
+        ++itt;
     }
 
     return foundSomething;
@@ -399,7 +422,7 @@ ChannelModule::translateFromB
 
     //  Iterate over the destination buffer(s)
     UINT64 value;
-    for (IoAccessControlList::Iterator itacList = acList.begin(); !itacList.atEnd(), bx < bytesAvailable; ++itacList )
+    for (IoAccessControlList::Iterator itacList = acList.begin(); !itacList.atEnd() && (bx < bytesAvailable); ++itacList )
     {
         value = 0;
         for ( INDEX sx = 0; sx < 6; ++sx )
@@ -407,7 +430,7 @@ ChannelModule::translateFromB
             value <<= 6;
             if ( bx < bytesAvailable )
             {
-                value |= (pByteBuffer[bx++] && 077);
+                value |= (pByteBuffer[bx++] & 077);
                 ++pTracker->m_pChannelProgram->m_BytesTransferred;
             }
         }
@@ -547,7 +570,7 @@ ChannelModule::translateToA
                 break;
             }
 
-            pTracker->m_pConversionBuffer[bx++] = static_cast<BYTE>((value & 0377000000000ll) >> 27);
+            pTracker->m_pConversionBuffer->m_pBuffer[bx++] = static_cast<BYTE>((value & 0377000000000ll) >> 27);
             value <<= 9;
             ++pTracker->m_pChannelProgram->m_BytesTransferred;
         }
@@ -573,12 +596,12 @@ ChannelModule::translateToB
     INDEX bx = 0;
     for ( IoAccessControlList::Iterator itacList = pTracker->m_pChannelProgram->m_AccessControlList.begin(); !itacList.atEnd(); ++itacList )
     {
-        pTracker->m_pConversionBuffer[bx++] = (*itacList)->getS1();
-        pTracker->m_pConversionBuffer[bx++] = (*itacList)->getS2();
-        pTracker->m_pConversionBuffer[bx++] = (*itacList)->getS3();
-        pTracker->m_pConversionBuffer[bx++] = (*itacList)->getS4();
-        pTracker->m_pConversionBuffer[bx++] = (*itacList)->getS5();
-        pTracker->m_pConversionBuffer[bx++] = (*itacList)->getS6();
+        pTracker->m_pConversionBuffer->m_pBuffer[bx++] = (*itacList)->getS1();
+        pTracker->m_pConversionBuffer->m_pBuffer[bx++] = (*itacList)->getS2();
+        pTracker->m_pConversionBuffer->m_pBuffer[bx++] = (*itacList)->getS3();
+        pTracker->m_pConversionBuffer->m_pBuffer[bx++] = (*itacList)->getS4();
+        pTracker->m_pConversionBuffer->m_pBuffer[bx++] = (*itacList)->getS5();
+        pTracker->m_pConversionBuffer->m_pBuffer[bx++] = (*itacList)->getS6();
         pTracker->m_pChannelProgram->m_BytesTransferred += 6;
         ++pTracker->m_pChannelProgram->m_WordsTransferred;
     }
@@ -726,6 +749,20 @@ std::ostream&       stream
 {
     Node::dump( stream );
 
+    CpuSet affinity = getWorkerAffinity();
+    stream << "  Affinity: " << affinity.getSpecification();
+    if ( !affinity.isEmpty() )
+        stream << " (CPUs " << affinity.getCpuListString() << ")";
+    stream << std::endl;
+
+    LatencyHistogram::Snapshot wait = m_WaitHistogram.getSnapshot();
+    LatencyHistogram::Snapshot total = m_TotalHistogram.getSnapshot();
+    stream << "  Latency: IOs=" << std::dec << total.m_Count
+        << "  WaitP99=" << LatencyHistogram::getDurationString( wait.getPercentileMicros( 99.0 ) )
+        << "  P50=" << LatencyHistogram::getDurationString( total.getPercentileMicros( 50.0 ) )
+        << "  P99=" << LatencyHistogram::getDurationString( total.getPercentileMicros( 99.0 ) )
+        << "  Max=" << LatencyHistogram::getDurationString( total.m_MaxMicros ) << std::endl;
+
     stream << "  Trackers:" << std::endl;
     for ( CITTRACKERS itt = m_Trackers.begin(); itt != m_Trackers.end(); ++itt )
     {
@@ -777,6 +814,19 @@ std::ostream&       stream
 }
 
 
+//  getQueueDepth()
+//
+//  Retrieves the number of channel programs we are holding, whether waiting or in progress
+COUNT
+ChannelModule::getQueueDepth()
+{
+    lock();
+    COUNT depth = m_Trackers.size();
+    unlock();
+    return depth;
+}
+
+
 //  handleIo()
 //
 //  Called by InputOutputProcessor to hand us a ChannelProgram.
@@ -819,32 +869,37 @@ ChannelModule::handleIo
     Tracker tracker( pChannelProgram );
     tracker.m_TransferSizeBytes = byteCount;
 
-#if EXECLIB_LOG_CHANNEL_IOS
-    std::stringstream strm;
-    strm << "IOProcessor::routeIo path="
-        << pChannelProgram->m_ProcessorUPI << "/"
-        << pChannelProgram->m_ChannelModuleAddress << "/"
-        << pChannelProgram->m_ControllerAddress << "/"
-        << pChannelProgram->m_DeviceAddress
-        << " Cmd=" << ChannelModule::getChannelCommandString( pChannelProgram->m_Command )
-        << " Addr=" << pChannelProgram->m_Address
-        << " Words=" << pChannelProgram->m_TransferSizeWords;
-    SystemLog::write( strm.str() );
-    const IoAccessControlList::IOACWS& acList = pChannelProgram->m_AccessControlList.getAccessControlWords();
-    for ( IoAccessControlList::CITIOACWS itacw = acList.begin(); itacw != acList.end(); ++itacw )
+    SYSTEM_LOG( CHANNEL, DEBUG, getLogPrefix() << "handleIo path="
+                << pChannelProgram->m_ProcessorUPI << "/"
+                << pChannelProgram->m_ChannelModuleAddress << "/"
+                << pChannelProgram->m_ControllerAddress << "/"
+                << pChannelProgram->m_DeviceAddress
+                << " Cmd=" << ChannelModule::getCommandString( pChannelProgram->m_Command )
+                << " Addr=" << pChannelProgram->m_Address
+                << " Words=" << pChannelProgram->m_TransferSizeWords );
+    if ( SYSTEM_LOG_ENABLED( CHANNEL, DEBUG ) )
     {
-        strm.str( "" );
-        strm << "    ACW: pBuf=0" << itacw->m_pBuffer
-            << " words=0" << std::oct << itacw->m_BufferSize
-            << " " << miscGetExecIoBufferAddressModifierString( itacw->m_AddressModifier );
-        SystemLog::write( strm.str() );
-
-#if EXECLIB_LOG_CHANNEL_IO_BUFFERS
-        if ( ChannelModule::isTransferOutCommand( pChannelProgram->m_Command ) )
-            miscDumpWord36BufferToLog( SystemLog::getInstance(), itacw->m_pBuffer, itacw->m_BufferSize );
-#endif
+        const IoAccessControlList::IOACWS& acList = pChannelProgram->m_AccessControlList.getAccessControlWords();
+        for ( IoAccessControlList::CITIOACWS itacw = acList.begin(); itacw != acList.end(); ++itacw )
+        {
+            SYSTEM_LOG( CHANNEL, DEBUG, "    ACW: pBuf=0" << itacw->m_pBuffer
+                        << " words=0" << std::oct << itacw->m_BufferSize
+                        << " " << miscGetExecIoBufferAddressModifierString( itacw->m_AddressModifier ) );
+            if ( SYSTEM_LOG_ENABLED( CHANNEL, TRACE ) && ChannelModule::isTransferOutCommand( pChannelProgram->m_Command ) )
+                miscDumpWord36BufferToLog( SystemLog::getInstance(),
+                                           SystemLog::CATEGORY_CHANNEL,
+                                           SystemLog::LEVEL_TRACE,
+                                           itacw->m_pBuffer,
+                                           itacw->m_BufferSize );
+        }
     }
-#endif
+
+    if ( TraceLog::isEnabled() )
+        TraceLog::record( TraceLog::EVENT_CHANNEL_PROGRAM,
+                          TraceLog::PHASE_BEGIN,
+                          reinterpret_cast<UINT64>( pChannelProgram ),
+                          getTraceNameId(),
+                          static_cast<UINT64>( pChannelProgram->m_Command ) );
 
     //  Queue the tracker and wake up the worker
     lock();
@@ -864,6 +919,39 @@ ChannelModule::initialize()
 }
 
 
+//  setAffinity()
+//
+//  Pins our worker thread to the given host CPUs (see CpuSet).
+//  Device IO is done on this thread, so this places the whole IO path for our subsystems.
+//  Idle conversion buffers are discarded - the worker allocates (and first touches) replacements as needed,
+//  so they end up on the NUMA node local to the thread's new CPUs.
+//
+//  Returns:
+//      true if successful
+bool
+ChannelModule::setAffinity
+(
+    const CpuSet&       cpuSet
+)
+{
+    lock();
+    ITCONVERSIONBUFFERS itcb = m_ConversionBuffers.begin();
+    while ( itcb != m_ConversionBuffers.end() )
+    {
+        if ( (*itcb)->m_InUse )
+            ++itcb;
+        else
+        {
+            delete *itcb;
+            itcb = m_ConversionBuffers.erase( itcb );
+        }
+    }
+    unlock();
+
+    return workerSetAffinity( cpuSet );
+}
+
+
 //  signal()
 //
 //  Device has completed an IO for us.
@@ -146,13 +146,17 @@ public:
         ConversionBuffer*       m_pConversionBuffer;
         COUNT                   m_TransferSizeBytes;
         Device::IoInfo*         m_pChildIo;
+        COUNT64                 m_QueuedMicros;     //  when handleIo() accepted the channel program
+        COUNT64                 m_StartedMicros;    //  when the child IO was routed to the controller
 
         Tracker( ChannelProgram* const pChannelProgram )
             :m_Cancelled( false ),
             m_pChannelProgram( pChannelProgram ),
             m_pConversionBuffer( 0 ),
             m_TransferSizeBytes( 0 ),
-            m_pChildIo( 0 )
+            m_pChildIo( 0 ),
+            m_QueuedMicros( LatencyHistogram::getMicroseconds() ),
+            m_StartedMicros( 0 )
         {}
     };
 
@@ -164,12 +168,21 @@ public:
 private:
     CONVERSIONBUFFERS           m_ConversionBuffers;
     bool                        m_SkipDataFlag;         // From Configurator, via DeviceManager (at startup)
+    LatencyHistogram            m_TotalHistogram;       // handleIo() to completion, for completed channel programs
     TRACKERS                    m_Trackers;
+    LatencyHistogram            m_WaitHistogram;        // handleIo() to child IO start
 
     bool                assignBuffer( ITTRACKERS itTracker );
     bool                assignBuffers();
     bool                checkChildIOs();
     bool                startChildIOs();
+
+    //  Worker interface
+    void                worker();
+
+
+protected:
+    //  Frame translation - protected so that embench can drive it directly
     void                translateFromA( Tracker* const  pTracker,
                                         COUNT* const    pResidue );
     void                translateFromB( Tracker* const  pTracker,
@@ -181,21 +194,22 @@ private:
     void                translateToB( Tracker* const pTracker );
     void                translateToC( Tracker* const pTracker );
 
-    //  Worker interface
-    void                worker();
-
 
 public:
     ChannelModule( const std::string& name )
         :Node( Node::Category::CHANNEL_MODULE, name ),
         Worker( name ),
         m_SkipDataFlag( false )
-    {}
+    {
+        MISCLIB_SET_LOCK_NAME( "ChannelModule " + name );
+    }
 
     ~ChannelModule();
 
     bool                cancelIo( const ChannelProgram* const pChannelProgram );
+    COUNT               getQueueDepth();
     void                handleIo( ChannelProgram* const pChannelProgram );
+    bool                setAffinity( const CpuSet& cpuSet );
 
     //  Node interface
     void                dump( std::ostream& stream ) const;
@@ -206,6 +220,9 @@ public:
     //  inlines
     inline void         setSkipDataFlag( const bool flag )      { m_SkipDataFlag = flag; }
 
+    inline LatencyHistogram&    getTotalHistogram()             { return m_TotalHistogram; }
+    inline LatencyHistogram&    getWaitHistogram()              { return m_WaitHistogram; }
+
     inline bool startUp()
     {
         return workerStart();
@@ -15,7 +15,8 @@
 
 //  ioEnd()
 //
-//  Derived classes must call this at the end of handling an io.
+//  Derived classes must call this at the end of handling an io, while still holding our lock.
+//  Records the time since ioStart() in the service time histogram.
 //
 //  Parameters:
 //      pIoInfo:			pointer to DevIoInfo object
@@ -23,33 +24,35 @@ void
 Device::ioEnd
 (
 const IoInfo* const     pIoInfo
-) const
+)
 {
-#if EXECLIB_LOG_DEVICE_IO_ERRORS
+    m_ServiceHistogram.record( LatencyHistogram::getMicroseconds() - m_IoStartMicros );
+    if ( TraceLog::isEnabled() )
+        TraceLog::record( TraceLog::EVENT_DEVICE_IO,
+                          TraceLog::PHASE_END,
+                          reinterpret_cast<UINT64>( pIoInfo ),
+                          static_cast<UINT64>( pIoInfo->getStatus() ) );
+
     if (( pIoInfo->getStatus() != IoStatus::SUCCESSFUL )
         && ( pIoInfo->getStatus() != IoStatus::NO_INPUT ))
     {
-        std::string logStr = "IoError Sts=";
-        logStr += getIoStatusString( pIoInfo->getStatus(), pIoInfo->getSystemError() );
-        logStr += " ";
-        logStr += getIoInfoString( pIoInfo );
-        writeLogEntry( logStr );
+        SYSTEM_LOG( DEVICE, WARNING, getLogPrefix() << "IoError Sts="
+                    << getIoStatusString( pIoInfo->getStatus(), pIoInfo->getSystemError() )
+                    << " " << getIoInfoString( pIoInfo ) );
     }
-#endif
 
-#if EXECLIB_LOG_DEVICE_IO_BUFFERS
-	if (( isReadFunction( pIoInfo->getFunction() ) )
+	if ( SYSTEM_LOG_ENABLED( DEVICE, TRACE )
+        && ( isReadFunction( pIoInfo->getFunction() ) )
 		&& ( pIoInfo->getStatus() == IoStatus::SUCCESSFUL ))
 	{
 		writeBuffersToLog(pIoInfo);
 	}
-#endif
 }
 
 
 //  ioStart()
 //
-//  Derived classes must call this at the beginning of handling an io.
+//  Derived classes must call this at the beginning of handling an io, while holding our lock.
 //  Performs any necessary logging, and posts an IoEvent to anyone listening.
 //
 //  Parameters:
@@ -60,16 +63,17 @@ Device::ioStart
 const IoInfo* const     pIoInfo
 )
 {
-#if EXECLIB_LOG_DEVICE_IOS
-    std::string logStr = "IoStart ";
-    logStr += getIoInfoString( pIoInfo );
-    writeLogEntry( logStr );
-#endif
-
-#if EXECLIB_LOG_DEVICE_IO_BUFFERS
-    if ( isWriteFunction( pIoInfo->getFunction() ) )
+    m_IoStartMicros = LatencyHistogram::getMicroseconds();
+    if ( TraceLog::isEnabled() )
+        TraceLog::record( TraceLog::EVENT_DEVICE_IO,
+                          TraceLog::PHASE_BEGIN,
+                          reinterpret_cast<UINT64>( pIoInfo ),
+                          getTraceNameId(),
+                          static_cast<UINT64>( pIoInfo->getFunction() ) );
+
+    SYSTEM_LOG( DEVICE, DEBUG, getLogPrefix() << "IoStart " << getIoInfoString( pIoInfo ) );
+    if ( SYSTEM_LOG_ENABLED( DEVICE, TRACE ) && isWriteFunction( pIoInfo->getFunction() ) )
         writeBuffersToLog( pIoInfo );
-#endif
 }
 
 
@@ -92,6 +96,12 @@ std::ostream&       stream
             << " Model: " << getDeviceModelString( m_DeviceModel ) << std::endl;
     stream << "  Ready:" << (isReady() ? "YES" : "NO")
         << "  UnitAttn:" << (m_UnitAttentionFlag ? "YES" : "NO") << std::endl;
+
+    LatencyHistogram::Snapshot service = m_ServiceHistogram.getSnapshot();
+    stream << "  Service: IOs=" << std::dec << service.m_Count
+        << "  P50=" << LatencyHistogram::getDurationString( service.getPercentileMicros( 50.0 ) )
+        << "  P99=" << LatencyHistogram::getDurationString( service.getPercentileMicros( 99.0 ) )
+        << "  Max=" << LatencyHistogram::getDurationString( service.m_MaxMicros ) << std::endl;
 }
 
 
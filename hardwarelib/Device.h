@@ -172,8 +172,12 @@ protected:
     //  All reads and writes will be rejected with IOS_UNIT_ATTENTION until an IOF_GET_INFO is issued.
     bool                                m_UnitAttentionFlag;
 
+    //  Time taken by handleIo(), from ioStart() to ioEnd()
+    COUNT64                             m_IoStartMicros;
+    LatencyHistogram                    m_ServiceHistogram;
+
     //  normal functions
-    void                                ioEnd( const IoInfo* const ) const;
+    void                                ioEnd( const IoInfo* const );
     void                                ioStart( const IoInfo* const );
 
     //  abstract functions
@@ -186,8 +190,11 @@ protected:
             m_DeviceModel( deviceModel ),
             m_DeviceType( deviceType ),
             m_ReadyFlag( false ),
-            m_UnitAttentionFlag( false )
-    {}
+            m_UnitAttentionFlag( false ),
+            m_IoStartMicros( 0 )
+    {
+        MISCLIB_SET_LOCK_NAME( "Device " + name );
+    }
 
 
 public:
@@ -203,6 +210,8 @@ public:
         return getDeviceModelString( m_DeviceModel );
     }
     inline DeviceType                   getDeviceType() const   { return m_DeviceType; }
+    inline const LatencyHistogram&      getServiceHistogram() const     { return m_ServiceHistogram; }
+    inline LatencyHistogram&            getServiceHistogram()           { return m_ServiceHistogram; }
     inline std::string                  getDeviceTypeString() const
     {
         return getDeviceTypeString( m_DeviceType );
@@ -96,7 +96,12 @@ const IoInfo*       pIoInfo
 {
     const IoInfo* pDiskIoInfo = dynamic_cast<const IoInfo*>(pIoInfo);
     if ( pDiskIoInfo && pDiskIoInfo->getBuffer() )
-        miscWriteBufferToLog( getName(), "IO Buffer", pDiskIoInfo->getBuffer(), getBlockSize() );
+        miscWriteBufferToLog( SystemLog::CATEGORY_DEVICE,
+                              SystemLog::LEVEL_TRACE,
+                              getName(),
+                              "IO Buffer",
+                              pDiskIoInfo->getBuffer(),
+                              getBlockSize() );
 }
 
 
@@ -11,6 +11,34 @@
 
 //  protected and private methods
 
+//  getDiskBlockSize()
+//
+//  Finds the block size of the pack mounted on the device a channel program addresses, for IoCapture.
+//  Returns zero if the path does not lead to a prepped disk.
+BLOCK_SIZE
+IOProcessor::getDiskBlockSize
+(
+    const ChannelModule::ChannelProgram* const  pChannelProgram
+) const
+{
+    auto itcm = m_Descendants.find( pChannelProgram->m_ChannelModuleAddress );
+    if ( itcm == m_Descendants.end() )
+        return 0;
+
+    const DESCENDANTS& controllers = itcm->second->getDescendants();
+    auto itctl = controllers.find( pChannelProgram->m_ControllerAddress );
+    if ( itctl == controllers.end() )
+        return 0;
+
+    const DESCENDANTS& devices = itctl->second->getDescendants();
+    auto itdev = devices.find( pChannelProgram->m_DeviceAddress );
+    if ( itdev == devices.end() )
+        return 0;
+
+    const DiskDevice* pDevice = dynamic_cast<const DiskDevice*>( itdev->second );
+    return pDevice ? pDevice->getBlockSize() : 0;
+}
+
 
 
 //  constructors, destructors
@@ -60,6 +88,9 @@ IOProcessor::routeIo
     ChannelModule::ChannelProgram* const    pChannelProgram
 )
 {
+    if ( IoCapture::isCapturing() )
+        IoCapture::record( *pChannelProgram, getDiskBlockSize( pChannelProgram ) );
+
     auto itn = m_Descendants.find( pChannelProgram->m_ChannelModuleAddress );
     if ( itn == m_Descendants.end() )
     {
@@ -19,6 +19,7 @@
 class   IOProcessor : public Processor
 {
 private:
+    BLOCK_SIZE      getDiskBlockSize( const ChannelModule::ChannelProgram* const pChannelProgram ) const;
 
 public:
     IOProcessor( const std::string& name )
@@ -0,0 +1,294 @@
+//  IoCapture.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "hardwarelib.h"
+
+
+
+//  statics
+
+const char                      IoCapture::FILE_MAGIC[8] = { 'E', 'M', 'I', 'O', 'C', 'A', 'P', '1' };
+
+IoCapture::RECORDS              IoCapture::m_Batch;
+std::atomic<bool>               IoCapture::m_Capturing( false );
+std::condition_variable         IoCapture::m_Condition;
+std::mutex                      IoCapture::m_ControlMutex;
+std::string                     IoCapture::m_FileName;
+IoCapture::BATCHES              IoCapture::m_FullBatches;
+COUNT64                         IoCapture::m_LastTimestamp = 0;
+std::mutex                      IoCapture::m_Mutex;
+COUNT64                         IoCapture::m_RecordCount = 0;
+IoCapture::BATCHES              IoCapture::m_SpareBatches;
+COUNT64                         IoCapture::m_StartMicros = 0;
+COUNT64                         IoCapture::m_StopMicros = 0;
+std::ofstream                   IoCapture::m_Stream;
+bool                            IoCapture::m_TermFlag = false;
+std::thread                     IoCapture::m_Thread;
+bool                            IoCapture::m_WriteFailed = false;
+
+static_assert( sizeof( IoCapture::Record ) == 40, "IoCapture::Record must match the capture file format" );
+
+
+
+//  private methods
+
+//  writerLoop()
+//
+//  Main loop for the writer thread.  Writes full batches as record() hands them over, and returns the
+//  emptied batches to the spares.  Exits once it is told to terminate and the queue is empty, or when a
+//  write fails - in which case capture is stopped.
+void
+IoCapture::writerLoop()
+{
+    std::unique_lock<std::mutex> lock( m_Mutex );
+    while ( true )
+    {
+        while ( !m_TermFlag && m_FullBatches.empty() )
+            m_Condition.wait( lock );
+        if ( m_FullBatches.empty() )
+            break;
+
+        RECORDS batch;
+        batch.swap( m_FullBatches.front() );
+        m_FullBatches.pop_front();
+        lock.unlock();
+
+        m_Stream.write( reinterpret_cast<const char*>( &batch[0] ), batch.size() * sizeof( Record ) );
+        bool good = m_Stream.good();
+
+        lock.lock();
+        if ( !good )
+        {
+            m_FullBatches.clear();
+            m_WriteFailed = true;
+            if ( m_Capturing.load() )
+            {
+                SystemLog::write( "IoCapture failed writing " + m_FileName + " - capture stopped" );
+                m_Capturing.store( false );
+                m_StopMicros = LatencyHistogram::getMicroseconds();
+            }
+            break;
+        }
+
+        batch.clear();
+        m_SpareBatches.push_back( RECORDS() );
+        m_SpareBatches.back().swap( batch );
+    }
+}
+
+
+
+//  public methods
+
+//  getStatistics()
+IoCapture::Statistics
+IoCapture::getStatistics()
+{
+    Statistics stats;
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    stats.m_Capturing = m_Capturing.load();
+    stats.m_FileName = m_FileName;
+    stats.m_RecordCount = m_RecordCount;
+    if ( m_StartMicros )
+        stats.m_ElapsedMicros = (stats.m_Capturing ? LatencyHistogram::getMicroseconds() : m_StopMicros) - m_StartMicros;
+    return stats;
+}
+
+
+//  load()
+//
+//  Reads a capture file in its entirety
+bool
+IoCapture::load
+(
+    const std::string&  fileName,
+    RECORDS* const      pRecords,
+    std::string* const  pErrorMessage
+)
+{
+    pRecords->clear();
+    std::ifstream stream( fileName, std::ios::in | std::ios::binary );
+    if ( !stream.good() )
+    {
+        *pErrorMessage = "Cannot open " + fileName;
+        return false;
+    }
+
+    char magic[sizeof( FILE_MAGIC )];
+    UINT32 recordSize = 0;
+    stream.read( magic, sizeof( magic ) );
+    stream.read( reinterpret_cast<char*>( &recordSize ), sizeof( recordSize ) );
+    if ( !stream.good() || (memcmp( magic, FILE_MAGIC, sizeof( FILE_MAGIC ) ) != 0) || (recordSize != sizeof( Record )) )
+    {
+        *pErrorMessage = fileName + " is not a valid IO capture";
+        return false;
+    }
+
+    Record record;
+    while ( stream.read( reinterpret_cast<char*>( &record ), sizeof( record ) ) )
+        pRecords->push_back( record );
+
+    //  A capture which was not stopped cleanly may end with part of a record - we ignore it
+    return true;
+}
+
+
+//  record()
+//
+//  Called by IOProcessor::routeIo() for every channel program, while we are capturing
+void
+IoCapture::record
+(
+    const ChannelModule::ChannelProgram&    channelProgram,
+    const BLOCK_SIZE                        blockSize
+)
+{
+    Record record;
+    memset( &record, 0, sizeof( record ) );
+    record.m_Address = channelProgram.m_Address;
+    record.m_TransferSizeWords = static_cast<UINT32>( channelProgram.m_TransferSizeWords );
+    record.m_BlockSize = static_cast<UINT32>( blockSize );
+    record.m_ProcessorUPI = static_cast<UINT16>( channelProgram.m_ProcessorUPI );
+    record.m_ChannelModuleAddress = static_cast<UINT16>( channelProgram.m_ChannelModuleAddress );
+    record.m_ControllerAddress = static_cast<UINT16>( channelProgram.m_ControllerAddress );
+    record.m_DeviceAddress = static_cast<UINT16>( channelProgram.m_DeviceAddress );
+    record.m_Command = static_cast<UINT8>( channelProgram.m_Command );
+    record.m_Format = static_cast<UINT8>( channelProgram.m_Format );
+    record.m_BufferWords = static_cast<UINT32>( channelProgram.m_AccessControlList.getExtent() );
+    COUNT64 nowMicros = LatencyHistogram::getMicroseconds();
+
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    if ( !m_Capturing.load( std::memory_order_relaxed ) )
+        return;
+
+    //  Another thread may have taken the mutex between our clock read and ours - timestamps must not go backward
+    record.m_Timestamp = nowMicros > m_StartMicros ? nowMicros - m_StartMicros : 0;
+    if ( record.m_Timestamp < m_LastTimestamp )
+        record.m_Timestamp = m_LastTimestamp;
+    m_LastTimestamp = record.m_Timestamp;
+
+    m_Batch.push_back( record );
+    ++m_RecordCount;
+    if ( m_Batch.size() >= BATCH_SIZE )
+    {
+        m_FullBatches.push_back( RECORDS() );
+        m_FullBatches.back().swap( m_Batch );
+        if ( m_SpareBatches.empty() )
+        {
+            m_Batch.reserve( BATCH_SIZE );
+        }
+        else
+        {
+            m_Batch.swap( m_SpareBatches.back() );
+            m_SpareBatches.pop_back();
+        }
+
+        m_Condition.notify_one();
+    }
+}
+
+
+//  start()
+//
+//  Opens (replacing) the capture file, starts the writer thread, and starts capturing
+bool
+IoCapture::start
+(
+    const std::string&  fileName,
+    std::string* const  pErrorMessage
+)
+{
+    std::lock_guard<std::mutex> controlGuard( m_ControlMutex );
+    {
+        std::lock_guard<std::mutex> guard( m_Mutex );
+        if ( m_Capturing.load() )
+        {
+            *pErrorMessage = "Already capturing to " + m_FileName;
+            return false;
+        }
+    }
+
+    //  A writer which gave up on a failed write has exited, but nobody has joined it yet
+    if ( m_Thread.joinable() )
+    {
+        m_Thread.join();
+        m_Stream.close();
+    }
+
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    m_Stream.clear();
+    m_Stream.open( fileName, std::ios::out | std::ios::binary | std::ios::trunc );
+    if ( !m_Stream.good() )
+    {
+        m_Stream.close();
+        *pErrorMessage = "Cannot open " + fileName;
+        return false;
+    }
+
+    UINT32 recordSize = sizeof( Record );
+    m_Stream.write( FILE_MAGIC, sizeof( FILE_MAGIC ) );
+    m_Stream.write( reinterpret_cast<const char*>( &recordSize ), sizeof( recordSize ) );
+
+    m_Batch.clear();
+    m_Batch.reserve( BATCH_SIZE );
+    m_FileName = fileName;
+    m_LastTimestamp = 0;
+    m_RecordCount = 0;
+    m_StartMicros = LatencyHistogram::getMicroseconds();
+    m_StopMicros = 0;
+    m_TermFlag = false;
+    m_WriteFailed = false;
+    m_Thread = std::thread( &IoCapture::writerLoop );
+    m_Capturing.store( true );
+    return true;
+}
+
+
+//  stop()
+//
+//  Stops capturing, hands whatever is left in the batch to the writer, and waits for the writer to finish.
+//
+//  Returns:
+//      false if we were not capturing, or the capture file could not be written
+bool
+IoCapture::stop()
+{
+    std::lock_guard<std::mutex> controlGuard( m_ControlMutex );
+    bool wasCapturing = false;
+    {
+        std::lock_guard<std::mutex> guard( m_Mutex );
+        wasCapturing = m_Capturing.load();
+        if ( wasCapturing )
+        {
+            m_Capturing.store( false );
+            m_StopMicros = LatencyHistogram::getMicroseconds();
+            if ( !m_Batch.empty() )
+            {
+                m_FullBatches.push_back( RECORDS() );
+                m_FullBatches.back().swap( m_Batch );
+            }
+        }
+
+        m_TermFlag = true;
+        m_Condition.notify_one();
+    }
+
+    //  Even if capture was already stopped by a failed write, its writer has yet to be joined
+    if ( m_Thread.joinable() )
+    {
+        m_Thread.join();
+        m_Stream.close();
+    }
+
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    m_SpareBatches.clear();
+    if ( !wasCapturing )
+        return false;
+
+    if ( m_WriteFailed )
+        SystemLog::write( "IoCapture failed writing " + m_FileName );
+    return !m_WriteFailed;
+}
+
@@ -0,0 +1,110 @@
+//  IoCapture.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Records the shape of every channel program which reaches IOProcessor::routeIo() - when, where, what,
+//  and how much, but never the data - so that an IO pattern can be shared where the packs themselves cannot.
+//  embench -replay re-issues a capture against scratch packs.
+//
+//  Capture is off by default; while it is off, routeIo() pays one relaxed atomic load.  While it is on,
+//  records are batched under a mutex, and each full batch is handed to a writer thread - routeIo() callers
+//  never wait on the capture file.  If the writer falls behind, full batches queue up in memory.
+//
+//  The file is FILE_MAGIC, the record size (UINT32), then Records in the order routeIo() saw them,
+//  until end of file.
+
+
+
+#ifndef     HARDWARELIB_IO_CAPTURE_H
+#define     HARDWARELIB_IO_CAPTURE_H
+
+
+
+#include    "ChannelModule.h"
+
+
+
+class   IoCapture
+{
+public:
+    //  One channel program, exactly as it appears in the capture file
+    class   Record
+    {
+    public:
+        UINT64                  m_Timestamp;            //  microseconds since the capture started
+        UINT64                  m_Address;              //  block id, for disks
+        UINT32                  m_TransferSizeWords;
+        UINT32                  m_BlockSize;            //  bytes per block of the target pack - zero if not a prepped disk
+        UINT16                  m_ProcessorUPI;
+        UINT16                  m_ChannelModuleAddress;
+        UINT16                  m_ControllerAddress;
+        UINT16                  m_DeviceAddress;
+        UINT8                   m_Command;              //  ChannelModule::Command
+        UINT8                   m_Format;               //  ChannelModule::IoTranslateFormat
+        UINT16                  m_Reserved;
+        UINT32                  m_BufferWords;          //  extent of the ACWs - the channel module sizes the transfer by this
+    };
+
+    typedef     std::vector<Record>                 RECORDS;
+    typedef     RECORDS::const_iterator             CITRECORDS;
+
+    class   Statistics
+    {
+    public:
+        bool                    m_Capturing;
+        COUNT64                 m_ElapsedMicros;        //  since the current (or most recent) capture started
+        std::string             m_FileName;
+        COUNT64                 m_RecordCount;
+
+        Statistics()
+            :m_Capturing( false ),
+            m_ElapsedMicros( 0 ),
+            m_RecordCount( 0 )
+        {}
+    };
+
+    static const COUNT          BATCH_SIZE = 4096;      //  records per write
+    static const char           FILE_MAGIC[8];
+
+private:
+    typedef     std::deque<RECORDS>                 BATCHES;
+
+    //  Everything but m_Capturing is protected by m_Mutex, except that the file itself is touched only by
+    //  the writer thread (or by start() and stop(), while it is not running).  start() and stop() are
+    //  serialized by m_ControlMutex, so that only one of them starts or joins the writer.
+    static RECORDS              m_Batch;                //  being filled by record()
+    static std::atomic<bool>    m_Capturing;
+    static std::mutex           m_ControlMutex;
+    static std::condition_variable  m_Condition;        //  wakes the writer
+    static std::string          m_FileName;
+    static BATCHES              m_FullBatches;          //  waiting for the writer
+    static COUNT64              m_LastTimestamp;        //  of the most recent record
+    static std::mutex           m_Mutex;
+    static COUNT64              m_RecordCount;
+    static BATCHES              m_SpareBatches;         //  written, and ready to be filled again
+    static COUNT64              m_StartMicros;
+    static COUNT64              m_StopMicros;
+    static std::ofstream        m_Stream;
+    static bool                 m_TermFlag;             //  tells the writer to finish the queue and exit
+    static std::thread          m_Thread;
+    static bool                 m_WriteFailed;
+
+    static void                 writerLoop();
+
+public:
+    static Statistics           getStatistics();
+    static bool                 load( const std::string&    fileName,
+                                      RECORDS* const        pRecords,
+                                      std::string* const    pErrorMessage );
+    static void                 record( const ChannelModule::ChannelProgram&    channelProgram,
+                                        const BLOCK_SIZE                        blockSize );
+    static bool                 start( const std::string&   fileName,
+                                       std::string* const   pErrorMessage );
+    static bool                 stop();
+
+    static inline bool          isCapturing()       { return m_Capturing.load( std::memory_order_relaxed ); }
+};
+
+
+
+#endif
+
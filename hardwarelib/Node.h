@@ -29,26 +29,43 @@ public:
 private:
     const Category              m_Category;
     const SuperString           m_Name;
+    const UINT32                m_TraceNameId;
 
 
 protected:
     ANCESTORS                   m_Ancestors;
     DESCENDANTS                 m_Descendants;
 
+    //  System log category for entries concerning this node
+    inline SystemLog::Category getLogCategory() const
+    {
+        switch ( m_Category )
+        {
+        case Category::CHANNEL_MODULE:  return SystemLog::CATEGORY_CHANNEL;
+        case Category::DEVICE:          return SystemLog::CATEGORY_DEVICE;
+        default:                        return SystemLog::CATEGORY_IO;
+        }
+    }
+
+    //  Node category and name, for the front of system log entries (e.g., in SYSTEM_LOG expressions)
+    inline std::string getLogPrefix() const
+    {
+        return std::string( getCategoryString( m_Category ) ) + " " + m_Name + ":";
+    }
+
     //  Convenience wrapper for derived objects which need to write to the system log.
     //  Automatically prepends node category and name to the message.
     inline void writeLogEntry( const std::string& text ) const
     {
-        std::stringstream strm;
-        strm << getCategoryString( m_Category ) << " " << m_Name << ":" << text;
-        SystemLog::write( strm.str() );
+        SystemLog::write( getLogCategory(), SystemLog::LEVEL_INFO, getLogPrefix() + text );
     }
 
 public:
     Node( const Category        category,
           const std::string&    name )
         :m_Category( category ),
-                m_Name( name )
+                m_Name( name ),
+                m_TraceNameId( TraceLog::intern( name ) )
     {}
 
     virtual ~Node(){}
@@ -72,6 +89,7 @@ public:
     inline const char*          getCategoryString() const   { return getCategoryString( m_Category ); }
     inline const DESCENDANTS&   getDescendants() const      { return m_Descendants; }
     inline const SuperString&   getName() const             { return m_Name; }
+    inline UINT32               getTraceNameId() const      { return m_TraceNameId; }
 
     //  statics
     static bool                 connect( Node* const    pAncestor,
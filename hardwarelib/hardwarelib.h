@@ -18,13 +18,8 @@
 
 
 
-//  Following tags should be commented out to disable them
-#define     EXECLIB_LOG_CHANNEL_IOS             0
-#define     EXECLIB_LOG_CHANNEL_IO_ERRORS       1
-#define     EXECLIB_LOG_CHANNEL_IO_BUFFERS      0   //  this won't always work if EXECLIB_LOG_CHANNEL_IOS isn't also def'd
-#define     EXECLIB_LOG_DEVICE_IOS              0
-#define     EXECLIB_LOG_DEVICE_IO_ERRORS        1
-#define     EXECLIB_LOG_DEVICE_IO_BUFFERS       0   //  this won't always work if EXECLIB_LOG_DEVICE_IOS isn't also def'd
+//  IO logging is controlled at run time, by the minimum levels of the CHANNEL and DEVICE system log categories:
+//  DEBUG logs every channel program and device IO, TRACE adds the buffer contents.
 
 
 
@@ -82,6 +77,7 @@ public:
 #include        "Processor.h"
 #include            "IOProcessor.h"
 #include    "IoAccessControlList.h"
+#include    "IoCapture.h"
 
 
 #endif
@@ -43,6 +43,7 @@ OBJECTFILES= \
 	${OBJECTDIR}/FileSystemDiskDevice.o \
 	${OBJECTDIR}/IOProcessor.o \
 	${OBJECTDIR}/IoAccessControlList.o \
+	${OBJECTDIR}/IoCapture.o \
 	${OBJECTDIR}/Node.o \
 	${OBJECTDIR}/Processor.o
 
@@ -113,6 +114,11 @@ ${OBJECTDIR}/IoAccessControlList.o: IoAccessControlList.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/IoAccessControlList.o IoAccessControlList.cpp
 
+${OBJECTDIR}/IoCapture.o: IoCapture.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/IoCapture.o IoCapture.cpp
+
 ${OBJECTDIR}/Node.o: Node.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
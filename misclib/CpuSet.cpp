@@ -0,0 +1,288 @@
+//  CpuSet implementation
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "misclib.h"
+
+
+
+//  statics
+
+//  Read during static initialization, on the main thread, so that unpinning a thread can restore whatever
+//  restriction (cpuset, taskset, and the like) we were started under rather than claiming every host CPU.
+const CpuSet::CPUS              CpuSet::m_StartupCpus = CpuSet::readProcessCpus();
+
+
+
+//  private static methods
+
+//  parseList()
+//
+//  Parses a list of CPU numbers and ranges, such as "0-3,8,10-11".
+//
+//  Parameters:
+//      list:               list to be parsed
+//      pCpus:              where we store the resulting CPU numbers
+//
+//  Returns:
+//      true if successful, false if the list is malformed
+bool
+CpuSet::parseList
+(
+    const std::string&      list,
+    CPUS* const             pCpus
+)
+{
+    pCpus->clear();
+
+    std::stringstream strm( list );
+    std::string item;
+    while ( std::getline( strm, item, ',' ) )
+    {
+        SuperString first = item;
+        SuperString last = item;
+        size_t dashx = item.find( '-' );
+        if ( dashx != std::string::npos )
+        {
+            first = item.substr( 0, dashx );
+            last = item.substr( dashx + 1 );
+        }
+
+        first.trimLeadingSpaces();
+        first.trimTrailingSpaces();
+        last.trimLeadingSpaces();
+        last.trimTrailingSpaces();
+        if ( !first.isDecimalNumeric() || !last.isDecimalNumeric() )
+            return false;
+
+        COUNT firstCpu = first.toDecimal();
+        COUNT lastCpu = last.toDecimal();
+        if ( (firstCpu > lastCpu) || (lastCpu >= MAX_CPUS) )
+            return false;
+
+        for ( COUNT cpu = firstCpu; cpu <= lastCpu; ++cpu )
+            pCpus->insert( cpu );
+    }
+
+    return !pCpus->empty();
+}
+
+
+//  readProcessCpus()
+//
+//  Retrieves the CPUs the host currently allows us to run on.
+//  If the host won't say, we assume all of them.
+CpuSet::CPUS
+CpuSet::readProcessCpus()
+{
+    CPUS cpus;
+#ifdef WIN32
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if ( GetProcessAffinityMask( GetCurrentProcess(), &processMask, &systemMask ) )
+    {
+        for ( COUNT cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu )
+        {
+            if ( processMask & (static_cast<DWORD_PTR>(1) << cpu) )
+                cpus.insert( cpu );
+        }
+    }
+#else
+    cpu_set_t cpuSet;
+    CPU_ZERO( &cpuSet );
+    if ( sched_getaffinity( 0, sizeof(cpuSet), &cpuSet ) == 0 )
+    {
+        for ( COUNT cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+        {
+            if ( CPU_ISSET( cpu, &cpuSet ) )
+                cpus.insert( cpu );
+        }
+    }
+#endif
+
+    if ( cpus.empty() )
+    {
+        for ( COUNT cpu = 0; cpu < getHostCpuCount(); ++cpu )
+            cpus.insert( cpu );
+    }
+
+    return cpus;
+}
+
+
+
+//  public methods
+
+//  getCpuListString()
+//
+//  Produces the CPU numbers in this set in list form, with ranges collapsed (e.g., "0-3,8").
+//  An empty set produces "ANY".
+std::string
+CpuSet::getCpuListString() const
+{
+    if ( m_Cpus.empty() )
+        return "ANY";
+
+    std::stringstream strm;
+    CITCPUS itcpu = m_Cpus.begin();
+    while ( itcpu != m_Cpus.end() )
+    {
+        COUNT first = *itcpu;
+        COUNT last = first;
+        for ( ++itcpu; (itcpu != m_Cpus.end()) && (*itcpu == last + 1); ++itcpu )
+            last = *itcpu;
+
+        if ( strm.tellp() > 0 )
+            strm << ",";
+        strm << first;
+        if ( last > first )
+            strm << "-" << last;
+    }
+
+    return strm.str();
+}
+
+
+
+//  public static methods
+
+//  getHostCpuCount()
+//
+//  Retrieves the number of CPUs the host makes available to us
+COUNT
+CpuSet::getHostCpuCount()
+{
+    COUNT count = std::thread::hardware_concurrency();
+    return count ? count : 1;
+}
+
+
+//  getNumaNodeCount()
+//
+//  Retrieves the number of NUMA nodes on the host.  A host with no NUMA support is reported as a single node.
+COUNT
+CpuSet::getNumaNodeCount()
+{
+#ifdef WIN32
+    ULONG highestNode = 0;
+    if ( !GetNumaHighestNodeNumber( &highestNode ) )
+        return 1;
+    return highestNode + 1;
+#else
+    COUNT count = 0;
+    while ( true )
+    {
+        std::stringstream strm;
+        strm << "/sys/devices/system/node/node" << count << "/cpulist";
+        std::ifstream file( strm.str().c_str() );
+        if ( !file.is_open() )
+            break;
+        ++count;
+    }
+
+    return count ? count : 1;
+#endif
+}
+
+
+//  getNumaNodeCpus()
+//
+//  Retrieves the CPUs which belong to a particular NUMA node
+//
+//  Parameters:
+//      node:               NUMA node number
+//      pCpus:              where we store the CPU numbers
+//
+//  Returns:
+//      true if successful, false if there is no such node
+bool
+CpuSet::getNumaNodeCpus
+(
+    const COUNT             node,
+    CPUS* const             pCpus
+)
+{
+    pCpus->clear();
+
+#ifdef WIN32
+    ULONGLONG mask = 0;
+    if ( (node > 0xFF) || !GetNumaNodeProcessorMask( static_cast<UCHAR>(node), &mask ) )
+        return false;
+    for ( COUNT cpu = 0; cpu < 64; ++cpu )
+    {
+        if ( mask & (1ull << cpu) )
+            pCpus->insert( cpu );
+    }
+    return !pCpus->empty();
+#else
+    std::stringstream strm;
+    strm << "/sys/devices/system/node/node" << node << "/cpulist";
+    std::ifstream file( strm.str().c_str() );
+    if ( !file.is_open() )
+    {
+        //  No NUMA support in the host (or at least none exposed) - node 0 is the whole host
+        if ( node != 0 )
+            return false;
+        for ( COUNT cpu = 0; cpu < getHostCpuCount(); ++cpu )
+            pCpus->insert( cpu );
+        return true;
+    }
+
+    std::string list;
+    std::getline( file, list );
+    return parseList( list, pCpus );
+#endif
+}
+
+
+//  parse()
+//
+//  Builds a CpuSet from a specification string (see CpuSet.h)
+//
+//  Parameters:
+//      specification:      specification to be parsed
+//      pCpuSet:            where we store the result - unchanged if we fail
+//
+//  Returns:
+//      true if successful, false if the specification is malformed or refers to CPUs or nodes the host doesn't have
+bool
+CpuSet::parse
+(
+    const std::string&      specification,
+    CpuSet* const           pCpuSet
+)
+{
+    SuperString spec = specification;
+    spec.trimLeadingSpaces();
+    spec.trimTrailingSpaces();
+    spec.foldToUpperCase();
+
+    if ( spec.empty() || (spec.compare( "ANY" ) == 0) )
+    {
+        pCpuSet->m_Cpus.clear();
+        pCpuSet->m_Specification = "ANY";
+        return true;
+    }
+
+    CPUS cpus;
+    if ( spec.compare( 0, 4, "NODE" ) == 0 )
+    {
+        SuperString nodeStr = spec.substr( 4 );
+        if ( !nodeStr.isDecimalNumeric() )
+            return false;
+        if ( !getNumaNodeCpus( nodeStr.toDecimal(), &cpus ) )
+            return false;
+    }
+    else
+    {
+        if ( !parseList( spec, &cpus ) )
+            return false;
+        if ( *cpus.rbegin() >= getHostCpuCount() )
+            return false;
+    }
+
+    pCpuSet->m_Cpus = cpus;
+    pCpuSet->m_Specification = spec;
+    return true;
+}
@@ -0,0 +1,59 @@
+//  CpuSet.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  A set of host CPUs, to which a Worker thread may be pinned.
+//  A CpuSet is described by a specification string, which is either
+//      a list of CPU numbers and ranges, such as "0-3,8,10-11"
+//      "NODEn", meaning all the CPUs which belong to host NUMA node n
+//      "ANY" or empty, meaning no restriction at all
+//  The specification is retained as given, so that it can be persisted and displayed.
+
+
+
+#ifndef     MISCLIB_CPU_SET_H
+#define     MISCLIB_CPU_SET_H
+
+
+
+class   CpuSet
+{
+public:
+    typedef std::set<COUNT>                     CPUS;
+    typedef CPUS::iterator                      ITCPUS;
+    typedef CPUS::const_iterator                CITCPUS;
+
+    static const COUNT          MAX_CPUS = 1024;        //  highest CPU number we can pin to, plus one
+
+private:
+    CPUS                        m_Cpus;
+    std::string                 m_Specification;
+
+    static const CPUS           m_StartupCpus;          //  the process affinity, as it was before anyone pinned anything
+
+    static bool                 parseList( const std::string&   list,
+                                           CPUS* const          pCpus );
+    static CPUS                 readProcessCpus();
+
+public:
+    CpuSet()
+        :m_Specification( "ANY" )
+    {}
+
+    std::string                 getCpuListString() const;
+
+    inline const CPUS&          getCpus() const                 { return m_Cpus; }
+    inline const std::string&   getSpecification() const        { return m_Specification; }
+    inline bool                 isEmpty() const                 { return m_Cpus.empty(); }
+
+    static COUNT                getHostCpuCount();
+    static COUNT                getNumaNodeCount();
+    static bool                 getNumaNodeCpus( const COUNT    node,
+                                                 CPUS* const    pCpus );
+    static inline const CPUS&   getStartupCpus()                { return m_StartupCpus; }
+    static bool                 parse( const std::string&   specification,
+                                       CpuSet* const        pCpuSet );
+};
+
+
+
+#endif
@@ -3,6 +3,8 @@
 //
 //  Interface and code for abstract class defining behavior for any object
 //  which wishes to emit events to listeners.
+//  Listeners may be registered and unregistered on one thread while events are emitted on another;
+//  once unregisterListener() returns, the listener will not be called again.
 
 
 
@@ -24,18 +26,34 @@ private:
     typedef LISTENERS::const_iterator   CITLISTENERS;
 
     LISTENERS                           m_Listeners;
+    std::mutex                          m_ListenerMutex;
 
 protected:
     void    notifyListeners( Event* const pEvent )
     {
+        std::lock_guard<std::mutex> guard( m_ListenerMutex );
         for ( CITLISTENERS it = m_Listeners.begin(); it != m_Listeners.end(); ++it )
             (*it)->listenerEventTriggered( pEvent );
     }
 
 public:
-    inline void         registerListener( Listener* const pListener )           { m_Listeners.push_back( pListener ); }
-    inline void         registerPriorityListener( Listener* const pListener )   { m_Listeners.push_front( pListener ); }
-    inline void         unregisterListener( Listener* const pListener )         { m_Listeners.remove( pListener ); }
+    inline void registerListener( Listener* const pListener )
+    {
+        std::lock_guard<std::mutex> guard( m_ListenerMutex );
+        m_Listeners.push_back( pListener );
+    }
+
+    inline void registerPriorityListener( Listener* const pListener )
+    {
+        std::lock_guard<std::mutex> guard( m_ListenerMutex );
+        m_Listeners.push_front( pListener );
+    }
+
+    inline void unregisterListener( Listener* const pListener )
+    {
+        std::lock_guard<std::mutex> guard( m_ListenerMutex );
+        m_Listeners.remove( pListener );
+    }
 };
 
 
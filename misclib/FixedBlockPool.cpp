@@ -0,0 +1,362 @@
+//  FixedBlockPool.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "misclib.h"
+
+
+
+#ifdef  WIN32
+#define     POOL_THREAD_LOCAL   __declspec(thread)
+#else
+#define     POOL_THREAD_LOCAL   __thread
+#endif
+
+#define     POOL_BLOCK_ALIGNMENT    16
+
+
+
+//  statics
+
+FixedBlockPool*     FixedBlockPool::m_pPools[MAX_POOLS];
+COUNT32             FixedBlockPool::m_PoolCount = 0;
+
+static std::mutex   registryMutex;      //  protects m_pPools and m_PoolCount
+
+#ifndef WIN32
+static pthread_key_t    threadExitKey;
+static std::once_flag   threadExitKeyOnce;
+#endif
+
+
+
+//  private methods
+
+//  addSlab()
+//
+//  Obtains another slab from the heap and threads its blocks onto the pool free list.
+//  Call under lock().
+void
+FixedBlockPool::addSlab()
+{
+    BYTE* pSlab = new BYTE[m_BlockSize * m_BlocksPerSlab];
+    m_Slabs.push_back( pSlab );
+
+    //  Link the blocks in address order, so that consecutive allocations tend to be adjacent in memory
+    BYTE* pBlock = pSlab + (m_BlockSize * (m_BlocksPerSlab - 1));
+    for ( INDEX bx = 0; bx < m_BlocksPerSlab; ++bx )
+    {
+        setNextLink( pBlock, m_pFreeList );
+        m_pFreeList = pBlock;
+        pBlock -= m_BlockSize;
+    }
+
+    ++m_Statistics.m_SlabCount;
+    m_Statistics.m_BlockCount += m_BlocksPerSlab;
+    m_Statistics.m_PoolFreeCount += m_BlocksPerSlab;
+}
+
+
+//  drainThreadCache()
+//
+//  Moves the indicated number of blocks from the given thread cache back to the pool free list.
+void
+FixedBlockPool::drainThreadCache
+(
+    ThreadCache* const  pCache,
+    const COUNT32       blockCount
+)
+{
+    COUNT32 count = (blockCount > pCache->m_Count) ? pCache->m_Count : blockCount;
+    if ( count == 0 )
+        return;
+
+    //  Unlink the blocks from the cache without holding the lock, then splice them in all at once.
+    void* pFirst = pCache->m_pHead;
+    void* pLast = pFirst;
+    for ( COUNT32 bx = 1; bx < count; ++bx )
+        pLast = getNextLink( pLast );
+    pCache->m_pHead = getNextLink( pLast );
+    pCache->m_Count -= count;
+
+    lock();
+    setNextLink( pLast, m_pFreeList );
+    m_pFreeList = pFirst;
+    m_Statistics.m_PoolFreeCount += count;
+    ++m_Statistics.m_DrainCount;
+    m_Statistics.m_AllocationCount += pCache->m_Allocations;
+    pCache->m_Allocations = 0;
+    unlock();
+}
+
+
+//  refillThreadCache()
+//
+//  Moves a batch of blocks from the pool free list into the given (presumably empty) thread cache.
+void
+FixedBlockPool::refillThreadCache
+(
+    ThreadCache* const  pCache
+)
+{
+    lock();
+
+    for ( COUNT32 bx = 0; bx < THREAD_CACHE_BATCH; ++bx )
+    {
+        if ( m_pFreeList == 0 )
+            addSlab();
+
+        void* pBlock = m_pFreeList;
+        m_pFreeList = getNextLink( pBlock );
+        setNextLink( pBlock, pCache->m_pHead );
+        pCache->m_pHead = pBlock;
+        ++pCache->m_Count;
+    }
+
+    m_Statistics.m_PoolFreeCount -= THREAD_CACHE_BATCH;
+    ++m_Statistics.m_RefillCount;
+    m_Statistics.m_AllocationCount += pCache->m_Allocations;
+    pCache->m_Allocations = 0;
+    unlock();
+}
+
+
+
+//  private statics
+
+//  getThreadCache()
+//
+//  Retrieves the calling thread's cache for the pool with the given index.
+//  The first time a thread gets here, we arrange for its caches to be drained when it exits.
+FixedBlockPool::ThreadCache*
+FixedBlockPool::getThreadCache
+(
+    const INDEX     poolIndex
+)
+{
+    static POOL_THREAD_LOCAL ThreadCache    caches[MAX_POOLS];
+    static POOL_THREAD_LOCAL bool           registered;
+
+    if ( !registered )
+    {
+        registered = true;
+#ifndef WIN32
+        std::call_once( threadExitKeyOnce, [](){ pthread_key_create( &threadExitKey, threadExitHandler ); } );
+        pthread_setspecific( threadExitKey, caches );
+#endif
+    }
+
+    return &caches[poolIndex];
+}
+
+
+//  threadExitHandler()
+//
+//  Invoked (on POSIX platforms) as a thread-specific-data destructor when a thread which has used
+//  any pool terminates.  Returns all the thread's cached blocks to their pools.
+void
+FixedBlockPool::threadExitHandler
+(
+    void*           pArg
+)
+{
+    ThreadCache* pCaches = static_cast<ThreadCache*>( pArg );
+
+    registryMutex.lock();
+    for ( INDEX px = 0; px < m_PoolCount; ++px )
+    {
+        if ( m_pPools[px] && pCaches[px].m_Count )
+            m_pPools[px]->drainThreadCache( &pCaches[px], pCaches[px].m_Count );
+    }
+    registryMutex.unlock();
+}
+
+
+
+//  constructors, destructors
+
+FixedBlockPool::FixedBlockPool
+(
+    const std::string&  name,
+    const COUNT         blockSize,
+    const COUNT         blocksPerSlab
+)
+:m_BlockSize( ((blockSize < sizeof(void*) ? sizeof(void*) : blockSize) + POOL_BLOCK_ALIGNMENT - 1) & ~static_cast<COUNT>(POOL_BLOCK_ALIGNMENT - 1) ),
+m_BlocksPerSlab( blocksPerSlab ? blocksPerSlab : 1 ),
+m_Name( name ),
+m_PoolIndex( MAX_POOLS ),
+m_pFreeList( 0 )
+{
+    //  Register the pool so that it gets thread caching.  Indexes are never reused, so that
+    //  a stale thread cache can never be mistaken for the cache of some newer pool.
+    registryMutex.lock();
+    if ( m_PoolCount < MAX_POOLS )
+    {
+        m_PoolIndex = m_PoolCount++;
+        m_pPools[m_PoolIndex] = this;
+    }
+    registryMutex.unlock();
+}
+
+
+FixedBlockPool::~FixedBlockPool()
+{
+    registryMutex.lock();
+    if ( m_PoolIndex < MAX_POOLS )
+        m_pPools[m_PoolIndex] = 0;
+    registryMutex.unlock();
+
+    lock();
+    while ( !m_Slabs.empty() )
+    {
+        delete[] m_Slabs.front();
+        m_Slabs.pop_front();
+    }
+    m_pFreeList = 0;
+    unlock();
+}
+
+
+
+//  public methods
+
+//  allocate()
+//
+//  Retrieves an uninitialized block from the pool.  Never returns null.
+void*
+FixedBlockPool::allocate()
+{
+    if ( m_PoolIndex < MAX_POOLS )
+    {
+        ThreadCache* pCache = getThreadCache( m_PoolIndex );
+        if ( pCache->m_Count == 0 )
+            refillThreadCache( pCache );
+
+        void* pBlock = pCache->m_pHead;
+        pCache->m_pHead = getNextLink( pBlock );
+        --pCache->m_Count;
+        ++pCache->m_Allocations;
+        return pBlock;
+    }
+
+    lock();
+    if ( m_pFreeList == 0 )
+        addSlab();
+    void* pBlock = m_pFreeList;
+    m_pFreeList = getNextLink( pBlock );
+    --m_Statistics.m_PoolFreeCount;
+    ++m_Statistics.m_AllocationCount;
+    unlock();
+
+    return pBlock;
+}
+
+
+//  dump()
+//
+//  For debugging
+void
+FixedBlockPool::dump
+(
+    std::ostream&       stream,
+    const std::string&  prefix
+) const
+{
+    Statistics stats = getStatistics();
+    stream << prefix << "FixedBlockPool " << m_Name
+        << "  BlockSize=" << std::dec << m_BlockSize
+        << "  Slabs=" << stats.m_SlabCount
+        << "  Blocks=" << stats.m_BlockCount
+        << "  PoolFree=" << stats.m_PoolFreeCount
+        << "  Allocs=" << stats.m_AllocationCount
+        << "  Refills=" << stats.m_RefillCount
+        << "  Drains=" << stats.m_DrainCount
+        << std::endl;
+}
+
+
+//  getStatistics()
+FixedBlockPool::Statistics
+FixedBlockPool::getStatistics() const
+{
+    lock();
+    Statistics stats = m_Statistics;
+    unlock();
+    return stats;
+}
+
+
+//  release()
+//
+//  Returns a block (previously obtained via allocate()) to the pool.  Null pointers are ignored.
+void
+FixedBlockPool::release
+(
+    void* const     pBlock
+)
+{
+    if ( pBlock == 0 )
+        return;
+
+    if ( m_PoolIndex < MAX_POOLS )
+    {
+        ThreadCache* pCache = getThreadCache( m_PoolIndex );
+        setNextLink( pBlock, pCache->m_pHead );
+        pCache->m_pHead = pBlock;
+        ++pCache->m_Count;
+        if ( pCache->m_Count > THREAD_CACHE_LIMIT )
+            drainThreadCache( pCache, THREAD_CACHE_BATCH );
+        return;
+    }
+
+    lock();
+    setNextLink( pBlock, m_pFreeList );
+    m_pFreeList = pBlock;
+    ++m_Statistics.m_PoolFreeCount;
+    unlock();
+}
+
+
+
+//  public statics
+
+//  dumpAll()
+//
+//  Dumps all registered pools
+void
+FixedBlockPool::dumpAll
+(
+    std::ostream&       stream,
+    const std::string&  prefix
+)
+{
+    registryMutex.lock();
+    for ( INDEX px = 0; px < m_PoolCount; ++px )
+    {
+        if ( m_pPools[px] )
+            m_pPools[px]->dump( stream, prefix );
+    }
+    registryMutex.unlock();
+}
+
+
+//  getPools()
+//
+//  Retrieves all registered pools (i.e., those which have thread caches).  Pools live for the duration
+//  of the process, so the pointers remain valid.
+void
+FixedBlockPool::getPools
+(
+    std::vector<FixedBlockPool*>* const pContainer
+)
+{
+    pContainer->clear();
+    registryMutex.lock();
+    for ( INDEX px = 0; px < m_PoolCount; ++px )
+    {
+        if ( m_pPools[px] )
+            pContainer->push_back( m_pPools[px] );
+    }
+    registryMutex.unlock();
+}
@@ -0,0 +1,103 @@
+//  FixedBlockPool.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Slab allocator for large numbers of small, identically-sized objects (directory sectors, DAD tables, etc).
+//  Blocks are carved out of slabs which are obtained from the heap a few dozen blocks at a time,
+//  and released blocks are kept on a free list rather than being returned to the heap.
+//
+//  Each thread keeps a small private cache of free blocks per pool, so that the common allocate/release
+//  path does not need to take the pool lock.  When a thread cache runs dry it pulls a batch from the pool;
+//  when it overflows it pushes a batch back.  A thread's cached blocks are returned to the pool when the
+//  thread exits (on POSIX platforms; on Windows they simply remain cached, bounded by the cache limit).
+//
+//  Pools are expected to live for the duration of the process (i.e., as statics).  Slab memory is never
+//  returned to the heap until the pool is destroyed.
+
+
+
+#ifndef     MISCLIB_FIXED_BLOCK_POOL_H
+#define     MISCLIB_FIXED_BLOCK_POOL_H
+
+
+
+class   FixedBlockPool : public Lockable
+{
+public:
+    class   Statistics
+    {
+    public:
+        COUNT64                 m_AllocationCount;      //  Blocks allocated - thread cache counts are folded in on refill/drain
+        COUNT64                 m_SlabCount;            //  Number of slabs obtained from the heap
+        COUNT64                 m_BlockCount;           //  Total number of blocks in all slabs
+        COUNT64                 m_PoolFreeCount;        //  Blocks on the pool-wide free list (not counting thread caches)
+        COUNT64                 m_RefillCount;          //  Number of times a thread cache was refilled from the pool
+        COUNT64                 m_DrainCount;           //  Number of times a thread cache was drained into the pool
+
+        Statistics()
+            :m_AllocationCount( 0 ),
+            m_SlabCount( 0 ),
+            m_BlockCount( 0 ),
+            m_PoolFreeCount( 0 ),
+            m_RefillCount( 0 ),
+            m_DrainCount( 0 )
+        {}
+    };
+
+    static const COUNT32        MAX_POOLS           = 16;   //  Pools beyond this number do not get thread caches
+    static const COUNT32        THREAD_CACHE_LIMIT  = 64;   //  Max free blocks held by one thread for one pool
+    static const COUNT32        THREAD_CACHE_BATCH  = 32;   //  Blocks moved between thread cache and pool at once
+
+private:
+    //  Per-thread cache of free blocks.  Must be POD so that it can live in thread-local storage.
+    struct  ThreadCache
+    {
+        void*                   m_pHead;
+        COUNT32                 m_Count;
+        COUNT32                 m_Allocations;          //  Not yet folded into the pool statistics
+    };
+
+    const COUNT                 m_BlockSize;            //  Rounded up to a multiple of the free-list link size
+    const COUNT                 m_BlocksPerSlab;
+    const std::string           m_Name;
+    INDEX                       m_PoolIndex;            //  Index into thread cache arrays, MAX_POOLS if none
+    void*                       m_pFreeList;            //  Pool-wide free list (linked through the first word of each block)
+    std::list<BYTE*>            m_Slabs;
+    Statistics                  m_Statistics;
+
+    static FixedBlockPool*      m_pPools[MAX_POOLS];
+    static COUNT32              m_PoolCount;
+
+    void                        addSlab();
+    void                        drainThreadCache( ThreadCache* const    pCache,
+                                                  const COUNT32         blockCount );
+    void                        refillThreadCache( ThreadCache* const pCache );
+
+    static ThreadCache*         getThreadCache( const INDEX poolIndex );
+    static void                 threadExitHandler( void* pArg );
+
+    static inline void*         getNextLink( void* const pBlock )                   { return *static_cast<void**>(pBlock); }
+    static inline void          setNextLink( void* const pBlock, void* const pNext ){ *static_cast<void**>(pBlock) = pNext; }
+
+public:
+    FixedBlockPool( const std::string&  name,
+                    const COUNT         blockSize,
+                    const COUNT         blocksPerSlab = 128 );
+    ~FixedBlockPool();
+
+    void*                       allocate();
+    void                        dump( std::ostream&         stream,
+                                      const std::string&    prefix ) const;
+    Statistics                  getStatistics() const;
+    void                        release( void* const pBlock );
+
+    inline COUNT                getBlockSize() const                { return m_BlockSize; }
+    inline const std::string&   getName() const                     { return m_Name; }
+
+    static void                 dumpAll( std::ostream&          stream,
+                                         const std::string&     prefix );
+    static void                 getPools( std::vector<FixedBlockPool*>* const pContainer );
+};
+
+
+
+#endif
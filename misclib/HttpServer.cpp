@@ -6,8 +6,267 @@
 
 
 
+//  private methods
+
+//  dispatch()
+//
+//  Hands a request to whichever handler is registered for its path.
+//  We hold the lock throughout, so that unregisterHandler() cannot return while the handler is in use.
+void
+HttpServer::dispatch
+(
+    const Request&      request,
+    Response* const     pResponse
+)
+{
+    lock();
+    CITHANDLERS ith = m_Handlers.find( request.m_Path );
+    if ( ith == m_Handlers.end() )
+    {
+        pResponse->m_StatusCode = 404;
+        pResponse->m_Body = "Not Found\n";
+    }
+    else
+    {
+        ith->second->handleRequest( request, pResponse );
+    }
+    unlock();
+}
+
+
+//  parseRequest()
+//
+//  Extracts the next complete request (if there is one) from the client's input.
+//
+//  Returns:
+//      true if a request was extracted into pRequest
+//      false if there is not yet a complete request - or if the input is unacceptable, in which case
+//          we set *pErrorStatus to the HTTP status to be reported (it is otherwise left zero)
+bool
+HttpServer::parseRequest
+(
+    Client* const       pClient,
+    Request* const      pRequest,
+    int* const          pErrorStatus
+)
+{
+    *pErrorStatus = 0;
+    std::string& input = pClient->m_Input;
+
+    //  Tolerate stray line ends between requests
+    size_t start = input.find_first_not_of( "\r\n" );
+    if ( start == std::string::npos )
+    {
+        input.clear();
+        return false;
+    }
+    input.erase( 0, start );
+
+    size_t headerEnd = input.find( "\r\n\r\n" );
+    if ( headerEnd == std::string::npos )
+    {
+        if ( input.size() > MAX_HEADER_SIZE )
+            *pErrorStatus = 431;
+        return false;
+    }
+
+    //  Request line - method, target, version
+    std::stringstream strm( input.substr( 0, headerEnd ) );
+    std::string line;
+    std::getline( strm, line );
+    if ( !line.empty() && (line[line.size() - 1] == '\r') )
+        line.resize( line.size() - 1 );
+
+    std::stringstream lineStrm( line );
+    std::string target;
+    if ( !(lineStrm >> pRequest->m_Method >> target >> pRequest->m_Version)
+        || (pRequest->m_Version.compare( 0, 5, "HTTP/" ) != 0) )
+    {
+        *pErrorStatus = 400;
+        return false;
+    }
+
+    size_t queryx = target.find( '?' );
+    pRequest->m_Path = target.substr( 0, queryx );
+    pRequest->m_Query = (queryx == std::string::npos) ? "" : target.substr( queryx + 1 );
+
+    //  Headers
+    while ( std::getline( strm, line ) )
+    {
+        if ( !line.empty() && (line[line.size() - 1] == '\r') )
+            line.resize( line.size() - 1 );
+
+        size_t colonx = line.find( ':' );
+        if ( colonx == std::string::npos )
+        {
+            *pErrorStatus = 400;
+            return false;
+        }
+
+        SuperString name = line.substr( 0, colonx );
+        name.foldToLowerCase();
+        SuperString value = line.substr( colonx + 1 );
+        value.trimLeadingSpaces();
+        value.trimTrailingSpaces();
+        pRequest->m_Headers[name] = value;
+    }
+
+    //  Body, if any
+    if ( pRequest->m_Headers.find( "transfer-encoding" ) != pRequest->m_Headers.end() )
+    {
+        *pErrorStatus = 501;
+        return false;
+    }
+
+    COUNT bodySize = 0;
+    std::map<std::string, std::string>::const_iterator itcl = pRequest->m_Headers.find( "content-length" );
+    if ( itcl != pRequest->m_Headers.end() )
+    {
+        SuperString lengthStr = itcl->second;
+        if ( !lengthStr.isDecimalNumeric() )
+        {
+            *pErrorStatus = 400;
+            return false;
+        }
+
+        bodySize = lengthStr.toDecimal();
+        if ( bodySize > MAX_BODY_SIZE )
+        {
+            *pErrorStatus = 413;
+            return false;
+        }
+    }
+
+    size_t bodyStart = headerEnd + 4;
+    if ( input.size() < bodyStart + bodySize )
+        return false;
+
+    pRequest->m_Body = input.substr( bodyStart, bodySize );
+    input.erase( 0, bodyStart + bodySize );
+    return true;
+}
+
+
+//  sendResponse()
+//
+//  Formats a response and queues it for the client.  Responses to HEAD carry the headers, but no body.
+void
+HttpServer::sendResponse
+(
+    const int           clientSocket,
+    const Request&      request,
+    const Response&     response,
+    const bool          keepAlive
+)
+{
+    std::stringstream strm;
+    strm << "HTTP/1.1 " << std::dec << response.m_StatusCode << " " << getReasonPhrase( response.m_StatusCode ) << "\r\n"
+        << "Content-Type: " << response.m_ContentType << "\r\n"
+        << "Content-Length: " << response.m_Body.size() << "\r\n"
+        << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n";
+    for ( std::map<std::string, std::string>::const_iterator ith = response.m_Headers.begin();
+         ith != response.m_Headers.end(); ++ith )
+        strm << ith->first << ": " << ith->second << "\r\n";
+    strm << "\r\n";
+
+    if ( request.m_Method.compare( "HEAD" ) != 0 )
+        strm << response.m_Body;
+
+    std::string text = strm.str();
+    sendClientSocket( clientSocket, text.c_str(), text.size() );
+    if ( !keepAlive )
+        closeClientSocket( clientSocket );
+}
+
+
+
+//  private static methods
+
+//  getReasonPhrase()
+const char*
+HttpServer::getReasonPhrase
+(
+    const int           statusCode
+)
+{
+    switch ( statusCode )
+    {
+    case 200:   return "OK";
+    case 204:   return "No Content";
+    case 400:   return "Bad Request";
+    case 404:   return "Not Found";
+    case 405:   return "Method Not Allowed";
+    case 413:   return "Payload Too Large";
+    case 431:   return "Request Header Fields Too Large";
+    case 500:   return "Internal Server Error";
+    case 501:   return "Not Implemented";
+    case 503:   return "Service Unavailable";
+    }
+
+    return "Unknown";
+}
+
+
+
 //  protected methods
 
+//  handleInput()
+//
+//  NetServer has data from a client - accumulate it, and process each complete request it contains
+void
+HttpServer::handleInput
+(
+    const int           clientSocket,
+    const char* const   pData,
+    const COUNT         dataSize
+)
+{
+    Client& client = m_Clients[clientSocket];
+    client.m_Input.append( pData, dataSize );
+
+    while ( true )
+    {
+        Request request;
+        int errorStatus;
+        if ( !parseRequest( &client, &request, &errorStatus ) )
+        {
+            if ( errorStatus != 0 )
+            {
+                //  We cannot tell where the next request would begin, so this is the end of the conversation
+                Response response;
+                response.m_StatusCode = errorStatus;
+                response.m_Body = std::string( getReasonPhrase( errorStatus ) ) + "\n";
+                sendResponse( clientSocket, request, response, false );
+                client.m_Input.clear();
+            }
+            return;
+        }
+
+        //  HTTP/1.1 connections persist unless asked not to; HTTP/1.0 connections only if asked to
+        SuperString connection;
+        std::map<std::string, std::string>::const_iterator itc = request.m_Headers.find( "connection" );
+        if ( itc != request.m_Headers.end() )
+        {
+            connection = itc->second;
+            connection.foldToLowerCase();
+        }
+
+        bool keepAlive = (request.m_Version.compare( "HTTP/1.0" ) == 0)
+                         ? (connection.compare( "keep-alive" ) == 0)
+                         : (connection.compare( "close" ) != 0);
+
+        Response response;
+        dispatch( request, &response );
+        sendResponse( clientSocket, request, response, keepAlive );
+        if ( !keepAlive )
+        {
+            client.m_Input.clear();
+            return;
+        }
+    }
+}
+
+
 //  handleNewConnection()
 //
 //  NetServer has a new client for us to play with - set it up
@@ -17,5 +276,54 @@ HttpServer::handleNewConnection
     const int clientSocket
 )
 {
+    m_Clients[clientSocket] = Client();
+}
+
+
+//  handleSocketClosed()
+//
+//  A client has gone away
+void
+HttpServer::handleSocketClosed
+(
+    const int clientSocket
+)
+{
+    m_Clients.erase( clientSocket );
+}
+
+
+
+//  public methods
+
+//  registerHandler()
+//
+//  Arranges for requests for the given path to be handed to the given handler, which must remain valid
+//  until it is unregistered (or we are stopped).
+void
+HttpServer::registerHandler
+(
+    const std::string&  path,
+    Handler* const      pHandler
+)
+{
+    lock();
+    m_Handlers[path] = pHandler;
+    unlock();
+}
+
+
+//  unregisterHandler()
+//
+//  Stops dispatching requests for the given path.  Once we return, the handler is no longer in use.
+void
+HttpServer::unregisterHandler
+(
+    const std::string&  path
+)
+{
+    lock();
+    m_Handlers.erase( path );
+    unlock();
 }
 
@@ -1,4 +1,8 @@
 //  HttpServer derived from NetServer
+//
+//  A small HTTP/1.1 server.  Requests are dispatched by path to Handler objects registered via registerHandler();
+//  handlers run on the NetServer worker thread, so they should not dawdle.  Persistent connections and pipelined
+//  requests are supported; chunked request bodies are not.
 
 
 
@@ -10,16 +14,94 @@
 
 class   HttpServer : public NetServer
 {
+public:
+    class   Request
+    {
+    public:
+        std::string                         m_Body;
+        std::map<std::string, std::string>  m_Headers;      //  keyed by lower-case header name
+        std::string                         m_Method;
+        std::string                         m_Path;         //  without query string
+        std::string                         m_Query;
+        std::string                         m_Version;      //  e.g., "HTTP/1.1"
+    };
+
+    class   Response
+    {
+    public:
+        std::string                         m_Body;
+        std::string                         m_ContentType;
+        std::map<std::string, std::string>  m_Headers;      //  anything other than content type/length and connection
+        int                                 m_StatusCode;
+
+        Response()
+            :m_ContentType( "text/plain; charset=utf-8" ),
+            m_StatusCode( 200 )
+        {}
+    };
+
+    class   Handler
+    {
+    public:
+        virtual ~Handler(){}
+        virtual void                handleRequest( const Request&   request,
+                                                   Response* const  pResponse ) = 0;
+    };
+
+private:
+    class   Client
+    {
+    public:
+        std::string                 m_Input;            //  received, not yet consumed by a request
+    };
+
+    typedef     std::map<int, Client>                   CLIENTS;
+    typedef     CLIENTS::iterator                       ITCLIENTS;
+
+    typedef     std::map<std::string, Handler*>         HANDLERS;
+    typedef     HANDLERS::iterator                      ITHANDLERS;
+    typedef     HANDLERS::const_iterator                CITHANDLERS;
+
+    CLIENTS                         m_Clients;          //  only touched on the worker thread
+    HANDLERS                        m_Handlers;         //  protected by lock()
+
+    static const COUNT              MAX_BODY_SIZE = 64 * 1024;
+    static const COUNT              MAX_HEADER_SIZE = 8 * 1024;
+
+    void                            dispatch( const Request&    request,
+                                              Response* const   pResponse );
+    bool                            parseRequest( Client* const     pClient,
+                                                  Request* const    pRequest,
+                                                  int* const        pErrorStatus );
+    void                            sendResponse( const int         clientSocket,
+                                                  const Request&    request,
+                                                  const Response&   response,
+                                                  const bool        keepAlive );
+
+    static const char*              getReasonPhrase( const int statusCode );
+
 protected:
-//    void            handleNewConnection( const int clientSocket ) override;
-    
-    
+    void                            handleInput( const int          clientSocket,
+                                                 const char* const  pData,
+                                                 const COUNT        dataSize ) override;
+    void                            handleNewConnection( const int clientSocket ) override;
+    void                            handleSocketClosed( const int clientSocket ) override;
+
 public:
     HttpServer( const std::string&  workerName,
                 const long          listenAddress,
                 const short         listenPort )
     :NetServer( workerName, listenAddress, listenPort )
     {}
+
+    HttpServer( const std::string&  workerName,
+                const short         listenPort )
+    :NetServer( workerName, listenPort )
+    {}
+
+    void                            registerHandler( const std::string& path,
+                                                     Handler* const     pHandler );
+    void                            unregisterHandler( const std::string& path );
 };
 
 
@@ -0,0 +1,172 @@
+//  LatencyHistogram implementation
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "misclib.h"
+
+
+
+//  constructors, destructors
+
+LatencyHistogram::LatencyHistogram()
+    :m_MaxMicros( 0 ),
+    m_TotalMicros( 0 )
+{
+    for ( INDEX bx = 0; bx < BUCKET_COUNT; ++bx )
+        m_Buckets[bx] = 0;
+}
+
+
+
+//  private static methods
+
+//  getBucketIndex()
+//
+//  Finds the bucket for a value - values which are too large go in the last bucket
+INDEX
+LatencyHistogram::getBucketIndex
+(
+    const COUNT64       micros
+)
+{
+    if ( micros < SUB_BUCKET_COUNT )
+        return static_cast<INDEX>(micros);
+
+    COUNT magnitude = 0;
+    for ( COUNT64 temp = micros; temp > 1; temp >>= 1 )
+        ++magnitude;
+    if ( magnitude >= MAX_MAGNITUDE )
+        return BUCKET_COUNT - 1;
+
+    //  The top SUB_BUCKET_BITS + 1 bits of the value (the first of which is always set) pick the sub-bucket
+    COUNT64 mantissa = micros >> (magnitude - SUB_BUCKET_BITS);
+    return (magnitude - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + static_cast<INDEX>(mantissa - SUB_BUCKET_COUNT);
+}
+
+
+//  getBucketUpperBound()
+//
+//  Retrieves the largest value which belongs in the given bucket
+COUNT64
+LatencyHistogram::getBucketUpperBound
+(
+    const INDEX         index
+)
+{
+    if ( index < SUB_BUCKET_COUNT )
+        return index;
+
+    COUNT shift = index / SUB_BUCKET_COUNT - 1;
+    COUNT64 mantissa = SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+
+
+//  public methods
+
+//  Snapshot::getPercentileMicros()
+//
+//  Retrieves the value below which the given percentage (0.0 to 100.0) of the recorded values fall.
+//  The result is the upper bound of the containing bucket, but never more than the largest value recorded.
+COUNT64
+LatencyHistogram::Snapshot::getPercentileMicros
+(
+    const double        percentile
+) const
+{
+    if ( m_Count == 0 )
+        return 0;
+
+    COUNT64 target = static_cast<COUNT64>( (percentile / 100.0) * m_Count + 0.5 );
+    if ( target == 0 )
+        target = 1;
+
+    COUNT64 cumulative = 0;
+    for ( INDEX bx = 0; bx < m_Buckets.size(); ++bx )
+    {
+        cumulative += m_Buckets[bx];
+        if ( cumulative >= target )
+        {
+            COUNT64 bound = getBucketUpperBound( bx );
+            return (bound < m_MaxMicros) ? bound : m_MaxMicros;
+        }
+    }
+
+    return m_MaxMicros;
+}
+
+
+//  getSnapshot()
+//
+//  Copies out the current counts.  Records made while we are copying may or may not be included.
+LatencyHistogram::Snapshot
+LatencyHistogram::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.m_Buckets.resize( BUCKET_COUNT );
+    snapshot.m_Count = 0;
+    for ( INDEX bx = 0; bx < BUCKET_COUNT; ++bx )
+    {
+        snapshot.m_Buckets[bx] = m_Buckets[bx].load( std::memory_order_relaxed );
+        snapshot.m_Count += snapshot.m_Buckets[bx];
+    }
+
+    snapshot.m_MaxMicros = m_MaxMicros.load( std::memory_order_relaxed );
+    snapshot.m_TotalMicros = m_TotalMicros.load( std::memory_order_relaxed );
+    return snapshot;
+}
+
+
+//  record()
+//
+//  Counts one occurrence of the given duration
+void
+LatencyHistogram::record
+(
+    const COUNT64       micros
+)
+{
+    m_Buckets[getBucketIndex( micros )].fetch_add( 1, std::memory_order_relaxed );
+    m_TotalMicros.fetch_add( micros, std::memory_order_relaxed );
+    COUNT64 max = m_MaxMicros.load( std::memory_order_relaxed );
+    while ( (micros > max) && !m_MaxMicros.compare_exchange_weak( max, micros, std::memory_order_relaxed ) )
+    {}
+}
+
+
+//  reset()
+//
+//  Discards everything recorded so far
+void
+LatencyHistogram::reset()
+{
+    for ( INDEX bx = 0; bx < BUCKET_COUNT; ++bx )
+        m_Buckets[bx].store( 0, std::memory_order_relaxed );
+    m_MaxMicros.store( 0, std::memory_order_relaxed );
+    m_TotalMicros.store( 0, std::memory_order_relaxed );
+}
+
+
+
+//  public static methods
+
+//  getDurationString()
+//
+//  Formats a duration compactly for console display - e.g., 850US, 12MS, 3S
+std::string
+LatencyHistogram::getDurationString
+(
+    const COUNT64       micros
+)
+{
+    std::stringstream strm;
+    if ( micros < 10000 )
+        strm << micros << "US";
+    else if ( micros < 10000000 )
+        strm << micros / 1000 << "MS";
+    else
+        strm << micros / 1000000 << "S";
+    return strm.str();
+}
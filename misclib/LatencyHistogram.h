@@ -0,0 +1,71 @@
+//  LatencyHistogram.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  A fixed-size log-linear histogram of durations, in microseconds, in the manner of HdrHistogram.
+//  Values below 16 have a bucket each; above that, each power of two is split into 16 buckets,
+//  so any percentile we report is within about 6% of the true value.
+//  Recording is lock-free (a few relaxed atomic increments), so it can be done from any thread
+//  on the IO path; readers take a Snapshot, which is consistent enough for operator display.
+
+
+
+#ifndef     MISCLIB_LATENCY_HISTOGRAM_H
+#define     MISCLIB_LATENCY_HISTOGRAM_H
+
+
+
+class   LatencyHistogram
+{
+private:
+    static const COUNT          SUB_BUCKET_BITS = 4;
+    static const COUNT          SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const COUNT          MAX_MAGNITUDE = 40;     //  values are clamped below 2^40 microseconds (about 12 days)
+    static const COUNT          BUCKET_COUNT = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+public:
+    class   Snapshot
+    {
+    public:
+        std::vector<COUNT64>    m_Buckets;
+        COUNT64                 m_Count;
+        COUNT64                 m_MaxMicros;
+        COUNT64                 m_TotalMicros;
+
+        Snapshot()
+            :m_Count( 0 ),
+            m_MaxMicros( 0 ),
+            m_TotalMicros( 0 )
+        {}
+
+        COUNT64                 getPercentileMicros( const double percentile ) const;
+
+        inline COUNT64          getMeanMicros() const           { return m_Count ? m_TotalMicros / m_Count : 0; }
+    };
+
+private:
+    std::atomic<COUNT64>        m_Buckets[BUCKET_COUNT];
+    std::atomic<COUNT64>        m_MaxMicros;
+    std::atomic<COUNT64>        m_TotalMicros;
+
+    static INDEX                getBucketIndex( const COUNT64 micros );
+    static COUNT64              getBucketUpperBound( const INDEX index );
+
+public:
+    LatencyHistogram();
+
+    Snapshot                    getSnapshot() const;
+    void                        record( const COUNT64 micros );
+    void                        reset();
+
+    static std::string          getDurationString( const COUNT64 micros );
+
+    static inline COUNT64 getMicroseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>
+                ( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+};
+
+
+
+#endif
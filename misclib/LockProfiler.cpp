@@ -0,0 +1,298 @@
+//  LockProfile and LockProfiler class implementations
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "misclib.h"
+
+
+
+#if MISCLIB_LOCK_PROFILING
+
+//  statics
+
+LockProfiler*           LockProfiler::m_pInstance = 0;
+
+static std::once_flag   profilerOnce;
+
+
+
+//  LockProfile
+
+//  private statics
+
+//  getBucket()
+INDEX
+LockProfile::getBucket
+(
+    const COUNT64       nanoseconds
+)
+{
+    INDEX bucket = 0;
+    COUNT64 value = nanoseconds;
+    while ( (value > 1) && (bucket < BUCKET_COUNT - 1) )
+    {
+        value >>= 1;
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+
+
+//  constructors, destructors
+
+LockProfile::LockProfile()
+    :m_Name( "(unnamed)" ),
+    m_HoldDepth( 0 ),
+    m_pHoldFile( 0 ),
+    m_HoldLine( 0 ),
+    m_HoldStartNSecs( 0 )
+{
+    for ( INDEX bx = 0; bx < BUCKET_COUNT; ++bx )
+    {
+        m_HoldHistogram[bx] = 0;
+        m_WaitHistogram[bx] = 0;
+    }
+
+    m_Totals.m_Acquisitions = 0;
+    m_Totals.m_Contentions = 0;
+    m_Totals.m_TotalWaitNSecs = 0;
+    m_Totals.m_MaxWaitNSecs = 0;
+    m_Totals.m_TotalHoldNSecs = 0;
+
+    LockProfiler::getInstance()->registerProfile( this );
+}
+
+
+LockProfile::~LockProfile()
+{
+    LockProfiler::getInstance()->unregisterProfile( this );
+}
+
+
+
+//  public methods
+
+//  dump()
+//
+//  Totals, non-empty histogram buckets, and call sites in descending order of time spent waiting
+void
+LockProfile::dump
+(
+    std::ostream&       stream,
+    const std::string&  prefix
+) const
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+
+    stream << prefix << m_Name
+        << "  Acq=" << std::dec << m_Totals.m_Acquisitions
+        << "  Contended=" << m_Totals.m_Contentions
+        << "  Wait=" << m_Totals.m_TotalWaitNSecs / 1000 << "us"
+        << "  MaxWait=" << m_Totals.m_MaxWaitNSecs / 1000 << "us"
+        << "  Held=" << m_Totals.m_TotalHoldNSecs / 1000 << "us"
+        << std::endl;
+
+    stream << prefix << "  Wait / Hold histogram (ns):" << std::endl;
+    for ( INDEX bx = 0; bx < BUCKET_COUNT; ++bx )
+    {
+        if ( m_WaitHistogram[bx] || m_HoldHistogram[bx] )
+        {
+            stream << prefix << "    >=" << std::setw( 11 ) << std::setfill( ' ' ) << (bx == 0 ? 0 : (1ULL << bx))
+                << "  Wait:" << std::setw( 10 ) << m_WaitHistogram[bx]
+                << "  Hold:" << std::setw( 10 ) << m_HoldHistogram[bx]
+                << std::endl;
+        }
+    }
+
+    std::multimap<COUNT64, const CallSite*> bySite;
+    for ( CITCALLSITES itcs = m_CallSites.begin(); itcs != m_CallSites.end(); ++itcs )
+        bySite.insert( std::make_pair( itcs->second.m_TotalWaitNSecs, &itcs->second ) );
+
+    stream << prefix << "  Call sites:" << std::endl;
+    for ( std::multimap<COUNT64, const CallSite*>::const_reverse_iterator its = bySite.rbegin(); its != bySite.rend(); ++its )
+    {
+        const CallSite* pSite = its->second;
+        stream << prefix << "    " << pSite->m_pFile << ":" << pSite->m_Line
+            << "  Acq=" << pSite->m_Acquisitions
+            << "  Contended=" << pSite->m_Contentions
+            << "  Wait=" << pSite->m_TotalWaitNSecs / 1000 << "us"
+            << "  Held=" << pSite->m_TotalHoldNSecs / 1000 << "us"
+            << std::endl;
+    }
+}
+
+
+//  getSummary()
+LockProfile::Summary
+LockProfile::getSummary() const
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    Summary summary = m_Totals;
+    summary.m_Name = m_Name;
+    return summary;
+}
+
+
+//  recordAcquisition()
+//
+//  Invoked by the lock, once the lock has been acquired.
+//  For exclusive acquisitions, we note the call site and time so that recordRelease() can attribute the hold time.
+void
+LockProfile::recordAcquisition
+(
+    const char* const   pFile,
+    const UINT32        line,
+    const bool          contended,
+    const COUNT64       waitNSecs,
+    const bool          exclusive
+)
+{
+    if ( exclusive && (m_HoldDepth++ == 0) )
+    {
+        m_pHoldFile = pFile;
+        m_HoldLine = line;
+        m_HoldStartNSecs = LockStatistics::getNanoseconds();
+    }
+
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    CallSite& site = m_CallSites[CALLSITEKEY( pFile, line )];
+    site.m_pFile = pFile;
+    site.m_Line = line;
+    ++site.m_Acquisitions;
+    ++m_Totals.m_Acquisitions;
+    ++m_WaitHistogram[getBucket( waitNSecs )];
+    if ( contended )
+    {
+        ++site.m_Contentions;
+        site.m_TotalWaitNSecs += waitNSecs;
+        ++m_Totals.m_Contentions;
+        m_Totals.m_TotalWaitNSecs += waitNSecs;
+        if ( waitNSecs > m_Totals.m_MaxWaitNSecs )
+            m_Totals.m_MaxWaitNSecs = waitNSecs;
+    }
+}
+
+
+//  recordRelease()
+//
+//  Invoked by the lock just before an exclusive release, while still held
+void
+LockProfile::recordRelease()
+{
+    if ( --m_HoldDepth > 0 )
+        return;
+
+    COUNT64 holdNSecs = LockStatistics::getNanoseconds() - m_HoldStartNSecs;
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    m_CallSites[CALLSITEKEY( m_pHoldFile, m_HoldLine )].m_TotalHoldNSecs += holdNSecs;
+    m_Totals.m_TotalHoldNSecs += holdNSecs;
+    ++m_HoldHistogram[getBucket( holdNSecs )];
+}
+
+
+//  setName()
+void
+LockProfile::setName
+(
+    const std::string&  name
+)
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    m_Name = name;
+}
+
+
+
+//  LockProfiler
+
+//  public methods
+
+//  dump()
+//
+//  Dumps the topCount profiles with the most total wait time (all of them, if topCount is zero)
+void
+LockProfiler::dump
+(
+    std::ostream&       stream,
+    const std::string&  prefix,
+    const COUNT         topCount
+)
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    std::multimap<COUNT64, const LockProfile*> byWait;
+    for ( std::set<LockProfile*>::const_iterator itp = m_Profiles.begin(); itp != m_Profiles.end(); ++itp )
+        byWait.insert( std::make_pair( (*itp)->getSummary().m_TotalWaitNSecs, *itp ) );
+
+    stream << prefix << "Lock Profile (" << std::dec << m_Profiles.size() << " locks)" << std::endl;
+    COUNT count = 0;
+    for ( std::multimap<COUNT64, const LockProfile*>::const_reverse_iterator itp = byWait.rbegin();
+          (itp != byWait.rend()) && ((topCount == 0) || (count < topCount)); ++itp, ++count )
+        itp->second->dump( stream, prefix + "  " );
+}
+
+
+//  getTopContended()
+//
+//  Retrieves summaries for the topCount profiles with the most total wait time
+void
+LockProfiler::getTopContended
+(
+    const COUNT                         topCount,
+    std::vector<LockProfile::Summary>*  pSummaries
+)
+{
+    pSummaries->clear();
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    std::multimap<COUNT64, LockProfile::Summary> byWait;
+    for ( std::set<LockProfile*>::const_iterator itp = m_Profiles.begin(); itp != m_Profiles.end(); ++itp )
+    {
+        LockProfile::Summary summary = (*itp)->getSummary();
+        if ( summary.m_Contentions > 0 )
+            byWait.insert( std::make_pair( summary.m_TotalWaitNSecs, summary ) );
+    }
+
+    for ( std::multimap<COUNT64, LockProfile::Summary>::const_reverse_iterator itp = byWait.rbegin();
+          (itp != byWait.rend()) && (pSummaries->size() < topCount); ++itp )
+        pSummaries->push_back( itp->second );
+}
+
+
+//  registerProfile()
+void
+LockProfiler::registerProfile
+(
+    LockProfile* const  pProfile
+)
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    m_Profiles.insert( pProfile );
+}
+
+
+//  unregisterProfile()
+void
+LockProfiler::unregisterProfile
+(
+    LockProfile* const  pProfile
+)
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    m_Profiles.erase( pProfile );
+}
+
+
+
+//  public statics
+
+//  getInstance()
+LockProfiler*
+LockProfiler::getInstance()
+{
+    std::call_once( profilerOnce, [](){ m_pInstance = new LockProfiler(); } );
+    return m_pInstance;
+}
+
+#endif
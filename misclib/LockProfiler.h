@@ -0,0 +1,145 @@
+//  LockProfiler.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Opt-in lock profiling, enabled by building with MISCLIB_LOCK_PROFILING set to 1.
+//  Each Lockable / SharedLockable then owns a LockProfile which records, for every acquisition, how long the
+//  caller waited and (for exclusive acquisitions) how long the lock was held, bucketed into power-of-two
+//  nanosecond histograms and broken down by acquiring call site.  Owners name their locks via
+//  MISCLIB_SET_LOCK_NAME(), and LockProfiler keeps the set of all live profiles so that the most contended
+//  can be reported.
+//
+//  When profiling is not enabled, none of the profiling code is compiled, and MISCLIB_SET_LOCK_NAME() does
+//  not evaluate its argument.  Locking still costs a try-lock ahead of each blocking acquisition, so that
+//  contentions can be counted (see LockStatistics.h).
+
+
+
+#ifndef     MISCLIB_LOCK_PROFILER_H
+#define     MISCLIB_LOCK_PROFILER_H
+
+
+
+#if MISCLIB_LOCK_PROFILING
+
+//  Call site of the code invoking lock(), captured via default arguments
+#if defined(__GNUC__)
+#define     MISCLIB_CALLER_FILE     __builtin_FILE()
+#define     MISCLIB_CALLER_LINE     __builtin_LINE()
+#else
+#define     MISCLIB_CALLER_FILE     "?"
+#define     MISCLIB_CALLER_LINE     0
+#endif
+
+
+
+class   LockProfile
+{
+public:
+    static const COUNT          BUCKET_COUNT = 32;      //  bucket n counts times in [2^n, 2^(n+1)) nanoseconds
+
+    class   CallSite
+    {
+    public:
+        const char*             m_pFile;
+        UINT32                  m_Line;
+        COUNT64                 m_Acquisitions;
+        COUNT64                 m_Contentions;
+        COUNT64                 m_TotalWaitNSecs;
+        COUNT64                 m_TotalHoldNSecs;
+
+        CallSite()
+            :m_pFile( 0 ),
+            m_Line( 0 ),
+            m_Acquisitions( 0 ),
+            m_Contentions( 0 ),
+            m_TotalWaitNSecs( 0 ),
+            m_TotalHoldNSecs( 0 )
+        {}
+    };
+
+    class   Summary
+    {
+    public:
+        std::string             m_Name;
+        COUNT64                 m_Acquisitions;
+        COUNT64                 m_Contentions;
+        COUNT64                 m_TotalWaitNSecs;
+        COUNT64                 m_MaxWaitNSecs;
+        COUNT64                 m_TotalHoldNSecs;
+    };
+
+private:
+    typedef     std::pair<const char*, UINT32>          CALLSITEKEY;
+    typedef     std::map<CALLSITEKEY, CallSite>         CALLSITES;
+    typedef     CALLSITES::const_iterator               CITCALLSITES;
+
+    CALLSITES                   m_CallSites;
+    COUNT64                     m_HoldHistogram[BUCKET_COUNT];
+    mutable std::mutex          m_Mutex;
+    std::string                 m_Name;
+    Summary                     m_Totals;
+    COUNT64                     m_WaitHistogram[BUCKET_COUNT];
+
+    //  Current exclusive holder - only touched by the thread holding the lock
+    COUNT                       m_HoldDepth;
+    const char*                 m_pHoldFile;
+    UINT32                      m_HoldLine;
+    COUNT64                     m_HoldStartNSecs;
+
+    static INDEX                getBucket( const COUNT64 nanoseconds );
+
+public:
+    LockProfile();
+    ~LockProfile();
+
+    void                        dump( std::ostream&         stream,
+                                      const std::string&    prefix ) const;
+    Summary                     getSummary() const;
+    void                        recordAcquisition( const char* const    pFile,
+                                                   const UINT32         line,
+                                                   const bool           contended,
+                                                   const COUNT64        waitNSecs,
+                                                   const bool           exclusive );
+    void                        recordRelease();
+    void                        setName( const std::string& name );
+};
+
+
+
+class   LockProfiler
+{
+private:
+    std::mutex                  m_Mutex;
+    std::set<LockProfile*>      m_Profiles;
+
+    static LockProfiler*        m_pInstance;
+
+    LockProfiler(){}
+
+public:
+    void                        dump( std::ostream&         stream,
+                                      const std::string&    prefix,
+                                      const COUNT           topCount );
+    void                        getTopContended( const COUNT                        topCount,
+                                                 std::vector<LockProfile::Summary>* pSummaries );
+    void                        registerProfile( LockProfile* const pProfile );
+    void                        unregisterProfile( LockProfile* const pProfile );
+
+    static LockProfiler*        getInstance();
+};
+
+#endif
+
+
+
+//  Names the lock of the Lockable or SharedLockable whose member function (or constructor) invokes it.
+//  A macro, so that the name is not built at all when profiling is not enabled.
+#if MISCLIB_LOCK_PROFILING
+#define     MISCLIB_SET_LOCK_NAME( name )   setLockName( name )
+#else
+#define     MISCLIB_SET_LOCK_NAME( name )   ((void) 0)
+#endif
+
+
+
+#endif
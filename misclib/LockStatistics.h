@@ -0,0 +1,104 @@
+//  LockStatistics.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Contention counters shared by Lockable, SharedLockable, and SpinLockable.
+//  Only an acquisition which actually has to wait is counted and timed, so the uncontended path writes
+//  nothing shared - a per-lock acquisition counter would bounce one cache line between every reader of
+//  a SharedLockable.  Acquisitions are counted only when building with MISCLIB_LOCK_PROFILING.
+
+
+
+#ifndef     MISCLIB_LOCK_STATISTICS_H
+#define     MISCLIB_LOCK_STATISTICS_H
+
+
+
+class   LockStatistics
+{
+public:
+    class   Snapshot
+    {
+    public:
+#if MISCLIB_LOCK_PROFILING
+        COUNT64                 m_Acquisitions;         //  Exclusive acquisitions (including recursive ones)
+        COUNT64                 m_SharedAcquisitions;   //  Shared acquisitions
+#endif
+        COUNT64                 m_Contentions;          //  Acquisitions which had to wait
+        COUNT64                 m_TotalWaitNSecs;       //  Total time spent waiting, over all contentions
+        COUNT64                 m_MaxWaitNSecs;         //  Longest single wait
+
+        Snapshot()
+            :
+#if MISCLIB_LOCK_PROFILING
+            m_Acquisitions( 0 ),
+            m_SharedAcquisitions( 0 ),
+#endif
+            m_Contentions( 0 ),
+            m_TotalWaitNSecs( 0 ),
+            m_MaxWaitNSecs( 0 )
+        {}
+    };
+
+private:
+#if MISCLIB_LOCK_PROFILING
+    std::atomic<COUNT64>        m_Acquisitions;
+    std::atomic<COUNT64>        m_SharedAcquisitions;
+#endif
+    std::atomic<COUNT64>        m_Contentions;
+    std::atomic<COUNT64>        m_TotalWaitNSecs;
+    std::atomic<COUNT64>        m_MaxWaitNSecs;
+
+public:
+    LockStatistics()
+        :
+#if MISCLIB_LOCK_PROFILING
+        m_Acquisitions( 0 ),
+        m_SharedAcquisitions( 0 ),
+#endif
+        m_Contentions( 0 ),
+        m_TotalWaitNSecs( 0 ),
+        m_MaxWaitNSecs( 0 )
+    {}
+
+#if MISCLIB_LOCK_PROFILING
+    inline void recordAcquisition( const bool shared )
+    {
+        if ( shared )
+            m_SharedAcquisitions.fetch_add( 1, std::memory_order_relaxed );
+        else
+            m_Acquisitions.fetch_add( 1, std::memory_order_relaxed );
+    }
+#endif
+
+    inline void recordContention( const COUNT64 waitNSecs )
+    {
+        m_Contentions.fetch_add( 1, std::memory_order_relaxed );
+        m_TotalWaitNSecs.fetch_add( waitNSecs, std::memory_order_relaxed );
+        COUNT64 max = m_MaxWaitNSecs.load( std::memory_order_relaxed );
+        while ( (waitNSecs > max) && !m_MaxWaitNSecs.compare_exchange_weak( max, waitNSecs, std::memory_order_relaxed ) )
+        {}
+    }
+
+    inline Snapshot getSnapshot() const
+    {
+        Snapshot snapshot;
+#if MISCLIB_LOCK_PROFILING
+        snapshot.m_Acquisitions = m_Acquisitions.load( std::memory_order_relaxed );
+        snapshot.m_SharedAcquisitions = m_SharedAcquisitions.load( std::memory_order_relaxed );
+#endif
+        snapshot.m_Contentions = m_Contentions.load( std::memory_order_relaxed );
+        snapshot.m_TotalWaitNSecs = m_TotalWaitNSecs.load( std::memory_order_relaxed );
+        snapshot.m_MaxWaitNSecs = m_MaxWaitNSecs.load( std::memory_order_relaxed );
+        return snapshot;
+    }
+
+    static inline COUNT64 getNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>
+                ( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+};
+
+
+
+#endif
@@ -5,6 +5,10 @@
 //  Uses a pointer to a std::recursive_mutex because:
 //      a thread may recurse on locking
 //      Implementing classes may have many getting methods which need to lock, but should be otherwise const
+//
+//  See SharedLockable for classes whose getters are hot enough to warrant reader/writer locking,
+//  and SpinLockable for very short critical sections.
+//  Owners may name the lock via MISCLIB_SET_LOCK_NAME(), for the benefit of lock profiling (see LockProfiler.h).
 
 
 
@@ -13,15 +17,28 @@
 
 
 
+#include    "LockProfiler.h"
+#include    "LockStatistics.h"
+
+
+
 class   Lockable
 {
 private:
     std::recursive_mutex*   m_pMutex;
+    LockStatistics*         m_pStatistics;
+#if MISCLIB_LOCK_PROFILING
+    LockProfile*            m_pProfile;
+#endif
 
 protected:
     Lockable()
     {
         m_pMutex = new std::recursive_mutex;
+        m_pStatistics = new LockStatistics;
+#if MISCLIB_LOCK_PROFILING
+        m_pProfile = new LockProfile;
+#endif
     }
 
 public:
@@ -29,14 +46,62 @@ public:
     {
         delete m_pMutex;
         m_pMutex = 0;
+        delete m_pStatistics;
+        m_pStatistics = 0;
+#if MISCLIB_LOCK_PROFILING
+        delete m_pProfile;
+        m_pProfile = 0;
+#endif
     }
 
-    inline void     lock() const        { m_pMutex->lock(); }
+#if MISCLIB_LOCK_PROFILING
+    inline void lock( const char* const pFile = MISCLIB_CALLER_FILE,
+                      const UINT32      line = MISCLIB_CALLER_LINE ) const
+#else
+    inline void lock() const
+#endif
+    {
+        COUNT64 waitNSecs = 0;
+        bool contended = !m_pMutex->try_lock();
+        if ( contended )
+        {
+            COUNT64 startNSecs = LockStatistics::getNanoseconds();
+            m_pMutex->lock();
+            waitNSecs = LockStatistics::getNanoseconds() - startNSecs;
+            m_pStatistics->recordContention( waitNSecs );
+        }
+#if MISCLIB_LOCK_PROFILING
+        m_pStatistics->recordAcquisition( false );
+        m_pProfile->recordAcquisition( pFile, line, contended, waitNSecs, true );
+#endif
+    }
+
+#if MISCLIB_LOCK_PROFILING
+    inline bool try_lock( const char* const pFile = MISCLIB_CALLER_FILE,
+                          const UINT32      line = MISCLIB_CALLER_LINE ) const
+    {
+        if ( !m_pMutex->try_lock() )
+            return false;
+        m_pStatistics->recordAcquisition( false );
+        m_pProfile->recordAcquisition( pFile, line, false, 0, true );
+        return true;
+    }
+
+    inline void unlock() const
+    {
+        m_pProfile->recordRelease();
+        m_pMutex->unlock();
+    }
+
+    inline void     setLockName( const std::string& name )  { m_pProfile->setName( name ); }
+#else
     inline bool     try_lock() const    { return m_pMutex->try_lock(); }
     inline void     unlock() const      { m_pMutex->unlock(); }
+#endif
+
+    inline LockStatistics::Snapshot getLockStatistics() const   { return m_pStatistics->getSnapshot(); }
 };
 
 
 
 #endif
-
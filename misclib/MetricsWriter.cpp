@@ -0,0 +1,199 @@
+//  MetricsWriter.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "misclib.h"
+
+
+
+//  statics
+
+const char* const   MetricsWriter::CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+
+
+//  private methods
+
+//  writeName()
+//
+//  Writes the metric name and label set which begin a sample line
+void
+MetricsWriter::writeName
+(
+    const std::string&  name,
+    const LABELS&       labels
+)
+{
+    m_Stream << name;
+    if ( labels.empty() )
+        return;
+
+    m_Stream << "{";
+    for ( CITLABELS itl = labels.begin(); itl != labels.end(); ++itl )
+    {
+        if ( itl != labels.begin() )
+            m_Stream << ",";
+        m_Stream << itl->first << "=\"" << escapeLabelValue( itl->second ) << "\"";
+    }
+    m_Stream << "}";
+}
+
+
+
+//  private statics
+
+//  escapeHelp()
+//
+//  HELP text may not contain raw backslashes or line feeds
+std::string
+MetricsWriter::escapeHelp
+(
+    const std::string&  text
+)
+{
+    std::string result;
+    for ( INDEX tx = 0; tx < text.size(); ++tx )
+    {
+        if ( text[tx] == '\\' )
+            result += "\\\\";
+        else if ( text[tx] == '\n' )
+            result += "\\n";
+        else
+            result += text[tx];
+    }
+    return result;
+}
+
+
+//  escapeLabelValue()
+//
+//  As escapeHelp(), but double quotes must be escaped as well
+std::string
+MetricsWriter::escapeLabelValue
+(
+    const std::string&  text
+)
+{
+    std::string result;
+    for ( INDEX tx = 0; tx < text.size(); ++tx )
+    {
+        if ( text[tx] == '\\' )
+            result += "\\\\";
+        else if ( text[tx] == '\n' )
+            result += "\\n";
+        else if ( text[tx] == '"' )
+            result += "\\\"";
+        else
+            result += text[tx];
+    }
+    return result;
+}
+
+
+
+//  constructors, destructors
+
+MetricsWriter::MetricsWriter()
+{
+    m_Stream << std::setprecision( 9 );
+}
+
+
+
+//  public methods
+
+//  describe()
+//
+//  Begins a metric family
+void
+MetricsWriter::describe
+(
+    const std::string&  name,
+    const Type          type,
+    const std::string&  help
+)
+{
+    m_Stream << "# HELP " << name << " " << escapeHelp( help ) << "\n"
+        << "# TYPE " << name << " " << getTypeString( type ) << "\n";
+}
+
+
+//  writeSample()
+//
+//  Writes an integral sample - counters, mostly
+void
+MetricsWriter::writeSample
+(
+    const std::string&  name,
+    const LABELS&       labels,
+    const COUNT64       value
+)
+{
+    writeName( name, labels );
+    m_Stream << " " << std::dec << value << "\n";
+}
+
+
+//  writeSample()
+//
+//  Writes a floating-point sample
+void
+MetricsWriter::writeSample
+(
+    const std::string&  name,
+    const LABELS&       labels,
+    const double        value
+)
+{
+    writeName( name, labels );
+    m_Stream << " " << value << "\n";
+}
+
+
+//  writeSummary()
+//
+//  Writes the samples for a summary (the quantiles, _sum, and _count), in seconds
+void
+MetricsWriter::writeSummary
+(
+    const std::string&                  name,
+    const LABELS&                       labels,
+    const LatencyHistogram::Snapshot&   snapshot
+)
+{
+    static const double quantiles[] = { 0.5, 0.9, 0.99 };
+    for ( INDEX qx = 0; qx < sizeof( quantiles ) / sizeof( quantiles[0] ); ++qx )
+    {
+        std::stringstream strm;
+        strm << quantiles[qx];
+        LABELS quantileLabels = labels;
+        quantileLabels.push_back( std::make_pair( "quantile", strm.str() ) );
+        writeSample( name, quantileLabels, snapshot.getPercentileMicros( quantiles[qx] * 100.0 ) / 1000000.0 );
+    }
+
+    writeSample( name + "_sum", labels, snapshot.m_TotalMicros / 1000000.0 );
+    writeSample( name + "_count", labels, snapshot.m_Count );
+}
+
+
+
+//  public statics
+
+//  getTypeString()
+const char*
+MetricsWriter::getTypeString
+(
+    const Type          type
+)
+{
+    switch ( type )
+    {
+    case TYPE_COUNTER:  return "counter";
+    case TYPE_GAUGE:    return "gauge";
+    case TYPE_SUMMARY:  return "summary";
+    }
+
+    return "untyped";
+}
+
@@ -0,0 +1,72 @@
+//  MetricsWriter.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Accumulates metrics in the Prometheus text exposition format (version 0.0.4).
+//  Each metric family is begun with describe(), which emits its HELP and TYPE lines, and is followed by all of
+//  its samples - the format requires the samples of a family to be contiguous.
+//  Latencies are published as summaries, in seconds, from LatencyHistogram snapshots.
+
+
+
+#ifndef     MISCLIB_METRICS_WRITER_H
+#define     MISCLIB_METRICS_WRITER_H
+
+
+
+#include    "LatencyHistogram.h"
+
+
+
+class   MetricsWriter
+{
+public:
+    enum Type
+    {
+        TYPE_COUNTER,
+        TYPE_GAUGE,
+        TYPE_SUMMARY,
+    };
+
+    typedef std::vector<std::pair<std::string, std::string>>    LABELS;
+    typedef LABELS::const_iterator                              CITLABELS;
+
+    static const char* const    CONTENT_TYPE;
+
+private:
+    std::stringstream           m_Stream;
+
+    void                        writeName( const std::string&   name,
+                                           const LABELS&        labels );
+
+    static std::string          escapeHelp( const std::string& text );
+    static std::string          escapeLabelValue( const std::string& text );
+
+public:
+    MetricsWriter();
+
+    void                        describe( const std::string&    name,
+                                          const Type            type,
+                                          const std::string&    help );
+    void                        writeSample( const std::string& name,
+                                             const LABELS&      labels,
+                                             const COUNT64      value );
+    void                        writeSample( const std::string& name,
+                                             const LABELS&      labels,
+                                             const double       value );
+    void                        writeSummary( const std::string&                    name,
+                                              const LABELS&                         labels,
+                                              const LatencyHistogram::Snapshot&     snapshot );
+
+    inline std::string          getText() const                         { return m_Stream.str(); }
+    inline void                 writeSample( const std::string& name,
+                                             const COUNT64      value ) { writeSample( name, LABELS(), value ); }
+    inline void                 writeSample( const std::string& name,
+                                             const double       value ) { writeSample( name, LABELS(), value ); }
+
+    static const char*          getTypeString( const Type type );
+};
+
+
+
+#endif
+
@@ -8,9 +8,99 @@
 
 //  private methods
 
+//  acceptConnections()
+//
+//  The listen socket is readable - accept every connection which is waiting.
+//  Connections beyond MAX_CONNECTIONS are closed immediately.
+void
+NetServer::acceptConnections
+(
+    const int       listenSocket
+)
+{
+    while ( true )
+    {
+        int clientSocket = accept( listenSocket, 0, 0 );
+        if ( clientSocket < 0 )
+        {
+            if ( (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR) )
+            {
+                std::stringstream strm;
+                strm << "NetServer " << getWorkerName() << " accept() failed:" << errno << ":" << strerror( errno );
+                SystemLog::write( strm.str() );
+            }
+            return;
+        }
+
+        lock();
+        bool full = m_Connections.size() >= MAX_CONNECTIONS;
+        unlock();
+
+        if ( full || !setNonBlocking( clientSocket ) )
+        {
+            close( clientSocket );
+            continue;
+        }
+
+        lock();
+        m_Connections[clientSocket] = Connection();
+        unlock();
+
+        handleNewConnection( clientSocket );
+    }
+}
+
+
+//  dropConnection()
+//
+//  Closes a client socket and forgets about it, then lets the derived class know
+void
+NetServer::dropConnection
+(
+    const int       clientSocket
+)
+{
+    lock();
+    m_Connections.erase( clientSocket );
+    unlock();
+
+    close( clientSocket );
+    handleSocketClosed( clientSocket );
+}
+
+
+//  readClientSocket()
+//
+//  A client socket is readable - read whatever is there, and pass it on to the derived class.
+//
+//  Returns:
+//      false if the client has closed the connection, or the socket has failed
+bool
+NetServer::readClientSocket
+(
+    const int       clientSocket
+)
+{
+    char buffer[READ_BUFFER_SIZE];
+    while ( true )
+    {
+        ssize_t bytes = recv( clientSocket, buffer, sizeof( buffer ), 0 );
+        if ( bytes > 0 )
+        {
+            handleInput( clientSocket, buffer, static_cast<COUNT>(bytes) );
+            continue;
+        }
+
+        if ( bytes == 0 )
+            return false;
+        return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR);
+    }
+}
+
+
 //  worker()
 //
-//  Sits on the indicated port and accepts connections
+//  Sits on the indicated port, accepts connections, and moves data to and from the client sockets
 void
 NetServer::worker()
 {
@@ -24,13 +114,18 @@ NetServer::worker()
         return;
     }
 
+    //  Allow a quick restart, without waiting out TIME_WAIT on the previous incarnation's connections
+    int reuse = 1;
+    setsockopt( listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof( reuse ) );
+
     //  Create socketAddressIn
     struct sockaddr_in socketAddressIn;
     int socketAddressSize = sizeof( sockaddr_in );
 
+    memset( &socketAddressIn, 0, sizeof( socketAddressIn ) );
     socketAddressIn.sin_family = AF_INET;
     socketAddressIn.sin_addr.s_addr = htonl( m_ListenAddress );
-    socketAddressIn.sin_port = ntohs( m_ListenPort );
+    socketAddressIn.sin_port = htons( m_ListenPort );
 
     //  Bind
     if ( bind( listenSocket, reinterpret_cast<struct sockaddr *>( &socketAddressIn ), socketAddressSize ) < 0 )
@@ -43,7 +138,7 @@ NetServer::worker()
     }
 
     //  Set up listen
-    if ( listen( listenSocket, BACKLOG ) < 0 )
+    if ( !setNonBlocking( listenSocket ) || (listen( listenSocket, BACKLOG ) < 0) )
     {
         std::stringstream strm;
         strm << "NetServer " << Worker::getWorkerName() << " Cannot listen on socket";
@@ -52,70 +147,154 @@ NetServer::worker()
         return;
     }
 
-    //  Set up container to hold all the client sockets for open connections
-    std::list<int> clientSockets;
-
     //  Now loop listening for incoming connections on the listen socket,
-    //  and incoming data on any registered client sockets.
+    //  and incoming data (or room for outgoing data) on the client sockets.
+    std::vector<struct pollfd> pollStructs;
     while ( !isWorkerTerminating() )
     {
-        //  Set up poll
-        int socketCount = 1 + clientSockets.size();
-        struct pollfd* pPollStructs = new struct pollfd[socketCount];
+        //  Set up poll - we only ask about writability for sockets which have output queued.
+        //  Sockets which are to be closed, and have nothing left to write, are closed here.
+        std::vector<int> closingSockets;
+        pollStructs.clear();
 
-        pPollStructs[0].fd = listenSocket;
-        pPollStructs[0].events = POLLIN | POLLPRI;
-        pPollStructs[0].revents = 0;
+        struct pollfd listenPoll;
+        listenPoll.fd = listenSocket;
+        listenPoll.events = POLLIN;
+        listenPoll.revents = 0;
+        pollStructs.push_back( listenPoll );
 
-        int px = 1;
-        for ( auto itcs = clientSockets.begin(); itcs != clientSockets.end(); ++itcs )
+        lock();
+        for ( CITCONNECTIONS itc = m_Connections.begin(); itc != m_Connections.end(); ++itc )
         {
-            pPollStructs[px].fd = *itcs;
-            pPollStructs[px].events = POLLIN | POLLPRI | POLLRDHUP;
-            pPollStructs[px].revents = 0;
-            ++px;
+            if ( itc->second.m_CloseRequested && itc->second.m_Output.empty() )
+            {
+                closingSockets.push_back( itc->first );
+                continue;
+            }
+
+            struct pollfd clientPoll;
+            clientPoll.fd = itc->first;
+            clientPoll.events = POLLIN | POLLRDHUP;
+            if ( !itc->second.m_Output.empty() )
+                clientPoll.events |= POLLOUT;
+            clientPoll.revents = 0;
+            pollStructs.push_back( clientPoll );
         }
+        unlock();
+
+        for ( INDEX cx = 0; cx < closingSockets.size(); ++cx )
+            dropConnection( closingSockets[cx] );
 
-        //  Poll for anything, waiting for up to 5000ms
-        int pollResult = poll( pPollStructs, socketCount, 5000 );
+        //  Poll for anything
+        int pollResult = poll( &pollStructs[0], pollStructs.size(), POLL_MILLISECONDS );
         if ( pollResult < 0 )
         {
+            if ( errno == EINTR )
+                continue;
+
             std::stringstream strm;
             strm << "NetServer poll() failed:" << errno << ":" << strerror( errno );
             SystemLog::write( strm.str() );
-
-            delete[] pPollStructs;
             break;
         }
 
         //  Go see what there is to do (if anything)
-        for ( px = 0; px < socketCount; ++px )
+        if ( pollStructs[0].revents & POLLIN )
+            acceptConnections( listenSocket );
+
+        for ( INDEX px = 1; px < pollStructs.size(); ++px )
         {
-            if ( pPollStructs[px].revents & POLLIN )
-            {
-                //???? for listen socket, a connect is ready
-                //  for other sockets, read is ready
-                std::cout << "px=" << px << ":POLLIN" << std::endl;//????
-            }
-            else if ( pPollStructs[px].revents & POLLPRI )
-            {
-                std::cout << "px=" << px << ":POLLPRI" << std::endl;//????
-            }
-            else if ( pPollStructs[px].revents & POLLRDHUP )
-            {
-                std::cout << "px=" << px << ":POLLRDHUP" << std::endl;//????
-            }
-        }
+            int clientSocket = pollStructs[px].fd;
+            short revents = pollStructs[px].revents;
+            bool ok = true;
 
-        delete[] pPollStructs;
+            if ( revents & (POLLERR | POLLNVAL) )
+                ok = false;
+            if ( ok && (revents & POLLOUT) )
+                ok = writeClientSocket( clientSocket );
+            if ( ok && (revents & POLLIN) )
+                ok = readClientSocket( clientSocket );
+            if ( ok && (revents & (POLLRDHUP | POLLHUP)) && !(revents & POLLIN) )
+                ok = false;
+
+            if ( !ok )
+                dropConnection( clientSocket );
+        }
     }
 
-    //???? how to close client sockets / conversations?
+    //  Close down all the conversations
+    lock();
+    std::vector<int> clientSockets;
+    for ( CITCONNECTIONS itc = m_Connections.begin(); itc != m_Connections.end(); ++itc )
+        clientSockets.push_back( itc->first );
+    unlock();
+
+    for ( INDEX cx = 0; cx < clientSockets.size(); ++cx )
+        dropConnection( clientSockets[cx] );
 
     close( listenSocket );
 }
 
 
+//  writeClientSocket()
+//
+//  Writes as much queued output for the given client as the socket will take.
+//
+//  Returns:
+//      false if the socket has failed
+bool
+NetServer::writeClientSocket
+(
+    const int       clientSocket
+)
+{
+    lock();
+    ITCONNECTIONS itc = m_Connections.find( clientSocket );
+    if ( itc == m_Connections.end() )
+    {
+        unlock();
+        return true;
+    }
+
+    std::string& output = itc->second.m_Output;
+    bool result = true;
+    while ( !output.empty() )
+    {
+        ssize_t bytes = send( clientSocket, output.c_str(), output.size(), MSG_NOSIGNAL );
+        if ( bytes < 0 )
+        {
+            result = (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR);
+            break;
+        }
+
+        output.erase( 0, bytes );
+    }
+
+    unlock();
+    return result;
+}
+
+
+
+//  private statics
+
+//  setNonBlocking()
+//
+//  Puts a socket into non-blocking mode
+bool
+NetServer::setNonBlocking
+(
+    const int       socket
+)
+{
+    int flags = fcntl( socket, F_GETFL, 0 );
+    return (flags >= 0) && (fcntl( socket, F_SETFL, flags | O_NONBLOCK ) == 0);
+}
+
+
+
+//  constructors, destructors
+
 NetServer::NetServer
 (
     const std::string&   workerName,
@@ -145,3 +324,58 @@ NetServer::~NetServer()
 {
 };
 
+
+
+//  public methods
+
+//  closeClientSocket()
+//
+//  Closes the connection to the given client, once any output queued for it has been written.
+//
+//  Returns:
+//      false if there is no such client
+bool
+NetServer::closeClientSocket
+(
+    const int           clientSocket
+)
+{
+    lock();
+    ITCONNECTIONS itc = m_Connections.find( clientSocket );
+    bool found = itc != m_Connections.end();
+    if ( found )
+        itc->second.m_CloseRequested = true;
+    unlock();
+
+    return found;
+}
+
+
+//  sendClientSocket()
+//
+//  Queues output for the given client, and writes as much of it as we can right away.
+//  Whatever the socket will not yet take, the worker writes as the socket becomes writable.
+//
+//  Returns:
+//      false if there is no such client, or we have already been asked to close it
+bool
+NetServer::sendClientSocket
+(
+    const int           clientSocket,
+    const char* const   pData,
+    const COUNT         dataSize
+)
+{
+    lock();
+    ITCONNECTIONS itc = m_Connections.find( clientSocket );
+    bool found = (itc != m_Connections.end()) && !itc->second.m_CloseRequested;
+    if ( found )
+    {
+        itc->second.m_Output.append( pData, dataSize );
+        writeClientSocket( clientSocket );
+    }
+    unlock();
+
+    return found;
+}
+
@@ -1,4 +1,10 @@
 //  NetServer header file, describing a base class for more-specific handlers
+//
+//  A NetServer listens on a TCP port, and services all of its client connections from the one worker thread,
+//  using non-blocking sockets and poll().  Derived classes are told of new connections, incoming data, and
+//  closed connections via the handle*() methods, which are always invoked on the worker thread.
+//  Output is queued via sendClientSocket() and written as the socket can accept it; closeClientSocket()
+//  closes the connection once any queued output has been written.
 
 
 
@@ -15,20 +21,48 @@
 class   NetServer : public Worker, public Lockable
 {
 private:
+    class   Connection
+    {
+    public:
+        bool                m_CloseRequested;       //  close once m_Output is written
+        std::string         m_Output;               //  queued, not yet written
+
+        Connection()
+            :m_CloseRequested( false )
+        {}
+    };
+
+    typedef     std::map<int, Connection>   CONNECTIONS;        //  keyed by client socket
+    typedef     CONNECTIONS::iterator       ITCONNECTIONS;
+    typedef     CONNECTIONS::const_iterator CITCONNECTIONS;
+
+    CONNECTIONS             m_Connections;
     const ulong             m_ListenAddress;
     const short             m_ListenPort;
 
-    static const int        BACKLOG = 3;
+    static const int        BACKLOG = 16;
+    static const COUNT      MAX_CONNECTIONS = 64;
+    static const int        POLL_MILLISECONDS = 250;    //  bounds the delay in noticing workerStop()
+    static const COUNT      READ_BUFFER_SIZE = 4096;
 
+    void                    acceptConnections( const int listenSocket );
+    void                    dropConnection( const int clientSocket );
+    bool                    readClientSocket( const int clientSocket );
+    bool                    writeClientSocket( const int clientSocket );
     void                    worker() override;
 
+    static bool             setNonBlocking( const int socket );
+
 protected:
-//    virtual void            handleInput( const int clientSocket ) = 0;//????
-//    virtual void            handleNewConnection( const int clientSocket ) = 0;
-//    virtual void            handleSocketClosed( const int clientSocket ) = 0;//????
+    //  We spend our time blocked on sockets, which the VirtualClock cannot see
+    bool                    isWorkerClockParticipant() const override   { return false; }
+
+    virtual void            handleInput( const int          clientSocket,
+                                         const char* const  pData,
+                                         const COUNT        dataSize ) = 0;
+    virtual void            handleNewConnection( const int clientSocket )   {}
+    virtual void            handleSocketClosed( const int clientSocket )    {}
 
-public:
-    //???? c'tors should be protected - not prot now due to testing
     NetServer( const std::string&   workerName,
                const ulong          listenAddress,
                const short          listenPort );
@@ -36,12 +70,15 @@ public:
     NetServer( const std::string&       workerName,
                const short              listenPort );
 
+public:
     virtual ~NetServer();
 
-//    bool                    closeClientSocket( const int clientSocket );
-//    bool                    sendClientSocket( const int         clientSocket,
-//                                              const char* const pData,
-//                                              const int         dataSize );
+    bool                    closeClientSocket( const int clientSocket );
+    bool                    sendClientSocket( const int         clientSocket,
+                                              const char* const pData,
+                                              const COUNT       dataSize );
+
+    inline short            getListenPort() const       { return m_ListenPort; }
 };
 
 
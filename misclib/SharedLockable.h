@@ -0,0 +1,248 @@
+//  SharedLockable.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Reader/writer counterpart to Lockable.
+//  lock() / unlock() take the lock exclusively, exactly as Lockable does, so a class can switch from
+//  Lockable to SharedLockable without touching its writers; getters then use lockShared() / unlockShared()
+//  so that they may run concurrently with each other.
+//
+//  The exclusive lock is recursive, and a thread holding it may also take the shared lock (it is simply
+//  counted as another level of exclusive ownership).  The reverse is NOT true - a thread holding only the
+//  shared lock must not ask for the exclusive lock, as it will deadlock.  Nor should a thread take the shared
+//  lock recursively, as a waiting writer may be preferred over the second acquisition on some platforms.
+//
+//  With lock profiling enabled, hold times are recorded for exclusive ownership only.
+
+
+
+#ifndef     MISCLIB_SHARED_LOCKABLE_H
+#define     MISCLIB_SHARED_LOCKABLE_H
+
+
+
+#include    "LockProfiler.h"
+#include    "LockStatistics.h"
+
+
+
+class   SharedLockable
+{
+private:
+    //  Everything lives on the heap, so that const getters may lock (as for Lockable)
+    class   LockState
+    {
+    public:
+#ifdef WIN32
+        SRWLOCK                         m_Lock;
+#else
+        pthread_rwlock_t                m_Lock;
+#endif
+        std::atomic<std::thread::id>    m_ExclusiveOwner;
+        COUNT                           m_ExclusiveDepth;       //  Only touched by the exclusive owner
+        LockStatistics                  m_Statistics;
+#if MISCLIB_LOCK_PROFILING
+        LockProfile                     m_Profile;
+#endif
+
+        LockState()
+            :m_ExclusiveOwner( std::thread::id() ),
+            m_ExclusiveDepth( 0 )
+        {
+#ifdef WIN32
+            InitializeSRWLock( &m_Lock );
+#else
+            pthread_rwlock_init( &m_Lock, 0 );
+#endif
+        }
+
+        ~LockState()
+        {
+#ifndef WIN32
+            pthread_rwlock_destroy( &m_Lock );
+#endif
+        }
+    };
+
+    LockState*              m_pState;
+
+    inline bool isOwnedByMe() const
+    {
+        return m_pState->m_ExclusiveOwner.load( std::memory_order_relaxed ) == std::this_thread::get_id();
+    }
+
+    inline void becomeOwner() const
+    {
+        m_pState->m_ExclusiveOwner.store( std::this_thread::get_id(), std::memory_order_relaxed );
+        m_pState->m_ExclusiveDepth = 1;
+    }
+
+protected:
+    SharedLockable()
+    {
+        m_pState = new LockState;
+    }
+
+public:
+    ~SharedLockable()
+    {
+        delete m_pState;
+        m_pState = 0;
+    }
+
+#if MISCLIB_LOCK_PROFILING
+    inline void lock( const char* const pFile = MISCLIB_CALLER_FILE,
+                      const UINT32      line = MISCLIB_CALLER_LINE ) const
+#else
+    inline void lock() const
+#endif
+    {
+        COUNT64 waitNSecs = 0;
+        bool contended = false;
+        if ( isOwnedByMe() )
+        {
+            ++m_pState->m_ExclusiveDepth;
+        }
+        else
+        {
+#ifdef WIN32
+            contended = !TryAcquireSRWLockExclusive( &m_pState->m_Lock );
+            if ( contended )
+            {
+                COUNT64 startNSecs = LockStatistics::getNanoseconds();
+                AcquireSRWLockExclusive( &m_pState->m_Lock );
+                waitNSecs = LockStatistics::getNanoseconds() - startNSecs;
+            }
+#else
+            contended = pthread_rwlock_trywrlock( &m_pState->m_Lock ) != 0;
+            if ( contended )
+            {
+                COUNT64 startNSecs = LockStatistics::getNanoseconds();
+                pthread_rwlock_wrlock( &m_pState->m_Lock );
+                waitNSecs = LockStatistics::getNanoseconds() - startNSecs;
+            }
+#endif
+            if ( contended )
+                m_pState->m_Statistics.recordContention( waitNSecs );
+            becomeOwner();
+        }
+
+#if MISCLIB_LOCK_PROFILING
+        m_pState->m_Statistics.recordAcquisition( false );
+        m_pState->m_Profile.recordAcquisition( pFile, line, contended, waitNSecs, true );
+#endif
+    }
+
+#if MISCLIB_LOCK_PROFILING
+    inline bool try_lock( const char* const pFile = MISCLIB_CALLER_FILE,
+                          const UINT32      line = MISCLIB_CALLER_LINE ) const
+#else
+    inline bool try_lock() const
+#endif
+    {
+        if ( isOwnedByMe() )
+        {
+            ++m_pState->m_ExclusiveDepth;
+        }
+        else
+        {
+#ifdef WIN32
+            if ( !TryAcquireSRWLockExclusive( &m_pState->m_Lock ) )
+                return false;
+#else
+            if ( pthread_rwlock_trywrlock( &m_pState->m_Lock ) != 0 )
+                return false;
+#endif
+            becomeOwner();
+        }
+
+#if MISCLIB_LOCK_PROFILING
+        m_pState->m_Statistics.recordAcquisition( false );
+        m_pState->m_Profile.recordAcquisition( pFile, line, false, 0, true );
+#endif
+        return true;
+    }
+
+    inline void unlock() const
+    {
+        assert( isOwnedByMe() );
+#if MISCLIB_LOCK_PROFILING
+        m_pState->m_Profile.recordRelease();
+#endif
+        if ( --m_pState->m_ExclusiveDepth == 0 )
+        {
+            m_pState->m_ExclusiveOwner.store( std::thread::id(), std::memory_order_relaxed );
+#ifdef WIN32
+            ReleaseSRWLockExclusive( &m_pState->m_Lock );
+#else
+            pthread_rwlock_unlock( &m_pState->m_Lock );
+#endif
+        }
+    }
+
+#if MISCLIB_LOCK_PROFILING
+    inline void lockShared( const char* const   pFile = MISCLIB_CALLER_FILE,
+                            const UINT32        line = MISCLIB_CALLER_LINE ) const
+#else
+    inline void lockShared() const
+#endif
+    {
+        COUNT64 waitNSecs = 0;
+        bool contended = false;
+        bool exclusive = isOwnedByMe();
+        if ( exclusive )
+        {
+            ++m_pState->m_ExclusiveDepth;
+        }
+        else
+        {
+#ifdef WIN32
+            contended = !TryAcquireSRWLockShared( &m_pState->m_Lock );
+            if ( contended )
+            {
+                COUNT64 startNSecs = LockStatistics::getNanoseconds();
+                AcquireSRWLockShared( &m_pState->m_Lock );
+                waitNSecs = LockStatistics::getNanoseconds() - startNSecs;
+            }
+#else
+            contended = pthread_rwlock_tryrdlock( &m_pState->m_Lock ) != 0;
+            if ( contended )
+            {
+                COUNT64 startNSecs = LockStatistics::getNanoseconds();
+                pthread_rwlock_rdlock( &m_pState->m_Lock );
+                waitNSecs = LockStatistics::getNanoseconds() - startNSecs;
+            }
+#endif
+            if ( contended )
+                m_pState->m_Statistics.recordContention( waitNSecs );
+        }
+
+#if MISCLIB_LOCK_PROFILING
+        m_pState->m_Statistics.recordAcquisition( true );
+        m_pState->m_Profile.recordAcquisition( pFile, line, contended, waitNSecs, exclusive );
+#endif
+    }
+
+    inline void unlockShared() const
+    {
+        if ( isOwnedByMe() )
+        {
+            unlock();
+            return;
+        }
+
+#ifdef WIN32
+        ReleaseSRWLockShared( &m_pState->m_Lock );
+#else
+        pthread_rwlock_unlock( &m_pState->m_Lock );
+#endif
+    }
+
+    inline LockStatistics::Snapshot getLockStatistics() const   { return m_pState->m_Statistics.getSnapshot(); }
+#if MISCLIB_LOCK_PROFILING
+    inline void     setLockName( const std::string& name )      { m_pState->m_Profile.setName( name ); }
+#endif
+};
+
+
+
+#endif
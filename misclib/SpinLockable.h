@@ -0,0 +1,83 @@
+//  SpinLockable.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Spinning counterpart to Lockable, for critical sections which are only a handful of instructions long
+//  (queue pushes and pops and the like).  It is NOT recursive, and nothing which might block may be done
+//  while holding it.  After a short burst of spinning, a waiter yields its time slice between attempts.
+
+
+
+#ifndef     MISCLIB_SPIN_LOCKABLE_H
+#define     MISCLIB_SPIN_LOCKABLE_H
+
+
+
+#include    "LockStatistics.h"
+
+
+
+class   SpinLockable
+{
+private:
+    static const COUNT      SPINS_BEFORE_YIELD = 64;
+
+    //  On the heap, so that const getters may lock (as for Lockable)
+    std::atomic_flag*       m_pFlag;
+    LockStatistics*         m_pStatistics;
+
+protected:
+    SpinLockable()
+    {
+        m_pFlag = new std::atomic_flag;
+        m_pFlag->clear();
+        m_pStatistics = new LockStatistics;
+    }
+
+public:
+    ~SpinLockable()
+    {
+        delete m_pFlag;
+        m_pFlag = 0;
+        delete m_pStatistics;
+        m_pStatistics = 0;
+    }
+
+    inline void lock() const
+    {
+        if ( m_pFlag->test_and_set( std::memory_order_acquire ) )
+        {
+            COUNT64 startNSecs = LockStatistics::getNanoseconds();
+            COUNT spins = 0;
+            while ( m_pFlag->test_and_set( std::memory_order_acquire ) )
+            {
+                if ( ++spins >= SPINS_BEFORE_YIELD )
+                {
+                    std::this_thread::yield();
+                    spins = 0;
+                }
+            }
+            m_pStatistics->recordContention( LockStatistics::getNanoseconds() - startNSecs );
+        }
+#if MISCLIB_LOCK_PROFILING
+        m_pStatistics->recordAcquisition( false );
+#endif
+    }
+
+    inline LockStatistics::Snapshot getLockStatistics() const   { return m_pStatistics->getSnapshot(); }
+#if MISCLIB_LOCK_PROFILING
+    inline bool try_lock() const
+    {
+        if ( m_pFlag->test_and_set( std::memory_order_acquire ) )
+            return false;
+        m_pStatistics->recordAcquisition( false );
+        return true;
+    }
+#else
+    inline bool     try_lock() const    { return !m_pFlag->test_and_set( std::memory_order_acquire ); }
+#endif
+    inline void     unlock() const      { m_pFlag->clear( std::memory_order_release ); }
+};
+
+
+
+#endif
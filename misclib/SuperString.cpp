@@ -70,6 +70,20 @@ SuperString::convertWhiteSpace()
 }
 
 
+//  foldToLowerCase()
+//
+//  converts all uppercase to lowercase
+void
+SuperString::foldToLowerCase()
+{
+    for ( INDEX sx = 0; sx < size(); ++sx )
+    {
+        if ( isupper( (*this)[sx] ) )
+            (*this)[sx] = static_cast<char>(tolower( (*this)[sx] ));
+    }
+}
+
+
 //  foldToUpperCase()
 //
 //  converts all lowercase to uppercase
@@ -18,6 +18,7 @@ public:
 
     int             compareNoCase( const std::string& value ) const;
     void            convertWhiteSpace();
+    void            foldToLowerCase();
     void            foldToUpperCase();
     bool            isDecimalNumeric() const;
     void            trimLeadingSpaces();
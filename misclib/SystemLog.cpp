@@ -7,23 +7,369 @@
 
 
 
+#ifdef  WIN32
+#define     LOG_THREAD_LOCAL    __declspec(thread)
+#else
+#define     LOG_THREAD_LOCAL    __thread
+#endif
+
+
+
 //  statics
 
 SystemLog*  SystemLog::m_pInstance = 0;
 
+const COUNT32   SystemLog::FLUSH_MILLISECONDS;
+
+static LOG_THREAD_LOCAL UINT32  currentThreadId;
+
+static const char* const        CategoryNames[SystemLog::CATEGORY_COUNT] =
+{
+    "GENERAL",
+    "CHANNEL",
+    "CONSOLE",
+    "DEVICE",
+    "EXEC",
+    "FACILITIES",
+    "IO",
+    "MFD",
+    "NETWORK",
+    "WORKER",
+};
+
+static const char* const        LevelNames[SystemLog::LEVEL_OFF + 1] =
+{
+    "TRACE",
+    "DEBUG",
+    "INFO",
+    "WARNING",
+    "ERROR",
+    "OFF",
+};
+
 
 
 //	private, protected methods
 
+//  drain()
+//
+//  Moves every filled slot (in order, stopping at the first which is not yet filled) into the buffer,
+//  one line per entry, writing the buffer out whenever it reaches FLUSH_BYTES.  Writer thread only.
+//
+//  Returns:
+//      number of entries drained
+COUNT
+    SystemLog::drain
+    (
+    std::string* const      pBuffer
+    )
+{
+    COUNT count = 0;
+    COUNT64 position = m_DequeuePosition.load( std::memory_order_relaxed );
+    while ( true )
+    {
+        Slot* pSlot = &m_pSlots[position & (QUEUE_SIZE - 1)];
+        if ( pSlot->m_Sequence.load( std::memory_order_acquire ) != position + 1 )
+            break;
+
+        formatEntry( pBuffer, pSlot->m_TimeMicros, pSlot->m_ThreadId, pSlot->m_Level, pSlot->m_Category, pSlot->m_Text );
+        pSlot->m_Text.clear();
+        pSlot->m_Sequence.store( position + QUEUE_SIZE, std::memory_order_release );
+        m_DequeuePosition.store( ++position, std::memory_order_relaxed );
+        ++count;
+
+        if ( pBuffer->size() >= FLUSH_BYTES )
+        {
+            writeBatch( *pBuffer );
+            pBuffer->clear();
+        }
+    }
+
+    return count;
+}
+
+
+//  formatEntry()
+//
+//  Appends one line to the buffer, in the current format.  Writer thread only.
+void
+    SystemLog::formatEntry
+    (
+    std::string* const      pBuffer,
+    const INT64             timeMicros,
+    const UINT32            threadId,
+    const Level             level,
+    const Category          category,
+    const std::string&      text
+    ) const
+{
+    time_t seconds = static_cast<time_t>( timeMicros / 1000000 );
+    struct tm localTime;
+#ifdef WIN32
+    localtime_s( &localTime, &seconds );
+#else
+    localtime_r( &seconds, &localTime );
+#endif
+
+    char timeStamp[64];
+    snprintf( timeStamp,
+              sizeof( timeStamp ),
+              "%04d-%02d-%02d %02d:%02d:%02d.%06d",
+              localTime.tm_year + 1900,
+              localTime.tm_mon + 1,
+              localTime.tm_mday,
+              localTime.tm_hour,
+              localTime.tm_min,
+              localTime.tm_sec,
+              static_cast<int>( timeMicros % 1000000 ) );
+
+    std::stringstream strm;
+    if ( m_Format.load( std::memory_order_relaxed ) == FORMAT_JSON )
+    {
+        strm << "{\"ts\":\"" << timeStamp << "\""
+            << ",\"tid\":" << threadId
+            << ",\"level\":\"" << LevelNames[level] << "\""
+            << ",\"category\":\"" << CategoryNames[category] << "\""
+            << ",\"msg\":" << getJsonString( text ) << "}";
+    }
+    else
+    {
+        strm << timeStamp << " " << std::setw( 6 ) << threadId
+            << " " << std::left << std::setw( 7 ) << LevelNames[level]
+            << " " << std::setw( 10 ) << CategoryNames[category] << " " << text;
+    }
+
+    pBuffer->append( strm.str() );
+    pBuffer->push_back( '\n' );
+}
+
+
+//  isRotationDue()
+//
+//  Call under m_Mutex, from the writer thread
+bool
+    SystemLog::isRotationDue() const
+{
+    if ( (m_RotateBytes > 0) && (m_FileSize >= m_RotateBytes) )
+        return true;
+    return m_RotateDaily && (getCurrentDay() != m_FileDay);
+}
+
+
+//  rotate()
+//
+//  Renames the current file with a time stamp suffix, and starts a new one.  If the rename fails,
+//  we carry on appending to the current file rather than lose its content.  Writer thread only.
+void
+    SystemLog::rotate()
+{
+    SystemTime* pLocalTime = SystemTime::createLocalSystemTime();
+    std::string timeStamp = pLocalTime->getTimeStamp();
+    delete pLocalTime;
+
+    //  Do not clobber a file rotated earlier in the same second
+    std::string rotatedName = m_FileName + "." + timeStamp;
+    struct stat statBuffer;
+    for ( INDEX suffix = 1; stat( rotatedName.c_str(), &statBuffer ) == 0; ++suffix )
+    {
+        std::stringstream strm;
+        strm << m_FileName << "." << timeStamp << "-" << suffix;
+        rotatedName = strm.str();
+    }
+
+    m_pStream->close();
+    bool renamed = std::rename( m_FileName.c_str(), rotatedName.c_str() ) == 0;
+    m_pStream->open( m_FileName, renamed ? std::ios::out | std::ios::trunc : std::ios::out | std::ios::app );
+
+    //  If the rename failed, we do not try again until the file has grown by another rotation's worth
+    m_FileDay = getCurrentDay();
+    m_FileSize = 0;
+    if ( renamed )
+    {
+        std::lock_guard<std::mutex> guard( m_Mutex );
+        ++m_Statistics.m_RotationCount;
+    }
+    else
+    {
+        std::cerr << "SystemLog cannot rename " << m_FileName << " to " << rotatedName << std::endl;
+    }
+}
+
+
+//  writeBatch()
+//
+//  Writes a batch of entries to the file.  Writer thread only.
+void
+    SystemLog::writeBatch
+    (
+    const std::string&      buffer
+    )
+{
+    m_pStream->write( buffer.c_str(), buffer.size() );
+    m_FileSize += buffer.size();
+
+    COUNT entries = std::count( buffer.begin(), buffer.end(), '\n' );
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    m_Statistics.m_WrittenBytes += buffer.size();
+    m_Statistics.m_WrittenCount += entries;
+}
+
+
+//  writerLoop()
+//
+//  Main loop for the writer thread.  Wakes up every FLUSH_MILLISECONDS (or when prodded), writes whatever
+//  is in the ring, and flushes the file.  On a flush() request, or on termination, it keeps going until
+//  it has everything which was queued before the request - even entries whose writers have claimed a slot
+//  but not quite finished filling it.
+void
+    SystemLog::writerLoop()
+{
+    std::string buffer;
+    std::unique_lock<std::mutex> lock( m_Mutex );
+    while ( true )
+    {
+        if ( !m_TermFlag && (m_FlushCompleted == m_FlushRequested) )
+            m_Condition.wait_for( lock, std::chrono::milliseconds( FLUSH_MILLISECONDS ) );
+
+        bool termFlag = m_TermFlag;
+        COUNT64 flushRequested = m_FlushRequested;
+        COUNT64 target = (termFlag || (flushRequested != m_FlushCompleted))
+                         ? m_EnqueuePosition.load( std::memory_order_acquire ) : 0;
+        lock.unlock();
+
+        COUNT64 fileSize = m_FileSize;
+
+        COUNT64 dropped = m_DroppedCount.load( std::memory_order_relaxed );
+        if ( dropped != m_ReportedDropCount )
+        {
+            std::stringstream strm;
+            strm << "SystemLog dropped " << (dropped - m_ReportedDropCount) << " entries - ring was full";
+            INT64 now = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch() ).count();
+            formatEntry( &buffer, now, getCurrentThreadId(), LEVEL_WARNING, CATEGORY_GENERAL, strm.str() );
+            m_ReportedDropCount = dropped;
+        }
+
+        drain( &buffer );
+        while ( m_DequeuePosition.load( std::memory_order_relaxed ) < target )
+        {
+            std::this_thread::yield();
+            drain( &buffer );
+        }
+
+        if ( !buffer.empty() )
+        {
+            writeBatch( buffer );
+            buffer.clear();
+        }
+
+        bool wroteSomething = m_FileSize != fileSize;
+        if ( wroteSomething )
+            m_pStream->flush();
+
+        lock.lock();
+        if ( wroteSomething )
+            ++m_Statistics.m_FlushCount;
+        if ( isRotationDue() )
+        {
+            lock.unlock();
+            rotate();
+            lock.lock();
+        }
+
+        m_FlushCompleted = flushRequested;
+        m_FlushCondition.notify_all();
+        if ( termFlag )
+            break;
+    }
+}
+
+
+
+//  private statics
+
+//  getCurrentDay()
+UINT32
+    SystemLog::getCurrentDay()
+{
+    SystemTime* pLocalTime = SystemTime::createLocalSystemTime();
+    UINT32 day = pLocalTime->getDay();
+    delete pLocalTime;
+    return day;
+}
+
+
+//  getCurrentThreadId()
+//
+//  Host thread id of the caller - the one shown by top, ps, and the debugger.
+UINT32
+    SystemLog::getCurrentThreadId()
+{
+    if ( currentThreadId == 0 )
+    {
+#ifdef WIN32
+        currentThreadId = static_cast<UINT32>( GetCurrentThreadId() );
+#else
+        currentThreadId = static_cast<UINT32>( syscall( SYS_gettid ) );
+#endif
+    }
+
+    return currentThreadId;
+}
+
+
+//  getJsonString()
+//
+//  Quotes and escapes a string for JSON
+std::string
+    SystemLog::getJsonString
+    (
+    const std::string&      value
+    )
+{
+    std::stringstream strm;
+    strm << "\"";
+    for ( INDEX cx = 0; cx < value.size(); ++cx )
+    {
+        char ch = value[cx];
+        if ( (ch == '"') || (ch == '\\') )
+            strm << '\\' << ch;
+        else if ( static_cast<BYTE>(ch) < ASCII_SPACE )
+            strm << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << static_cast<int>(ch) << std::dec;
+        else
+            strm << ch;
+    }
+    strm << "\"";
+    return strm.str();
+}
+
 
 
 //	constructors, destructors
 
 SystemLog::SystemLog()
+    :m_DequeuePosition( 0 ),
+    m_DroppedCount( 0 ),
+    m_Enabled( false ),
+    m_EnqueuePosition( 0 ),
+    m_FileDay( 0 ),
+    m_FileSize( 0 ),
+    m_FlushCompleted( 0 ),
+    m_FlushRequested( 0 ),
+    m_Format( FORMAT_TEXT ),
+    m_ReportedDropCount( 0 ),
+    m_RotateBytes( 0 ),
+    m_RotateDaily( false ),
+    m_pSlots( new Slot[QUEUE_SIZE] ),
+    m_pStream( 0 ),
+    m_TermFlag( false )
 {
     assert( !m_pInstance );
+    for ( INDEX sx = 0; sx < QUEUE_SIZE; ++sx )
+        m_pSlots[sx].m_Sequence.store( sx, std::memory_order_relaxed );
+    for ( INDEX cx = 0; cx < CATEGORY_COUNT; ++cx )
+        m_MinimumLevels[cx].store( LEVEL_INFO, std::memory_order_relaxed );
     m_pInstance = this;
-    m_pStream = 0;
 }
 
 
@@ -32,6 +378,7 @@ SystemLog::~SystemLog()
     if ( m_pStream )
         close();
     m_pInstance = 0;
+    delete[] m_pSlots;
 }
 
 
@@ -40,13 +387,21 @@ SystemLog::~SystemLog()
 
 //  close()
 //
-//  Closes the underlying log file
+//  Stops the writer thread (once it has written everything queued so far) and closes the underlying log file.
+//  Entries written after this point are discarded.
 bool
     SystemLog::close()
 {
     if ( !m_pStream )
         return false;
 
+    m_Enabled = false;
+    m_Mutex.lock();
+    m_TermFlag = true;
+    m_Condition.notify_one();
+    m_Mutex.unlock();
+    m_Thread.join();
+
     m_pStream->close();
     delete m_pStream;
     m_pStream = 0;
@@ -55,9 +410,55 @@ bool
 }
 
 
+//  enable()
+//
+//  Enables or disables the acceptance of new entries
+void
+    SystemLog::enable
+    (
+    const bool              flag
+    )
+{
+    m_Enabled = flag;
+}
+
+
+//  flush()
+//
+//  Waits until everything written before we were called is in the file
+void
+    SystemLog::flush()
+{
+    std::unique_lock<std::mutex> lock( m_Mutex );
+    if ( !m_pStream || m_TermFlag )
+        return;
+
+    COUNT64 request = ++m_FlushRequested;
+    m_Condition.notify_one();
+    while ( m_FlushCompleted < request )
+        m_FlushCondition.wait( lock );
+}
+
+
+//  getStatistics()
+SystemLog::Statistics
+    SystemLog::getStatistics()
+{
+    m_Mutex.lock();
+    Statistics stats = m_Statistics;
+    m_Mutex.unlock();
+
+    stats.m_DroppedCount = m_DroppedCount.load( std::memory_order_relaxed );
+    COUNT64 enqueued = m_EnqueuePosition.load( std::memory_order_relaxed );
+    COUNT64 dequeued = m_DequeuePosition.load( std::memory_order_relaxed );
+    stats.m_QueuedCount = enqueued > dequeued ? static_cast<COUNT>(enqueued - dequeued) : 0;
+    return stats;
+}
+
+
 //  open()
 //
-//  Opens the log file
+//  Opens the log file, and starts the writer thread
 bool
     SystemLog::open
     (
@@ -67,26 +468,201 @@ bool
     if ( m_pStream )
         return false;
 
-    m_Enabled = true;
     m_pStream = new std::ofstream();
     m_pStream->open( fileName );
+    m_FileName = fileName;
+    m_FileDay = getCurrentDay();
+    m_FileSize = 0;
+    m_TermFlag = false;
+    m_Thread = std::thread( &SystemLog::writerLoop, this );
+
+    m_Enabled = true;
     return true;
 }
 
 
+//  setFormat()
+//
+//  Selects plain text or JSON lines for entries written from here on
+void
+    SystemLog::setFormat
+    (
+    const Format            format
+    )
+{
+    m_Format.store( format, std::memory_order_relaxed );
+}
+
+
+//  setMinimumLevel()
+//
+//  Entries of the given category, below the given level, are ignored from here on
+void
+    SystemLog::setMinimumLevel
+    (
+    const Category          category,
+    const Level             level
+    )
+{
+    m_MinimumLevels[category].store( level, std::memory_order_relaxed );
+}
+
+
+//  setRotation()
+//
+//  Sets the conditions under which the log file is rotated.
+//
+//  Parameters:
+//      maxBytes:           rotate once the file reaches this size - zero for no limit
+//      daily:              rotate when the (local) date changes
+void
+    SystemLog::setRotation
+    (
+    const COUNT64           maxBytes,
+    const bool              daily
+    )
+{
+    m_Mutex.lock();
+    m_RotateBytes = maxBytes;
+    m_RotateDaily = daily;
+    m_Mutex.unlock();
+}
+
+
 //  writeEntry()
 //
-//  Writes an entry to the SystemLog
+//  Writes an uncategorized, informational entry to the SystemLog
 void
 	SystemLog::writeEntry
 	(
 	const std::string&		text
 	)
 {
-    if ( m_Enabled )
+    writeEntry( CATEGORY_GENERAL, LEVEL_INFO, text );
+}
+
+
+//  writeEntry()
+//
+//  Writes an entry to the SystemLog - or rather, queues it for the writer thread - if its category is
+//  logging at its level.  We never block; if the ring is full, the entry is dropped (and counted).
+void
+	SystemLog::writeEntry
+	(
+    const Category          category,
+    const Level             level,
+	const std::string&		text
+	)
+{
+    if ( !m_Enabled.load( std::memory_order_relaxed )
+        || (level < m_MinimumLevels[category].load( std::memory_order_relaxed )) )
+        return;
+
+    //  Claim a slot.  The slot for position p is free when its sequence is p; if it is less than that,
+    //  the writer has not yet drained the entry from the previous lap, and the ring is full.
+    COUNT64 position = m_EnqueuePosition.load( std::memory_order_relaxed );
+    Slot* pSlot = 0;
+    while ( true )
     {
-        lock();
-        *m_pStream << text << std::endl;
-        unlock();
+        pSlot = &m_pSlots[position & (QUEUE_SIZE - 1)];
+        INT64 difference = static_cast<INT64>( pSlot->m_Sequence.load( std::memory_order_acquire ) - position );
+        if ( difference == 0 )
+        {
+            if ( m_EnqueuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+                break;
+        }
+        else if ( difference < 0 )
+        {
+            m_DroppedCount.fetch_add( 1, std::memory_order_relaxed );
+            return;
+        }
+        else
+        {
+            position = m_EnqueuePosition.load( std::memory_order_relaxed );
+        }
     }
+
+    pSlot->m_Category = category;
+    pSlot->m_Level = level;
+    pSlot->m_Text = text;
+    pSlot->m_ThreadId = getCurrentThreadId();
+    pSlot->m_TimeMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch() ).count();
+    pSlot->m_Sequence.store( position + 1, std::memory_order_release );
+
+    //  Prod the writer if the ring is half full, rather than waiting for its next scheduled pass
+    if ( position - m_DequeuePosition.load( std::memory_order_relaxed ) == QUEUE_SIZE / 2 )
+        m_Condition.notify_one();
 }
+
+
+
+//  public statics
+
+//  getCategory()
+//
+//  Finds the category with the given name (case-insensitive)
+bool
+    SystemLog::getCategory
+    (
+    const std::string&      name,
+    Category* const         pCategory
+    )
+{
+    for ( INDEX cx = 0; cx < CATEGORY_COUNT; ++cx )
+    {
+        if ( SuperString( name ).compareNoCase( CategoryNames[cx] ) == 0 )
+        {
+            *pCategory = static_cast<Category>( cx );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//  getCategoryString()
+const char*
+    SystemLog::getCategoryString
+    (
+    const Category          category
+    )
+{
+    return category < CATEGORY_COUNT ? CategoryNames[category] : "?";
+}
+
+
+//  getLevel()
+//
+//  Finds the level with the given name (case-insensitive)
+bool
+    SystemLog::getLevel
+    (
+    const std::string&      name,
+    Level* const            pLevel
+    )
+{
+    for ( INDEX lx = 0; lx <= LEVEL_OFF; ++lx )
+    {
+        if ( SuperString( name ).compareNoCase( LevelNames[lx] ) == 0 )
+        {
+            *pLevel = static_cast<Level>( lx );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//  getLevelString()
+const char*
+    SystemLog::getLevelString
+    (
+    const Level             level
+    )
+{
+    return level <= LEVEL_OFF ? LevelNames[level] : "?";
+}
+
@@ -1,5 +1,20 @@
 //	SystemLog.h - header file for generic system log
 //  Copyright (c) 2015 by Kurt Duncan
+//
+//  Writers never touch the file.  writeEntry() puts the text in a fixed-size ring of slots (claimed with a
+//  compare-and-swap, so any number of threads may write at once) and returns; a background thread drains
+//  the ring, and writes and flushes the entries in batches - every FLUSH_MILLISECONDS, or sooner if the ring
+//  is filling.  If the ring is full, the entry is dropped and counted, and the writer notes the loss in the
+//  log.  Anyone who needs the log to be on disk right now (e.g., the exec, when it stops) calls flush().
+//
+//  The file may be rotated when it reaches a given size, and/or when the date changes - the old file is
+//  renamed with a time stamp suffix, and a new one is started under the original name.
+//
+//  Each entry has a level and a category, and each category has a minimum level below which entries are ignored.
+//  Use the SYSTEM_LOG macros for anything which must be formatted - they test the level before evaluating the
+//  stream expression, so a disabled entry costs one relaxed load; and entries below MISCLIB_LOG_MIN_LEVEL are
+//  removed by the compiler altogether.  Time stamps and thread ids are taken when the entry is queued, and the
+//  writer thread formats the line - as plain text, or as one JSON object per line.
 
 
 
@@ -8,28 +23,167 @@
 
 
 
-class	SystemLog : public Lockable
+class	SystemLog
 {
+public:
+    enum Category
+    {
+        CATEGORY_GENERAL,
+        CATEGORY_CHANNEL,
+        CATEGORY_CONSOLE,
+        CATEGORY_DEVICE,
+        CATEGORY_EXEC,
+        CATEGORY_FACILITIES,
+        CATEGORY_IO,
+        CATEGORY_MFD,
+        CATEGORY_NETWORK,
+        CATEGORY_WORKER,
+        CATEGORY_COUNT,
+    };
+
+    //  Values must agree with MISCLIB_LOG_MIN_LEVEL
+    enum Level
+    {
+        LEVEL_TRACE = 0,
+        LEVEL_DEBUG = 1,
+        LEVEL_INFO = 2,
+        LEVEL_WARNING = 3,
+        LEVEL_ERROR = 4,
+        LEVEL_OFF = 5,                                  //  only as a minimum level - disables the category
+    };
+
+    enum Format
+    {
+        FORMAT_TEXT,
+        FORMAT_JSON,
+    };
+
+    class   Statistics
+    {
+    public:
+        COUNT64                 m_DroppedCount;         //  entries lost to a full ring
+        COUNT64                 m_FlushCount;           //  batches written to the file
+        COUNT                   m_QueuedCount;          //  entries in the ring, not yet written
+        COUNT64                 m_RotationCount;
+        COUNT64                 m_WrittenBytes;
+        COUNT64                 m_WrittenCount;         //  entries written to the file
+
+        Statistics()
+            :m_DroppedCount( 0 ),
+            m_FlushCount( 0 ),
+            m_QueuedCount( 0 ),
+            m_RotationCount( 0 ),
+            m_WrittenBytes( 0 ),
+            m_WrittenCount( 0 )
+        {}
+    };
+
+    static const COUNT          QUEUE_SIZE = 4096;          //  entries - must be a power of two
+    static const COUNT          FLUSH_BYTES = 64 * 1024;    //  write out a batch once it gets this big
+    static const COUNT32        FLUSH_MILLISECONDS = 200;   //  longest an entry waits in the ring
+
 private:
+    class   Slot
+    {
+    public:
+        Category                m_Category;
+        Level                   m_Level;
+        std::atomic<COUNT64>    m_Sequence;             //  position + 1 once filled; position + QUEUE_SIZE once drained
+        std::string             m_Text;
+        UINT32                  m_ThreadId;             //  host thread id
+        INT64                   m_TimeMicros;           //  since the epoch
+    };
+
+    //  Producers claim slots via m_EnqueuePosition without locking; everything else is protected by m_Mutex,
+    //  and the file itself is touched only by the writer thread (or by open() and close(), while it is not running).
+    std::condition_variable     m_Condition;            //  wakes the writer
+    std::atomic<COUNT64>        m_DequeuePosition;      //  advanced only by the writer
+    std::atomic<COUNT64>        m_DroppedCount;
+    std::atomic<bool>           m_Enabled;
+    std::atomic<COUNT64>        m_EnqueuePosition;
+    UINT32                      m_FileDay;              //  day of month on which the current file was started
+    std::string                 m_FileName;
+    COUNT64                     m_FileSize;
+    std::condition_variable     m_FlushCondition;       //  wakes flush() callers
+    COUNT64                     m_FlushCompleted;       //  flush requests satisfied by the writer
+    COUNT64                     m_FlushRequested;
+    std::atomic<Format>         m_Format;
+    std::atomic<Level>          m_MinimumLevels[CATEGORY_COUNT];
+    std::mutex                  m_Mutex;
+    COUNT64                     m_ReportedDropCount;    //  drops already noted in the log
+    COUNT64                     m_RotateBytes;          //  zero for no rotation by size
+    bool                        m_RotateDaily;
+    Slot*                       m_pSlots;
+    Statistics                  m_Statistics;           //  m_DroppedCount and m_QueuedCount are filled in on request
     std::ofstream*              m_pStream;
-    bool                        m_Enabled;
+    bool                        m_TermFlag;
+    std::thread                 m_Thread;
 
     static SystemLog*		    m_pInstance;
 
+    COUNT                       drain( std::string* const pBuffer );
+    void                        formatEntry( std::string* const pBuffer,
+                                             const INT64        timeMicros,
+                                             const UINT32       threadId,
+                                             const Level        level,
+                                             const Category     category,
+                                             const std::string& text ) const;
+    bool                        isRotationDue() const;
+    void                        rotate();
+    void                        writeBatch( const std::string& buffer );
+    void                        writerLoop();
+
+    static UINT32               getCurrentDay();
+    static UINT32               getCurrentThreadId();
+    static std::string          getJsonString( const std::string& value );
+
 public:
     SystemLog();
     ~SystemLog();
 
     bool                        close();
     void                        enable( const bool flag );
+    void                        flush();
+    Format                      getFormat() const               { return m_Format.load( std::memory_order_relaxed ); }
+    Level                       getMinimumLevel( const Category category ) const
+                                                                { return m_MinimumLevels[category].load( std::memory_order_relaxed ); }
+    Statistics                  getStatistics();
     bool                        open( const std::string& fileName );
+    void                        setFormat( const Format format );
+    void                        setMinimumLevel( const Category category,
+                                                 const Level    level );
+    void                        setRotation( const COUNT64  maxBytes,
+                                             const bool     daily );
     void					    writeEntry( const std::string& text );
+    void                        writeEntry( const Category      category,
+                                            const Level         level,
+                                            const std::string&  text );
+
+    static bool                 getCategory( const std::string& name,
+                                             Category* const    pCategory );
+    static const char*          getCategoryString( const Category category );
+    static bool                 getLevel( const std::string&    name,
+                                          Level* const          pLevel );
+    static const char*          getLevelString( const Level level );
 
     static inline SystemLog* getInstance()
     {
         return m_pInstance;
     }
 
+    //  Cheap enough to call before formatting anything
+    static inline bool isLogging
+        (
+        const Category          category,
+        const Level             level
+        )
+    {
+        SystemLog* psl = getInstance();
+        return psl
+            && psl->m_Enabled.load( std::memory_order_relaxed )
+            && (level >= psl->m_MinimumLevels[category].load( std::memory_order_relaxed ));
+    }
+
     static inline void write
         (
         const std::string&      text
@@ -39,8 +193,42 @@ public:
         if ( psl )
             psl->writeEntry( text );
     }
+
+    static inline void write
+        (
+        const Category          category,
+        const Level             level,
+        const std::string&      text
+        )
+    {
+        SystemLog* psl = getInstance();
+        if ( psl )
+            psl->writeEntry( category, level, text );
+    }
 };
 
 
 
+//  Front end for formatted entries - category and level are the suffixes of the enum names, e.g.
+//      SYSTEM_LOG( MFD, DEBUG, "allocated track " << trackId << " on " << packName );
+//  The expression is not evaluated unless the entry is going to be written.
+#define     SYSTEM_LOG( category, level, expression )                                                           \
+    do                                                                                                          \
+    {                                                                                                           \
+        if ( (SystemLog::LEVEL_##level >= MISCLIB_LOG_MIN_LEVEL)                                                \
+            && SystemLog::isLogging( SystemLog::CATEGORY_##category, SystemLog::LEVEL_##level ) )               \
+        {                                                                                                       \
+            std::stringstream systemLogStream;                                                                  \
+            systemLogStream << expression;                                                                      \
+            SystemLog::write( SystemLog::CATEGORY_##category, SystemLog::LEVEL_##level, systemLogStream.str() );\
+        }                                                                                                       \
+    } while ( false )
+
+//  For guarding larger blocks of logging code (e.g., buffer dumps) in the same way
+#define     SYSTEM_LOG_ENABLED( category, level )                                                               \
+    ((SystemLog::LEVEL_##level >= MISCLIB_LOG_MIN_LEVEL)                                                        \
+        && SystemLog::isLogging( SystemLog::CATEGORY_##category, SystemLog::LEVEL_##level ))
+
+
+
 #endif
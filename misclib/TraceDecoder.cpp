@@ -0,0 +1,290 @@
+//  TraceDecoder.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "misclib.h"
+
+
+
+//  private statics
+
+//  getArgName()
+//
+//  Retrieves the JSON name of the indicated argument of the indicated record type,
+//  or null if that argument is not used.
+const char*
+TraceDecoder::getArgName
+(
+    const TraceLog::Event   event,
+    const TraceLog::Phase   phase,
+    const INDEX             argIndex
+)
+{
+    switch ( event )
+    {
+    case TraceLog::EVENT_CHANNEL_PROGRAM:
+        if ( phase == TraceLog::PHASE_END )
+            return argIndex == 0 ? "deviceStatus" : 0;
+        return argIndex == 0 ? "channelModule" : "command";
+
+    case TraceLog::EVENT_DEVICE_IO:
+        if ( phase == TraceLog::PHASE_END )
+            return argIndex == 0 ? "deviceStatus" : 0;
+        return argIndex == 0 ? "device" : "function";
+
+    case TraceLog::EVENT_WORKER_WAKEUP:
+        return argIndex == 0 ? "worker" : "latencyMicros";
+
+    case TraceLog::EVENT_WORKER_STEP:
+        return (phase == TraceLog::PHASE_BEGIN) && (argIndex == 0) ? "worker" : 0;
+
+    case TraceLog::EVENT_MFD_COMMIT:
+        return (phase == TraceLog::PHASE_BEGIN) && (argIndex == 0) ? "sectors" : 0;
+
+    case TraceLog::EVENT_KEYIN:
+        return (phase == TraceLog::PHASE_BEGIN) && (argIndex == 0) ? "keyin" : 0;
+
+    default:
+        return 0;
+    }
+}
+
+
+//  getEventName()
+const char*
+TraceDecoder::getEventName
+(
+    const TraceLog::Event   event
+)
+{
+    switch ( event )
+    {
+    case TraceLog::EVENT_CHANNEL_PROGRAM:   return "ChannelProgram";
+    case TraceLog::EVENT_DEVICE_IO:         return "DeviceIo";
+    case TraceLog::EVENT_WORKER_WAKEUP:     return "WorkerWakeup";
+    case TraceLog::EVENT_WORKER_STEP:       return "WorkerStep";
+    case TraceLog::EVENT_MFD_COMMIT:        return "MFDCommit";
+    case TraceLog::EVENT_KEYIN:             return "Keyin";
+    default:                                return "Unknown";
+    }
+}
+
+
+//  getJsonString()
+//
+//  Quotes and escapes a string for JSON
+std::string
+TraceDecoder::getJsonString
+(
+    const std::string&      value
+)
+{
+    std::stringstream strm;
+    strm << "\"";
+    for ( INDEX cx = 0; cx < value.size(); ++cx )
+    {
+        char ch = value[cx];
+        if ( (ch == '"') || (ch == '\\') )
+            strm << '\\' << ch;
+        else if ( static_cast<BYTE>(ch) < ASCII_SPACE )
+            strm << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << static_cast<int>(ch) << std::dec;
+        else
+            strm << ch;
+    }
+    strm << "\"";
+    return strm.str();
+}
+
+
+//  isNameArg()
+//
+//  Indicates whether the indicated argument is a TraceLog name id, rather than a number
+bool
+TraceDecoder::isNameArg
+(
+    const TraceLog::Event   event,
+    const TraceLog::Phase   phase,
+    const INDEX             argIndex
+)
+{
+    if ( (phase == TraceLog::PHASE_END) || (argIndex != 0) )
+        return false;
+
+    return (event == TraceLog::EVENT_CHANNEL_PROGRAM)
+            || (event == TraceLog::EVENT_DEVICE_IO)
+            || (event == TraceLog::EVENT_WORKER_WAKEUP)
+            || (event == TraceLog::EVENT_WORKER_STEP)
+            || (event == TraceLog::EVENT_KEYIN);
+}
+
+
+//  readFile()
+//
+//  Reads and validates the content of a dump file
+bool
+TraceDecoder::readFile
+(
+    std::istream&                   stream,
+    VSTRING* const                  pNames,
+    std::map<UINT32, UINT32>*       pThreadNames,
+    std::vector<TraceLog::Record>*  pRecords
+)
+{
+    char magic[sizeof( TraceLog::FILE_MAGIC )];
+    UINT32 recordSize = 0;
+    UINT32 nameCount = 0;
+    UINT32 threadCount = 0;
+    UINT64 recordCount = 0;
+
+    stream.read( magic, sizeof( magic ) );
+    stream.read( reinterpret_cast<char*>( &recordSize ), sizeof( recordSize ) );
+    stream.read( reinterpret_cast<char*>( &nameCount ), sizeof( nameCount ) );
+    stream.read( reinterpret_cast<char*>( &threadCount ), sizeof( threadCount ) );
+    stream.read( reinterpret_cast<char*>( &recordCount ), sizeof( recordCount ) );
+    if ( !stream.good()
+        || (memcmp( magic, TraceLog::FILE_MAGIC, sizeof( magic ) ) != 0)
+        || (recordSize != sizeof( TraceLog::Record )) )
+        return false;
+
+    for ( INDEX nx = 0; nx < nameCount; ++nx )
+    {
+        UINT32 length = 0;
+        stream.read( reinterpret_cast<char*>( &length ), sizeof( length ) );
+        std::string name( length, ' ' );
+        if ( length )
+            stream.read( &name[0], length );
+        if ( !stream.good() )
+            return false;
+        pNames->push_back( name );
+    }
+
+    for ( INDEX tx = 0; tx < threadCount; ++tx )
+    {
+        UINT32 threadId = 0;
+        UINT32 nameId = 0;
+        stream.read( reinterpret_cast<char*>( &threadId ), sizeof( threadId ) );
+        stream.read( reinterpret_cast<char*>( &nameId ), sizeof( nameId ) );
+        if ( !stream.good() )
+            return false;
+        (*pThreadNames)[threadId] = nameId;
+    }
+
+    TraceLog::Record record;
+    for ( UINT64 rx = 0; rx < recordCount; ++rx )
+    {
+        stream.read( reinterpret_cast<char*>( &record ), sizeof( record ) );
+        if ( stream.gcount() != sizeof( record ) )
+            return false;
+        pRecords->push_back( record );
+    }
+
+    return true;
+}
+
+
+
+//  public statics
+
+//  decode()
+//
+//  Reads the given TraceLog dump file, and writes the equivalent Chrome trace JSON to the given output file.
+//
+//  Returns:
+//      false if the input is not a trace dump, or either file cannot be accessed (the reason is logged)
+bool
+TraceDecoder::decode
+(
+    const std::string&  inputFileName,
+    const std::string&  outputFileName
+)
+{
+    VSTRING names;
+    std::map<UINT32, UINT32> threadNames;
+    std::vector<TraceLog::Record> records;
+
+    std::ifstream input( inputFileName, std::ios::in | std::ios::binary );
+    if ( !input.good() )
+    {
+        SystemLog::write( "TraceDecoder cannot open " + inputFileName );
+        return false;
+    }
+
+    bool readOk = readFile( input, &names, &threadNames, &records );
+    input.close();
+    if ( !readOk )
+    {
+        SystemLog::write( "TraceDecoder " + inputFileName + " is not a valid trace dump" );
+        return false;
+    }
+
+    std::ofstream output( outputFileName, std::ios::out | std::ios::trunc );
+    if ( !output.good() )
+    {
+        SystemLog::write( "TraceDecoder cannot open " + outputFileName );
+        return false;
+    }
+
+    output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+
+    for ( std::map<UINT32, UINT32>::const_iterator itt = threadNames.begin(); itt != threadNames.end(); ++itt )
+    {
+        std::string name = itt->second < names.size() ? names[itt->second] : "";
+        output << (first ? "\n" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << itt->first
+            << ",\"args\":{\"name\":" << getJsonString( name ) << "}}";
+        first = false;
+    }
+
+    UINT64 baseTime = records.empty() ? 0 : records[0].m_Timestamp;
+    for ( INDEX rx = 0; rx < records.size(); ++rx )
+    {
+        const TraceLog::Record& record = records[rx];
+        TraceLog::Event event = static_cast<TraceLog::Event>( record.m_Event );
+        TraceLog::Phase phase = static_cast<TraceLog::Phase>( record.m_Phase );
+        UINT64 nanos = record.m_Timestamp - baseTime;
+
+        const char* pPhaseCode = "i";
+        if ( phase == TraceLog::PHASE_BEGIN )
+            pPhaseCode = record.m_Id ? "b" : "B";
+        else if ( phase == TraceLog::PHASE_END )
+            pPhaseCode = record.m_Id ? "e" : "E";
+
+        output << (first ? "\n" : ",\n")
+            << "{\"name\":\"" << getEventName( event ) << "\",\"cat\":\"em2200\",\"ph\":\"" << pPhaseCode << "\""
+            << ",\"ts\":" << (nanos / 1000) << "." << std::setw( 3 ) << std::setfill( '0' ) << (nanos % 1000)
+            << ",\"pid\":1,\"tid\":" << record.m_ThreadId;
+        first = false;
+
+        if ( record.m_Id )
+            output << ",\"id\":\"0x" << std::hex << record.m_Id << std::dec << "\"";
+        if ( phase == TraceLog::PHASE_INSTANT )
+            output << ",\"s\":\"t\"";
+
+        bool firstArg = true;
+        for ( INDEX ax = 0; ax < 2; ++ax )
+        {
+            const char* pArgName = getArgName( event, phase, ax );
+            if ( pArgName == 0 )
+                continue;
+
+            output << (firstArg ? ",\"args\":{" : ",") << "\"" << pArgName << "\":";
+            firstArg = false;
+            if ( isNameArg( event, phase, ax ) )
+                output << getJsonString( record.m_Args[ax] < names.size() ? names[record.m_Args[ax]] : "" );
+            else
+                output << record.m_Args[ax];
+        }
+
+        output << (firstArg ? "}" : "}}");
+    }
+
+    output << "\n]}\n";
+    bool result = output.good();
+    output.close();
+    if ( !result )
+        SystemLog::write( "TraceDecoder failed writing " + outputFileName );
+    return result;
+}
+
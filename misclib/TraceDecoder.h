@@ -0,0 +1,40 @@
+//  TraceDecoder.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Converts a file written by TraceLog::dump() into Chrome trace event JSON, which can be loaded into
+//  chrome://tracing or ui.perfetto.dev.  Spans which begin and end on one thread become B/E events,
+//  spans which may cross threads become async b/e events keyed by their id, and the rest become instants.
+//  Timestamps are reported in microseconds from the earliest record in the file.
+//  This does not need a running exec - it may be used on a dump from some earlier session.
+
+
+
+#ifndef     MISCLIB_TRACE_DECODER_H
+#define     MISCLIB_TRACE_DECODER_H
+
+
+
+class   TraceDecoder
+{
+private:
+    static const char*          getArgName( const TraceLog::Event   event,
+                                            const TraceLog::Phase   phase,
+                                            const INDEX             argIndex );
+    static const char*          getEventName( const TraceLog::Event event );
+    static std::string          getJsonString( const std::string& value );
+    static bool                 isNameArg( const TraceLog::Event    event,
+                                           const TraceLog::Phase    phase,
+                                           const INDEX              argIndex );
+    static bool                 readFile( std::istream&                 stream,
+                                          VSTRING* const                pNames,
+                                          std::map<UINT32, UINT32>*     pThreadNames,
+                                          std::vector<TraceLog::Record>* pRecords );
+
+public:
+    static bool                 decode( const std::string&  inputFileName,
+                                        const std::string&  outputFileName );
+};
+
+
+
+#endif
@@ -0,0 +1,342 @@
+//  TraceLog.cpp
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "misclib.h"
+
+
+
+#ifdef  WIN32
+#define     TRACE_THREAD_LOCAL  __declspec(thread)
+#else
+#define     TRACE_THREAD_LOCAL  __thread
+#endif
+
+
+
+//  statics
+
+const char                      TraceLog::FILE_MAGIC[8] = { 'E', 'M', 'T', 'R', 'A', 'C', 'E', '1' };
+
+std::atomic<bool>               TraceLog::m_Enabled( false );
+TraceLog*                       TraceLog::m_pInstance = 0;
+
+static std::once_flag           instanceOnce;
+
+static TRACE_THREAD_LOCAL void*     currentRing;
+static TRACE_THREAD_LOCAL UINT32    currentThreadNameId;
+
+#ifndef WIN32
+static pthread_key_t            threadExitKey;
+static std::once_flag           threadExitKeyOnce;
+#endif
+
+static_assert( sizeof( TraceLog::Record ) == 40, "TraceLog::Record must match the dump file format" );
+
+
+
+//  private methods
+
+//  internLocked()
+//
+//  Does the work for intern() - call under m_Mutex
+UINT32
+TraceLog::internLocked
+(
+    const std::string&      name
+)
+{
+    if ( name.empty() )
+        return 0;
+
+    CITNAME_IDS itn = m_NameIds.find( name );
+    if ( itn != m_NameIds.end() )
+        return itn->second;
+
+    UINT32 nameId = static_cast<UINT32>( m_Names.size() );
+    m_Names.push_back( name );
+    m_NameIds[name] = nameId;
+    return nameId;
+}
+
+
+
+//  private statics
+
+//  getInstance()
+//
+//  Retrieves the process-wide registry, creating it on first use
+TraceLog*
+TraceLog::getInstance()
+{
+    std::call_once( instanceOnce, [](){
+        m_pInstance = new TraceLog();
+    } );
+
+    return m_pInstance;
+}
+
+
+//  getRing()
+//
+//  Retrieves the calling thread's ring.  The first time a thread gets here, we give it a ring (one left behind
+//  by a terminated thread if there is one) and a new thread id, and arrange to give the ring back when it exits.
+TraceLog::Ring*
+TraceLog::getRing()
+{
+    if ( currentRing )
+        return static_cast<Ring*>( currentRing );
+
+    TraceLog* pLog = getInstance();
+    pLog->m_Mutex.lock();
+    Ring* pRing = 0;
+    for ( INDEX rx = 0; rx < pLog->m_Rings.size(); ++rx )
+    {
+        if ( !pLog->m_Rings[rx]->m_InUse )
+        {
+            pRing = pLog->m_Rings[rx];
+            break;
+        }
+    }
+
+    if ( pRing == 0 )
+    {
+        pRing = new Ring();
+        pLog->m_Rings.push_back( pRing );
+    }
+
+    pRing->m_InUse = true;
+    pRing->m_ThreadId = pLog->m_NextThreadId++;
+    if ( currentThreadNameId )
+        pLog->m_ThreadNames[pRing->m_ThreadId] = currentThreadNameId;
+    pLog->m_Mutex.unlock();
+
+#ifndef WIN32
+    std::call_once( threadExitKeyOnce, [](){ pthread_key_create( &threadExitKey, threadExitHandler ); } );
+    pthread_setspecific( threadExitKey, pRing );
+#endif
+
+    currentRing = pRing;
+    return pRing;
+}
+
+
+//  threadExitHandler()
+//
+//  Invoked (on POSIX platforms) as a thread-specific-data destructor when a thread which has recorded
+//  anything terminates.  The ring (and the records in it) are kept for the next new thread.
+void
+TraceLog::threadExitHandler
+(
+    void*           pArg
+)
+{
+    TraceLog* pLog = getInstance();
+    pLog->m_Mutex.lock();
+    static_cast<Ring*>( pArg )->m_InUse = false;
+    pLog->m_Mutex.unlock();
+}
+
+
+
+//  constructors, destructors
+
+TraceLog::TraceLog()
+:m_Names( 1 ),
+m_NextThreadId( 1 )
+{
+}
+
+
+
+//  public statics
+
+//  dump()
+//
+//  Writes the name table, the thread names, and every record still held in any ring, in timestamp order,
+//  to the given file.  Recording may continue while we do this; records which may have been overwritten
+//  while we were copying them are discarded.
+//
+//  Returns:
+//      false if the file could not be written
+bool
+TraceLog::dump
+(
+    const std::string&      fileName
+)
+{
+    std::vector<Record> records;
+
+    TraceLog* pLog = getInstance();
+    pLog->m_Mutex.lock();
+    VSTRING names = pLog->m_Names;
+    THREAD_NAMES threadNames = pLog->m_ThreadNames;
+    for ( INDEX rx = 0; rx < pLog->m_Rings.size(); ++rx )
+    {
+        Ring* pRing = pLog->m_Rings[rx];
+        COUNT64 head = pRing->m_Head.load( std::memory_order_acquire );
+        COUNT64 first = head > RING_SIZE ? head - RING_SIZE : 0;
+
+        std::vector<Record> ringRecords;
+        ringRecords.reserve( static_cast<COUNT>(head - first) );
+        for ( COUNT64 index = first; index < head; ++index )
+            ringRecords.push_back( pRing->m_Records[index % RING_SIZE] );
+
+        //  The owner may have lapped us while we copied - anything it could have been writing is suspect
+        COUNT64 newHead = pRing->m_Head.load( std::memory_order_acquire );
+        COUNT64 firstValid = newHead >= RING_SIZE ? newHead - RING_SIZE + 1 : 0;
+        for ( COUNT64 index = first; index < head; ++index )
+        {
+            if ( index >= firstValid )
+                records.push_back( ringRecords[static_cast<INDEX>(index - first)] );
+        }
+    }
+    pLog->m_Mutex.unlock();
+
+    std::stable_sort( records.begin(), records.end(),
+                      []( const Record& a, const Record& b ){ return a.m_Timestamp < b.m_Timestamp; } );
+
+    std::ofstream stream( fileName, std::ios::out | std::ios::binary | std::ios::trunc );
+    if ( !stream.good() )
+    {
+        SystemLog::write( "TraceLog cannot open " + fileName );
+        return false;
+    }
+
+    UINT32 recordSize = sizeof( Record );
+    UINT32 nameCount = static_cast<UINT32>( names.size() );
+    UINT32 threadCount = static_cast<UINT32>( threadNames.size() );
+    UINT64 recordCount = records.size();
+
+    stream.write( FILE_MAGIC, sizeof( FILE_MAGIC ) );
+    stream.write( reinterpret_cast<const char*>( &recordSize ), sizeof( recordSize ) );
+    stream.write( reinterpret_cast<const char*>( &nameCount ), sizeof( nameCount ) );
+    stream.write( reinterpret_cast<const char*>( &threadCount ), sizeof( threadCount ) );
+    stream.write( reinterpret_cast<const char*>( &recordCount ), sizeof( recordCount ) );
+
+    for ( INDEX nx = 0; nx < names.size(); ++nx )
+    {
+        UINT32 length = static_cast<UINT32>( names[nx].size() );
+        stream.write( reinterpret_cast<const char*>( &length ), sizeof( length ) );
+        stream.write( names[nx].c_str(), length );
+    }
+
+    for ( CITTHREAD_NAMES itt = threadNames.begin(); itt != threadNames.end(); ++itt )
+    {
+        stream.write( reinterpret_cast<const char*>( &itt->first ), sizeof( itt->first ) );
+        stream.write( reinterpret_cast<const char*>( &itt->second ), sizeof( itt->second ) );
+    }
+
+    if ( !records.empty() )
+        stream.write( reinterpret_cast<const char*>( &records[0] ), records.size() * sizeof( Record ) );
+
+    bool result = stream.good();
+    stream.close();
+    if ( !result )
+        SystemLog::write( "TraceLog failed writing " + fileName );
+    return result;
+}
+
+
+//  getStatistics()
+TraceLog::Statistics
+TraceLog::getStatistics()
+{
+    Statistics stats;
+    stats.m_Enabled = isEnabled();
+
+    TraceLog* pLog = getInstance();
+    pLog->m_Mutex.lock();
+    stats.m_NameCount = pLog->m_Names.size() - 1;
+    stats.m_RingCount = pLog->m_Rings.size();
+    stats.m_ThreadCount = pLog->m_NextThreadId - 1;
+    for ( INDEX rx = 0; rx < pLog->m_Rings.size(); ++rx )
+        stats.m_RecordCount += pLog->m_Rings[rx]->m_Head.load( std::memory_order_relaxed );
+    pLog->m_Mutex.unlock();
+
+    return stats;
+}
+
+
+//  intern()
+//
+//  Retrieves the id for the given name, adding it to the name table if necessary.
+//  This takes a lock - callers on a hot path should do it once, and keep the result.
+UINT32
+TraceLog::intern
+(
+    const std::string&      name
+)
+{
+    TraceLog* pLog = getInstance();
+    pLog->m_Mutex.lock();
+    UINT32 nameId = pLog->internLocked( name );
+    pLog->m_Mutex.unlock();
+    return nameId;
+}
+
+
+//  record()
+//
+//  Appends a record to the calling thread's ring.  Callers normally check isEnabled() first,
+//  so that they do not assemble arguments for nothing; we do not check it again.
+void
+TraceLog::record
+(
+    const Event     event,
+    const Phase     phase,
+    const UINT64    id,
+    const UINT64    arg0,
+    const UINT64    arg1
+)
+{
+    Ring* pRing = getRing();
+    COUNT64 head = pRing->m_Head.load( std::memory_order_relaxed );
+    Record& record = pRing->m_Records[head % RING_SIZE];
+
+    record.m_Timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>
+                            ( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    record.m_Id = id;
+    record.m_Args[0] = arg0;
+    record.m_Args[1] = arg1;
+    record.m_ThreadId = pRing->m_ThreadId;
+    record.m_Event = static_cast<UINT16>( event );
+    record.m_Phase = static_cast<UINT8>( phase );
+    record.m_Reserved = 0;
+
+    pRing->m_Head.store( head + 1, std::memory_order_release );
+}
+
+
+//  setEnabled()
+//
+//  Turns tracing on or off.  Records already in the rings are kept either way.
+void
+TraceLog::setEnabled
+(
+    const bool      enabled
+)
+{
+    m_Enabled.store( enabled, std::memory_order_relaxed );
+}
+
+
+//  setThreadName()
+//
+//  Names the calling thread, for the benefit of whoever reads the trace.
+//  Worker threads and WorkerPool carriers do this as they start.
+void
+TraceLog::setThreadName
+(
+    const std::string&      name
+)
+{
+    TraceLog* pLog = getInstance();
+    pLog->m_Mutex.lock();
+    currentThreadNameId = pLog->internLocked( name );
+    if ( currentRing )
+        pLog->m_ThreadNames[static_cast<Ring*>( currentRing )->m_ThreadId] = currentThreadNameId;
+    pLog->m_Mutex.unlock();
+}
+
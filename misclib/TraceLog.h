@@ -0,0 +1,165 @@
+//  TraceLog.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  A low-overhead binary event trace, for finding out where time goes between components.
+//  Each thread which records anything gets its own ring of fixed-size Records, written only by that thread,
+//  so recording is a handful of stores and a release increment - no locks, no allocation, no formatting.
+//  When a ring fills, the oldest records are overwritten.  Tracing is off by default; while it is off,
+//  each trace point costs one relaxed atomic load (callers test isEnabled() before assembling arguments).
+//
+//  Names (channel modules, devices, workers, keyins) are interned once into a table of small ids, so that
+//  Records never carry strings.  dump() writes the name table and every ring to a binary file, which
+//  TraceDecoder turns into Chrome trace / Perfetto JSON.
+//
+//  Spans are recorded as BEGIN and END records.  A span with a zero id begins and ends on the same thread;
+//  a span with a non-zero id (typically the address of the object being traced) may end on another thread.
+
+
+
+#ifndef     MISCLIB_TRACE_LOG_H
+#define     MISCLIB_TRACE_LOG_H
+
+
+
+class   TraceLog
+{
+public:
+    enum Event
+    {
+        EVENT_NONE,
+        EVENT_CHANNEL_PROGRAM,      //  async span: args are channel module name, command  / device status
+        EVENT_DEVICE_IO,            //  async span: args are device name, function          / device status
+        EVENT_WORKER_WAKEUP,        //  instant:    args are worker name, wakeup latency in microseconds
+        EVENT_WORKER_STEP,          //  span:       args are worker name (WorkerPool steps)
+        EVENT_MFD_COMMIT,           //  span:       args are updated sector count
+        EVENT_KEYIN,                //  span:       args are keyin name
+        EVENT_COUNT,
+    };
+
+    enum Phase
+    {
+        PHASE_BEGIN,
+        PHASE_END,
+        PHASE_INSTANT,
+    };
+
+    //  One trace event, exactly as it appears in the dump file
+    class   Record
+    {
+    public:
+        UINT64                  m_Timestamp;        //  steady clock, nanoseconds
+        UINT64                  m_Id;               //  zero for spans which begin and end on one thread
+        UINT64                  m_Args[2];          //  meaning depends upon m_Event
+        UINT32                  m_ThreadId;         //  TraceLog thread id, not the host's
+        UINT16                  m_Event;
+        UINT8                   m_Phase;
+        UINT8                   m_Reserved;
+    };
+
+    //  Records BEGIN on construction and END on destruction, for a span on the current thread.
+    //  If tracing is off when the span begins, nothing is recorded at either end.
+    class   Span
+    {
+    private:
+        const Event             m_Event;
+        const bool              m_Recording;
+
+    public:
+        Span( const Event       event,
+              const UINT64      arg0 = 0,
+              const UINT64      arg1 = 0 )
+            :m_Event( event ),
+            m_Recording( isEnabled() )
+        {
+            if ( m_Recording )
+                record( m_Event, PHASE_BEGIN, 0, arg0, arg1 );
+        }
+
+        ~Span()
+        {
+            if ( m_Recording )
+                record( m_Event, PHASE_END, 0 );
+        }
+    };
+
+    class   Statistics
+    {
+    public:
+        bool                    m_Enabled;
+        COUNT                   m_NameCount;
+        COUNT64                 m_RecordCount;      //  total recorded, including those since overwritten
+        COUNT                   m_RingCount;
+        COUNT                   m_ThreadCount;      //  threads which have ever recorded anything
+
+        Statistics()
+            :m_Enabled( false ),
+            m_NameCount( 0 ),
+            m_RecordCount( 0 ),
+            m_RingCount( 0 ),
+            m_ThreadCount( 0 )
+        {}
+    };
+
+    static const char           FILE_MAGIC[8];
+    static const COUNT          RING_SIZE = 8192;   //  records per thread
+
+private:
+    class   Ring
+    {
+    public:
+        std::atomic<COUNT64>    m_Head;             //  index of the next record to be written
+        bool                    m_InUse;            //  owned by a live thread - protected by m_Mutex
+        Record                  m_Records[RING_SIZE];
+        UINT32                  m_ThreadId;
+
+        Ring()
+            :m_Head( 0 ),
+            m_InUse( false ),
+            m_ThreadId( 0 )
+        {}
+    };
+
+    typedef std::unordered_map<std::string, UINT32>     NAME_IDS;
+    typedef NAME_IDS::const_iterator                    CITNAME_IDS;
+
+    typedef std::map<UINT32, UINT32>                    THREAD_NAMES;   //  thread id to name id
+    typedef THREAD_NAMES::const_iterator                CITTHREAD_NAMES;
+
+    //  Everything but the enabled flag and the ring contents is protected by m_Mutex.
+    //  The instance is never deleted, so that threads still running during process exit may record safely.
+    std::mutex                  m_Mutex;
+    NAME_IDS                    m_NameIds;
+    VSTRING                     m_Names;            //  indexed by name id - id zero is the empty name
+    UINT32                      m_NextThreadId;
+    std::vector<Ring*>          m_Rings;
+    THREAD_NAMES                m_ThreadNames;
+
+    static std::atomic<bool>    m_Enabled;
+    static TraceLog*            m_pInstance;
+
+    TraceLog();
+
+    UINT32                      internLocked( const std::string& name );
+
+    static TraceLog*            getInstance();
+    static Ring*                getRing();
+    static void                 threadExitHandler( void* pArg );
+
+public:
+    static bool                 dump( const std::string& fileName );
+    static Statistics           getStatistics();
+    static UINT32               intern( const std::string& name );
+    static void                 record( const Event     event,
+                                        const Phase     phase,
+                                        const UINT64    id,
+                                        const UINT64    arg0 = 0,
+                                        const UINT64    arg1 = 0 );
+    static void                 setEnabled( const bool enabled );
+    static void                 setThreadName( const std::string& name );
+
+    static inline bool          isEnabled()         { return m_Enabled.load( std::memory_order_relaxed ); }
+};
+
+
+
+#endif
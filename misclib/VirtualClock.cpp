@@ -0,0 +1,458 @@
+//  VirtualClock class implementation
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "misclib.h"
+
+
+
+//  statics
+
+VirtualClock*       VirtualClock::m_pInstance = 0;
+
+static std::once_flag   instanceOnce;
+
+#ifdef  WIN32
+static __declspec(thread)   bool    participant = false;
+#else
+static __thread             bool    participant = false;
+#endif
+
+
+
+//  constructors, destructors
+
+VirtualClock::VirtualClock()
+:m_BaseEpoch( SystemTime::getMicrosecondsSinceEpoch() ),
+m_BaseMonotonic( getRealMicroseconds() ),
+m_BaseReal( m_BaseMonotonic.load() ),
+m_BaseSequence( 0 ),
+m_Factor( 1 ),
+m_Mode( MODE_REAL )
+{
+}
+
+
+
+//  private methods
+
+//  checkIdle()
+//
+//  If we are in VIRTUAL mode and every participant is waiting, jumps ahead to the earliest deadline.
+//  Call under m_Mutex.
+void
+VirtualClock::checkIdle()
+{
+    if ( (m_Mode != MODE_VIRTUAL)
+        || (m_Statistics.m_BusyCount > 0)
+        || (m_Statistics.m_ThreadCount == 0)
+        || m_Deadlines.empty() )
+        return;
+
+    Base base;
+    readBase( &base );
+    COUNT64 now = base.m_Monotonic + getElapsedMicroseconds( base );
+    COUNT64 earliest = *m_Deadlines.begin();
+    if ( earliest > now )
+    {
+        COUNT64 delta = earliest - now;
+        base.m_Monotonic += delta;
+        base.m_Epoch += delta;
+        writeBase( base );
+        ++m_Statistics.m_JumpCount;
+        m_Statistics.m_SkippedMicroseconds += delta;
+    }
+}
+
+
+//  readBase()
+//
+//  Retrieves the base values and factor as of a single publication, retrying if a writer gets in the way
+void
+VirtualClock::readBase
+(
+    Base* const         pBase
+) const
+{
+    while ( true )
+    {
+        COUNT64 sequence = m_BaseSequence.load( std::memory_order_acquire );
+        pBase->m_Epoch = m_BaseEpoch.load( std::memory_order_relaxed );
+        pBase->m_Monotonic = m_BaseMonotonic.load( std::memory_order_relaxed );
+        pBase->m_Real = m_BaseReal.load( std::memory_order_relaxed );
+        pBase->m_Factor = m_Factor.load( std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if ( ((sequence & 1) == 0) && (m_BaseSequence.load( std::memory_order_relaxed ) == sequence) )
+            return;
+        std::this_thread::yield();
+    }
+}
+
+
+//  writeBase()
+//
+//  Publishes new base values and factor, so that readBase() sees all of them or none.  Call under m_Mutex.
+void
+VirtualClock::writeBase
+(
+    const Base&         base
+)
+{
+    COUNT64 sequence = m_BaseSequence.load( std::memory_order_relaxed );
+    m_BaseSequence.store( sequence + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    m_BaseEpoch.store( base.m_Epoch, std::memory_order_relaxed );
+    m_BaseMonotonic.store( base.m_Monotonic, std::memory_order_relaxed );
+    m_BaseReal.store( base.m_Real, std::memory_order_relaxed );
+    m_Factor.store( base.m_Factor, std::memory_order_relaxed );
+    m_BaseSequence.store( sequence + 2, std::memory_order_release );
+}
+
+
+
+//  private static methods
+
+//  getElapsedMicroseconds()
+//
+//  Retrieves the time on the given timeline which has elapsed since its last mode change (not counting jumps)
+COUNT64
+VirtualClock::getElapsedMicroseconds
+(
+    const Base&         base
+)
+{
+    COUNT64 real = getRealMicroseconds();
+    return (real > base.m_Real) ? (real - base.m_Real) * base.m_Factor : 0;
+}
+
+//  getRealMicroseconds()
+//
+//  Retrieves the host's monotonic clock, in microseconds
+COUNT64
+VirtualClock::getRealMicroseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>
+            ( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+
+//  public methods
+
+//  beginWait()
+//
+//  Tells the clock that the calling thread is about to block until the given deadline (or until it is woken).
+//  Every beginWait() must be paired with an endWait() on the same Wait object.
+//
+//  Parameters:
+//      deadline:           monotonic microseconds (see getDeadline()), or NO_DEADLINE
+//      pWait:              state for this wait, owned by the caller
+void
+VirtualClock::beginWait
+(
+    const COUNT64       deadline,
+    Wait* const         pWait
+)
+{
+    *pWait = Wait();
+    pWait->m_Deadline = deadline;
+    if ( m_Mode == MODE_REAL )
+        return;
+
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    pWait->m_Registered = true;
+    pWait->m_Participant = participant;
+    if ( deadline != NO_DEADLINE )
+    {
+        pWait->m_itDeadline = m_Deadlines.insert( deadline );
+        pWait->m_HasDeadline = true;
+    }
+
+    if ( pWait->m_Participant )
+        --m_Statistics.m_BusyCount;
+    checkIdle();
+}
+
+
+//  dump()
+//
+//  For debugging
+void
+VirtualClock::dump
+(
+    std::ostream&       stream,
+    const std::string&  prefix
+)
+{
+    Statistics stats = getStatistics();
+    stream << prefix << "VirtualClock"
+        << "  Mode=" << getModeString( m_Mode );
+    if ( m_Mode == MODE_ACCELERATED )
+        stream << "  Factor=" << std::dec << m_Factor;
+    stream << "  Threads=" << std::dec << stats.m_ThreadCount
+        << "  Busy=" << stats.m_BusyCount
+        << "  Waits=" << stats.m_WaitCount
+        << "  Jumps=" << stats.m_JumpCount
+        << "  SkippedMSecs=" << stats.m_SkippedMicroseconds / 1000
+        << std::endl;
+}
+
+
+//  endWait()
+//
+//  Tells the clock that the calling thread has stopped waiting
+void
+VirtualClock::endWait
+(
+    Wait* const         pWait
+)
+{
+    if ( !pWait->m_Registered )
+        return;
+
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    if ( pWait->m_HasDeadline )
+        m_Deadlines.erase( pWait->m_itDeadline );
+    if ( pWait->m_Participant && !pWait->m_Woken )
+        ++m_Statistics.m_BusyCount;
+    pWait->m_Registered = false;
+    checkIdle();
+}
+
+
+//  enterThread()
+//
+//  Makes the calling thread a participant - time will not jump while it is busy
+void
+VirtualClock::enterThread()
+{
+    if ( participant )
+        return;
+
+    participant = true;
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    ++m_Statistics.m_ThreadCount;
+    ++m_Statistics.m_BusyCount;
+}
+
+
+//  exitThread()
+//
+//  The calling thread is no longer a participant - it must not be inside a wait
+void
+VirtualClock::exitThread()
+{
+    if ( !participant )
+        return;
+
+    participant = false;
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    --m_Statistics.m_ThreadCount;
+    --m_Statistics.m_BusyCount;
+    checkIdle();
+}
+
+
+//  getDeadline()
+//
+//  Converts a wait duration into a deadline for beginWait()
+COUNT64
+VirtualClock::getDeadline
+(
+    const COUNT32       milliseconds
+) const
+{
+    return getMonotonicMicroseconds() + static_cast<COUNT64>(milliseconds) * 1000;
+}
+
+
+//  getMicrosecondsSinceEpoch()
+//
+//  Counterpart to SystemTime::getMicrosecondsSinceEpoch(), on our timeline
+COUNT64
+VirtualClock::getMicrosecondsSinceEpoch() const
+{
+    if ( m_Mode == MODE_REAL )
+        return SystemTime::getMicrosecondsSinceEpoch();
+
+    Base base;
+    readBase( &base );
+    return base.m_Epoch + getElapsedMicroseconds( base );
+}
+
+
+//  getMonotonicMicroseconds()
+//
+//  Retrieves our monotonic time.  The origin is arbitrary - this is for measuring intervals and setting deadlines.
+COUNT64
+VirtualClock::getMonotonicMicroseconds() const
+{
+    Base base;
+    readBase( &base );
+    return base.m_Monotonic + getElapsedMicroseconds( base );
+}
+
+
+//  getRealWaitMilliseconds()
+//
+//  Tells a waiter how long to block on the host before checking isWaitExpired() again.
+//  Zero means the deadline has already passed.
+COUNT32
+VirtualClock::getRealWaitMilliseconds
+(
+    const Wait* const   pWait
+) const
+{
+    if ( pWait->m_Deadline == NO_DEADLINE )
+        return SLICE_MILLISECONDS;
+
+    COUNT64 now = getMonotonicMicroseconds();
+    if ( now >= pWait->m_Deadline )
+        return 0;
+
+    COUNT64 remaining = pWait->m_Deadline - now;
+    Mode mode = m_Mode;
+    if ( mode == MODE_ACCELERATED )
+    {
+        COUNT factor = m_Factor;
+        remaining = (remaining + factor - 1) / factor;
+    }
+
+    COUNT64 milliseconds = (remaining + 999) / 1000;
+    if ( (mode == MODE_VIRTUAL) && (milliseconds > SLICE_MILLISECONDS) )
+        milliseconds = SLICE_MILLISECONDS;
+    return static_cast<COUNT32>(milliseconds);
+}
+
+
+//  getStatistics()
+VirtualClock::Statistics
+VirtualClock::getStatistics()
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    Statistics stats = m_Statistics;
+    stats.m_WaitCount = m_Deadlines.size();
+    return stats;
+}
+
+
+//  isWaitExpired()
+//
+//  Returns true if the deadline for the given wait has arrived
+bool
+VirtualClock::isWaitExpired
+(
+    const Wait* const   pWait
+) const
+{
+    return (pWait->m_Deadline != NO_DEADLINE) && (getMonotonicMicroseconds() >= pWait->m_Deadline);
+}
+
+
+//  setMode()
+//
+//  Changes the way time runs.  The factor applies only to ACCELERATED mode.
+//
+//  Returns:
+//      false if the factor is not sensible
+bool
+VirtualClock::setMode
+(
+    const Mode          mode,
+    const COUNT         factor
+)
+{
+    if ( (mode == MODE_ACCELERATED) && ((factor < 1) || (factor > 1000)) )
+        return false;
+
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    Base base;
+    base.m_Monotonic = getMonotonicMicroseconds();
+    base.m_Epoch = (mode == MODE_REAL) ? SystemTime::getMicrosecondsSinceEpoch() : getMicrosecondsSinceEpoch();
+    base.m_Real = getRealMicroseconds();
+    base.m_Factor = (mode == MODE_ACCELERATED) ? factor : 1;
+    writeBase( base );
+    m_Mode = mode;
+    checkIdle();
+
+    return true;
+}
+
+
+//  sleep()
+//
+//  Sleeps for the given number of milliseconds of our time
+void
+VirtualClock::sleep
+(
+    const COUNT32       milliseconds
+)
+{
+    Wait wait;
+    beginWait( getDeadline( milliseconds ), &wait );
+    COUNT32 slice = getRealWaitMilliseconds( &wait );
+    while ( slice > 0 )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds( slice ) );
+        slice = getRealWaitMilliseconds( &wait );
+    }
+    endWait( &wait );
+}
+
+
+//  wake()
+//
+//  Counts the thread doing the given wait as busy again, ahead of its actually waking up.
+//  Call under whatever lock protects the waiter's wakeup condition, so that the Wait cannot go away meanwhile.
+void
+VirtualClock::wake
+(
+    Wait* const         pWait
+)
+{
+    if ( !pWait->m_Registered || !pWait->m_Participant )
+        return;
+
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    if ( !pWait->m_Woken )
+    {
+        pWait->m_Woken = true;
+        ++m_Statistics.m_BusyCount;
+    }
+}
+
+
+
+//  public statics
+
+//  getInstance()
+//
+//  Retrieves the process-wide clock, creating it (in REAL mode) on first use
+VirtualClock*
+VirtualClock::getInstance()
+{
+    std::call_once( instanceOnce, [](){
+        m_pInstance = new VirtualClock();
+    } );
+
+    return m_pInstance;
+}
+
+
+//  getModeString()
+const char*
+VirtualClock::getModeString
+(
+    const Mode          mode
+)
+{
+    switch ( mode )
+    {
+    case MODE_REAL:         return "REAL";
+    case MODE_ACCELERATED:  return "ACCELERATED";
+    case MODE_VIRTUAL:      return "VIRTUAL";
+    }
+
+    return "???";
+}
@@ -0,0 +1,145 @@
+//  VirtualClock.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  The process-wide source of time for everything which waits, sleeps, or asks what time it is on behalf of
+//  the emulated system.  It runs in one of three modes:
+//      REAL:           host time - this is the default, and behaves exactly as if there were no VirtualClock
+//      ACCELERATED:    time runs some whole-number factor faster than host time
+//      VIRTUAL:        time runs at host speed while anyone is busy, but whenever every participating thread is
+//                          waiting, it jumps straight to the earliest pending deadline
+//
+//  Worker threads and WorkerPool carriers are participants.  A participant is busy unless it is inside a
+//  beginWait() / endWait() pair; anyone who ends a wait early (e.g., workerSignal()) calls wake() first, so the
+//  waiter counts as busy from the instant it becomes runnable, rather than when it gets around to running.
+//  Waiters block on the host for at most getRealWaitMilliseconds() at a time, re-checking isWaitExpired().
+//  Since virtual time never runs slower than host time, a participant stuck in a host call (socket, file, etc)
+//  merely keeps the clock from jumping - it cannot stall anyone else's deadline.
+//
+//  Mode changes are intended to be made while the exec is stopped.  Monotonic time is continuous across them;
+//  epoch time returns to the host clock on entering REAL mode.
+
+
+
+#ifndef     MISCLIB_VIRTUAL_CLOCK_H
+#define     MISCLIB_VIRTUAL_CLOCK_H
+
+
+
+class   VirtualClock
+{
+public:
+    enum Mode
+    {
+        MODE_REAL,
+        MODE_ACCELERATED,
+        MODE_VIRTUAL,
+    };
+
+    class   Statistics
+    {
+    public:
+        COUNT                   m_BusyCount;            //  participants not currently waiting
+        COUNT64                 m_JumpCount;            //  times every participant was idle and time jumped ahead
+        COUNT64                 m_SkippedMicroseconds;  //  total time skipped by jumps
+        COUNT                   m_ThreadCount;          //  participating threads
+        COUNT                   m_WaitCount;            //  registered waits with a deadline
+
+        Statistics()
+            :m_BusyCount( 0 ),
+            m_JumpCount( 0 ),
+            m_SkippedMicroseconds( 0 ),
+            m_ThreadCount( 0 ),
+            m_WaitCount( 0 )
+        {}
+    };
+
+    typedef std::multiset<COUNT64>              DEADLINES;
+    typedef DEADLINES::iterator                 ITDEADLINES;
+
+    //  State for one wait by one thread - owned by the waiter, normally on its stack
+    class   Wait
+    {
+    public:
+        COUNT64                 m_Deadline;             //  monotonic microseconds, or NO_DEADLINE
+        bool                    m_HasDeadline;          //  m_itDeadline is valid
+        ITDEADLINES             m_itDeadline;
+        bool                    m_Participant;          //  waiter is a participating thread
+        bool                    m_Registered;           //  known to the clock (i.e., not REAL mode)
+        bool                    m_Woken;                //  wake() has already counted the waiter as busy
+
+        Wait()
+            :m_Deadline( 0 ),
+            m_HasDeadline( false ),
+            m_Participant( false ),
+            m_Registered( false ),
+            m_Woken( false )
+        {}
+    };
+
+    static const COUNT64        NO_DEADLINE = 0xFFFFFFFFFFFFFFFFull;
+
+private:
+    static const COUNT32        SLICE_MILLISECONDS = 5;     //  longest host wait between virtual time checks
+
+    //  A consistent copy of the values our timeline is computed from
+    class   Base
+    {
+    public:
+        COUNT64                 m_Epoch;
+        COUNT64                 m_Monotonic;
+        COUNT64                 m_Real;
+        COUNT                   m_Factor;
+    };
+
+    //  The base values and m_Factor are published together through m_BaseSequence, a seqlock which is odd
+    //  while they are being changed.  Writers must hold m_Mutex.
+    std::atomic<COUNT64>        m_BaseEpoch;            //  epoch microseconds at the last mode change, plus jumps
+    std::atomic<COUNT64>        m_BaseMonotonic;        //  monotonic microseconds at the last mode change, plus jumps
+    std::atomic<COUNT64>        m_BaseReal;             //  host monotonic microseconds at the last mode change
+    std::atomic<COUNT64>        m_BaseSequence;
+    DEADLINES                   m_Deadlines;
+    std::atomic<COUNT>          m_Factor;
+    std::atomic<Mode>           m_Mode;
+    std::mutex                  m_Mutex;                //  Protects m_Deadlines, m_Statistics, and jumps
+    Statistics                  m_Statistics;
+
+    static VirtualClock*        m_pInstance;
+
+    VirtualClock();
+
+    void                        checkIdle();
+    void                        readBase( Base* const pBase ) const;
+    void                        writeBase( const Base& base );
+
+    static COUNT64              getElapsedMicroseconds( const Base& base );
+    static COUNT64              getRealMicroseconds();
+
+public:
+    void                        beginWait( const COUNT64    deadline,
+                                           Wait* const      pWait );
+    void                        dump( std::ostream&         stream,
+                                      const std::string&    prefix );
+    void                        endWait( Wait* const pWait );
+    void                        enterThread();
+    void                        exitThread();
+    COUNT64                     getDeadline( const COUNT32 milliseconds ) const;
+    COUNT64                     getMicrosecondsSinceEpoch() const;
+    COUNT64                     getMonotonicMicroseconds() const;
+    COUNT32                     getRealWaitMilliseconds( const Wait* const pWait ) const;
+    Statistics                  getStatistics();
+    bool                        isWaitExpired( const Wait* const pWait ) const;
+    bool                        setMode( const Mode     mode,
+                                         const COUNT    factor );
+    void                        sleep( const COUNT32 milliseconds );
+    void                        wake( Wait* const pWait );
+
+    inline COUNT                getFactor() const               { return m_Factor; }
+    inline Mode                 getMode() const                 { return m_Mode; }
+
+    static VirtualClock*        getInstance();
+    static const char*          getModeString( const Mode mode );
+};
+
+
+
+#endif
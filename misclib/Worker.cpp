@@ -7,11 +7,26 @@
 
 
 
+//  statics
+
+//  The Worker whose worker() or workerStep() is running on this thread, if any
+#ifdef  WIN32
+static __declspec(thread)   Worker*     currentWorker = 0;
+#else
+static __thread             Worker*     currentWorker = 0;
+#endif
+
+
+
 //  constructors, destructors
 Worker::Worker( const std::string& name )
 	:m_ActiveFlag( false ),
 	m_Name( name ),
+	m_PooledFlag( false ),
 	m_TermFlag( false ),
+    m_PendingSignals( 0 ),
+    m_pClockWait( 0 ),
+    m_TraceNameId( 0 ),
 #ifdef WIN32
     m_EventHandle( 0 ),
 	m_ThreadHandle( reinterpret_cast<HANDLE>(-1) ),
@@ -19,6 +34,7 @@ Worker::Worker( const std::string& name )
 #else
     m_pThreadCondition( 0 ),
     m_ThreadId( 0 ),
+    m_JoinPending( false ),
     m_pThreadMutex( 0 )
 #endif
 {
@@ -26,16 +42,36 @@ Worker::Worker( const std::string& name )
 	// Create event handle
 	m_EventHandle = CreateEvent( NULL, FALSE, FALSE, NULL );
 #else
+    //  Timed waits are measured against the monotonic clock
+    pthread_condattr_t condAttr;
+    pthread_condattr_init( &condAttr );
+    pthread_condattr_setclock( &condAttr, CLOCK_MONOTONIC );
     m_pThreadCondition = new pthread_cond_t;
     m_pThreadMutex = new pthread_mutex_t;
-    pthread_cond_init( m_pThreadCondition, 0 );
+    pthread_cond_init( m_pThreadCondition, &condAttr );
     pthread_mutex_init( m_pThreadMutex, 0 );
+    pthread_condattr_destroy( &condAttr );
 #endif
 }
 
 
 Worker::~Worker()
 {
+    //  Owners must only delete terminated workers - joining a live one here could block forever, so we complain.
+    //  A finished thread which nobody joined is detached, so that its resources are released when it is gone.
+    if ( isWorkerActive() )
+        SYSTEM_LOG( WORKER, ERROR, "Worker " << getWorkerName() << " deleted while still active" );
+
+    //  A thread which has just marked itself inactive may still be on its way out of the exit lock
+    {
+        std::lock_guard<std::mutex> guard( m_ExitMutex );
+    }
+
+#ifndef WIN32
+    if ( m_JoinPending )
+        pthread_detach( m_ThreadId );
+#endif
+
 #ifdef WIN32
 	CloseHandle( m_EventHandle );
     m_EventHandle = 0;
@@ -48,20 +84,213 @@ Worker::~Worker()
 }
 
 
+// private functions
+
+//  applyAffinity()
+//
+//  Applies m_Affinity to our dedicated thread - an empty set lets the thread run on any CPU the process
+//  was allowed at startup.  Caller must hold m_AffinityMutex.
+//
+//  Parameters:
+//      currentThread:      true if the caller is our thread (which may not yet know its own thread id)
+//
+//  Returns:
+//      true if successful
+bool
+Worker::applyAffinity
+(
+    const bool          currentThread
+) const
+{
+    const CpuSet::CPUS& cpus = m_Affinity.getCpus();
+#ifdef WIN32
+    DWORD_PTR mask = 0;
+    for ( CpuSet::CITCPUS itcpu = cpus.begin(); itcpu != cpus.end(); ++itcpu )
+    {
+        if ( *itcpu < sizeof(DWORD_PTR) * 8 )
+            mask |= static_cast<DWORD_PTR>(1) << *itcpu;
+    }
+
+    if ( mask == 0 )
+    {
+        const CpuSet::CPUS& startupCpus = CpuSet::getStartupCpus();
+        for ( CpuSet::CITCPUS itcpu = startupCpus.begin(); itcpu != startupCpus.end(); ++itcpu )
+        {
+            if ( *itcpu < sizeof(DWORD_PTR) * 8 )
+                mask |= static_cast<DWORD_PTR>(1) << *itcpu;
+        }
+    }
+
+    HANDLE hThread = currentThread ? GetCurrentThread() : m_ThreadHandle;
+    return SetThreadAffinityMask( hThread, mask ) != 0;
+#else
+    const CpuSet::CPUS& applied = cpus.empty() ? CpuSet::getStartupCpus() : cpus;
+    cpu_set_t cpuSet;
+    CPU_ZERO( &cpuSet );
+    for ( CpuSet::CITCPUS itcpu = applied.begin(); itcpu != applied.end(); ++itcpu )
+    {
+        if ( *itcpu < CPU_SETSIZE )
+            CPU_SET( *itcpu, &cpuSet );
+    }
+
+    pthread_t thread = currentThread ? pthread_self() : m_ThreadId;
+    return pthread_setaffinity_np( thread, sizeof(cpuSet), &cpuSet ) == 0;
+#endif
+}
+
+
+//  getWorkerTraceNameId()
+//
+//  Retrieves our TraceLog name id, interning our name the first time we are asked.
+//  Only ever asked from our own thread (or the carrier running our step), so there is no race.
+UINT32
+Worker::getWorkerTraceNameId() const
+{
+    if ( m_TraceNameId == 0 )
+        m_TraceNameId = TraceLog::intern( m_Name );
+    return m_TraceNameId;
+}
+
+
+//  setInactive()
+//
+//  Marks us terminated, and wakes anyone in workerJoin().
+//  This is the last thing our thread (or the pool) does with us - the owner may delete us as soon as it is done.
+void
+Worker::setInactive()
+{
+    std::lock_guard<std::mutex> guard( m_ExitMutex );
+    m_TermFlag = true;
+    m_ActiveFlag = false;
+    m_ExitCondition.notify_all();
+}
+
+
+//  workerPoolStep()
+//
+//  Invoked by the WorkerPool - runs our next step
+COUNT32
+Worker::workerPoolStep()
+{
+    currentWorker = this;
+    COUNT32 result = workerStep();
+    currentWorker = 0;
+
+    return result;
+}
+
+
+//  workerStepsComplete()
+//
+//  Invoked by the WorkerPool once workerPoolStep() returns STEP_DONE.
+void
+Worker::workerStepsComplete()
+{
+    SYSTEM_LOG( WORKER, INFO, "Worker steps complete for " << getWorkerName() );
+
+    workerExiting();
+    setInactive();
+}
+
+
 // other functions
 
+//  getWorkerAffinity()
+//
+//  Retrieves the set of CPUs to which our thread is (or will be) pinned
+CpuSet
+Worker::getWorkerAffinity() const
+{
+    std::lock_guard<std::mutex> guard( m_AffinityMutex );
+    return m_Affinity;
+}
+
+
+//  getWorkerWakeupStatistics()
+//
+//  Retrieves a snapshot of our signal/wakeup counters
+Worker::WakeupStatistics
+Worker::getWorkerWakeupStatistics() const
+{
+#ifdef WIN32
+    m_SignalMutex.lock();
+    WakeupStatistics stats = m_WakeupStatistics;
+    m_SignalMutex.unlock();
+#else
+    pthread_mutex_lock( m_pThreadMutex );
+    WakeupStatistics stats = m_WakeupStatistics;
+    pthread_mutex_unlock( m_pThreadMutex );
+#endif
+    return stats;
+}
+
+
+//  workerJoin()
+//
+//  Waits for a terminating worker to finish.  For a dedicated thread this joins the thread, releasing its
+//  resources, if that has not already been done.  For a pooled worker, it waits until the pool is done with us.
+void
+Worker::workerJoin()
+{
+    {
+        std::unique_lock<std::mutex> lock( m_ExitMutex );
+        if ( m_ActiveFlag )
+        {
+            //  We may be on a carrier, and what we are waiting for may need one
+            WorkerPool::BlockingScope blocking;
+            m_ExitCondition.wait( lock, [this](){ return !m_ActiveFlag; } );
+        }
+    }
+
+#ifndef WIN32
+    if ( !m_PooledFlag && m_JoinPending )
+    {
+        pthread_join( m_ThreadId, 0 );
+        std::lock_guard<std::mutex> guard( m_AffinityMutex );
+        m_JoinPending = false;
+    }
+#endif
+}
+
+
+//  workerSetAffinity()
+//
+//  Pins our thread to the given set of host CPUs (or unpins it, for an empty set).
+//  If the thread is running, this takes effect immediately; otherwise it takes effect when the thread starts.
+//  Memory the thread allocates and first touches afterward will generally come from the NUMA node it runs on.
+//
+//  Returns:
+//      false if we are a pooled worker, or the host refused the request
+bool
+Worker::workerSetAffinity
+(
+    const CpuSet&       cpuSet
+)
+{
+    if ( m_PooledFlag || isWorkerSteppable() )
+        return false;
+
+    std::lock_guard<std::mutex> guard( m_AffinityMutex );
+    m_Affinity = cpuSet;
+#ifdef WIN32
+    if ( m_ActiveFlag && (m_ThreadHandle != reinterpret_cast<HANDLE>(-1)) )
+        return applyAffinity( false );
+#else
+    if ( m_ActiveFlag && m_JoinPending )
+        return applyAffinity( false );
+#endif
+
+    return true;
+}
+
+
 //  workerSetTermFlag()
 //
 //  Sets the term flag, which the derived class's worker thread should be polling.
 void
 Worker::workerSetTermFlag()
 {
-    if ( WORKER_LOGGING )
-    {
-        std::string logStr = "Setting term flag for worker ";
-        logStr += getWorkerName();
-        SystemLog::getInstance()->write( logStr );
-    }
+    SYSTEM_LOG( WORKER, INFO, "Setting term flag for worker " << getWorkerName() );
 
     m_TermFlag = true;
 }
@@ -71,13 +300,30 @@ Worker::workerSetTermFlag()
 //
 //  Allows any client to signal the Worker that something is ready, or needs attention.
 //  Useful for waking up the worker from some sleeping state.
+//  The signal is latched until the worker next waits, so it cannot be lost.
 void
 Worker::workerSignal() const
 {
+    //  A pooled worker may be parked between steps, or (rarely) inside a workerWait() within a step - wake both.
+    if ( m_PooledFlag )
+        WorkerPool::getInstance()->signal( const_cast<Worker*>( this ) );
+
 #ifdef WIN32
-    SetEvent( m_EventHandle );
+    m_SignalMutex.lock();
 #else
     pthread_mutex_lock( m_pThreadMutex );
+#endif
+
+    ++m_WakeupStatistics.m_SignalCount;
+    if ( m_PendingSignals++ == 0 )
+        m_FirstPendingSignalTime = std::chrono::steady_clock::now();
+    if ( m_pClockWait )
+        VirtualClock::getInstance()->wake( m_pClockWait );
+
+#ifdef WIN32
+    m_SignalMutex.unlock();
+    SetEvent( m_EventHandle );
+#else
     pthread_cond_signal( m_pThreadCondition );
     pthread_mutex_unlock( m_pThreadMutex );
 #endif
@@ -93,17 +339,29 @@ Worker::workerStart()
     if ( isWorkerActive() )
         return false;
 
+    //  Reap the thread from any previous start
+    workerJoin();
+
     m_ActiveFlag = true;
     m_TermFlag = false;
 
-    // Create thread
+    // Steppable workers share the pool's threads rather than getting one of their own
+    m_PooledFlag = isWorkerSteppable();
+    if ( m_PooledFlag )
+    {
+        SYSTEM_LOG( WORKER, INFO, "Scheduling pooled worker for " << getWorkerName() );
+
+        WorkerPool::getInstance()->schedule( this );
+        return true;
+    }
+
+    // Create thread - the new thread applies our affinity, once we've finished recording its id
+    std::lock_guard<std::mutex> guard( m_AffinityMutex );
 #ifdef WIN32
     m_ThreadHandle = reinterpret_cast<HANDLE>(_beginthread( Worker::workerThreadProc, 0, reinterpret_cast<void*>(this) ));
     if ( m_ThreadHandle == reinterpret_cast<HANDLE>(-1) )
     {
-        std::string logStr = "Failed to start thread for ";
-        logStr += this->getWorkerName();
-        SystemLog::getInstance()->write( logStr );
+        SYSTEM_LOG( WORKER, ERROR, "Failed to start thread for " << getWorkerName() );
         m_ActiveFlag = false;
         return false;
     }
@@ -111,12 +369,11 @@ Worker::workerStart()
     int retn = pthread_create( &m_ThreadId, 0, workerThreadProc, this );
     if ( retn != 0 )
     {
-        std::string logStr = "Failed to start thread for ";
-        logStr += this->getWorkerName();
-        SystemLog::getInstance()->write( logStr );
+        SYSTEM_LOG( WORKER, ERROR, "Failed to start thread for " << getWorkerName() );
         m_ActiveFlag = false;
         return false;
     }
+    m_JoinPending = true;
 #endif
 
     return true;
@@ -142,14 +399,7 @@ Worker::workerStop
     workerSetTermFlag();
     workerSignal();
     if ( waitFlag )
-    {
-#ifdef WIN32
-        while ( isWorkerActive() )
-            Sleep( 0 );
-#else
-        pthread_join( m_ThreadId, 0 );
-#endif
-    }
+        workerJoin();
 
     return true;
 }
@@ -157,31 +407,104 @@ Worker::workerStop
 
 //  workerWait()
 //
-//  Sleep for the indicated number of milliseconds, or until we are signaled.
-void
+//  Sleep for the indicated number of milliseconds (of VirtualClock time), or until we are signaled.
+//  If one or more signals arrived since our last wait, we return immediately, consuming all of them.
+//
+//  Returns:
+//      true if we were signaled, false if we timed out
+bool
 Worker::workerWait
     (
     const COUNT32       Milliseconds
     ) const
 {
-#ifdef WIN32
-    WaitForSingleObjectEx( m_EventHandle, Milliseconds, TRUE );
-#else
-    COUNT64 million = 1000000UL;
+    //  The clock tells us how long to block on the host at a stretch - all of it in REAL mode,
+    //  or short slices in VIRTUAL mode, where time may jump ahead while we are blocked.
+    VirtualClock* pClock = VirtualClock::getInstance();
+    VirtualClock::Wait clockWait;
 
-    struct timeval tvNow;
-    gettimeofday( &tvNow, 0 );
-    COUNT64 millisNow = (static_cast<COUNT64>(tvNow.tv_sec) * million) + tvNow.tv_usec;
-    COUNT64 millisLimit = millisNow + Milliseconds;
+#ifdef WIN32
+    m_SignalMutex.lock();
+    bool pending = m_PendingSignals > 0;
+    if ( !pending )
+    {
+        pClock->beginWait( pClock->getDeadline( Milliseconds ), &clockWait );
+        m_pClockWait = &clockWait;
+    }
+    m_SignalMutex.unlock();
 
-    struct timespec timeToWait;
-    timeToWait.tv_sec = millisLimit / million;
-    timeToWait.tv_nsec = (millisLimit % million) * 1000UL;
+    if ( pending )
+        ResetEvent( m_EventHandle );
+    else
+    {
+        WorkerPool::BlockingScope blocking;
+        COUNT32 slice = pClock->getRealWaitMilliseconds( &clockWait );
+        while ( (slice > 0) && (WaitForSingleObjectEx( m_EventHandle, slice, TRUE ) == WAIT_TIMEOUT) )
+            slice = pClock->getRealWaitMilliseconds( &clockWait );
+    }
 
+    m_SignalMutex.lock();
+    if ( !pending )
+    {
+        m_pClockWait = 0;
+        pClock->endWait( &clockWait );
+    }
+#else
     pthread_mutex_lock( m_pThreadMutex );
-    pthread_cond_timedwait( m_pThreadCondition, m_pThreadMutex, &timeToWait );
+    if ( m_PendingSignals == 0 )
+    {
+        pClock->beginWait( pClock->getDeadline( Milliseconds ), &clockWait );
+        m_pClockWait = &clockWait;
+
+        WorkerPool::BlockingScope blocking;
+        COUNT32 slice = pClock->getRealWaitMilliseconds( &clockWait );
+        while ( (m_PendingSignals == 0) && (slice > 0) )
+        {
+            struct timespec deadline;
+            clock_gettime( CLOCK_MONOTONIC, &deadline );
+            deadline.tv_sec += slice / 1000;
+            deadline.tv_nsec += static_cast<long>(slice % 1000) * 1000000L;
+            if ( deadline.tv_nsec >= 1000000000L )
+            {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+
+            pthread_cond_timedwait( m_pThreadCondition, m_pThreadMutex, &deadline );
+            slice = pClock->getRealWaitMilliseconds( &clockWait );
+        }
+
+        m_pClockWait = 0;
+        pClock->endWait( &clockWait );
+    }
+#endif
+
+    bool signaled = m_PendingSignals > 0;
+    if ( signaled )
+    {
+        COUNT64 latency = std::chrono::duration_cast<std::chrono::microseconds>
+                            ( std::chrono::steady_clock::now() - m_FirstPendingSignalTime ).count();
+        ++m_WakeupStatistics.m_WakeupCount;
+        m_WakeupStatistics.m_TotalLatencyUSecs += latency;
+        if ( latency > m_WakeupStatistics.m_MaxLatencyUSecs )
+            m_WakeupStatistics.m_MaxLatencyUSecs = latency;
+        m_PendingSignals = 0;
+
+        if ( TraceLog::isEnabled() )
+        {
+            TraceLog::record( TraceLog::EVENT_WORKER_WAKEUP, TraceLog::PHASE_INSTANT, 0, getWorkerTraceNameId(), latency );
+        }
+    }
+    else
+        ++m_WakeupStatistics.m_TimeoutCount;
+
+#ifdef WIN32
+    m_SignalMutex.unlock();
+#else
     pthread_mutex_unlock( m_pThreadMutex );
 #endif
+
+    return signaled;
 }
 
 
@@ -200,29 +523,33 @@ Worker::workerThreadProc
     void* const         pWorker
     )
 {
-    std::string         logStr;
     Worker*             pw;
 
     pw = static_cast<Worker*>( pWorker );
 
-    if ( WORKER_LOGGING )
-    {
-        logStr = "Starting worker for ";
-        logStr += pw->getWorkerName();
-        SystemLog::getInstance()->write( logStr );
-    }
+    pw->m_AffinityMutex.lock();
+    if ( !pw->m_Affinity.isEmpty() && !pw->applyAffinity( true ) )
+        SYSTEM_LOG( WORKER, WARNING, "Cannot set CPU affinity for " << pw->getWorkerName() );
+    pw->m_AffinityMutex.unlock();
+    TraceLog::setThreadName( pw->getWorkerName() );
+
+    SYSTEM_LOG( WORKER, INFO, "Starting worker for " << pw->getWorkerName() );
+
+    bool clockParticipant = pw->isWorkerClockParticipant();
+    if ( clockParticipant )
+        VirtualClock::getInstance()->enterThread();
 
+    currentWorker = pw;
     pw->worker();
+    currentWorker = 0;
 
-    if ( WORKER_LOGGING )
-    {
-        logStr = "Worker exiting for ";
-        logStr += pw->getWorkerName();
-        SystemLog::getInstance()->write( logStr );
-    }
+    if ( clockParticipant )
+        VirtualClock::getInstance()->exitThread();
+
+    SYSTEM_LOG( WORKER, INFO, "Worker exiting for " << pw->getWorkerName() );
 
-    pw->m_TermFlag = true;
-    pw->m_ActiveFlag = false;
+    pw->workerExiting();
+    pw->setInactive();
 #ifdef  WIN32
     _endthread();
 #else
@@ -230,3 +557,16 @@ Worker::workerThreadProc
 #endif
 }
 
+
+//  getCurrentWorker()
+//
+//  Retrieves the Worker running on the calling thread (on its own thread, or as a WorkerPool step), if any.
+//  Lets code which is handed no Worker pointer still sleep until signaled, rather than polling.
+//
+//  Static.
+Worker*
+Worker::getCurrentWorker()
+{
+    return currentWorker;
+}
+
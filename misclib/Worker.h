@@ -2,6 +2,21 @@
 //  Copyright (c) 2015 by Kurt Duncan
 //
 //	Base class for anything that wants to have a basic worker thread
+//
+//  workerSignal() is latched: a signal sent while the worker is not waiting is remembered, and satisfies the
+//  next workerWait() immediately.  Any number of signals sent between waits are consumed by a single wakeup.
+//  Wait deadlines are measured on the monotonic clock, so they are unaffected by host clock changes.
+//
+//  Derived classes may override workerExiting() to learn, on the worker's own thread, that it is about to
+//  terminate - so that whoever owns the object can reclaim it promptly.  A terminated thread is joined by
+//  workerJoin() or workerStop() with the wait flag; if neither happened, the destructor detaches it.
+//  Deleting a worker which is still active is an error.
+//
+//  A dedicated worker thread may be pinned to a CpuSet with workerSetAffinity(), before or after it is started.
+//  Pooled workers run on threads shared with others, and cannot be pinned.
+//
+//  Waits are measured on the VirtualClock, and worker threads take part in its idle detection unless the derived
+//  class overrides isWorkerClockParticipant() (as it should, if it spends its time blocked in host calls).
 
 
 
@@ -10,12 +25,53 @@
 
 
 
+#include    "VirtualClock.h"
+
+
+
 class Worker
 {
+public:
+    class WakeupStatistics
+    {
+    public:
+        COUNT64                 m_SignalCount;          //  workerSignal() invocations
+        COUNT64                 m_WakeupCount;          //  workerWait() calls satisfied by a signal
+        COUNT64                 m_TimeoutCount;         //  workerWait() calls which timed out
+        COUNT64                 m_TotalLatencyUSecs;    //  sum of (first pending signal -> waiter resumes)
+        COUNT64                 m_MaxLatencyUSecs;
+
+        WakeupStatistics()
+            :m_SignalCount( 0 ),
+            m_WakeupCount( 0 ),
+            m_TimeoutCount( 0 ),
+            m_TotalLatencyUSecs( 0 ),
+            m_MaxLatencyUSecs( 0 )
+        {}
+    };
+
 private:
     bool                        m_ActiveFlag;
+    CpuSet                      m_Affinity;
+    mutable std::mutex          m_AffinityMutex;    // protects m_Affinity, and the thread id while starting
+    std::condition_variable     m_ExitCondition;    // notified when m_ActiveFlag goes false
+    mutable std::mutex          m_ExitMutex;        // protects m_ExitCondition
     const std::string           m_Name;
+    bool                        m_PooledFlag;       // running as a sequence of steps on the WorkerPool
     bool                        m_TermFlag;
+
+    //  Latched signal state - protected by m_pThreadMutex (m_SignalMutex for WIN32)
+    mutable COUNT               m_PendingSignals;
+    mutable std::chrono::steady_clock::time_point
+                                m_FirstPendingSignalTime;
+    mutable WakeupStatistics    m_WakeupStatistics;
+    mutable VirtualClock::Wait* m_pClockWait;       //  non-null while we are inside workerWait()
+    mutable UINT32              m_TraceNameId;      //  TraceLog name id, interned on first use
+
+#ifdef WIN32
+    mutable std::mutex          m_SignalMutex;
+#endif
+
 #ifdef WIN32
     HANDLE                      m_EventHandle;
     HANDLE                      m_ThreadHandle;
@@ -23,6 +79,7 @@ private:
 #else
     pthread_cond_t *            m_pThreadCondition;
     pthread_t                   m_ThreadId;
+    bool                        m_JoinPending;      // thread was created and has not yet been joined
     pthread_mutex_t *           m_pThreadMutex;     // private mutex; others must use Lockable implementation
 #endif
 
@@ -32,17 +89,47 @@ private:
     typedef void *              THREADPROCRETURN;
 #endif
 
-    static const bool           WORKER_LOGGING = true;
     static THREADPROCRETURN     workerThreadProc( void* pArg );
     virtual void                worker() = 0;
 
+    bool                        applyAffinity( const bool currentThread ) const;
+    UINT32                      getWorkerTraceNameId() const;
+    void                        setInactive();
+    COUNT32                     workerPoolStep();
+    void                        workerStepsComplete();
+
+    friend class WorkerPool;
+
+protected:
+    //  Derived classes which can do their work in short, non-blocking steps may say so via isWorkerSteppable().
+    //  They are then run by the WorkerPool, which calls workerStep() repeatedly instead of calling worker()
+    //  on a dedicated thread.  workerStep() returns the number of milliseconds to wait before the next step
+    //  (a workerSignal() cuts the wait short), or STEP_DONE when the worker is finished.
+    static const COUNT32        STEP_DONE = 0xFFFFFFFF;
+
+    virtual bool                isWorkerSteppable() const       { return false; }
+    virtual COUNT32             workerStep()                    { return STEP_DONE; }
+
+    //  Invoked on the worker's thread (or pool carrier) after worker() returns or the last step completes,
+    //  just before we are marked terminated.  The object must not be deleted from within this call.
+    virtual void                workerExiting()                 {}
+
+    //  Workers which block in host calls rather than in workerWait() should not hold back virtual time
+    virtual bool                isWorkerClockParticipant() const    { return true; }
+
 public:
     Worker( const std::string& Name );
     virtual ~Worker();
 
+    CpuSet                      getWorkerAffinity() const;
+    WakeupStatistics            getWorkerWakeupStatistics() const;
+    void                        workerJoin();
+    bool                        workerSetAffinity( const CpuSet& cpuSet );
     void                        workerSignal() const;
     void                        workerSetTermFlag();
-    void                        workerWait( const COUNT32 Milliseconds ) const;
+    bool                        workerWait( const COUNT32 Milliseconds ) const;
+
+    static Worker*              getCurrentWorker();
 
     inline const std::string&   getWorkerName() const           { return m_Name; }
     inline bool                 isWorkerActive() const          { return m_ActiveFlag; }
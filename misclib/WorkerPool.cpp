@@ -0,0 +1,485 @@
+//  WorkerPool class implementation
+//  Copyright (c) 2015 by Kurt Duncan
+
+
+
+#include    "misclib.h"
+
+
+
+//  statics
+
+WorkerPool*         WorkerPool::m_pInstance = 0;
+
+static std::once_flag   instanceOnce;
+
+#ifdef  WIN32
+static __declspec(thread)   INDEX   currentCarrier = static_cast<INDEX>(-1);
+#else
+static __thread             INDEX   currentCarrier = static_cast<INDEX>(-1);
+#endif
+
+
+
+//  constructors, destructors
+
+WorkerPool::WorkerPool
+(
+    const COUNT         targetCarriers
+)
+:m_ActiveCarriers( 0 ),
+m_BlockedCarriers( 0 ),
+m_CarrierCount( 0 ),
+m_Carriers( MAX_CARRIERS, 0 ),
+m_NextCarrier( 0 ),
+m_TargetCarriers( targetCarriers )
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    for ( INDEX cx = 0; cx < targetCarriers; ++cx )
+        startCarrier();
+}
+
+
+
+//  private methods
+
+//  beginBlocking()
+//
+//  A step on the calling carrier is about to wait.  If that leaves fewer unblocked carriers than we want,
+//  add one - it will steal whatever is queued behind the waiting step.
+void
+WorkerPool::beginBlocking()
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    ++m_BlockedCarriers;
+    if ( (m_ActiveCarriers - m_BlockedCarriers < m_TargetCarriers) && (m_ActiveCarriers < MAX_CARRIERS) )
+        startCarrier();
+    else if ( hasQueuedWork() )
+        wakeCarrier();
+}
+
+
+//  carrierLoop()
+//
+//  Main loop for each carrier thread
+void
+WorkerPool::carrierLoop
+(
+    const INDEX         carrierIndex
+)
+{
+    currentCarrier = carrierIndex;
+
+    std::stringstream strm;
+    strm << "WorkerPool carrier " << carrierIndex;
+    TraceLog::setThreadName( strm.str() );
+
+    VirtualClock* pClock = VirtualClock::getInstance();
+    pClock->enterThread();
+
+    while ( true )
+    {
+        Worker* pWorker = findWork( carrierIndex );
+        if ( pWorker )
+        {
+            runStep( pWorker );
+            continue;
+        }
+
+        //  Nothing queued anywhere - move expired timers to our own queue, or sleep until the next one expires
+        //  (or until something gets queued).
+        std::unique_lock<std::mutex> lock( m_Mutex );
+        COUNT64 now = pClock->getMonotonicMicroseconds();
+        if ( !m_Timers.empty() && (m_Timers.begin()->first <= now) )
+        {
+            while ( !m_Timers.empty() && (m_Timers.begin()->first <= now) )
+            {
+                Worker* pExpired = m_Timers.begin()->second;
+                m_Timers.erase( m_Timers.begin() );
+                m_WorkerEntries[pExpired].m_State = WS_QUEUED;
+                enqueue( pExpired );
+            }
+            continue;
+        }
+
+        //  enqueue() runs under m_Mutex, so if nothing is queued now, its wakeCarrier() cannot get in ahead of our wait
+        if ( hasQueuedWork() )
+            continue;
+
+        //  Nothing to do, and enough carriers without us once the waits which called us into being have ended
+        if ( m_ActiveCarriers - m_BlockedCarriers > m_TargetCarriers )
+        {
+            retireCarrier( carrierIndex );
+            lock.unlock();
+            pClock->exitThread();
+            currentCarrier = static_cast<INDEX>(-1);
+            return;
+        }
+
+        //  Unless the clock is REAL, we wait in the slices it asks for - time may jump while we are waiting,
+        //  and a carrier which wakeCarrier() counted as busy must get going even if the notify went elsewhere.
+        VirtualClock::Wait clockWait;
+        pClock->beginWait( m_Timers.empty() ? VirtualClock::NO_DEADLINE : m_Timers.begin()->first, &clockWait );
+        m_IdleWaits.push_back( &clockWait );
+
+        if ( m_Timers.empty() && (pClock->getMode() == VirtualClock::MODE_REAL) )
+            m_Condition.wait( lock );
+        else
+            m_Condition.wait_for( lock, std::chrono::milliseconds( pClock->getRealWaitMilliseconds( &clockWait ) ) );
+
+        std::deque<VirtualClock::Wait*>::iterator itw = std::find( m_IdleWaits.begin(), m_IdleWaits.end(), &clockWait );
+        if ( itw != m_IdleWaits.end() )
+            m_IdleWaits.erase( itw );
+        pClock->endWait( &clockWait );
+    }
+}
+
+
+//  endBlocking()
+//
+//  A step on the calling carrier has finished waiting.  If that leaves a surplus of unblocked carriers,
+//  wake an idle one so that it can retire.
+void
+WorkerPool::endBlocking()
+{
+    std::lock_guard<std::mutex> guard( m_Mutex );
+    --m_BlockedCarriers;
+    if ( m_ActiveCarriers - m_BlockedCarriers > m_TargetCarriers )
+        wakeCarrier();
+}
+
+
+//  enqueue()
+//
+//  Puts a Worker on a run queue - the calling carrier's own, if the caller is a carrier.
+//  Otherwise, the next active carrier's in turn - retired ones are passed over.
+//  Call under m_Mutex.
+void
+WorkerPool::enqueue
+(
+    Worker* const       pWorker
+)
+{
+    COUNT carrierCount = m_CarrierCount.load();
+    INDEX cx = currentCarrier;
+    if ( cx >= carrierCount )
+    {
+        cx = m_NextCarrier % carrierCount;
+        while ( !m_Carriers[cx]->m_Active )
+            cx = (cx + 1) % carrierCount;
+        m_NextCarrier = (cx + 1) % carrierCount;
+    }
+
+    Carrier* pCarrier = m_Carriers[cx];
+    pCarrier->lock();
+    pCarrier->m_RunQueue.push_back( pWorker );
+    pCarrier->unlock();
+    wakeCarrier();
+}
+
+
+//  findWork()
+//
+//  Takes the most recently queued Worker from our own run queue, or failing that,
+//  the least recently queued Worker from some other carrier's run queue.
+Worker*
+WorkerPool::findWork
+(
+    const INDEX         carrierIndex
+)
+{
+    Carrier* pOwn = m_Carriers[carrierIndex];
+    pOwn->lock();
+    if ( !pOwn->m_RunQueue.empty() )
+    {
+        Worker* pWorker = pOwn->m_RunQueue.back();
+        pOwn->m_RunQueue.pop_back();
+        pOwn->unlock();
+        return pWorker;
+    }
+    pOwn->unlock();
+
+    COUNT carrierCount = m_CarrierCount.load();
+    for ( INDEX offset = 1; offset < carrierCount; ++offset )
+    {
+        Carrier* pVictim = m_Carriers[(carrierIndex + offset) % carrierCount];
+        pVictim->lock();
+        if ( !pVictim->m_RunQueue.empty() )
+        {
+            Worker* pWorker = pVictim->m_RunQueue.front();
+            pVictim->m_RunQueue.pop_front();
+            pVictim->unlock();
+
+            m_Mutex.lock();
+            ++m_Statistics.m_StealCount;
+            m_Mutex.unlock();
+            return pWorker;
+        }
+        pVictim->unlock();
+    }
+
+    return 0;
+}
+
+
+//  hasQueuedWork()
+//
+//  Checks whether any run queue is non-empty
+bool
+WorkerPool::hasQueuedWork() const
+{
+    COUNT carrierCount = m_CarrierCount.load();
+    for ( INDEX cx = 0; cx < carrierCount; ++cx )
+    {
+        Carrier* pCarrier = m_Carriers[cx];
+        pCarrier->lock();
+        bool empty = pCarrier->m_RunQueue.empty();
+        pCarrier->unlock();
+        if ( !empty )
+            return true;
+    }
+
+    return false;
+}
+
+
+//  retireCarrier()
+//
+//  Takes the calling carrier out of service - its run queue must be empty, and its thread is about to exit.
+//  Call under m_Mutex.
+void
+WorkerPool::retireCarrier
+(
+    const INDEX         carrierIndex
+)
+{
+    Carrier* pCarrier = m_Carriers[carrierIndex];
+    pCarrier->m_Active = false;
+    pCarrier->m_Thread.detach();
+    --m_ActiveCarriers;
+    ++m_Statistics.m_RetireCount;
+}
+
+
+//  runStep()
+//
+//  Runs one step for the given Worker, then queues it, parks it, or lets it go.
+void
+WorkerPool::runStep
+(
+    Worker* const       pWorker
+)
+{
+    m_Mutex.lock();
+    WorkerEntry& entry = m_WorkerEntries[pWorker];
+    entry.m_State = WS_RUNNING;
+    entry.m_Signaled = false;
+    ++m_Statistics.m_StepCount;
+    m_Mutex.unlock();
+
+    bool tracing = TraceLog::isEnabled();
+    if ( tracing )
+        TraceLog::record( TraceLog::EVENT_WORKER_STEP, TraceLog::PHASE_BEGIN, 0, pWorker->getWorkerTraceNameId() );
+
+    COUNT32 delayMSec = pWorker->workerPoolStep();
+
+    if ( tracing )
+        TraceLog::record( TraceLog::EVENT_WORKER_STEP, TraceLog::PHASE_END, 0 );
+
+    m_Mutex.lock();
+    if ( delayMSec == Worker::STEP_DONE )
+    {
+        m_WorkerEntries.erase( pWorker );
+        m_Mutex.unlock();
+
+        //  The Worker may be deleted by its owner as soon as this happens, so it must come last.
+        pWorker->workerStepsComplete();
+        return;
+    }
+
+    WorkerEntry& after = m_WorkerEntries[pWorker];
+    if ( after.m_Signaled || (delayMSec == 0) || pWorker->isWorkerTerminating() )
+    {
+        after.m_State = WS_QUEUED;
+        enqueue( pWorker );
+    }
+    else
+    {
+        after.m_State = WS_WAITING;
+        after.m_itTimer = m_Timers.insert( std::make_pair( VirtualClock::getInstance()->getDeadline( delayMSec ),
+                                                           pWorker ) );
+        wakeCarrier();
+    }
+    m_Mutex.unlock();
+}
+
+
+//  startCarrier()
+//
+//  Adds a carrier thread, in the slot of a retired carrier if there is one.  Otherwise, its Carrier is in place
+//  before the count says so, for those who look without m_Mutex.
+//  Call under m_Mutex.
+void
+WorkerPool::startCarrier()
+{
+    COUNT carrierCount = m_CarrierCount.load();
+    INDEX cx = 0;
+    while ( (cx < carrierCount) && m_Carriers[cx]->m_Active )
+        ++cx;
+
+    Carrier* pCarrier = 0;
+    if ( cx < carrierCount )
+        pCarrier = m_Carriers[cx];
+    else
+    {
+        pCarrier = new Carrier();
+        m_Carriers[cx] = pCarrier;
+        m_CarrierCount.store( cx + 1 );
+    }
+
+    pCarrier->m_Active = true;
+    ++m_ActiveCarriers;
+    pCarrier->m_Thread = std::thread( &WorkerPool::carrierLoop, this, cx );
+}
+
+
+//  wakeCarrier()
+//
+//  Wakes an idle carrier, if there is one, to look at the run queues and timers.
+//  Call under m_Mutex.
+void
+WorkerPool::wakeCarrier()
+{
+    if ( !m_IdleWaits.empty() )
+    {
+        VirtualClock::getInstance()->wake( m_IdleWaits.front() );
+        m_IdleWaits.pop_front();
+    }
+
+    m_Condition.notify_one();
+}
+
+
+
+//  public methods
+
+//  dump()
+//
+//  For debugging
+void
+WorkerPool::dump
+(
+    std::ostream&       stream,
+    const std::string&  prefix
+)
+{
+    Statistics stats = getStatistics();
+    stream << prefix << "WorkerPool"
+        << "  Carriers=" << std::dec << stats.m_CarrierCount
+        << "  Target=" << stats.m_TargetCarrierCount
+        << "  Blocked=" << stats.m_BlockedCarrierCount
+        << "  Workers=" << stats.m_WorkerCount
+        << "  Steps=" << stats.m_StepCount
+        << "  Steals=" << stats.m_StealCount
+        << "  Retired=" << stats.m_RetireCount
+        << std::endl;
+}
+
+
+//  getStatistics()
+WorkerPool::Statistics
+WorkerPool::getStatistics()
+{
+    m_Mutex.lock();
+    Statistics stats = m_Statistics;
+    stats.m_BlockedCarrierCount = m_BlockedCarriers;
+    stats.m_CarrierCount = m_ActiveCarriers;
+    stats.m_TargetCarrierCount = m_TargetCarriers;
+    stats.m_WorkerCount = m_WorkerEntries.size();
+    m_Mutex.unlock();
+    return stats;
+}
+
+
+//  schedule()
+//
+//  Brings a (newly-started) steppable Worker into the pool
+void
+WorkerPool::schedule
+(
+    Worker* const       pWorker
+)
+{
+    m_Mutex.lock();
+    m_WorkerEntries[pWorker] = WorkerEntry();
+    enqueue( pWorker );
+    m_Mutex.unlock();
+}
+
+
+//  signal()
+//
+//  Cuts short any wait the given Worker is doing between steps.
+//  If it is in the middle of a step, it will get another step as soon as this one is done.
+void
+WorkerPool::signal
+(
+    Worker* const       pWorker
+)
+{
+    m_Mutex.lock();
+    ITWORKERENTRIES itwe = m_WorkerEntries.find( pWorker );
+    if ( itwe != m_WorkerEntries.end() )
+    {
+        WorkerEntry& entry = itwe->second;
+        if ( entry.m_State == WS_RUNNING )
+            entry.m_Signaled = true;
+        else if ( entry.m_State == WS_WAITING )
+        {
+            m_Timers.erase( entry.m_itTimer );
+            entry.m_State = WS_QUEUED;
+            enqueue( pWorker );
+        }
+    }
+    m_Mutex.unlock();
+}
+
+
+
+//  BlockingScope
+
+WorkerPool::BlockingScope::BlockingScope()
+    :m_Counted( currentCarrier != static_cast<INDEX>(-1) )
+{
+    //  Only carriers set currentCarrier, so if this is one, the pool exists
+    if ( m_Counted )
+        m_pInstance->beginBlocking();
+}
+
+
+WorkerPool::BlockingScope::~BlockingScope()
+{
+    if ( m_Counted )
+        m_pInstance->endBlocking();
+}
+
+
+
+//  public statics
+
+//  getInstance()
+//
+//  Retrieves the process-wide pool, creating it (with one carrier per host core, but at least two) on first use.
+//  More carriers are added later, as steps block.
+WorkerPool*
+WorkerPool::getInstance()
+{
+    std::call_once( instanceOnce, [](){
+        COUNT carriers = std::thread::hardware_concurrency();
+        if ( carriers < 2 )
+            carriers = 2;
+        m_pInstance = new WorkerPool( carriers );
+    } );
+
+    return m_pInstance;
+}
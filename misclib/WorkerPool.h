@@ -0,0 +1,150 @@
+//  WorkerPool.h
+//  Copyright (c) 2015 by Kurt Duncan
+//
+//  Runs pooled Workers on a set of carrier threads which scales with the host's cores, instead of
+//  giving each of them a dedicated thread.  A steppable Worker does a bounded amount of work in each
+//  call to workerStep(), and returns the number of milliseconds it would like to wait before the next one.
+//  Between steps it is parked on a timer, and workerSignal() brings it back early - so a step boundary plays
+//  the part of a wait() in a threaded Worker.  Workers which are not steppable keep their dedicated threads.
+//
+//  Each carrier has its own run queue; a Worker made ready by a carrier goes to that carrier's queue, and idle
+//  carriers steal from the others.  A step which waits (in workerWait() or miscSleep()) tells us so through
+//  a BlockingScope; if that leaves fewer unblocked carriers than there are cores, we add a carrier.
+//  Once the waits end, a carrier which finds itself idle while there are more unblocked carriers than cores
+//  retires - so the number of carriers is the number of cores, plus the number of steps waiting right now.
+//  A retired carrier's slot is reused by the next carrier we add.
+//
+//  Timers run on the VirtualClock, and the carriers take part in its idle detection - an idle carrier is one
+//  which is waiting, and a carrier we are about to wake for new work is counted as busy from that moment on.
+//
+//  The pool is created on first use and lasts for the life of the process.
+
+
+
+#ifndef     MISCLIB_WORKER_POOL_H
+#define     MISCLIB_WORKER_POOL_H
+
+
+
+class   WorkerPool
+{
+public:
+    class   Statistics
+    {
+    public:
+        COUNT                   m_BlockedCarrierCount;  //  Carriers currently waiting inside a step
+        COUNT                   m_CarrierCount;
+        COUNT                   m_TargetCarrierCount;   //  Unblocked carriers we try to keep - one per core
+        COUNT                   m_WorkerCount;          //  Workers currently in the pool
+        COUNT64                 m_RetireCount;          //  Surplus carriers which have exited
+        COUNT64                 m_StepCount;            //  Steps executed
+        COUNT64                 m_StealCount;           //  Steps taken from some other carrier's run queue
+
+        Statistics()
+            :m_BlockedCarrierCount( 0 ),
+            m_CarrierCount( 0 ),
+            m_TargetCarrierCount( 0 ),
+            m_WorkerCount( 0 ),
+            m_RetireCount( 0 ),
+            m_StepCount( 0 ),
+            m_StealCount( 0 )
+        {}
+    };
+
+    //  Brackets a wait inside a step, so that the pool can keep enough carriers running.
+    //  Does nothing on a thread which is not a carrier.
+    class   BlockingScope
+    {
+    private:
+        bool                    m_Counted;
+
+    public:
+        BlockingScope();
+        ~BlockingScope();
+    };
+
+private:
+    enum WorkerState
+    {
+        WS_QUEUED,              //  On a run queue
+        WS_RUNNING,             //  A carrier is in workerStep()
+        WS_WAITING,             //  Parked on the timer
+    };
+
+    typedef     std::multimap<COUNT64, Worker*>             TIMERS;     //  keyed by VirtualClock deadline
+    typedef     TIMERS::iterator                            ITTIMERS;
+
+    class   WorkerEntry
+    {
+    public:
+        WorkerState             m_State;
+        bool                    m_Signaled;             //  workerSignal() while running - step again right away
+        ITTIMERS                m_itTimer;              //  Valid only for WS_WAITING
+
+        WorkerEntry()
+            :m_State( WS_QUEUED ),
+            m_Signaled( false )
+        {}
+    };
+
+    typedef     std::map<Worker*, WorkerEntry>              WORKERENTRIES;
+    typedef     WORKERENTRIES::iterator                     ITWORKERENTRIES;
+
+    //  The lock protects m_RunQueue
+    class   Carrier : public SpinLockable
+    {
+    public:
+        bool                    m_Active;               //  A thread is running this carrier - under m_Mutex
+        std::deque<Worker*>     m_RunQueue;             //  Owner takes from the back, thieves from the front
+        std::thread             m_Thread;               //  Detached when the carrier retires
+
+        Carrier()
+            :m_Active( false )
+        {}
+    };
+
+    COUNT                       m_ActiveCarriers;
+    COUNT                       m_BlockedCarriers;
+    std::atomic<COUNT>          m_CarrierCount;         //  Entries of m_Carriers in use - they never move, or go away,
+                                                        //      though a retired one is empty until it is reused
+    std::vector<Carrier*>       m_Carriers;             //  Sized at MAX_CARRIERS
+    std::condition_variable     m_Condition;            //  Idle carriers wait here
+    std::deque<VirtualClock::Wait*>
+                                m_IdleWaits;            //  Clock waits of idle carriers, not yet woken
+    std::mutex                  m_Mutex;                //  Protects everything below, and m_Condition
+    INDEX                       m_NextCarrier;          //  Round-robin placement for Workers readied by non-carriers
+    Statistics                  m_Statistics;
+    TIMERS                      m_Timers;
+    const COUNT                 m_TargetCarriers;
+    WORKERENTRIES               m_WorkerEntries;
+
+    static WorkerPool*          m_pInstance;
+
+    WorkerPool( const COUNT targetCarriers );
+
+    void                        beginBlocking();
+    void                        carrierLoop( const INDEX carrierIndex );
+    void                        endBlocking();
+    void                        enqueue( Worker* const pWorker );
+    Worker*                     findWork( const INDEX carrierIndex );
+    bool                        hasQueuedWork() const;
+    void                        retireCarrier( const INDEX carrierIndex );
+    void                        runStep( Worker* const pWorker );
+    void                        startCarrier();
+    void                        wakeCarrier();
+
+    static const COUNT          MAX_CARRIERS = 1024;
+
+public:
+    void                        dump( std::ostream&         stream,
+                                      const std::string&    prefix );
+    Statistics                  getStatistics();
+    void                        schedule( Worker* const pWorker );
+    void                        signal( Worker* const pWorker );
+
+    static WorkerPool*          getInstance();
+};
+
+
+
+#endif
@@ -306,13 +306,15 @@ miscDumpWord36Buffer
 
 //  miscDumpWord36BufferToLog
 //
-//  Dumps a buffer to the indicated system log
+//  Dumps a buffer to the indicated system log, under the category and level by which the caller decided to dump it
 void
 miscDumpWord36BufferToLog
 (
-    SystemLog* const        pSystemLog,
-    const Word36* const     pBuffer,
-    const COUNT             wordCount
+    SystemLog* const            pSystemLog,
+    const SystemLog::Category   category,
+    const SystemLog::Level      level,
+    const Word36* const         pBuffer,
+    const COUNT                 wordCount
 )
 {
     INDEX wx = 0;
@@ -348,7 +350,7 @@ miscDumpWord36BufferToLog
         if ( (wx % 4) == 3 )
         {
             strm << octalString << " " << fieldataString << " " << asciiString;
-            pSystemLog->write( strm.str() );
+            pSystemLog->writeEntry( category, level, strm.str() );
             octalString.clear();
             fieldataString.clear();
             asciiString.clear();
@@ -803,19 +805,16 @@ miscOnesCompSubtract36
 
 //  miscSleep()
 //
-//  Sleeps for a given number of milliseconds (or more, depending upon the runtime)
+//  Sleeps for a given number of milliseconds (or more, depending upon the runtime) of VirtualClock time.
+//  On a WorkerPool carrier, the pool may start another carrier to cover for us meanwhile.
 void
 miscSleep
 (
     const COUNT32 milliseconds
 )
 {
-#ifdef WIN32
-    Sleep( milliseconds );
-#else
-    COUNT64 micros = static_cast<COUNT64>(milliseconds) * 1000;
-    usleep( micros );
-#endif
+    WorkerPool::BlockingScope blocking;
+    VirtualClock::getInstance()->sleep( milliseconds );
 }
 
 
@@ -1126,10 +1125,12 @@ miscWord36Unpack
 
 //  miscWriteBufferToLog()
 //
-//  Writes the given BYTE buffer to the system log
+//  Writes the given BYTE buffer to the system log, with the given category and level
 void
 miscWriteBufferToLog
 (
+    const SystemLog::Category   category,
+    const SystemLog::Level      level,
     const std::string&      identifier,
     const std::string&      caption,
     const BYTE* const       pBuffer,
@@ -1141,7 +1142,7 @@ miscWriteBufferToLog
     std::stringstream asciiStream;
 
     strm << identifier << " -- " << caption;
-    SystemLog::write( strm.str() );
+    SystemLog::write( category, level, strm.str() );
 
     for ( INDEX bx = 0; bx < bytes; bx += 16 )
     {
@@ -1166,7 +1167,7 @@ miscWriteBufferToLog
         }
 
         strm << hexStream.str() << " " << asciiStream.str();
-        SystemLog::write( strm.str() );
+        SystemLog::write( category, level, strm.str() );
     }
 }
 
@@ -15,6 +15,7 @@
 
 
 #include    <assert.h>
+#include    <errno.h>
 #include    <stdint.h>
 #include    <stdio.h>
 #include    <stdlib.h>
@@ -34,12 +35,18 @@
 #include    <sys/poll.h>
 #include    <sys/socket.h>
 #include    <sys/stat.h>
+#include    <sys/syscall.h>
 #include    <sys/sysinfo.h>
 #include    <sys/time.h>
 #include    <sys/types.h>
 #include    <unistd.h>
 #endif
 
+#include    <algorithm>
+#include    <atomic>
+#include    <chrono>
+#include    <condition_variable>
+#include    <deque>
 #include    <fstream>
 #include    <iomanip>
 #include    <iostream>
@@ -49,6 +56,8 @@
 #include    <set>
 #include    <sstream>
 #include    <string>
+#include    <thread>
+#include    <unordered_map>
 #include    <vector>
 
 
@@ -57,6 +66,22 @@
 #define     VERSION     "0.2"
 #define     COPYRIGHT   "Copyright (c) 2014-2015 by Kurt Duncan"
 
+//  Set to 1 to have every Lockable and SharedLockable record wait times, hold times, and acquiring call sites
+//  (see LockProfiler.h).  When 0, none of the profiling code is compiled.
+#ifndef     MISCLIB_LOCK_PROFILING
+#define     MISCLIB_LOCK_PROFILING      0
+#endif
+
+//  SYSTEM_LOG entries below this level (0 = TRACE, 1 = DEBUG, 2 = INFO - see SystemLog::Level) are compiled out,
+//  whatever the minimum levels are set to at run time.
+#ifndef     MISCLIB_LOG_MIN_LEVEL
+#ifdef      NDEBUG
+#define     MISCLIB_LOG_MIN_LEVEL       2
+#else
+#define     MISCLIB_LOG_MIN_LEVEL       0
+#endif
+#endif
+
 //  Paths
 #ifdef WIN32
 #define     BASE_PATH       "C:\\ProgramData\\em2200\\"
@@ -394,24 +419,64 @@ inline INT32    miscTwosComplement18( const UINT32 operand )    { return miscIsN
 inline INT32    miscTwosComplement24( const UINT32 operand )    { return miscIsNegative24( operand ) ? (0 - miscComplement24( operand )) : operand; }
 inline INT64    miscTwosComplement36( const UINT64 operand )    { return miscIsNegative36( operand ) ? (0 - miscComplement36( operand )) : operand; }
 
+//  Big-endian integers in host files (MFD snapshots, catalog indices, and the like)
+inline UINT32   miscGetBigEndian32( const BYTE* const pSource )
+{
+    return (static_cast<UINT32>( pSource[0] ) << 24) | (static_cast<UINT32>( pSource[1] ) << 16)
+            | (static_cast<UINT32>( pSource[2] ) << 8) | pSource[3];
+}
+
+inline UINT64   miscGetBigEndian64( const BYTE* const pSource )
+{
+    return (static_cast<UINT64>( miscGetBigEndian32( pSource ) ) << 32) | miscGetBigEndian32( pSource + 4 );
+}
+
+inline void     miscPutBigEndian32( BYTE* const     pDestination,
+                                    const UINT32    value )
+{
+    pDestination[0] = static_cast<BYTE>( value >> 24 );
+    pDestination[1] = static_cast<BYTE>( value >> 16 );
+    pDestination[2] = static_cast<BYTE>( value >> 8 );
+    pDestination[3] = static_cast<BYTE>( value );
+}
+
+inline void     miscPutBigEndian64( BYTE* const     pDestination,
+                                    const UINT64    value )
+{
+    miscPutBigEndian32( pDestination, static_cast<UINT32>( value >> 32 ) );
+    miscPutBigEndian32( pDestination + 4, static_cast<UINT32>( value ) );
+}
+
 
 
+#include    "CpuSet.h"
 #include    "DataHandler.h"         //???? is this obsolete?
 #include    "Emitter.h"
 #include    "Event.h"
 #include    "GeneralRegister.h"     //???? should this be in hardwarelib?
 #include    "HttpServer.h"
 #include    "InstructionWord.h"     //????  should this be in hardwarelib?
+#include    "LatencyHistogram.h"
 #include    "Listener.h"
+#include    "LockProfiler.h"
+#include    "LockStatistics.h"
 #include    "Lockable.h"
+#include    "FixedBlockPool.h"
+#include    "MetricsWriter.h"
 #include    "NetServer.h"
+#include    "SharedLockable.h"
 #include    "SimpleFile.h"
+#include    "SpinLockable.h"
 #include    "SuperString.h"
 #include    "SystemLog.h"
 #include    "SystemTime.h"
 #include    "TDate.h"
+#include    "TraceLog.h"
+#include    "TraceDecoder.h"
+#include    "VirtualClock.h"
 #include    "Word36.h"
 #include    "Worker.h"
+#include    "WorkerPool.h"
 
 
 
@@ -421,9 +486,11 @@ char            miscAsciiToDisplay( const char  ascChar,
 void            miscDumpWord36Buffer( std::ostream&         stream,
                                       const Word36* const   pBuffer,
                                       const COUNT           wordCount );
-void            miscDumpWord36BufferToLog( SystemLog* const     pSystemLog,
-                                           const Word36* const  pBuffer,
-                                           const COUNT          wordCount );
+void            miscDumpWord36BufferToLog( SystemLog* const         pSystemLog,
+                                           const SystemLog::Category    category,
+                                           const SystemLog::Level       level,
+                                           const Word36* const      pBuffer,
+                                           const COUNT              wordCount );
 char            miscFieldataToAscii( const char fdChar );
 COUNT64         miscGetAvailableMemory();
 BLOCK_SIZE      miscGetBlockSizeFromPrepFactor( PREP_FACTOR prepFactor );
@@ -468,7 +535,9 @@ std::string     miscWord36FieldataToString( const Word36* const pWord36Buffer,
 void            miscWord36Unpack( Word36* const         pWord36Buffer,
                                     const BYTE* const   pByteBuffer,
                                     const COUNT         word36Count );
-void            miscWriteBufferToLog( const std::string&    identifer,
+void            miscWriteBufferToLog( const SystemLog::Category category,
+                                        const SystemLog::Level  level,
+                                        const std::string&  identifer,
                                         const std::string&  caption,
                                         const BYTE* const   pBuffer,
                                         const COUNT         bytes );
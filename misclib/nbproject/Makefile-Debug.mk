@@ -35,16 +35,27 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/CpuSet.o \
 	${OBJECTDIR}/DataHandler.o \
+	${OBJECTDIR}/FixedBlockPool.o \
 	${OBJECTDIR}/GeneralRegister.o \
+	${OBJECTDIR}/HttpServer.o \
 	${OBJECTDIR}/InstructionWord.o \
+	${OBJECTDIR}/LatencyHistogram.o \
+	${OBJECTDIR}/LockProfiler.o \
+	${OBJECTDIR}/MetricsWriter.o \
+	${OBJECTDIR}/NetServer.o \
 	${OBJECTDIR}/SimpleFile.o \
 	${OBJECTDIR}/SuperString.o \
 	${OBJECTDIR}/SystemLog.o \
 	${OBJECTDIR}/SystemTime.o \
 	${OBJECTDIR}/TDate.o \
+	${OBJECTDIR}/TraceDecoder.o \
+	${OBJECTDIR}/TraceLog.o \
+	${OBJECTDIR}/VirtualClock.o \
 	${OBJECTDIR}/Word36.o \
 	${OBJECTDIR}/Worker.o \
+	${OBJECTDIR}/WorkerPool.o \
 	${OBJECTDIR}/misclib.o
 
 
@@ -74,21 +85,56 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libmisclib.a: ${OBJECTFILES}
 	${AR} -rv ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libmisclib.a ${OBJECTFILES} 
 	$(RANLIB) ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/libmisclib.a
 
+${OBJECTDIR}/CpuSet.o: CpuSet.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/CpuSet.o CpuSet.cpp
+
 ${OBJECTDIR}/DataHandler.o: DataHandler.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DataHandler.o DataHandler.cpp
 
+${OBJECTDIR}/FixedBlockPool.o: FixedBlockPool.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/FixedBlockPool.o FixedBlockPool.cpp
+
 ${OBJECTDIR}/GeneralRegister.o: GeneralRegister.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/GeneralRegister.o GeneralRegister.cpp
 
+${OBJECTDIR}/HttpServer.o: HttpServer.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/HttpServer.o HttpServer.cpp
+
 ${OBJECTDIR}/InstructionWord.o: InstructionWord.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/InstructionWord.o InstructionWord.cpp
 
+${OBJECTDIR}/LatencyHistogram.o: LatencyHistogram.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/LatencyHistogram.o LatencyHistogram.cpp
+
+${OBJECTDIR}/LockProfiler.o: LockProfiler.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/LockProfiler.o LockProfiler.cpp
+
+${OBJECTDIR}/MetricsWriter.o: MetricsWriter.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MetricsWriter.o MetricsWriter.cpp
+
+${OBJECTDIR}/NetServer.o: NetServer.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/NetServer.o NetServer.cpp
+
 ${OBJECTDIR}/SimpleFile.o: SimpleFile.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -114,6 +160,21 @@ ${OBJECTDIR}/TDate.o: TDate.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TDate.o TDate.cpp
 
+${OBJECTDIR}/TraceDecoder.o: TraceDecoder.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TraceDecoder.o TraceDecoder.cpp
+
+${OBJECTDIR}/TraceLog.o: TraceLog.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TraceLog.o TraceLog.cpp
+
+${OBJECTDIR}/VirtualClock.o: VirtualClock.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/VirtualClock.o VirtualClock.cpp
+
 ${OBJECTDIR}/Word36.o: Word36.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -124,6 +185,11 @@ ${OBJECTDIR}/Worker.o: Worker.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Worker.o Worker.cpp
 
+${OBJECTDIR}/WorkerPool.o: WorkerPool.cpp 
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -Wall -std=c++11 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/WorkerPool.o WorkerPool.cpp
+
 ${OBJECTDIR}/misclib.o: misclib.cpp 
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"